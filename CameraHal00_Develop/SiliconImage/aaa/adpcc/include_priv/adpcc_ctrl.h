@@ -75,6 +75,7 @@ typedef struct AdpccContext_s
 
     CamResolutionName_t             ResName;            /**< identifier for accessing resolution depended calibration data */
     CamCalibDbHandle_t              hCamCalibDb;        /**< calibration database handle */
+    CamDpccProfile_t                *pDpccProfile;      /**< DPCC profile of the resolution, resolved with ResName */
 
     float                           gain;               /**< current sensor gain */
     AdpccConfig_t                   Config;
@@ -90,16 +90,27 @@ static RESULT AdpccPrepareCalibDbAccess
     const uint16_t              framerate
 )
 {
+    CamCalibDbResProfiles_t Profiles;
+
     RESULT result = RET_SUCCESS;
 
     TRACE( ADPCC_INFO, "%s: (enter)\n", __FUNCTION__);
 
-    result = CamCalibDbGetResolutionNameByWidthHeight( hCamCalibDb, width, height, &pAdpccCtx->ResName );
+    // resolve resolution and dpcc-profile once, both are kept until the next configuration
+    result = CamCalibDbGetResProfilesByWidthHeight( hCamCalibDb, width, height, &Profiles );
     if ( RET_SUCCESS != result )
     {
         TRACE( ADPCC_ERROR, "%s: resolution (%dx%d@%d) not found in database\n", __FUNCTION__, width, height, framerate );
         return ( result );
     }
+
+    strncpy( pAdpccCtx->ResName, Profiles.pResolution->name, sizeof( pAdpccCtx->ResName ) );
+    pAdpccCtx->pDpccProfile = Profiles.pDpccProfile;
+    if ( NULL == pAdpccCtx->pDpccProfile )
+    {
+        TRACE( ADPCC_ERROR, "%s: no DPCC profile for resolution %s in database\n", __FUNCTION__, pAdpccCtx->ResName );
+        return ( RET_NOTSUPP );
+    }
     TRACE( ADPCC_INFO, "%s: resolution = %s\n", __FUNCTION__, pAdpccCtx->ResName );
 
     pAdpccCtx->hCamCalibDb = hCamCalibDb;
@@ -148,14 +159,8 @@ static RESULT AdpccApplyConfiguration
             return ( result );
         }
 
-        // get dpf-profile from calibration database
-        result = CamCalibDbGetDpccProfileByResolution( pAdpccCtx->hCamCalibDb, pAdpccCtx->ResName, &pDpccProfile );
-        if ( result != RET_SUCCESS )
-        {
-            TRACE( ADPCC_ERROR, "%s: Getting DPCC profile for resolution %s from calibration database failed (%d)\n",
-                                    __FUNCTION__, pAdpccCtx->ResName, result );
-            return ( result );
-        }
+        // dpcc-profile was resolved with the resolution
+        pDpccProfile = pAdpccCtx->pDpccProfile;
         DCT_ASSERT( NULL != pDpccProfile );
 
         DpccConfig.isp_dpcc_mode            = pDpccProfile->isp_dpcc_mode;
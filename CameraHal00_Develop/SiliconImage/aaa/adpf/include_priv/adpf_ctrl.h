@@ -75,6 +75,7 @@ typedef struct AdpfContext_s
 
     CamResolutionName_t             ResName;            /**< identifier for accessing resolution depended calibration data */
     CamCalibDbHandle_t              hCamCalibDb;        /**< calibration database handle */
+    CamDpfProfile_t                 *pDpfProfile;       /**< DPF profile of the resolution, resolved with ResName */
 
     uint16_t                        SigmaGreen;         /**< sigma value for green pixel */
     uint16_t                        SigmaRedBlue;       /**< sigma value for red/blue pixel */
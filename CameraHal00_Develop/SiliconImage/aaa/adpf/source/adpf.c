@@ -238,16 +238,27 @@ static RESULT AdpfPrepareCalibDbAccess
     const uint16_t              framerate
 )
 {
+    CamCalibDbResProfiles_t Profiles;
+
     RESULT result = RET_SUCCESS;
 
     TRACE( ADPF_INFO, "%s: (enter)\n", __FUNCTION__);
 
-    result = CamCalibDbGetResolutionNameByWidthHeight( hCamCalibDb, width, height, &pAdpfCtx->ResName );
+    // resolve resolution and dpf-profile once, both are kept until the next configuration
+    result = CamCalibDbGetResProfilesByWidthHeight( hCamCalibDb, width, height, &Profiles );
     if ( RET_SUCCESS != result )
     {
         TRACE( ADPF_ERROR, "%s: resolution (%dx%d@%d) not found in database\n", __FUNCTION__, width, height, framerate );
         return ( result );
     }
+
+    strncpy( pAdpfCtx->ResName, Profiles.pResolution->name, sizeof( pAdpfCtx->ResName ) );
+    pAdpfCtx->pDpfProfile = Profiles.pDpfProfile;
+    if ( NULL == pAdpfCtx->pDpfProfile )
+    {
+        TRACE( ADPF_ERROR, "%s: no DPF profile for resolution %s in database\n", __FUNCTION__, pAdpfCtx->ResName );
+        return ( RET_NOTSUPP );
+    }
     TRACE( ADPF_INFO, "%s: resolution = %s\n", __FUNCTION__, pAdpfCtx->ResName );
 
     pAdpfCtx->hCamCalibDb = hCamCalibDb;
@@ -698,14 +709,8 @@ static RESULT AdpfApplyConfiguration
             return ( result );
         }
 
-        // get dpf-profile from calibration database
-        result = CamCalibDbGetDpfProfileByResolution( pAdpfCtx->hCamCalibDb, pAdpfCtx->ResName, &pDpfProfile );
-        if ( result != RET_SUCCESS )
-        {
-            TRACE( ADPF_ERROR,  "%s: Getting DPF profile for resolution %s from calibration database failed (%d)\n",
-                                    __FUNCTION__, pAdpfCtx->ResName, result );
-            return ( result );
-        }
+        // dpf-profile was resolved with the resolution
+        pDpfProfile = pAdpfCtx->pDpfProfile;
         DCT_ASSERT( NULL != pDpfProfile );
 
         // initialize Adpf context with values from calibration database
@@ -1526,14 +1531,11 @@ RESULT AdpfGetMfdGain
 
     if ( ADPF_STATE_RUNNING == pAdpfCtx->state )
     {
-        result = CamCalibDbGetDpfProfileByResolution( pAdpfCtx->hCamCalibDb, pAdpfCtx->ResName, &pDpfProfile );
-        if ( result != RET_SUCCESS )
+        pDpfProfile = pAdpfCtx->pDpfProfile;
+        if ( NULL == pDpfProfile )
         {
-            TRACE( ADPF_ERROR,  "%s: Getting DPF profile for resolution %s from calibration database failed (%d)\n",
-                                    __FUNCTION__, pAdpfCtx->ResName, result );
-            return ( result );
+            return ( RET_NOTSUPP );
         }
-        DCT_ASSERT( NULL != pDpfProfile );
 
 		*mfd_enable = pDpfProfile->Mfd.enable;
         mfd_gain[0] = pDpfProfile->Mfd.gain[0];
@@ -1586,14 +1588,11 @@ RESULT AdpfGetUvnrPara
 
     if ( ADPF_STATE_RUNNING == pAdpfCtx->state )
     {
-        result = CamCalibDbGetDpfProfileByResolution( pAdpfCtx->hCamCalibDb, pAdpfCtx->ResName, &pDpfProfile );
-        if ( result != RET_SUCCESS )
+        pDpfProfile = pAdpfCtx->pDpfProfile;
+        if ( NULL == pDpfProfile )
         {
-            TRACE( ADPF_ERROR,  "%s: Getting DPF profile for resolution %s from calibration database failed (%d)\n",
-                                    __FUNCTION__, pAdpfCtx->ResName, result );
-            return ( result );
+            return ( RET_NOTSUPP );
         }
-        DCT_ASSERT( NULL != pDpfProfile );
 
 		*uvnr_enable = pDpfProfile->Uvnr.enable;
 		uvnr_gain[0] = pDpfProfile->Uvnr.gain[0];
@@ -9,6 +9,7 @@ LOCAL_SRC_FILES:=\
 	source/acc.c\
 	source/alsc.c\
 	source/awb.c\
+	source/awb_simd.c\
 	source/expprior.c\
 	source/illuest.c\
 	source/interpolate.c\
@@ -21,8 +22,10 @@ LOCAL_C_INCLUDES += \
 	$(LOCAL_PATH)/include_priv\
 	$(LOCAL_PATH)/../../include/
 
-LOCAL_CFLAGS := -Wall -Wextra -std=c99   -Wformat-nonliteral -g -O0 -DDEBUG -pedantic
+# runs per frame, so optimized even in debug builds
+LOCAL_CFLAGS := -Wall -Wextra -std=c99   -Wformat-nonliteral -g -O2 -DDEBUG -pedantic
 LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
+LOCAL_ARM_NEON := true
 LOCAL_STATIC_LIBRARIES := libisp_ebase libisp_oslayer libisp_common libisp_hal libisp_isi libisp_cameric_drv libisp_cam_calibdb
 
 #LOCAL_MODULE_PATH := $(TARGET_OUT_SHARED_LIBRARIES)/hw
@@ -30,3 +33,25 @@ LOCAL_MODULE:= libisp_aaa_awb
 
 LOCAL_MODULE_TAGS:= optional
 include $(BUILD_STATIC_LIBRARY)
+
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:=\
+	source/awb_bench.c\
+	source/awb_simd.c\
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/include\
+	$(LOCAL_PATH)/include_priv\
+	$(LOCAL_PATH)/../../include/
+
+LOCAL_CFLAGS := -Wall -Wextra -std=gnu99 -Wformat-nonliteral -O2
+LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
+LOCAL_ARM_NEON := true
+LOCAL_SHARED_LIBRARIES := liblog
+
+LOCAL_MODULE:= awb_bench
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
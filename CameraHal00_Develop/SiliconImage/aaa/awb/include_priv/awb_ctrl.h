@@ -57,6 +57,28 @@ extern "C"
 #define AWB_MAX_ILLUMINATION_PROFILES   32L
 
 
+
+/*****************************************************************************/
+/**
+ * @brief   Gaussian mixture model of the illumination profiles, one array per
+ *          parameter so the likelihoods are evaluated four profiles at a time
+ *          (see AwbSimdLikeHood()). Entries from NoIlluProfiles up to the next
+ *          multiple of 4 are zero, their likelihood evaluates to 0.
+ */
+/*****************************************************************************/
+typedef struct AwbIlluTable_s
+{
+    float                           MeanC1[AWB_MAX_ILLUMINATION_PROFILES];      /**< GaussMeanValue */
+    float                           MeanC2[AWB_MAX_ILLUMINATION_PROFILES];
+    float                           Cov11[AWB_MAX_ILLUMINATION_PROFILES];       /**< CovarianceMatrix */
+    float                           Cov12[AWB_MAX_ILLUMINATION_PROFILES];
+    float                           Cov21[AWB_MAX_ILLUMINATION_PROFILES];
+    float                           Cov22[AWB_MAX_ILLUMINATION_PROFILES];
+    float                           GaussFactor[AWB_MAX_ILLUMINATION_PROFILES];
+    int32_t                         Num;                                        /**< number of profiles */
+} AwbIlluTable_t;
+
+
 /*****************************************************************************/
 /**
  * @brief This enum type specifies the different possible states of the AWB.
@@ -97,6 +119,7 @@ typedef struct AwbContext_s
 
     CamResolutionName_t             ResName;                /**< identifier for accessing resolution depended calibration data */
     int32_t                         ResIdx;                 /**< resolution index */
+    CamCalibAwbGlobal_t             *pAwbGlobal;            /**< awb-global calibration data of the resolution */
     CamCalibDbHandle_t              hCamCalibDb;            /**< calibration database handle */
 
     /* meassured mode */
@@ -136,6 +159,7 @@ typedef struct AwbContext_s
     uint32_t                        IlluIdx;                /**< index of start illumination profile */
     int32_t                         NoIlluProfiles;         /**< number of illumination profiles 0..31 */
     CamIlluProfile_t                *pIlluProfiles[AWB_MAX_ILLUMINATION_PROFILES];  /**< array of illumination profile pointer */
+    AwbIlluTable_t                  IlluTable;              /**< gaussian models of pIlluProfiles */
 
     CamCcProfile_t                  *pCcProfiles[AWB_MAX_ILLUMINATION_PROFILES][CAM_NO_CC_PROFILES];
     CamLscProfile_t                 *pLscProfiles[CAM_NO_RESOLUTIONS][AWB_MAX_ILLUMINATION_PROFILES][CAM_NO_LSC_PROFILES];
@@ -0,0 +1,157 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+#ifndef __AWB_SIMD_H__
+#define __AWB_SIMD_H__
+
+/**
+ * @file awb_simd.h
+ *
+ * @brief   Per-frame kernels of the AWB: illumination likelihoods, lsc table
+ *          and cc matrix interpolation and damping.
+ *
+ *          Every kernel has a portable reference version (suffix Ref), which
+ *          is the original calculation, and a NEON version selected at compile
+ *          time. The lsc kernel is bit exact to the reference. The float
+ *          kernels differ in the last bit at most, the likelihood uses a
+ *          float exponential instead of the double one.
+ *
+ *****************************************************************************/
+/**
+ * @defgroup AWB_SIMD AWB kernels
+ * @{
+ *
+ */
+#include <ebase/types.h>
+#include <common/cam_types.h>
+
+#include "awb_ctrl.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define AWB_SIMD_NEON   1
+#endif
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Fills the gaussian model table from the illumination profiles.
+ *
+ * @param   pTable          table to fill
+ * @param   pIlluProfiles   profiles
+ * @param   num             number of profiles (max. AWB_MAX_ILLUMINATION_PROFILES)
+ *
+ *****************************************************************************/
+void AwbSimdIlluTableInit
+(
+    AwbIlluTable_t          *pTable,
+    CamIlluProfile_t        *pIlluProfiles[],
+    const int32_t           num
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Evaluates the gaussian likelihood of all profiles at the PCA
+ *          coordinates of the measurement.
+ *
+ * @param   pTable          gaussian models
+ * @param   fPcaC1          first PCA component
+ * @param   fPcaC2          second PCA component
+ * @param   pLikeHood       results, room for pTable->Num rounded up to 4
+ *
+ *****************************************************************************/
+void AwbSimdLikeHood
+(
+    const AwbIlluTable_t    *pTable,
+    const float             fPcaC1,
+    const float             fPcaC2,
+    float                   *pLikeHood
+);
+
+void AwbSimdLikeHoodRef
+(
+    const AwbIlluTable_t    *pTable,
+    const float             fPcaC1,
+    const float             fPcaC2,
+    float                   *pLikeHood
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Blends two lsc matrices in 16.16 fixed point with rounding,
+ *          pRes = ( fA * pA + fB * pB + 0x8000 ) >> 16. pRes may be pA or pB.
+ *
+ *****************************************************************************/
+void AwbSimdLscBlend
+(
+    const CamLscMatrix_t    *pA,
+    const CamLscMatrix_t    *pB,
+    const uint32_t          fA,
+    const uint32_t          fB,
+    CamLscMatrix_t          *pRes
+);
+
+void AwbSimdLscBlendRef
+(
+    const CamLscMatrix_t    *pA,
+    const CamLscMatrix_t    *pB,
+    const uint32_t          fA,
+    const uint32_t          fB,
+    CamLscMatrix_t          *pRes
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Blends two float vectors, pRes = fA * pA + fB * pB. pRes may be
+ *          pA or pB.
+ *
+ *****************************************************************************/
+void AwbSimdBlend
+(
+    const float             *pA,
+    const float             *pB,
+    const float             fA,
+    const float             fB,
+    float                   *pRes,
+    const uint32_t          num
+);
+
+void AwbSimdBlendRef
+(
+    const float             *pA,
+    const float             *pB,
+    const float             fA,
+    const float             fB,
+    float                   *pRes,
+    const uint32_t          num
+);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+/* @} AWB_SIMD */
+
+#endif /* __AWB_SIMD_H__ */
@@ -29,6 +29,7 @@
 #include "awb_ctrl.h"
 
 #include "acc.h"
+#include "awb_simd.h"
 #include "interpolate.h"
 
 
@@ -104,12 +105,7 @@ static RESULT InterpolateMatrix
         float f1 = ( fSatB - fSat ) / ( fSatB - fSatA ); // test: if fSat == fSatA => f1 = 1 => choose A: ok
         float f2 = 1.0f - f1;
 
-        int i;
-
-        for ( i=0; i<9; i++)
-        {
-            pResMatrix->fCoeff[i] = f1 * pMatrixA->fCoeff[i] + f2 * pMatrixB->fCoeff[i];
-        }
+        AwbSimdBlend( pMatrixA->fCoeff, pMatrixB->fCoeff, f1, f2, pResMatrix->fCoeff, 9U );
 
         result = RET_SUCCESS;
     }
@@ -221,12 +217,7 @@ static RESULT InterpolateVector
         float f1 = ( fSatB - fSat ) / ( fSatB - fSatA ); // test: if fSat == fSatA => f1 = 1 => choose A: ok
         float f2 = 1.0f - f1;
 
-        pResOffset->fCoeff[CAM_3CH_COLOR_COMPONENT_RED]
-                = f1 * pOffsetA->fCoeff[CAM_3CH_COLOR_COMPONENT_RED] + f2 * pOffsetB->fCoeff[CAM_3CH_COLOR_COMPONENT_RED];
-        pResOffset->fCoeff[CAM_3CH_COLOR_COMPONENT_GREEN]
-                = f1 * pOffsetA->fCoeff[CAM_3CH_COLOR_COMPONENT_GREEN] + f2 * pOffsetB->fCoeff[CAM_3CH_COLOR_COMPONENT_GREEN];
-        pResOffset->fCoeff[CAM_3CH_COLOR_COMPONENT_BLUE]
-                = f1 * pOffsetA->fCoeff[CAM_3CH_COLOR_COMPONENT_BLUE] + f2 * pOffsetB->fCoeff[CAM_3CH_COLOR_COMPONENT_BLUE];
+        AwbSimdBlend( pOffsetA->fCoeff, pOffsetB->fCoeff, f1, f2, pResOffset->fCoeff, 3U );
 
         result = RET_SUCCESS;
     }
@@ -368,25 +359,13 @@ static RESULT Damping
     if ( (pMatrixUndamped != NULL) && (pMatrixDamped != NULL) 
             && (pOffsetUndamped != NULL) && (pOffsetDamped != NULL) )
     {
-        int32_t i;
         float f = (1.0f - damp);
 
         /* calc. damped cc matrix */
-        for( i=0; i<9; i++ )
-        {
-            pMatrixDamped->fCoeff[i] = (damp * pMatrixDamped->fCoeff[i]) + (f *  pMatrixUndamped->fCoeff[i]);
-        }
+        AwbSimdBlend( pMatrixDamped->fCoeff, pMatrixUndamped->fCoeff, damp, f, pMatrixDamped->fCoeff, 9U );
 
         /* calc. damped cc offsets */
-        pOffsetDamped->fCoeff[CAM_3CH_COLOR_COMPONENT_RED]
-                        = (damp * pOffsetDamped->fCoeff[CAM_3CH_COLOR_COMPONENT_RED])
-                        + (f * pOffsetUndamped->fCoeff[CAM_3CH_COLOR_COMPONENT_RED]);
-        pOffsetDamped->fCoeff[CAM_3CH_COLOR_COMPONENT_GREEN]
-                        = (damp * pOffsetDamped->fCoeff[CAM_3CH_COLOR_COMPONENT_GREEN])
-                        + (f * pOffsetUndamped->fCoeff[CAM_3CH_COLOR_COMPONENT_GREEN]);
-        pOffsetDamped->fCoeff[CAM_3CH_COLOR_COMPONENT_BLUE]
-                        = (damp * pOffsetDamped->fCoeff[CAM_3CH_COLOR_COMPONENT_BLUE])
-                        + (f * pOffsetUndamped->fCoeff[CAM_3CH_COLOR_COMPONENT_BLUE]);
+        AwbSimdBlend( pOffsetDamped->fCoeff, pOffsetUndamped->fCoeff, damp, f, pOffsetDamped->fCoeff, 3U );
 
         result = RET_SUCCESS;
     }
@@ -27,6 +27,7 @@
 #include "awb_ctrl.h"
 
 #include "alsc.h"
+#include "awb_simd.h"
 #include "interpolate.h"
 
 
@@ -147,33 +148,10 @@ static RESULT VignInterpolateMatrices
         uint32_t f1_ = (uint32_t)(f1 * 65536.0f);
         uint32_t f2_ = (uint32_t)(f2 * 65536.0f);
 
-        int16_t i;
-
-        uint32_t red;
-        uint32_t greenr;
-        uint32_t greenb;
-        uint32_t blue;
-
-        for ( i=0; i<(17*17); i++ )
-        {
-            red     = (f1_ * (uint32_t)pLscProfile1->LscMatrix[ISI_COLOR_COMPONENT_RED].uCoeff[i])
-                        + (f2_ * (uint32_t)pLscProfile2->LscMatrix[ISI_COLOR_COMPONENT_RED].uCoeff[i]);
-
-            greenr  = (f1_ * (uint32_t)pLscProfile1->LscMatrix[ISI_COLOR_COMPONENT_GREENR].uCoeff[i])
-                        + (f2_ * (uint32_t)pLscProfile2->LscMatrix[ISI_COLOR_COMPONENT_GREENR].uCoeff[i]);
-
-            greenb  = (f1_ * (uint32_t)pLscProfile1->LscMatrix[ISI_COLOR_COMPONENT_GREENB].uCoeff[i])
-                        + (f2_ * (uint32_t)pLscProfile2->LscMatrix[ISI_COLOR_COMPONENT_GREENB].uCoeff[i]);
-
-            blue    = (f1_ * (uint32_t)pLscProfile1->LscMatrix[ISI_COLOR_COMPONENT_BLUE].uCoeff[i])
-                        + (f2_ * (uint32_t)pLscProfile2->LscMatrix[ISI_COLOR_COMPONENT_BLUE].uCoeff[i]);
-
-            /* with round up (add 65536/2 <=> 0.5) before right shift */
-            pResMatrix->LscMatrix[ISI_COLOR_COMPONENT_RED].uCoeff[i]    = (uint16_t)((red + (65536>>1)) >> 16);
-            pResMatrix->LscMatrix[ISI_COLOR_COMPONENT_GREENR].uCoeff[i] = (uint16_t)((greenr + (65536>>1)) >> 16);
-            pResMatrix->LscMatrix[ISI_COLOR_COMPONENT_GREENB].uCoeff[i] = (uint16_t)((greenb + (65536>>1)) >> 16);
-            pResMatrix->LscMatrix[ISI_COLOR_COMPONENT_BLUE].uCoeff[i]   = (uint16_t)((blue + (65536>>1)) >> 16);
-        }
+        /* the profile tables have the layout of a CamLscMatrix_t */
+        AwbSimdLscBlend( (const CamLscMatrix_t *)&pLscProfile1->LscMatrix[0],
+                         (const CamLscMatrix_t *)&pLscProfile2->LscMatrix[0],
+                         f1_, f2_, pResMatrix );
 
         iResult = RET_SUCCESS;
     }
@@ -200,33 +178,7 @@ static RESULT Damping
         uint32_t f1_ = (uint32_t)(damp * 65536.0f);
         uint32_t f2_ = (uint32_t)(65536U - f1_);
 
-        int16_t i;
-
-        uint32_t red;
-        uint32_t greenr;
-        uint32_t greenb;
-        uint32_t blue;
-
-        for ( i=0; i<(17*17); i++ )
-        {
-            red     = (f1_ * (uint32_t)pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_RED].uCoeff[i])
-                        + (f2_ * (uint32_t)pMatrixUndamped->LscMatrix[ISI_COLOR_COMPONENT_RED].uCoeff[i]);
-
-            greenr  = (f1_ * (uint32_t)pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_GREENR].uCoeff[i])
-                        + (f2_ * (uint32_t)pMatrixUndamped->LscMatrix[ISI_COLOR_COMPONENT_GREENR].uCoeff[i]);
-
-            greenb  = (f1_ * (uint32_t)pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_GREENB].uCoeff[i])
-                        + (f2_ * (uint32_t)pMatrixUndamped->LscMatrix[ISI_COLOR_COMPONENT_GREENB].uCoeff[i]);
-
-            blue    = (f1_ * (uint32_t)pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_BLUE].uCoeff[i])
-                        + (f2_ * (uint32_t)pMatrixUndamped->LscMatrix[ISI_COLOR_COMPONENT_BLUE].uCoeff[i]);
-
-            /* with round up (add 65536/2 <=> 0.5) before right shift */
-            pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_RED].uCoeff[i]    = (uint16_t)((red    + (65536>>1)) >> 16);
-            pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_GREENR].uCoeff[i] = (uint16_t)((greenr + (65536>>1)) >> 16);
-            pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_GREENB].uCoeff[i] = (uint16_t)((greenb + (65536>>1)) >> 16);
-            pMatrixDamped->LscMatrix[ISI_COLOR_COMPONENT_BLUE].uCoeff[i]   = (uint16_t)((blue   + (65536>>1)) >> 16);
-        }
+        AwbSimdLscBlend( pMatrixDamped, pMatrixUndamped, f1_, f2_, pMatrixDamped );
 
         result = RET_SUCCESS;
     }
@@ -35,6 +35,7 @@
 #include "wpregionadapt.h"
 #include "acc.h"
 #include "alsc.h"
+#include "awb_simd.h"
 
 /******************************************************************************
  * local macro definitions
@@ -112,18 +113,23 @@ static RESULT AwbPrepareCalibDbAccess
     const float                 framerate
 )
 {
+    CamCalibDbResProfiles_t Profiles;
+
     RESULT result = RET_SUCCESS;
 
     TRACE( AWB_INFO, "%s: (enter)\n", __FUNCTION__);
 
-    result = CamCalibDbGetResolutionNameByWidthHeight( hCamCalibDb, width, height, &pAwbCtx->ResName );
+    // resolve resolution and awb-global data once, both are kept until the next resolution switch
+    result = CamCalibDbGetResProfilesByWidthHeight( hCamCalibDb, width, height, &Profiles );
     if ( RET_SUCCESS != result )
     {
         TRACE( AWB_ERROR, "%s: resolution (%dx%d@%d) not found in database\n", __FUNCTION__, width, height, framerate );
         return ( result );
     }
 
-    result = CamCalibDbGetResolutionIdxByName( hCamCalibDb, pAwbCtx->ResName, &pAwbCtx->ResIdx );
+    strncpy( pAwbCtx->ResName, Profiles.pResolution->name, sizeof( pAwbCtx->ResName ) );
+    pAwbCtx->ResIdx     = Profiles.ResIdx;
+    pAwbCtx->pAwbGlobal = Profiles.pAwbGlobal;
     DCT_ASSERT( pAwbCtx->ResIdx < CAM_NO_RESOLUTIONS );
 
     TRACE( AWB_INFO, "%s: resolution(%d) = %s\n", __FUNCTION__, pAwbCtx->ResIdx, pAwbCtx->ResName );
@@ -322,14 +328,13 @@ static RESULT AwbPrepareCalibrationData
     pAwbCtx->D50IlluProfileIdx  = -1;
     pAwbCtx->CwfIlluProfileIdx  = -1;
 
-    // get awb-global calibration data from database
-    result = CamCalibDbGetAwbGlobalByResolution( pAwbCtx->hCamCalibDb, pAwbCtx->ResName, &pAwbGlobal );
-    if ( RET_SUCCESS != result )
+    // awb-global calibration data was resolved with the resolution
+    pAwbGlobal = pAwbCtx->pAwbGlobal;
+    if ( NULL == pAwbGlobal )
     {
         TRACE( AWB_ERROR, "%s: database does not conatin AWB data for resolution %s\n", __FUNCTION__, pAwbCtx->ResName );
-        return ( result );
+        return ( RET_NOTSUPP );
     }
-    DCT_ASSERT( pAwbGlobal != NULL );
 
     // store the pointers and values into instance context
     pAwbCtx->RgProjMaxSky       = pAwbGlobal->fRgProjMaxSky;
@@ -473,6 +478,9 @@ static RESULT AwbPrepareCalibrationData
 
     pAwbCtx->NoIlluProfiles = cnt;
 
+    // gaussian models in the layout of the likelihood kernel
+    AwbSimdIlluTableInit( &pAwbCtx->IlluTable, pAwbCtx->pIlluProfiles, cnt );
+
     // initialize the IIR filter
     AwbExpPriorConfig_t ExpPriorCfg;
 
@@ -2188,3 +2196,35 @@ RESULT AwbCalcWBgainbyCT
 
 }
 
+
+
+
+/******************************************************************************
+ * AwbGetLscMatrix()
+ *****************************************************************************/
+RESULT AwbGetLscMatrix
+(
+    AwbHandle_t     handle,
+    CamLscMatrix_t  *pLscMatrix
+)
+{
+    AwbContext_t *pAwbCtx = (AwbContext_t *)handle;
+
+    TRACE( AWB_INFO, "%s: (enter)\n", __FUNCTION__);
+
+    if ( NULL == pAwbCtx )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( NULL == pLscMatrix )
+    {
+        return ( RET_INVALID_PARM );
+    }
+
+    *pLscMatrix = pAwbCtx->DampedLscMatrixTable;
+
+    TRACE( AWB_INFO, "%s: (exit)\n", __FUNCTION__);
+
+    return ( RET_SUCCESS );
+}
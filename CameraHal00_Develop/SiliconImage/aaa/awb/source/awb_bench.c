@@ -0,0 +1,308 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file    awb_bench.c
+ *
+ * @brief   Checks the AWB kernels against their reference versions and times
+ *          the per-frame math of AwbProcessFrame() with both.
+ *
+ *          One frame is what the awb does per processed measurement: the
+ *          likelihoods of all illumination profiles, one lsc interpolation
+ *          and damping, two cc matrix and offset interpolations and the cc
+ *          damping. The inputs are random but reproducible, -s picks another
+ *          set. The lsc results have to be bit exact, the float results have
+ *          to be within a relative 1e-6 of the reference.
+ *
+ *          Exit code is 0 if all results matched, 1 otherwise.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ebase/types.h>
+#include <common/cam_types.h>
+
+#include "awb.h"
+#include "awb_ctrl.h"
+#include "awb_simd.h"
+
+#define BENCH_DEF_LOOPS     10000
+#define BENCH_DEF_PROFILES  7
+#define BENCH_POINTS        256
+
+#define BENCH_REL_TOL       1e-6f
+#define BENCH_ABS_TOL       1e-30f      /**< exp() of the reference underflows earlier */
+
+typedef void (*LikeHoodFn_t)( const AwbIlluTable_t *, const float, const float, float * );
+typedef void (*LscBlendFn_t)( const CamLscMatrix_t *, const CamLscMatrix_t *, const uint32_t, const uint32_t, CamLscMatrix_t * );
+typedef void (*BlendFn_t)( const float *, const float *, const float, const float, float *, const uint32_t );
+
+typedef struct BenchKernels_s
+{
+    LikeHoodFn_t    LikeHood;
+    LscBlendFn_t    LscBlend;
+    BlendFn_t       Blend;
+} BenchKernels_t;
+
+typedef struct BenchData_s
+{
+    AwbIlluTable_t  Table;
+    float           PcaC1[BENCH_POINTS];
+    float           PcaC2[BENCH_POINTS];
+    CamLscMatrix_t  Lsc[2];
+    float           Cc[2][12];              /**< 3x3 matrix and 1x3 offset */
+} BenchData_t;
+
+static const BenchKernels_t RefKernels  = { AwbSimdLikeHoodRef, AwbSimdLscBlendRef, AwbSimdBlendRef };
+static const BenchKernels_t SimdKernels = { AwbSimdLikeHood, AwbSimdLscBlend, AwbSimdBlend };
+
+static uint32_t seed = 1U;
+
+static float frand( float min, float max )
+{
+    seed = seed * 1103515245U + 12345U;
+    return ( min + ( max - min ) * (float)( seed >> 8 ) / (float)( 1U << 24 ) );
+}
+
+static long long now_us( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000 );
+}
+
+static void usage( const char *name )
+{
+    printf( "usage: %s [-n loops] [-p profiles] [-s seed]\n", name );
+}
+
+/* profiles shaped like the ones of the calibration database: means within
+ * +-0.2, inverse covariances of 1e2..1e4, so the exponents cover 0..-100 */
+static void make_data( BenchData_t *pData, const int32_t profiles )
+{
+    static CamIlluProfile_t illu[AWB_MAX_ILLUMINATION_PROFILES];
+    CamIlluProfile_t *pIllu[AWB_MAX_ILLUMINATION_PROFILES];
+    uint16_t *lsc;
+    float d, o;
+    int32_t i;
+
+    memset( illu, 0, sizeof(illu) );
+
+    for ( i = 0; i < profiles; i++ )
+    {
+        d = frand( 100.0f, 10000.0f );
+        o = frand( -0.5f, 0.5f ) * d;
+
+        illu[i].GaussMeanValue.fCoeff[0]    = frand( -0.2f, 0.2f );
+        illu[i].GaussMeanValue.fCoeff[1]    = frand( -0.2f, 0.2f );
+        illu[i].CovarianceMatrix.fCoeff[0]  = d;
+        illu[i].CovarianceMatrix.fCoeff[1]  = o;
+        illu[i].CovarianceMatrix.fCoeff[2]  = o;
+        illu[i].CovarianceMatrix.fCoeff[3]  = frand( 100.0f, 10000.0f );
+        illu[i].GaussFactor.fCoeff[0]       = frand( 1.0f, 1000.0f );
+
+        pIllu[i] = &illu[i];
+    }
+
+    AwbSimdIlluTableInit( &pData->Table, pIllu, profiles );
+
+    for ( i = 0; i < BENCH_POINTS; i++ )
+    {
+        pData->PcaC1[i] = frand( -0.25f, 0.25f );
+        pData->PcaC2[i] = frand( -0.25f, 0.25f );
+    }
+
+    /* full 12 bit range (4.8 fixed point in the isp) */
+    lsc = &pData->Lsc[0].LscMatrix[0].uCoeff[0];
+    for ( i = 0; i < (int32_t)( 2 * sizeof(CamLscMatrix_t) / sizeof(uint16_t) ); i++ )
+    {
+        lsc[i] = (uint16_t)frand( 0.0f, 4095.0f );
+    }
+
+    for ( i = 0; i < 12; i++ )
+    {
+        pData->Cc[0][i] = frand( -2.0f, 2.0f );
+        pData->Cc[1][i] = frand( -2.0f, 2.0f );
+    }
+}
+
+/* same calls, same order as AwbIlluEstProcessFrame(), AwbAlscProcessFrame()
+ * and AwbAccProcessFrame() */
+static void frame
+(
+    const BenchKernels_t    *pK,
+    const BenchData_t       *pData,
+    const int32_t           point,
+    float                   *pLikeHood,
+    CamLscMatrix_t          *pLsc,
+    float                   *pCc
+)
+{
+    const float f1 = 0.25f + 0.5f * (float)point / BENCH_POINTS;
+    const uint32_t f1_ = (uint32_t)( f1 * 65536.0f );
+    const uint32_t f2_ = (uint32_t)( ( 1.0f - f1 ) * 65536.0f );
+    const uint32_t damp_ = (uint32_t)( 0.7f * 65536.0f );
+    float undamped[12];
+
+    CamLscMatrix_t undampedLsc;
+
+    pK->LikeHood( &pData->Table, pData->PcaC1[point], pData->PcaC2[point], pLikeHood );
+
+    pK->LscBlend( &pData->Lsc[0], &pData->Lsc[1], f1_, f2_, &undampedLsc );
+    pK->LscBlend( pLsc, &undampedLsc, damp_, 65536U - damp_, pLsc );
+
+    pK->Blend( &pData->Cc[0][0], &pData->Cc[1][0], f1, 1.0f - f1, &undamped[0], 9U );
+    pK->Blend( &pData->Cc[0][9], &pData->Cc[1][9], f1, 1.0f - f1, &undamped[9], 3U );
+    pK->Blend( &pCc[0], &undamped[0], 0.7f, 0.3f, &pCc[0], 9U );
+    pK->Blend( &pCc[9], &undamped[9], 0.7f, 0.3f, &pCc[9], 3U );
+}
+
+static int float_differs( const float a, const float ref )
+{
+    return ( fabsf( a - ref ) > ( BENCH_REL_TOL * fabsf( ref ) + BENCH_ABS_TOL ) );
+}
+
+static long check( const BenchData_t *pData )
+{
+    float refLh[AWB_MAX_ILLUMINATION_PROFILES], simdLh[AWB_MAX_ILLUMINATION_PROFILES];
+    float refCc[12], simdCc[12];
+    static CamLscMatrix_t refLsc, simdLsc;
+
+    const uint16_t *a = &refLsc.LscMatrix[0].uCoeff[0];
+    const uint16_t *b = &simdLsc.LscMatrix[0].uCoeff[0];
+
+    long errors = 0;
+    int32_t i, j;
+
+    memcpy( &refLsc, &pData->Lsc[1], sizeof(refLsc) );
+    memcpy( &simdLsc, &pData->Lsc[1], sizeof(simdLsc) );
+    memcpy( refCc, pData->Cc[1], sizeof(refCc) );
+    memcpy( simdCc, pData->Cc[1], sizeof(simdCc) );
+
+    /* the damped results are carried over, so differences would add up */
+    for ( i = 0; i < BENCH_POINTS; i++ )
+    {
+        frame( &RefKernels, pData, i, refLh, &refLsc, refCc );
+        frame( &SimdKernels, pData, i, simdLh, &simdLsc, simdCc );
+
+        for ( j = 0; j < pData->Table.Num; j++ )
+        {
+            if ( float_differs( simdLh[j], refLh[j] ) )
+            {
+                if ( errors++ < 10 )
+                {
+                    printf( "point %d: likelihood[%d] %g, reference %g\n", i, j, simdLh[j], refLh[j] );
+                }
+            }
+        }
+
+        for ( j = 0; j < 12; j++ )
+        {
+            if ( float_differs( simdCc[j], refCc[j] ) )
+            {
+                if ( errors++ < 10 )
+                {
+                    printf( "point %d: cc[%d] %g, reference %g\n", i, j, simdCc[j], refCc[j] );
+                }
+            }
+        }
+
+        for ( j = 0; j < (int32_t)( sizeof(CamLscMatrix_t) / sizeof(uint16_t) ); j++ )
+        {
+            if ( a[j] != b[j] )
+            {
+                if ( errors++ < 10 )
+                {
+                    printf( "point %d: lsc[%d] %u, reference %u\n", i, j, b[j], a[j] );
+                }
+            }
+        }
+    }
+
+    return ( errors );
+}
+
+static double time_frames( const BenchKernels_t *pK, const BenchData_t *pData, const int loops )
+{
+    float lh[AWB_MAX_ILLUMINATION_PROFILES];
+    float cc[12];
+    static CamLscMatrix_t lsc;
+    long long t0;
+    int i;
+
+    memcpy( &lsc, &pData->Lsc[1], sizeof(lsc) );
+    memcpy( cc, pData->Cc[1], sizeof(cc) );
+
+    t0 = now_us();
+    for ( i = 0; i < loops; i++ )
+    {
+        frame( pK, pData, i % BENCH_POINTS, lh, &lsc, cc );
+    }
+
+    return ( (double)( now_us() - t0 ) / loops );
+}
+
+int main( int argc, char **argv )
+{
+    static BenchData_t data;
+    int loops = BENCH_DEF_LOOPS;
+    int profiles = BENCH_DEF_PROFILES;
+    double refUs, simdUs;
+    long errors;
+    int opt;
+
+    while ( ( opt = getopt( argc, argv, "n:p:s:h" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                loops = atoi( optarg );
+                break;
+            case 'p':
+                profiles = atoi( optarg );
+                break;
+            case 's':
+                seed = (uint32_t)strtoul( optarg, NULL, 0 );
+                break;
+            default:
+                usage( argv[0] );
+                return ( 0 );
+        }
+    }
+    if ( ( loops < 1 ) || ( profiles < 1 ) || ( profiles > AWB_MAX_ILLUMINATION_PROFILES ) )
+    {
+        usage( argv[0] );
+        return ( 1 );
+    }
+
+    make_data( &data, profiles );
+
+    errors = check( &data );
+
+    refUs  = time_frames( &RefKernels, &data, loops );
+    simdUs = time_frames( &SimdKernels, &data, loops );
+
+#ifdef AWB_SIMD_NEON
+    printf( "kernels: neon, %d profiles\n", profiles );
+#else
+    printf( "kernels: portable (same as reference), %d profiles\n", profiles );
+#endif
+    printf( "reference %8.3f us/frame\n", refUs );
+    printf( "kernels   %8.3f us/frame   (%.2fx)\n", simdUs, ( simdUs > 0.0 ) ? refUs / simdUs : 0.0 );
+    printf( "%ld mismatches in %d frames\n", errors, BENCH_POINTS );
+
+    return ( ( errors == 0 ) ? 0 : 1 );
+}
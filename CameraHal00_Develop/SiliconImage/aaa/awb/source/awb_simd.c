@@ -0,0 +1,341 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file awb_simd.c
+ *
+ * @brief   Per-frame kernels of the AWB, portable and NEON.
+ *
+ *****************************************************************************/
+#include <math.h>
+
+#include <ebase/types.h>
+#include <ebase/builtins.h>
+
+#include <common/cam_types.h>
+
+#include "awb.h"
+#include "awb_ctrl.h"
+#include "awb_simd.h"
+
+#ifdef AWB_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+
+
+/******************************************************************************
+ * local macro definitions
+ *****************************************************************************/
+#define AWB_LSC_COEFFS      ( CAM_4CH_COLOR_COMPONENT_MAX * 17 * 17 )   /**< all four tables as one array */
+
+#define AWB_LSC_ROUND       ( 65536U >> 1 )                             /**< 0.5 in 16.16 */
+
+
+
+/******************************************************************************
+ * local functions
+ *****************************************************************************/
+
+#ifdef AWB_SIMD_NEON
+
+/******************************************************************************
+ * AwbSimdExpNeon()
+ *
+ * expf() for four lanes, cephes polynomial after range reduction to
+ * [-ln2/2, ln2/2], about 2 ulp. Arguments below -87 give ~1e-38 instead of
+ * underflowing, the likelihoods are compared against DIVMIN only.
+ *****************************************************************************/
+static inline float32x4_t AwbSimdExpNeon
+(
+    float32x4_t x
+)
+{
+    float32x4_t fx;
+    float32x4_t tmp;
+    float32x4_t y;
+    float32x4_t z;
+    uint32x4_t  mask;
+    int32x4_t   n;
+
+    x = vminq_f32( x, vdupq_n_f32( 88.0f ) );
+    x = vmaxq_f32( x, vdupq_n_f32( -87.0f ) );
+
+    /* n = floor( x / ln2 + 0.5 ) */
+    fx   = vaddq_f32( vmulq_f32( x, vdupq_n_f32( 1.44269504088896341f ) ), vdupq_n_f32( 0.5f ) );
+    tmp  = vcvtq_f32_s32( vcvtq_s32_f32( fx ) );
+    mask = vcgtq_f32( tmp, fx );
+    fx   = vsubq_f32( tmp, vreinterpretq_f32_u32( vandq_u32( mask, vreinterpretq_u32_f32( vdupq_n_f32( 1.0f ) ) ) ) );
+
+    /* r = x - n * ln2, ln2 split in two for precision */
+    x = vsubq_f32( x, vmulq_f32( fx, vdupq_n_f32( 0.693359375f ) ) );
+    x = vsubq_f32( x, vmulq_f32( fx, vdupq_n_f32( -2.12194440e-4f ) ) );
+    z = vmulq_f32( x, x );
+
+    y = vdupq_n_f32( 1.9875691500e-4f );
+    y = vaddq_f32( vmulq_f32( y, x ), vdupq_n_f32( 1.3981999507e-3f ) );
+    y = vaddq_f32( vmulq_f32( y, x ), vdupq_n_f32( 8.3334519073e-3f ) );
+    y = vaddq_f32( vmulq_f32( y, x ), vdupq_n_f32( 4.1665795894e-2f ) );
+    y = vaddq_f32( vmulq_f32( y, x ), vdupq_n_f32( 1.6666665459e-1f ) );
+    y = vaddq_f32( vmulq_f32( y, x ), vdupq_n_f32( 5.0000001201e-1f ) );
+    y = vaddq_f32( vaddq_f32( vmulq_f32( y, z ), x ), vdupq_n_f32( 1.0f ) );
+
+    /* 2^n */
+    n = vcvtq_s32_f32( fx );
+    n = vshlq_n_s32( vaddq_s32( n, vdupq_n_s32( 127 ) ), 23 );
+
+    return ( vmulq_f32( y, vreinterpretq_f32_s32( n ) ) );
+}
+
+#endif /* AWB_SIMD_NEON */
+
+
+
+/******************************************************************************
+ * See header file for detailed comment.
+ *****************************************************************************/
+
+/******************************************************************************
+ * AwbSimdIlluTableInit()
+ *****************************************************************************/
+void AwbSimdIlluTableInit
+(
+    AwbIlluTable_t          *pTable,
+    CamIlluProfile_t        *pIlluProfiles[],
+    const int32_t           num
+)
+{
+    int32_t i;
+
+    MEMSET( pTable, 0, sizeof(*pTable) );
+
+    for ( i = 0; i < num; i++ )
+    {
+        pTable->MeanC1[i]       = pIlluProfiles[i]->GaussMeanValue.fCoeff[0];
+        pTable->MeanC2[i]       = pIlluProfiles[i]->GaussMeanValue.fCoeff[1];
+        pTable->Cov11[i]        = pIlluProfiles[i]->CovarianceMatrix.fCoeff[0];
+        pTable->Cov12[i]        = pIlluProfiles[i]->CovarianceMatrix.fCoeff[1];
+        pTable->Cov21[i]        = pIlluProfiles[i]->CovarianceMatrix.fCoeff[2];
+        pTable->Cov22[i]        = pIlluProfiles[i]->CovarianceMatrix.fCoeff[3];
+        pTable->GaussFactor[i]  = pIlluProfiles[i]->GaussFactor.fCoeff[0];
+    }
+
+    pTable->Num = num;
+}
+
+
+
+/******************************************************************************
+ * AwbSimdLikeHoodRef()
+ *****************************************************************************/
+void AwbSimdLikeHoodRef
+(
+    const AwbIlluTable_t    *pTable,
+    const float             fPcaC1,
+    const float             fPcaC2,
+    float                   *pLikeHood
+)
+{
+    float fPcaC1x;
+    float fPcaC2x;
+    float fVal1;
+    float fVal2;
+
+    int32_t i;
+
+    for ( i = 0; i < pTable->Num; i++ )
+    {
+        fPcaC1x = ( fPcaC1 - pTable->MeanC1[i] );
+        fPcaC2x = ( fPcaC2 - pTable->MeanC2[i] );
+
+        fVal1 = ( pTable->Cov11[i] * fPcaC1x ) + ( pTable->Cov12[i] * fPcaC2x );
+        fVal2 = ( pTable->Cov21[i] * fPcaC1x ) + ( pTable->Cov22[i] * fPcaC2x );
+
+        pLikeHood[i] = (float)( exp( -0.5 * (double)( fPcaC1x * fVal1 + fPcaC2x * fVal2 ) ) ) * pTable->GaussFactor[i];
+    }
+}
+
+
+
+/******************************************************************************
+ * AwbSimdLikeHood()
+ *****************************************************************************/
+void AwbSimdLikeHood
+(
+    const AwbIlluTable_t    *pTable,
+    const float             fPcaC1,
+    const float             fPcaC2,
+    float                   *pLikeHood
+)
+{
+#ifdef AWB_SIMD_NEON
+    const float32x4_t c1 = vdupq_n_f32( fPcaC1 );
+    const float32x4_t c2 = vdupq_n_f32( fPcaC2 );
+    const float32x4_t half = vdupq_n_f32( -0.5f );
+
+    int32_t i;
+
+    for ( i = 0; i < pTable->Num; i += 4 )
+    {
+        float32x4_t x1 = vsubq_f32( c1, vld1q_f32( &pTable->MeanC1[i] ) );
+        float32x4_t x2 = vsubq_f32( c2, vld1q_f32( &pTable->MeanC2[i] ) );
+
+        float32x4_t v1 = vaddq_f32( vmulq_f32( vld1q_f32( &pTable->Cov11[i] ), x1 ),
+                                    vmulq_f32( vld1q_f32( &pTable->Cov12[i] ), x2 ) );
+        float32x4_t v2 = vaddq_f32( vmulq_f32( vld1q_f32( &pTable->Cov21[i] ), x1 ),
+                                    vmulq_f32( vld1q_f32( &pTable->Cov22[i] ), x2 ) );
+
+        float32x4_t q = vaddq_f32( vmulq_f32( x1, v1 ), vmulq_f32( x2, v2 ) );
+
+        vst1q_f32( &pLikeHood[i], vmulq_f32( AwbSimdExpNeon( vmulq_f32( half, q ) ),
+                                             vld1q_f32( &pTable->GaussFactor[i] ) ) );
+    }
+#else
+    AwbSimdLikeHoodRef( pTable, fPcaC1, fPcaC2, pLikeHood );
+#endif
+}
+
+
+
+/******************************************************************************
+ * AwbSimdLscBlendRef()
+ *****************************************************************************/
+void AwbSimdLscBlendRef
+(
+    const CamLscMatrix_t    *pA,
+    const CamLscMatrix_t    *pB,
+    const uint32_t          fA,
+    const uint32_t          fB,
+    CamLscMatrix_t          *pRes
+)
+{
+    const uint16_t *a = &pA->LscMatrix[0].uCoeff[0];
+    const uint16_t *b = &pB->LscMatrix[0].uCoeff[0];
+    uint16_t *res = &pRes->LscMatrix[0].uCoeff[0];
+
+    uint32_t val;
+    int32_t i;
+
+    for ( i = 0; i < AWB_LSC_COEFFS; i++ )
+    {
+        val = ( fA * (uint32_t)a[i] ) + ( fB * (uint32_t)b[i] );
+
+        /* with round up (add 65536/2 <=> 0.5) before right shift */
+        res[i] = (uint16_t)( ( val + AWB_LSC_ROUND ) >> 16 );
+    }
+}
+
+
+
+/******************************************************************************
+ * AwbSimdLscBlend()
+ *****************************************************************************/
+void AwbSimdLscBlend
+(
+    const CamLscMatrix_t    *pA,
+    const CamLscMatrix_t    *pB,
+    const uint32_t          fA,
+    const uint32_t          fB,
+    CamLscMatrix_t          *pRes
+)
+{
+#ifdef AWB_SIMD_NEON
+    const uint16_t *a = &pA->LscMatrix[0].uCoeff[0];
+    const uint16_t *b = &pB->LscMatrix[0].uCoeff[0];
+    uint16_t *res = &pRes->LscMatrix[0].uCoeff[0];
+
+    const uint32x4_t round = vdupq_n_u32( AWB_LSC_ROUND );
+
+    uint32_t val;
+    int32_t i;
+
+    for ( i = 0; i <= ( AWB_LSC_COEFFS - 8 ); i += 8 )
+    {
+        uint16x8_t va = vld1q_u16( &a[i] );
+        uint16x8_t vb = vld1q_u16( &b[i] );
+
+        /* same modulo 2^32 arithmetic as the reference */
+        uint32x4_t lo = vmulq_n_u32( vmovl_u16( vget_low_u16( va ) ), fA );
+        uint32x4_t hi = vmulq_n_u32( vmovl_u16( vget_high_u16( va ) ), fA );
+        lo = vmlaq_n_u32( lo, vmovl_u16( vget_low_u16( vb ) ), fB );
+        hi = vmlaq_n_u32( hi, vmovl_u16( vget_high_u16( vb ) ), fB );
+
+        /* vrshrn would round without wrapping, so add the 0.5 explicitly */
+        lo = vaddq_u32( lo, round );
+        hi = vaddq_u32( hi, round );
+
+        vst1q_u16( &res[i], vcombine_u16( vshrn_n_u32( lo, 16 ), vshrn_n_u32( hi, 16 ) ) );
+    }
+
+    for ( ; i < AWB_LSC_COEFFS; i++ )
+    {
+        val = ( fA * (uint32_t)a[i] ) + ( fB * (uint32_t)b[i] );
+        res[i] = (uint16_t)( ( val + AWB_LSC_ROUND ) >> 16 );
+    }
+#else
+    AwbSimdLscBlendRef( pA, pB, fA, fB, pRes );
+#endif
+}
+
+
+
+/******************************************************************************
+ * AwbSimdBlendRef()
+ *****************************************************************************/
+void AwbSimdBlendRef
+(
+    const float             *pA,
+    const float             *pB,
+    const float             fA,
+    const float             fB,
+    float                   *pRes,
+    const uint32_t          num
+)
+{
+    uint32_t i;
+
+    for ( i = 0U; i < num; i++ )
+    {
+        pRes[i] = ( fA * pA[i] ) + ( fB * pB[i] );
+    }
+}
+
+
+
+/******************************************************************************
+ * AwbSimdBlend()
+ *****************************************************************************/
+void AwbSimdBlend
+(
+    const float             *pA,
+    const float             *pB,
+    const float             fA,
+    const float             fB,
+    float                   *pRes,
+    const uint32_t          num
+)
+{
+#ifdef AWB_SIMD_NEON
+    uint32_t i;
+
+    for ( i = 0U; ( i + 4U ) <= num; i += 4U )
+    {
+        vst1q_f32( &pRes[i], vaddq_f32( vmulq_n_f32( vld1q_f32( &pA[i] ), fA ),
+                                        vmulq_n_f32( vld1q_f32( &pB[i] ), fB ) ) );
+    }
+
+    for ( ; i < num; i++ )
+    {
+        pRes[i] = ( fA * pA[i] ) + ( fB * pB[i] );
+    }
+#else
+    AwbSimdBlendRef( pA, pB, fA, fB, pRes, num );
+#endif
+}
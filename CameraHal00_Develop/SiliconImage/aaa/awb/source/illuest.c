@@ -26,6 +26,7 @@
 #include "awb.h"
 #include "awb_ctrl.h"
 #include "illuest.h"
+#include "awb_simd.h"
 
 #include "interpolate.h"
 
@@ -119,12 +120,6 @@ RESULT AwbIlluEstProcessFrame
     float fPcaC1 = 0.0f;
     float fPcaC2 = 0.0f;
 
-    float fPcaC1x = 0.0f;
-    float fPcaC2x = 0.0f;
-
-    float fVal1 = 0.0f;
-    float fVal2 = 0.0f;
-
     float fWeightSum    = 0.0f;
     float fLikeHoodSum  = 0.0f;
     float fMaxWeight    = 0.0f;
@@ -182,30 +177,20 @@ RESULT AwbIlluEstProcessFrame
          (pAwbCtx->NormalizedMeansRgb.fGreen - pAwbCtx->pSvdMeanValue->fCoeff[1]) * pAwbCtx->pPcaMatrix->fCoeff[4] +
          (pAwbCtx->NormalizedMeansRgb.fBlue  - pAwbCtx->pSvdMeanValue->fCoeff[2]) * pAwbCtx->pPcaMatrix->fCoeff[5];
 
-    /* 4.) calculate the likelihood data */
-    for( i=0; i<pAwbCtx->NoIlluProfiles; i++)
-    {
-        /* MAP Lookup
-         *                            1/2 (fPcaC1 - µ01, fPcaC2 - µ02) x | E011 E012 | x | fPcaC1 - µ01 |
-         *  fLikeHood0 = Gaussfac.* e                                    | E021 E022 |   | fPcaC2 - µ02 |
-         *
-         *                            1/2 (fPcaC1 - µ11, fPcaC2 - µ12) x | E111 E112 | x | fPcaC1 - µ11 |
-         *  fLikeHood1 = Gaussfac.* e                                    | E121 E122 |   | fPcaC2 - µ12 |
-         *
-         *                            1/2 (fPcaC1 - µ21, fPcaC2 - µ22) x | E211 E212 | x | fPcaC1 - µ21 |
-         *  fLikeHood2 = Gaussfac.* e                                    | E221 E222 |   | fPcaC2 - µ22 |
-         *
-         */
-        fPcaC1x = (fPcaC1 - pAwbCtx->pIlluProfiles[i]->GaussMeanValue.fCoeff[0]);
-        fPcaC2x = (fPcaC2 - pAwbCtx->pIlluProfiles[i]->GaussMeanValue.fCoeff[1]);
-
-        fVal1 = (pAwbCtx->pIlluProfiles[i]->CovarianceMatrix.fCoeff[0] * fPcaC1x) 
-                        + (pAwbCtx->pIlluProfiles[i]->CovarianceMatrix.fCoeff[1] * fPcaC2x);
-        fVal2 = (pAwbCtx->pIlluProfiles[i]->CovarianceMatrix.fCoeff[2] * fPcaC1x)
-                        + (pAwbCtx->pIlluProfiles[i]->CovarianceMatrix.fCoeff[3] * fPcaC2x);
-
-        pAwbCtx->LikeHood[i] = (float)( exp( -0.5 * (double)( fPcaC1x * fVal1 + fPcaC2x * fVal2 ) ) ) * pAwbCtx->pIlluProfiles[i]->GaussFactor.fCoeff[0];
-    }
+    /* 4.) calculate the likelihood data
+     *
+     *    MAP Lookup
+     *                            1/2 (fPcaC1 - µ01, fPcaC2 - µ02) x | E011 E012 | x | fPcaC1 - µ01 |
+     *  fLikeHood0 = Gaussfac.* e                                    | E021 E022 |   | fPcaC2 - µ02 |
+     *
+     *                            1/2 (fPcaC1 - µ11, fPcaC2 - µ12) x | E111 E112 | x | fPcaC1 - µ11 |
+     *  fLikeHood1 = Gaussfac.* e                                    | E121 E122 |   | fPcaC2 - µ12 |
+     *
+     *                            1/2 (fPcaC1 - µ21, fPcaC2 - µ22) x | E211 E212 | x | fPcaC1 - µ21 |
+     *  fLikeHood2 = Gaussfac.* e                                    | E221 E222 |   | fPcaC2 - µ22 |
+     *
+     */
+    AwbSimdLikeHood( &pAwbCtx->IlluTable, fPcaC1, fPcaC2, pAwbCtx->LikeHood );
 
     // calculate the likehood sum
     for( i = 0; i < pAwbCtx->NoIlluProfiles; i++ )
@@ -233,8 +218,8 @@ RESULT AwbIlluEstProcessFrame
 
         fWeightSum += pAwbCtx->Weight[i];
 
-        TRACE( AWB_DEBUG, "%015s: liklyhood[%d]=%f weigth[%d]=%f Pca: %f %f Val: %f %f \n",
-                pAwbCtx->pIlluProfiles[i]->name, i, pAwbCtx->LikeHood[i], i, pAwbCtx->Weight[i], fPcaC1x, fPcaC2x, fVal1, fVal2 );
+        TRACE( AWB_DEBUG, "%015s: liklyhood[%d]=%f weigth[%d]=%f Pca: %f %f\n",
+                pAwbCtx->pIlluProfiles[i]->name, i, pAwbCtx->LikeHood[i], i, pAwbCtx->Weight[i], fPcaC1, fPcaC2 );
     }
 
     TRACE( AWB_DEBUG, "fLikeHoodSum=%f, %f\n", fLikeHoodSum, fWeightSum );
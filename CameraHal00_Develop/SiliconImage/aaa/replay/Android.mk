@@ -0,0 +1,38 @@
+#
+# RockChip Camera HAL
+#
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+# the stubs stand in for libisp_cameric_drv and libisp_hal, so the replay
+# runs on any target of the lunch combo, with or without an isp
+LOCAL_SRC_FILES:=\
+	source/aaa_replay.cpp\
+	source/replay_stubs.c\
+
+LOCAL_C_INCLUDES += \
+	bionic\
+	$(LOCAL_PATH)/include_priv\
+	$(LOCAL_PATH)/../../isi/include_priv\
+	$(LOCAL_PATH)/../../include/\
+	$(LOCAL_PATH)/../../isp_cam_api/include\
+	external/tinyxml2
+
+ifeq (1,$(strip $(shell expr $(PLATFORM_VERSION) \< 6.0)))
+LOCAL_C_INCLUDES += external/stlport/stlport
+endif
+
+LOCAL_CPPFLAGS := -fuse-cxa-atexit -Wall -Wextra -std=c++0x -Wformat-nonliteral
+LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
+LOCAL_CONLYFLAGS := -std=c99
+
+LOCAL_STATIC_LIBRARIES := libisp_calibdb libtinyxml2 \
+	libisp_aaa_aec libisp_aaa_awb libisp_aaa_af libisp_aaa_adpf libisp_aaa_adpcc \
+	libisp_isi libisp_cam_calibdb libisp_ebase libisp_oslayer libisp_common
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE:= aaa_replay
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,207 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+#ifndef __AAA_REPLAY_LOG_H__
+#define __AAA_REPLAY_LOG_H__
+
+/**
+ * @file aaa_replay_log.h
+ *
+ * @brief   Binary log of the 3A measurements of a capture.
+ *
+ *          The log starts with an AaaReplayLogHeader_t holding everything the
+ *          3A modules were configured with. Every measurement the cam-engine
+ *          processed follows as an AaaReplayRecord_t, directly followed by
+ *          Size bytes of the CamerIc measurement result. The result part of a
+ *          record is the state after the measurement was processed, the
+ *          replay compares against it. The exposure in the result is what the
+ *          sensor applied, so it differs from what the AEC asked for by up to
+ *          one sensor step.
+ *
+ *          All values are host endian, logs are written and read on little
+ *          endian machines only.
+ *
+ *****************************************************************************/
+/**
+ * @defgroup AAA_REPLAY 3A measurement log
+ * @{
+ *
+ */
+#include <ebase/types.h>
+#include <common/cam_types.h>
+
+#include <cameric_drv/cameric_drv_common.h>
+#include <cameric_drv/cameric_isp_hist_drv_api.h>
+#include <cameric_drv/cameric_isp_awb_drv_api.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+
+#define AAA_REPLAY_LOG_MAGIC        0x4c413341UL    /**< "A3AL" */
+#define AAA_REPLAY_LOG_VERSION      2UL
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Measurement type of a record, same order as the cam-engine
+ *          processes them.
+ *
+ *****************************************************************************/
+#define AAA_REPLAY_MEAS_HIST        0U              /**< CamerIcHistBins_t */
+#define AAA_REPLAY_MEAS_MEANLUMA    1U              /**< CamerIcMeanLuma_t */
+#define AAA_REPLAY_MEAS_AWB         2U              /**< CamerIcAwbMeasuringResult_t */
+#define AAA_REPLAY_MEAS_AFM         3U              /**< CamerIcAfmMeasuringResult_t */
+#define AAA_REPLAY_MEAS_MAX         4U
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Modules running when the recording was started.
+ *
+ *****************************************************************************/
+#define AAA_REPLAY_MODULE_AEC       0x01U
+#define AAA_REPLAY_MODULE_AWB       0x02U
+#define AAA_REPLAY_MODULE_AF        0x04U
+#define AAA_REPLAY_MODULE_ADPF      0x08U
+#define AAA_REPLAY_MODULE_ADPCC     0x10U
+
+
+
+/*****************************************************************************/
+/**
+ *          AaaReplayLogHeader_t
+ *
+ * @brief   Setup of the 3A modules and the sensor at start of the recording
+ *
+ *****************************************************************************/
+typedef struct AaaReplayLogHeader_s
+{
+    uint32_t                    Magic;                  /**< AAA_REPLAY_LOG_MAGIC */
+    uint32_t                    Version;                /**< AAA_REPLAY_LOG_VERSION */
+
+    uint32_t                    Modules;                /**< AAA_REPLAY_MODULE_* */
+    uint32_t                    Width;                  /**< isp output window */
+    uint32_t                    Height;
+
+    /* sensor */
+    uint32_t                    Resolution;             /**< IsiGetResolutionIss() */
+    float                       MinGain;
+    float                       MaxGain;
+    float                       MinIntegrationTime;
+    float                       MaxIntegrationTime;
+    float                       GainIncrement;          /**< sensor step, 0 if unknown */
+    float                       IntegrationTimeIncrement;
+    float                       StartGain;              /**< exposure when the recording started */
+    float                       StartIntegrationTime;
+
+    /* aec, see AecConfig_t */
+    uint32_t                    AecDampingMode;
+    uint32_t                    AecSemMode;
+    uint32_t                    AecFlicker;
+    uint32_t                    AecAfpsEnabled;
+    float                       AecSetPoint;
+    float                       AecClmTolerance;
+    float                       AecDampOverStill;
+    float                       AecDampUnderStill;
+    float                       AecDampOverVideo;
+    float                       AecDampUnderVideo;
+    float                       AecAfpsMaxGain;
+    CamerIcHistWeights_t        AecGridWeights;
+
+    /* awb, see AwbConfig_t and AwbStart() */
+    CamerIcAwbMeasuringConfig_t AwbMeasConfig;
+    uint32_t                    AwbMeasMode;
+    uint32_t                    AwbMode;
+    uint32_t                    AwbIlluIdx;
+    uint32_t                    AwbFlags;
+    uint32_t                    AwbCnt;                 /**< frames since the last AwbProcessFrame() */
+    uint32_t                    AwbDecimation;          /**< AwbProcessFrame() on every n-th frame */
+
+    /* af */
+    uint32_t                    AfSearch;               /**< AfSearchStrategy_t */
+} AaaReplayLogHeader_t;
+
+
+
+/*****************************************************************************/
+/**
+ *          AaaReplayResult_t
+ *
+ * @brief   Values the 3A modules programmed, after processing a measurement
+ *
+ *****************************************************************************/
+typedef struct AaaReplayResult_s
+{
+    float                       fGain;                  /**< sensor gain */
+    float                       fIntegrationTime;       /**< sensor integration time */
+    uint32_t                    LscHash;                /**< AaaReplayLscHash() of the lsc matrix */
+    CamerIcGains_t              Gains;                  /**< white balance gains */
+    CamerIc3x3Matrix_t          CcMatrix;               /**< cross talk matrix */
+    CamerIcXTalkOffset_t        CcOffset;               /**< cross talk offset */
+    uint16_t                    Reserved;
+} AaaReplayResult_t;
+
+
+
+/*****************************************************************************/
+/**
+ *          AaaReplayRecord_t
+ *
+ * @brief   One processed measurement, Size bytes of payload follow
+ *
+ *****************************************************************************/
+typedef struct AaaReplayRecord_s
+{
+    uint16_t                    Type;                   /**< AAA_REPLAY_MEAS_* */
+    uint16_t                    Size;                   /**< payload size */
+    uint32_t                    DeltaUs;                /**< time since the previous record */
+    AaaReplayResult_t           Result;
+} AaaReplayRecord_t;
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   FNV-1a over the four lsc tables, the log keeps only the hash of
+ *          the 4 x 17 x 17 correction values.
+ *
+ *****************************************************************************/
+static inline uint32_t AaaReplayLscHash
+(
+    const CamLscMatrix_t    *pLscMatrix
+)
+{
+    const uint8_t *p = (const uint8_t *)pLscMatrix->LscMatrix;
+    uint32_t hash = 2166136261UL;
+    uint32_t i;
+
+    for ( i = 0UL; i < sizeof(pLscMatrix->LscMatrix); i++ )
+    {
+        hash = ( hash ^ p[i] ) * 16777619UL;
+    }
+
+    return ( hash );
+}
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+/* @} AAA_REPLAY */
+
+#endif /* __AAA_REPLAY_LOG_H__ */
@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+#ifndef __REPLAY_STUBS_H__
+#define __REPLAY_STUBS_H__
+
+/**
+ * @file replay_stubs.h
+ *
+ * @brief   CamerIc, HAL and sensor stand-ins the 3A modules run against in
+ *          the replay.
+ *
+ *          The CamerIc functions the 3A modules call only store what they
+ *          are given, the getters return it. The sensor is an oracle: it
+ *          answers every exposure request with the exposure the real sensor
+ *          applied for the record being replayed, so the modules see the
+ *          same state as during the capture. The request itself is kept to
+ *          compare against the capture.
+ *
+ *****************************************************************************/
+#include <ebase/types.h>
+#include <common/return_codes.h>
+
+#include <cameric_drv/cameric_drv_api.h>
+#include <isi/isi.h>
+#include <isi/isi_iss.h>
+
+#include <replay/aaa_replay_log.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns the handle of the CamerIc stand-in and clears what was
+ *          programmed into it.
+ *
+ *****************************************************************************/
+CamerIcDrvHandle_t ReplayCamerIcReset
+(
+    void
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Fills gains, cross talk matrix and offset of a result with the
+ *          values programmed into the CamerIc stand-in.
+ *
+ *****************************************************************************/
+void ReplayCamerIcGetResult
+(
+    AaaReplayResult_t   *pResult
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Creates the replay sensor with the limits and the start exposure
+ *          of a log.
+ *
+ * @param   pHeader     log header
+ * @param   phSensor    returns the sensor handle
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_OUTOFMEM
+ *
+ *****************************************************************************/
+RESULT ReplaySensorCreate
+(
+    const AaaReplayLogHeader_t  *pHeader,
+    IsiSensorHandle_t           *phSensor
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Releases the replay sensor.
+ *
+ *****************************************************************************/
+void ReplaySensorRelease
+(
+    IsiSensorHandle_t   hSensor
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the exposure the sensor applies during the next record and
+ *          forgets the last request.
+ *
+ *****************************************************************************/
+void ReplaySensorNextRecord
+(
+    IsiSensorHandle_t   hSensor,
+    const float         fGain,
+    const float         fIntegrationTime
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns the exposure the AEC asked for while the current record
+ *          was processed, or the applied one if it didn't ask.
+ *
+ *****************************************************************************/
+void ReplaySensorGetRequest
+(
+    IsiSensorHandle_t   hSensor,
+    float               *pGain,
+    float               *pIntegrationTime
+);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REPLAY_STUBS_H__ */
@@ -0,0 +1,818 @@
+/******************************************************************************
+ *
+ * Copyright 2011, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file    aaa_replay.cpp
+ *
+ * @brief   Runs the 3A modules on a measurement log and checks and times them.
+ *
+ *          The log is written by CamEngineAaaRecordStart() on the target.
+ *          The modules are set up as described in the log header and fed
+ *          every recorded measurement in the order the cam-engine worker
+ *          processed them, against the CamerIc and sensor stand-ins of
+ *          replay_stubs.c. After each measurement the programmed values are
+ *          compared to the ones recorded, see aaa_replay_log.h for what is
+ *          compared how.
+ *
+ *          The first run is checked, all runs are timed. With -w the replayed
+ *          values are written to a new log, which then serves as reference
+ *          for later builds.
+ *
+ *          Exit code is 0 if all records matched, 1 on a mismatch and -1 if
+ *          the replay could not be run.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "calib_xml/calibdb.h"
+
+#include <aec/aec.h>
+#include <awb/awb.h>
+#include <af/af.h>
+#include <adpf/adpf.h>
+#include <adpcc/adpcc.h>
+
+#include <replay/aaa_replay_log.h>
+
+#include "replay_stubs.h"
+
+#define REPLAY_DEF_LOOPS        1
+#define REPLAY_MAX_REPORTED     10      /**< mismatches printed unless -q */
+
+enum
+{
+    REPLAY_MOD_AEC = 0,
+    REPLAY_MOD_AWB,
+    REPLAY_MOD_AF,
+    REPLAY_MOD_ADPF,
+    REPLAY_MOD_ADPCC,
+    REPLAY_MOD_MAX
+};
+
+static const char *ReplayModName[REPLAY_MOD_MAX] =
+{
+    "aec", "awb", "af", "adpf", "adpcc"
+};
+
+static const uint16_t ReplayMeasSize[AAA_REPLAY_MEAS_MAX] =
+{
+    sizeof( CamerIcHistBins_t ),
+    sizeof( CamerIcMeanLuma_t ),
+    sizeof( CamerIcAwbMeasuringResult_t ),
+    sizeof( CamerIcAfmMeasuringResult_t )
+};
+
+typedef union ReplayMeas_u
+{
+    CamerIcHistBins_t               Bins;
+    CamerIcMeanLuma_t               Luma;
+    CamerIcAwbMeasuringResult_t     Awb;
+    CamerIcAfmMeasuringResult_t     Afm;
+} ReplayMeas_t;
+
+typedef struct ReplayRecord_s
+{
+    AaaReplayRecord_t   Rec;
+    ReplayMeas_t        Meas;
+} ReplayRecord_t;
+
+typedef struct ReplayTime_s
+{
+    long long           Calls;
+    long long           SumUs;
+    long long           MaxUs;
+} ReplayTime_t;
+
+typedef struct ReplayModules_s
+{
+    IsiSensorHandle_t   hSensor;
+    CamerIcDrvHandle_t  hCamerIc;
+    AecHandle_t         hAec;
+    AwbHandle_t         hAwb;
+    AfHandle_t          hAf;
+    AdpfHandle_t        hAdpf;
+    AdpccHandle_t       hAdpcc;
+    uint32_t            AwbCnt;
+    uint32_t            AwbDecimation;
+} ReplayModules_t;
+
+typedef struct ReplayCheck_s
+{
+    float               Tolerance;      /**< -t, relative */
+    uint32_t            Lsb;            /**< -l, fixed point registers */
+    bool                Quiet;
+    long long           Mismatches;
+    long long           LscMismatches;
+} ReplayCheck_t;
+
+static long long now_us( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000 );
+}
+
+static void usage( const char *name )
+{
+    printf( "usage: %s [-n loops] [-t tolerance] [-l lsb] [-d awb decimation] [-w reference.log] [-q] sensor.xml capture.log\n", name );
+}
+
+static void time_add( ReplayTime_t *pTime, long long us )
+{
+    pTime->Calls++;
+    pTime->SumUs += us;
+    if ( us > pTime->MaxUs )
+    {
+        pTime->MaxUs = us;
+    }
+}
+
+static bool read_log
+(
+    const char                      *name,
+    AaaReplayLogHeader_t            *pHeader,
+    std::vector<ReplayRecord_t>     &records
+)
+{
+    FILE *f = fopen( name, "rb" );
+    ReplayRecord_t r;
+
+    if ( f == NULL )
+    {
+        fprintf( stderr, "can't open %s\n", name );
+        return ( false );
+    }
+
+    if ( ( fread( pHeader, sizeof(*pHeader), 1, f ) != 1 )
+            || ( pHeader->Magic != AAA_REPLAY_LOG_MAGIC )
+            || ( pHeader->Version != AAA_REPLAY_LOG_VERSION ) )
+    {
+        fprintf( stderr, "%s is no measurement log of this version\n", name );
+        fclose( f );
+        return ( false );
+    }
+
+    while ( fread( &r.Rec, sizeof(r.Rec), 1, f ) == 1 )
+    {
+        if ( ( r.Rec.Type >= AAA_REPLAY_MEAS_MAX ) || ( r.Rec.Size != ReplayMeasSize[r.Rec.Type] ) )
+        {
+            fprintf( stderr, "%s: record %u has type %u, size %u\n", name,
+                        (unsigned)records.size(), r.Rec.Type, r.Rec.Size );
+            fclose( f );
+            return ( false );
+        }
+
+        if ( fread( &r.Meas, r.Rec.Size, 1, f ) != 1 )
+        {
+            /* recording was cut off in the middle of a record */
+            break;
+        }
+
+        records.push_back( r );
+    }
+
+    fclose( f );
+
+    return ( true );
+}
+
+static bool write_log
+(
+    const char                          *name,
+    const AaaReplayLogHeader_t          *pHeader,
+    const std::vector<ReplayRecord_t>   &records
+)
+{
+    FILE *f = fopen( name, "wb" );
+    bool ok = ( f != NULL );
+    size_t i;
+
+    ok = ok && ( fwrite( pHeader, sizeof(*pHeader), 1, f ) == 1 );
+    for ( i = 0; ok && ( i < records.size() ); i++ )
+    {
+        ok = ( fwrite( &records[i].Rec, sizeof(records[i].Rec), 1, f ) == 1 )
+                && ( fwrite( &records[i].Meas, records[i].Rec.Size, 1, f ) == 1 );
+    }
+
+    if ( f != NULL )
+    {
+        ok = ( fclose( f ) == 0 ) && ok;
+    }
+
+    return ( ok );
+}
+
+static void modules_release( ReplayModules_t *pMods )
+{
+    if ( pMods->hAf != NULL )
+    {
+        (void)AfStop( pMods->hAf );
+        (void)AfRelease( pMods->hAf );
+    }
+    if ( pMods->hAdpcc != NULL )
+    {
+        (void)AdpccRelease( pMods->hAdpcc );
+    }
+    if ( pMods->hAdpf != NULL )
+    {
+        (void)AdpfRelease( pMods->hAdpf );
+    }
+    if ( pMods->hAwb != NULL )
+    {
+        (void)AwbStop( pMods->hAwb );
+        (void)AwbRelease( pMods->hAwb );
+    }
+    if ( pMods->hAec != NULL )
+    {
+        (void)AecStop( pMods->hAec );
+        (void)AecRelease( pMods->hAec );
+    }
+    ReplaySensorRelease( pMods->hSensor );
+
+    memset( pMods, 0, sizeof(*pMods) );
+}
+
+/* same setup as CamEngineModulesInit() and CamEngineModulesConfigure() */
+static RESULT modules_setup
+(
+    ReplayModules_t             *pMods,
+    const AaaReplayLogHeader_t  *pHeader,
+    CamCalibDbHandle_t          hCamCalibDb
+)
+{
+    RESULT result;
+
+    memset( pMods, 0, sizeof(*pMods) );
+    pMods->hCamerIc = ReplayCamerIcReset();
+    pMods->AwbCnt   = pHeader->AwbCnt;
+    pMods->AwbDecimation = ( pHeader->AwbDecimation > 0UL ) ? pHeader->AwbDecimation : 1UL;
+
+    result = ReplaySensorCreate( pHeader, &pMods->hSensor );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
+    /* aec */
+    {
+        AecInstanceConfig_t inst;
+        AecConfig_t config;
+
+        memset( &inst, 0, sizeof(inst) );
+        result = AecInit( &inst );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AecInit: %d\n", result );
+            return ( result );
+        }
+        pMods->hAec = inst.hAec;
+
+        memset( &config, 0, sizeof(config) );
+        config.hSensor          = pMods->hSensor;
+        config.hCamCalibDb      = hCamCalibDb;
+        config.DampingMode      = (AecDampingMode_t)pHeader->AecDampingMode;
+        config.SemMode          = (AecSemMode_t)pHeader->AecSemMode;
+        config.SetPoint         = pHeader->AecSetPoint;
+        config.ClmTolerance     = pHeader->AecClmTolerance;
+        config.DampOverStill    = pHeader->AecDampOverStill;
+        config.DampUnderStill   = pHeader->AecDampUnderStill;
+        config.DampOverVideo    = pHeader->AecDampOverVideo;
+        config.DampUnderVideo   = pHeader->AecDampUnderVideo;
+        config.AfpsEnabled      = pHeader->AecAfpsEnabled ? BOOL_TRUE : BOOL_FALSE;
+        config.AfpsMaxGain      = pHeader->AecAfpsMaxGain;
+        config.EcmFlickerSelect = (AecEcmFlickerPeriod_t)pHeader->AecFlicker;
+
+        result = AecConfigure( pMods->hAec, &config );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AecConfigure: %d\n", result );
+            return ( result );
+        }
+
+        result = AecSetMeanLumaGridWeights( pMods->hAec, pHeader->AecGridWeights );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AecSetMeanLumaGridWeights: %d\n", result );
+            return ( result );
+        }
+
+        if ( pHeader->Modules & AAA_REPLAY_MODULE_AEC )
+        {
+            result = AecStart( pMods->hAec );
+            if ( result != RET_SUCCESS )
+            {
+                fprintf( stderr, "AecStart: %d\n", result );
+                return ( result );
+            }
+
+            /* configure takes set point and damping from the database, the
+             * capture may have run with others (CamEngineModulesSetAecPoint) */
+            result = AecReConfigure( pMods->hAec, &config, NULL );
+            if ( result != RET_SUCCESS )
+            {
+                fprintf( stderr, "AecReConfigure: %d\n", result );
+                return ( result );
+            }
+        }
+    }
+
+    /* awb */
+    {
+        AwbInstanceConfig_t inst;
+        AwbConfig_t config;
+
+        memset( &inst, 0, sizeof(inst) );
+        result = AwbInit( &inst );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AwbInit: %d\n", result );
+            return ( result );
+        }
+        pMods->hAwb = inst.hAwb;
+
+        memset( &config, 0, sizeof(config) );
+        config.Mode              = AWB_MODE_AUTO;
+        config.hCamerIc          = pMods->hCamerIc;
+        config.width             = (uint16_t)pHeader->Width;
+        config.height            = (uint16_t)pHeader->Height;
+        config.framerate         = 0.0f;
+        config.hCamCalibDb       = hCamCalibDb;
+        config.fStableDeviation  = 0.1f;
+        config.fRestartDeviation = 0.2f;
+        config.MeasMode          = (CamerIcIspAwbMeasuringMode_t)pHeader->AwbMeasMode;
+        config.MeasConfig        = pHeader->AwbMeasConfig;
+        config.Flags             = pHeader->AwbFlags;
+
+        result = AwbConfigure( pMods->hAwb, &config );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AwbConfigure: %d\n", result );
+            return ( result );
+        }
+
+        if ( pHeader->Modules & AAA_REPLAY_MODULE_AWB )
+        {
+            result = AwbSetFlags( pMods->hAwb, pHeader->AwbFlags );
+            if ( result == RET_SUCCESS )
+            {
+                result = AwbStart( pMods->hAwb, (AwbMode_t)pHeader->AwbMode, pHeader->AwbIlluIdx );
+            }
+            if ( result != RET_SUCCESS )
+            {
+                fprintf( stderr, "AwbStart: %d\n", result );
+                return ( result );
+            }
+        }
+    }
+
+    /* af, has its own thread and is only timed */
+    if ( pHeader->Modules & AAA_REPLAY_MODULE_AF )
+    {
+        AfInstanceConfig_t inst;
+        AfConfig_t config;
+
+        memset( &inst, 0, sizeof(inst) );
+        result = AfInit( &inst );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AfInit: %d\n", result );
+            return ( result );
+        }
+        pMods->hAf = inst.hAf;
+
+        memset( &config, 0, sizeof(config) );
+        config.hCamerIc = pMods->hCamerIc;
+        config.hSensor  = pMods->hSensor;
+        config.Afss     = (AfSearchStrategy_t)pHeader->AfSearch;
+
+        result = AfConfigure( pMods->hAf, &config );
+        if ( result == RET_SUCCESS )
+        {
+            result = AfStart( pMods->hAf, (AfSearchStrategy_t)pHeader->AfSearch );
+        }
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AfStart: %d\n", result );
+            return ( result );
+        }
+    }
+
+    /* adpf and adpcc run once configured */
+    {
+        AdpfInstanceConfig_t inst;
+        AdpfConfig_t config;
+
+        memset( &inst, 0, sizeof(inst) );
+        result = AdpfInit( &inst );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AdpfInit: %d\n", result );
+            return ( result );
+        }
+        pMods->hAdpf = inst.hAdpf;
+
+        memset( &config, 0, sizeof(config) );
+        config.hCamerIc             = pMods->hCamerIc;
+        config.type                 = ADPF_USE_CALIB_DATABASE;
+        config.fSensorGain          = 1.0f;
+        config.data.db.width        = (uint16_t)pHeader->Width;
+        config.data.db.height       = (uint16_t)pHeader->Height;
+        config.data.db.framerate    = 0;
+        config.data.db.hCamCalibDb  = hCamCalibDb;
+
+        result = AdpfConfigure( pMods->hAdpf, &config );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AdpfConfigure: %d\n", result );
+            return ( result );
+        }
+
+        if ( !( pHeader->Modules & AAA_REPLAY_MODULE_ADPF ) )
+        {
+            (void)AdpfStop( pMods->hAdpf );
+        }
+    }
+
+    {
+        AdpccInstanceConfig_t inst;
+        AdpccConfig_t config;
+
+        memset( &inst, 0, sizeof(inst) );
+        result = AdpccInit( &inst );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AdpccInit: %d\n", result );
+            return ( result );
+        }
+        pMods->hAdpcc = inst.hAdpcc;
+
+        memset( &config, 0, sizeof(config) );
+        config.hCamerIc             = pMods->hCamerIc;
+        config.type                 = ADPCC_USE_CALIB_DATABASE;
+        config.fSensorGain          = 1.0f;
+        config.data.db.width        = (uint16_t)pHeader->Width;
+        config.data.db.height       = (uint16_t)pHeader->Height;
+        config.data.db.framerate    = 0;
+        config.data.db.hCamCalibDb  = hCamCalibDb;
+
+        result = AdpccConfigure( pMods->hAdpcc, &config );
+        if ( result != RET_SUCCESS )
+        {
+            fprintf( stderr, "AdpccConfigure: %d\n", result );
+            return ( result );
+        }
+
+        if ( !( pHeader->Modules & AAA_REPLAY_MODULE_ADPCC ) )
+        {
+            (void)AdpccStop( pMods->hAdpcc );
+        }
+    }
+
+    return ( RET_SUCCESS );
+}
+
+/* same order as the cam-engine worker, see CamEngineAaaProcessHistogram() ff. */
+static void process
+(
+    ReplayModules_t     *pMods,
+    ReplayRecord_t      *pRecord,
+    ReplayTime_t        *pTimes
+)
+{
+    float fGain = 0.0f;
+    float fTi = 0.0f;
+    bool_t settled = BOOL_FALSE;
+    long long t0;
+
+    switch ( pRecord->Rec.Type )
+    {
+        case AAA_REPLAY_MEAS_HIST:
+            t0 = now_us();
+            (void)AecClmExecute( pMods->hAec, pRecord->Meas.Bins );
+            time_add( &pTimes[REPLAY_MOD_AEC], now_us() - t0 );
+
+            (void)AecGetCurrentGain( pMods->hAec, &fGain );
+
+            t0 = now_us();
+            (void)AdpfProcessFrame( pMods->hAdpf, fGain );
+            time_add( &pTimes[REPLAY_MOD_ADPF], now_us() - t0 );
+
+            t0 = now_us();
+            (void)AdpccProcessFrame( pMods->hAdpcc, fGain );
+            time_add( &pTimes[REPLAY_MOD_ADPCC], now_us() - t0 );
+
+            t0 = now_us();
+            (void)AwbSetHistogram( pMods->hAwb, pRecord->Meas.Bins );
+            time_add( &pTimes[REPLAY_MOD_AWB], now_us() - t0 );
+            break;
+
+        case AAA_REPLAY_MEAS_MEANLUMA:
+            t0 = now_us();
+            (void)AecSemExecute( pMods->hAec, pRecord->Meas.Luma );
+            time_add( &pTimes[REPLAY_MOD_AEC], now_us() - t0 );
+            break;
+
+        case AAA_REPLAY_MEAS_AWB:
+            if ( ( RET_SUCCESS == AecSettled( pMods->hAec, &settled ) ) && ( BOOL_TRUE == settled ) )
+            {
+                if ( pMods->AwbCnt >= ( pMods->AwbDecimation - 1UL ) )
+                {
+                    pMods->AwbCnt = 0UL;
+
+                    (void)AecGetCurrentGain( pMods->hAec, &fGain );
+                    (void)AecGetCurrentIntegrationTime( pMods->hAec, &fTi );
+
+                    t0 = now_us();
+                    (void)AwbProcessFrame( pMods->hAwb, &pRecord->Meas.Awb, fGain, fTi );
+                    time_add( &pTimes[REPLAY_MOD_AWB], now_us() - t0 );
+                }
+                else
+                {
+                    ++pMods->AwbCnt;
+                }
+            }
+            break;
+
+        case AAA_REPLAY_MEAS_AFM:
+            if ( pMods->hAf != NULL )
+            {
+                t0 = now_us();
+                (void)AfProcessFrame( pMods->hAf, &pRecord->Meas.Afm );
+                time_add( &pTimes[REPLAY_MOD_AF], now_us() - t0 );
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void result_get
+(
+    ReplayModules_t     *pMods,
+    AaaReplayResult_t   *pResult
+)
+{
+    CamLscMatrix_t LscMatrix;
+
+    memset( pResult, 0, sizeof(*pResult) );
+
+    ReplaySensorGetRequest( pMods->hSensor, &pResult->fGain, &pResult->fIntegrationTime );
+    ReplayCamerIcGetResult( pResult );
+
+    if ( AwbGetLscMatrix( pMods->hAwb, &LscMatrix ) == RET_SUCCESS )
+    {
+        pResult->LscHash = AaaReplayLscHash( &LscMatrix );
+    }
+}
+
+static bool near_float( float a, float b, float step, float tol )
+{
+    return ( fabsf( a - b ) <= ( step + tol * fabsf( b ) ) );
+}
+
+static bool near_reg( uint32_t a, uint32_t b, uint32_t lsb )
+{
+    return ( ( ( a > b ) ? ( a - b ) : ( b - a ) ) <= lsb );
+}
+
+static void check
+(
+    ReplayCheck_t               *pCheck,
+    const AaaReplayLogHeader_t  *pHeader,
+    size_t                      idx,
+    const AaaReplayResult_t     *pGot,
+    const AaaReplayResult_t     *pExp
+)
+{
+    char what[64] = "";
+    bool lsc = false;
+    int i;
+
+    if ( !near_float( pGot->fGain, pExp->fGain, pHeader->GainIncrement, pCheck->Tolerance ) )
+    {
+        snprintf( what, sizeof(what), "gain %f/%f", pGot->fGain, pExp->fGain );
+    }
+    else if ( !near_float( pGot->fIntegrationTime, pExp->fIntegrationTime,
+                    pHeader->IntegrationTimeIncrement, pCheck->Tolerance ) )
+    {
+        snprintf( what, sizeof(what), "ti %f/%f", pGot->fIntegrationTime, pExp->fIntegrationTime );
+    }
+    else if ( !near_reg( pGot->Gains.Red, pExp->Gains.Red, pCheck->Lsb )
+                || !near_reg( pGot->Gains.GreenR, pExp->Gains.GreenR, pCheck->Lsb )
+                || !near_reg( pGot->Gains.GreenB, pExp->Gains.GreenB, pCheck->Lsb )
+                || !near_reg( pGot->Gains.Blue, pExp->Gains.Blue, pCheck->Lsb ) )
+    {
+        snprintf( what, sizeof(what), "wb gains %u %u %u %u/%u %u %u %u",
+                    pGot->Gains.Red, pGot->Gains.GreenR, pGot->Gains.GreenB, pGot->Gains.Blue,
+                    pExp->Gains.Red, pExp->Gains.GreenR, pExp->Gains.GreenB, pExp->Gains.Blue );
+    }
+    else if ( !near_reg( pGot->CcOffset.Red, pExp->CcOffset.Red, pCheck->Lsb )
+                || !near_reg( pGot->CcOffset.Green, pExp->CcOffset.Green, pCheck->Lsb )
+                || !near_reg( pGot->CcOffset.Blue, pExp->CcOffset.Blue, pCheck->Lsb ) )
+    {
+        snprintf( what, sizeof(what), "cc offset" );
+    }
+    else
+    {
+        for ( i = 0; i < 9; i++ )
+        {
+            if ( !near_reg( pGot->CcMatrix.Coeff[i], pExp->CcMatrix.Coeff[i], pCheck->Lsb ) )
+            {
+                snprintf( what, sizeof(what), "cc matrix [%d] 0x%x/0x%x", i,
+                            pGot->CcMatrix.Coeff[i], pExp->CcMatrix.Coeff[i] );
+                break;
+            }
+        }
+    }
+
+    if ( ( what[0] == '\0' ) && ( pGot->LscHash != pExp->LscHash ) )
+    {
+        /* a hash has no tolerance, only count it when exact match is asked for */
+        snprintf( what, sizeof(what), "lsc 0x%08x/0x%08x", pGot->LscHash, pExp->LscHash );
+        lsc = ( pCheck->Tolerance != 0.0f ) || ( pCheck->Lsb != 0UL );
+    }
+
+    if ( what[0] == '\0' )
+    {
+        return;
+    }
+
+    if ( lsc )
+    {
+        pCheck->LscMismatches++;
+    }
+    else
+    {
+        pCheck->Mismatches++;
+    }
+
+    if ( !pCheck->Quiet && ( ( pCheck->Mismatches + pCheck->LscMismatches ) <= REPLAY_MAX_REPORTED ) )
+    {
+        printf( "record %u: %s%s\n", (unsigned)idx, what, lsc ? " (not counted)" : "" );
+    }
+}
+
+int main( int argc, char **argv )
+{
+    std::vector<ReplayRecord_t> records;
+    std::vector<ReplayRecord_t> replayed;
+    AaaReplayLogHeader_t header;
+    ReplayTime_t times[REPLAY_MOD_MAX];
+    ReplayCheck_t chk;
+    const char *outlog = NULL;
+    int decimation = 0;
+    const char *xml, *capture;
+    long long frames = 0, captureUs = 0, sumUs = 0;
+    int loops = REPLAY_DEF_LOOPS;
+    int opt, loop, i;
+    size_t n;
+
+    memset( &chk, 0, sizeof(chk) );
+    memset( times, 0, sizeof(times) );
+
+    while ( ( opt = getopt( argc, argv, "n:t:l:d:w:qh" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                loops = atoi( optarg );
+                break;
+            case 't':
+                chk.Tolerance = (float)atof( optarg );
+                break;
+            case 'l':
+                chk.Lsb = (uint32_t)strtoul( optarg, NULL, 0 );
+                break;
+            case 'd':
+                decimation = atoi( optarg );
+                break;
+            case 'w':
+                outlog = optarg;
+                break;
+            case 'q':
+                chk.Quiet = true;
+                break;
+            default:
+                usage( argv[0] );
+                return ( 0 );
+        }
+    }
+    if ( ( ( optind + 2 ) > argc ) || ( loops < 1 ) )
+    {
+        usage( argv[0] );
+        return ( -1 );
+    }
+
+    xml     = argv[optind];
+    capture = argv[optind + 1];
+
+    if ( !read_log( capture, &header, records ) )
+    {
+        return ( -1 );
+    }
+
+    /* what-if run, the recorded values then only match up to the first
+     * frame the awb is run differently */
+    if ( decimation > 0 )
+    {
+        header.AwbDecimation = (uint32_t)decimation;
+        header.AwbCnt        = 0UL;
+    }
+
+    CalibDb db;
+    if ( !db.CreateCalibDb( xml ) )
+    {
+        fprintf( stderr, "parsing %s failed\n", xml );
+        return ( -1 );
+    }
+
+    for ( n = 0; n < records.size(); n++ )
+    {
+        captureUs += records[n].Rec.DeltaUs;
+        if ( records[n].Rec.Type == AAA_REPLAY_MEAS_HIST )
+        {
+            frames++;
+        }
+    }
+
+    replayed = records;
+
+    for ( loop = 0; loop < loops; loop++ )
+    {
+        ReplayModules_t mods;
+
+        if ( modules_setup( &mods, &header, db.GetCalibDbHandle() ) != RET_SUCCESS )
+        {
+            modules_release( &mods );
+            return ( -1 );
+        }
+
+        for ( n = 0; n < records.size(); n++ )
+        {
+            ReplaySensorNextRecord( mods.hSensor, records[n].Rec.Result.fGain, records[n].Rec.Result.fIntegrationTime );
+
+            process( &mods, &records[n], times );
+
+            if ( loop == 0 )
+            {
+                AaaReplayResult_t *pOut = &replayed[n].Rec.Result;
+
+                result_get( &mods, pOut );
+                check( &chk, &header, n, pOut, &records[n].Rec.Result );
+
+                /* keep what the sensor applied, later replays need the same input */
+                pOut->fGain            = records[n].Rec.Result.fGain;
+                pOut->fIntegrationTime = records[n].Rec.Result.fIntegrationTime;
+            }
+        }
+
+        modules_release( &mods );
+    }
+
+    printf( "%s: %u records, %lld frames, %.2f s captured, %d runs\n", capture,
+                (unsigned)records.size(), frames, captureUs / 1000000.0, loops );
+    for ( i = 0; i < REPLAY_MOD_MAX; i++ )
+    {
+        if ( times[i].Calls == 0 )
+        {
+            continue;
+        }
+        sumUs += times[i].SumUs;
+        printf( "%-6s %10lld calls   mean %8.2f us   max %8lld us\n", ReplayModName[i],
+                    times[i].Calls, (double)times[i].SumUs / times[i].Calls, times[i].MaxUs );
+    }
+    if ( frames > 0 )
+    {
+        printf( "3a     %10.2f us per frame\n", (double)sumUs / ( frames * loops ) );
+    }
+    printf( "mismatches: %lld", chk.Mismatches );
+    if ( chk.LscMismatches > 0 )
+    {
+        printf( " (+%lld lsc not counted)", chk.LscMismatches );
+    }
+    printf( "\n" );
+
+    if ( ( outlog != NULL ) && !write_log( outlog, &header, replayed ) )
+    {
+        fprintf( stderr, "can't write %s\n", outlog );
+        return ( -1 );
+    }
+
+    return ( ( chk.Mismatches == 0 ) ? 0 : 1 );
+}
@@ -0,0 +1,863 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file replay_stubs.c
+ *
+ * @brief   CamerIc, HAL and sensor stand-ins for the 3A replay.
+ *
+ *          Linked instead of libisp_cameric_drv and libisp_hal, like
+ *          hal_mockup but without any device behind it.
+ *
+ *****************************************************************************/
+#include <ebase/types.h>
+#include <ebase/trace.h>
+#include <ebase/builtins.h>
+
+#include <common/return_codes.h>
+
+#include <hal/hal_api.h>
+
+#include <cameric_drv/cameric_drv_api.h>
+#include <cameric_drv/cameric_isp_drv_api.h>
+#include <cameric_drv/cameric_isp_awb_drv_api.h>
+#include <cameric_drv/cameric_isp_lsc_drv_api.h>
+#include <cameric_drv/cameric_isp_afm_drv_api.h>
+#include <cameric_drv/cameric_isp_dpf_drv_api.h>
+#include <cameric_drv/cameric_isp_dpcc_drv_api.h>
+#include <cameric_drv/cameric_isp_flt_drv_api.h>
+
+#include <isi/isi.h>
+#include <isi/isi_iss.h>
+#include "isi_priv.h"
+
+#include "replay_stubs.h"
+
+
+
+/******************************************************************************
+ * local macro definitions
+ *****************************************************************************/
+CREATE_TRACER( REPLAY_STUB_INFO , "REPLAY-STUB: ", INFO , 0 );
+CREATE_TRACER( REPLAY_STUB_ERROR, "REPLAY-STUB: ", ERROR, 1 );
+
+#define REPLAY_SENSOR_MAX_STEP      64UL    /**< focus steps of the replay lens */
+
+
+
+/******************************************************************************
+ * local type definitions
+ *****************************************************************************/
+
+/* what the 3A modules programmed */
+typedef struct ReplayCamerIc_s
+{
+    CamerIcGains_t          Gains;
+    CamerIc3x3Matrix_t      CcMatrix;
+    CamerIcXTalkOffset_t    CcOffset;
+} ReplayCamerIc_t;
+
+typedef struct ReplaySensorContext_s
+{
+    IsiSensorContext_t      IsiCtx;             /**< common context of ISI and ISI driver layer; @note: MUST BE FIRST IN DRIVER CONTEXT */
+
+    uint32_t                Resolution;
+    float                   MinGain;
+    float                   MaxGain;
+    float                   MinIntegrationTime;
+    float                   MaxIntegrationTime;
+    float                   GainIncrement;
+    float                   IntegrationTimeIncrement;
+
+    float                   Gain;               /**< applied now */
+    float                   IntegrationTime;
+    float                   NextGain;           /**< applied on the next request */
+    float                   NextIntegrationTime;
+    bool_t                  Requested;          /**< aec asked during this record */
+    float                   RequestGain;
+    float                   RequestIntegrationTime;
+
+    uint32_t                FocusPos;
+} ReplaySensorContext_t;
+
+
+
+/******************************************************************************
+ * local variable declarations
+ *****************************************************************************/
+static ReplayCamerIc_t ReplayCamerIc;
+
+/* never dereferenced, HalAddRef() only needs it to be set */
+static int ReplayHal;
+
+
+
+/******************************************************************************
+ * HAL
+ *****************************************************************************/
+RESULT HalAddRef( HalHandle_t HalHandle )
+{
+    return ( ( HalHandle == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT HalDelRef( HalHandle_t HalHandle )
+{
+    return ( ( HalHandle == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT HalReadI2CMem( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint32_t reg_address, uint8_t reg_addr_size, uint8_t *p_read_buffer, uint32_t byte_size )
+{
+    UNUSED_PARAM( HalHandle );
+    UNUSED_PARAM( bus_num );
+    UNUSED_PARAM( slave_addr );
+    UNUSED_PARAM( reg_address );
+    UNUSED_PARAM( reg_addr_size );
+    UNUSED_PARAM( p_read_buffer );
+    UNUSED_PARAM( byte_size );
+
+    return ( RET_NOTSUPP );
+}
+
+RESULT HalWriteI2CMem( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint32_t reg_address, uint8_t reg_addr_size, uint8_t *p_write_buffer, uint32_t byte_size )
+{
+    UNUSED_PARAM( HalHandle );
+    UNUSED_PARAM( bus_num );
+    UNUSED_PARAM( slave_addr );
+    UNUSED_PARAM( reg_address );
+    UNUSED_PARAM( reg_addr_size );
+    UNUSED_PARAM( p_write_buffer );
+    UNUSED_PARAM( byte_size );
+
+    return ( RET_NOTSUPP );
+}
+
+RESULT HalWriteI2CBatch( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint8_t reg_addr_size, const HalI2cMsg_t *p_msgs, uint32_t num_msgs )
+{
+    UNUSED_PARAM( HalHandle );
+    UNUSED_PARAM( bus_num );
+    UNUSED_PARAM( slave_addr );
+    UNUSED_PARAM( reg_addr_size );
+    UNUSED_PARAM( p_msgs );
+    UNUSED_PARAM( num_msgs );
+
+    return ( RET_NOTSUPP );
+}
+
+
+
+/******************************************************************************
+ * CamerIc, awb
+ *****************************************************************************/
+RESULT CamerIcIspAwbSetMeasuringMode
+(
+    CamerIcDrvHandle_t                  handle,
+    const CamerIcIspAwbMeasuringMode_t  mode,
+    const CamerIcAwbMeasuringConfig_t   *pMeasConfig
+)
+{
+    UNUSED_PARAM( handle );
+    UNUSED_PARAM( mode );
+
+    return ( ( pMeasConfig == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspAwbGetGains
+(
+    CamerIcDrvHandle_t  handle,
+    CamerIcGains_t      *pGains
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pGains == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pGains = ReplayCamerIc.Gains;
+
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspAwbSetGains
+(
+    CamerIcDrvHandle_t      handle,
+    const CamerIcGains_t    *pGains
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pGains == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    ReplayCamerIc.Gains = *pGains;
+
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspGetCrossTalkCoefficients
+(
+    CamerIcDrvHandle_t  handle,
+    CamerIc3x3Matrix_t  *pCTalkCoefficients
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pCTalkCoefficients == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pCTalkCoefficients = ReplayCamerIc.CcMatrix;
+
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspSetCrossTalkCoefficients
+(
+    CamerIcDrvHandle_t          handle,
+    const CamerIc3x3Matrix_t    *pCTalkCoefficients
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pCTalkCoefficients == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    ReplayCamerIc.CcMatrix = *pCTalkCoefficients;
+
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspGetCrossTalkOffset
+(
+    CamerIcDrvHandle_t          handle,
+    CamerIcXTalkOffset_t        *pCrossTalkOffset
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pCrossTalkOffset == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pCrossTalkOffset = ReplayCamerIc.CcOffset;
+
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspSetCrossTalkOffset
+(
+    CamerIcDrvHandle_t          handle,
+    const CamerIcXTalkOffset_t  *pCrossTalkOffset
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pCrossTalkOffset == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    ReplayCamerIc.CcOffset = *pCrossTalkOffset;
+
+    return ( RET_SUCCESS );
+}
+
+/* the lsc matrix is taken from the awb module, see AwbGetLscMatrix() */
+RESULT CamerIcIspLscSetLenseShadeSectorConfig
+(
+    CamerIcDrvHandle_t                  handle,
+    const CamerIcIspLscSectorConfig_t   *pLscConfig
+)
+{
+    UNUSED_PARAM( handle );
+
+    return ( ( pLscConfig == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspLscSetLenseShadeCorrectionMatrix
+(
+    CamerIcDrvHandle_t              handle,
+    const uint16_t                  *pLscRDataTbl,
+    const uint16_t                  *pLscGRDataTbl,
+    const uint16_t                  *pLscGBDataTbl,
+    const uint16_t                  *pLscBDataTbl
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( (pLscRDataTbl == NULL) || (pLscGRDataTbl == NULL) || (pLscGBDataTbl == NULL) || (pLscBDataTbl == NULL) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamerIc, af
+ *****************************************************************************/
+bool_t CamerIcIspAfmMeasuringWindowIsEnabled
+(
+    CamerIcDrvHandle_t              handle,
+    const CamerIcIspAfmWindowId_t   WdwId
+)
+{
+    UNUSED_PARAM( handle );
+
+    /* the cam-engine measures with window A only */
+    return ( ( WdwId == CAMERIC_ISP_AFM_WINDOW_A ) ? BOOL_TRUE : BOOL_FALSE );
+}
+
+
+
+/******************************************************************************
+ * CamerIc, adpf
+ *****************************************************************************/
+RESULT CamerIcIspDpfEnable( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpfDisable( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpfConfig( CamerIcDrvHandle_t handle, const CamerIcDpfConfig_t *pDpfCfg )
+{
+    UNUSED_PARAM( handle );
+    return ( ( pDpfCfg == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpfSetNoiseFunctionGain( CamerIcDrvHandle_t handle, const CamerIcGains_t *pNfGains )
+{
+    UNUSED_PARAM( handle );
+    return ( ( pNfGains == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpfSetNoiseLevelLookUp( CamerIcDrvHandle_t handle, const CamerIcDpfNoiseLevelLookUp_t *pDpfNll )
+{
+    UNUSED_PARAM( handle );
+    return ( ( pDpfNll == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpfSetStrength( CamerIcDrvHandle_t handle, const CamerIcDpfInvStrength_t *pDpfStrength )
+{
+    UNUSED_PARAM( handle );
+    return ( ( pDpfStrength == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspFltSetFilterParameter
+(
+    CamerIcDrvHandle_t                      handle,
+    const CamerIcIspFltDeNoiseLevel_t       DeNoiseLevel,
+    const CamerIcIspFltSharpeningLevel_t    SharpeningLevel
+)
+{
+    UNUSED_PARAM( handle );
+    UNUSED_PARAM( DeNoiseLevel );
+    UNUSED_PARAM( SharpeningLevel );
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamerIc, adpcc
+ *****************************************************************************/
+RESULT CamerIcIspDpccEnable( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpccDisable( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpccSetStaticConfig( CamerIcDrvHandle_t handle, CamerIcDpccStaticConfig_t *pConfig )
+{
+    UNUSED_PARAM( handle );
+    return ( ( pConfig == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpccSetStaticDemoConfigGain12( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpccSetStaticDemoConfigGain24( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+RESULT CamerIcIspDpccSetStaticDemoConfigGain48( CamerIcDrvHandle_t handle )
+{
+    UNUSED_PARAM( handle );
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * sensor
+ *****************************************************************************/
+static RESULT ReplaySensorCreateIss
+(
+    IsiSensorInstanceConfig_t   *pConfig
+)
+{
+    ReplaySensorContext_t *pCtx;
+
+    pCtx = ( ReplaySensorContext_t * )malloc( sizeof(ReplaySensorContext_t) );
+    if ( pCtx == NULL )
+    {
+        return ( RET_OUTOFMEM );
+    }
+    MEMSET( pCtx, 0, sizeof(ReplaySensorContext_t) );
+
+    pCtx->IsiCtx.HalHandle  = pConfig->HalHandle;
+    pCtx->IsiCtx.pSensor    = pConfig->pSensor;
+
+    pConfig->hSensor = ( IsiSensorHandle_t )pCtx;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorReleaseIss
+(
+    IsiSensorHandle_t   handle
+)
+{
+    free( handle );
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorExposureControlIss
+(
+    IsiSensorHandle_t   handle,
+    const float         NewGain,
+    const float         NewIntegrationTime,
+    uint8_t             *pNumberOfFramesToSkip,
+    float               *pSetGain,
+    float               *pSetIntegrationTime
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( (pNumberOfFramesToSkip == NULL) || (pSetGain == NULL) || (pSetIntegrationTime == NULL) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    pCtx->Requested              = BOOL_TRUE;
+    pCtx->RequestGain            = NewGain;
+    pCtx->RequestIntegrationTime = NewIntegrationTime;
+
+    /* answer with what the real sensor did */
+    pCtx->Gain            = pCtx->NextGain;
+    pCtx->IntegrationTime = pCtx->NextIntegrationTime;
+
+    *pNumberOfFramesToSkip = 0U;
+    *pSetGain              = pCtx->Gain;
+    *pSetIntegrationTime   = pCtx->IntegrationTime;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetGainLimitsIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pMinGain,
+    float               *pMaxGain
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( (pMinGain == NULL) || (pMaxGain == NULL) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pMinGain = pCtx->MinGain;
+    *pMaxGain = pCtx->MaxGain;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetIntegrationTimeLimitsIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pMinIntegrationTime,
+    float               *pMaxIntegrationTime
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( (pMinIntegrationTime == NULL) || (pMaxIntegrationTime == NULL) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pMinIntegrationTime = pCtx->MinIntegrationTime;
+    *pMaxIntegrationTime = pCtx->MaxIntegrationTime;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetCurrentExposureIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pSetGain,
+    float               *pSetIntegrationTime
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( (pSetGain == NULL) || (pSetIntegrationTime == NULL) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pSetGain            = pCtx->Gain;
+    *pSetIntegrationTime = pCtx->IntegrationTime;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetGainIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pSetGain
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( pSetGain == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pSetGain = pCtx->Gain;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetGainIncrementIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pIncr
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( pIncr == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pIncr = pCtx->GainIncrement;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetIntegrationTimeIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pSetIntegrationTime
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( pSetIntegrationTime == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pSetIntegrationTime = pCtx->IntegrationTime;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetIntegrationTimeIncrementIss
+(
+    IsiSensorHandle_t   handle,
+    float               *pIncr
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( pIncr == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pIncr = pCtx->IntegrationTimeIncrement;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorGetResolutionIss
+(
+    IsiSensorHandle_t   handle,
+    uint32_t            *pSetResolution
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( pSetResolution == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pSetResolution = pCtx->Resolution;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorMdiInitMotoDriveMds
+(
+    IsiSensorHandle_t   handle
+)
+{
+    UNUSED_PARAM( handle );
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorMdiSetupMotoDrive
+(
+    IsiSensorHandle_t   handle,
+    uint32_t            *pMaxStep
+)
+{
+    UNUSED_PARAM( handle );
+
+    if ( pMaxStep == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pMaxStep = REPLAY_SENSOR_MAX_STEP;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorMdiFocusSet
+(
+    IsiSensorHandle_t   handle,
+    const uint32_t      AbsStep
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    pCtx->FocusPos = ( AbsStep > REPLAY_SENSOR_MAX_STEP ) ? REPLAY_SENSOR_MAX_STEP : AbsStep;
+
+    return ( RET_SUCCESS );
+}
+
+static RESULT ReplaySensorMdiFocusGet
+(
+    IsiSensorHandle_t   handle,
+    uint32_t            *pAbsStep
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )handle;
+
+    if ( pAbsStep == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    *pAbsStep = pCtx->FocusPos;
+
+    return ( RET_SUCCESS );
+}
+
+static IsiSensor_t ReplaySensor =
+{
+    .pszName                            = "replay",
+    .pIsiCreateSensorIss                = ReplaySensorCreateIss,
+    .pIsiReleaseSensorIss               = ReplaySensorReleaseIss,
+    .pIsiExposureControlIss             = ReplaySensorExposureControlIss,
+    .pIsiGetGainLimitsIss               = ReplaySensorGetGainLimitsIss,
+    .pIsiGetIntegrationTimeLimitsIss    = ReplaySensorGetIntegrationTimeLimitsIss,
+    .pIsiGetCurrentExposureIss          = ReplaySensorGetCurrentExposureIss,
+    .pIsiGetGainIss                     = ReplaySensorGetGainIss,
+    .pIsiGetGainIncrementIss            = ReplaySensorGetGainIncrementIss,
+    .pIsiGetIntegrationTimeIss          = ReplaySensorGetIntegrationTimeIss,
+    .pIsiGetIntegrationTimeIncrementIss = ReplaySensorGetIntegrationTimeIncrementIss,
+    .pIsiGetResolutionIss               = ReplaySensorGetResolutionIss,
+    .pIsiMdiInitMotoDriveMds            = ReplaySensorMdiInitMotoDriveMds,
+    .pIsiMdiSetupMotoDrive              = ReplaySensorMdiSetupMotoDrive,
+    .pIsiMdiFocusSet                    = ReplaySensorMdiFocusSet,
+    .pIsiMdiFocusGet                    = ReplaySensorMdiFocusGet,
+};
+
+
+
+/******************************************************************************
+ * See header file for detailed comment.
+ *****************************************************************************/
+
+/******************************************************************************
+ * ReplayCamerIcReset()
+ *****************************************************************************/
+CamerIcDrvHandle_t ReplayCamerIcReset
+(
+    void
+)
+{
+    MEMSET( &ReplayCamerIc, 0, sizeof(ReplayCamerIc) );
+
+    return ( ( CamerIcDrvHandle_t )&ReplayCamerIc );
+}
+
+
+
+/******************************************************************************
+ * ReplayCamerIcGetResult()
+ *****************************************************************************/
+void ReplayCamerIcGetResult
+(
+    AaaReplayResult_t   *pResult
+)
+{
+    pResult->Gains    = ReplayCamerIc.Gains;
+    pResult->CcMatrix = ReplayCamerIc.CcMatrix;
+    pResult->CcOffset = ReplayCamerIc.CcOffset;
+}
+
+
+
+/******************************************************************************
+ * ReplaySensorCreate()
+ *****************************************************************************/
+RESULT ReplaySensorCreate
+(
+    const AaaReplayLogHeader_t  *pHeader,
+    IsiSensorHandle_t           *phSensor
+)
+{
+    IsiSensorInstanceConfig_t config;
+    ReplaySensorContext_t *pCtx;
+    RESULT result;
+
+    MEMSET( &config, 0, sizeof(config) );
+    config.HalHandle = ( HalHandle_t )&ReplayHal;
+    config.pSensor   = &ReplaySensor;
+
+    result = IsiCreateSensorIss( &config );
+    if ( result != RET_SUCCESS )
+    {
+        TRACE( REPLAY_STUB_ERROR, "%s: can't create sensor (%d)\n", __FUNCTION__, result );
+        return ( result );
+    }
+
+    pCtx = ( ReplaySensorContext_t * )config.hSensor;
+    pCtx->Resolution                = pHeader->Resolution;
+    pCtx->MinGain                   = pHeader->MinGain;
+    pCtx->MaxGain                   = pHeader->MaxGain;
+    pCtx->MinIntegrationTime        = pHeader->MinIntegrationTime;
+    pCtx->MaxIntegrationTime        = pHeader->MaxIntegrationTime;
+    pCtx->GainIncrement             = pHeader->GainIncrement;
+    pCtx->IntegrationTimeIncrement  = pHeader->IntegrationTimeIncrement;
+    pCtx->Gain                      = pHeader->StartGain;
+    pCtx->IntegrationTime           = pHeader->StartIntegrationTime;
+    pCtx->NextGain                  = pHeader->StartGain;
+    pCtx->NextIntegrationTime       = pHeader->StartIntegrationTime;
+
+    TRACE( REPLAY_STUB_INFO, "%s: 0x%08x, gain %f..%f, ti %f..%f\n", __FUNCTION__, pCtx->Resolution,
+            pCtx->MinGain, pCtx->MaxGain, pCtx->MinIntegrationTime, pCtx->MaxIntegrationTime );
+
+    *phSensor = config.hSensor;
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * ReplaySensorRelease()
+ *****************************************************************************/
+void ReplaySensorRelease
+(
+    IsiSensorHandle_t   hSensor
+)
+{
+    if ( hSensor != NULL )
+    {
+        (void)IsiReleaseSensorIss( hSensor );
+    }
+}
+
+
+
+/******************************************************************************
+ * ReplaySensorNextRecord()
+ *****************************************************************************/
+void ReplaySensorNextRecord
+(
+    IsiSensorHandle_t   hSensor,
+    const float         fGain,
+    const float         fIntegrationTime
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )hSensor;
+
+    pCtx->NextGain            = fGain;
+    pCtx->NextIntegrationTime = fIntegrationTime;
+    pCtx->Requested           = BOOL_FALSE;
+}
+
+
+
+/******************************************************************************
+ * ReplaySensorGetRequest()
+ *****************************************************************************/
+void ReplaySensorGetRequest
+(
+    IsiSensorHandle_t   hSensor,
+    float               *pGain,
+    float               *pIntegrationTime
+)
+{
+    ReplaySensorContext_t *pCtx = ( ReplaySensorContext_t * )hSensor;
+
+    if ( BOOL_TRUE == pCtx->Requested )
+    {
+        *pGain            = pCtx->RequestGain;
+        *pIntegrationTime = pCtx->RequestIntegrationTime;
+    }
+    else
+    {
+        /* nothing asked for, the sensor keeps its exposure */
+        pCtx->Gain            = pCtx->NextGain;
+        pCtx->IntegrationTime = pCtx->NextIntegrationTime;
+        *pGain                = pCtx->Gain;
+        *pIntegrationTime     = pCtx->IntegrationTime;
+    }
+}
@@ -57,7 +57,8 @@ typedef struct MediaBuffer_s
     uint32_t      baseSize;     /**< Base size of buffer (can differ from actual buffer
                                      size, set in ScmiBuffer). */
     uint32_t      lockCount;    /**< Counting how many times buffer is used. 0 means
-                                     buffer belongs to pool and is free. */
+                                     buffer belongs to pool and is free. Only changed
+                                     atomically, see @ref MediaBufIncLockCount. */
     void*         pOwner;
     uint32_t      duration;     /**< Used to calculate duration */
     bool_t        syncPoint;    /**< Indicates if buffer contains a reference frame. */
@@ -268,6 +269,73 @@ extern RESULT MediaBufLockBuffer(MediaBuffer_t*   pBuf);
 extern RESULT MediaBufUnlockBuffer(MediaBuffer_t*   pBuf);
 
 
+/*****************************************************************************/
+/**
+ * @brief   Returns the current lock count of a media buffer.
+ *
+ * @param   pBuf    Buffer of interest.
+ *
+ * @return  Lock count, 0 means the buffer is free.
+ *****************************************************************************/
+INLINE uint32_t MediaBufGetLockCount(const MediaBuffer_t *pBuf)
+{
+    DCT_ASSERT(pBuf != NULL);
+
+    return __atomic_load_n(&pBuf->lockCount, __ATOMIC_ACQUIRE);
+}
+
+
+/*****************************************************************************/
+/**
+ * @brief   Atomically increments the lock count of a media buffer.
+ *
+ * @param   pBuf    Buffer of interest.
+ *
+ * @return  Lock count after the increment.
+ *****************************************************************************/
+INLINE uint32_t MediaBufIncLockCount(MediaBuffer_t *pBuf)
+{
+    DCT_ASSERT(pBuf != NULL);
+
+    return __atomic_add_fetch(&pBuf->lockCount, 1U, __ATOMIC_ACQ_REL);
+}
+
+
+/*****************************************************************************/
+/**
+ * @brief   Atomically decrements the lock count of a media buffer, unless
+ *          it is already 0.
+ *
+ * @param   pBuf    Buffer of interest.
+ * @param   pCount  Lock count after the decrement.
+ *
+ * @return  Status of operation.
+ * @retval  RET_SUCCESS     lock count decremented
+ * @retval  RET_FAILURE     buffer was not locked
+ *****************************************************************************/
+INLINE RESULT MediaBufDecLockCount(MediaBuffer_t *pBuf, uint32_t *pCount)
+{
+    uint32_t count;
+
+    DCT_ASSERT(pBuf != NULL);
+    DCT_ASSERT(pCount != NULL);
+
+    count = __atomic_load_n(&pBuf->lockCount, __ATOMIC_RELAXED);
+    do
+    {
+        if (count == 0U)
+        {
+            return RET_FAILURE;
+        }
+    } while (!__atomic_compare_exchange_n(&pBuf->lockCount, &count, count - 1U, BOOL_FALSE,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    *pCount = count - 1U;
+
+    return RET_SUCCESS;
+}
+
+
 #if defined (__cplusplus)
 }
 #endif
@@ -85,6 +85,12 @@ extern "C" {
  */
 #define MAX_NUM_REGISTERED_CB   3
 
+/**
+ * @brief   Upper limit for maxBufNum, the free-slot bitmap is sized for it.
+ */
+#define MEDIA_BUF_POOL_MAX_BUF_NUM  128U
+#define MEDIA_BUF_POOL_MAP_WORDS    ( MEDIA_BUF_POOL_MAX_BUF_NUM / 32U )
+
 /**
  * @brief   Parameter id, used when calling @ref MediaBufPoolSetParameter.
  */
@@ -171,6 +177,7 @@ typedef struct MediaBufPool_s
     uint16_t             highWatermark;         /**< if value is reached high watermark callback is triggered */
     uint16_t             lowWatermark;          /**< if value is reached low watermark callback is triggered */
     uint32_t             index;                 /**< Pointer to current index in buffer array (internal use) */
+    uint32_t             freeMap[MEDIA_BUF_POOL_MAP_WORDS]; /**< Bit i set: pBufArray[i] is free (internal use) */
     MediaBufPoolNotify_t notify[MAX_NUM_REGISTERED_CB];   /**< Array with info about users registered for notification */
 } MediaBufPool_t;
 
@@ -214,6 +221,9 @@ typedef struct MediaBufPoolMemory_s
 
 /**
  * @brief   Get a free buffer from the MediaBufferPool.
+ *          Lock free, may be called from several threads at once. In random
+ *          access mode the free buffer is found through a bitmap instead of
+ *          scanning the buffer array.
  *
  * @param   pBufPool Pointer to the MediaBufferPool.
  *
@@ -232,6 +242,7 @@ void MediaBufPoolBufferFilled(MediaBufPool_t* pBufPool, MediaBuffer_t* pBuf);
 
 /**
  * @brief   Free a buffer from the bufferpool.
+ *          Lock free, may race with @ref MediaBufPoolGetBuffer.
  *
  * @param   pBuf    Buffer to free
  *
@@ -21,7 +21,6 @@
  * </pre>
  *
  *****************************************************************************/
-#include <oslayer/oslayer.h>
 
 #include "media_buffer.h"
 #include "media_buffer_pool.h"
@@ -49,7 +48,7 @@ RESULT MediaBufLockBuffer(MediaBuffer_t* pBuf)
     DCT_ASSERT(pBuf != NULL);
     DCT_ASSERT(pBuf->pOwner != NULL);
 
-    osAtomicIncrement( &pBuf->lockCount );
+    (void) MediaBufIncLockCount( pBuf );
 
     return RET_SUCCESS;
 }
@@ -66,8 +65,14 @@ RESULT MediaBufUnlockBuffer(MediaBuffer_t* pBuf)
 		return RET_FAILURE;
 	}
 
-    uint32_t val = osAtomicDecrement( &pBuf->lockCount );
+    uint32_t val;
 
+    if (MediaBufDecLockCount( pBuf, &val ) != RET_SUCCESS)
+    {
+        return RET_FAILURE;
+    }
+
+    /* only the caller dropping the last lock sees 0 */
     if(val == 0U)
     {
         MediaBufPoolFreeBuffer(pBuf->pOwner, pBuf);
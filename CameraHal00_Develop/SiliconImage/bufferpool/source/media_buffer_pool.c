@@ -35,6 +35,84 @@
 
 USE_TRACER( HAL_INFO  );
 
+
+/******************************************************************************
+ * MediaBufPoolInitFreeMap
+ *
+ * Marks the first bufNum buffers as free, buffers beyond bufNum are never
+ * handed out.
+ *****************************************************************************/
+static void MediaBufPoolInitFreeMap(MediaBufPool_t* pBufPool)
+{
+    uint32_t i;
+
+    (void) MEMSET(pBufPool->freeMap, 0, sizeof(pBufPool->freeMap));
+    for(i = 0U; i < pBufPool->bufNum; i++)
+    {
+        pBufPool->freeMap[i / 32U] |= (1U << (i % 32U));
+    }
+}
+
+
+/******************************************************************************
+ * MediaBufPoolTakeFreeSlot
+ *
+ * Finds and clears a set bit in the free map, searching from the current
+ * index so buffers are still handed out round robin. Returns the slot or
+ * -1 if no buffer is free.
+ *****************************************************************************/
+static int32_t MediaBufPoolTakeFreeSlot(MediaBufPool_t* pBufPool)
+{
+    uint32_t words = ((uint32_t)pBufPool->bufNum + 31U) / 32U;
+    uint32_t start = __atomic_load_n(&pBufPool->index, __ATOMIC_RELAXED);
+    uint32_t w     = start / 32U;
+    uint32_t n;
+    uint32_t mask;
+    uint32_t bits;
+    uint32_t bit;
+
+    /* one extra round for the bits below start in the first word */
+    for(n = 0U; n <= words; n++, w = (w + 1U < words) ? (w + 1U) : 0U)
+    {
+        mask = (n == 0U) ? (~0U << (start % 32U)) : ~0U;
+        bits = __atomic_load_n(&pBufPool->freeMap[w], __ATOMIC_ACQUIRE);
+        while((bits & mask) != 0U)
+        {
+            bit = (uint32_t)__builtin_ctz(bits & mask);
+            if(__atomic_compare_exchange_n(&pBufPool->freeMap[w], &bits, bits & ~(1U << bit),
+                                           BOOL_FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                return (int32_t)(w * 32U + bit);
+            }
+            /* bits was reloaded by the failed exchange */
+        }
+    }
+
+    return -1;
+}
+
+
+/******************************************************************************
+ * MediaBufPoolTakeRingSlot
+ *
+ * Ringbuffer mode: only the buffer at index may be taken, no random access.
+ *****************************************************************************/
+static int32_t MediaBufPoolTakeRingSlot(MediaBufPool_t* pBufPool)
+{
+    uint32_t i    = __atomic_load_n(&pBufPool->index, __ATOMIC_RELAXED);
+    uint32_t zero = 0U;
+
+    if(!__atomic_compare_exchange_n(&pBufPool->pBufArray[i].lockCount, &zero, 1U,
+                                    BOOL_FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+        return -1;
+    }
+
+    (void) __atomic_fetch_and(&pBufPool->freeMap[i / 32U], ~(1U << (i % 32U)), __ATOMIC_RELAXED);
+
+    return (int32_t)i;
+}
+
 /******************************************************************************
  * MediaBufPoolGetSize
  *****************************************************************************/
@@ -52,6 +130,11 @@ RESULT MediaBufPoolGetSize(MediaBufPoolConfig_t* pPoolConfig)
         return RET_WRONG_CONFIG;
     }
 
+    if(pPoolConfig->maxBufNum > MEDIA_BUF_POOL_MAX_BUF_NUM)
+    {
+        return RET_WRONG_CONFIG;
+    }
+
     /* size of extra metadata */
     pPoolConfig->metaDataMemSize = pPoolConfig->maxBufNum * pPoolConfig->metaDataSizeMediaBuf;
 
@@ -106,7 +189,8 @@ RESULT MediaBufPoolCreate(MediaBufPool_t*       pBufPool,
     }
 
     if((pPoolConfig->bufNum == 0U) || (pPoolConfig->bufSize == 0U) ||
-       (pPoolConfig->maxBufNum < pPoolConfig->bufNum))
+       (pPoolConfig->maxBufNum < pPoolConfig->bufNum) ||
+       (pPoolConfig->maxBufNum > MEDIA_BUF_POOL_MAX_BUF_NUM))
     {
         return RET_WRONG_CONFIG;
     }
@@ -181,6 +265,8 @@ RESULT MediaBufPoolCreate(MediaBufPool_t*       pBufPool,
         MediaBufInit(&pBufPool->pBufArray[i]);
     }
 
+    MediaBufPoolInitFreeMap(pBufPool);
+
     return ret;
 }
 
@@ -218,6 +304,8 @@ RESULT MediaBufPoolReset(MediaBufPool_t* pBufPool)
         MediaBufInit(&pBufPool->pBufArray[i]);
     }
 
+    MediaBufPoolInitFreeMap(pBufPool);
+
     return RET_SUCCESS;
 }
 
@@ -363,51 +451,49 @@ RESULT MediaBufPoolGetParameter(MediaBufPool_t*       pBufPool,
 MediaBuffer_t* MediaBufPoolGetBuffer(MediaBufPool_t* pBufPool)
 {
     MediaBuffer_t *pMediaBuffer;
+    int32_t       slot;
+    uint32_t      next;
 
     DCT_ASSERT(pBufPool != NULL);
 
-    for(;;)
+    if(__atomic_load_n(&pBufPool->freeBufNum, __ATOMIC_ACQUIRE) == 0U)
     {
-        /* if the requested number of buffers is greater than the maximum then wait*/
-        while( pBufPool->freeBufNum == 0U )
-        {
-            return  NULL;
-        }
+        return NULL;
+    }
 
-        /* at least one buffer is free*/
-        for(;;)
-        {
-            if(!pBufPool->pBufArray[pBufPool->index].lockCount)
-            {
-                /* adjust the resources count*/
-                pBufPool->freeBufNum--;
-                pBufPool->pBufArray[pBufPool->index].lockCount = 1;
-                pBufPool->pBufArray[pBufPool->index].pOwner = pBufPool;
-                pMediaBuffer = &pBufPool->pBufArray[pBufPool->index];
-
-                if(++(pBufPool->index) >= pBufPool->bufNum)
-                {
-                    pBufPool->index = 0U;
-                }
-
-                return pMediaBuffer;
-            }
-            else
-            {
-                /* pBufPool->uiIndex points to the next buffer to be checked for a get empty request.*/
-                /* If that buffer is locked, no media buffer is returned, because random access is*/
-                /* not allowed in ringbuffer mode.*/
-                if(pBufPool->flags & BUFPOOL_RINGBUFFER)
-                {
-                    return  NULL;
-                }
-            }
-            if(++(pBufPool->index) >= pBufPool->bufNum)
-            {
-                pBufPool->index = 0U;
-            }
-        }
-    } /* for( ;;)*/
+    if(pBufPool->flags & BUFPOOL_RINGBUFFER)
+    {
+        /* pBufPool->index points to the next buffer to be checked for a get empty request.*/
+        /* If that buffer is locked, no media buffer is returned, because random access is*/
+        /* not allowed in ringbuffer mode.*/
+        slot = MediaBufPoolTakeRingSlot(pBufPool);
+    }
+    else
+    {
+        slot = MediaBufPoolTakeFreeSlot(pBufPool);
+    }
+
+    if(slot < 0)
+    {
+        return NULL;
+    }
+
+    /* the slot is ours now, nobody else touches the buffer until it is freed */
+    pMediaBuffer = &pBufPool->pBufArray[slot];
+    pMediaBuffer->pOwner = pBufPool;
+    __atomic_store_n(&pMediaBuffer->lockCount, 1U, __ATOMIC_RELEASE);
+
+    /* adjust the resources count*/
+    (void) __atomic_sub_fetch(&pBufPool->freeBufNum, 1U, __ATOMIC_ACQ_REL);
+
+    next = (uint32_t)slot + 1U;
+    if(next >= pBufPool->bufNum)
+    {
+        next = 0U;
+    }
+    __atomic_store_n(&pBufPool->index, next, __ATOMIC_RELAXED);
+
+    return pMediaBuffer;
 }
 
 
@@ -417,13 +503,14 @@ MediaBuffer_t* MediaBufPoolGetBuffer(MediaBufPool_t* pBufPool)
 void MediaBufPoolBufferFilled(MediaBufPool_t* pBufPool, MediaBuffer_t* pBuf)
 {
     uint32_t i;
+    uint32_t fillLevel;
 
     DCT_ASSERT(pBufPool != NULL);
     DCT_ASSERT(pBuf != NULL);
 
     /* increase fill level */
-    pBufPool->fillLevel++;
-    DCT_ASSERT(pBufPool->fillLevel <= pBufPool->bufNum);
+    fillLevel = __atomic_add_fetch(&pBufPool->fillLevel, 1U, __ATOMIC_ACQ_REL);
+    DCT_ASSERT(fillLevel <= pBufPool->bufNum);
 
     /* inform registered users about new full buffer */
     for(i = 0; i < MAX_NUM_REGISTERED_CB; i++)
@@ -437,7 +524,7 @@ void MediaBufPoolBufferFilled(MediaBufPool_t* pBufPool, MediaBuffer_t* pBuf)
     /* inform registered users about entering of the high watermark critical region.
      * If the last buffer flag is set we have to inform the user too.
      * Otherwise he would wait infinitly for the hit of the high watermark.*/
-    if ( pBufPool->highWatermark && (pBufPool->highWatermark == pBufPool->fillLevel) )
+    if ( pBufPool->highWatermark && (pBufPool->highWatermark == fillLevel) )
     {
         for(i = 0; i < MAX_NUM_REGISTERED_CB; i++)
         {
@@ -449,7 +536,7 @@ void MediaBufPoolBufferFilled(MediaBufPool_t* pBufPool, MediaBuffer_t* pBuf)
     }
 
     /* inform registered users about leaving of the low watermark critical region */
-    if ( pBufPool->lowWatermark && ((pBufPool->lowWatermark + 1) == (int32_t) pBufPool->fillLevel) )
+    if ( pBufPool->lowWatermark && ((pBufPool->lowWatermark + 1) == (int32_t) fillLevel) )
     {
         for(i = 0; i < MAX_NUM_REGISTERED_CB; i++)
         {
@@ -467,28 +554,42 @@ void MediaBufPoolBufferFilled(MediaBufPool_t* pBufPool, MediaBuffer_t* pBuf)
  *****************************************************************************/
 void MediaBufPoolFreeBuffer(MediaBufPool_t* pBufPool, MediaBuffer_t *pBuf)
 {
-    int32_t i;
+    int32_t  i;
+    uint32_t slot;
+    uint32_t fillLevel;
 
     DCT_ASSERT(pBufPool != NULL);
     DCT_ASSERT(pBuf != NULL);
 
-    pBuf->lockCount = 0;
-    pBufPool->freeBufNum++;
+    slot = (uint32_t)(pBuf - pBufPool->pBufArray);
+    DCT_ASSERT(slot < pBufPool->maxBufNum);
 
+    fillLevel = __atomic_load_n(&pBufPool->fillLevel, __ATOMIC_RELAXED);
     if (pBuf->isFull)
     {
-    	//DCT_ASSERT(pBufPool->fillLevel > 0);
-    	if ( pBufPool->fillLevel > 0 )
-    	{
-    		pBufPool->fillLevel--;
-    	}
-    	else
-    	{
-    		pBufPool->fillLevel = 0;
-    	}
+        //DCT_ASSERT(pBufPool->fillLevel > 0);
+        do
+        {
+            if ( fillLevel == 0U )
+            {
+                break;
+            }
+        } while (!__atomic_compare_exchange_n(&pBufPool->fillLevel, &fillLevel, fillLevel - 1U,
+                                              BOOL_FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+        if ( fillLevel > 0U )
+        {
+            fillLevel--;
+        }
         pBuf->isFull = BOOL_FALSE;
     }
 
+    /* count first, so a racing get never sees more buffers taken than were free */
+    (void) __atomic_add_fetch(&pBufPool->freeBufNum, 1U, __ATOMIC_ACQ_REL);
+
+    /* publish the buffer, from here on it may be handed out again */
+    __atomic_store_n(&pBuf->lockCount, 0U, __ATOMIC_RELEASE);
+    (void) __atomic_fetch_or(&pBufPool->freeMap[slot / 32U], (1U << (slot % 32U)), __ATOMIC_RELEASE);
+
     /* inform registered users about released buffer */
     for(i = 0; i < MAX_NUM_REGISTERED_CB; i++)
     {
@@ -500,7 +601,7 @@ void MediaBufPoolFreeBuffer(MediaBufPool_t* pBufPool, MediaBuffer_t *pBuf)
 
     /* inform registered users about entering of the low watermark critical region */
     if(pBufPool->lowWatermark &&
-       (pBufPool->lowWatermark == pBufPool->fillLevel))
+       (pBufPool->lowWatermark == fillLevel))
     {
         for(i = 0; i < MAX_NUM_REGISTERED_CB; i++)
         {
@@ -513,7 +614,7 @@ void MediaBufPoolFreeBuffer(MediaBufPool_t* pBufPool, MediaBuffer_t *pBuf)
 
     /* inform registered users about leaving of the high watermark critical region */
     if(pBufPool->highWatermark &&
-       ((uint32_t)(pBufPool->highWatermark - 1) == pBufPool->fillLevel) )
+       ((uint32_t)(pBufPool->highWatermark - 1) == fillLevel) )
     {
         for(i = 0; i < MAX_NUM_REGISTERED_CB; i++)
         {
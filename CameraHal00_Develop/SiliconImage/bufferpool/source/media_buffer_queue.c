@@ -305,17 +305,17 @@ MediaBuffer_t* MediaBufQueueGetFullBuffer(MediaBufQueue_t *pBufQueue)
 RESULT MediaBufQueueReleaseBuffer(MediaBufQueue_t* pBufQueue,
                                           MediaBuffer_t*   pBuf)
 {
+    uint32_t lockCount;
+
     DCT_ASSERT(pBufQueue != NULL);
     DCT_ASSERT(pBuf != NULL);
     
-    if (pBuf->lockCount == 0U)
+    if (MediaBufDecLockCount(pBuf, &lockCount) != RET_SUCCESS)
     {
         return RET_FAILURE;
     }
 
-    pBuf->lockCount--;
-
-    if(pBuf->lockCount == 0U)
+    if(lockCount == 0U)
     {
         MediaBufPoolFreeBuffer(&pBufQueue->bufPool, pBuf);
         
@@ -340,7 +340,7 @@ RESULT MediaBufQueueFlush(MediaBufQueue_t *pBufQueue)
     while(MediaBufQueueFullBuffersAvailable(pBufQueue))
     {
         pBuf = MediaBufQueueGetFullBuffer(pBufQueue);
-        while (pBuf->lockCount > 0U)
+        while (MediaBufGetLockCount(pBuf) > 0U)
         {
             MediaBufQueueReleaseBuffer(pBufQueue, pBuf);
         }
@@ -422,7 +422,7 @@ RESULT MediaBufQueueLockBuffer(MediaBufQueue_t* pBufQueue,
 
     (void) pBufQueue;
 
-    pBuf->lockCount++;
+    (void) MediaBufIncLockCount(pBuf);
     
     return RET_SUCCESS;
 }
@@ -211,14 +211,17 @@ static RESULT MediaBufQueueExReleaseBufferInt(MediaBufQueueEx_t* pBufQueue, Medi
     MediaBufPool_t *pBufPool = pBufQueue->pBufPool;
     DCT_ASSERT(pBufPool != NULL);
 
-    if (pBuf->lockCount == 0U)
+    uint32_t lockCount;
+
+    if (MediaBufDecLockCount(pBuf, &lockCount) != RET_SUCCESS)
     {
         return RET_FAILURE;
     }
 
     //
     //TODO/FIX: this assumes the buffer was added to the queue with a lock count of 1
-    if (pBuf->lockCount == 1U)
+    //the buffer is not back in the pool before the callbacks ran, so decrementing first is fine
+    if (lockCount == 0U)
     {
         int i;
 
@@ -233,9 +236,7 @@ static RESULT MediaBufQueueExReleaseBufferInt(MediaBufQueueEx_t* pBufQueue, Medi
         }
     }
 
-    pBuf->lockCount--;
-
-    if (pBuf->lockCount == 0U)
+    if (lockCount == 0U)
     {
         /* inform media buffer pool (and its registered users) about released buffer */
         /* always do this, not matter if the pool is external or not */
@@ -595,7 +596,7 @@ RESULT MediaBufQueueExFlush(MediaBufQueueEx_t *pBufQueue)
         pBuf = MediaBufQueueExGetFullBuffer(pBufQueue);
         if (!pBufQueue->isExtPool)
         {
-            while (pBuf->lockCount > 0U)
+            while (MediaBufGetLockCount(pBuf) > 0U)
             {
                 MediaBufQueueExReleaseBuffer(pBufQueue, pBuf);
             }
@@ -607,7 +608,7 @@ RESULT MediaBufQueueExFlush(MediaBufQueueEx_t *pBufQueue)
             // fully released thereby as well - except when it is still being locked
             // by processes currently dealing with that buffer. In that case these
             // processes will finally release the buffer by unlocking it.
-            DCT_ASSERT( pBuf->lockCount > 0U );
+            DCT_ASSERT( MediaBufGetLockCount(pBuf) > 0U );
             MediaBufQueueExReleaseBuffer(pBufQueue, pBuf);
         }
     }
@@ -743,7 +744,7 @@ RESULT MediaBufQueueExLockBuffer(MediaBufQueueEx_t* pBufQueue,
 
     (void) pBufQueue;
 
-    pBuf->lockCount++;
+    (void) MediaBufIncLockCount(pBuf);
 
     return RET_SUCCESS;
 }
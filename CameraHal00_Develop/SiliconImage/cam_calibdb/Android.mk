@@ -8,6 +8,7 @@ include $(CLEAR_VARS)
 LOCAL_SRC_FILES:=\
 	source/cam_calibdb.c\
 	source/cam_calibdb_api.c\
+	source/cam_calibdb_bin.c\
 
 
 LOCAL_C_INCLUDES += \
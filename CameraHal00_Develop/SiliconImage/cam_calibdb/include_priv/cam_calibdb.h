@@ -25,6 +25,7 @@
 #define __CAM_CALIBDB_H__
 
 #include <ebase/types.h>
+#include <ebase/hashtable.h>
 #include <oslayer/oslayer.h>
 #include <common/return_codes.h>
 #include <common/cam_types.h>
@@ -38,6 +39,54 @@ extern "C"
 #endif
 
 
+/**
+ * @brief   Items of a list in list order, for access by index
+ *
+ */
+typedef struct CamCalibDbItemVec_s
+{
+    void                        **ppItems;      /**< item pointers */
+    int32_t                     no;             /**< number of items */
+    int32_t                     size;           /**< number of allocated slots */
+} CamCalibDbItemVec_t;
+
+
+
+/**
+ * @brief   Lookup indices of the Cam-Calibration Database
+ *
+ * @note    The indices are filled by the CamCalibDbAdd* functions and
+ *          released with the lists. Name tables are keyed by a NUL terminated
+ *          copy of the name and keep the first item added under a name, so
+ *          a lookup finds the same item as the list search it replaces.
+ *          Tables are created on first insert.
+ *
+ */
+typedef struct CamCalibDbIndex_s
+{
+    CamCalibDbItemVec_t         resolution;             /**< resolutions by index */
+    CamCalibDbItemVec_t         ecm_profile;            /**< ECM profiles by index */
+    CamCalibDbItemVec_t         illumination;           /**< illuminations by index */
+
+    GHashTable                  *pResolutionByName;     /**< name -> resolution index + 1 */
+    GHashTable                  *pResolutionBySize;     /**< (width << 16) | height -> resolution index + 1 */
+    GHashTable                  *pAwbGlobalByRes;       /**< resolution name -> awb global */
+    GHashTable                  *pEcmProfileByName;     /**< name -> ECM profile */
+    GHashTable                  *pIlluminationByName;   /**< name -> illumination */
+    GHashTable                  *pLscProfileByName;     /**< name -> LSC profile */
+    GHashTable                  *pCcProfileByName;      /**< name -> CC profile */
+    GHashTable                  *pBlsProfileByName;     /**< name -> BLS profile */
+    GHashTable                  *pBlsProfileByRes;      /**< resolution name -> BLS profile */
+    GHashTable                  *pCacProfileByName;     /**< name -> CAC profile */
+    GHashTable                  *pCacProfileByRes;      /**< resolution name -> CAC profile */
+    GHashTable                  *pDpfProfileByName;     /**< name -> DPF profile */
+    GHashTable                  *pDpfProfileByRes;      /**< resolution name -> DPF profile */
+    GHashTable                  *pDpccProfileByName;    /**< name -> DPCC profile */
+    GHashTable                  *pDpccProfileByRes;     /**< resolution name -> DPCC profile */
+} CamCalibDbIndex_t;
+
+
+
 /**
  * @brief   Internal context of the Cam-Calibration Database
  *
@@ -66,6 +115,8 @@ typedef struct CamCalibDbContext_s
     List                        dpcc_profile;   /**< list of supported DPCC profiles */
 	CamCalibGammaOut_t 			*pGammaOut;		/**< Gamma out settings */
     CamCalibSystemData_t        system;
+
+    CamCalibDbIndex_t           index;          /**< lookup indices over the lists above */
 } CamCalibDbContext_t;
 
 
@@ -30,6 +30,8 @@ CREATE_TRACER( CAM_CALIBDB_API_WARN , "CAM_CALIBDB_API: ", WARNING, 1 );
 CREATE_TRACER( CAM_CALIBDB_API_ERROR, "CAM_CALIBDB_API: ", ERROR,   1 );
 CREATE_TRACER( CAM_CALIBDB_API_DEBUG, ""                 , INFO,    0 );
 
+#define CAM_CALIBDB_INDEX_KEY_LEN   32      /**< room for the longest name type plus NUL */
+
 
 /******************************************************************************
  * local type definitions
@@ -89,19 +91,6 @@ static int SearchResolutionByName( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchResolutionByWidthHeight
- *****************************************************************************/
-static int SearchResolutionByWidthHeight( List *l, void *key )
-{
-    CamResolution_t *search = (CamResolution_t *)key;
-    CamResolution_t *res = (CamResolution_t *)l;
-
-    return ( ((search->width==res->width) && (search->height==res->height)) ? 1 : 0 );
-}
-
-
-
 /******************************************************************************
  * SearchForEqualAwbGlobal
  *****************************************************************************/
@@ -128,19 +117,6 @@ static int SearchAwbGlobalByName( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchAwbGlobalByResolution
- *****************************************************************************/
-static int SearchAwbGlobalByResolution( List *l, void *key )
-{
-    CamCalibAwbGlobal_t *awb = (CamCalibAwbGlobal_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(awb->resolution, k, sizeof(awb->resolution))) ? 1 : 0 );
-}
-
-
-
 /******************************************************************************
  * SearchForEqualEcmProfile
  *****************************************************************************/
@@ -154,19 +130,6 @@ static int SearchForEqualEcmProfile( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchEcmProfileByName
- *****************************************************************************/
-static int SearchEcmProfileByName( List *l, void *key )
-{
-    CamEcmProfile_t *ecm = (CamEcmProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(ecm->name, k, sizeof(ecm->name))) ? 1 : 0 );
-}
-
-
-
 /******************************************************************************
  * SearchForEqualEcmScheme
  *****************************************************************************/
@@ -206,19 +169,6 @@ static int SearchForEqualIllumination( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchIlluminationByName
- *****************************************************************************/
-static int SearchIlluminationByName( List *l, void *key )
-{
-    CamIlluProfile_t *illu = (CamIlluProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(illu->name, k, sizeof(illu->name))) ? 1 : 0 );
-}
-
-
-
 /******************************************************************************
  * SearchForEqualLscProfile
  *****************************************************************************/
@@ -232,18 +182,6 @@ static int SearchForEqualLscProfile( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchLscProfileByName
- *****************************************************************************/
-static int SearchLscProfileByName( List *l, void *key )
-{
-    CamLscProfile_t *lsc = (CamLscProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(lsc->name, k, sizeof(lsc->name))) ? 1 : 0 );
-}
-
-
 /******************************************************************************
  * SearchForEqualCcProfile
  *****************************************************************************/
@@ -257,18 +195,6 @@ static int SearchForEqualCcProfile( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchCcProfileByName
- *****************************************************************************/
-static int SearchCcProfileByName( List *l, void *key )
-{
-    CamCcProfile_t *cc = (CamCcProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(cc->name, k, sizeof(cc->name))) ? 1 : 0 );
-}
-
-
 /******************************************************************************
  * SearchForEqualBlsProfile
  *****************************************************************************/
@@ -282,32 +208,6 @@ static int SearchForEqualBlsProfile( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchBlsProfileByName
- *****************************************************************************/
-static int SearchBlsProfileByName( List *l, void *key )
-{
-    CamBlsProfile_t *bls = (CamBlsProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(bls->name, k, sizeof(bls->name))) ? 1 : 0 );
-}
-
-
-
-/******************************************************************************
- * SearchBlsProfileByResolution
- *****************************************************************************/
-static int SearchBlsProfileByResolution( List *l, void *key )
-{
-    CamBlsProfile_t *bls = (CamBlsProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(bls->resolution, k, sizeof(bls->resolution))) ? 1 : 0 );
-}
-
-
-
 /******************************************************************************
  * SearchForEqualCacProfile
  *****************************************************************************/
@@ -321,32 +221,6 @@ static int SearchForEqualCacProfile( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchCacProfileByName
- *****************************************************************************/
-static int SearchCacProfileByName( List *l, void *key )
-{
-    CamCacProfile_t *cac = (CamCacProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(cac->name, k, sizeof(cac->name))) ? 1 : 0 );
-}
-
-
-
-/******************************************************************************
- * SearchCacProfileByResolution
- *****************************************************************************/
-static int SearchCacProfileByResolution( List *l, void *key )
-{
-    CamCacProfile_t *cac = (CamCacProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(cac->resolution, k, sizeof(cac->resolution))) ? 1 : 0 );
-}
-
-
-
 /******************************************************************************
  * SearchForEqualDpfProfile
  *****************************************************************************/
@@ -372,57 +246,6 @@ static int SearchForEqualDpccProfile( List *l, void *key )
 
 
 
-/******************************************************************************
- * SearchDpfProfileByName
- *****************************************************************************/
-static int SearchDpfProfileByName( List *l, void *key )
-{
-    CamDpfProfile_t *dpf = (CamDpfProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(dpf->name, k, sizeof(dpf->name))) ? 1 : 0 );
-}
-
-
-
-/******************************************************************************
- * SearchDpfProfileByResolution
- *****************************************************************************/
-static int SearchDpfProfileByResolution( List *l, void *key )
-{
-    CamDpfProfile_t *dpf = (CamDpfProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(dpf->resolution, k, sizeof(dpf->resolution))) ? 1 : 0 );
-}
-
-
-
-/******************************************************************************
- * SearchDpccProfileByName
- *****************************************************************************/
-static int SearchDpccProfileByName( List *l, void *key )
-{
-    CamDpccProfile_t *dpcc = (CamDpccProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(dpcc->name, k, sizeof(dpcc->name))) ? 1 : 0 );
-}
-
-
-
-/******************************************************************************
- * SearchDpccProfileByResolution
- *****************************************************************************/
-static int SearchDpccProfileByResolution( List *l, void *key )
-{
-    CamDpccProfile_t *dpcc = (CamDpccProfile_t *)l;
-    char *k = (char *)key;
-
-    return ( (!strncmp(dpcc->resolution, k, sizeof(dpcc->resolution))) ? 1 : 0 );
-}
-
-
 /******************************************************************************
  * ClearFrameRateList
  *****************************************************************************/
@@ -741,6 +564,238 @@ static void ClearDpccProfileList(  List *l )
 }
 
 
+/******************************************************************************
+ * IndexKey
+ *****************************************************************************/
+static void IndexKey( char *key, const char *name, const size_t size )
+{
+    size_t len = 0;
+
+    DCT_ASSERT( size < CAM_CALIBDB_INDEX_KEY_LEN );
+
+    /* names are compared with strncmp( .., sizeof(name) ), so they need not
+     * be terminated */
+    while ( ( len < size ) && name[len] )
+    {
+        ++len;
+    }
+
+    MEMCPY( key, name, len );
+    key[len] = '\0';
+}
+
+
+
+/******************************************************************************
+ * IndexAddName
+ *****************************************************************************/
+static RESULT IndexAddName( GHashTable **ppTable, const char *name, const size_t size, void *pItem )
+{
+    char key[CAM_CALIBDB_INDEX_KEY_LEN];
+    char *pKey;
+
+    IndexKey( key, name, size );
+
+    if ( NULL == *ppTable )
+    {
+        *ppTable = hashTableNewFull( strHash, strEqual, free, NULL );
+        if ( NULL == *ppTable )
+        {
+            return ( RET_OUTOFMEM );
+        }
+    }
+
+    /* the first item added under a name wins, like in a list search */
+    if ( NULL != hashTableLookup( *ppTable, key ) )
+    {
+        return ( RET_SUCCESS );
+    }
+
+    pKey = malloc( strlen( key ) + 1 );
+    if ( NULL == pKey )
+    {
+        return ( RET_OUTOFMEM );
+    }
+    MEMCPY( pKey, key, strlen( key ) + 1 );
+
+    hashTableInsert( *ppTable, pKey, pItem );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IndexFindName
+ *****************************************************************************/
+static void *IndexFindName( GHashTable *pTable, const char *name, const size_t size )
+{
+    char key[CAM_CALIBDB_INDEX_KEY_LEN];
+
+    if ( ( NULL == pTable ) || ( NULL == name ) )
+    {
+        return ( NULL );
+    }
+
+    IndexKey( key, name, size );
+
+    return ( hashTableLookup( pTable, key ) );
+}
+
+
+
+/******************************************************************************
+ * IndexAddItem
+ *****************************************************************************/
+static RESULT IndexAddItem( CamCalibDbItemVec_t *pVec, void *pItem )
+{
+    if ( pVec->no == pVec->size )
+    {
+        int32_t size = ( pVec->size ) ? ( 2 * pVec->size ) : 8;
+        void **ppItems = realloc( pVec->ppItems, size * sizeof(void *) );
+        if ( NULL == ppItems )
+        {
+            return ( RET_OUTOFMEM );
+        }
+
+        pVec->ppItems   = ppItems;
+        pVec->size      = size;
+    }
+
+    pVec->ppItems[pVec->no++] = pItem;
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IndexGetItem
+ *****************************************************************************/
+static void *IndexGetItem( const CamCalibDbItemVec_t *pVec, const uint32_t idx )
+{
+    return ( ( idx < (uint32_t)pVec->no ) ? pVec->ppItems[idx] : NULL );
+}
+
+
+
+/******************************************************************************
+ * IndexAddResolution
+ *****************************************************************************/
+static RESULT IndexAddResolution( CamCalibDbIndex_t *pIndex, CamResolution_t *pResolution )
+{
+    ulong_t key = ( (ulong_t)pResolution->width << 16 ) | pResolution->height;
+    void *value;
+
+    RESULT result;
+
+    result = IndexAddItem( &pIndex->resolution, pResolution );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
+    /* both tables hold the list index + 1, so a miss reads as -1 */
+    value = CAST_UINT32_TO_POINTER( void *, (ulong_t)pIndex->resolution.no );
+
+    result = IndexAddName( &pIndex->pResolutionByName, pResolution->name, sizeof(pResolution->name), value );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
+    if ( NULL == pIndex->pResolutionBySize )
+    {
+        pIndex->pResolutionBySize = hashTableNew( directHash, directEqual );
+        if ( NULL == pIndex->pResolutionBySize )
+        {
+            return ( RET_OUTOFMEM );
+        }
+    }
+
+    if ( NULL == hashTableLookup( pIndex->pResolutionBySize, CAST_UINT32_TO_POINTER( void *, key ) ) )
+    {
+        hashTableInsert( pIndex->pResolutionBySize, CAST_UINT32_TO_POINTER( void *, key ), value );
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IndexResolutionIdx
+ *****************************************************************************/
+static int32_t IndexResolutionIdx( CamCalibDbIndex_t *pIndex, const char *name )
+{
+    ulong_t value = CAST_POINTER_TO_UINT32( IndexFindName( pIndex->pResolutionByName, name, sizeof(CamResolutionName_t) ) );
+
+    return ( (int32_t)value - 1 );
+}
+
+
+
+/******************************************************************************
+ * IndexResolutionBySize
+ *****************************************************************************/
+static CamResolution_t *IndexResolutionBySize( CamCalibDbIndex_t *pIndex, const uint16_t width, const uint16_t height )
+{
+    ulong_t key = ( (ulong_t)width << 16 ) | height;
+    ulong_t value;
+
+    if ( NULL == pIndex->pResolutionBySize )
+    {
+        return ( NULL );
+    }
+
+    value = CAST_POINTER_TO_UINT32( hashTableLookup( pIndex->pResolutionBySize, CAST_UINT32_TO_POINTER( void *, key ) ) );
+
+    return ( (CamResolution_t *)IndexGetItem( &pIndex->resolution, (uint32_t)value - 1 ) );
+}
+
+
+
+/******************************************************************************
+ * ClearIndex
+ *****************************************************************************/
+static void ClearIndex( CamCalibDbIndex_t *pIndex )
+{
+    GHashTable **ppTables[] =
+    {
+        &pIndex->pResolutionByName,
+        &pIndex->pResolutionBySize,
+        &pIndex->pAwbGlobalByRes,
+        &pIndex->pEcmProfileByName,
+        &pIndex->pIlluminationByName,
+        &pIndex->pLscProfileByName,
+        &pIndex->pCcProfileByName,
+        &pIndex->pBlsProfileByName,
+        &pIndex->pBlsProfileByRes,
+        &pIndex->pCacProfileByName,
+        &pIndex->pCacProfileByRes,
+        &pIndex->pDpfProfileByName,
+        &pIndex->pDpfProfileByRes,
+        &pIndex->pDpccProfileByName,
+        &pIndex->pDpccProfileByRes,
+    };
+    uint32_t i;
+
+    for ( i = 0; i < ( sizeof(ppTables) / sizeof(ppTables[0]) ); i++ )
+    {
+        if ( NULL != *ppTables[i] )
+        {
+            hashTableDestroy( *ppTables[i] );
+        }
+    }
+
+    free( pIndex->resolution.ppItems );
+    free( pIndex->ecm_profile.ppItems );
+    free( pIndex->illumination.ppItems );
+
+    MEMSET( pIndex, 0, sizeof(CamCalibDbIndex_t) );
+}
+
+
 /******************************************************************************
  * ValidateFrameRate
  *****************************************************************************/
@@ -1102,6 +1157,7 @@ static RESULT ClearContext( CamCalibDbContext_t *pCamCalibDbCtx )
     ClearCacProfileList( &pCamCalibDbCtx->cac_profile );
     ClearDpfProfileList( &pCamCalibDbCtx->dpf_profile );
     ClearDpccProfileList( &pCamCalibDbCtx->dpcc_profile );
+    ClearIndex( &pCamCalibDbCtx->index );
 
     MEMSET( pCamCalibDbCtx, 0, sizeof(CamCalibDbContext_t) );
 
@@ -1453,6 +1509,12 @@ RESULT CamCalibDbAddResolution
     ListPrepareItem( pNewRes );
     ListAddTail( &pCamCalibDbCtx->resolution, pNewRes );
 
+    result = IndexAddResolution( &pCamCalibDbCtx->index, pNewRes );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
     /* add already linked schemes as well */
     CamFrameRate_t *pFrameRate = (CamFrameRate_t *)ListHead( &pAddRes->framerates );
     while ( pFrameRate )
@@ -1498,7 +1560,7 @@ RESULT CamCalibDbGetNoOfResolutions
         return ( RET_INVALID_PARM );
     }
 
-    *no = (uint32_t)ListNoItems( &pCamCalibDbCtx->resolution );
+    *no = pCamCalibDbCtx->index.resolution.no;
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -1531,8 +1593,14 @@ RESULT CamCalibDbGetResolutionByName
         return ( RET_INVALID_PARM );
     }
 
-    /* search resolution by name */
-    *pResolution = (CamResolution_t *)ListSearch( &pCamCalibDbCtx->resolution, SearchResolutionByName, (void *)name );
+    /* search resolution by name, a name that only starts with a resolution
+     * name is not in the index and still needs the list search */
+    *pResolution = (CamResolution_t *)IndexGetItem( &pCamCalibDbCtx->index.resolution,
+                                        (uint32_t)IndexResolutionIdx( &pCamCalibDbCtx->index, name ) );
+    if ( NULL == *pResolution )
+    {
+        *pResolution = (CamResolution_t *)ListSearch( &pCamCalibDbCtx->resolution, SearchResolutionByName, (void *)name );
+    }
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -1553,7 +1621,6 @@ RESULT CamCalibDbGetResolutionByWidthHeight
 )
 {
     CamCalibDbContext_t *pCamCalibDbCtx = (CamCalibDbContext_t *)hCamCalibDb;
-    CamResolution_t SearchParam;
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (enter)\n", __FUNCTION__ );
 
@@ -1572,13 +1639,8 @@ RESULT CamCalibDbGetResolutionByWidthHeight
         return ( RET_INVALID_PARM );
     }
 
-    MEMSET( &SearchParam, 0, sizeof( SearchParam ) );
-    SearchParam.width      = width;
-    SearchParam.height     = height;
-
-    /* search resolution by name */
-    *pResolution = (CamResolution_t *)ListSearch( &pCamCalibDbCtx->resolution,
-                                        SearchResolutionByWidthHeight, (void *)&SearchParam );
+    /* search resolution by size */
+    *pResolution = IndexResolutionBySize( &pCamCalibDbCtx->index, width, height );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -1599,7 +1661,6 @@ RESULT CamCalibDbGetResolutionNameByWidthHeight
 )
 {
     CamCalibDbContext_t *pCamCalibDbCtx = (CamCalibDbContext_t *)hCamCalibDb;
-    CamResolution_t     SearchParam;
     CamResolution_t     *pResolution;
 
     RESULT result = RET_SUCCESS;
@@ -1616,13 +1677,8 @@ RESULT CamCalibDbGetResolutionNameByWidthHeight
         return ( RET_INVALID_PARM );
     }
 
-    MEMSET( &SearchParam, 0, sizeof( SearchParam ) );
-    SearchParam.width      = width;
-    SearchParam.height     = height;
-
-    /* search resolution by name */
-    pResolution = (CamResolution_t *)ListSearch( &pCamCalibDbCtx->resolution,
-                                        SearchResolutionByWidthHeight, (void *)&SearchParam );
+    /* search resolution by size */
+    pResolution = IndexResolutionBySize( &pCamCalibDbCtx->index, width, height );
     if ( pResolution )
     {
         strncpy( (char *)pResolutionName, (char *)pResolution->name, sizeof( CamResolutionName_t ) );
@@ -1651,8 +1707,6 @@ RESULT CamCalibDbGetResolutionIdxByName
 )
 {
     CamCalibDbContext_t *pCamCalibDbCtx = (CamCalibDbContext_t *)hCamCalibDb;
-    CamResolution_t     SearchParam;
-    CamResolution_t     *pResolution;
 
     RESULT result = RET_SUCCESS;
 
@@ -1668,8 +1722,65 @@ RESULT CamCalibDbGetResolutionIdxByName
         return ( RET_INVALID_PARM );
     }
 
-    /* search resolution by name */
-    *pIdx = ListGetIdxByItem( &pCamCalibDbCtx->resolution, SearchResolutionByName, (void *)name );
+    /* search resolution by name, see CamCalibDbGetResolutionByName */
+    *pIdx = IndexResolutionIdx( &pCamCalibDbCtx->index, name );
+    if ( *pIdx < 0 )
+    {
+        *pIdx = ListGetIdxByItem( &pCamCalibDbCtx->resolution, SearchResolutionByName, (void *)name );
+    }
+
+    TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamCalibDbGetResProfilesByWidthHeight
+ *****************************************************************************/
+RESULT CamCalibDbGetResProfilesByWidthHeight
+(
+    CamCalibDbHandle_t          hCamCalibDb,
+    const uint16_t              width,
+    const uint16_t              height,
+    CamCalibDbResProfiles_t     *pProfiles
+)
+{
+    CamCalibDbContext_t *pCamCalibDbCtx = (CamCalibDbContext_t *)hCamCalibDb;
+    CamCalibDbIndex_t   *pIndex;
+    CamResolution_t     *pResolution;
+
+    TRACE( CAM_CALIBDB_API_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( NULL == pCamCalibDbCtx )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( NULL == pProfiles )
+    {
+        return ( RET_INVALID_PARM );
+    }
+
+    MEMSET( pProfiles, 0, sizeof( CamCalibDbResProfiles_t ) );
+    pProfiles->ResIdx = -1;
+
+    pIndex = &pCamCalibDbCtx->index;
+
+    pResolution = IndexResolutionBySize( pIndex, width, height );
+    if ( NULL == pResolution )
+    {
+        return ( RET_NOTSUPP );
+    }
+
+    pProfiles->pResolution  = pResolution;
+    pProfiles->ResIdx       = IndexResolutionIdx( pIndex, pResolution->name );
+    pProfiles->pAwbGlobal   = (CamCalibAwbGlobal_t *)IndexFindName( pIndex->pAwbGlobalByRes, pResolution->name, sizeof(CamResolutionName_t) );
+    pProfiles->pBlsProfile  = (CamBlsProfile_t *)IndexFindName( pIndex->pBlsProfileByRes, pResolution->name, sizeof(CamResolutionName_t) );
+    pProfiles->pCacProfile  = (CamCacProfile_t *)IndexFindName( pIndex->pCacProfileByRes, pResolution->name, sizeof(CamResolutionName_t) );
+    pProfiles->pDpfProfile  = (CamDpfProfile_t *)IndexFindName( pIndex->pDpfProfileByRes, pResolution->name, sizeof(CamResolutionName_t) );
+    pProfiles->pDpccProfile = (CamDpccProfile_t *)IndexFindName( pIndex->pDpccProfileByRes, pResolution->name, sizeof(CamResolutionName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -1800,6 +1911,12 @@ RESULT CamCalibDbAddAwbGlobal
 
         ListPrepareItem( pNewAwbGlobal );
         ListAddTail( &pCamCalibDbCtx->awb_global, pNewAwbGlobal );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pAwbGlobalByRes, pNewAwbGlobal->resolution, sizeof(pNewAwbGlobal->resolution), pNewAwbGlobal );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -1840,7 +1957,7 @@ RESULT CamCalibDbGetAwbGlobalByResolution
     }
 
     /* search resolution by name */
-    *pAwbGlobal = (CamCalibAwbGlobal_t *)ListSearch( &pCamCalibDbCtx->awb_global, SearchAwbGlobalByResolution, (void *)ResName );
+    *pAwbGlobal = (CamCalibAwbGlobal_t *)IndexFindName( pCamCalibDbCtx->index.pAwbGlobalByRes, ResName, sizeof(CamResolutionName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2065,6 +2182,18 @@ RESULT CamCalibDbAddEcmProfile
     ListPrepareItem( pNewEcmProfile );
     ListAddTail( &pCamCalibDbCtx->ecm_profile, pNewEcmProfile );
 
+    result = IndexAddItem( &pCamCalibDbCtx->index.ecm_profile, pNewEcmProfile );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
+    result = IndexAddName( &pCamCalibDbCtx->index.pEcmProfileByName, pNewEcmProfile->name, sizeof(pNewEcmProfile->name), pNewEcmProfile );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
     /* add already linked schemes as well */
     CamEcmScheme_t *pEcmScheme = (CamEcmScheme_t *)ListHead( &pAddEcmProfile->ecm_scheme );
     while ( pEcmScheme )
@@ -2108,7 +2237,7 @@ RESULT CamCalibDbGetNoOfEcmProfiles
         return ( RET_INVALID_PARM );
     }
 
-    *no = (uint32_t)ListNoItems( &pCamCalibDbCtx->ecm_profile );
+    *no = pCamCalibDbCtx->index.ecm_profile.no;
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2184,7 +2313,7 @@ RESULT CamCalibDbGetEcmProfileByName
     }
 
     /* search profile by name */
-    *ppEcmProfile = (CamEcmProfile_t *)ListSearch( &pCamCalibDbCtx->ecm_profile, SearchEcmProfileByName, (void *)EcmProfileName );
+    *ppEcmProfile = (CamEcmProfile_t *)IndexFindName( pCamCalibDbCtx->index.pEcmProfileByName, EcmProfileName, sizeof(CamEcmProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2218,7 +2347,7 @@ RESULT CamCalibDbGetEcmProfileByIdx
     }
 
     /* search profile by index */
-    *ppEcmProfile = (CamEcmProfile_t *)ListGetItemByIdx( &pCamCalibDbCtx->ecm_profile, idx );
+    *ppEcmProfile = (CamEcmProfile_t *)IndexGetItem( &pCamCalibDbCtx->index.ecm_profile, idx );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2422,7 +2551,7 @@ RESULT CamCalibDbGetNoOfIlluminations
     }
 
     /* search resolution by name */
-    *no = (uint32_t)ListNoItems( &pCamCalibDbCtx->illumination );
+    *no = pCamCalibDbCtx->index.illumination.no;
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2498,6 +2627,18 @@ RESULT CamCalibDbAddIllumination
         /* add illumination to list */
         ListPrepareItem( pNewIllu );
         ListAddTail( &pCamCalibDbCtx->illumination, pNewIllu );
+
+        result = IndexAddItem( &pCamCalibDbCtx->index.illumination, pNewIllu );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pIlluminationByName, pNewIllu->name, sizeof(pNewIllu->name), pNewIllu );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -2534,7 +2675,7 @@ RESULT CamCalibDbGetIlluminationByName
     }
 
     /* search resolution by name */
-    *pIllumination = (CamIlluProfile_t *)ListSearch( &pCamCalibDbCtx->illumination, SearchIlluminationByName, (void *)name );
+    *pIllumination = (CamIlluProfile_t *)IndexFindName( pCamCalibDbCtx->index.pIlluminationByName, name, sizeof(CamIlluminationName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2568,7 +2709,7 @@ RESULT CamCalibDbGetIlluminationByIdx
     }
 
     /* search resolution by name */
-    *pIllumination = (CamIlluProfile_t *)ListGetItemByIdx( &pCamCalibDbCtx->illumination, idx );
+    *pIllumination = (CamIlluProfile_t *)IndexGetItem( &pCamCalibDbCtx->index.illumination, idx );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2613,6 +2754,12 @@ RESULT CamCalibDbAddLscProfile
 
         ListPrepareItem( pNewLsc );
         ListAddTail( &pCamCalibDbCtx->lsc_profile, pNewLsc );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pLscProfileByName, pNewLsc->name, sizeof(pNewLsc->name), pNewLsc );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -2651,7 +2798,7 @@ RESULT CamCalibDbGetLscProfileByName
     }
 
     /* search resolution by name */
-    *pLscProfile = (CamLscProfile_t *)ListSearch( &pCamCalibDbCtx->lsc_profile, SearchLscProfileByName, (void *)name );
+    *pLscProfile = (CamLscProfile_t *)IndexFindName( pCamCalibDbCtx->index.pLscProfileByName, name, sizeof(CamLscProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2696,6 +2843,12 @@ RESULT CamCalibDbAddCcProfile
 
         ListPrepareItem( pNewCc );
         ListAddTail( &pCamCalibDbCtx->cc_profile, pNewCc );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pCcProfileByName, pNewCc->name, sizeof(pNewCc->name), pNewCc );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -2734,7 +2887,7 @@ RESULT CamCalibDbGetCcProfileByName
     }
 
     /* search resolution by name */
-    *pCcProfile = (CamCcProfile_t *)ListSearch( &pCamCalibDbCtx->cc_profile, SearchCcProfileByName, (void *)name );
+    *pCcProfile = (CamCcProfile_t *)IndexFindName( pCamCalibDbCtx->index.pCcProfileByName, name, sizeof(CamCcProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2779,6 +2932,18 @@ RESULT CamCalibDbAddBlsProfile
 
         ListPrepareItem( pNewBls );
         ListAddTail( &pCamCalibDbCtx->bls_profile, pNewBls );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pBlsProfileByName, pNewBls->name, sizeof(pNewBls->name), pNewBls );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pBlsProfileByRes, pNewBls->resolution, sizeof(pNewBls->resolution), pNewBls );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -2817,7 +2982,7 @@ RESULT CamCalibDbGetBlsProfileByName
     }
 
     /* search resolution by name */
-    *pBlsProfile = (CamBlsProfile_t *)ListSearch( &pCamCalibDbCtx->bls_profile, SearchBlsProfileByName, (void *)name );
+    *pBlsProfile = (CamBlsProfile_t *)IndexFindName( pCamCalibDbCtx->index.pBlsProfileByName, name, sizeof(CamBlsProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2851,7 +3016,7 @@ RESULT CamCalibDbGetBlsProfileByResolution
     }
 
     /* search resolution by name */
-    *pBlsProfile = (CamBlsProfile_t *)ListSearch( &pCamCalibDbCtx->bls_profile, SearchBlsProfileByResolution, (void *)ResName );
+    *pBlsProfile = (CamBlsProfile_t *)IndexFindName( pCamCalibDbCtx->index.pBlsProfileByRes, ResName, sizeof(CamResolutionName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2896,6 +3061,18 @@ RESULT CamCalibDbAddCacProfile
 
         ListPrepareItem( pNewCac );
         ListAddTail( &pCamCalibDbCtx->cac_profile, pNewCac );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pCacProfileByName, pNewCac->name, sizeof(pNewCac->name), pNewCac );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pCacProfileByRes, pNewCac->resolution, sizeof(pNewCac->resolution), pNewCac );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -2934,7 +3111,7 @@ RESULT CamCalibDbGetCacProfileByName
     }
 
     /* search resolution by name */
-    *pCacProfile = (CamCacProfile_t *)ListSearch( &pCamCalibDbCtx->cac_profile, SearchCacProfileByName, (void *)name );
+    *pCacProfile = (CamCacProfile_t *)IndexFindName( pCamCalibDbCtx->index.pCacProfileByName, name, sizeof(CamCacProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -2968,7 +3145,7 @@ RESULT CamCalibDbGetCacProfileByResolution
     }
 
     /* search resolution by name */
-    *pCacProfile = (CamCacProfile_t *)ListSearch( &pCamCalibDbCtx->cac_profile, SearchCacProfileByResolution, (void *)ResName );
+    *pCacProfile = (CamCacProfile_t *)IndexFindName( pCamCalibDbCtx->index.pCacProfileByRes, ResName, sizeof(CamResolutionName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -3013,6 +3190,18 @@ RESULT CamCalibDbAddDpfProfile
 
         ListPrepareItem( pNewDpf );
         ListAddTail( &pCamCalibDbCtx->dpf_profile, pNewDpf );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pDpfProfileByName, pNewDpf->name, sizeof(pNewDpf->name), pNewDpf );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pDpfProfileByRes, pNewDpf->resolution, sizeof(pNewDpf->resolution), pNewDpf );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -3051,7 +3240,7 @@ RESULT CamCalibDbGetDpfProfileByName
     }
 
     /* search resolution by name */
-    *pDpfProfile = (CamDpfProfile_t *)ListSearch( &pCamCalibDbCtx->dpf_profile, SearchDpfProfileByName, (void *)name );
+    *pDpfProfile = (CamDpfProfile_t *)IndexFindName( pCamCalibDbCtx->index.pDpfProfileByName, name, sizeof(CamDpfProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -3085,7 +3274,7 @@ RESULT CamCalibDbGetDpfProfileByResolution
     }
 
     /* search resolution by name */
-    *pDpfProfile = (CamDpfProfile_t *)ListSearch( &pCamCalibDbCtx->dpf_profile, SearchDpfProfileByResolution, (void *)ResName );
+    *pDpfProfile = (CamDpfProfile_t *)IndexFindName( pCamCalibDbCtx->index.pDpfProfileByRes, ResName, sizeof(CamResolutionName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -3130,6 +3319,18 @@ RESULT CamCalibDbAddDpccProfile
 
         ListPrepareItem( pNewDpcc );
         ListAddTail( &pCamCalibDbCtx->dpcc_profile, pNewDpcc );
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pDpccProfileByName, pNewDpcc->name, sizeof(pNewDpcc->name), pNewDpcc );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
+
+        result = IndexAddName( &pCamCalibDbCtx->index.pDpccProfileByRes, pNewDpcc->resolution, sizeof(pNewDpcc->resolution), pNewDpcc );
+        if ( result != RET_SUCCESS )
+        {
+            return ( result );
+        }
     }
     else
     {
@@ -3168,7 +3369,7 @@ RESULT CamCalibDbGetDpccfProfileByName
     }
 
     /* search resolution by name */
-    *pDpccProfile = (CamDpccProfile_t *)ListSearch( &pCamCalibDbCtx->dpcc_profile, SearchDpccProfileByName, (void *)name );
+    *pDpccProfile = (CamDpccProfile_t *)IndexFindName( pCamCalibDbCtx->index.pDpccProfileByName, name, sizeof(CamDpccProfileName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
@@ -3202,7 +3403,7 @@ RESULT CamCalibDbGetDpccProfileByResolution
     }
 
     /* search resolution by name */
-    *pDpccProfile = (CamDpccProfile_t *)ListSearch( &pCamCalibDbCtx->dpcc_profile, SearchDpccProfileByResolution, (void *)ResName );
+    *pDpccProfile = (CamDpccProfile_t *)IndexFindName( pCamCalibDbCtx->index.pDpccProfileByRes, ResName, sizeof(CamResolutionName_t) );
 
     TRACE( CAM_CALIBDB_API_INFO, "%s (exit)\n", __FUNCTION__ );
 
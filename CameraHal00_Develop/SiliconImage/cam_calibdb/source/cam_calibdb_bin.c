@@ -0,0 +1,1088 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file cam_calibdb_bin.c
+ *
+ * @brief
+ *   Binary image of the CamCalibDb.
+ *
+ *   The image is a header followed by one record per database item. A record
+ *   holds the item structure as it is in memory, followed by the arrays and
+ *   list items it points to. Every pointer inside a record is stored as an
+ *   offset from the start of the record structure (0 for NULL), so loading
+ *   is a private mapping of the file, a pass that turns the offsets back
+ *   into pointers, and the usual CamCalibDbAdd* calls.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <ebase/trace.h>
+#include <ebase/builtins.h>
+#include <ebase/dct_assert.h>
+
+#include "cam_calibdb_api.h"
+#include "cam_calibdb.h"
+
+/******************************************************************************
+ * local macro definitions
+ *****************************************************************************/
+CREATE_TRACER( CAM_CALIBDB_BIN_INFO , "CAM_CALIBDB_BIN: ", INFO,    0 );
+CREATE_TRACER( CAM_CALIBDB_BIN_WARN , "CAM_CALIBDB_BIN: ", WARNING, 1 );
+CREATE_TRACER( CAM_CALIBDB_BIN_ERROR, "CAM_CALIBDB_BIN: ", ERROR,   1 );
+
+#define CAM_CALIBDB_BIN_MAGIC       0x42444343UL    /**< "CCDB" */
+#define CAM_CALIBDB_BIN_VERSION     1U
+
+#define CAM_CALIBDB_BIN_ALIGN       8U
+
+#define FNV1A64_OFFSET              0xcbf29ce484222325ULL
+#define FNV1A64_PRIME               0x100000001b3ULL
+
+/* stores a pointer member of a record item and the array behind it */
+#define BIN_PUT_ARRAY( pBuf, base, type, pItem, member, n )                 \
+    BinPutArray( pBuf, base, base + offsetof( type, member ),               \
+                 (pItem)->member, (uint32_t)(n) * sizeof( *(pItem)->member ) )
+
+/* turns a stored offset of a mapped record item back into a pointer */
+#define BIN_RELOC_ARRAY( pRec, size, pItem, member, n )                     \
+    BinRelocPtr( pRec, size, &(pItem)->member,                              \
+                 (uint32_t)(n) * sizeof( *(pItem)->member ) )
+
+
+
+/******************************************************************************
+ * local type definitions
+ *****************************************************************************/
+typedef enum CamCalibDbBinTag_e
+{
+    CAM_CALIBDB_BIN_META        = 1,
+    CAM_CALIBDB_BIN_SYSTEM      = 2,
+    CAM_CALIBDB_BIN_RESOLUTION  = 3,
+    CAM_CALIBDB_BIN_AWB_GLOBAL  = 4,
+    CAM_CALIBDB_BIN_AEC_GLOBAL  = 5,
+    CAM_CALIBDB_BIN_GAMMA_OUT   = 6,
+    CAM_CALIBDB_BIN_ECM_PROFILE = 7,
+    CAM_CALIBDB_BIN_ILLU        = 8,
+    CAM_CALIBDB_BIN_LSC         = 9,
+    CAM_CALIBDB_BIN_CC          = 10,
+    CAM_CALIBDB_BIN_BLS         = 11,
+    CAM_CALIBDB_BIN_CAC         = 12,
+    CAM_CALIBDB_BIN_DPF         = 13,
+    CAM_CALIBDB_BIN_DPCC        = 14
+} CamCalibDbBinTag_t;
+
+typedef struct CamCalibDbBinHeader_s
+{
+    uint32_t    magic;                  /**< CAM_CALIBDB_BIN_MAGIC, also tells the byte order */
+    uint16_t    version;                /**< CAM_CALIBDB_BIN_VERSION */
+    uint16_t    headerSize;             /**< sizeof(CamCalibDbBinHeader_t) */
+    uint32_t    layout;                 /**< hash of pointer size and structure sizes */
+    uint32_t    payloadSize;            /**< bytes following the header */
+    uint64_t    srcHash;                /**< hash of the source xml */
+    uint32_t    payloadCrc;             /**< crc32 of the payload */
+    uint32_t    reserved;
+} CamCalibDbBinHeader_t;
+
+typedef struct CamCalibDbBinRecord_s
+{
+    uint32_t    tag;                    /**< CamCalibDbBinTag_t */
+    uint32_t    size;                   /**< bytes following the record header */
+} CamCalibDbBinRecord_t;
+
+typedef struct BinBuf_s
+{
+    uint8_t     *pData;
+    uint32_t    used;
+    uint32_t    size;
+    RESULT      result;
+} BinBuf_t;
+
+
+
+/******************************************************************************
+ * local variable declarations
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * local functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Fnv1a64
+ *****************************************************************************/
+static uint64_t Fnv1a64( uint64_t hash, const void *pData, size_t len )
+{
+    const uint8_t *p = (const uint8_t *)pData;
+
+    while ( len-- )
+    {
+        hash ^= *p++;
+        hash *= FNV1A64_PRIME;
+    }
+
+    return ( hash );
+}
+
+
+
+/******************************************************************************
+ * Crc32
+ *****************************************************************************/
+static uint32_t Crc32( const uint8_t *pData, uint32_t len )
+{
+    uint32_t table[256];
+    uint32_t crc = 0xffffffffUL;
+    uint32_t i, j, c;
+
+    /* cheap next to the payload, and no shared state between callers */
+    for ( i = 0; i < 256; i++ )
+    {
+        c = i;
+        for ( j = 0; j < 8; j++ )
+        {
+            c = ( c & 1 ) ? ( 0xedb88320UL ^ ( c >> 1 ) ) : ( c >> 1 );
+        }
+        table[i] = c;
+    }
+
+    while ( len-- )
+    {
+        crc = table[( crc ^ *pData++ ) & 0xff] ^ ( crc >> 8 );
+    }
+
+    return ( crc ^ 0xffffffffUL );
+}
+
+
+
+/******************************************************************************
+ * BinLayout
+ *****************************************************************************/
+static uint32_t BinLayout( void )
+{
+    /* records are raw structures, an image from another build must not load */
+    const uint32_t sizes[] =
+    {
+        sizeof( void * ),
+        sizeof( CamCalibDbMetaData_t ),
+        sizeof( CamCalibSystemData_t ),
+        sizeof( CamResolution_t ),
+        sizeof( CamFrameRate_t ),
+        sizeof( CamCalibAwbGlobal_t ),
+        sizeof( CamCalibAecGlobal_t ),
+        sizeof( CamCalibGammaOut_t ),
+        sizeof( CamEcmProfile_t ),
+        sizeof( CamEcmScheme_t ),
+        sizeof( CamIlluProfile_t ),
+        sizeof( CamLscProfile_t ),
+        sizeof( CamCcProfile_t ),
+        sizeof( CamBlsProfile_t ),
+        sizeof( CamCacProfile_t ),
+        sizeof( CamDpfProfile_t ),
+        sizeof( CamDpccProfile_t ),
+        sizeof( CamerIcIspFltDeNoiseLevel_t ),
+        sizeof( CamerIcIspFltSharpeningLevel_t )
+    };
+
+    return ( (uint32_t)Fnv1a64( FNV1A64_OFFSET, sizes, sizeof(sizes) ) );
+}
+
+
+
+/******************************************************************************
+ * BinBufReserve
+ *****************************************************************************/
+static uint32_t BinBufReserve( BinBuf_t *pBuf, uint32_t len )
+{
+    uint32_t offset = ( pBuf->used + CAM_CALIBDB_BIN_ALIGN - 1 ) & ~( CAM_CALIBDB_BIN_ALIGN - 1 );
+
+    if ( pBuf->result != RET_SUCCESS )
+    {
+        return ( 0 );
+    }
+
+    if ( ( offset + len ) > pBuf->size )
+    {
+        uint32_t size = ( pBuf->size ) ? pBuf->size : 16384U;
+        uint8_t *pData;
+
+        while ( size < ( offset + len ) )
+        {
+            size <<= 1;
+        }
+        pData = realloc( pBuf->pData, size );
+        if ( pData == NULL )
+        {
+            pBuf->result = RET_OUTOFMEM;
+            return ( 0 );
+        }
+        pBuf->pData = pData;
+        pBuf->size  = size;
+    }
+
+    MEMSET( pBuf->pData + pBuf->used, 0, offset + len - pBuf->used );
+    pBuf->used = offset + len;
+
+    return ( offset );
+}
+
+
+
+/******************************************************************************
+ * BinBufPut
+ *****************************************************************************/
+static uint32_t BinBufPut( BinBuf_t *pBuf, const void *pData, uint32_t len )
+{
+    uint32_t offset = BinBufReserve( pBuf, len );
+
+    if ( ( offset != 0 ) && ( len != 0 ) )
+    {
+        MEMCPY( pBuf->pData + offset, pData, len );
+    }
+
+    return ( offset );
+}
+
+
+
+/******************************************************************************
+ * BinSetSlot
+ *****************************************************************************/
+static void BinSetSlot( BinBuf_t *pBuf, uint32_t slot, uintptr_t value )
+{
+    if ( pBuf->result == RET_SUCCESS )
+    {
+        MEMCPY( pBuf->pData + slot, &value, sizeof(value) );
+    }
+}
+
+
+
+/******************************************************************************
+ * BinBeginRecord
+ *****************************************************************************/
+static uint32_t BinBeginRecord( BinBuf_t *pBuf, CamCalibDbBinTag_t tag )
+{
+    CamCalibDbBinRecord_t rec = { (uint32_t)tag, 0U };
+
+    return ( BinBufPut( pBuf, &rec, sizeof(rec) ) );
+}
+
+
+
+/******************************************************************************
+ * BinEndRecord
+ *****************************************************************************/
+static void BinEndRecord( BinBuf_t *pBuf, uint32_t recOffset )
+{
+    uint32_t end = BinBufReserve( pBuf, 0 );
+
+    if ( pBuf->result == RET_SUCCESS )
+    {
+        CamCalibDbBinRecord_t *pRec = (CamCalibDbBinRecord_t *)( pBuf->pData + recOffset );
+        pRec->size = end - recOffset - sizeof(CamCalibDbBinRecord_t);
+    }
+}
+
+
+
+/******************************************************************************
+ * BinPutItem
+ *
+ * Puts an item structure, the list link it starts with (if any) is cleared.
+ *****************************************************************************/
+static uint32_t BinPutItem( BinBuf_t *pBuf, const void *pItem, uint32_t len, bool_t linked )
+{
+    uint32_t base = BinBufPut( pBuf, pItem, len );
+
+    if ( linked )
+    {
+        BinSetSlot( pBuf, base, 0 );
+    }
+
+    return ( base );
+}
+
+
+
+/******************************************************************************
+ * BinPutArray
+ *****************************************************************************/
+static void BinPutArray
+(
+    BinBuf_t    *pBuf,
+    uint32_t    base,
+    uint32_t    slot,
+    const void  *pData,
+    uint32_t    len
+)
+{
+    uint32_t offset;
+
+    if ( pData == NULL )
+    {
+        BinSetSlot( pBuf, slot, 0 );
+        return;
+    }
+
+    offset = BinBufPut( pBuf, pData, len );
+    BinSetSlot( pBuf, slot, offset - base );
+}
+
+
+
+/******************************************************************************
+ * BinPutList
+ *
+ * Appends all items of a list, the list head at slot and each item's link
+ * are set to the offset of the following item.
+ *****************************************************************************/
+static void BinPutList
+(
+    BinBuf_t    *pBuf,
+    uint32_t    base,
+    uint32_t    slot,
+    const List  *pList,
+    uint32_t    itemSize
+)
+{
+    const List *pItem = ListHead( pList );
+
+    BinSetSlot( pBuf, slot, 0 );
+    while ( pItem )
+    {
+        uint32_t offset = BinPutItem( pBuf, pItem, itemSize, BOOL_TRUE );
+
+        BinSetSlot( pBuf, slot, offset - base );
+        slot  = offset;
+        pItem = pItem->p_next;
+    }
+}
+
+
+
+/******************************************************************************
+ * BinPutSimpleList
+ *
+ * One record per item, for the profiles without pointers.
+ *****************************************************************************/
+static void BinPutSimpleList
+(
+    BinBuf_t            *pBuf,
+    CamCalibDbBinTag_t  tag,
+    const List          *pList,
+    uint32_t            itemSize
+)
+{
+    const List *pItem = ListHead( pList );
+
+    while ( pItem )
+    {
+        uint32_t rec = BinBeginRecord( pBuf, tag );
+        BinPutItem( pBuf, pItem, itemSize, BOOL_TRUE );
+        BinEndRecord( pBuf, rec );
+        pItem = pItem->p_next;
+    }
+}
+
+
+
+/******************************************************************************
+ * BinPutAwbGlobal
+ *****************************************************************************/
+static void BinPutAwbGlobal( BinBuf_t *pBuf, const CamCalibAwbGlobal_t *pAwb )
+{
+    const CamAwbClipParm_t       *pClip  = &pAwb->AwbClipParam;
+    const CamAwbGlobalFadeParm_t *pFade  = &pAwb->AwbGlobalFadeParm;
+    const CamAwbFade2Parm_t      *pFade2 = &pAwb->AwbFade2Parm;
+
+    uint32_t rec  = BinBeginRecord( pBuf, CAM_CALIBDB_BIN_AWB_GLOBAL );
+    uint32_t base = BinPutItem( pBuf, pAwb, sizeof(*pAwb), BOOL_TRUE );
+
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbClipParam.pRg1, pClip->ArraySize1 );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbClipParam.pMaxDist1, pClip->ArraySize1 );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbClipParam.pRg2, pClip->ArraySize2 );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbClipParam.pMaxDist2, pClip->ArraySize2 );
+
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbGlobalFadeParm.pGlobalFade1, pFade->ArraySize1 );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbGlobalFadeParm.pGlobalGainDistance1, pFade->ArraySize1 );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbGlobalFadeParm.pGlobalFade2, pFade->ArraySize2 );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbGlobalFadeParm.pGlobalGainDistance2, pFade->ArraySize2 );
+
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pFade, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pCbMinRegionMax, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pCrMinRegionMax, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMaxCSumRegionMax, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pCbMinRegionMin, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pCrMinRegionMin, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMaxCSumRegionMin, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMinCRegionMax, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMinCRegionMin, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMaxYRegionMax, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMaxYRegionMin, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMinYMaxGRegionMax, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pMinYMaxGRegionMin, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pRefCb, pFade2->ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamCalibAwbGlobal_t, pAwb, AwbFade2Parm.pRefCr, pFade2->ArraySize );
+
+    BinEndRecord( pBuf, rec );
+}
+
+
+
+/******************************************************************************
+ * BinPutIllumination
+ *****************************************************************************/
+static void BinPutIllumination( BinBuf_t *pBuf, const CamIlluProfile_t *pIllu )
+{
+    uint32_t rec  = BinBeginRecord( pBuf, CAM_CALIBDB_BIN_ILLU );
+    uint32_t base = BinPutItem( pBuf, pIllu, sizeof(*pIllu), BOOL_TRUE );
+
+    BIN_PUT_ARRAY( pBuf, base, CamIlluProfile_t, pIllu, SaturationCurve.pSensorGain, pIllu->SaturationCurve.ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamIlluProfile_t, pIllu, SaturationCurve.pSaturation, pIllu->SaturationCurve.ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamIlluProfile_t, pIllu, VignettingCurve.pSensorGain, pIllu->VignettingCurve.ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamIlluProfile_t, pIllu, VignettingCurve.pVignetting, pIllu->VignettingCurve.ArraySize );
+
+    BinEndRecord( pBuf, rec );
+}
+
+
+
+/******************************************************************************
+ * BinPutDpfProfile
+ *****************************************************************************/
+static void BinPutDpfProfile( BinBuf_t *pBuf, const CamDpfProfile_t *pDpf )
+{
+    uint32_t rec  = BinBeginRecord( pBuf, CAM_CALIBDB_BIN_DPF );
+    uint32_t base = BinPutItem( pBuf, pDpf, sizeof(*pDpf), BOOL_TRUE );
+
+    BIN_PUT_ARRAY( pBuf, base, CamDpfProfile_t, pDpf, DenoiseLevelCurve.pSensorGain, pDpf->DenoiseLevelCurve.ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamDpfProfile_t, pDpf, DenoiseLevelCurve.pDlevel, pDpf->DenoiseLevelCurve.ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamDpfProfile_t, pDpf, SharpeningLevelCurve.pSensorGain, pDpf->SharpeningLevelCurve.ArraySize );
+    BIN_PUT_ARRAY( pBuf, base, CamDpfProfile_t, pDpf, SharpeningLevelCurve.pSlevel, pDpf->SharpeningLevelCurve.ArraySize );
+
+    BinEndRecord( pBuf, rec );
+}
+
+
+
+/******************************************************************************
+ * BinRelocPtr
+ *****************************************************************************/
+static RESULT BinRelocPtr( uint8_t *pRec, uint32_t size, void *pSlot, uint32_t len )
+{
+    uintptr_t offset;
+    void *p = NULL;
+
+    MEMCPY( &offset, pSlot, sizeof(offset) );
+    if ( offset != 0 )
+    {
+        if ( ( offset & 3U ) || ( offset > size ) || ( len > ( size - offset ) ) )
+        {
+            return ( RET_WRONG_CONFIG );
+        }
+        p = pRec + offset;
+    }
+    MEMCPY( pSlot, &p, sizeof(p) );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * BinRelocList
+ *****************************************************************************/
+static RESULT BinRelocList( uint8_t *pRec, uint32_t size, List *pList, uint32_t itemSize )
+{
+    uintptr_t last = 0;
+    uintptr_t offset;
+
+    for ( ;; )
+    {
+        MEMCPY( &offset, &pList->p_next, sizeof(offset) );
+        if ( offset == 0 )
+        {
+            pList->p_next = NULL;
+            break;
+        }
+
+        /* items only ever follow each other, this also rules out loops */
+        if ( ( offset <= last ) || ( offset & ( CAM_CALIBDB_BIN_ALIGN - 1 ) )
+                || ( offset > size ) || ( itemSize > ( size - offset ) ) )
+        {
+            return ( RET_WRONG_CONFIG );
+        }
+        last = offset;
+
+        pList->p_next = (List *)( pRec + offset );
+        pList = pList->p_next;
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * BinDupArray
+ *****************************************************************************/
+static void *BinDupArray( const void *pData, uint32_t len )
+{
+    void *p;
+
+    if ( pData == NULL )
+    {
+        return ( NULL );
+    }
+
+    p = malloc( len ? len : 1 );
+    if ( p != NULL )
+    {
+        MEMCPY( p, pData, len );
+    }
+
+    return ( p );
+}
+
+
+
+/******************************************************************************
+ * BinAddAwbGlobal
+ *****************************************************************************/
+static RESULT BinAddAwbGlobal( CamCalibDbHandle_t hCamCalibDb, uint8_t *pRec, uint32_t size )
+{
+    CamCalibAwbGlobal_t *pAwb = (CamCalibAwbGlobal_t *)pRec;
+    uint16_t n1, n2, n;
+
+    RESULT result = RET_SUCCESS;
+
+    n1 = pAwb->AwbClipParam.ArraySize1;
+    n2 = pAwb->AwbClipParam.ArraySize2;
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbClipParam.pRg1, n1 );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbClipParam.pMaxDist1, n1 );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbClipParam.pRg2, n2 );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbClipParam.pMaxDist2, n2 );
+
+    n1 = pAwb->AwbGlobalFadeParm.ArraySize1;
+    n2 = pAwb->AwbGlobalFadeParm.ArraySize2;
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbGlobalFadeParm.pGlobalFade1, n1 );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbGlobalFadeParm.pGlobalGainDistance1, n1 );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbGlobalFadeParm.pGlobalFade2, n2 );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbGlobalFadeParm.pGlobalGainDistance2, n2 );
+
+    n = pAwb->AwbFade2Parm.ArraySize;
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pFade, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pCbMinRegionMax, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pCrMinRegionMax, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMaxCSumRegionMax, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pCbMinRegionMin, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pCrMinRegionMin, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMaxCSumRegionMin, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMinCRegionMax, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMinCRegionMin, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMaxYRegionMax, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMaxYRegionMin, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMinYMaxGRegionMax, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pMinYMaxGRegionMin, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pRefCb, n );
+    result |= BIN_RELOC_ARRAY( pRec, size, pAwb, AwbFade2Parm.pRefCr, n );
+
+    if ( result != RET_SUCCESS )
+    {
+        return ( RET_WRONG_CONFIG );
+    }
+
+    return ( CamCalibDbAddAwbGlobal( hCamCalibDb, pAwb ) );
+}
+
+
+
+/******************************************************************************
+ * BinAddIllumination
+ *****************************************************************************/
+static RESULT BinAddIllumination( CamCalibDbHandle_t hCamCalibDb, uint8_t *pRec, uint32_t size )
+{
+    CamIlluProfile_t *pIllu = (CamIlluProfile_t *)pRec;
+
+    RESULT result = RET_SUCCESS;
+
+    result |= BIN_RELOC_ARRAY( pRec, size, pIllu, SaturationCurve.pSensorGain, pIllu->SaturationCurve.ArraySize );
+    result |= BIN_RELOC_ARRAY( pRec, size, pIllu, SaturationCurve.pSaturation, pIllu->SaturationCurve.ArraySize );
+    result |= BIN_RELOC_ARRAY( pRec, size, pIllu, VignettingCurve.pSensorGain, pIllu->VignettingCurve.ArraySize );
+    result |= BIN_RELOC_ARRAY( pRec, size, pIllu, VignettingCurve.pVignetting, pIllu->VignettingCurve.ArraySize );
+
+    if ( result != RET_SUCCESS )
+    {
+        return ( RET_WRONG_CONFIG );
+    }
+
+    return ( CamCalibDbAddIllumination( hCamCalibDb, pIllu ) );
+}
+
+
+
+/******************************************************************************
+ * BinAddDpfProfile
+ *****************************************************************************/
+static RESULT BinAddDpfProfile( CamCalibDbHandle_t hCamCalibDb, uint8_t *pRec, uint32_t size )
+{
+    CamDpfProfile_t *pDpf = (CamDpfProfile_t *)pRec;
+    CamDenoiseLevelCurve_t    *pDenoise = &pDpf->DenoiseLevelCurve;
+    CamSharpeningLevelCurve_t *pSharp   = &pDpf->SharpeningLevelCurve;
+
+    RESULT result = RET_SUCCESS;
+
+    result |= BIN_RELOC_ARRAY( pRec, size, pDpf, DenoiseLevelCurve.pSensorGain, pDenoise->ArraySize );
+    result |= BIN_RELOC_ARRAY( pRec, size, pDpf, DenoiseLevelCurve.pDlevel, pDenoise->ArraySize );
+    result |= BIN_RELOC_ARRAY( pRec, size, pDpf, SharpeningLevelCurve.pSensorGain, pSharp->ArraySize );
+    result |= BIN_RELOC_ARRAY( pRec, size, pDpf, SharpeningLevelCurve.pSlevel, pSharp->ArraySize );
+
+    if ( result != RET_SUCCESS )
+    {
+        return ( RET_WRONG_CONFIG );
+    }
+
+    /* the dpf profile takes over the curves instead of copying them */
+    pDenoise->pSensorGain = BinDupArray( pDenoise->pSensorGain, pDenoise->ArraySize * sizeof(float) );
+    pDenoise->pDlevel     = BinDupArray( pDenoise->pDlevel, pDenoise->ArraySize * sizeof(*pDenoise->pDlevel) );
+    pSharp->pSensorGain   = BinDupArray( pSharp->pSensorGain, pSharp->ArraySize * sizeof(float) );
+    pSharp->pSlevel       = BinDupArray( pSharp->pSlevel, pSharp->ArraySize * sizeof(*pSharp->pSlevel) );
+
+    result = CamCalibDbAddDpfProfile( hCamCalibDb, pDpf );
+    if ( result != RET_SUCCESS )
+    {
+        free( pDenoise->pSensorGain );
+        free( pDenoise->pDlevel );
+        free( pSharp->pSensorGain );
+        free( pSharp->pSlevel );
+    }
+
+    return ( result );
+}
+
+
+
+/******************************************************************************
+ * BinAddRecord
+ *****************************************************************************/
+static RESULT BinAddRecord
+(
+    CamCalibDbHandle_t  hCamCalibDb,
+    uint32_t            tag,
+    uint8_t             *pRec,
+    uint32_t            size
+)
+{
+    static const uint32_t itemSize[] =
+    {
+        [CAM_CALIBDB_BIN_META]          = sizeof( CamCalibDbMetaData_t ),
+        [CAM_CALIBDB_BIN_SYSTEM]        = sizeof( CamCalibSystemData_t ),
+        [CAM_CALIBDB_BIN_RESOLUTION]    = sizeof( CamResolution_t ),
+        [CAM_CALIBDB_BIN_AWB_GLOBAL]    = sizeof( CamCalibAwbGlobal_t ),
+        [CAM_CALIBDB_BIN_AEC_GLOBAL]    = sizeof( CamCalibAecGlobal_t ),
+        [CAM_CALIBDB_BIN_GAMMA_OUT]     = sizeof( CamCalibGammaOut_t ),
+        [CAM_CALIBDB_BIN_ECM_PROFILE]   = sizeof( CamEcmProfile_t ),
+        [CAM_CALIBDB_BIN_ILLU]          = sizeof( CamIlluProfile_t ),
+        [CAM_CALIBDB_BIN_LSC]           = sizeof( CamLscProfile_t ),
+        [CAM_CALIBDB_BIN_CC]            = sizeof( CamCcProfile_t ),
+        [CAM_CALIBDB_BIN_BLS]           = sizeof( CamBlsProfile_t ),
+        [CAM_CALIBDB_BIN_CAC]           = sizeof( CamCacProfile_t ),
+        [CAM_CALIBDB_BIN_DPF]           = sizeof( CamDpfProfile_t ),
+        [CAM_CALIBDB_BIN_DPCC]          = sizeof( CamDpccProfile_t ),
+    };
+
+    RESULT result;
+
+    if ( ( tag == 0 ) || ( tag >= ( sizeof(itemSize) / sizeof(itemSize[0]) ) )
+            || ( size < itemSize[tag] ) )
+    {
+        return ( RET_WRONG_CONFIG );
+    }
+
+    switch ( tag )
+    {
+        case CAM_CALIBDB_BIN_META:
+            return ( CamCalibDbSetMetaData( hCamCalibDb, (CamCalibDbMetaData_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_SYSTEM:
+            return ( CamCalibDbSetSystemData( hCamCalibDb, (CamCalibSystemData_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_RESOLUTION:
+            result = BinRelocList( pRec, size, &((CamResolution_t *)pRec)->framerates, sizeof(CamFrameRate_t) );
+            if ( result != RET_SUCCESS )
+            {
+                return ( result );
+            }
+            return ( CamCalibDbAddResolution( hCamCalibDb, (CamResolution_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_AWB_GLOBAL:
+            return ( BinAddAwbGlobal( hCamCalibDb, pRec, size ) );
+
+        case CAM_CALIBDB_BIN_AEC_GLOBAL:
+            return ( CamCalibDbAddAecGlobal( hCamCalibDb, (CamCalibAecGlobal_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_GAMMA_OUT:
+            return ( CamCalibDbAddGammaOut( hCamCalibDb, (CamCalibGammaOut_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_ECM_PROFILE:
+            result = BinRelocList( pRec, size, &((CamEcmProfile_t *)pRec)->ecm_scheme, sizeof(CamEcmScheme_t) );
+            if ( result != RET_SUCCESS )
+            {
+                return ( result );
+            }
+            return ( CamCalibDbAddEcmProfile( hCamCalibDb, (CamEcmProfile_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_ILLU:
+            return ( BinAddIllumination( hCamCalibDb, pRec, size ) );
+
+        case CAM_CALIBDB_BIN_LSC:
+            return ( CamCalibDbAddLscProfile( hCamCalibDb, (CamLscProfile_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_CC:
+            return ( CamCalibDbAddCcProfile( hCamCalibDb, (CamCcProfile_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_BLS:
+            return ( CamCalibDbAddBlsProfile( hCamCalibDb, (CamBlsProfile_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_CAC:
+            return ( CamCalibDbAddCacProfile( hCamCalibDb, (CamCacProfile_t *)pRec ) );
+
+        case CAM_CALIBDB_BIN_DPF:
+            return ( BinAddDpfProfile( hCamCalibDb, pRec, size ) );
+
+        case CAM_CALIBDB_BIN_DPCC:
+            return ( CamCalibDbAddDpccProfile( hCamCalibDb, (CamDpccProfile_t *)pRec ) );
+
+        default:
+            return ( RET_WRONG_CONFIG );
+    }
+}
+
+
+
+/******************************************************************************
+ * See header file for detailed comment.
+ *****************************************************************************/
+
+/******************************************************************************
+ * CamCalibDbHashFile
+ *****************************************************************************/
+RESULT CamCalibDbHashFile
+(
+    const char  *pFileName,
+    uint64_t    *pHash
+)
+{
+    struct stat st;
+    void *pMap;
+    int fd;
+
+    if ( ( pFileName == NULL ) || ( pHash == NULL ) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    fd = open( pFileName, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return ( RET_INVALID_PARM );
+    }
+
+    if ( ( fstat( fd, &st ) < 0 ) || ( st.st_size <= 0 ) )
+    {
+        close( fd );
+        return ( RET_FAILURE );
+    }
+
+    pMap = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( pMap == MAP_FAILED )
+    {
+        return ( RET_FAILURE );
+    }
+
+    *pHash = Fnv1a64( FNV1A64_OFFSET, pMap, st.st_size );
+    munmap( pMap, st.st_size );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamCalibDbSaveBinary
+ *****************************************************************************/
+RESULT CamCalibDbSaveBinary
+(
+    CamCalibDbHandle_t  hCamCalibDb,
+    const char          *pFileName,
+    uint64_t            srcHash
+)
+{
+    CamCalibDbContext_t *pCamCalibDbCtx = (CamCalibDbContext_t *)hCamCalibDb;
+    CamCalibDbBinHeader_t *pHeader;
+    CamCalibDbMetaData_t meta;
+    const List *pItem;
+    char tmpName[256];
+    uint32_t rec, base;
+    ssize_t written;
+    BinBuf_t buf;
+    int fd;
+
+    TRACE( CAM_CALIBDB_BIN_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( NULL == pCamCalibDbCtx )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( ( NULL == pFileName )
+            || ( snprintf( tmpName, sizeof(tmpName), "%s.tmp", pFileName ) >= (int)sizeof(tmpName) ) )
+    {
+        return ( RET_INVALID_PARM );
+    }
+
+    MEMSET( &buf, 0, sizeof(buf) );
+    BinBufReserve( &buf, sizeof(CamCalibDbBinHeader_t) );
+
+    /* meta and system data */
+    MEMSET( &meta, 0, sizeof(meta) );
+    MEMCPY( meta.cdate, pCamCalibDbCtx->cdate, sizeof(meta.cdate) );
+    MEMCPY( meta.cname, pCamCalibDbCtx->cname, sizeof(meta.cname) );
+    MEMCPY( meta.cversion, pCamCalibDbCtx->cversion, sizeof(meta.cversion) );
+    MEMCPY( meta.sname, pCamCalibDbCtx->sname, sizeof(meta.sname) );
+    MEMCPY( meta.sid, pCamCalibDbCtx->sid, sizeof(meta.sid) );
+    meta.OTPInfo = pCamCalibDbCtx->OTPInfo;
+
+    rec = BinBeginRecord( &buf, CAM_CALIBDB_BIN_META );
+    BinPutItem( &buf, &meta, sizeof(meta), BOOL_FALSE );
+    BinEndRecord( &buf, rec );
+
+    rec = BinBeginRecord( &buf, CAM_CALIBDB_BIN_SYSTEM );
+    BinPutItem( &buf, &pCamCalibDbCtx->system, sizeof(pCamCalibDbCtx->system), BOOL_FALSE );
+    BinEndRecord( &buf, rec );
+
+    /* resolutions with their framerates */
+    for ( pItem = ListHead( &pCamCalibDbCtx->resolution ); pItem; pItem = pItem->p_next )
+    {
+        rec  = BinBeginRecord( &buf, CAM_CALIBDB_BIN_RESOLUTION );
+        base = BinPutItem( &buf, pItem, sizeof(CamResolution_t), BOOL_TRUE );
+        BinPutList( &buf, base, base + offsetof( CamResolution_t, framerates ),
+                    &((const CamResolution_t *)pItem)->framerates, sizeof(CamFrameRate_t) );
+        BinEndRecord( &buf, rec );
+    }
+
+    for ( pItem = ListHead( &pCamCalibDbCtx->awb_global ); pItem; pItem = pItem->p_next )
+    {
+        BinPutAwbGlobal( &buf, (const CamCalibAwbGlobal_t *)pItem );
+    }
+
+    if ( pCamCalibDbCtx->pAecGlobal )
+    {
+        rec = BinBeginRecord( &buf, CAM_CALIBDB_BIN_AEC_GLOBAL );
+        BinPutItem( &buf, pCamCalibDbCtx->pAecGlobal, sizeof(CamCalibAecGlobal_t), BOOL_FALSE );
+        BinEndRecord( &buf, rec );
+    }
+
+    if ( pCamCalibDbCtx->pGammaOut )
+    {
+        rec = BinBeginRecord( &buf, CAM_CALIBDB_BIN_GAMMA_OUT );
+        BinPutItem( &buf, pCamCalibDbCtx->pGammaOut, sizeof(CamCalibGammaOut_t), BOOL_FALSE );
+        BinEndRecord( &buf, rec );
+    }
+
+    /* ecm profiles with their schemes */
+    for ( pItem = ListHead( &pCamCalibDbCtx->ecm_profile ); pItem; pItem = pItem->p_next )
+    {
+        rec  = BinBeginRecord( &buf, CAM_CALIBDB_BIN_ECM_PROFILE );
+        base = BinPutItem( &buf, pItem, sizeof(CamEcmProfile_t), BOOL_TRUE );
+        BinPutList( &buf, base, base + offsetof( CamEcmProfile_t, ecm_scheme ),
+                    &((const CamEcmProfile_t *)pItem)->ecm_scheme, sizeof(CamEcmScheme_t) );
+        BinEndRecord( &buf, rec );
+    }
+
+    for ( pItem = ListHead( &pCamCalibDbCtx->illumination ); pItem; pItem = pItem->p_next )
+    {
+        BinPutIllumination( &buf, (const CamIlluProfile_t *)pItem );
+    }
+
+    BinPutSimpleList( &buf, CAM_CALIBDB_BIN_LSC, &pCamCalibDbCtx->lsc_profile, sizeof(CamLscProfile_t) );
+    BinPutSimpleList( &buf, CAM_CALIBDB_BIN_CC, &pCamCalibDbCtx->cc_profile, sizeof(CamCcProfile_t) );
+    BinPutSimpleList( &buf, CAM_CALIBDB_BIN_BLS, &pCamCalibDbCtx->bls_profile, sizeof(CamBlsProfile_t) );
+    BinPutSimpleList( &buf, CAM_CALIBDB_BIN_CAC, &pCamCalibDbCtx->cac_profile, sizeof(CamCacProfile_t) );
+
+    for ( pItem = ListHead( &pCamCalibDbCtx->dpf_profile ); pItem; pItem = pItem->p_next )
+    {
+        BinPutDpfProfile( &buf, (const CamDpfProfile_t *)pItem );
+    }
+
+    BinPutSimpleList( &buf, CAM_CALIBDB_BIN_DPCC, &pCamCalibDbCtx->dpcc_profile, sizeof(CamDpccProfile_t) );
+
+    if ( buf.result != RET_SUCCESS )
+    {
+        TRACE( CAM_CALIBDB_BIN_ERROR, "%s (out of memory)\n", __FUNCTION__ );
+        free( buf.pData );
+        return ( buf.result );
+    }
+
+    pHeader = (CamCalibDbBinHeader_t *)buf.pData;
+    pHeader->magic       = CAM_CALIBDB_BIN_MAGIC;
+    pHeader->version     = CAM_CALIBDB_BIN_VERSION;
+    pHeader->headerSize  = sizeof(CamCalibDbBinHeader_t);
+    pHeader->layout      = BinLayout();
+    pHeader->payloadSize = buf.used - sizeof(CamCalibDbBinHeader_t);
+    pHeader->srcHash     = srcHash;
+    pHeader->payloadCrc  = Crc32( buf.pData + sizeof(CamCalibDbBinHeader_t), pHeader->payloadSize );
+
+    /* write aside and rename, a reader never sees half an image */
+    fd = open( tmpName, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if ( fd < 0 )
+    {
+        TRACE( CAM_CALIBDB_BIN_WARN, "%s (can't create %s)\n", __FUNCTION__, tmpName );
+        free( buf.pData );
+        return ( RET_FAILURE );
+    }
+    written = write( fd, buf.pData, buf.used );
+    if ( ( close( fd ) < 0 ) || ( written != (ssize_t)buf.used )
+            || ( rename( tmpName, pFileName ) < 0 ) )
+    {
+        TRACE( CAM_CALIBDB_BIN_WARN, "%s (can't write %s)\n", __FUNCTION__, pFileName );
+        unlink( tmpName );
+        free( buf.pData );
+        return ( RET_FAILURE );
+    }
+
+    TRACE( CAM_CALIBDB_BIN_INFO, "%s (exit, %u bytes)\n", __FUNCTION__, buf.used );
+    free( buf.pData );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamCalibDbLoadBinary
+ *****************************************************************************/
+RESULT CamCalibDbLoadBinary
+(
+    CamCalibDbHandle_t  hCamCalibDb,
+    const char          *pFileName,
+    uint64_t            srcHash
+)
+{
+    const CamCalibDbBinHeader_t *pHeader;
+    struct stat st;
+    uint8_t *pMap;
+    uint32_t offset, end;
+    int fd;
+
+    RESULT result = RET_SUCCESS;
+
+    TRACE( CAM_CALIBDB_BIN_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( NULL == hCamCalibDb )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( NULL == pFileName )
+    {
+        return ( RET_INVALID_PARM );
+    }
+
+    fd = open( pFileName, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return ( RET_NOTAVAILABLE );
+    }
+
+    if ( ( fstat( fd, &st ) < 0 ) || ( st.st_size < (off_t)sizeof(CamCalibDbBinHeader_t) )
+            || ( st.st_size > (off_t)0x7fffffff ) )
+    {
+        close( fd );
+        return ( RET_WRONG_CONFIG );
+    }
+
+    /* private and writable: pointers are fixed up in place, the file stays as it is */
+    pMap = mmap( NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( pMap == MAP_FAILED )
+    {
+        return ( RET_FAILURE );
+    }
+
+    pHeader = (const CamCalibDbBinHeader_t *)pMap;
+    if ( ( pHeader->magic != CAM_CALIBDB_BIN_MAGIC )
+            || ( pHeader->version != CAM_CALIBDB_BIN_VERSION )
+            || ( pHeader->headerSize != sizeof(CamCalibDbBinHeader_t) )
+            || ( pHeader->layout != BinLayout() )
+            || ( pHeader->payloadSize != ( (uint32_t)st.st_size - sizeof(CamCalibDbBinHeader_t) ) ) )
+    {
+        TRACE( CAM_CALIBDB_BIN_WARN, "%s (%s is not an image of this build)\n", __FUNCTION__, pFileName );
+        result = RET_WRONG_CONFIG;
+    }
+    else if ( pHeader->srcHash != srcHash )
+    {
+        TRACE( CAM_CALIBDB_BIN_INFO, "%s (%s is stale)\n", __FUNCTION__, pFileName );
+        result = RET_NOTAVAILABLE;
+    }
+    else if ( pHeader->payloadCrc != Crc32( pMap + sizeof(CamCalibDbBinHeader_t), pHeader->payloadSize ) )
+    {
+        TRACE( CAM_CALIBDB_BIN_WARN, "%s (%s checksum mismatch)\n", __FUNCTION__, pFileName );
+        result = RET_WRONG_CONFIG;
+    }
+
+    offset = sizeof(CamCalibDbBinHeader_t);
+    end    = (uint32_t)st.st_size;
+    while ( ( result == RET_SUCCESS ) && ( offset < end ) )
+    {
+        const CamCalibDbBinRecord_t *pRec = (const CamCalibDbBinRecord_t *)( pMap + offset );
+
+        if ( ( ( end - offset ) < sizeof(*pRec) )
+                || ( pRec->size & ( CAM_CALIBDB_BIN_ALIGN - 1 ) )
+                || ( pRec->size > ( end - offset - sizeof(*pRec) ) ) )
+        {
+            result = RET_WRONG_CONFIG;
+            break;
+        }
+
+        result = BinAddRecord( hCamCalibDb, pRec->tag, pMap + offset + sizeof(*pRec), pRec->size );
+        if ( result != RET_SUCCESS )
+        {
+            TRACE( CAM_CALIBDB_BIN_ERROR, "%s (record %u at %u failed: %d)\n",
+                    __FUNCTION__, pRec->tag, offset, result );
+        }
+
+        offset += sizeof(*pRec) + pRec->size;
+    }
+
+    munmap( pMap, st.st_size );
+
+    if ( result != RET_SUCCESS )
+    {
+        (void)CamCalibDbClear( hCamCalibDb );
+        return ( result );
+    }
+
+    TRACE( CAM_CALIBDB_BIN_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( RET_SUCCESS );
+}
+
+
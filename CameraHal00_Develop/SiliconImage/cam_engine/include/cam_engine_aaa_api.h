@@ -1065,6 +1065,57 @@ RESULT CamEngineAwbGetIlluEstInfo
 );
 
 
+
+/*****************************************************************************/
+/**
+ * @brief   This function starts recording the 3A measurements to a log.
+ *
+ *          Every histogram, mean luma, AWB and AFM measurement the 3A modules
+ *          processed is written together with the resulting sensor exposure,
+ *          white balance gains, cross talk matrix and offset and a hash of
+ *          the lsc matrix. The log is replayed offline with aaa_replay. It
+ *          ends on @ref CamEngineAaaRecordStop or when the CamEngine is
+ *          reconfigured. Changing 3A settings during a recording makes the
+ *          replay diverge from it.
+ *
+ * @param   hCamEngine          Handle to the CamEngine instance.
+ * @param   pFileName           Log file to create.
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS         function succeed
+ * @retval  RET_WRONG_HANDLE    invalid instance handle
+ * @retval  RET_WRONG_STATE     CamEngine not running
+ * @retval  RET_NOTSUPP         no sensor driven AEC/AWB
+ * @retval  RET_BUSY            already recording
+ * @retval  RET_FAILURE         log can't be written
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaRecordStart
+(
+    CamEngineHandle_t   hCamEngine,
+    const char          *pFileName
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   This function stops recording the 3A measurements.
+ *
+ * @param   hCamEngine          Handle to the CamEngine instance.
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS         function succeed
+ * @retval  RET_WRONG_HANDLE    invalid instance handle
+ * @retval  RET_WRONG_STATE     not recording
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaRecordStop
+(
+    CamEngineHandle_t   hCamEngine
+);
+
+
 #ifdef __cplusplus
 }
 #endif
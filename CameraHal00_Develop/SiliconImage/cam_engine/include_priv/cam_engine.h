@@ -24,6 +24,8 @@
 #ifndef __CAM_ENGINE_H__
 #define __CAM_ENGINE_H__
 
+#include <stdio.h>
+
 #include <ebase/types.h>
 #include <oslayer/oslayer.h>
 #include <common/return_codes.h>
@@ -33,6 +35,11 @@
 #include <bufferpool/media_buffer_queue_ex.h>
 
 #include <cameric_drv/cameric_drv_api.h>
+#include <cameric_drv/cameric_isp_hist_drv_api.h>
+#include <cameric_drv/cameric_isp_exp_drv_api.h>
+#include <cameric_drv/cameric_isp_awb_drv_api.h>
+#include <cameric_drv/cameric_isp_afm_drv_api.h>
+#include <cameric_drv/cameric_isp_vsm_drv_api.h>
 #include <mipi_drv/mipi_drv_api.h>
 
 #include <aec/aec.h>
@@ -98,6 +105,109 @@ typedef struct ChainCtx_s
 } ChainCtx_t;
 
 
+/**
+ * @brief   Measurement types handed over from the CamerIc event callback to
+ *          the 3A worker thread. HIST to AFM are logged with the same value
+ *          as AAA_REPLAY_MEAS_*.
+ *
+ */
+typedef enum CamEngineMeasType_e
+{
+    CAM_ENGINE_MEAS_HIST        = 0,                        /**< histogram bins */
+    CAM_ENGINE_MEAS_MEANLUMA    = 1,                        /**< mean luma grid */
+    CAM_ENGINE_MEAS_AWB         = 2,                        /**< awb measuring result */
+    CAM_ENGINE_MEAS_AFM         = 3,                        /**< afm measuring result */
+    CAM_ENGINE_MEAS_VSM         = 4,                        /**< vsm displacement vector */
+    CAM_ENGINE_MEAS_MAX
+} CamEngineMeasType_t;
+
+
+/**
+ * @brief   Copy of one measurement, the driver reuses its own result buffers
+ *          as soon as the event callback returns.
+ *
+ */
+typedef union CamEngineMeasData_u
+{
+    CamerIcHistBins_t               Bins;
+    CamerIcMeanLuma_t               Luma;
+    CamerIcAwbMeasuringResult_t     Awb;
+    CamerIcAfmMeasuringResult_t     Afm;
+    CamerIcIspVsmEventData_t        Vsm;
+} CamEngineMeasData_t;
+
+
+/**
+ * @brief   Latest-wins mailbox for one measurement type (triple buffer).
+ *
+ * The event callback fills Buf[Back] and swaps it with the middle buffer, the
+ * worker swaps Buf[Front] with the middle buffer if it is marked fresh. A
+ * measurement not taken by the worker in time is overwritten by the next one.
+ *
+ */
+typedef struct CamEngineMeasSlot_s
+{
+    CamEngineMeasData_t         Buf[3];
+    int64_t                     Stamp[3];                   /**< arrival time of the measurement in us */
+    uint32_t                    Middle;                     /**< index of middle buffer | CAM_ENGINE_MEAS_FRESH */
+    uint32_t                    Back;                       /**< buffer owned by the event callback */
+    uint32_t                    Front;                      /**< buffer owned by the worker */
+
+    uint32_t                    Dropped;                    /**< measurements overwritten before processing */
+    uint32_t                    Processed;                  /**< measurements processed by the worker */
+    uint32_t                    Late;                       /**< measurements processed after the frame deadline */
+    int64_t                     MaxUs;                      /**< worst latency from arrival to end of processing */
+} CamEngineMeasSlot_t;
+
+#define CAM_ENGINE_MEAS_FRESH   0x4UL
+
+/**
+ * @brief   AwbProcessFrame() runs on every n-th awb measurement once the aec
+ *          settled. The awb damping is applied per processed frame, so a
+ *          smaller n also settles the white balance faster.
+ */
+#ifndef CAM_ENGINE_AWB_DECIMATION
+#define CAM_ENGINE_AWB_DECIMATION   3UL
+#endif
+
+
+/**
+ * @brief   Context of the 3A worker thread of one cam-engine instance.
+ *
+ */
+typedef struct CamEngineAaaWorker_s
+{
+    osThread                    thread;                     /**< 3A worker thread */
+    osEvent                     event;                      /**< signalled on each new measurement */
+    osMutex                     lock;                       /**< held while a measurement is processed */
+    uint32_t                    running;                    /**< cleared to stop the worker */
+    uint32_t                    generation;                 /**< bumped on restart, drops pending measurements */
+
+    CamEngineMeasSlot_t         slot[CAM_ENGINE_MEAS_MAX];
+
+    /* decimation, event callback side */
+    uint32_t                    MeanCnt;
+    uint32_t                    ExpCnt;
+    uint32_t                    AfCnt;
+    uint32_t                    AfCntMax;
+    uint32_t                    AvsCnt;
+    uint32_t                    AvsCntWait;
+
+    /* decimation, worker side */
+    uint32_t                    AwbCnt;
+
+    /* frame deadline */
+    int64_t                     LastFrameUs;                /**< arrival time of the last histogram */
+    uint32_t                    FramePeriodUs;              /**< distance of the last two histograms */
+    uint32_t                    Frames;                     /**< histograms since the last report */
+
+    /* measurement log, see CamEngineAaaRecordStart() */
+    FILE                        *pRecord;                   /**< open while recording, written by the worker */
+    int64_t                     RecordLastUs;               /**< stamp of the last record written */
+    uint32_t                    Records;                    /**< records written */
+} CamEngineAaaWorker_t;
+
+
 /**
  * @brief Internal context of the cam-engine
  *
@@ -198,6 +308,8 @@ typedef struct CamEngineContext_s
 	osMutex 					camEngineCtx_lock;
 	uint32_t					index;
 	bool_t						color_mode;
+
+    CamEngineAaaWorker_t        aaaWorker;                  /**< 3A processing decoupled from the measurement callback */
 } CamEngineContext_t;
 
 
@@ -39,6 +39,105 @@
 
 
 
+/*****************************************************************************/
+/**
+ * @brief   Starts the 3A worker thread of a CamEngine instance. The worker
+ *          runs the auto algorithms on the measurements handed over by
+ *          @ref CamEngineCamerIcDrvMeasureCb, so slow algorithms don't hold
+ *          up the driver's event delivery.
+ *
+ * @param   pCamEngineCtx   Pointer to the context of CamEngine instance
+ *
+ * @return              Return the result of the function call.
+ * @retval              RET_SUCCESS
+ * @retval              RET_WRONG_HANDLE
+ * @retval              RET_FAILURE
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerInit
+(
+    CamEngineContext_t  *pCamEngineCtx
+);
+
+
+/*****************************************************************************/
+/**
+ * @brief   Stops the 3A worker thread and reports its deadline statistics.
+ *
+ * @param   pCamEngineCtx   Pointer to the context of CamEngine instance
+ *
+ * @return              Return the result of the function call.
+ * @retval              RET_SUCCESS
+ * @retval              RET_WRONG_HANDLE
+ * @retval              RET_FAILURE
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerRelease
+(
+    CamEngineContext_t  *pCamEngineCtx
+);
+
+
+/*****************************************************************************/
+/**
+ * @brief   Waits for the measurement the 3A worker is processing and drops
+ *          all pending ones. Call after the measurement drivers are stopped.
+ *
+ * @param   pCamEngineCtx   Pointer to the context of CamEngine instance
+ *
+ * @return              Return the result of the function call.
+ * @retval              RET_SUCCESS
+ * @retval              RET_WRONG_HANDLE
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerFlush
+(
+    CamEngineContext_t  *pCamEngineCtx
+);
+
+
+/*****************************************************************************/
+/**
+ * @brief   Opens a measurement log and writes the current 3A setup to it.
+ *          From then on the worker appends every measurement it processed.
+ *          The recording ends on @ref CamEngineAaaWorkerRecordStop, on
+ *          restart of the measurements and on release of the worker.
+ *
+ * @param   pCamEngineCtx   Pointer to the context of CamEngine instance
+ * @param   pFileName       Log to create
+ *
+ * @return              Return the result of the function call.
+ * @retval              RET_SUCCESS
+ * @retval              RET_WRONG_HANDLE
+ * @retval              RET_BUSY        already recording
+ * @retval              RET_FAILURE     log can't be written
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerRecordStart
+(
+    CamEngineContext_t  *pCamEngineCtx,
+    const char          *pFileName
+);
+
+
+/*****************************************************************************/
+/**
+ * @brief   Closes the measurement log.
+ *
+ * @param   pCamEngineCtx   Pointer to the context of CamEngine instance
+ *
+ * @return              Return the result of the function call.
+ * @retval              RET_SUCCESS
+ * @retval              RET_WRONG_HANDLE
+ * @retval              RET_WRONG_STATE not recording
+ *
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerRecordStop
+(
+    CamEngineContext_t  *pCamEngineCtx
+);
+
+
 /*****************************************************************************/
 /**
  * @brief   Short description.
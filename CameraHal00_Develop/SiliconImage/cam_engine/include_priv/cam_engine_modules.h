@@ -38,6 +38,12 @@
 #include "cam_engine.h"
 
 
+/**
+ * @brief   AWB measuring window thresholds the AWB module is configured with.
+ */
+extern const CamerIcAwbMeasuringConfig_t MeasConfig;
+
+
 /*****************************************************************************/
 /**
  * @brief   Short description.
@@ -137,12 +137,20 @@ RESULT CamEngineCreate
         goto cleanup_2;
     }
 
+    /* create 3A worker thread */
+    result = CamEngineAaaWorkerInit( pCamEngineCtx );
+    if ( result != RET_SUCCESS )
+    {
+        TRACE( CAM_ENGINE_ERROR, "%s (creating 3A worker failed)\n", __FUNCTION__ );
+        goto cleanup_3;
+    }
+
     /* create handler thread */
     if ( OSLAYER_OK != osThreadCreate( &pCamEngineCtx->thread, CamEngineThreadHandler, pCamEngineCtx ) )
     {
         TRACE( CAM_ENGINE_ERROR, "%s (creating handler thread failed)\n", __FUNCTION__ );
         result = RET_FAILURE;
-        goto cleanup_3;
+        goto cleanup_4;
     }
 
     osMutexInit(&pCamEngineCtx->camEngineCtx_lock);
@@ -153,6 +161,9 @@ RESULT CamEngineCreate
     return ( RET_SUCCESS );
 
     /* failure cleanup */
+cleanup_4: /* stop 3A worker */
+    (void)CamEngineAaaWorkerRelease( pCamEngineCtx );
+
 cleanup_3: /* delete cmd queue */
     (void)osQueueDestroy( &pCamEngineCtx->commandQueue );
 
@@ -237,6 +248,14 @@ RESULT CamEngineDestroy
         UPDATE_RESULT( result, RET_FAILURE);
     }
 
+    /* stop 3A worker before the modules it drives go away */
+    lres = CamEngineAaaWorkerRelease( pCamEngineCtx );
+    if ( lres != RET_SUCCESS )
+    {
+        TRACE( CAM_ENGINE_ERROR, "%s (stopping 3A worker failed -> RESULT=%d)\n", __FUNCTION__, lres );
+        UPDATE_RESULT( result, lres );
+    }
+
     /* release modules */
     lres = CamEngineModulesRelease( pCamEngineCtx );
     if ( lres != RET_SUCCESS )
@@ -1450,6 +1469,14 @@ RESULT CamEngineReleaseDrv
         UPDATE_RESULT( result, lres );
     }
 
+    /* no more measurements, drop the ones not yet processed */
+    lres = CamEngineAaaWorkerFlush( pCamEngineCtx );
+    if ( lres != RET_SUCCESS )
+    {
+        TRACE( CAM_ENGINE_ERROR, "%s: (can't flush 3A worker %d)\n", __FUNCTION__, lres );
+        UPDATE_RESULT( result, lres );
+    }
+
 #if defined(MRV_JPE_VERSION) //zyc ,for test
     /* jpeg-encoder */
     lres = CamEngineReleaseJpeDrv( pCamEngineCtx );
@@ -24,6 +24,7 @@
 #include "cam_engine.h"
 #include "cam_engine_api.h"
 #include "cam_engine_aaa_api.h"
+#include "cam_engine_cb.h"
 
 /******************************************************************************
  * local macro definitions
@@ -2892,3 +2893,81 @@ RESULT CamEngineAwbGetIlluEstInfo
 
 	return AwbGetIlluEstInfo(pCamEngineCtx->hAwb, ExpPriorIn, ExpPriorOut, name, likehood, wight, curIdx, region, count);
 }
+
+
+
+/******************************************************************************
+ * CamEngineAaaRecordStart()
+ *****************************************************************************/
+RESULT CamEngineAaaRecordStart
+(
+    CamEngineHandle_t   hCamEngine,
+    const char          *pFileName
+)
+{
+    CamEngineContext_t *pCamEngineCtx = (CamEngineContext_t *)hCamEngine;
+
+    RESULT result = RET_SUCCESS;
+
+    TRACE( CAM_ENGINE_API_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( pFileName == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    /* check if cam-engine running */
+    if ( ( CAM_ENGINE_STATE_RUNNING   != pCamEngineCtx->state ) &&
+         ( CAM_ENGINE_STATE_STREAMING != pCamEngineCtx->state ) )
+    {
+        return ( RET_WRONG_STATE );
+    }
+
+    /* only sensor driven aec/awb can be replayed */
+    if ( ( ( CAM_ENGINE_MODE_SENSOR_2D != pCamEngineCtx->mode )
+                && ( CAM_ENGINE_MODE_SENSOR_2D_IMGSTAB != pCamEngineCtx->mode ) )
+            || ( NULL == pCamEngineCtx->chain[pCamEngineCtx->chainIdx0].hSensor )
+            || ( NULL == pCamEngineCtx->hAec ) || ( NULL == pCamEngineCtx->hAwb ) )
+    {
+        return ( RET_NOTSUPP );
+    }
+
+    result = CamEngineAaaWorkerRecordStart( pCamEngineCtx, pFileName );
+
+    TRACE( CAM_ENGINE_API_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( result );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaRecordStop()
+ *****************************************************************************/
+RESULT CamEngineAaaRecordStop
+(
+    CamEngineHandle_t   hCamEngine
+)
+{
+    CamEngineContext_t *pCamEngineCtx = (CamEngineContext_t *)hCamEngine;
+
+    RESULT result = RET_SUCCESS;
+
+    TRACE( CAM_ENGINE_API_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    result = CamEngineAaaWorkerRecordStop( pCamEngineCtx );
+
+    TRACE( CAM_ENGINE_API_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( result );
+}
@@ -28,8 +28,12 @@
 #include <cameric_drv/cameric_isp_afm_drv_api.h>
 #include <cameric_drv/cameric_isp_vsm_drv_api.h>
 
+#include <isi/isi.h>
+#include <replay/aaa_replay_log.h>
+
 #include "cam_engine.h"
 #include "cam_engine_cb.h"
+#include "cam_engine_modules.h"
 
 /******************************************************************************
  * local macro definitions
@@ -41,6 +45,9 @@ CREATE_TRACER( CAM_ENGINE_CB_ERROR, "CAM-ENGINE-CB: ", ERROR  , 1 );
 
 CREATE_TRACER( CAM_ENGINE_CB_DEBUG, "CAM-ENGINE-CB: ", INFO   , 0 );
 
+/* measurements are reported at most every CAM_ENGINE_AAA_REPORT_US */
+#define CAM_ENGINE_AAA_REPORT_US    10000000LL
+
 /******************************************************************************
  * local type definitions
  *****************************************************************************/
@@ -49,26 +56,915 @@ CREATE_TRACER( CAM_ENGINE_CB_DEBUG, "CAM-ENGINE-CB: ", INFO   , 0 );
 /******************************************************************************
  * local variable declarations
  *****************************************************************************/
-// match initialization values with values in CamEngineCamerIcDrvMeasureCbRestart() below
-static uint32_t MeanCnt    = 0UL;
-static uint32_t ExpCnt     = 0UL;
-static uint32_t AwbCnt     = 0UL;
-static uint32_t AfCnt      = 0UL;
-static uint32_t AfCntMax   = 80UL;
-static uint32_t AvsCnt     = 0UL;
-static uint32_t AvsCntWait = 0UL;
-//static uint32_t AvsCntWait = 25UL;
+static const char *CamEngineMeasName[CAM_ENGINE_MEAS_MAX] =
+{
+    "hist", "meanluma", "awb", "afm", "vsm"
+};
+
+static const uint32_t CamEngineMeasSize[CAM_ENGINE_MEAS_MAX] =
+{
+    sizeof( CamerIcHistBins_t ),
+    sizeof( CamerIcMeanLuma_t ),
+    sizeof( CamerIcAwbMeasuringResult_t ),
+    sizeof( CamerIcAfmMeasuringResult_t ),
+    sizeof( CamerIcIspVsmEventData_t )
+};
 
 
 /******************************************************************************
  * local function prototypes
  *****************************************************************************/
+static int32_t CamEngineAaaWorkerThread
+(
+    void *p_arg
+);
+
+
+
+/******************************************************************************
+ * CamEngineMeasPublish()
+ *
+ * Called in the event callback, copies the measurement into the mailbox of
+ * its type and wakes up the worker. Never blocks.
+ *****************************************************************************/
+static void CamEngineMeasPublish
+(
+    CamEngineAaaWorker_t        *pWorker,
+    const CamEngineMeasType_t   type,
+    const void                  *pParam,
+    const int64_t               stamp
+)
+{
+    CamEngineMeasSlot_t *pSlot = &pWorker->slot[type];
+    uint32_t prev;
+
+    MEMCPY( &pSlot->Buf[pSlot->Back], pParam, CamEngineMeasSize[type] );
+    pSlot->Stamp[pSlot->Back] = stamp;
+
+    prev = __atomic_exchange_n( &pSlot->Middle, pSlot->Back | CAM_ENGINE_MEAS_FRESH, __ATOMIC_ACQ_REL );
+    pSlot->Back = prev & ~CAM_ENGINE_MEAS_FRESH;
+    if ( prev & CAM_ENGINE_MEAS_FRESH )
+    {
+        /* worker didn't take the previous one */
+        (void)__atomic_add_fetch( &pSlot->Dropped, 1UL, __ATOMIC_RELAXED );
+    }
+
+    (void)osEventSignal( &pWorker->event );
+}
+
+
+
+/******************************************************************************
+ * CamEngineMeasTake()
+ *
+ * Called in the worker, gets the latest measurement of a type if there is a
+ * new one. The data stays valid until the next call for the same type.
+ *****************************************************************************/
+static bool_t CamEngineMeasTake
+(
+    CamEngineMeasSlot_t *pSlot,
+    CamEngineMeasData_t **ppData,
+    int64_t             *pStamp
+)
+{
+    uint32_t prev;
+
+    if ( !( __atomic_load_n( &pSlot->Middle, __ATOMIC_ACQUIRE ) & CAM_ENGINE_MEAS_FRESH ) )
+    {
+        return ( BOOL_FALSE );
+    }
+
+    prev = __atomic_exchange_n( &pSlot->Middle, pSlot->Front, __ATOMIC_ACQ_REL );
+    pSlot->Front = prev & ~CAM_ENGINE_MEAS_FRESH;
+
+    *ppData = &pSlot->Buf[pSlot->Front];
+    *pStamp = pSlot->Stamp[pSlot->Front];
+
+    return ( BOOL_TRUE );
+}
+
+
+
+/******************************************************************************
+ * CamEngineMeasDone()
+ *
+ * A measurement has to be processed before the next frame is measured.
+ *****************************************************************************/
+static void CamEngineMeasDone
+(
+    CamEngineAaaWorker_t        *pWorker,
+    const CamEngineMeasType_t   type,
+    const int64_t               stamp
+)
+{
+    CamEngineMeasSlot_t *pSlot = &pWorker->slot[type];
+    uint32_t period = __atomic_load_n( &pWorker->FramePeriodUs, __ATOMIC_RELAXED );
+    int64_t now = 0LL;
+    int64_t us;
+
+    (void)osTimeStampUs( &now );
+    us = now - stamp;
+
+    ++pSlot->Processed;
+    if ( us > pSlot->MaxUs )
+    {
+        pSlot->MaxUs = us;
+    }
+
+    if ( ( period > 0UL ) && ( us > (int64_t)period ) )
+    {
+        ++pSlot->Late;
+        TRACE( CAM_ENGINE_CB_DEBUG, "%s: %s took %lld us (frame %u us)\n",
+                __FUNCTION__, CamEngineMeasName[type], us, period );
+    }
+}
+
+
+
+/******************************************************************************
+ * CamEngineMeasReport()
+ *****************************************************************************/
+static void CamEngineMeasReport
+(
+    CamEngineContext_t  *pCamEngineCtx
+)
+{
+    CamEngineAaaWorker_t *pWorker = &pCamEngineCtx->aaaWorker;
+    uint32_t period = __atomic_load_n( &pWorker->FramePeriodUs, __ATOMIC_RELAXED );
+    uint32_t i;
+
+    for ( i = 0UL; i < CAM_ENGINE_MEAS_MAX; i++ )
+    {
+        CamEngineMeasSlot_t *pSlot = &pWorker->slot[i];
+        uint32_t dropped = __atomic_exchange_n( &pSlot->Dropped, 0UL, __ATOMIC_RELAXED );
+
+        if ( ( pSlot->Late > 0UL ) || ( dropped > 0UL ) )
+        {
+            TRACE( CAM_ENGINE_CB_WARN, "engine %u: %s missed deadline: %u processed, %u late, %u dropped, max %lld us (frame %u us)\n",
+                    pCamEngineCtx->index, CamEngineMeasName[i], pSlot->Processed, pSlot->Late, dropped, pSlot->MaxUs, period );
+        }
+        else if ( pSlot->Processed > 0UL )
+        {
+            TRACE( CAM_ENGINE_CB_INFO, "engine %u: %s %u processed, max %lld us (frame %u us)\n",
+                    pCamEngineCtx->index, CamEngineMeasName[i], pSlot->Processed, pSlot->MaxUs, period );
+        }
+
+        pSlot->Processed = 0UL;
+        pSlot->Late      = 0UL;
+        pSlot->MaxUs     = 0LL;
+    }
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaProcessHistogram()
+ *****************************************************************************/
+static void CamEngineAaaProcessHistogram
+(
+    CamEngineContext_t  *pCamEngineCtx,
+    CamerIcHistBins_t   bins
+)
+{
+    RESULT result;
+
+    float fGain = 0.0f;
+    float fTi = 0.0f;
+
+    result = AecClmExecute( pCamEngineCtx->hAec, bins );
+    if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s AecClmExecute: %d", __FUNCTION__, result );
+    }
+    DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+
+    if ( pCamEngineCtx->mode != CAM_ENGINE_MODE_IMAGE_PROCESSING )
+    {
+        /* get current gain */
+        result = AecGetCurrentGain( pCamEngineCtx->hAec, &fGain );
+        DCT_ASSERT( result == RET_SUCCESS );
+
+        result = AecGetCurrentIntegrationTime( pCamEngineCtx->hAec, &fTi );
+        DCT_ASSERT( result == RET_SUCCESS );
+    }
+    else
+    {
+        fGain  = pCamEngineCtx->vGain;
+        fTi = pCamEngineCtx->vItime;
+    }
+
+    TRACE( CAM_ENGINE_CB_DEBUG, "%s gain: %f, Ti: %f\n", __FUNCTION__, fGain, fTi );
+
+    /* calc. denoising pre-filter with current gain */
+    result = AdpfProcessFrame( pCamEngineCtx->hAdpf, fGain );
+    if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s AdpfProcessFrame: %d", __FUNCTION__, result );
+    }
+    DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+
+    /* calc. defect pixel cluster filter with current gain */
+    result = AdpccProcessFrame( pCamEngineCtx->hAdpcc, fGain );
+    if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s AdpccProcessFrame: %d", __FUNCTION__, result );
+    }
+    DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+
+    result = AwbSetHistogram( pCamEngineCtx->hAwb, bins );
+    if ( result != RET_SUCCESS )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s AwbSetHistogram: %d", __FUNCTION__, result );
+    }
+    DCT_ASSERT( (result == RET_SUCCESS) );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaProcessMeanLuma()
+ *****************************************************************************/
+static void CamEngineAaaProcessMeanLuma
+(
+    CamEngineContext_t  *pCamEngineCtx,
+    CamerIcMeanLuma_t   luma
+)
+{
+    RESULT result;
+
+    result = AecSemExecute( pCamEngineCtx->hAec, luma );
+    if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s AecSemExecute: %d", __FUNCTION__, result );
+    }
+    //zyc for test
+    //zhy  v1.0x10.1:
+    //DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaProcessAwb()
+ *****************************************************************************/
+static void CamEngineAaaProcessAwb
+(
+    CamEngineContext_t          *pCamEngineCtx,
+    CamerIcAwbMeasuringResult_t *pAwb
+)
+{
+    CamEngineAaaWorker_t *pWorker = &pCamEngineCtx->aaaWorker;
+    RESULT result;
+    bool_t settled;
+
+    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_AWB (#%d)\n", pWorker->AwbCnt );
+
+    /* decimated here, as it depends on the aec state the worker updates */
+    result = AecSettled( pCamEngineCtx->hAec, &settled );
+    if ( (RET_SUCCESS == result) && (BOOL_TRUE == settled) )
+    {
+        if ( pWorker->AwbCnt >= (CAM_ENGINE_AWB_DECIMATION - 1UL) )
+        {
+            float fIntergrationTime = 0.0f;
+            float fGain = 0.0f;
+
+            pWorker->AwbCnt = 0;
+
+            if ( pCamEngineCtx->mode != CAM_ENGINE_MODE_IMAGE_PROCESSING )
+            {
+                /* get current gain */
+                result = AecGetCurrentGain( pCamEngineCtx->hAec, &fGain );
+                DCT_ASSERT( result == RET_SUCCESS );
+
+                result = AecGetCurrentIntegrationTime( pCamEngineCtx->hAec, &fIntergrationTime );
+                DCT_ASSERT( result == RET_SUCCESS );
+            }
+            else
+            {
+                fGain  = pCamEngineCtx->vGain;
+                fIntergrationTime = pCamEngineCtx->vItime;
+            }
+
+            result = AwbProcessFrame( pCamEngineCtx->hAwb, pAwb, fGain, fIntergrationTime );
+            if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+            {
+                TRACE( CAM_ENGINE_CB_ERROR, "%s AwbProcessFrame: %d", __FUNCTION__, result );
+            }
+            DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+        }
+        else
+        {
+            ++pWorker->AwbCnt;
+        }
+    }
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaProcessAfm()
+ *****************************************************************************/
+static void CamEngineAaaProcessAfm
+(
+    CamEngineContext_t          *pCamEngineCtx,
+    CamerIcAfmMeasuringResult_t *pAfm
+)
+{
+    RESULT result;
+
+    if (pCamEngineCtx->hAf != NULL) {
+        result = AfProcessFrame( pCamEngineCtx->hAf, pAfm );
+        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+        {
+            TRACE( CAM_ENGINE_CB_ERROR, "%s AfProcessFrame: %d", __FUNCTION__, result );
+        }
+        DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+    }
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaProcessVsm()
+ *****************************************************************************/
+static void CamEngineAaaProcessVsm
+(
+    CamEngineContext_t          *pCamEngineCtx,
+    CamerIcIspVsmEventData_t    *pEventData
+)
+{
+    CamerIcIspVsmDisplVec_t *pDisplVec = &pEventData->DisplVec;
+    CamEngineVector_t displVec;
+    bool_t running = BOOL_FALSE;
+    RESULT result;
+
+    if ( NULL == pCamEngineCtx->hAvs )
+    {
+        return;
+    }
+
+    MEMSET( &displVec, 0, sizeof(displVec) );
+
+    displVec.x = pDisplVec->delta_h;
+    displVec.y = pDisplVec->delta_v;
+
+    result = AvsGetStatus( pCamEngineCtx->hAvs, &running, NULL, NULL );
+    if ( result != RET_SUCCESS )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s AvsGetStatus: %d", __FUNCTION__, result );
+    }
+    DCT_ASSERT( result == RET_SUCCESS );
+
+    if ( running )
+    {
+        result = AvsProcessFrame( pCamEngineCtx->hAvs, pEventData->frameId, &displVec );
+        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
+        {
+            TRACE( CAM_ENGINE_CB_ERROR, "%s AvsProcessFrame: %d", __FUNCTION__, result );
+        }
+        DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+    }
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaRecordHeader()
+ *
+ * Collects the 3A setup for the head of a measurement log.
+ *****************************************************************************/
+static RESULT CamEngineAaaRecordHeader
+(
+    CamEngineContext_t      *pCamEngineCtx,
+    AaaReplayLogHeader_t    *pHeader
+)
+{
+    IsiSensorHandle_t hSensor = pCamEngineCtx->chain[pCamEngineCtx->chainIdx0].hSensor;
+    AecConfig_t AecConfig;
+    AfSearchStrategy_t fss = AFM_FSS_INVALID;
+    AwbMode_t AwbMode = AWB_MODE_INVALID;
+    bool_t running = BOOL_FALSE;
+    float sharpness = 0.0f;
+    RESULT result;
+
+    MEMSET( pHeader, 0, sizeof(*pHeader) );
+    pHeader->Magic   = AAA_REPLAY_LOG_MAGIC;
+    pHeader->Version = AAA_REPLAY_LOG_VERSION;
+    pHeader->Width   = pCamEngineCtx->outWindow.width;
+    pHeader->Height  = pCamEngineCtx->outWindow.height;
+
+    result = IsiGetResolutionIss( hSensor, &pHeader->Resolution );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    result = IsiGetGainLimitsIss( hSensor, &pHeader->MinGain, &pHeader->MaxGain );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    result = IsiGetIntegrationTimeLimitsIss( hSensor, &pHeader->MinIntegrationTime, &pHeader->MaxIntegrationTime );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    result = IsiGetCurrentExposureIss( hSensor, &pHeader->StartGain, &pHeader->StartIntegrationTime );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    /* not every driver knows its steps */
+    (void)IsiGetGainIncrementIss( hSensor, &pHeader->GainIncrement );
+    (void)IsiGetIntegrationTimeIncrementIss( hSensor, &pHeader->IntegrationTimeIncrement );
+
+    /* aec */
+    result = AecGetCurrentConfig( pCamEngineCtx->hAec, &AecConfig );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    pHeader->AecDampingMode     = AecConfig.DampingMode;
+    pHeader->AecSemMode         = AecConfig.SemMode;
+    pHeader->AecFlicker         = AecConfig.EcmFlickerSelect;
+    pHeader->AecAfpsEnabled     = AecConfig.AfpsEnabled;
+    pHeader->AecSetPoint        = AecConfig.SetPoint;
+    pHeader->AecClmTolerance    = AecConfig.ClmTolerance;
+    pHeader->AecDampOverStill   = AecConfig.DampOverStill;
+    pHeader->AecDampUnderStill  = AecConfig.DampUnderStill;
+    pHeader->AecDampOverVideo   = AecConfig.DampOverVideo;
+    pHeader->AecDampUnderVideo  = AecConfig.DampUnderVideo;
+    pHeader->AecAfpsMaxGain     = AecConfig.AfpsMaxGain;
+
+    result = AecGetGridWeights( pCamEngineCtx->hAec, pHeader->AecGridWeights );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    result = AecStatus( pCamEngineCtx->hAec, &running, &AecConfig.SemMode, &AecConfig.SetPoint,
+                            &AecConfig.ClmTolerance, &AecConfig.DampingMode, &AecConfig.DampOverStill,
+                            &AecConfig.DampUnderStill, &AecConfig.DampOverVideo, &AecConfig.DampUnderVideo );
+    if ( ( RET_SUCCESS == result ) && ( BOOL_TRUE == running ) )
+    {
+        pHeader->Modules |= AAA_REPLAY_MODULE_AEC;
+    }
+
+    /* awb */
+    pHeader->AwbMeasConfig  = MeasConfig;
+    pHeader->AwbMeasMode    = CAMERIC_ISP_AWB_MEASURING_MODE_YCBCR;
+
+    result = AwbStatus( pCamEngineCtx->hAwb, &running, &AwbMode, &pHeader->AwbIlluIdx, NULL );
+    if ( ( RET_SUCCESS == result ) && ( BOOL_TRUE == running ) )
+    {
+        pHeader->Modules |= AAA_REPLAY_MODULE_AWB;
+    }
+    pHeader->AwbMode = AwbMode;
+    pHeader->AwbCnt  = pCamEngineCtx->aaaWorker.AwbCnt;
+    pHeader->AwbDecimation = CAM_ENGINE_AWB_DECIMATION;
+
+    result = AwbGetFlags( pCamEngineCtx->hAwb, &pHeader->AwbFlags );
+    RETURN_RESULT_IF_DIFFERENT( result, RET_SUCCESS );
+
+    /* af, adpf, adpcc */
+    if ( ( NULL != pCamEngineCtx->hAf )
+            && ( RET_SUCCESS == AfStatus( pCamEngineCtx->hAf, &running, &fss, &sharpness ) )
+            && ( BOOL_TRUE == running ) )
+    {
+        pHeader->Modules |= AAA_REPLAY_MODULE_AF;
+        pHeader->AfSearch = fss;
+    }
+
+    if ( ( RET_SUCCESS == AdpfStatus( pCamEngineCtx->hAdpf, &running ) ) && ( BOOL_TRUE == running ) )
+    {
+        pHeader->Modules |= AAA_REPLAY_MODULE_ADPF;
+    }
+
+    if ( ( RET_SUCCESS == AdpccStatus( pCamEngineCtx->hAdpcc, &running ) ) && ( BOOL_TRUE == running ) )
+    {
+        pHeader->Modules |= AAA_REPLAY_MODULE_ADPCC;
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaRecord()
+ *
+ * Appends a processed measurement and what the 3A modules programmed for it
+ * to the measurement log.
+ *****************************************************************************/
+static void CamEngineAaaRecord
+(
+    CamEngineContext_t          *pCamEngineCtx,
+    const CamEngineMeasType_t   type,
+    const CamEngineMeasData_t   *pData,
+    const int64_t               stamp
+)
+{
+    CamEngineAaaWorker_t *pWorker = &pCamEngineCtx->aaaWorker;
+    CamerIcDrvHandle_t hCamerIc = pCamEngineCtx->chain[pCamEngineCtx->chainIdx0].hCamerIc;
+    CamLscMatrix_t LscMatrix;
+    AaaReplayRecord_t record;
+
+    if ( ( NULL == pWorker->pRecord ) || ( type >= (CamEngineMeasType_t)AAA_REPLAY_MEAS_MAX ) )
+    {
+        return;
+    }
+
+    MEMSET( &record, 0, sizeof(record) );
+    record.Type    = (uint16_t)type;
+    record.Size    = (uint16_t)CamEngineMeasSize[type];
+    record.DeltaUs = ( pWorker->RecordLastUs > 0LL ) ? (uint32_t)( stamp - pWorker->RecordLastUs ) : 0UL;
+    pWorker->RecordLastUs = stamp;
+
+    (void)AecGetCurrentGain( pCamEngineCtx->hAec, &record.Result.fGain );
+    (void)AecGetCurrentIntegrationTime( pCamEngineCtx->hAec, &record.Result.fIntegrationTime );
+    (void)CamerIcIspAwbGetGains( hCamerIc, &record.Result.Gains );
+    (void)CamerIcIspGetCrossTalkCoefficients( hCamerIc, &record.Result.CcMatrix );
+    (void)CamerIcIspGetCrossTalkOffset( hCamerIc, &record.Result.CcOffset );
+    if ( RET_SUCCESS == AwbGetLscMatrix( pCamEngineCtx->hAwb, &LscMatrix ) )
+    {
+        record.Result.LscHash = AaaReplayLscHash( &LscMatrix );
+    }
+
+    if ( ( 1U != fwrite( &record, sizeof(record), 1U, pWorker->pRecord ) )
+            || ( 1U != fwrite( pData, record.Size, 1U, pWorker->pRecord ) ) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (writing measurement log failed, recording stopped)\n", __FUNCTION__ );
+        (void)fclose( pWorker->pRecord );
+        pWorker->pRecord = NULL;
+        return;
+    }
+
+    ++pWorker->Records;
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaRecordClose()
+ *****************************************************************************/
+static void CamEngineAaaRecordClose
+(
+    CamEngineAaaWorker_t    *pWorker
+)
+{
+    if ( NULL != pWorker->pRecord )
+    {
+        if ( 0 != fclose( pWorker->pRecord ) )
+        {
+            TRACE( CAM_ENGINE_CB_ERROR, "%s (closing measurement log failed)\n", __FUNCTION__ );
+        }
+        pWorker->pRecord = NULL;
+
+        TRACE( CAM_ENGINE_CB_INFO, "%s (%u measurements recorded)\n", __FUNCTION__, pWorker->Records );
+    }
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaWorkerThread()
+ *****************************************************************************/
+static int32_t CamEngineAaaWorkerThread
+(
+    void *p_arg
+)
+{
+    CamEngineContext_t *pCamEngineCtx = (CamEngineContext_t *)p_arg;
+    CamEngineAaaWorker_t *pWorker = &pCamEngineCtx->aaaWorker;
+    uint32_t generation = __atomic_load_n( &pWorker->generation, __ATOMIC_ACQUIRE );
+    int64_t lastReport = 0LL;
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    (void)osTimeStampUs( &lastReport );
+
+    for ( ;; )
+    {
+        CamEngineMeasData_t *pData;
+        int64_t stamp;
+        int64_t now = 0LL;
+        uint32_t type;
+
+        if ( OSLAYER_OK != osEventWait( &pWorker->event ) )
+        {
+            TRACE( CAM_ENGINE_CB_ERROR, "%s (waiting for measurement failed)\n", __FUNCTION__ );
+            break;
+        }
+
+        if ( !__atomic_load_n( &pWorker->running, __ATOMIC_ACQUIRE ) )
+        {
+            break;
+        }
+
+        (void)osMutexLock( &pWorker->lock );
+
+        if ( generation != __atomic_load_n( &pWorker->generation, __ATOMIC_ACQUIRE ) )
+        {
+            /* restarted, measurements taken so far belong to the old setup */
+            generation = __atomic_load_n( &pWorker->generation, __ATOMIC_ACQUIRE );
+            pWorker->AwbCnt = 0UL;
+            /* the log header describes the old setup */
+            CamEngineAaaRecordClose( pWorker );
+            for ( type = 0UL; type < CAM_ENGINE_MEAS_MAX; type++ )
+            {
+                (void)CamEngineMeasTake( &pWorker->slot[type], &pData, &stamp );
+            }
+        }
+        else
+        {
+            /* histogram first, awb needs the histogram of the same frame */
+            for ( type = 0UL; type < CAM_ENGINE_MEAS_MAX; type++ )
+            {
+                if ( BOOL_TRUE != CamEngineMeasTake( &pWorker->slot[type], &pData, &stamp ) )
+                {
+                    continue;
+                }
+
+                switch ( type )
+                {
+                    case CAM_ENGINE_MEAS_HIST:
+                        CamEngineAaaProcessHistogram( pCamEngineCtx, pData->Bins );
+                        break;
+
+                    case CAM_ENGINE_MEAS_MEANLUMA:
+                        CamEngineAaaProcessMeanLuma( pCamEngineCtx, pData->Luma );
+                        break;
+
+                    case CAM_ENGINE_MEAS_AWB:
+                        CamEngineAaaProcessAwb( pCamEngineCtx, &pData->Awb );
+                        break;
+
+                    case CAM_ENGINE_MEAS_AFM:
+                        CamEngineAaaProcessAfm( pCamEngineCtx, &pData->Afm );
+                        break;
+
+                    case CAM_ENGINE_MEAS_VSM:
+                    default:
+                        CamEngineAaaProcessVsm( pCamEngineCtx, &pData->Vsm );
+                        break;
+                }
+
+                CamEngineMeasDone( pWorker, (CamEngineMeasType_t)type, stamp );
+                CamEngineAaaRecord( pCamEngineCtx, (CamEngineMeasType_t)type, pData, stamp );
+            }
+        }
+
+        (void)osMutexUnlock( &pWorker->lock );
+
+        (void)osTimeStampUs( &now );
+        if ( ( now - lastReport ) >= CAM_ENGINE_AAA_REPORT_US )
+        {
+            CamEngineMeasReport( pCamEngineCtx );
+            lastReport = now;
+        }
+    }
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( 0 );
+}
+
 
 
  /******************************************************************************
  * See header file for detailed comment.
  *****************************************************************************/
 
+/******************************************************************************
+ * CamEngineAaaWorkerInit()
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerInit
+(
+    CamEngineContext_t  *pCamEngineCtx
+)
+{
+    CamEngineAaaWorker_t *pWorker;
+    uint32_t i;
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    pWorker = &pCamEngineCtx->aaaWorker;
+    MEMSET( pWorker, 0, sizeof( *pWorker ) );
+
+    for ( i = 0UL; i < CAM_ENGINE_MEAS_MAX; i++ )
+    {
+        pWorker->slot[i].Back   = 0UL;
+        pWorker->slot[i].Middle = 1UL;
+        pWorker->slot[i].Front  = 2UL;
+    }
+
+    // match with values in CamEngineCamerIcDrvMeasureCbRestart() below
+    pWorker->AfCntMax   = 80UL;
+    pWorker->AvsCntWait = 0UL;
+    pWorker->running    = 1UL;
+
+    if ( OSLAYER_OK != osEventInit( &pWorker->event, 1, 0 ) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (creating event failed)\n", __FUNCTION__ );
+        return ( RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osMutexInit( &pWorker->lock ) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (creating mutex failed)\n", __FUNCTION__ );
+        (void)osEventDestroy( &pWorker->event );
+        return ( RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osThreadCreate( &pWorker->thread, CamEngineAaaWorkerThread, pCamEngineCtx ) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (creating worker thread failed)\n", __FUNCTION__ );
+        (void)osMutexDestroy( &pWorker->lock );
+        (void)osEventDestroy( &pWorker->event );
+        return ( RET_FAILURE );
+    }
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaWorkerRelease()
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerRelease
+(
+    CamEngineContext_t  *pCamEngineCtx
+)
+{
+    CamEngineAaaWorker_t *pWorker;
+    RESULT result = RET_SUCCESS;
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    pWorker = &pCamEngineCtx->aaaWorker;
+
+    __atomic_store_n( &pWorker->running, 0UL, __ATOMIC_RELEASE );
+    (void)osEventSignal( &pWorker->event );
+
+    if ( OSLAYER_OK != osThreadWait( &pWorker->thread ) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (waiting for worker thread failed)\n", __FUNCTION__ );
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osThreadClose( &pWorker->thread ) )
+    {
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (closing worker thread failed)\n", __FUNCTION__ );
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    CamEngineMeasReport( pCamEngineCtx );
+    CamEngineAaaRecordClose( pWorker );
+
+    (void)osMutexDestroy( &pWorker->lock );
+    (void)osEventDestroy( &pWorker->event );
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( result );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaWorkerFlush()
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerFlush
+(
+    CamEngineContext_t  *pCamEngineCtx
+)
+{
+    CamEngineAaaWorker_t *pWorker;
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    pWorker = &pCamEngineCtx->aaaWorker;
+
+    /* measurements still queued are dropped, one in progress is waited for */
+    (void)osMutexLock( &pWorker->lock );
+    (void)__atomic_add_fetch( &pWorker->generation, 1UL, __ATOMIC_RELEASE );
+    (void)osMutexUnlock( &pWorker->lock );
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaWorkerRecordStart()
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerRecordStart
+(
+    CamEngineContext_t  *pCamEngineCtx,
+    const char          *pFileName
+)
+{
+    CamEngineAaaWorker_t *pWorker;
+    AaaReplayLogHeader_t header;
+    FILE *pFile;
+    RESULT result;
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    pWorker = &pCamEngineCtx->aaaWorker;
+
+    /* the header has to match the first measurement recorded */
+    (void)osMutexLock( &pWorker->lock );
+
+    if ( NULL != pWorker->pRecord )
+    {
+        (void)osMutexUnlock( &pWorker->lock );
+        return ( RET_BUSY );
+    }
+
+    result = CamEngineAaaRecordHeader( pCamEngineCtx, &header );
+    if ( RET_SUCCESS != result )
+    {
+        (void)osMutexUnlock( &pWorker->lock );
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (can't get 3A setup: %d)\n", __FUNCTION__, result );
+        return ( result );
+    }
+
+    pFile = fopen( pFileName, "wb" );
+    if ( NULL == pFile )
+    {
+        (void)osMutexUnlock( &pWorker->lock );
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (can't create %s)\n", __FUNCTION__, pFileName );
+        return ( RET_FAILURE );
+    }
+
+    if ( 1U != fwrite( &header, sizeof(header), 1U, pFile ) )
+    {
+        (void)fclose( pFile );
+        (void)osMutexUnlock( &pWorker->lock );
+        TRACE( CAM_ENGINE_CB_ERROR, "%s (can't write %s)\n", __FUNCTION__, pFileName );
+        return ( RET_FAILURE );
+    }
+
+    pWorker->pRecord      = pFile;
+    pWorker->RecordLastUs = 0LL;
+    pWorker->Records      = 0UL;
+
+    (void)osMutexUnlock( &pWorker->lock );
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * CamEngineAaaWorkerRecordStop()
+ *****************************************************************************/
+RESULT CamEngineAaaWorkerRecordStop
+(
+    CamEngineContext_t  *pCamEngineCtx
+)
+{
+    CamEngineAaaWorker_t *pWorker;
+    RESULT result = RET_SUCCESS;
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    if ( pCamEngineCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    pWorker = &pCamEngineCtx->aaaWorker;
+
+    (void)osMutexLock( &pWorker->lock );
+    if ( NULL == pWorker->pRecord )
+    {
+        result = RET_WRONG_STATE;
+    }
+    CamEngineAaaRecordClose( pWorker );
+    (void)osMutexUnlock( &pWorker->lock );
+
+    TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( result );
+}
+
+
+
 /******************************************************************************
  * CamEngineCamerIcDrvMeasureCbRestart()
  *****************************************************************************/
@@ -78,6 +974,7 @@ RESULT CamEngineCamerIcDrvMeasureCbRestart
     uint32_t            numFramesToSkip
 )
 {
+    CamEngineAaaWorker_t *pWorker;
     RESULT result = RET_SUCCESS;
 
     TRACE( CAM_ENGINE_CB_INFO, "%s (enter)\n", __FUNCTION__ );
@@ -89,20 +986,30 @@ RESULT CamEngineCamerIcDrvMeasureCbRestart
 
     UNUSED_PARAM(numFramesToSkip);
 
-    // match with static initialization above
-    MeanCnt    = 0UL;
-    ExpCnt     = 0UL;
-    AwbCnt     = 0UL;
-    AfCnt      = 0UL;
-    //AfCntMax   = 120UL;
-    AfCntMax   = 10UL;
-    AvsCnt     = 0UL;
-    AvsCntWait = 25UL;
-    //AvsCntWait = 0UL;
+    pWorker = &pCamEngineCtx->aaaWorker;
+
+    /* keep the worker out while the counters and af are reset */
+    (void)osMutexLock( &pWorker->lock );
+    (void)__atomic_add_fetch( &pWorker->generation, 1UL, __ATOMIC_RELEASE );
+
+    // match with initialization in CamEngineAaaWorkerInit() above
+    pWorker->MeanCnt    = 0UL;
+    pWorker->ExpCnt     = 0UL;
+    pWorker->AfCnt      = 0UL;
+    //pWorker->AfCntMax   = 120UL;
+    pWorker->AfCntMax   = 10UL;
+    pWorker->AvsCnt     = 0UL;
+    pWorker->AvsCntWait = 25UL;
+    //pWorker->AvsCntWait = 0UL;
 
+    /* frame rate may change with the new setup */
+    pWorker->LastFrameUs = 0LL;
+    __atomic_store_n( &pWorker->FramePeriodUs, 0UL, __ATOMIC_RELAXED );
 
     AfMeasureCbRestart(pCamEngineCtx->hAf);
 
+    (void)osMutexUnlock( &pWorker->lock );
+
     TRACE( CAM_ENGINE_CB_INFO, "%s (exit)\n", __FUNCTION__ );
 
     return result;
@@ -255,6 +1162,9 @@ void CamEngineCamerIcDrvJpeCb
 
 /******************************************************************************
  * CamEngineCamerIcDrvMeasureCb()
+ *
+ * Runs in the driver's event context: decimates, copies the measurement and
+ * leaves the processing to the 3A worker of this engine.
  *****************************************************************************/
 void CamEngineCamerIcDrvMeasureCb
 (
@@ -271,71 +1181,34 @@ void CamEngineCamerIcDrvMeasureCb
     if ( (pUserContext != NULL) && ( pParam != NULL) )
     {
         CamEngineContext_t *pCamEngineCtx = ( CamEngineContext_t * )pUserContext;
+        CamEngineAaaWorker_t *pWorker = &pCamEngineCtx->aaaWorker;
+        int64_t stamp = 0LL;
+
+        (void)osTimeStampUs( &stamp );
+        result = RET_SUCCESS;
 
         switch ( evtId )
         {
 
             case CAMERIC_ISP_EVENT_HISTOGRAM:
                 {
-                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_HISTOGRAM (#%d)\n", ExpCnt );
+                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_HISTOGRAM (#%d)\n", pWorker->ExpCnt );
 
-                    if ( ExpCnt == 1UL )
+                    /* one histogram per frame, its distance is the deadline */
+                    if ( pWorker->LastFrameUs > 0LL )
                     {
-                        float fGain = 0.0f;
-                        float fTi = 0.0f;
-
-                        ExpCnt = 0;
-
-                        result = AecClmExecute( pCamEngineCtx->hAec, pParam );
-                        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AecClmExecute: %d", __FUNCTION__, result );
-                        }
-                        DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
-
-                        if ( pCamEngineCtx->mode != CAM_ENGINE_MODE_IMAGE_PROCESSING )
-                        {
-                            /* get current gain */
-                            result = AecGetCurrentGain( pCamEngineCtx->hAec, &fGain );
-                            DCT_ASSERT( result == RET_SUCCESS );
-
-                            result = AecGetCurrentIntegrationTime( pCamEngineCtx->hAec, &fTi );
-                            DCT_ASSERT( result == RET_SUCCESS );
-                        }
-                        else
-                        {
-                            fGain  = pCamEngineCtx->vGain;
-                            fTi = pCamEngineCtx->vItime;
-                        }
-
-                        TRACE( CAM_ENGINE_CB_DEBUG, "%s gain: %f, Ti: %f\n", __FUNCTION__, fGain, fTi );
-
-                        /* calc. denoising pre-filter with current gain */
-                        result = AdpfProcessFrame( pCamEngineCtx->hAdpf, fGain );
-                        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AdpfProcessFrame: %d", __FUNCTION__, result );
-                        }
-                        DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
-
-                        /* calc. defect pixel cluster filter with current gain */
-                        result = AdpccProcessFrame( pCamEngineCtx->hAdpcc, fGain );
-                        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AdpccProcessFrame: %d", __FUNCTION__, result );
-                        }
-                        DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+                        __atomic_store_n( &pWorker->FramePeriodUs, (uint32_t)( stamp - pWorker->LastFrameUs ), __ATOMIC_RELAXED );
+                    }
+                    pWorker->LastFrameUs = stamp;
 
-                        result = AwbSetHistogram( pCamEngineCtx->hAwb, pParam );
-                        if ( result != RET_SUCCESS )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AwbSetHistogram: %d", __FUNCTION__, result );
-                        }
-                        DCT_ASSERT( (result == RET_SUCCESS) );
+                    if ( pWorker->ExpCnt == 1UL )
+                    {
+                        pWorker->ExpCnt = 0;
+                        CamEngineMeasPublish( pWorker, CAM_ENGINE_MEAS_HIST, pParam, stamp );
                     }
                     else
                     {
-                        ++ExpCnt;
+                        ++pWorker->ExpCnt;
                         TRACE( CAM_ENGINE_CB_DEBUG, "%s nc\n", __FUNCTION__ );
                     };
 
@@ -344,23 +1217,16 @@ void CamEngineCamerIcDrvMeasureCb
 
             case CAMERIC_ISP_EVENT_MEANLUMA:
                 {
-                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_MEANLUMA (#%d)\n", MeanCnt );
+                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_MEANLUMA (#%d)\n", pWorker->MeanCnt );
 
-                    if ( MeanCnt == 2UL )
+                    if ( pWorker->MeanCnt == 2UL )
                     {
-                        MeanCnt = 0;
-                        result = AecSemExecute( pCamEngineCtx->hAec, pParam );
-                        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AecSemExecute: %d", __FUNCTION__, result );
-                        }
-                        //zyc for test
-                        //zhy  v1.0x10.1:
-                        //DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
+                        pWorker->MeanCnt = 0;
+                        CamEngineMeasPublish( pWorker, CAM_ENGINE_MEAS_MEANLUMA, pParam, stamp );
                     }
                     else
                     {
-                        ++MeanCnt;
+                        ++pWorker->MeanCnt;
                     }
 
                     break;
@@ -368,127 +1234,34 @@ void CamEngineCamerIcDrvMeasureCb
 
             case CAMERIC_ISP_EVENT_AWB:
                 {
-                    bool_t settled;
-
-                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_AWB (#%d)\n", AwbCnt );
-
-                    result = AecSettled( pCamEngineCtx->hAec, &settled );
-                    if ( (RET_SUCCESS == result) && (BOOL_TRUE == settled) )
-                    {
-                        if ( (AwbCnt == 2UL) )
-                        {
-                            float fIntergrationTime = 0.0f;
-                            float fGain = 0.0f;
-
-                            AwbCnt = 0;
-
-                            if ( pCamEngineCtx->mode != CAM_ENGINE_MODE_IMAGE_PROCESSING )
-                            {
-                                /* get current gain */
-                                result = AecGetCurrentGain( pCamEngineCtx->hAec, &fGain );
-                                DCT_ASSERT( result == RET_SUCCESS );
-
-                                result = AecGetCurrentIntegrationTime( pCamEngineCtx->hAec, &fIntergrationTime );
-                                DCT_ASSERT( result == RET_SUCCESS );
-                            }
-                            else
-                            {
-                                fGain  = pCamEngineCtx->vGain;
-                                fIntergrationTime = pCamEngineCtx->vItime;
-                            }
-
-                            result = AwbProcessFrame( pCamEngineCtx->hAwb, pParam, fGain, fIntergrationTime );
-                            if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                            {
-                                TRACE( CAM_ENGINE_CB_ERROR, "%s AwbProcessFrame: %d", __FUNCTION__, result );
-                            }
-                            DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
-                        }
-                        else
-                        {
-                            ++AwbCnt;
-                        }
-                    }
-
+                    /* decimated by the worker */
+                    CamEngineMeasPublish( pWorker, CAM_ENGINE_MEAS_AWB, pParam, stamp );
                     break;
                 }
 
             case CAMERIC_ISP_EVENT_AFM:
                 {
-                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_AFM (#%d)\n", AfCnt );
+                    TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_AFM (#%d)\n", pWorker->AfCnt );
 
-                    #if 0
-                    if ( (AfCnt > AfCntMax) &&  )
-                    {
-                        AfCnt = 0;
-                        AfCntMax = 0;
-                        result = AfProcessFrame( pCamEngineCtx->hAf, pParam );
-                        if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AfProcessFrame: %d", __FUNCTION__, result );
-                        }
-                        DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
-                    }
-                    else
-                    {
-                        ++AfCnt;
+                    if (pCamEngineCtx->hAf != NULL) {
+                        CamEngineMeasPublish( pWorker, CAM_ENGINE_MEAS_AFM, pParam, stamp );
                     }
-                    #else
-                    bool_t settled;
-                    if (pCamEngineCtx->hAf != NULL) {                    
-                        //result = AecSettled( pCamEngineCtx->hAec, &settled );
-                        //if ( (RET_SUCCESS == result) && (BOOL_TRUE == settled) ) {
-                            result = AfProcessFrame( pCamEngineCtx->hAf, pParam );
-                            if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                            {
-                                TRACE( CAM_ENGINE_CB_ERROR, "%s AfProcessFrame: %d", __FUNCTION__, result );
-                            }
-                            DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
-                        //}
-                    }
-                    #endif
                     break;
                 }
 
             case CAMERIC_ISP_EVENT_VSM:
                 {
-                    CamerIcIspVsmEventData_t *pEventData =
-                        (CamerIcIspVsmEventData_t *) pParam;
-                    CamerIcIspVsmDisplVec_t *pDisplVec = &pEventData->DisplVec;
-                    CamEngineVector_t displVec;
-
-                    MEMSET( &displVec, 0, sizeof(displVec) );
-
-                    displVec.x = pDisplVec->delta_h;
-                    displVec.y = pDisplVec->delta_v;
-
-                    if ( (AvsCnt >= AvsCntWait) && (NULL != pCamEngineCtx->hAvs) )
+                    if ( (pWorker->AvsCnt >= pWorker->AvsCntWait) && (NULL != pCamEngineCtx->hAvs) )
                     {
-                        bool_t running = BOOL_FALSE;
-                        AvsCnt = 0;
-                        AvsCntWait = 0;
-                        TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_VSM (#%d)\n", AvsCnt );
+                        pWorker->AvsCnt = 0;
+                        pWorker->AvsCntWait = 0;
+                        TRACE( CAM_ENGINE_CB_DEBUG, "CAMERIC_ISP_EVENT_VSM (#%d)\n", pWorker->AvsCnt );
 
-                        result = AvsGetStatus( pCamEngineCtx->hAvs, &running, NULL, NULL );
-                        if ( result != RET_SUCCESS )
-                        {
-                            TRACE( CAM_ENGINE_CB_ERROR, "%s AvsGetStatus: %d", __FUNCTION__, result );
-                        }
-                        DCT_ASSERT( result == RET_SUCCESS );
-
-                        if ( running )
-                        {
-                            result = AvsProcessFrame( pCamEngineCtx->hAvs, pEventData->frameId, &displVec );
-                            if ( (result != RET_SUCCESS) && (result != RET_CANCELED) )
-                            {
-                                TRACE( CAM_ENGINE_CB_ERROR, "%s AvsProcessFrame: %d", __FUNCTION__, result );
-                            }
-                            DCT_ASSERT( ((result == RET_SUCCESS) || (result == RET_CANCELED)) );
-                        }
+                        CamEngineMeasPublish( pWorker, CAM_ENGINE_MEAS_VSM, pParam, stamp );
                     }
                     else
                     {
-                        ++AvsCnt;
+                        ++pWorker->AvsCnt;
                     }
                     break;
                 }
@@ -496,6 +1269,7 @@ void CamEngineCamerIcDrvMeasureCb
              default:
                 {
                     TRACE( CAM_ENGINE_CB_ERROR, "unknown Event \n" );
+                    result = RET_FAILURE;
                     break;
                 }
         }
@@ -527,6 +527,37 @@ RESULT HalWriteI2CMem( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_ad
 RESULT HalWriteI2CMem_Rate( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint32_t reg_address, uint8_t reg_addr_size, uint8_t *p_write_buffer, uint32_t byte_size,uint32_t rate);
 
 
+/*****************************************************************************/
+/**
+ * @brief   One write of a batch, see @ref HalWriteI2CBatch.
+ *****************************************************************************/
+typedef struct HalI2cMsg_s
+{
+    uint32_t    reg_address;    //!< Address of first register to write.
+    uint8_t     *p_buffer;      //!< Data, written to reg_address and the following addresses.
+    uint32_t    byte_size;      //!< Amount of data to write.
+} HalI2cMsg_t;
+
+
+/*****************************************************************************/
+/**
+ * @brief   writes a number of register blocks in order, holding the bus for the whole batch
+ * @param   HalHandle       Handle to HAL session as returned by @ref HalOpen.
+ * @param   bus_num         Number of bus which is to be used.
+ * @param   slave_addr      Address of slave to be accessed (supports auto detection of 10bit adresses).
+ * @param   reg_addr_size   Size of register addresses in bytes, valid range: 0..4 bytes.
+ * @param   p_msgs          Writes to do, each one I2C message.
+ * @param   num_msgs        Number of writes.
+ * @return  Result of operation.
+ *
+ * @note    Messages are handed to the driver as plain requests of up to 4
+ *          bytes each, a longer one is split at 4 byte steps of its address.
+ *          More than one data byte to 8 bit registers relies on the address
+ *          auto increment of the slave. Stops at the first failing request.
+ *****************************************************************************/
+RESULT HalWriteI2CBatch( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint8_t reg_addr_size, const HalI2cMsg_t *p_msgs, uint32_t num_msgs );
+
+
 /*****************************************************************************/
 /**
  * @brief   reads a number of data from the memory to a buffer starting a the given address
@@ -1396,6 +1396,72 @@ RESULT HalWriteI2CMem
 }
 
 
+/******************************************************************************
+ * HalWriteI2CBatch()
+ *****************************************************************************/
+RESULT HalWriteI2CBatch
+(
+    HalHandle_t         HalHandle,
+    uint8_t             bus_num,
+    uint16_t            slave_addr,
+    uint8_t             reg_addr_size,
+    const HalI2cMsg_t   *p_msgs,
+    uint32_t            num_msgs
+)
+{
+    RESULT result = RET_SUCCESS;
+    OSLAYER_STATUS osStatus;
+    I2cReturnType i2c_result;
+    uint32_t n;
+
+    if ( (HalHandle == NULL) || (p_msgs == NULL) )
+    {
+        return RET_NULL_POINTER;
+    }
+
+    if ( (bus_num >= NUM_I2C) || (reg_addr_size > 4) )
+    {
+        return RET_INVALID_PARM;
+    }
+
+    // get context from handle & check
+    HalContext_t *pHalCtx = (HalContext_t *)HalHandle;
+    if (pHalCtx->refCount == 0)
+    {
+        return RET_WRONG_STATE;
+    }
+
+    // lock controller once for all messages
+    osStatus = osMutexLock( &pHalCtx->iicMutex[bus_num] );
+    if (OSLAYER_OK != osStatus)
+    {
+        TRACE( HAL_ERROR, "Can't lock I2C bus #%d\n", bus_num );
+        return RET_FAILURE;
+    }
+
+    // access controller
+    for ( n = 0; (n < num_msgs) && (RET_SUCCESS == result); n++ )
+    {
+        i2c_result = i2c_write_ex( &pHalCtx->iicConfig[bus_num], slave_addr, p_msgs[n].reg_address, reg_addr_size, p_msgs[n].p_buffer, p_msgs[n].byte_size );
+        if (I2C_RET_SUCCESS != i2c_result)
+        {
+            TRACE( HAL_ERROR, "Access on I2C bus #%d failed (i2c_result=%d)\n", bus_num, i2c_result );
+            UPDATE_RESULT( result, RET_FAILURE );
+        }
+    }
+
+    // unlock controller again
+    osStatus = osMutexUnlock( &pHalCtx->iicMutex[bus_num] );
+    if (OSLAYER_OK != osStatus)
+    {
+        TRACE( HAL_ERROR, "Can't unlock I2C bus #%d\n", bus_num );
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    return result;
+}
+
+
 /******************************************************************************
  * HalConnectIrq()
  *****************************************************************************/
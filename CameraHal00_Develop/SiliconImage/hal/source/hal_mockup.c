@@ -40,6 +40,8 @@ CREATE_TRACER(HAL_ERROR, "HAL-MOCKUP: ", ERROR, 1);
 #define NUM_I2C                  6
 #define NUM_EXTDEV               3
 
+#define HAL_MEM_INDEX_MIN        32      //!< initial size of the block index
+
 /******************************************************************************
  * local type definitions
  *****************************************************************************/
@@ -64,7 +66,9 @@ typedef struct HalMemMap_s
 } HalMemMap_t;
 
 struct MemBlockInfo_s{
-    List node;
+    ulong_t dev_addr;   //!< address seen by the isp, mmu_addr if iommu mapped, phy_addr otherwise
+    ulong_t vir_addr;   //!< cpu mapping of dev_addr
+    ulong_t size;
 	//old mode
     camera_ionbuf_t data;
 	//new mode
@@ -77,7 +81,12 @@ typedef struct HalMemManager_s
     camera_ionbuf_dev_t *ion_device;
 	//new mode
 	cam_mem_handle_t* cam_mem_handle;
-    List halMemList;
+
+    osMutex                 memMutex;       //!< protects the block index
+    struct MemBlockInfo_s   **blockIndex;   //!< allocated blocks sorted by dev_addr
+    uint32_t                numBlocks;
+    uint32_t                maxBlocks;
+    struct MemBlockInfo_s   *lastBlock;     //!< block of the last lookup, the same buffers are accessed every frame
 }HalMemManager_t;
 
 typedef struct pthread_fake_s {
@@ -215,6 +224,13 @@ HalHandle_t HalOpen( char* dev_filename , HalPara_t *para)
         goto cleanup_2;
     }
 
+    if ( OSLAYER_OK != osMutexInit( &pHalCtx->memMng.memMutex ) )
+    {
+        TRACE( HAL_ERROR, "%s(%d):Can't initialize memMutex\n" ,__FUNCTION__,__LINE__);
+        osMutexDestroy( &pHalCtx->modMutex );
+        goto cleanup_2;
+    }
+
     for ( currI2c = 0; currI2c < NUM_I2C; currI2c++ )
     {
         if ( OSLAYER_OK != osMutexInit( &pHalCtx->iicMutex[currI2c] ) )
@@ -292,9 +308,6 @@ HalHandle_t HalOpen( char* dev_filename , HalPara_t *para)
     } else
 		pHalCtx->memMng.cam_mem_handle->camsys_fd = camsys_fd;
 
-    //init mem list
-    ListInit(&(pHalCtx->memMng.halMemList));
-
     //zyc add
     pHalCtx->drvInfo.camsys_fd = camsys_fd;
 
@@ -395,6 +408,7 @@ cleanup_3: // cleanup some mutexes
         osMutexDestroy( &pHalCtx->iicMutex[--currI2c] );
     }
 
+    osMutexDestroy( &pHalCtx->memMng.memMutex );
     osMutexDestroy( &pHalCtx->modMutex );
 
 cleanup_2: // close board
@@ -481,6 +495,15 @@ RESULT HalClose( HalHandle_t HalHandle )
         osStatus = osMutexDestroy( &pHalCtx->modMutex );
         UPDATE_RESULT( result, (OSLAYER_OK == osStatus) ? RET_SUCCESS : RET_FAILURE );
 
+        // blocks still allocated belong to the caller, only the index goes
+        if (pHalCtx->memMng.numBlocks)
+        {
+            TRACE( HAL_ERROR, "%d memory blocks not freed\n", pHalCtx->memMng.numBlocks );
+        }
+        free( pHalCtx->memMng.blockIndex );
+        osStatus = osMutexDestroy( &pHalCtx->memMng.memMutex );
+        UPDATE_RESULT( result, (OSLAYER_OK == osStatus) ? RET_SUCCESS : RET_FAILURE );
+
         // close board
         // n.a.
         if (pHalCtx->drvInfo.camsys_fd>0)
@@ -1133,6 +1156,124 @@ RESULT HalSetClock( HalHandle_t HalHandle, uint32_t dev_mask, uint32_t frequency
 }
 
 
+/******************************************************************************
+ * halMemIndexSearch()
+ *
+ * Binary search in the block index, returns the position of the last block
+ * starting at or below mem_address, -1 if there is none. Called with the
+ * memMutex held.
+ *****************************************************************************/
+static int32_t halMemIndexSearch( HalMemManager_t *pMemMng, ulong_t mem_address )
+{
+    int32_t lo = 0;
+    int32_t hi = (int32_t)pMemMng->numBlocks - 1;
+    int32_t pos = -1;
+
+    while (lo <= hi)
+    {
+        int32_t mid = (lo + hi) / 2;
+
+        if (pMemMng->blockIndex[mid]->dev_addr <= mem_address)
+        {
+            pos = mid;
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    return pos;
+}
+
+
+/******************************************************************************
+ * halMemIndexAdd()
+ *****************************************************************************/
+static RESULT halMemIndexAdd( HalMemManager_t *pMemMng, struct MemBlockInfo_s *block )
+{
+    RESULT result = RET_SUCCESS;
+    int32_t pos;
+
+    osMutexLock( &pMemMng->memMutex );
+
+    if (pMemMng->numBlocks == pMemMng->maxBlocks)
+    {
+        uint32_t max = (pMemMng->maxBlocks) ? (pMemMng->maxBlocks * 2) : HAL_MEM_INDEX_MIN;
+        struct MemBlockInfo_s **index = realloc( pMemMng->blockIndex, max * sizeof(*index) );
+
+        if (index == NULL)
+        {
+            result = RET_OUTOFMEM;
+        }
+        else
+        {
+            pMemMng->blockIndex = index;
+            pMemMng->maxBlocks = max;
+        }
+    }
+
+    if (result == RET_SUCCESS)
+    {
+        pos = halMemIndexSearch( pMemMng, block->dev_addr ) + 1;
+        memmove( &pMemMng->blockIndex[pos + 1], &pMemMng->blockIndex[pos],
+                    (pMemMng->numBlocks - pos) * sizeof(pMemMng->blockIndex[0]) );
+        pMemMng->blockIndex[pos] = block;
+        pMemMng->numBlocks++;
+    }
+
+    osMutexUnlock( &pMemMng->memMutex );
+
+    return result;
+}
+
+
+/******************************************************************************
+ * halMemIndexFind()
+ *
+ * Returns the block containing mem_address, NULL if there is none. With
+ * remove set the block is taken out of the index.
+ *****************************************************************************/
+static struct MemBlockInfo_s* halMemIndexFind( HalMemManager_t *pMemMng, ulong_t mem_address, bool_t remove )
+{
+    struct MemBlockInfo_s *block;
+    int32_t pos = -1;
+
+    osMutexLock( &pMemMng->memMutex );
+
+    block = pMemMng->lastBlock;
+    if (remove || (block == NULL) || ((mem_address - block->dev_addr) >= block->size))
+    {
+        pos = halMemIndexSearch( pMemMng, mem_address );
+        block = NULL;
+        if ((pos >= 0) && ((mem_address - pMemMng->blockIndex[pos]->dev_addr) < pMemMng->blockIndex[pos]->size))
+        {
+            block = pMemMng->blockIndex[pos];
+        }
+    }
+
+    if (block && remove)
+    {
+        pMemMng->numBlocks--;
+        memmove( &pMemMng->blockIndex[pos], &pMemMng->blockIndex[pos + 1],
+                    (pMemMng->numBlocks - pos) * sizeof(pMemMng->blockIndex[0]) );
+        if (pMemMng->lastBlock == block)
+        {
+            pMemMng->lastBlock = NULL;
+        }
+    }
+    else if (block)
+    {
+        pMemMng->lastBlock = block;
+    }
+
+    osMutexUnlock( &pMemMng->memMutex );
+
+    return block;
+}
+
+
 /******************************************************************************
  * HalAllocMemory()
  *****************************************************************************/
@@ -1166,7 +1307,6 @@ uint32_t HalAllocMemory( HalHandle_t HalHandle, uint32_t byte_size )
     }
     
     memset(block,0,sizeof(struct MemBlockInfo_s));
-    ListInit(&(block->node));
 
 	if (pHalCtx->ops) {
 		block->new_data = pHalCtx->ops->alloc(pHalCtx->memMng.cam_mem_handle,byte_size);
@@ -1183,18 +1323,24 @@ uint32_t HalAllocMemory( HalHandle_t HalHandle, uint32_t byte_size )
 			}
 
 		}
-		//add to tail of list
-		ListAddTail(&pHalCtx->memMng.halMemList, (void*)block);
+		block->dev_addr = (block->new_data->iommu_maped) ? block->new_data->mmu_addr : block->new_data->phy_addr;
+		block->vir_addr = block->new_data->vir_addr;
+		block->size = block->new_data->size;
+
+		if (halMemIndexAdd(&pHalCtx->memMng, block) != RET_SUCCESS) {
+			TRACE( HAL_ERROR, "Can't add block to the index\n" );
+			if (block->new_data->iommu_maped)
+				pHalCtx->ops->iommu_unmap(pHalCtx->memMng.cam_mem_handle,block->new_data);
+			pHalCtx->ops->free(pHalCtx->memMng.cam_mem_handle,block->new_data);
+			goto failed_alloc;
+		}
 		
 		TRACE( HAL_INFO, "malloc 0x%x bytes,iommu mapped %d,mmu_addr 0x%x,vir_addr 0x%x,phy_addr 0x%x,block(%p)\n",
 			byte_size,
 			block->new_data->iommu_maped,block->new_data->mmu_addr,
 			block->new_data->vir_addr,block->new_data->phy_addr,
 			block);
-		if (block->new_data->iommu_maped)
-			return block->new_data->mmu_addr;
-		else
-			return block->new_data->phy_addr;
+		return block->dev_addr;
 	} else {
 	    //alloc from ion
 	    if(pHalCtx->memMng.ion_device->alloc(pHalCtx->memMng.ion_device, byte_size, &block->data) !=0)
@@ -1202,11 +1348,18 @@ uint32_t HalAllocMemory( HalHandle_t HalHandle, uint32_t byte_size )
 	        TRACE( HAL_ERROR, "Can't malloc size(0x%x) from ion\n",byte_size );
 	        goto failed_alloc;
 	    }
-		//add to tail of list
-		ListAddTail(&pHalCtx->memMng.halMemList, (void*)block);
+		block->dev_addr = block->data.phy_addr;
+		block->vir_addr = block->data.vir_addr;
+		block->size = block->data.size;
+
+		if (halMemIndexAdd(&pHalCtx->memMng, block) != RET_SUCCESS) {
+			TRACE( HAL_ERROR, "Can't add block to the index\n" );
+			pHalCtx->memMng.ion_device->free(pHalCtx->memMng.ion_device, &block->data);
+			goto failed_alloc;
+		}
 		
 		TRACE( HAL_INFO, " malloc size(0x%x@0x%x),block(%p) from ion successful\n",byte_size,block->data.phy_addr, block);
-		return block->data.phy_addr;
+		return block->dev_addr;
 	}
 
 failed_alloc:
@@ -1217,39 +1370,6 @@ failed_alloc:
 }
 
 
-static int searchListFun(List *node, void *key){
-    ulong_t mem_phy_addr = (ulong_t)key;
-    struct MemBlockInfo_s* blockInfo_p = (struct MemBlockInfo_s*)node;
-    
-    if((mem_phy_addr - blockInfo_p->data.phy_addr) < blockInfo_p->data.size){
-   //     TRACE(HAL_INFO,"block mem phy addr = 0x%x,find addr = 0x%x",  blockInfo_p->data->phys,mem_phy_addr);
-        return 1;
-    }else{
-        return 0;
-    }
-}
-
-static int searchListFun_for_newdata(List *node, void *key){
-    ulong_t mem_phy_addr = (ulong_t)key;
-    struct MemBlockInfo_s* blockInfo_p = (struct MemBlockInfo_s*)node;
-	
-    if (blockInfo_p->new_data->iommu_maped) {
-		if((mem_phy_addr - blockInfo_p->new_data->mmu_addr) < blockInfo_p->new_data->size){
-			//     TRACE(HAL_INFO,"block mem phy addr = 0x%x,find addr = 0x%x",  blockInfo_p->data->phys,mem_phy_addr);
-			return 1;
-		}else{
-			return 0;
-		}
-    } else {
-
-		 if((mem_phy_addr - blockInfo_p->new_data->phy_addr) < blockInfo_p->new_data->size){
-		//	   TRACE(HAL_INFO,"block mem phy addr = 0x%x,find addr = 0x%x",  blockInfo_p->data->phys,mem_phy_addr);
-			 return 1;
-		 }else{
-			 return 0;
-		 }
-	}
-}
 /******************************************************************************
  * HalFreeMemory()
  *****************************************************************************/
@@ -1275,50 +1395,34 @@ RESULT HalFreeMemory( HalHandle_t HalHandle, ulong_t mem_address )
         return RET_WRONG_HANDLE;
     }
     
-    List* p_item = NULL;
+    //remove the item, nobody finds it while it is freed
+    struct MemBlockInfo_s* p_block = halMemIndexFind(&pHalCtx->memMng, mem_address, BOOL_TRUE);
+    if(!p_block){
+        TRACE( HAL_ERROR, "line:%d,have not find the block,phy addr = 0x%x\n",__LINE__,mem_address );
+        return RET_SUCCESS;
+    }
 
 	if (pHalCtx->ops == NULL) {
-	    //remove the item
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the ion block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return RET_SUCCESS;
+	    if(pHalCtx->memMng.ion_device->free(pHalCtx->memMng.ion_device, &(p_block->data)) != 0){
+	        TRACE( HAL_ERROR, "failed free ion block,phy_addr = 0x%x\n",mem_address );
+	        //free failed, add again
+	        halMemIndexAdd(&pHalCtx->memMng, p_block);
 	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        if(pHalCtx->memMng.ion_device->free(pHalCtx->memMng.ion_device, &(p_block->data)) != 0){
-	            TRACE( HAL_ERROR, "failed free ion block,phy_addr = 0x%x\n",mem_address );
-	        }else{
-	             //something wrong with ListRemoveItem,zyc
-	            //ListRemoveItem(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-	            free(p_block);
-	            TRACE( HAL_NOTICE1, " free ion buffer(phy=0x%x) successful\n",mem_address );
-	        }
+	        free(p_block);
+	        TRACE( HAL_NOTICE1, " free ion buffer(phy=0x%x) successful\n",mem_address );
 	    }
 	}else {
-	    //remove the item
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun_for_newdata, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the  block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return RET_SUCCESS;
+		if (p_block->new_data->iommu_maped) {
+			pHalCtx->ops->iommu_unmap(pHalCtx->memMng.cam_mem_handle,p_block->new_data);
+		}
+	    if( pHalCtx->ops->free(pHalCtx->memMng.cam_mem_handle,p_block->new_data) != 0){
+	        TRACE( HAL_ERROR, "failed free memops block,phy_addr = 0x%x\n",mem_address );
+			//free failed, add again
+			halMemIndexAdd(&pHalCtx->memMng, p_block);
 	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-			if (p_block->new_data->iommu_maped) {
-				pHalCtx->ops->iommu_unmap(pHalCtx->memMng.cam_mem_handle,p_block->new_data);
-			}
-			//should remove before free
-			ListRemoveItem(&pHalCtx->memMng.halMemList, &searchListFun_for_newdata, (void *)mem_address);			
-	        if( pHalCtx->ops->free(pHalCtx->memMng.cam_mem_handle,p_block->new_data) != 0){
-	            TRACE( HAL_ERROR, "failed free memops block,phy_addr = 0x%x\n",mem_address );
-				//free failed, add again
-				ListAddTail(&pHalCtx->memMng.halMemList, (void*)p_block);
-	        }else{
-	             //something wrong with ListRemoveItem,zyc
-	            //ListRemoveItem(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-	            free(p_block);
-	            TRACE( HAL_ERROR, " free memops buffer(phy=0x%x) successful\n",mem_address );
-	        }
+	        free(p_block);
+	        TRACE( HAL_ERROR, " free memops buffer(phy=0x%x) successful\n",mem_address );
 	    }
-
 	}
 
 
@@ -1347,35 +1451,14 @@ RESULT HalReadMemory( HalHandle_t HalHandle, ulong_t mem_address, uint8_t* p_rea
 
 
     //find the item
-    List* p_item = NULL;
-	
-	if (pHalCtx->ops != NULL) {
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun_for_newdata, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the memops block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return -1;
-	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        //compute virt addr
-	        if (p_block->new_data->iommu_maped)
-	        	memcpy( p_read_buffer, (void*)((ulong_t)p_block->new_data->vir_addr+((ulong_t)mem_address - p_block->new_data->mmu_addr)), byte_size );
-			else
-	        	memcpy( p_read_buffer, (void*)((ulong_t)p_block->new_data->vir_addr+((ulong_t)mem_address - p_block->new_data->phy_addr)), byte_size );
-	    }
-	} else {
-			 p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-			 if(!p_item){
-				 TRACE( HAL_ERROR, "line:%d,have not find the ion block,phy addr = 0x%x\n",__LINE__,mem_address );
-				 return -1;
-			 }else{
-				 struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-				 //compute virt addr
-				 memcpy( p_read_buffer, (void*)((ulong_t)p_block->data.vir_addr+((ulong_t)mem_address - p_block->data.phy_addr)), byte_size );
-			 }
-	}
-
+    struct MemBlockInfo_s* p_block = halMemIndexFind(&pHalCtx->memMng, mem_address, BOOL_FALSE);
+    if(!p_block){
+        TRACE( HAL_ERROR, "line:%d,have not find the block,phy addr = 0x%x\n",__LINE__,mem_address );
+        return -1;
+    }
 
-  //  memcpy( p_read_buffer, (void*)mem_address, byte_size );
+    //compute virt addr
+    memcpy( p_read_buffer, (void*)(p_block->vir_addr + (mem_address - p_block->dev_addr)), byte_size );
 
     return RET_SUCCESS;
 }
@@ -1401,33 +1484,13 @@ RESULT HalWriteMemory( HalHandle_t HalHandle, ulong_t mem_address, uint8_t* p_wr
     }
 
     //find the item
-    List* p_item = NULL;
-	
-	if (pHalCtx->ops == NULL) {
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the ion block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return -1;
-	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        memcpy((void*)((ulong_t)p_block->data.vir_addr+ ((ulong_t)mem_address - p_block->data.phy_addr)),p_write_buffer, byte_size );
-	    }
-	} else {
+    struct MemBlockInfo_s* p_block = halMemIndexFind(&pHalCtx->memMng, mem_address, BOOL_FALSE);
+    if(!p_block){
+        TRACE( HAL_ERROR, "line:%d,have not find the block,phy addr = 0x%x\n",__LINE__,mem_address );
+        return -1;
+    }
 
-		p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun_for_newdata, (void *)mem_address);
-		if(!p_item){
-			TRACE( HAL_ERROR, "line:%d,have not find the memops block,phy addr = 0x%x\n",__LINE__,mem_address );
-			return -1;
-		}else{
-			struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-			
-	        if (p_block->new_data->iommu_maped)
-				memcpy((void*)((ulong_t)p_block->new_data->vir_addr+ ((ulong_t)mem_address - p_block->new_data->mmu_addr)),p_write_buffer, byte_size );
-			else
-				memcpy((void*)((ulong_t)p_block->new_data->vir_addr+ ((ulong_t)mem_address - p_block->new_data->phy_addr)),p_write_buffer, byte_size );
-		}
-	}
-//    memcpy( (void*)mem_address, p_write_buffer, byte_size );
+    memcpy( (void*)(p_block->vir_addr + (mem_address - p_block->dev_addr)), p_write_buffer, byte_size );
 
     return RET_SUCCESS;
 }
@@ -1448,37 +1511,26 @@ RESULT HalGetMemoryMapFd( HalHandle_t HalHandle, ulong_t mem_address,int *fd )
         return RET_WRONG_STATE;
     }
     //find the item
-    List* p_item = NULL;
-	
+    struct MemBlockInfo_s* p_block = halMemIndexFind(&pHalCtx->memMng, mem_address, BOOL_FALSE);
+    if(!p_block){
+        TRACE( HAL_ERROR, "line:%d,have not find the block,phy addr = 0x%x\n",__LINE__,mem_address );
+        return -1;
+    }
+
 	if (pHalCtx->ops == NULL) {
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the ion block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return -1;
+	    if(pHalCtx->memMng.ion_device->iommu_enabled){
+	        *fd  =  p_block->data.map_fd;
 	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        if(pHalCtx->memMng.ion_device->iommu_enabled){
-	            *fd  =  p_block->data.map_fd;
-	        }else{
-	            *fd  = mem_address;
-	        }
-	        return RET_SUCCESS;
+	        *fd  = mem_address;
 	    }
 	} else {
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun_for_newdata, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the memops block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return -1;
+	    if(p_block->new_data->iommu_maped){
+	        *fd  =  p_block->new_data->fd;
 	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        if(p_block->new_data->iommu_maped){
-	            *fd  =  p_block->new_data->fd;
-	        }else{
-	            *fd  = mem_address;
-	        }
-	        return RET_SUCCESS;
+	        *fd  = mem_address;
 	    }
 	}
+	return RET_SUCCESS;
 }
 
 /******************************************************************************
@@ -1552,35 +1604,15 @@ RESULT HalMapMemory( HalHandle_t HalHandle, ulong_t mem_address, uint32_t byte_s
     // return mapped buffer
     *pp_mapped_buf = p_mapped_buffer;
 #else
-    //find the item
-    List* p_item = NULL;
-	if (pHalCtx->ops == NULL) {
+    // the blocks stay mapped from alloc to free, so this is the mapping of
+    // the block, no copy
+    struct MemBlockInfo_s* p_block = halMemIndexFind(&pHalCtx->memMng, mem_address, BOOL_FALSE);
+    if(!p_block){
+        TRACE( HAL_ERROR, "line:%d,have not find the block,phy addr = 0x%x\n",__LINE__,mem_address );
+        return -1;
+    }
 
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the ion block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return -1;
-	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        //compute virt addr
-	        p_mapped_buffer =  (void*)((ulong_t)p_block->data.vir_addr+((ulong_t)mem_address - p_block->data.phy_addr));
-	    }
-	    *pp_mapped_buf = p_mapped_buffer;
-	} else {
-	    p_item = ListSearch(&pHalCtx->memMng.halMemList, &searchListFun_for_newdata, (void *)mem_address);
-	    if(!p_item){
-	        TRACE( HAL_ERROR, "line:%d,have not find the memops block,phy addr = 0x%x\n",__LINE__,mem_address );
-	        return -1;
-	    }else{
-	        struct MemBlockInfo_s* p_block = (struct MemBlockInfo_s*)p_item;
-	        //compute virt addr
-	        if (p_block->new_data->iommu_maped) {
-				p_mapped_buffer =  (void*)((ulong_t)p_block->new_data->vir_addr+((ulong_t)mem_address - p_block->new_data->mmu_addr));
-			} else
-	        	p_mapped_buffer =  (void*)((ulong_t)p_block->new_data->vir_addr+((ulong_t)mem_address - p_block->new_data->phy_addr));
-	    }
-	    *pp_mapped_buf = p_mapped_buffer;
-	}
+    *pp_mapped_buf = (void*)(p_block->vir_addr + (mem_address - p_block->dev_addr));
 
 #endif
     return result;
@@ -1927,6 +1959,123 @@ RESULT HalWriteI2CMem_Rate
 }
 
 
+/******************************************************************************
+ * HalI2cWriteVal()
+ *
+ * One CAMSYS_I2CWR of up to 4 data bytes, the way HalWriteI2CMem() does it.
+ * Bus must be locked.
+ *****************************************************************************/
+static RESULT HalI2cWriteVal
+(
+    HalContext_t    *pHalCtx,
+    uint8_t         bus_num,
+    uint16_t        slave_addr,
+    uint32_t        reg_address,
+    uint8_t         reg_addr_size,
+    const uint8_t   *p_write_buffer,
+    uint32_t        byte_size
+)
+{
+    camsys_i2c_info_t i2cinfo;
+    uint32_t i;
+
+    memset( &i2cinfo, 0, sizeof(i2cinfo) );
+    i2cinfo.bus_num     = bus_num;
+    i2cinfo.slave_addr  = slave_addr;
+    i2cinfo.reg_addr    = reg_address;
+    i2cinfo.reg_size    = reg_addr_size;
+    i2cinfo.speed       = 300000;
+    i2cinfo.val_size    = byte_size;
+    for (i=0; i<byte_size; i++)
+    {
+        i2cinfo.val = (i2cinfo.val << 8) | p_write_buffer[i];
+    }
+
+    if ( ioctl( pHalCtx->drvInfo.camsys_fd, CAMSYS_I2CWR, &i2cinfo ) < 0 )
+    {
+        TRACE( HAL_ERROR, "I2c bus #%d write failed\n", bus_num );
+        return RET_FAILURE;
+    }
+
+    return RET_SUCCESS;
+}
+
+
+/******************************************************************************
+ * HalWriteI2CBatch()
+ *****************************************************************************/
+RESULT HalWriteI2CBatch
+(
+    HalHandle_t         HalHandle,
+    uint8_t             bus_num,
+    uint16_t            slave_addr,
+    uint8_t             reg_addr_size,
+    const HalI2cMsg_t   *p_msgs,
+    uint32_t            num_msgs
+)
+{
+    RESULT result = RET_SUCCESS;
+    OSLAYER_STATUS osStatus;
+    uint32_t n, offs, len;
+
+    if ( (HalHandle == NULL) || (p_msgs == NULL) )
+    {
+        TRACE( HAL_ERROR, "%s(%d): HalHandle or p_msgs is NULL",__FUNCTION__,__LINE__ );
+        return RET_NULL_POINTER;
+    }
+
+    if ( (bus_num >= NUM_I2C) || (reg_addr_size > 4) )
+    {
+        TRACE( HAL_ERROR ,"%s(%d): bus_num(%d) or reg_addr_size(%d) is invalidate",__FUNCTION__,__LINE__,
+            bus_num, reg_addr_size);
+        return RET_INVALID_PARM;
+    }
+
+    // get context from handle & check
+    HalContext_t *pHalCtx = (HalContext_t *)HalHandle;
+    if (pHalCtx->refCount == 0)
+    {
+        TRACE( HAL_ERROR, "%s(%d): refCount is invaldate(0)\n",__FUNCTION__,__LINE__);
+        return RET_WRONG_STATE;
+    }
+
+    if (pHalCtx->drvInfo.camsys_fd<=0)
+    {
+        TRACE( HAL_ERROR, "%s(%d): pHalCtx is error for haven't camsys device!\n",__FUNCTION__,__LINE__);
+        return RET_WRONG_HANDLE;
+    }
+
+    // lock controller
+    osStatus = osMutexLock( &pHalCtx->iicMutex[bus_num] );
+    if (OSLAYER_OK != osStatus)
+    {
+        TRACE( HAL_ERROR, "Can't lock I2C bus #%d\n", bus_num );
+        return RET_FAILURE;
+    }
+
+    // one request per (up to) 4 bytes, the only write the camsys driver takes
+    for ( n = 0; (n < num_msgs) && (result == RET_SUCCESS); n++ )
+    {
+        for ( offs = 0; (offs < p_msgs[n].byte_size) && (result == RET_SUCCESS); offs += len )
+        {
+            len = ( (p_msgs[n].byte_size - offs) > 4U ) ? 4U : (p_msgs[n].byte_size - offs);
+            result = HalI2cWriteVal( pHalCtx, bus_num, slave_addr, p_msgs[n].reg_address + offs,
+                                        reg_addr_size, &p_msgs[n].p_buffer[offs], len );
+        }
+    }
+
+    // unlock controller again
+    osStatus = osMutexUnlock( &pHalCtx->iicMutex[bus_num] );
+    if (OSLAYER_OK != osStatus)
+    {
+        TRACE( HAL_ERROR, "Can't unlock I2C bus #%d\n", bus_num );
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    return result;
+}
+
+
 /******************************************************************************
  * HalConnectIrq()
  *****************************************************************************/
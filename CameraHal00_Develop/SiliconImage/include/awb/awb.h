@@ -726,6 +726,27 @@ RESULT AwbCalcWBgainbyCT
 );
 
 
+
+/*****************************************************************************/
+/**
+ * @brief   The function returns the lsc matrix last programmed into CamerIc
+ *
+ * @param   handle      AWB instance handle
+ * @param   pLscMatrix  pointer to return the damped lsc matrix
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ * @retval  RET_INVALID_PARM
+ *
+ *****************************************************************************/
+RESULT AwbGetLscMatrix
+(
+    AwbHandle_t     handle,
+    CamLscMatrix_t  *pLscMatrix
+);
+
+
 #ifdef __cplusplus
 }
 #endif
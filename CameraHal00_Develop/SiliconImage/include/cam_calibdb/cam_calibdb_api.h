@@ -45,6 +45,27 @@ typedef struct CamCalibDbContext_s *CamCalibDbHandle_t;
 
 
 
+/*******************************************************************************
+ * @brief   Calibration data of one resolution, resolved in one call.
+ *
+ * @note    The pointers refer into the CamCalibDb instance and stay valid
+ *          until it is cleared or released, so modules can resolve them on
+ *          (re-)configuration and keep them.
+ *
+ *****************************************************************************/
+typedef struct CamCalibDbResProfiles_s
+{
+    CamResolution_t         *pResolution;   /**< resolution */
+    int32_t                 ResIdx;         /**< index of the resolution in the database */
+    CamCalibAwbGlobal_t     *pAwbGlobal;    /**< AWB global data, NULL if not in the database */
+    CamBlsProfile_t         *pBlsProfile;   /**< BLS profile, NULL if not in the database */
+    CamCacProfile_t         *pCacProfile;   /**< CAC profile, NULL if not in the database */
+    CamDpfProfile_t         *pDpfProfile;   /**< DPF profile, NULL if not in the database */
+    CamDpccProfile_t        *pDpccProfile;  /**< DPCC profile, NULL if not in the database */
+} CamCalibDbResProfiles_t;
+
+
+
 /*****************************************************************************/
 /**
  * @brief   The function creates and initializes a CamCalibDb instance.
@@ -310,6 +331,33 @@ RESULT CamCalibDbGetResolutionIdxByName
 
 
 
+/*****************************************************************************/
+/**
+ * @brief   This function returns the resolution of the given size together
+ *          with all calibration profiles linked to it
+ *
+ * @param   hCamCalibDb         Handle to the CamCalibDb instance.
+ * @param   width               width of resolution
+ * @param   height              height of resolution
+ * @param   pProfiles           reference to the profiles
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS         function succeed
+ * @retval  RET_WRONG_HANDLE    invalid instance handle
+ * @retval  RET_INVALID_PARM    invalid profiles reference
+ * @retval  RET_NOTSUPP         resolution not in the database
+ *
+ *****************************************************************************/
+RESULT CamCalibDbGetResProfilesByWidthHeight
+(
+    CamCalibDbHandle_t          hCamCalibDb,
+    const uint16_t              width,
+    const uint16_t              height,
+    CamCalibDbResProfiles_t     *pProfiles
+);
+
+
+
 /*****************************************************************************/
 /**
  * @brief   This function adds a global AWB profile in the CamCalibDb instance.
@@ -889,6 +937,87 @@ RESULT CamCalibDbGetOTPInfo
 	uint32_t *pOTPInfo
 );
 
+
+/*****************************************************************************/
+/**
+ * @brief   This function computes the FNV-1a hash of a calibration xml file.
+ *          The hash is stored in a binary image of the database and decides
+ *          whether the image still matches its source.
+ *
+ * @param   pFileName           Path of the xml file.
+ * @param   pHash               Returns the 64 bit hash.
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS         function succeed
+ * @retval  RET_INVALID_PARM    invalid file name
+ * @retval  RET_NULL_POINTER    null pointer
+ * @retval  RET_FAILURE         file could not be read
+ *
+ *****************************************************************************/
+RESULT CamCalibDbHashFile
+(
+    const char          *pFileName,
+    uint64_t            *pHash
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   This function writes the contents of the CamCalibDb instance to
+ *          a binary image, tagged with the hash of the xml it was parsed
+ *          from. The image is only valid on a build with the same structure
+ *          layout, which is recorded in the file as well.
+ *
+ * @param   hCamCalibDb         Handle to the CamCalibDb instance.
+ * @param   pFileName           Path of the binary image.
+ * @param   srcHash             Hash of the source xml (@ref CamCalibDbHashFile).
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS         function succeed
+ * @retval  RET_WRONG_HANDLE    invalid instance handle
+ * @retval  RET_INVALID_PARM    invalid file name
+ * @retval  RET_OUTOFMEM        not enough memory available
+ * @retval  RET_FAILURE         file could not be written
+ *
+ *****************************************************************************/
+RESULT CamCalibDbSaveBinary
+(
+    CamCalibDbHandle_t  hCamCalibDb,
+    const char          *pFileName,
+    uint64_t            srcHash
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   This function fills an empty CamCalibDb instance from a binary
+ *          image written by @ref CamCalibDbSaveBinary. The image is mapped
+ *          and checked (magic, version, structure layout, source hash and
+ *          checksum) before anything is added. On failure the instance is
+ *          cleared and the caller is expected to parse the xml instead.
+ *
+ * @param   hCamCalibDb         Handle to the CamCalibDb instance.
+ * @param   pFileName           Path of the binary image.
+ * @param   srcHash             Hash of the current source xml.
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS         function succeed
+ * @retval  RET_WRONG_HANDLE    invalid instance handle
+ * @retval  RET_INVALID_PARM    invalid file name
+ * @retval  RET_NOTAVAILABLE    no image, or the image is stale
+ * @retval  RET_WRONG_CONFIG    image is corrupt or from another build
+ * @retval  RET_OUTOFMEM        not enough memory available
+ *
+ *****************************************************************************/
+RESULT CamCalibDbLoadBinary
+(
+    CamCalibDbHandle_t  hCamCalibDb,
+    const char          *pFileName,
+    uint64_t            srcHash
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -124,6 +124,10 @@ extern const IsiRegDescription_t Sensor_g_4208x3120P30_fourlane_fpschg[];
 extern const IsiRegDescription_t Sensor_g_4208x3120P20_fourlane_fpschg[];
 extern const IsiRegDescription_t Sensor_g_4208x3120P10_fourlane_fpschg[];
 
+extern const IsiRegDescription_t Sensor_g_aRegShadow[];
+extern const IsiRegDescription_t Sensor_g_aGroupHoldBegin[];
+extern const IsiRegDescription_t Sensor_g_aGroupHoldEnd[];
+
 const IsiSensorCaps_t Sensor_g_IsiSensorDefaultConfig;
 
 
@@ -251,6 +255,7 @@ static RESULT Sensor_IsiCreateSensorIss
     pSensorCtx->IsiCtx.I2cBusNum              = pConfig->I2cBusNum;
     pSensorCtx->IsiCtx.SlaveAddress           = ( pConfig->SlaveAddr == 0 ) ? Sensor_SLAVE_ADDR : pConfig->SlaveAddr;
     pSensorCtx->IsiCtx.NrOfAddressBytes       = 2U;
+    pSensorCtx->IsiCtx.I2cBurstLen            = ISI_I2C_NR_DAT_BYTES_4;  /* 8 bit tables, auto increment; one camsys request per merged write */
 
     pSensorCtx->IsiCtx.I2cAfBusNum            = pConfig->I2cAfBusNum;
     pSensorCtx->IsiCtx.SlaveAfAddress         = ( pConfig->SlaveAfAddr == 0 ) ? Sensor_SLAVE_AF_ADDR : pConfig->SlaveAfAddr;
@@ -258,6 +263,14 @@ static RESULT Sensor_IsiCreateSensorIss
 
     pSensorCtx->IsiCtx.pSensor                = pConfig->pSensor;
 
+    result = IsiRegShadowCreate( pSensorCtx, Sensor_g_aRegShadow, Sensor_g_aGroupHoldBegin, Sensor_g_aGroupHoldEnd );
+    if ( result != RET_SUCCESS )
+    {
+        (void)HalDelRef( pConfig->HalHandle );
+        free ( pSensorCtx );
+        return ( result );
+    }
+
     pSensorCtx->Configured             = BOOL_FALSE;
     pSensorCtx->Streaming              = BOOL_FALSE;
     pSensorCtx->TestPattern            = BOOL_FALSE;
@@ -326,6 +339,8 @@ static RESULT Sensor_IsiReleaseSensorIss
 
     (void)HalDelRef( pSensorCtx->IsiCtx.HalHandle );
 
+    (void)IsiRegShadowRelease( pSensorCtx );
+
     MEMSET( pSensorCtx, 0, sizeof( Sensor_Context_t ) );
     free ( pSensorCtx );
 
@@ -1971,6 +1986,9 @@ static RESULT Sensor_IsiSensorSetPowerIss
     pSensorCtx->Configured = BOOL_FALSE;
     pSensorCtx->Streaming  = BOOL_FALSE;
 
+    /* power and reset lose all register values */
+    (void)IsiRegShadowInvalidate( pSensorCtx );
+
     result = HalSetPower( pSensorCtx->IsiCtx.HalHandle, pSensorCtx->IsiCtx.HalDevID, false );
     RETURN_RESULT_IF_DIFFERENT( RET_SUCCESS, result );
 
@@ -2767,14 +2785,15 @@ RESULT Sensor_IsiExposureControlIss
 
     TRACE( Sensor_DEBUG, "%s: g=%f, Ti=%f\n", __FUNCTION__, NewGain, NewIntegrationTime );
 
-  	result = Sensor_IsiRegWriteIss( pSensorCtx, 0x0104,1);
+    /* the changed registers go out in one grouped parameter hold (0x0104) */
+    result = IsiRegShadowBegin( pSensorCtx );
     RETURN_RESULT_IF_DIFFERENT( RET_SUCCESS, result );
 
     result = Sensor_IsiSetIntegrationTimeIss( handle, NewIntegrationTime, pSetIntegrationTime, pNumberOfFramesToSkip);
     result = Sensor_IsiSetGainIss( handle, NewGain, pSetGain);
 
-	result = Sensor_IsiRegWriteIss( pSensorCtx, 0x0104,0);
-    RETURN_RESULT_IF_DIFFERENT( RET_SUCCESS, result );  
+    UPDATE_RESULT( result, IsiRegShadowEnd( pSensorCtx ) );
+    RETURN_RESULT_IF_DIFFERENT( RET_SUCCESS, result );
     TRACE( Sensor_DEBUG, "%s: set: g=%f, Ti=%f, skip=%d\n", __FUNCTION__, *pSetGain, *pSetIntegrationTime, *pNumberOfFramesToSkip ); 
 
     return ( result );
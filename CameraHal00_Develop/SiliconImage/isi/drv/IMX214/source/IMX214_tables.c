@@ -1009,4 +1009,25 @@ const IsiRegDescription_t Sensor_g_onelane_resolution_2104_1560[] =
     {0x0000 ,0x00,"eTableEnd",eTableEnd}
 };
 
+// registers IsiRegShadowCreate() keeps a copy of: the exposure registers
+// written every frame
+const IsiRegDescription_t Sensor_g_aRegShadow[] =
+{
+	{0x0202,0x00,"coarse integration time H",eReadWriteNoDef},
+	{0x0203,0x00,"coarse integration time L",eReadWriteNoDef},
+	{0x0204,0x00,"analog gain H",eReadWriteNoDef},
+	{0x0205,0x00,"analog gain L",eReadWriteNoDef},
+	{0x0000,0x00,"eTableEnd",eTableEnd}
+};
 
+const IsiRegDescription_t Sensor_g_aGroupHoldBegin[] =
+{
+	{0x0104,0x01,"grouped parameter hold",eWriteOnly},
+	{0x0000,0x00,"eTableEnd",eTableEnd}
+};
+
+const IsiRegDescription_t Sensor_g_aGroupHoldEnd[] =
+{
+	{0x0104,0x00,"grouped parameter release",eWriteOnly},
+	{0x0000,0x00,"eTableEnd",eTableEnd}
+};
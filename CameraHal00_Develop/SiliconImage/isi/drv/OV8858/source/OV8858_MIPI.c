@@ -132,6 +132,10 @@ extern const IsiRegDescription_t OV8858_g_aRegDescription_fourlane_R2A[];
 extern const IsiRegDescription_t OV8858_g_3264x2448_fourlane_R2A[];
 extern const IsiRegDescription_t OV8858_g_1632x1224_fourlane_R2A[];
 
+extern const IsiRegDescription_t OV8858_g_aRegShadow[];
+extern const IsiRegDescription_t OV8858_g_aGroupHoldBegin[];
+extern const IsiRegDescription_t OV8858_g_aGroupHoldEnd[];
+
 
 
 
@@ -1048,6 +1052,7 @@ static RESULT OV8858_IsiCreateSensorIss
     pOV8858Ctx->IsiCtx.I2cBusNum              = pConfig->I2cBusNum;
     pOV8858Ctx->IsiCtx.SlaveAddress           = ( pConfig->SlaveAddr == 0 ) ? OV8858_SLAVE_ADDR : pConfig->SlaveAddr;
     pOV8858Ctx->IsiCtx.NrOfAddressBytes       = 2U;
+    pOV8858Ctx->IsiCtx.I2cBurstLen            = ISI_I2C_NR_DAT_BYTES_4;  /* 8 bit tables, auto increment; one camsys request per merged write */
 
     pOV8858Ctx->IsiCtx.I2cAfBusNum            = pConfig->I2cAfBusNum;
     pOV8858Ctx->IsiCtx.SlaveAfAddress         = ( pConfig->SlaveAfAddr == 0 ) ? OV8858_SLAVE_AF_ADDR : pConfig->SlaveAfAddr;
@@ -1055,6 +1060,14 @@ static RESULT OV8858_IsiCreateSensorIss
 
     pOV8858Ctx->IsiCtx.pSensor                = pConfig->pSensor;
 
+    result = IsiRegShadowCreate( pOV8858Ctx, OV8858_g_aRegShadow, OV8858_g_aGroupHoldBegin, OV8858_g_aGroupHoldEnd );
+    if ( result != RET_SUCCESS )
+    {
+        (void)HalDelRef( pConfig->HalHandle );
+        free ( pOV8858Ctx );
+        return ( result );
+    }
+
     pOV8858Ctx->Configured             = BOOL_FALSE;
     pOV8858Ctx->Streaming              = BOOL_FALSE;
     pOV8858Ctx->TestPattern            = BOOL_FALSE;
@@ -1124,6 +1137,8 @@ static RESULT OV8858_IsiReleaseSensorIss
 
     (void)HalDelRef( pOV8858Ctx->IsiCtx.HalHandle );
 
+    (void)IsiRegShadowRelease( pOV8858Ctx );
+
     MEMSET( pOV8858Ctx, 0, sizeof( OV8858_Context_t ) );
     free ( pOV8858Ctx );
 
@@ -2654,6 +2669,9 @@ static RESULT OV8858_IsiSensorSetPowerIss
     pOV8858Ctx->Configured = BOOL_FALSE;
     pOV8858Ctx->Streaming  = BOOL_FALSE;
 
+    /* power and reset lose all register values */
+    (void)IsiRegShadowInvalidate( pOV8858Ctx );
+
     TRACE( OV8858_DEBUG, "%s power off \n", __FUNCTION__);
     result = HalSetPower( pOV8858Ctx->IsiCtx.HalHandle, pOV8858Ctx->IsiCtx.HalDevID, false );
     RETURN_RESULT_IF_DIFFERENT( RET_SUCCESS, result );
@@ -3505,9 +3523,15 @@ RESULT OV8858_IsiExposureControlIss
     TRACE( OV8858_INFO, "%s: g=%f, Ti=%f\n", __FUNCTION__, NewGain, NewIntegrationTime );
 
 
+    /* exposure and gain take effect together, in one group hold */
+    result = IsiRegShadowBegin( pOV8858Ctx );
+    RETURN_RESULT_IF_DIFFERENT( RET_SUCCESS, result );
+
     result = OV8858_IsiSetIntegrationTimeIss( handle, NewIntegrationTime, pSetIntegrationTime, pNumberOfFramesToSkip );
     result = OV8858_IsiSetGainIss( handle, NewGain, pSetGain );
 
+    UPDATE_RESULT( result, IsiRegShadowEnd( pOV8858Ctx ) );
+
     TRACE( OV8858_INFO, "%s: set: g=%f, Ti=%f, skip=%d\n", __FUNCTION__, *pSetGain, *pSetIntegrationTime, *pNumberOfFramesToSkip );
     TRACE( OV8858_INFO, "%s: (exit)\n", __FUNCTION__);
 
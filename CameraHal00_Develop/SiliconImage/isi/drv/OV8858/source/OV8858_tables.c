@@ -2366,4 +2366,34 @@ const IsiRegDescription_t OV8858_g_3264x2448_twolane_R2A[] =
 	{0x0000,0x00,"eTableEnd",eTableEnd}
 };
 
+// registers IsiRegShadowCreate() keeps a copy of: the pll setup read back
+// to calculate the clocks and the exposure registers written every frame
+const IsiRegDescription_t OV8858_g_aRegShadow[] =
+{
+	{0x030b,0x00,"pll2 prediv",eReadWriteNoDef},
+	{0x030c,0x00,"pll2 mult H",eReadWriteNoDef},
+	{0x030d,0x00,"pll2 mult L",eReadWriteNoDef},
+	{0x030e,0x00,"pll2 divs",eReadWriteNoDef},
+	{0x030f,0x00,"pll2 divsp",eReadWriteNoDef},
+	{0x0312,0x00,"pll2 divdac",eReadWriteNoDef},
+	{0x3106,0x00,"sclk div",eReadWriteNoDef},
+	{0x3500,0x00,"exposure H",eReadWriteNoDef},
+	{0x3501,0x00,"exposure M",eReadWriteNoDef},
+	{0x3502,0x00,"exposure L",eReadWriteNoDef},
+	{0x3508,0x00,"gain H",eReadWriteNoDef},
+	{0x3509,0x00,"gain L",eReadWriteNoDef},
+	{0x0000,0x00,"eTableEnd",eTableEnd}
+};
+
+const IsiRegDescription_t OV8858_g_aGroupHoldBegin[] =
+{
+	{0x3208,0x00,"group 0 hold start",eWriteOnly},
+	{0x0000,0x00,"eTableEnd",eTableEnd}
+};
 
+const IsiRegDescription_t OV8858_g_aGroupHoldEnd[] =
+{
+	{0x3208,0x10,"group 0 hold end",eWriteOnly},
+	{0x3208,0xa0,"group 0 quick launch",eWriteOnly},
+	{0x0000,0x00,"eTableEnd",eTableEnd}
+};
@@ -46,6 +46,9 @@ extern "C"
 #define ISI_I2C_NR_DAT_BYTES_2  (2)                     // sensor has some 16-bit registers
 #define ISI_I2C_NR_DAT_BYTES_4  (4)                     // sensor has some 32-bit registers
 
+#define ISI_I2C_BATCH_MSGS      (64)                    // writes per HalWriteI2CBatch() of IsiRegDefaultsApply()
+#define ISI_I2C_BURST_MAX       (32)                    // max. data bytes of one merged write
+
 #define SUPPORT_MIPI_ONE_LANE  0x1
 #define SUPPORT_MIPI_TWO_LANE  0x2
 #define SUPPORT_MIPI_FOUR_LANE 0x4
@@ -55,6 +58,30 @@ extern "C"
 * TYPEDEFS
 ******************************************************************************/
 
+/* register shadow of a sensor, see IsiRegShadowCreate() */
+typedef struct IsiRegShadow_s IsiRegShadow_t;
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowStats_t
+ *
+ * @brief   counters of a register shadow
+ *
+ */
+/*****************************************************************************/
+typedef struct IsiRegShadowStats_s
+{
+    uint32_t       Writes;              /**< writes to shadowed registers */
+    uint32_t       WritesSkipped;       /**< of these, skipped as the value didn't change */
+    uint32_t       Reads;               /**< reads of shadowed registers */
+    uint32_t       ReadsCached;         /**< of these, answered from the shadow */
+    uint32_t       Transactions;        /**< group hold transactions sent */
+} IsiRegShadowStats_t;
+
+
+
 /*****************************************************************************/
 /**
  *          IsiSensorContext_t
@@ -77,6 +104,13 @@ typedef struct IsiSensorContext_s
     uint8_t        NrOfAfAddressBytes;  /**< Number of Address-Bytes */
 
     IsiSensor_t    *pSensor;            /**< points to the sensor device */
+
+    uint8_t        I2cBurstLen;         /**< 0: IsiRegDefaultsApply() writes register by register through
+                                             the driver; else tables go out in batches and writes to
+                                             consecutive addresses are merged into one of up to this
+                                             many data bytes (1 only batches, > 1 needs address auto
+                                             increment, max. ISI_I2C_BURST_MAX) */
+    IsiRegShadow_t *pRegShadow;         /**< register shadow, NULL if none (see IsiRegShadowCreate()) */
 } IsiSensorContext_t;
 
 
@@ -124,6 +158,10 @@ uint8_t IsiGetNrDatBytesIss
  * @brief   This function applies the default values of the registers specified
  *          in the given table. Writes to all registers that have been declared
  *          as writable and do have a default value (appropriate enum in table).
+ *          With IsiSensorContext_t::I2cBurstLen set the writes bypass the
+ *          driver's register write function and go out in batches, split at
+ *          eDelay entries; the data size of a register then comes from its
+ *          flags in the given table.
  *
  * @param   handle      Handle to image sensor device
  * @param   pRegDesc    Register description table
@@ -227,6 +265,156 @@ RESULT IsiI2cReadSensorRegister
 
 
 
+/*****************************************************************************/
+/**
+ *          IsiRegShadowCreate
+ *
+ * @brief   Creates a shadow of the sensor registers listed in the given
+ *          table. IsiI2cWriteSensorRegister() then skips writes that don't
+ *          change a known, non-volatile register and between
+ *          IsiRegShadowBegin() and IsiRegShadowEnd() only stages them.
+ *          IsiI2cReadSensorRegister() answers reads of known, non-volatile
+ *          registers from the shadow. Only accesses with the address and
+ *          size of a table entry hit the shadow, others go to the sensor and
+ *          make overlapped entries unknown.
+ *
+ *          All registers start unknown. IsiRegDefaultsApply() forgets the
+ *          shadow and then records what it writes, a software reset has to
+ *          come first in a table therefore.
+ *
+ * @param   handle      Handle to image sensor device
+ * @param   pRegDesc    registers to shadow (readable and/or writable ones,
+ *                      default values are not used)
+ * @param   pHoldBegin  writes that start a group hold, NULL if none
+ * @param   pHoldEnd    writes that end and launch a group hold, NULL if none
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ * @retval  RET_NULL_POINTER
+ * @retval  RET_WRONG_STATE     shadow already exists
+ * @retval  RET_OUTOFMEM
+ *
+ *****************************************************************************/
+RESULT IsiRegShadowCreate
+(
+    IsiSensorHandle_t         handle,
+    const IsiRegDescription_t *pRegDesc,
+    const IsiRegDescription_t *pHoldBegin,
+    const IsiRegDescription_t *pHoldEnd
+);
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowRelease
+ *
+ * @brief   Releases the register shadow, staged writes are dropped.
+ *
+ * @param   handle      Handle to image sensor device
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ *
+ *****************************************************************************/
+RESULT IsiRegShadowRelease
+(
+    IsiSensorHandle_t         handle
+);
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowInvalidate
+ *
+ * @brief   Marks all shadowed registers unknown and drops staged writes; to
+ *          be called whenever the sensor is reset or powered.
+ *
+ * @param   handle      Handle to image sensor device
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ *
+ *****************************************************************************/
+RESULT IsiRegShadowInvalidate
+(
+    IsiSensorHandle_t         handle
+);
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowBegin
+ *
+ * @brief   Starts a transaction, writes to shadowed registers are staged
+ *          until the matching IsiRegShadowEnd(). Transactions nest. Writes
+ *          to other registers still go to the sensor immediately.
+ *
+ * @param   handle      Handle to image sensor device
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ *
+ *****************************************************************************/
+RESULT IsiRegShadowBegin
+(
+    IsiSensorHandle_t         handle
+);
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowEnd
+ *
+ * @brief   Ends a transaction. Ending the outermost one sends the staged
+ *          writes in address order, framed by the group hold writes, as one
+ *          batch; nothing is sent if no register changed.
+ *
+ * @param   handle      Handle to image sensor device
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ * @retval  RET_WRONG_STATE     no transaction open
+ *
+ *****************************************************************************/
+RESULT IsiRegShadowEnd
+(
+    IsiSensorHandle_t         handle
+);
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowGetStats
+ *
+ * @brief   Returns the counters of the register shadow.
+ *
+ * @param   handle      Handle to image sensor device
+ * @param   pStats      counters
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_WRONG_HANDLE
+ * @retval  RET_NULL_POINTER
+ *
+ *****************************************************************************/
+RESULT IsiRegShadowGetStats
+(
+    IsiSensorHandle_t         handle,
+    IsiRegShadowStats_t       *pStats
+);
+
+
+
 #ifdef __cplusplus
 }
 #endif
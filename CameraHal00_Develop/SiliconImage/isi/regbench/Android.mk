@@ -0,0 +1,34 @@
+#
+# RockChip Camera HAL
+#
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+# camsys_i2c_sim.c stands in for the i2c functions of libisp_hal, so the
+# bench runs on any target without a sensor
+LOCAL_SRC_FILES:=\
+	source/isi_reg_bench.c\
+	source/camsys_i2c_sim.c\
+	../source/isisup.c\
+	../source/isi.c\
+	../drv/OV8858/source/OV8858_tables.c\
+	../drv/IMX214/source/IMX214_tables.c\
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/include_priv\
+	$(LOCAL_PATH)/../include\
+	$(LOCAL_PATH)/../include_priv\
+	$(LOCAL_PATH)/../drv/OV8858/include_priv\
+	$(LOCAL_PATH)/../drv/IMX214/include_priv\
+	$(LOCAL_PATH)/../../include\
+
+LOCAL_CFLAGS := -Wall -Wextra -std=gnu99 -Wformat-nonliteral -O2
+LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
+LOCAL_STATIC_LIBRARIES := libisp_ebase libisp_oslayer
+LOCAL_SHARED_LIBRARIES := liblog
+
+LOCAL_MODULE:= isi_reg_bench
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+#ifndef __CAMSYS_I2C_SIM_H__
+#define __CAMSYS_I2C_SIM_H__
+
+/**
+ * @file camsys_i2c_sim.h
+ *
+ * @brief   I2C part of the HAL against a simulated camsys device and sensor.
+ *
+ *          Every write is cut into camsys requests the way hal_mockup.c does
+ *          it and recorded. The sensor is a 64k register file with address
+ *          auto increment; besides its content the order of all byte writes
+ *          is kept, so two ways of programming a table can be compared.
+ *
+ *****************************************************************************/
+#include <ebase/types.h>
+#include <common/return_codes.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+
+#define CAMSYS_I2C_SIM_MAX_WRITES   8192U           /**< byte writes recorded */
+#define CAMSYS_I2C_SIM_SPEED        300000U         /**< bus clock of hal_mockup.c */
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Counters of the simulated device.
+ *
+ *****************************************************************************/
+typedef struct CamsysI2cSimStats_s
+{
+    uint32_t    Requests;       /**< CAMSYS_I2CWR / CAMSYS_I2CRD ioctls */
+    uint32_t    Messages;       /**< I2C messages on the bus */
+    uint32_t    BusBytes;       /**< bytes on the bus, slave and register addresses included */
+    uint32_t    BusUs;          /**< bus time at CAMSYS_I2C_SIM_SPEED */
+} CamsysI2cSimStats_t;
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   One byte written to the sensor.
+ *
+ *****************************************************************************/
+typedef struct CamsysI2cSimWrite_s
+{
+    uint16_t    Address;
+    uint8_t     Value;
+} CamsysI2cSimWrite_t;
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Clears register file, write record and counters.
+ *
+ *****************************************************************************/
+void CamsysI2cSimReset
+(
+    void
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns the counters.
+ *
+ *****************************************************************************/
+void CamsysI2cSimGetStats
+(
+    CamsysI2cSimStats_t *pStats
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns the recorded byte writes in bus order.
+ *
+ * @param   pNum        returns the number of writes, 0 if the record
+ *                      overflowed
+ *
+ *****************************************************************************/
+const CamsysI2cSimWrite_t *CamsysI2cSimGetWrites
+(
+    uint32_t            *pNum
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns the register file of the sensor, 64k bytes.
+ *
+ *****************************************************************************/
+const uint8_t *CamsysI2cSimGetRegs
+(
+    void
+);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CAMSYS_I2C_SIM_H__ */
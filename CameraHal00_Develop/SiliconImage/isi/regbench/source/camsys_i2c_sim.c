@@ -0,0 +1,240 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file camsys_i2c_sim.c
+ *
+ * @brief   HAL I2C functions against a simulated camsys device, linked
+ *          instead of libisp_hal.
+ *
+ *****************************************************************************/
+#include <ebase/types.h>
+#include <ebase/builtins.h>
+
+#include <common/return_codes.h>
+
+#include <hal/hal_api.h>
+
+#include "camsys_i2c_sim.h"
+
+
+
+/******************************************************************************
+ * local variable declarations
+ *****************************************************************************/
+static uint8_t              SimRegs[0x10000];
+static CamsysI2cSimWrite_t  SimWrites[CAMSYS_I2C_SIM_MAX_WRITES];
+static uint32_t             SimNumWrites;
+static bool_t               SimOverflow;
+static CamsysI2cSimStats_t  SimStats;
+
+
+
+/******************************************************************************
+ * local functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * SimMessage()
+ *
+ * One message on the bus: start, slave address, register address, data,
+ * stop. The sensor increments the register address after each data byte.
+ *****************************************************************************/
+static void SimMessage
+(
+    uint32_t        reg_address,
+    const uint8_t   reg_addr_size,
+    const uint8_t   *p_data,
+    const uint32_t  byte_size,
+    const bool_t    write
+)
+{
+    uint32_t i;
+
+    for ( i = 0U; i < byte_size; i++, reg_address++ )
+    {
+        if ( write )
+        {
+            SimRegs[reg_address & 0xffffU] = p_data[i];
+
+            if ( SimNumWrites < CAMSYS_I2C_SIM_MAX_WRITES )
+            {
+                SimWrites[SimNumWrites].Address = (uint16_t)reg_address;
+                SimWrites[SimNumWrites].Value   = p_data[i];
+                SimNumWrites++;
+            }
+            else
+            {
+                SimOverflow = BOOL_TRUE;
+            }
+        }
+    }
+
+    /* a read is a write of the register address and a restarted read */
+    SimStats.Messages += ( write ) ? 1U : 2U;
+    SimStats.BusBytes += ( ( write ) ? 1U : 2U ) + reg_addr_size + byte_size;
+}
+
+
+
+/******************************************************************************
+ * See header file for detailed comment.
+ *****************************************************************************/
+
+/******************************************************************************
+ * CamsysI2cSimReset()
+ *****************************************************************************/
+void CamsysI2cSimReset
+(
+    void
+)
+{
+    MEMSET( SimRegs, 0, sizeof(SimRegs) );
+    MEMSET( &SimStats, 0, sizeof(SimStats) );
+    SimNumWrites    = 0U;
+    SimOverflow     = BOOL_FALSE;
+}
+
+
+
+/******************************************************************************
+ * CamsysI2cSimGetStats()
+ *****************************************************************************/
+void CamsysI2cSimGetStats
+(
+    CamsysI2cSimStats_t *pStats
+)
+{
+    *pStats = SimStats;
+
+    /* 9 clocks per byte, plus start and stop */
+    pStats->BusUs = (uint32_t)( ( ( (uint64_t)SimStats.BusBytes * 9U + SimStats.Messages * 2U ) * 1000000U )
+                                    / CAMSYS_I2C_SIM_SPEED );
+}
+
+
+
+/******************************************************************************
+ * CamsysI2cSimGetWrites()
+ *****************************************************************************/
+const CamsysI2cSimWrite_t *CamsysI2cSimGetWrites
+(
+    uint32_t            *pNum
+)
+{
+    *pNum = ( SimOverflow ) ? 0U : SimNumWrites;
+
+    return ( SimWrites );
+}
+
+
+
+/******************************************************************************
+ * CamsysI2cSimGetRegs()
+ *****************************************************************************/
+const uint8_t *CamsysI2cSimGetRegs
+(
+    void
+)
+{
+    return ( SimRegs );
+}
+
+
+
+/******************************************************************************
+ * HAL
+ *****************************************************************************/
+RESULT HalAddRef( HalHandle_t HalHandle )
+{
+    return ( ( HalHandle == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+RESULT HalDelRef( HalHandle_t HalHandle )
+{
+    return ( ( HalHandle == NULL ) ? RET_NULL_POINTER : RET_SUCCESS );
+}
+
+/* CAMSYS_I2CRD, up to 4 bytes */
+RESULT HalReadI2CMem( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint32_t reg_address, uint8_t reg_addr_size, uint8_t *p_read_buffer, uint32_t byte_size )
+{
+    uint32_t i;
+
+    UNUSED_PARAM( bus_num );
+    UNUSED_PARAM( slave_addr );
+
+    if ( ( HalHandle == NULL ) || ( p_read_buffer == NULL ) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    if ( byte_size > 4U )
+    {
+        byte_size = 4U;
+    }
+
+    for ( i = 0U; i < byte_size; i++ )
+    {
+        p_read_buffer[i] = SimRegs[( reg_address + i ) & 0xffffU];
+    }
+
+    SimStats.Requests++;
+    SimMessage( reg_address, reg_addr_size, NULL, byte_size, BOOL_FALSE );
+
+    return ( RET_SUCCESS );
+}
+
+/* CAMSYS_I2CWR with the value in the request, up to 4 bytes */
+RESULT HalWriteI2CMem( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint32_t reg_address, uint8_t reg_addr_size, uint8_t *p_write_buffer, uint32_t byte_size )
+{
+    UNUSED_PARAM( bus_num );
+    UNUSED_PARAM( slave_addr );
+
+    if ( ( HalHandle == NULL ) || ( p_write_buffer == NULL ) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    if ( byte_size > 4U )
+    {
+        return ( RET_NOTSUPP );
+    }
+
+    SimStats.Requests++;
+    SimMessage( reg_address, reg_addr_size, p_write_buffer, byte_size, BOOL_TRUE );
+
+    return ( RET_SUCCESS );
+}
+
+/* same requests as hal_mockup.c: each message in requests of up to 4 bytes */
+RESULT HalWriteI2CBatch( HalHandle_t HalHandle, uint8_t bus_num, uint16_t slave_addr, uint8_t reg_addr_size, const HalI2cMsg_t *p_msgs, uint32_t num_msgs )
+{
+    uint32_t n, offs, len;
+
+    UNUSED_PARAM( bus_num );
+    UNUSED_PARAM( slave_addr );
+
+    if ( ( HalHandle == NULL ) || ( p_msgs == NULL ) )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    for ( n = 0U; n < num_msgs; n++ )
+    {
+        for ( offs = 0U; offs < p_msgs[n].byte_size; offs += len )
+        {
+            len = ( ( p_msgs[n].byte_size - offs ) > 4U ) ? 4U : ( p_msgs[n].byte_size - offs );
+            SimStats.Requests++;
+            SimMessage( p_msgs[n].reg_address + offs, reg_addr_size, &p_msgs[n].p_buffer[offs], len, BOOL_TRUE );
+        }
+    }
+
+    return ( RET_SUCCESS );
+}
@@ -0,0 +1,383 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file    isi_reg_bench.c
+ *
+ * @brief   Applies the register tables of the OV8858 and IMX214 drivers with
+ *          IsiRegDefaultsApply() against the simulated camsys device, once
+ *          register by register through the driver write function, once
+ *          batched and batched with merged writes of up to 4 bytes, as the
+ *          drivers do, and of up to ISI_I2C_BURST_MAX bytes.
+ *
+ *          The batched runs have to leave the same bytes in the sensor,
+ *          written in the same order, as the register by register run. For
+ *          every run the camsys requests, the I2C messages and the bus time
+ *          are printed.
+ *
+ *          Then it runs the exposure writes of OV8858_IsiExposureControlIss()
+ *          for a settling AEC, once plain and once with the register shadow
+ *          of the driver, and compares the sensor registers after every frame.
+ *
+ *          Exit code is 0 if all runs matched, 1 otherwise.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ebase/types.h>
+#include <common/return_codes.h>
+
+#include "isi.h"
+#include "isi_iss.h"
+#include "isi_priv.h"
+
+#include "camsys_i2c_sim.h"
+
+#define BENCH_RUNS          4
+#define BENCH_DEF_FRAMES    300
+
+extern const IsiRegDescription_t OV8858_g_aRegDescription_onelane[];
+extern const IsiRegDescription_t OV8858_g_aRegDescription_twolane[];
+extern const IsiRegDescription_t OV8858_g_aRegDescription_fourlane[];
+extern const IsiRegDescription_t OV8858_g_aRegDescription_twolane_R2A[];
+extern const IsiRegDescription_t OV8858_g_aRegDescription_fourlane_R2A[];
+extern const IsiRegDescription_t Sensor_g_aRegDescription_twolane[];
+extern const IsiRegDescription_t Sensor_g_aRegDescription_fourlane[];
+extern const IsiRegDescription_t OV8858_g_aRegShadow[];
+extern const IsiRegDescription_t OV8858_g_aGroupHoldBegin[];
+extern const IsiRegDescription_t OV8858_g_aGroupHoldEnd[];
+
+typedef struct BenchTable_s
+{
+    const char                  *pName;
+    const IsiRegDescription_t   *pTable;
+    const IsiRegDescription_t   *pWidths;   /**< table the driver takes the register widths from */
+} BenchTable_t;
+
+static const BenchTable_t BenchTables[] =
+{
+    { "OV8858 onelane",         OV8858_g_aRegDescription_onelane,       OV8858_g_aRegDescription_twolane },
+    { "OV8858 twolane",         OV8858_g_aRegDescription_twolane,       OV8858_g_aRegDescription_twolane },
+    { "OV8858 fourlane",        OV8858_g_aRegDescription_fourlane,      OV8858_g_aRegDescription_twolane },
+    { "OV8858 twolane R2A",     OV8858_g_aRegDescription_twolane_R2A,   OV8858_g_aRegDescription_twolane },
+    { "OV8858 fourlane R2A",    OV8858_g_aRegDescription_fourlane_R2A,  OV8858_g_aRegDescription_twolane },
+    { "IMX214 twolane",         Sensor_g_aRegDescription_twolane,       Sensor_g_aRegDescription_twolane },
+    { "IMX214 fourlane",        Sensor_g_aRegDescription_fourlane,      Sensor_g_aRegDescription_twolane },
+};
+
+static const uint8_t BenchBurstLen[BENCH_RUNS] = { 0U, 1U, ISI_I2C_NR_DAT_BYTES_4, ISI_I2C_BURST_MAX };
+
+static const IsiRegDescription_t *pWidths;
+
+static IsiSensorContext_t ctx;
+static IsiSensor_t sensor;
+
+/* same as the RegWriteIss of both drivers */
+static RESULT BenchRegWriteIss( IsiSensorHandle_t handle, const uint32_t address, const uint32_t value )
+{
+    uint8_t NrOfBytes;
+
+    NrOfBytes = IsiGetNrDatBytesIss( address, pWidths );
+    if ( !NrOfBytes )
+    {
+        NrOfBytes = 1;
+    }
+
+    return ( IsiI2cWriteSensorRegister( handle, address, (uint8_t *)(&value), NrOfBytes, BOOL_TRUE ) );
+}
+
+static void usage( const char *name )
+{
+    printf( "usage: %s [-n frames] [-v]\n", name );
+}
+
+static long bench_tables( const int verbose )
+{
+    static CamsysI2cSimWrite_t ref[CAMSYS_I2C_SIM_MAX_WRITES];
+
+    long errors = 0;
+
+    const CamsysI2cSimWrite_t *pWrites;
+    CamsysI2cSimStats_t stats;
+    CamsysI2cSimStats_t refStats = { 0U, 0U, 0U, 0U };
+    uint32_t numRef = 0U, num, t, r, i;
+    RESULT result;
+
+    printf( "%-22s %5s %9s %9s %9s %9s\n", "table", "burst", "requests", "messages", "bytes", "bus us" );
+
+    for ( t = 0U; t < sizeof(BenchTables) / sizeof(BenchTables[0]); t++ )
+    {
+        pWidths = BenchTables[t].pWidths;
+
+        for ( r = 0U; r < BENCH_RUNS; r++ )
+        {
+            CamsysI2cSimReset();
+
+            ctx.I2cBurstLen = BenchBurstLen[r];
+            result = IsiRegDefaultsApply( (IsiSensorHandle_t)&ctx, BenchTables[t].pTable );
+            if ( result != RET_SUCCESS )
+            {
+                printf( "%s: burst %u failed (%d)\n", BenchTables[t].pName, BenchBurstLen[r], result );
+                errors++;
+                continue;
+            }
+
+            CamsysI2cSimGetStats( &stats );
+            pWrites = CamsysI2cSimGetWrites( &num );
+            if ( ( num == 0U ) && ( stats.Messages > 0U ) )
+            {
+                printf( "%s: more than %u writes\n", BenchTables[t].pName, CAMSYS_I2C_SIM_MAX_WRITES );
+                return ( errors + 1 );
+            }
+
+            if ( r == 0U )
+            {
+                memcpy( ref, pWrites, num * sizeof(ref[0]) );
+                numRef   = num;
+                refStats = stats;
+            }
+            else
+            {
+                for ( i = 0U; ( i < num ) && ( i < numRef ); i++ )
+                {
+                    if ( ( pWrites[i].Address != ref[i].Address ) || ( pWrites[i].Value != ref[i].Value ) )
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if ( ( r > 0U ) && ( ( num != numRef ) || ( i < num ) ) )
+            {
+                printf( "%s: burst %u differs at write %u of %u/%u\n",
+                        BenchTables[t].pName, BenchBurstLen[r], i, num, numRef );
+                errors++;
+            }
+
+            printf( "%-22s %5u %9u %9u %9u %9u", BenchTables[t].pName, BenchBurstLen[r],
+                    stats.Requests, stats.Messages, stats.BusBytes, stats.BusUs );
+            if ( r > 0U )
+            {
+                printf( "   (%.1fx requests, %.1fx bus)",
+                        ( stats.Requests > 0U ) ? (double)refStats.Requests / stats.Requests : 0.0,
+                        ( stats.BusUs > 0U ) ? (double)refStats.BusUs / stats.BusUs : 0.0 );
+            }
+            printf( "\n" );
+
+            if ( verbose && ( r == 0U ) )
+            {
+                for ( i = 0U; i < num; i++ )
+                {
+                    printf( "  0x%04x = 0x%02x\n", pWrites[i].Address, pWrites[i].Value );
+                }
+            }
+        }
+    }
+
+    return ( errors );
+}
+
+/* same register writes as OV8858_IsiSetIntegrationTimeIss() and
+ * OV8858_IsiSetGainIss(), including their check for a changed value */
+static RESULT exposure( uint32_t *pOldLines, uint32_t *pOldGain, const uint32_t Lines, const uint32_t Gain )
+{
+    RESULT result = IsiRegShadowBegin( (IsiSensorHandle_t)&ctx );
+
+    if ( Lines != *pOldLines )
+    {
+        UPDATE_RESULT( result, BenchRegWriteIss( (IsiSensorHandle_t)&ctx, 0x3500, ( Lines & 0x0000F000U ) >> 12U ) );
+        UPDATE_RESULT( result, BenchRegWriteIss( (IsiSensorHandle_t)&ctx, 0x3501, ( Lines & 0x00000FF0U ) >> 4U ) );
+        UPDATE_RESULT( result, BenchRegWriteIss( (IsiSensorHandle_t)&ctx, 0x3502, ( Lines & 0x0000000FU ) << 4U ) );
+        *pOldLines = Lines;
+    }
+
+    if ( Gain != *pOldGain )
+    {
+        UPDATE_RESULT( result, BenchRegWriteIss( (IsiSensorHandle_t)&ctx, 0x3508, ( Gain >> 8 ) & 0x07U ) );
+        UPDATE_RESULT( result, BenchRegWriteIss( (IsiSensorHandle_t)&ctx, 0x3509, Gain & 0xffU ) );
+        *pOldGain = Gain;
+    }
+
+    UPDATE_RESULT( result, IsiRegShadowEnd( (IsiSensorHandle_t)&ctx ) );
+
+    return ( result );
+}
+
+static long bench_shadow( const uint32_t frames )
+{
+    static uint8_t regs[0x10000];
+
+    static const uint16_t pll[] = { 0x030b, 0x030c, 0x030d, 0x030e, 0x030f, 0x0312, 0x3106 };
+
+    CamsysI2cSimStats_t stats[2], start;
+    IsiRegShadowStats_t shadow;
+    uint32_t oldLines, oldGain, lines, gain, amp;
+    uint32_t f, r, i, value;
+    long errors = 0;
+    RESULT result;
+
+    printf( "\n%-22s %9s %9s %9s %9s\n", "OV8858 aec, per frame", "requests", "messages", "bytes", "bus us" );
+
+    pWidths = OV8858_g_aRegDescription_twolane;
+
+    for ( r = 0U; r < 2U; r++ )
+    {
+        CamsysI2cSimReset();
+
+        ctx.I2cBurstLen = ISI_I2C_NR_DAT_BYTES_4;   /* as the driver */
+        if ( r == 1U )
+        {
+            result = IsiRegShadowCreate( (IsiSensorHandle_t)&ctx, OV8858_g_aRegShadow, OV8858_g_aGroupHoldBegin, OV8858_g_aGroupHoldEnd );
+            if ( result != RET_SUCCESS )
+            {
+                printf( "IsiRegShadowCreate failed (%d)\n", result );
+                return ( errors + 1 );
+            }
+        }
+
+        result = IsiRegDefaultsApply( (IsiSensorHandle_t)&ctx, OV8858_g_aRegDescription_twolane );
+
+        /* the clock calculation of the driver reads the pll setup */
+        for ( i = 0U; ( i < sizeof(pll) / sizeof(pll[0]) ) && ( result == RET_SUCCESS ); i++ )
+        {
+            value = 0U;
+            result = IsiI2cReadSensorRegister( (IsiSensorHandle_t)&ctx, pll[i], (uint8_t *)&value, 1U, BOOL_TRUE );
+            if ( value != CamsysI2cSimGetRegs()[pll[i]] )
+            {
+                printf( "pll register 0x%04x read 0x%02x, is 0x%02x\n", pll[i], value, CamsysI2cSimGetRegs()[pll[i]] );
+                errors++;
+            }
+        }
+
+        CamsysI2cSimGetStats( &start );
+
+        oldLines = 0U;
+        oldGain  = 0U;
+
+        /* an aec settling with a halving overshoot, unchanged at the end */
+        for ( f = 0U; ( f < frames ) && ( result == RET_SUCCESS ); f++ )
+        {
+            amp   = 512U >> ( f / 20U );
+            lines = ( f & 1U ) ? ( 1000U + amp ) : ( 1000U - amp );
+            gain  = 128U + ( amp >> 2 );
+
+            result = exposure( &oldLines, &oldGain, lines, gain );
+
+            if ( r == 0U )
+            {
+                continue;
+            }
+
+            /* the sensor has to have the values of the frame */
+            if ( ( CamsysI2cSimGetRegs()[0x3500] != ( ( lines >> 12 ) & 0x0fU ) )
+                    || ( CamsysI2cSimGetRegs()[0x3501] != ( ( lines >> 4 ) & 0xffU ) )
+                    || ( CamsysI2cSimGetRegs()[0x3502] != ( ( lines & 0x0fU ) << 4 ) )
+                    || ( CamsysI2cSimGetRegs()[0x3508] != ( ( gain >> 8 ) & 0x07U ) )
+                    || ( CamsysI2cSimGetRegs()[0x3509] != ( gain & 0xffU ) ) )
+            {
+                if ( errors++ < 10 )
+                {
+                    printf( "frame %u: exposure/gain registers wrong\n", f );
+                }
+            }
+        }
+
+        if ( result != RET_SUCCESS )
+        {
+            printf( "frame %u failed (%d)\n", f, result );
+            errors++;
+        }
+
+        CamsysI2cSimGetStats( &stats[r] );
+        stats[r].Requests -= start.Requests;
+        stats[r].Messages -= start.Messages;
+        stats[r].BusBytes -= start.BusBytes;
+        stats[r].BusUs    -= start.BusUs;
+
+        printf( "%-22s %9.2f %9.2f %9.2f %9.1f\n", ( r == 0U ) ? "plain" : "shadow, group hold",
+                (double)stats[r].Requests / frames, (double)stats[r].Messages / frames,
+                (double)stats[r].BusBytes / frames, (double)stats[r].BusUs / frames );
+
+        if ( r == 1U )
+        {
+            (void)IsiRegShadowGetStats( (IsiSensorHandle_t)&ctx, &shadow );
+            printf( "%u of %u writes skipped, %u of %u reads cached, %u group holds\n",
+                    shadow.WritesSkipped, shadow.Writes, shadow.ReadsCached, shadow.Reads, shadow.Transactions );
+            (void)IsiRegShadowRelease( (IsiSensorHandle_t)&ctx );
+        }
+        else
+        {
+            memcpy( regs, CamsysI2cSimGetRegs(), sizeof(regs) );
+        }
+    }
+
+    /* both runs end with the same registers, apart from the group hold one */
+    for ( i = 0U; i < 0x10000U; i++ )
+    {
+        if ( ( i != 0x3208U ) && ( regs[i] != CamsysI2cSimGetRegs()[i] ) )
+        {
+            if ( errors++ < 10 )
+            {
+                printf( "register 0x%04x: shadow run 0x%02x, plain run 0x%02x\n", i, CamsysI2cSimGetRegs()[i], regs[i] );
+            }
+        }
+    }
+
+    return ( errors );
+}
+
+int main( int argc, char **argv )
+{
+    uint32_t frames = BENCH_DEF_FRAMES;
+    int verbose = 0;
+    long errors = 0;
+    int opt;
+
+    while ( ( opt = getopt( argc, argv, "n:vh" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                frames = (uint32_t)strtoul( optarg, NULL, 0 );
+                break;
+            case 'v':
+                verbose = 1;
+                break;
+            default:
+                usage( argv[0] );
+                return ( 0 );
+        }
+    }
+    if ( frames < 1U )
+    {
+        usage( argv[0] );
+        return ( 1 );
+    }
+
+    sensor.pIsiRegisterWriteIss = BenchRegWriteIss;
+
+    ctx.HalHandle           = (HalHandle_t)&ctx;
+    ctx.I2cBusNum           = 1U;
+    ctx.SlaveAddress        = 0x6cU;
+    ctx.NrOfAddressBytes    = 2U;
+    ctx.pSensor             = &sensor;
+
+    printf( "i2c %u Hz\n", CAMSYS_I2C_SIM_SPEED );
+
+    errors += bench_tables( verbose );
+    errors += bench_shadow( frames );
+
+    printf( "%ld mismatches\n", errors );
+
+    return ( ( errors == 0 ) ? 0 : 1 );
+}
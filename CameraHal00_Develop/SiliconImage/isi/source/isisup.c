@@ -15,6 +15,8 @@
  *   ADD_DESCRIPTION_HERE
  *
  *****************************************************************************/
+#include <stdlib.h>
+
 #include <ebase/types.h>
 #include <ebase/trace.h>
 #include <ebase/builtins.h>
@@ -39,6 +41,39 @@ USE_TRACER( ISI_ERROR );
  * local type definitions
  *****************************************************************************/
 
+/* writes of IsiRegDefaultsApply() collected for one HalWriteI2CBatch() */
+typedef struct IsiI2cBatch_s
+{
+    HalI2cMsg_t     Msg[ISI_I2C_BATCH_MSGS];
+    uint8_t         Data[ISI_I2C_BATCH_MSGS * 4];
+    uint32_t        NumMsgs;
+    uint32_t        Fill;                           /* bytes used of Data */
+} IsiI2cBatch_t;
+
+#define ISI_REG_SHADOW_VALID    0x01U               /* value known */
+#define ISI_REG_SHADOW_DIRTY    0x02U               /* value staged, not sent yet */
+
+/* one shadowed register */
+typedef struct IsiRegShadowEntry_s
+{
+    uint32_t        Addr;
+    uint8_t         NrOfBytes;
+    uint8_t         Volatile;
+    uint8_t         State;
+    uint8_t         Data[4];                        /* bus order */
+} IsiRegShadowEntry_t;
+
+struct IsiRegShadow_s
+{
+    const IsiRegDescription_t   *pHoldBegin;
+    const IsiRegDescription_t   *pHoldEnd;
+    uint32_t                    Depth;              /* open transactions */
+    uint32_t                    NumDirty;
+    IsiRegShadowStats_t         Stats;
+    uint32_t                    NumEntries;
+    IsiRegShadowEntry_t         Entry[];            /* sorted by address */
+};
+
 
 /******************************************************************************
  * local variable declarations
@@ -261,6 +296,440 @@ static RESULT IsiI2cSwapBytes
 
 
 
+/*****************************************************************************/
+/**
+ *          IsiI2cBatchFlush
+ *
+ * @brief   Sends the collected writes of a batch.
+ *
+ * @param   pSensorCtx          sensor context
+ * @param   pBatch              batch, empty afterwards
+ *
+ * @return  Return the result of the function call.
+ *
+ *****************************************************************************/
+static RESULT IsiI2cBatchFlush
+(
+    IsiSensorContext_t  *pSensorCtx,
+    IsiI2cBatch_t       *pBatch
+)
+{
+    RESULT result = RET_SUCCESS;
+
+    if ( pBatch->NumMsgs > 0U )
+    {
+        result = HalWriteI2CBatch( pSensorCtx->HalHandle,
+                                    pSensorCtx->I2cBusNum,
+                                    pSensorCtx->SlaveAddress,
+                                    pSensorCtx->NrOfAddressBytes,
+                                    pBatch->Msg,
+                                    pBatch->NumMsgs );
+    }
+
+    pBatch->NumMsgs = 0U;
+    pBatch->Fill    = 0U;
+
+    return ( result );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiI2cBatchAdd
+ *
+ * @brief   Adds a register write to a batch, big endian like
+ *          IsiI2cWriteSensorRegister() with swapped bytes. A write that
+ *          continues the previous one is merged into it up to BurstLen
+ *          data bytes.
+ *
+ * @param   pSensorCtx          sensor context
+ * @param   pBatch              batch, sent when full
+ * @param   RegAddress          register address
+ * @param   RegValue            value to write
+ * @param   NrOfDataBytes       register size
+ * @param   BurstLen            max. data bytes of a merged write
+ *
+ * @return  Return the result of the function call.
+ *
+ *****************************************************************************/
+static RESULT IsiI2cBatchAdd
+(
+    IsiSensorContext_t  *pSensorCtx,
+    IsiI2cBatch_t       *pBatch,
+    const uint32_t      RegAddress,
+    const uint32_t      RegValue,
+    const uint8_t       NrOfDataBytes,
+    const uint32_t      BurstLen
+)
+{
+    RESULT result = RET_SUCCESS;
+    HalI2cMsg_t *pLast = ( pBatch->NumMsgs > 0U ) ? &pBatch->Msg[pBatch->NumMsgs - 1U] : NULL;
+    uint8_t i;
+
+    if ( ( pLast == NULL )
+            || ( ( pLast->reg_address + pLast->byte_size ) != RegAddress )
+            || ( ( pLast->byte_size + NrOfDataBytes ) > BurstLen ) )
+    {
+        if ( ( pBatch->NumMsgs == ISI_I2C_BATCH_MSGS )
+                || ( ( pBatch->Fill + NrOfDataBytes ) > sizeof(pBatch->Data) ) )
+        {
+            result = IsiI2cBatchFlush( pSensorCtx, pBatch );
+        }
+
+        pLast = &pBatch->Msg[pBatch->NumMsgs++];
+        pLast->reg_address  = RegAddress;
+        pLast->p_buffer     = &pBatch->Data[pBatch->Fill];
+        pLast->byte_size    = 0U;
+    }
+    else if ( ( pBatch->Fill + NrOfDataBytes ) > sizeof(pBatch->Data) )
+    {
+        /* the merged write doesn't fit anymore, it moves to the next batch */
+        uint8_t Head[ISI_I2C_BURST_MAX];
+        HalI2cMsg_t Last = *pLast;
+
+        MEMCPY( Head, Last.p_buffer, Last.byte_size );
+        pBatch->NumMsgs--;
+
+        result = IsiI2cBatchFlush( pSensorCtx, pBatch );
+
+        MEMCPY( pBatch->Data, Head, Last.byte_size );
+        pLast = &pBatch->Msg[pBatch->NumMsgs++];
+        *pLast = Last;
+        pLast->p_buffer = pBatch->Data;
+        pBatch->Fill    = Last.byte_size;
+    }
+
+    for ( i = 0U; i < NrOfDataBytes; i++ )
+    {
+        pBatch->Data[pBatch->Fill++] = (uint8_t)( RegValue >> ( ( NrOfDataBytes - 1U - i ) * 8U ) );
+    }
+    pLast->byte_size += NrOfDataBytes;
+
+    return ( result );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowCompare
+ *
+ * @brief   qsort() compare function of shadow entries, by address.
+ *
+ *****************************************************************************/
+static int IsiRegShadowCompare
+(
+    const void  *pA,
+    const void  *pB
+)
+{
+    const IsiRegShadowEntry_t *pEntryA = (const IsiRegShadowEntry_t *)pA;
+    const IsiRegShadowEntry_t *pEntryB = (const IsiRegShadowEntry_t *)pB;
+
+    return ( ( pEntryA->Addr > pEntryB->Addr ) - ( pEntryA->Addr < pEntryB->Addr ) );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowLowerBound
+ *
+ * @brief   Returns the index of the first entry at or above an address.
+ *
+ *****************************************************************************/
+static uint32_t IsiRegShadowLowerBound
+(
+    const IsiRegShadow_t    *pShadow,
+    const uint32_t          Addr
+)
+{
+    uint32_t lo = 0U;
+    uint32_t hi = pShadow->NumEntries;
+
+    while ( lo < hi )
+    {
+        uint32_t mid = lo + ( ( hi - lo ) >> 1 );
+
+        if ( pShadow->Entry[mid].Addr < Addr )
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return ( lo );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowFind
+ *
+ * @brief   Returns the entry of an access, NULL if address or size don't
+ *          match an entry.
+ *
+ *****************************************************************************/
+static IsiRegShadowEntry_t *IsiRegShadowFind
+(
+    IsiRegShadow_t          *pShadow,
+    const uint32_t          Addr,
+    const uint8_t           NrOfBytes
+)
+{
+    uint32_t i = IsiRegShadowLowerBound( pShadow, Addr );
+
+    if ( ( i < pShadow->NumEntries )
+            && ( pShadow->Entry[i].Addr == Addr )
+            && ( pShadow->Entry[i].NrOfBytes == NrOfBytes ) )
+    {
+        return ( &pShadow->Entry[i] );
+    }
+
+    return ( NULL );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowForget
+ *
+ * @brief   Marks the entries overlapping an access unknown.
+ *
+ *****************************************************************************/
+static void IsiRegShadowForget
+(
+    IsiRegShadow_t          *pShadow,
+    const uint32_t          Addr,
+    const uint8_t           NrOfBytes
+)
+{
+    uint32_t i = IsiRegShadowLowerBound( pShadow, ( Addr > 3U ) ? ( Addr - 3U ) : 0U );
+
+    for ( ; ( i < pShadow->NumEntries ) && ( pShadow->Entry[i].Addr < ( Addr + NrOfBytes ) ); i++ )
+    {
+        IsiRegShadowEntry_t *pEntry = &pShadow->Entry[i];
+
+        if ( ( pEntry->Addr + pEntry->NrOfBytes ) > Addr )
+        {
+            if ( pEntry->State & ISI_REG_SHADOW_DIRTY )
+            {
+                pShadow->NumDirty--;
+            }
+            pEntry->State = 0U;
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowStage
+ *
+ * @brief   Handles a write in the shadow.
+ *
+ * @return  BOOL_TRUE if the write is done (skipped or staged), BOOL_FALSE
+ *          if it has to go to the sensor
+ *
+ *****************************************************************************/
+static bool_t IsiRegShadowStage
+(
+    IsiRegShadow_t          *pShadow,
+    const uint32_t          Addr,
+    const uint8_t           *pData,
+    const uint8_t           NrOfBytes
+)
+{
+    IsiRegShadowEntry_t *pEntry = IsiRegShadowFind( pShadow, Addr, NrOfBytes );
+    uint8_t i;
+
+    if ( pEntry == NULL )
+    {
+        return ( BOOL_FALSE );
+    }
+
+    pShadow->Stats.Writes++;
+
+    if ( ( pEntry->State == ISI_REG_SHADOW_VALID ) && !pEntry->Volatile )
+    {
+        for ( i = 0U; ( i < NrOfBytes ) && ( pEntry->Data[i] == pData[i] ); i++ )
+        {
+        }
+
+        if ( i == NrOfBytes )
+        {
+            pShadow->Stats.WritesSkipped++;
+            return ( BOOL_TRUE );
+        }
+    }
+
+    if ( pShadow->Depth == 0U )
+    {
+        return ( BOOL_FALSE );
+    }
+
+    MEMCPY( pEntry->Data, pData, NrOfBytes );
+    if ( !( pEntry->State & ISI_REG_SHADOW_DIRTY ) )
+    {
+        pShadow->NumDirty++;
+    }
+    pEntry->State = ISI_REG_SHADOW_VALID | ISI_REG_SHADOW_DIRTY;
+
+    return ( BOOL_TRUE );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowStore
+ *
+ * @brief   Records a register access that went to the sensor.
+ *
+ * @param   pShadow             register shadow
+ * @param   Addr                register address
+ * @param   pData               data in bus order, NULL if the access failed
+ * @param   NrOfBytes           size of the access
+ *
+ *****************************************************************************/
+static void IsiRegShadowStore
+(
+    IsiRegShadow_t          *pShadow,
+    const uint32_t          Addr,
+    const uint8_t           *pData,
+    const uint8_t           NrOfBytes
+)
+{
+    IsiRegShadowEntry_t *pEntry = IsiRegShadowFind( pShadow, Addr, NrOfBytes );
+
+    if ( ( pEntry == NULL ) || ( pData == NULL ) || pEntry->Volatile )
+    {
+        IsiRegShadowForget( pShadow, Addr, NrOfBytes );
+        return;
+    }
+
+    MEMCPY( pEntry->Data, pData, NrOfBytes );
+    pEntry->State = ISI_REG_SHADOW_VALID;
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowAddTable
+ *
+ * @brief   Adds the writes of a group hold table to a batch.
+ *
+ *****************************************************************************/
+static RESULT IsiRegShadowAddTable
+(
+    IsiSensorContext_t          *pSensorCtx,
+    IsiI2cBatch_t               *pBatch,
+    const IsiRegDescription_t   *pRegDesc,
+    const uint32_t              BurstLen
+)
+{
+    RESULT result = RET_SUCCESS;
+
+    while ( ( pRegDesc != NULL ) && ( pRegDesc->Flags != eTableEnd ) && ( result == RET_SUCCESS ) )
+    {
+        if ( pRegDesc->Flags & eWritable )
+        {
+            uint8_t NrOfDataBytes = ( pRegDesc->Flags & eFourBytes ) ? ISI_I2C_NR_DAT_BYTES_4
+                                  : ( pRegDesc->Flags & eTwoBytes )  ? ISI_I2C_NR_DAT_BYTES_2
+                                  : ISI_I2C_NR_DAT_BYTES_1;
+
+            result = IsiI2cBatchAdd( pSensorCtx, pBatch, pRegDesc->Addr, pRegDesc->DefaultValue, NrOfDataBytes, BurstLen );
+        }
+
+        ++pRegDesc;
+    }
+
+    return ( result );
+}
+
+
+
+/*****************************************************************************/
+/**
+ *          IsiRegShadowFlush
+ *
+ * @brief   Sends the staged writes as one group hold transaction.
+ *
+ *****************************************************************************/
+static RESULT IsiRegShadowFlush
+(
+    IsiSensorContext_t  *pSensorCtx
+)
+{
+    IsiRegShadow_t *pShadow = pSensorCtx->pRegShadow;
+    IsiI2cBatch_t Batch;
+    uint32_t BurstLen;
+    uint32_t i;
+    uint8_t j;
+
+    RESULT result;
+
+    BurstLen = ( pSensorCtx->I2cBurstLen == 0U ) ? 1U
+             : ( pSensorCtx->I2cBurstLen > ISI_I2C_BURST_MAX ) ? ISI_I2C_BURST_MAX
+             : pSensorCtx->I2cBurstLen;
+
+    Batch.NumMsgs = 0U;
+    Batch.Fill    = 0U;
+
+    result = IsiRegShadowAddTable( pSensorCtx, &Batch, pShadow->pHoldBegin, BurstLen );
+
+    for ( i = 0U; ( i < pShadow->NumEntries ) && ( result == RET_SUCCESS ); i++ )
+    {
+        IsiRegShadowEntry_t *pEntry = &pShadow->Entry[i];
+
+        if ( pEntry->State & ISI_REG_SHADOW_DIRTY )
+        {
+            uint32_t Value = 0U;
+
+            for ( j = 0U; j < pEntry->NrOfBytes; j++ )
+            {
+                Value = ( Value << 8 ) | pEntry->Data[j];
+            }
+
+            result = IsiI2cBatchAdd( pSensorCtx, &Batch, pEntry->Addr, Value, pEntry->NrOfBytes, BurstLen );
+        }
+    }
+
+    if ( result == RET_SUCCESS )
+    {
+        result = IsiRegShadowAddTable( pSensorCtx, &Batch, pShadow->pHoldEnd, BurstLen );
+    }
+
+    if ( result == RET_SUCCESS )
+    {
+        result = IsiI2cBatchFlush( pSensorCtx, &Batch );
+    }
+
+    /* on failure it is unknown what the sensor got */
+    for ( i = 0U; i < pShadow->NumEntries; i++ )
+    {
+        if ( pShadow->Entry[i].State & ISI_REG_SHADOW_DIRTY )
+        {
+            pShadow->Entry[i].State = ( result == RET_SUCCESS ) ? ISI_REG_SHADOW_VALID : 0U;
+        }
+    }
+
+    pShadow->NumDirty = 0U;
+    pShadow->Stats.Transactions++;
+
+    return ( result );
+}
+
+
+
 /******************************************************************************
  * See header file for detailed comment.
  *****************************************************************************/
@@ -315,6 +784,12 @@ RESULT IsiI2cWriteSensorRegister
         IsiI2cSwapBytes ( pData, NrOfDataBytes );
     }
 
+    if ( ( pSensorCtx->pRegShadow != NULL )
+            && IsiRegShadowStage( pSensorCtx->pRegShadow, RegAddress, pData, NrOfDataBytes ) )
+    {
+        return ( RET_SUCCESS );
+    }
+
     result = HalWriteI2CMem( pSensorCtx->HalHandle, 
                                 pSensorCtx->I2cBusNum, 
                                 pSensorCtx->SlaveAddress, 
@@ -323,6 +798,11 @@ RESULT IsiI2cWriteSensorRegister
                                 pData, 
                                 NrOfDataBytes );
 
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        IsiRegShadowStore( pSensorCtx->pRegShadow, RegAddress, ( result == RET_SUCCESS ) ? pData : NULL, NrOfDataBytes );
+    }
+
     TRACE( ISI_INFO, "%s (exit)\n", __FUNCTION__);
 
     return ( result );
@@ -373,13 +853,49 @@ RESULT IsiI2cReadSensorRegister
         return ( RET_NULL_POINTER );
     }
 
-    result = HalReadI2CMem( pSensorCtx->HalHandle, 
-                                pSensorCtx->I2cBusNum, 
-                                pSensorCtx->SlaveAddress, 
-                                RegAddress, 
-                                pSensorCtx->NrOfAddressBytes, 
-                                pData, 
-                                NrOfDataBytes );
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        IsiRegShadow_t *pShadow = pSensorCtx->pRegShadow;
+        IsiRegShadowEntry_t *pEntry = IsiRegShadowFind( pShadow, RegAddress, NrOfDataBytes );
+
+        if ( pEntry != NULL )
+        {
+            pShadow->Stats.Reads++;
+        }
+
+        /* a staged value is returned as well, it is what the sensor will have */
+        if ( ( pEntry != NULL ) && ( pEntry->State & ISI_REG_SHADOW_VALID ) && !pEntry->Volatile )
+        {
+            pShadow->Stats.ReadsCached++;
+            MEMCPY( pData, pEntry->Data, NrOfDataBytes );
+        }
+        else
+        {
+            result = HalReadI2CMem( pSensorCtx->HalHandle,
+                                        pSensorCtx->I2cBusNum,
+                                        pSensorCtx->SlaveAddress,
+                                        RegAddress,
+                                        pSensorCtx->NrOfAddressBytes,
+                                        pData,
+                                        NrOfDataBytes );
+
+            if ( ( result == RET_SUCCESS ) && ( pEntry != NULL ) && !pEntry->Volatile )
+            {
+                MEMCPY( pEntry->Data, pData, NrOfDataBytes );
+                pEntry->State = ISI_REG_SHADOW_VALID;
+            }
+        }
+    }
+    else
+    {
+        result = HalReadI2CMem( pSensorCtx->HalHandle,
+                                    pSensorCtx->I2cBusNum,
+                                    pSensorCtx->SlaveAddress,
+                                    RegAddress,
+                                    pSensorCtx->NrOfAddressBytes,
+                                    pData,
+                                    NrOfDataBytes );
+    }
 
     if ( bSwapBytesEnable == BOOL_TRUE )
     {
@@ -484,20 +1000,70 @@ RESULT IsiRegDefaultsApply
     const IsiRegDescription_t *pRegDesc
 )
 {
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+    IsiI2cBatch_t Batch;
+    uint32_t BurstLen = 0U;
+
     RESULT result = RET_SUCCESS;
 
     TRACE( ISI_INFO, "%s (enter)\n", __FUNCTION__);
 
     DCT_ASSERT( pRegDesc != NULL );
 
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    /* the table may change anything, its writes are recorded anew */
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        (void)IsiRegShadowInvalidate( handle );
+    }
+
+    if ( pSensorCtx->I2cBurstLen > 0U )
+    {
+        BurstLen = ( pSensorCtx->I2cBurstLen > ISI_I2C_BURST_MAX ) ? ISI_I2C_BURST_MAX : pSensorCtx->I2cBurstLen;
+        Batch.NumMsgs = 0U;
+        Batch.Fill    = 0U;
+    }
+
     while ( pRegDesc->Flags != eTableEnd)
     {
         /* if the register is writeable and has a default value */
         if ( (pRegDesc->Flags & eWritable) && !(pRegDesc->Flags & eNoDefault) )
         {
-            result = IsiWriteRegister( handle, pRegDesc->Addr, pRegDesc->DefaultValue );
+            if ( BurstLen > 0U )
+            {
+                uint8_t NrOfDataBytes = ( pRegDesc->Flags & eFourBytes ) ? ISI_I2C_NR_DAT_BYTES_4
+                                      : ( pRegDesc->Flags & eTwoBytes )  ? ISI_I2C_NR_DAT_BYTES_2
+                                      : ISI_I2C_NR_DAT_BYTES_1;
+
+                result = IsiI2cBatchAdd( pSensorCtx, &Batch, pRegDesc->Addr, pRegDesc->DefaultValue, NrOfDataBytes, BurstLen );
+
+                if ( pSensorCtx->pRegShadow != NULL )
+                {
+                    uint8_t Data[4];
+                    uint8_t i;
+
+                    for ( i = 0U; i < NrOfDataBytes; i++ )
+                    {
+                        Data[i] = (uint8_t)( pRegDesc->DefaultValue >> ( ( NrOfDataBytes - 1U - i ) * 8U ) );
+                    }
+
+                    IsiRegShadowStore( pSensorCtx->pRegShadow, pRegDesc->Addr, Data, NrOfDataBytes );
+                }
+            }
+            else
+            {
+                result = IsiWriteRegister( handle, pRegDesc->Addr, pRegDesc->DefaultValue );
+            }
             if ( result != RET_SUCCESS )
             {
+                if ( pSensorCtx->pRegShadow != NULL )
+                {
+                    (void)IsiRegShadowInvalidate( handle );
+                }
                 return ( result );
             }
         }
@@ -506,6 +1072,20 @@ RESULT IsiRegDefaultsApply
         /* some registers need some delay after reading or writing */
         if ( pRegDesc->Flags & eDelay )
         {
+            /* the writes so far have to be done before the delay */
+            if ( BurstLen > 0U )
+            {
+                result = IsiI2cBatchFlush( pSensorCtx, &Batch );
+                if ( result != RET_SUCCESS )
+                {
+                    if ( pSensorCtx->pRegShadow != NULL )
+                    {
+                        (void)IsiRegShadowInvalidate( handle );
+                    }
+                    return ( result );
+                }
+            }
+
             //wait user defined ms
             osSleep( pRegDesc->DefaultValue );
         }
@@ -514,6 +1094,15 @@ RESULT IsiRegDefaultsApply
         ++pRegDesc;
     }
 
+    if ( BurstLen > 0U )
+    {
+        result = IsiI2cBatchFlush( pSensorCtx, &Batch );
+        if ( ( result != RET_SUCCESS ) && ( pSensorCtx->pRegShadow != NULL ) )
+        {
+            (void)IsiRegShadowInvalidate( handle );
+        }
+    }
+
     TRACE( ISI_INFO, "%s (exit)\n", __FUNCTION__);
 
     return ( result );
@@ -593,3 +1182,245 @@ RESULT IsiRegDefaultsVerify
 }
 
 
+
+/******************************************************************************
+ * IsiRegShadowCreate()
+ *****************************************************************************/
+RESULT IsiRegShadowCreate
+(
+    IsiSensorHandle_t         handle,
+    const IsiRegDescription_t *pRegDesc,
+    const IsiRegDescription_t *pHoldBegin,
+    const IsiRegDescription_t *pHoldEnd
+)
+{
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+    IsiRegShadow_t *pShadow;
+    const IsiRegDescription_t *pDesc;
+    uint32_t Num = 0U;
+    uint32_t i;
+
+    TRACE( ISI_INFO, "%s (enter)\n", __FUNCTION__);
+
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( pRegDesc == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        return ( RET_WRONG_STATE );
+    }
+
+    for ( pDesc = pRegDesc; pDesc->Flags != eTableEnd; ++pDesc )
+    {
+        Num++;
+    }
+
+    pShadow = (IsiRegShadow_t *)malloc( sizeof(IsiRegShadow_t) + Num * sizeof(IsiRegShadowEntry_t) );
+    if ( pShadow == NULL )
+    {
+        return ( RET_OUTOFMEM );
+    }
+    MEMSET( pShadow, 0, sizeof(IsiRegShadow_t) + Num * sizeof(IsiRegShadowEntry_t) );
+
+    pShadow->pHoldBegin = pHoldBegin;
+    pShadow->pHoldEnd   = pHoldEnd;
+
+    for ( pDesc = pRegDesc; pDesc->Flags != eTableEnd; ++pDesc )
+    {
+        if ( ( pDesc->Flags & ( eReadable | eWritable ) ) && !( pDesc->Flags & eDelay ) )
+        {
+            IsiRegShadowEntry_t *pEntry = &pShadow->Entry[pShadow->NumEntries++];
+
+            pEntry->Addr        = pDesc->Addr;
+            pEntry->NrOfBytes   = ( pDesc->Flags & eFourBytes ) ? ISI_I2C_NR_DAT_BYTES_4
+                                : ( pDesc->Flags & eTwoBytes )  ? ISI_I2C_NR_DAT_BYTES_2
+                                : ISI_I2C_NR_DAT_BYTES_1;
+            pEntry->Volatile    = ( pDesc->Flags & eVolatile ) ? 1U : 0U;
+        }
+    }
+
+    qsort( pShadow->Entry, pShadow->NumEntries, sizeof(IsiRegShadowEntry_t), IsiRegShadowCompare );
+
+    /* a register listed twice is shadowed once */
+    for ( i = 1U, Num = ( pShadow->NumEntries > 0U ) ? 1U : 0U; i < pShadow->NumEntries; i++ )
+    {
+        if ( pShadow->Entry[i].Addr != pShadow->Entry[Num - 1U].Addr )
+        {
+            pShadow->Entry[Num++] = pShadow->Entry[i];
+        }
+    }
+    pShadow->NumEntries = Num;
+
+    pSensorCtx->pRegShadow = pShadow;
+
+    TRACE( ISI_INFO, "%s (exit: %d registers)\n", __FUNCTION__, pShadow->NumEntries);
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IsiRegShadowRelease()
+ *****************************************************************************/
+RESULT IsiRegShadowRelease
+(
+    IsiSensorHandle_t         handle
+)
+{
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        TRACE( ISI_INFO, "%s: %u/%u writes skipped, %u/%u reads cached, %u transactions\n", __FUNCTION__,
+                    pSensorCtx->pRegShadow->Stats.WritesSkipped, pSensorCtx->pRegShadow->Stats.Writes,
+                    pSensorCtx->pRegShadow->Stats.ReadsCached, pSensorCtx->pRegShadow->Stats.Reads,
+                    pSensorCtx->pRegShadow->Stats.Transactions );
+
+        free( pSensorCtx->pRegShadow );
+        pSensorCtx->pRegShadow = NULL;
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IsiRegShadowInvalidate()
+ *****************************************************************************/
+RESULT IsiRegShadowInvalidate
+(
+    IsiSensorHandle_t         handle
+)
+{
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+    uint32_t i;
+
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        for ( i = 0U; i < pSensorCtx->pRegShadow->NumEntries; i++ )
+        {
+            pSensorCtx->pRegShadow->Entry[i].State = 0U;
+        }
+        pSensorCtx->pRegShadow->NumDirty = 0U;
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IsiRegShadowBegin()
+ *****************************************************************************/
+RESULT IsiRegShadowBegin
+(
+    IsiSensorHandle_t         handle
+)
+{
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        pSensorCtx->pRegShadow->Depth++;
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IsiRegShadowEnd()
+ *****************************************************************************/
+RESULT IsiRegShadowEnd
+(
+    IsiSensorHandle_t         handle
+)
+{
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+    IsiRegShadow_t *pShadow;
+
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    pShadow = pSensorCtx->pRegShadow;
+    if ( pShadow == NULL )
+    {
+        return ( RET_SUCCESS );
+    }
+
+    if ( pShadow->Depth == 0U )
+    {
+        return ( RET_WRONG_STATE );
+    }
+
+    pShadow->Depth--;
+    if ( ( pShadow->Depth == 0U ) && ( pShadow->NumDirty > 0U ) )
+    {
+        return ( IsiRegShadowFlush( pSensorCtx ) );
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * IsiRegShadowGetStats()
+ *****************************************************************************/
+RESULT IsiRegShadowGetStats
+(
+    IsiSensorHandle_t         handle,
+    IsiRegShadowStats_t       *pStats
+)
+{
+    IsiSensorContext_t *pSensorCtx = (IsiSensorContext_t *)handle;
+
+    if ( pSensorCtx == NULL )
+    {
+        return ( RET_WRONG_HANDLE );
+    }
+
+    if ( pStats == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    if ( pSensorCtx->pRegShadow != NULL )
+    {
+        *pStats = pSensorCtx->pRegShadow->Stats;
+    }
+    else
+    {
+        MEMSET( pStats, 0, sizeof(*pStats) );
+    }
+
+    return ( RET_SUCCESS );
+}
+
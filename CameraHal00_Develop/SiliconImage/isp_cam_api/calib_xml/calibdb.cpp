@@ -22,6 +22,8 @@
 #include <cam_calibdb/cam_calibdb_api.h>
 #include <string>
 #include <iostream>
+#include <limits.h>
+#include <stdio.h>
 
 #include "calib_xml/calibdb.h"
 #include "calibtags.h"
@@ -825,12 +827,60 @@ bool CalibDb::CreateCalibDb
 
 
 /******************************************************************************
- * CalibDb::readFile
+ * CalibDb::CreateCalibDb
  *****************************************************************************/
 bool CalibDb::CreateCalibDb
 (
     const char *device
 )
+{
+    char cachefile[PATH_MAX];
+    uint64_t hash = 0;
+    bool cached;
+    bool res;
+
+    RESULT result = CamCalibDbCreate( &m_CalibDbHandle );
+    DCT_ASSERT( result == RET_SUCCESS );
+
+    // the binary image is only trusted when it was made from these exact xml bytes
+    const char *base = strrchr( device, '/' );
+    base = ( base ) ? ( base + 1 ) : device;
+    cached = ( snprintf( cachefile, sizeof(cachefile), "%s%s.bin", CALIBDB_CACHE_DIR, base ) < (int)sizeof(cachefile) )
+                && ( CamCalibDbHashFile( device, &hash ) == RET_SUCCESS );
+
+    if ( cached )
+    {
+        result = CamCalibDbLoadBinary( m_CalibDbHandle, cachefile, hash );
+        if ( result == RET_SUCCESS )
+        {
+            TRACE( CALIBDB_INFO, "%s(%d): %s loaded from %s\n", __FUNCTION__, __LINE__, device, cachefile );
+            return ( true );
+        }
+        TRACE( CALIBDB_INFO, "%s(%d): no valid image %s (%d), parsing xml\n", __FUNCTION__, __LINE__, cachefile, result );
+    }
+
+    res = readFile( device );
+    if ( res && cached )
+    {
+        result = CamCalibDbSaveBinary( m_CalibDbHandle, cachefile, hash );
+        if ( result != RET_SUCCESS )
+        {
+            TRACE( CALIBDB_WARN, "%s(%d): can't write %s (%d)\n", __FUNCTION__, __LINE__, cachefile, result );
+        }
+    }
+
+    return ( res );
+}
+
+
+
+/******************************************************************************
+ * CalibDb::readFile
+ *****************************************************************************/
+bool CalibDb::readFile
+(
+    const char *device
+)
 {
     //QString errorString;
     int errorID;
@@ -839,8 +889,6 @@ bool CalibDb::CreateCalibDb
     bool res = true;
     TRACE( CALIBDB_INFO, "%s(%d): (enter)\n", __FUNCTION__,__LINE__);
     
-	RESULT result = CamCalibDbCreate( &m_CalibDbHandle );
-    DCT_ASSERT( result == RET_SUCCESS );
     errorID = doc.LoadFile(device); 
     std::cout << __func__ << " doc.LoadFile" << "filename"<<device<< "error"<<errorID<<std::endl;
     if ( doc.Error() )
@@ -0,0 +1,169 @@
+/******************************************************************************
+ *
+ * Copyright 2011, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file    calibdb_bench.cpp
+ *
+ * @brief   Open time of a calibration database, xml vs binary image.
+ *
+ *          Every xml run starts without an image, so it pays for parsing and
+ *          for writing the image. Every binary run then opens the image the
+ *          way the camera service does on the next start. The image of the
+ *          last binary run is written again and compared to the first one.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "calib_xml/calibdb.h"
+
+#define BENCH_DEF_LOOPS     10
+
+static long long now_us( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000 );
+}
+
+static bool same_file( const char *a, const char *b )
+{
+    FILE *fa = fopen( a, "rb" );
+    FILE *fb = fopen( b, "rb" );
+    bool same = ( fa != NULL ) && ( fb != NULL );
+    int ca, cb;
+
+    while ( same )
+    {
+        ca = fgetc( fa );
+        cb = fgetc( fb );
+        same = ( ca == cb );
+        if ( ca == EOF )
+        {
+            break;
+        }
+    }
+
+    if ( fa ) fclose( fa );
+    if ( fb ) fclose( fb );
+
+    return ( same );
+}
+
+static void print_times( const char *name, long long *us, int loops )
+{
+    long long best = us[0], sum = 0;
+    int i;
+
+    for ( i = 0; i < loops; i++ )
+    {
+        sum += us[i];
+        if ( us[i] < best )
+        {
+            best = us[i];
+        }
+    }
+
+    printf( "%-22s best %8.2f ms   mean %8.2f ms\n", name, best / 1000.0, sum / 1000.0 / loops );
+}
+
+int main( int argc, char **argv )
+{
+    char cachefile[PATH_MAX];
+    char checkfile[PATH_MAX];
+    int loops = BENCH_DEF_LOOPS;
+    long long *xml_us, *bin_us;
+    const char *xml, *base;
+    uint64_t hash;
+    int opt, i;
+
+    while ( ( opt = getopt( argc, argv, "n:h" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                loops = atoi( optarg );
+                break;
+            default:
+                printf( "usage: %s [-n loops] sensor.xml\n", argv[0] );
+                return ( 0 );
+        }
+    }
+    if ( ( optind >= argc ) || ( loops < 1 ) )
+    {
+        printf( "usage: %s [-n loops] sensor.xml\n", argv[0] );
+        return ( -1 );
+    }
+
+    xml  = argv[optind];
+    base = strrchr( xml, '/' );
+    base = ( base ) ? ( base + 1 ) : xml;
+    snprintf( cachefile, sizeof(cachefile), "%s%s.bin", CALIBDB_CACHE_DIR, base );
+    snprintf( checkfile, sizeof(checkfile), "%s.check", cachefile );
+
+    if ( CamCalibDbHashFile( xml, &hash ) != RET_SUCCESS )
+    {
+        fprintf( stderr, "can't read %s\n", xml );
+        return ( -1 );
+    }
+
+    xml_us = new long long[loops];
+    bin_us = new long long[loops];
+
+    for ( i = 0; i < loops; i++ )
+    {
+        CalibDb db;
+
+        unlink( cachefile );
+        long long t0 = now_us();
+        if ( !db.CreateCalibDb( xml ) )
+        {
+            fprintf( stderr, "parsing %s failed\n", xml );
+            return ( -1 );
+        }
+        xml_us[i] = now_us() - t0;
+    }
+
+    if ( access( cachefile, R_OK ) != 0 )
+    {
+        fprintf( stderr, "no image written to %s\n", cachefile );
+        return ( -1 );
+    }
+
+    for ( i = 0; i < loops; i++ )
+    {
+        CalibDb db;
+
+        long long t0 = now_us();
+        db.CreateCalibDb( xml );
+        bin_us[i] = now_us() - t0;
+
+        if ( i == ( loops - 1 ) )
+        {
+            CamCalibDbSaveBinary( db.GetCalibDbHandle(), checkfile, hash );
+        }
+    }
+
+    printf( "%s, %d runs\n", xml, loops );
+    print_times( "xml parse + write", xml_us, loops );
+    print_times( "binary image", bin_us, loops );
+    printf( "image round trip: %s\n", same_file( cachefile, checkfile ) ? "identical" : "DIFFERENT" );
+
+    unlink( checkfile );
+    delete[] xml_us;
+    delete[] bin_us;
+
+    return ( 0 );
+}
@@ -28,6 +28,9 @@
 #include <cam_calibdb/cam_calibdb_api.h>
 using namespace tinyxml2;
 
+/* binary images of the parsed xml files, see CamCalibDbSaveBinary() */
+#define CALIBDB_CACHE_DIR   "/data/camera/"
+
 struct sensor_calib_info{
     CamCalibDbMetaData_t meta_data;
     CamResolution_t resolution;
@@ -81,6 +84,8 @@ private:
 
     typedef bool (CalibDb::*parseCellContent)(const XMLElement*, void *param);
 
+    bool readFile( const char *device );
+
     // parse helper
     bool parseEntryCell( const XMLElement*, int, parseCellContent, void *param = NULL );
 
@@ -8,6 +8,8 @@ include $(CLEAR_VARS)
 LOCAL_SRC_FILES:=\
 	source/som_ctrl.c\
 	source/som_ctrl_api.c\
+	source/som_ctrl_conv.c\
+	source/som_ctrl_writer.c\
 
 
 LOCAL_C_INCLUDES += \
@@ -17,6 +19,7 @@ LOCAL_C_INCLUDES += \
 
 LOCAL_CFLAGS := -Wall -Wextra -std=c99   -Wformat-nonliteral -g -O0 -DDEBUG -pedantic
 LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
+LOCAL_ARM_NEON := true
 LOCAL_STATIC_LIBRARIES := libisp_ebase libisp_oslayer libisp_common libisp_hal libisp_bufferpool 
 
 #LOCAL_MODULE_PATH := $(TARGET_OUT_SHARED_LIBRARIES)/hw
@@ -24,3 +27,27 @@ LOCAL_MODULE:= libisp_som_ctrl
 
 LOCAL_MODULE_TAGS:= optional
 include $(BUILD_STATIC_LIBRARY)
+
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:=\
+	source/som_bench.c\
+	source/som_ctrl_conv.c\
+	source/som_ctrl_writer.c\
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/include\
+	$(LOCAL_PATH)/include_priv\
+	$(LOCAL_PATH)/../include/
+
+LOCAL_CFLAGS := -Wall -Wextra -std=gnu99 -Wformat-nonliteral -O2
+LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
+LOCAL_ARM_NEON := true
+LOCAL_STATIC_LIBRARIES := libisp_ebase libisp_oslayer
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE:= som_bench
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
@@ -48,6 +48,7 @@ extern "C"
 #include <hal/hal_api.h>
 
 #include "som_ctrl_common.h"
+#include "som_ctrl_writer.h"
 
 /**
  * @brief   Internal states of the som control.
@@ -102,6 +103,8 @@ typedef struct somCtrlContext_s
     uint32_t                            CurrentPicWidth;    //!< Width of image currently captured.
     uint32_t                            CurrentPicHeight;   //!< Height of image currently captured.
     struct tm                           FileCreationTime;   //!< Creation time of first file in a sequence of files. Used for creation of file names.
+
+    somCtrlWriter_t                     Writer;             //!< Writes the pictures to the files, off the command processing thread.
 } somCtrlContext_t;
 
 
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+#ifndef __SOM_CTRL_CONV_H__
+#define __SOM_CTRL_CONV_H__
+
+/**
+ * @file som_ctrl_conv.h
+ *
+ * @brief   Pixel conversion of the som ctrl.
+ *
+ *          The reference version is the original conversion: upscale the
+ *          picture to YCbCr 4:4:4 by pixel doubling, then convert it in place
+ *          to RGB (BT.601, 10 bit fixed point). The other version converts
+ *          straight from the semiplanar planes in one pass, with NEON where
+ *          available, and is bit exact to the reference.
+ *
+ *****************************************************************************/
+/**
+ * @defgroup som_ctrl_conv SOM Ctrl pixel conversion
+ * @{
+ *
+ */
+#include <ebase/types.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SOM_CTRL_CONV_NEON  1
+#endif
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Converts a YCbCr 4:2:2 semiplanar picture to combined RGB 8:8:8,
+ *          reference version.
+ *
+ * @param   pRgb        3 * Width * Height bytes, no line gaps
+ * @param   pY          luma plane
+ * @param   YStride     bytes per luma line
+ * @param   pCbCr       combined chroma plane, Cb first
+ * @param   CbCrStride  bytes per chroma line
+ * @param   Width       width in pixels, even
+ * @param   Height      height in lines
+ *
+ *****************************************************************************/
+void somCtrlConvYCbCr422SemiToRgbRef
+(
+    uint8_t         *pRgb,
+    const uint8_t   *pY,
+    const uint32_t  YStride,
+    const uint8_t   *pCbCr,
+    const uint32_t  CbCrStride,
+    const uint32_t  Width,
+    const uint32_t  Height
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Same as @ref somCtrlConvYCbCr422SemiToRgbRef in one pass.
+ *
+ *****************************************************************************/
+void somCtrlConvYCbCr422SemiToRgb
+(
+    uint8_t         *pRgb,
+    const uint8_t   *pY,
+    const uint32_t  YStride,
+    const uint8_t   *pCbCr,
+    const uint32_t  CbCrStride,
+    const uint32_t  Width,
+    const uint32_t  Height
+);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+/* @} som_ctrl_conv */
+
+#endif /* __SOM_CTRL_CONV_H__ */
@@ -0,0 +1,260 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+#ifndef __SOM_CTRL_WRITER_H__
+#define __SOM_CTRL_WRITER_H__
+
+/**
+ * @file som_ctrl_writer.h
+ *
+ * @brief   File writer stage of the som ctrl.
+ *
+ *          The som thread fills a buffer of the writer's pool with a complete
+ *          picture, header and packed lines, and queues it. The writer thread
+ *          puts it into the file with a single write and hands the buffer
+ *          back. Closing a file is queued the same way, so the som thread
+ *          only waits when all buffers are in flight or when it syncs at the
+ *          end of a capture.
+ *
+ *          Writes of one file are done in queue order. A failed write is
+ *          counted and reported by the next @ref somCtrlWriterQueue or
+ *          @ref somCtrlWriterSync.
+ *
+ *****************************************************************************/
+/**
+ * @defgroup som_ctrl_writer SOM Ctrl writer
+ * @{
+ *
+ */
+#include <stdio.h>
+
+#include <ebase/types.h>
+#include <common/return_codes.h>
+
+#include <oslayer/oslayer.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+
+#define SOM_CTRL_WRITER_BUFFERS     3U          /**< pictures in flight */
+#define SOM_CTRL_WRITER_JOBS        16U         /**< depth of the job queue; writes, closes and syncs */
+#define SOM_CTRL_WRITER_ALIGN       4096U       /**< alignment of the buffers */
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Buffer of the writer's pool.
+ *
+ *****************************************************************************/
+typedef struct somCtrlWriteBuf_s
+{
+    void                *pMem;          //!< as allocated
+    uint8_t             *pData;         //!< start of data, aligned to SOM_CTRL_WRITER_ALIGN
+    uint32_t            Size;           //!< bytes available at pData
+} somCtrlWriteBuf_t;
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Counters of the writer.
+ *
+ *****************************************************************************/
+typedef struct somCtrlWriterStats_s
+{
+    uint32_t            Pictures;       //!< buffers written
+    uint32_t            Errors;         //!< failed writes and closes
+    uint64_t            Bytes;          //!< bytes written
+    int64_t             WriteUs;        //!< time the writer thread spent writing and closing
+    int64_t             WaitUs;         //!< time the som thread waited for a free buffer
+} somCtrlWriterStats_t;
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Context of the writer.
+ *
+ *****************************************************************************/
+typedef struct somCtrlWriter_s
+{
+    osThread            Thread;         //!< writer thread
+    osQueue             JobQueue;       //!< jobs to the writer thread
+    osQueue             FreeQueue;      //!< free buffers of the pool, somCtrlWriteBuf_t *
+    osEvent             SyncEvent;      //!< signalled when a sync job is through
+    osMutex             StatsLock;      //!< protects Stats and NewErrors
+
+    somCtrlWriteBuf_t   Buf[SOM_CTRL_WRITER_BUFFERS];
+
+    somCtrlWriterStats_t Stats;
+    uint32_t            NewErrors;      //!< errors not reported yet
+} somCtrlWriter_t;
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Creates queues and pool and starts the writer thread. The buffers
+ *          are allocated on first use.
+ *
+ * @param   pWriter     writer context
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_FAILURE
+ *
+ *****************************************************************************/
+RESULT somCtrlWriterCreate
+(
+    somCtrlWriter_t     *pWriter
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Writes everything queued, stops the writer thread and releases
+ *          the pool.
+ *
+ * @param   pWriter     writer context
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_FAILURE
+ *
+ *****************************************************************************/
+RESULT somCtrlWriterDestroy
+(
+    somCtrlWriter_t     *pWriter
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Takes a free buffer of the pool, waits if there is none. The
+ *          buffer is passed back with @ref somCtrlWriterQueue or
+ *          @ref somCtrlWriterPutBuffer.
+ *
+ * @param   pWriter     writer context
+ * @param   Size        bytes needed, the buffer grows if it is smaller
+ * @param   ppBuf       returns the buffer
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_OUTOFMEM    buffer couldn't grow, it is back in the pool
+ * @retval  RET_FAILURE
+ *
+ *****************************************************************************/
+RESULT somCtrlWriterGetBuffer
+(
+    somCtrlWriter_t     *pWriter,
+    const uint32_t      Size,
+    somCtrlWriteBuf_t   **ppBuf
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns a buffer unused.
+ *
+ *****************************************************************************/
+void somCtrlWriterPutBuffer
+(
+    somCtrlWriter_t     *pWriter,
+    somCtrlWriteBuf_t   *pBuf
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Queues the first Length bytes of a buffer for writing to pFile.
+ *          The buffer goes back to the pool after the write.
+ *
+ * @param   pWriter     writer context
+ * @param   pBuf        buffer from @ref somCtrlWriterGetBuffer
+ * @param   Length      bytes to write
+ * @param   pFile       file to append to
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_FAILURE     queueing failed or an earlier write failed
+ *
+ *****************************************************************************/
+RESULT somCtrlWriterQueue
+(
+    somCtrlWriter_t     *pWriter,
+    somCtrlWriteBuf_t   *pBuf,
+    const uint32_t      Length,
+    FILE                *pFile
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Queues closing of a file after everything queued for it.
+ *
+ *****************************************************************************/
+RESULT somCtrlWriterClose
+(
+    somCtrlWriter_t     *pWriter,
+    FILE                *pFile
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Waits until everything queued is written and closed.
+ *
+ * @param   pWriter     writer context
+ * @param   Release     free the buffers of the pool as well
+ *
+ * @return  Return the result of the function call.
+ * @retval  RET_SUCCESS
+ * @retval  RET_FAILURE     a write or close failed since the last report
+ *
+ *****************************************************************************/
+RESULT somCtrlWriterSync
+(
+    somCtrlWriter_t     *pWriter,
+    const bool_t        Release
+);
+
+
+
+/*****************************************************************************/
+/**
+ * @brief   Returns the counters since @ref somCtrlWriterCreate.
+ *
+ *****************************************************************************/
+void somCtrlWriterGetStats
+(
+    somCtrlWriter_t         *pWriter,
+    somCtrlWriterStats_t    *pStats
+);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+/* @} som_ctrl_writer */
+
+#endif /* __SOM_CTRL_WRITER_H__ */
@@ -0,0 +1,513 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file    som_bench.c
+ *
+ * @brief   Burst capture throughput of the som ctrl file output, the way
+ *          somCtrlStoreBuffer() used to do it against the writer stage.
+ *
+ *          A burst of pictures is stored once per output format, one file
+ *          per picture, from frames with line stuffing in memory:
+ *
+ *          - before: local buffer per picture, copy of the planes, header
+ *            with fprintf, one fwrite per line, YCbCr -> RGB by upscaling to
+ *            4:4:4 and converting in place; all on the calling thread
+ *          - writer: pool buffer, header and packed lines in it, one pass
+ *            conversion, file write and close on the writer thread
+ *
+ *          Reported are the time the calling thread, which is the som
+ *          thread, is busy per picture and the throughput of the burst up to
+ *          the final sync. Both sets of files have to be byte identical, the
+ *          conversion kernels are checked on random data as well.
+ *
+ *          Exit code is 0 if all results matched, 1 otherwise.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ebase/types.h>
+#include <common/return_codes.h>
+
+#include "som_ctrl_conv.h"
+#include "som_ctrl_writer.h"
+
+#define BENCH_DEF_FRAMES    10
+#define BENCH_DEF_WIDTH     2592
+#define BENCH_DEF_HEIGHT    1944
+#define BENCH_DEF_PAD       64          /**< line stuffing in bytes */
+#define BENCH_SOURCES       4           /**< frames cycled through */
+#define BENCH_HEADER_MAX    256
+
+typedef enum BenchFormat_e
+{
+    BENCH_RAW8      = 0,
+    BENCH_RAW16     = 1,
+    BENCH_YUV422    = 2,
+    BENCH_RGB       = 3,
+    BENCH_FORMATS
+} BenchFormat_t;
+
+static const char *FormatName[BENCH_FORMATS] = { "raw8 pgm", "raw16 pgm", "yuv422 pgm", "yuv422->rgb ppm" };
+static const char *FormatTag[BENCH_FORMATS]  = { "raw8", "raw16", "yuv", "rgb" };
+
+/* one frame in memory: raw plane, or luma and chroma plane */
+typedef struct BenchFrame_s
+{
+    uint8_t     *pY;
+    uint8_t     *pCbCr;
+    uint32_t    LineSize;       /**< bytes of pixel data per line */
+    uint32_t    Stride;
+} BenchFrame_t;
+
+static uint32_t seed = 1U;
+static int width  = BENCH_DEF_WIDTH;
+static int height = BENCH_DEF_HEIGHT;
+static int pad    = BENCH_DEF_PAD;
+static const char *dir = ".";
+
+static uint8_t rand8( void )
+{
+    seed = seed * 1103515245U + 12345U;
+    return ( (uint8_t)( seed >> 16 ) );
+}
+
+static long long now_us( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000 );
+}
+
+static void usage( const char *name )
+{
+    printf( "usage: %s [-n frames] [-w width] [-h height] [-p line stuffing] [-d dir] [-k] [-s seed]\n", name );
+}
+
+static void file_name( char *name, size_t size, const int format, const char *what, const int frame )
+{
+    snprintf( name, size, "%s/som_bench_%s_%s_%04d.%s", dir, FormatTag[format], what, frame,
+                ( format == BENCH_RGB ) ? "ppm" : "pgm" );
+}
+
+static int make_frames( BenchFrame_t *pFrames, const int format )
+{
+    const uint32_t line = (uint32_t)width * ( ( format == BENCH_RAW16 ) ? 2U : 1U );
+    uint32_t i, j;
+
+    for ( i = 0U; i < BENCH_SOURCES; i++ )
+    {
+        pFrames[i].LineSize = line;
+        pFrames[i].Stride   = line + (uint32_t)pad;
+        pFrames[i].pY       = malloc( pFrames[i].Stride * height );
+        pFrames[i].pCbCr    = malloc( pFrames[i].Stride * height );
+        if ( ( pFrames[i].pY == NULL ) || ( pFrames[i].pCbCr == NULL ) )
+        {
+            return ( -1 );
+        }
+
+        for ( j = 0U; j < pFrames[i].Stride * height; j++ )
+        {
+            pFrames[i].pY[j]    = rand8();
+            pFrames[i].pCbCr[j] = rand8();
+        }
+    }
+
+    return ( 0 );
+}
+
+static void free_frames( BenchFrame_t *pFrames )
+{
+    uint32_t i;
+
+    for ( i = 0U; i < BENCH_SOURCES; i++ )
+    {
+        free( pFrames[i].pY );
+        free( pFrames[i].pCbCr );
+    }
+}
+
+static int header( char *buf, const size_t size, const int format )
+{
+    switch ( format )
+    {
+        case BENCH_RAW8:
+        case BENCH_RAW16:
+            return ( snprintf( buf, size,
+                        "P5\n%d %d\n#####<DCT Raw>\n#<Type>%u</Type>\n#<Layout>%u</Layout>\n#<TimeStampUs>%lli</TimeStampUs>\n#####</DCT Raw>\n%d\n",
+                        width, height, 0U, 0U, 0ll, ( format == BENCH_RAW16 ) ? 65535 : 255 ) );
+        case BENCH_YUV422:
+            return ( snprintf( buf, size, "P5\n%d %d\n255\n", width, 2 * height ) );
+        default:
+            return ( snprintf( buf, size, "P6\n%d %d\n255\n", width, height ) );
+    }
+}
+
+/* plane to file the way the store functions did: one write if there is no
+ * stuffing, one write per line otherwise */
+static int write_plane( FILE *pFile, const uint8_t *pPlane, const BenchFrame_t *pFrame )
+{
+    int y;
+
+    for ( y = 0; y < height; y++ )
+    {
+        if ( 1 != fwrite( pPlane + y * pFrame->Stride, pFrame->LineSize, 1, pFile ) )
+        {
+            return ( -1 );
+        }
+    }
+
+    return ( 0 );
+}
+
+static int store_before( const BenchFrame_t *pFrame, const int format, const int frame )
+{
+    const uint32_t size = pFrame->Stride * height;
+    char name[FILENAME_MAX];
+    char head[BENCH_HEADER_MAX];
+    uint8_t *pLocBuf;
+    FILE *pFile;
+    int err = 0;
+
+    file_name( name, sizeof(name), format, "before", frame );
+    pFile = fopen( name, "wb" );
+    if ( pFile == NULL )
+    {
+        return ( -1 );
+    }
+
+    // local buffer per picture, planes read into it
+    pLocBuf = malloc( 2 * size );
+    if ( pLocBuf == NULL )
+    {
+        fclose( pFile );
+        return ( -1 );
+    }
+    memcpy( pLocBuf, pFrame->pY, size );
+    if ( format >= BENCH_YUV422 )
+    {
+        memcpy( pLocBuf + size, pFrame->pCbCr, size );
+    }
+
+    header( head, sizeof(head), format );
+    fprintf( pFile, "%s", head );
+
+    if ( format != BENCH_RGB )
+    {
+        err |= write_plane( pFile, pLocBuf, pFrame );
+        if ( format == BENCH_YUV422 )
+        {
+            err |= write_plane( pFile, pLocBuf + size, pFrame );
+        }
+    }
+    else
+    {
+        uint8_t *pYCbCr444 = malloc( 3 * width * height );
+        if ( pYCbCr444 == NULL )
+        {
+            err = -1;
+        }
+        else
+        {
+            somCtrlConvYCbCr422SemiToRgbRef( pYCbCr444, pLocBuf, pFrame->Stride, pLocBuf + size, pFrame->Stride, width, height );
+            if ( 1 != fwrite( pYCbCr444, 3 * width * height, 1, pFile ) )
+            {
+                err = -1;
+            }
+            free( pYCbCr444 );
+        }
+    }
+
+    free( pLocBuf );
+
+    if ( fclose( pFile ) != 0 )
+    {
+        err = -1;
+    }
+
+    return ( err );
+}
+
+static void pack_plane( uint8_t *pDst, const uint8_t *pPlane, const BenchFrame_t *pFrame )
+{
+    int y;
+
+    for ( y = 0; y < height; y++ )
+    {
+        memcpy( pDst + y * pFrame->LineSize, pPlane + y * pFrame->Stride, pFrame->LineSize );
+    }
+}
+
+static int store_writer( somCtrlWriter_t *pWriter, const BenchFrame_t *pFrame, const int format, const int frame )
+{
+    const uint32_t plane = pFrame->LineSize * height;
+    char name[FILENAME_MAX];
+    somCtrlWriteBuf_t *pBuf;
+    uint32_t length;
+    FILE *pFile;
+
+    file_name( name, sizeof(name), format, "writer", frame );
+    pFile = fopen( name, "wb" );
+    if ( pFile == NULL )
+    {
+        return ( -1 );
+    }
+
+    if ( RET_SUCCESS != somCtrlWriterGetBuffer( pWriter, BENCH_HEADER_MAX + 3 * plane, &pBuf ) )
+    {
+        fclose( pFile );
+        return ( -1 );
+    }
+
+    length = (uint32_t)header( (char *)pBuf->pData, BENCH_HEADER_MAX, format );
+
+    switch ( format )
+    {
+        case BENCH_RAW8:
+        case BENCH_RAW16:
+            pack_plane( pBuf->pData + length, pFrame->pY, pFrame );
+            length += plane;
+            break;
+        case BENCH_YUV422:
+            pack_plane( pBuf->pData + length, pFrame->pY, pFrame );
+            pack_plane( pBuf->pData + length + plane, pFrame->pCbCr, pFrame );
+            length += 2 * plane;
+            break;
+        default:
+            somCtrlConvYCbCr422SemiToRgb( pBuf->pData + length, pFrame->pY, pFrame->Stride, pFrame->pCbCr, pFrame->Stride, width, height );
+            length += 3 * plane;
+            break;
+    }
+
+    if ( RET_SUCCESS != somCtrlWriterQueue( pWriter, pBuf, length, pFile ) )
+    {
+        return ( -1 );
+    }
+
+    return ( ( RET_SUCCESS == somCtrlWriterClose( pWriter, pFile ) ) ? 0 : -1 );
+}
+
+static long compare_files( const int format, const int frames, const int keep )
+{
+    char a[FILENAME_MAX], b[FILENAME_MAX];
+    long errors = 0;
+    int i;
+
+    for ( i = 0; i < frames; i++ )
+    {
+        FILE *fa, *fb;
+        int ca, cb;
+
+        file_name( a, sizeof(a), format, "before", i );
+        file_name( b, sizeof(b), format, "writer", i );
+
+        fa = fopen( a, "rb" );
+        fb = fopen( b, "rb" );
+        if ( ( fa == NULL ) || ( fb == NULL ) )
+        {
+            errors++;
+        }
+        else
+        {
+            do
+            {
+                ca = fgetc( fa );
+                cb = fgetc( fb );
+            }
+            while ( ( ca == cb ) && ( ca != EOF ) );
+
+            if ( ca != cb )
+            {
+                if ( errors++ < 10 )
+                {
+                    printf( "%s: %s and %s differ\n", FormatName[format], a, b );
+                }
+            }
+        }
+
+        if ( fa != NULL )
+        {
+            fclose( fa );
+        }
+        if ( fb != NULL )
+        {
+            fclose( fb );
+        }
+
+        if ( !keep )
+        {
+            unlink( a );
+            unlink( b );
+        }
+    }
+
+    return ( errors );
+}
+
+/* odd strides and every value of all components at least once */
+static long check_conv( void )
+{
+    enum { W = 1000, H = 9, YS = 1013, CS = 1007 };
+    static uint8_t y[YS * H], c[CS * H];
+    static uint8_t ref[3 * W * H], out[3 * W * H];
+    long errors = 0;
+    uint32_t i, w;
+
+    for ( i = 0U; i < sizeof(y); i++ )
+    {
+        y[i] = rand8();
+    }
+    for ( i = 0U; i < sizeof(c); i++ )
+    {
+        c[i] = ( i < 512U ) ? (uint8_t)( i >> 1 ) : rand8();
+    }
+    for ( i = 0U; i < 256U; i++ )
+    {
+        y[i] = (uint8_t)i;
+    }
+
+    // full width and widths with tails for the vector loop
+    for ( w = W; w > W - 32U; w -= 2U )
+    {
+        memset( ref, 0, sizeof(ref) );
+        memset( out, 0, sizeof(out) );
+        somCtrlConvYCbCr422SemiToRgbRef( ref, y, YS, c, CS, w, H );
+        somCtrlConvYCbCr422SemiToRgb( out, y, YS, c, CS, w, H );
+
+        for ( i = 0U; i < 3U * w * H; i++ )
+        {
+            if ( ref[i] != out[i] )
+            {
+                if ( errors++ < 10 )
+                {
+                    printf( "conv width %u: byte %u is %u, reference %u\n", w, i, out[i], ref[i] );
+                }
+            }
+        }
+    }
+
+    return ( errors );
+}
+
+int main( int argc, char **argv )
+{
+    static BenchFrame_t frames[BENCH_SOURCES];
+    static somCtrlWriter_t writer;
+    int n = BENCH_DEF_FRAMES;
+    int keep = 0;
+    long errors;
+    int opt, format, i;
+
+    while ( ( opt = getopt( argc, argv, "n:w:h:p:d:ks:" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                n = atoi( optarg );
+                break;
+            case 'w':
+                width = atoi( optarg ) & ~1;
+                break;
+            case 'h':
+                height = atoi( optarg );
+                break;
+            case 'p':
+                pad = atoi( optarg );
+                break;
+            case 'd':
+                dir = optarg;
+                break;
+            case 'k':
+                keep = 1;
+                break;
+            case 's':
+                seed = (uint32_t)strtoul( optarg, NULL, 0 );
+                break;
+            default:
+                usage( argv[0] );
+                return ( 0 );
+        }
+    }
+    if ( ( n < 1 ) || ( width < 2 ) || ( height < 1 ) || ( pad < 0 ) )
+    {
+        usage( argv[0] );
+        return ( 1 );
+    }
+
+    errors = check_conv();
+
+    if ( RET_SUCCESS != somCtrlWriterCreate( &writer ) )
+    {
+        printf( "creating writer failed\n" );
+        return ( 1 );
+    }
+
+#ifdef SOM_CTRL_CONV_NEON
+    printf( "%d pictures of %dx%d, %d bytes line stuffing, conversion: neon\n", n, width, height, pad );
+#else
+    printf( "%d pictures of %dx%d, %d bytes line stuffing, conversion: portable\n", n, width, height, pad );
+#endif
+    printf( "%-16s %14s %14s %10s %10s\n", "", "before ms/pic", "writer ms/pic", "before MB/s", "writer MB/s" );
+
+    for ( format = 0; format < BENCH_FORMATS; format++ )
+    {
+        const double mb = (double)n * width * height * ( ( format == BENCH_RAW8 ) ? 1 : ( format == BENCH_RGB ) ? 3 : 2 ) / 1e6;
+        long long t0, tBefore, tBusy, tWriter;
+        int fail = 0;
+
+        if ( make_frames( frames, format ) != 0 )
+        {
+            printf( "out of memory\n" );
+            return ( 1 );
+        }
+
+        t0 = now_us();
+        for ( i = 0; i < n; i++ )
+        {
+            fail |= store_before( &frames[i % BENCH_SOURCES], format, i );
+        }
+        tBefore = now_us() - t0;
+
+        t0 = now_us();
+        for ( i = 0; i < n; i++ )
+        {
+            fail |= store_writer( &writer, &frames[i % BENCH_SOURCES], format, i );
+        }
+        tBusy = now_us() - t0;
+        if ( RET_SUCCESS != somCtrlWriterSync( &writer, BOOL_TRUE ) )
+        {
+            fail = 1;
+        }
+        tWriter = now_us() - t0;
+
+        printf( "%-16s %14.2f %14.2f %10.1f %10.1f\n", FormatName[format],
+                tBefore / 1000.0 / n, tBusy / 1000.0 / n, mb * 1e6 / tBefore, mb * 1e6 / tWriter );
+
+        if ( fail )
+        {
+            printf( "%s: writing files in %s failed\n", FormatName[format], dir );
+            errors++;
+        }
+        errors += compare_files( format, n, keep );
+
+        free_frames( frames );
+    }
+
+    somCtrlWriterDestroy( &writer );
+
+    printf( "%ld mismatches\n", errors );
+
+    return ( ( errors == 0 ) ? 0 : 1 );
+}
@@ -41,6 +41,7 @@
 //#include <libexif/exif-data.h>
 
 #include "som_ctrl.h"
+#include "som_ctrl_conv.h"
 
 /******************************************************************************
  * local macro definitions
@@ -49,6 +50,8 @@
 CREATE_TRACER(SOM_CTRL_INFO , "SOM-CTRL: ", INFO,  0);
 CREATE_TRACER(SOM_CTRL_ERROR, "SOM-CTRL: ", ERROR, 1);
 
+#define SOM_CTRL_HEADER_MAX     256U    //!< room for a pgm/ppm header in front of the picture
+
 /******************************************************************************
  * local type definitions
  *****************************************************************************/
@@ -198,12 +201,16 @@ static RESULT somCtrlStoreBufferYUV422Semi
 );
 
 /******************************************************************************
- * ConvertYCbCr444combToRGBcomb()
+ * somCtrlPackPlane()
  *****************************************************************************/
-static void ConvertYCbCr444combToRGBcomb
+static RESULT somCtrlPackPlane
 (
-    uint8_t     *pYCbCr444,
-    uint32_t    PlaneSizePixel
+    somCtrlContext_t    *pSomContext,
+    uint8_t             *pDst,
+    ulong_t             Address,
+    uint32_t            LineSize,
+    uint32_t            Stride,
+    uint32_t            Lines
 );
 
 /******************************************************************************
@@ -259,10 +266,22 @@ RESULT somCtrlCreate
         return ( RET_FAILURE );
     }
 
+    // create file writer
+    result = somCtrlWriterCreate( &pSomContext->Writer );
+    if (result != RET_SUCCESS)
+    {
+        TRACE(SOM_CTRL_ERROR, "%s (creating file writer failed)\n", __FUNCTION__);
+        osQueueDestroy( &pSomContext->FullBufQueue );
+        osQueueDestroy( &pSomContext->CommandQueue );
+        HalDelRef( pSomContext->HalHandle );
+        return ( result );
+    }
+
     // create handler thread
     if ( OSLAYER_OK != osThreadCreate( &pSomContext->Thread, somCtrlThreadHandler, pSomContext ) )
     {
         TRACE(SOM_CTRL_ERROR, "%s (creating handler thread failed)\n", __FUNCTION__);
+        somCtrlWriterDestroy( &pSomContext->Writer );
         osQueueDestroy( &pSomContext->FullBufQueue );
         osQueueDestroy( &pSomContext->CommandQueue );
         HalDelRef( pSomContext->HalHandle );
@@ -338,6 +357,14 @@ RESULT somCtrlDestroy
         }
     } while (osStatus == OSLAYER_OK);
 
+    // destroy file writer
+    lres = somCtrlWriterDestroy( &pSomContext->Writer );
+    if (lres != RET_SUCCESS)
+    {
+        TRACE(SOM_CTRL_ERROR, "%s (destroying file writer failed)\n", __FUNCTION__);
+        UPDATE_RESULT( result, lres);
+    }
+
     // destroy full buffer queue
     if ( OSLAYER_OK != osQueueDestroy( &pSomContext->FullBufQueue ) )
     {
@@ -548,8 +575,9 @@ static int32_t somCtrlThreadHandler
                     {
                         case eSomCtrlStateRunning:
                         {
-                            // finalize capture
+                            // finalize capture, files are complete once the writer is through
                             somCtrlStoreBufferStop( pSomContext );
+                            somCtrlWriterSync( &pSomContext->Writer, BOOL_TRUE );
 
                             // prepare completion info & complete pending start command
                             somCtrlCompletionInfo_t Info;
@@ -662,8 +690,9 @@ static int32_t somCtrlThreadHandler
                                     // stop if no more buffers to capture or last buffer or capture error
                                     if ( (++pSomContext->FramesCaptured == pSomContext->NumOfFrames) || (pBuffer->last) || (result != RET_SUCCESS) )
                                     {
-                                        // finalize capture
-                                        somCtrlStoreBufferStop( pSomContext );
+                                        // finalize capture, files are complete once the writer is through
+                                        UPDATE_RESULT( result, somCtrlStoreBufferStop( pSomContext ) );
+                                        UPDATE_RESULT( result, somCtrlWriterSync( &pSomContext->Writer, BOOL_TRUE ) );
 
                                         // prepare completion info & complete pending start command
                                         somCtrlCompletionInfo_t Info;
@@ -1318,13 +1347,13 @@ static RESULT somCtrlStoreBufferStop
             }
         }
 
-        // close file
-        fclose( pSomContext->pFile );
+        // close file after everything queued for it
+        UPDATE_RESULT( result, somCtrlWriterClose( &pSomContext->Writer, pSomContext->pFile ) );
         pSomContext->pFile = NULL;
 
         if(pSomContext->pFileRight)
         {
-            fclose( pSomContext->pFileRight );
+            UPDATE_RESULT( result, somCtrlWriterClose( &pSomContext->Writer, pSomContext->pFileRight ) );
             pSomContext->pFileRight = NULL;
         }
     }
@@ -1381,13 +1410,6 @@ static RESULT somCtrlStoreBufferRAW
     }
     // note: implementation assumes that on-board memory is used for buffers!
 
-    // allocate local buffer
-    uint8_t *pLocBuf = malloc(MAX_ALIGNED_SIZE(pBuffer->baseSize, pPicBufMetaData->Align));
-    if (pLocBuf == NULL)
-    {
-        return RET_OUTOFMEM;
-    }
-
     // need to allocate memory for summing up frames?
     if ( pSomContext->AverageFrames && (pSomContext->pAveragedData == NULL) )
     {
@@ -1395,100 +1417,92 @@ static RESULT somCtrlStoreBufferRAW
         pSomContext->pAveragedData = malloc( bufferSize );
         if ( pSomContext->pAveragedData == NULL )
         {
-            free( pLocBuf );
             return RET_OUTOFMEM;
         }
+        memset( pSomContext->pAveragedData, 0, bufferSize );
     }
 
-    // get base address & size of local plane
+    // get size of raw plane
     uint32_t RawPlaneSize = pPicBufMetaData->Data.raw.PicWidthBytes * pPicBufMetaData->Data.raw.PicHeightPixel;
-    uint8_t *pRawTmp, *pRawBase;
-    pRawTmp = pRawBase = (uint8_t *) ALIGN_UP( ((ulong_t)(pLocBuf)), pPicBufMetaData->Align);
-
-    // get raw plane from on-board memory
-    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.raw.pBuffer), pRawBase, RawPlaneSize );
-    UPDATE_RESULT( result, lres );
+    uint32_t RawLineSize  = pPicBufMetaData->Data.raw.PicWidthPixel * (is16bit ? 2 : 1);
 
     if ( !pSomContext->AverageFrames )
     {
         // write out raw image; no matter what pSomContext->ForceRGBOut requests
+        somCtrlWriteBuf_t *pBuf = NULL;
+        uint32_t Length;
+
+        lres = somCtrlWriterGetBuffer( &pSomContext->Writer, SOM_CTRL_HEADER_MAX + RawLineSize * pPicBufMetaData->Data.raw.PicHeightPixel, &pBuf );
+        if (lres != RET_SUCCESS)
+        {
+            return lres;
+        }
 
-        // write pgm header
-        fprintf( pFile,
+        // pgm header
+        Length = snprintf( (char *)pBuf->pData, SOM_CTRL_HEADER_MAX,
                 "%sP5\n%d %d\n#####<DCT Raw>\n#<Type>%u</Type>\n#<Layout>%u</Layout>\n#<TimeStampUs>%lli</TimeStampUs>\n#####</DCT Raw>\n%d\n",
                 putHeader ? "" : "\n", pPicBufMetaData->Data.raw.PicWidthPixel, pPicBufMetaData->Data.raw.PicHeightPixel,
                         pPicBufMetaData->Type, pPicBufMetaData->Layout, pPicBufMetaData->TimeStampUs, is16bit ? 65535 : 255 );
 
-        // write raw plane to file
-        if ( (pPicBufMetaData->Data.raw.PicWidthPixel * (is16bit ? 2 : 1)) == pPicBufMetaData->Data.raw.PicWidthBytes )
+        // raw plane from on-board memory, trailing gaps removed from lines
+        lres = somCtrlPackPlane( pSomContext, pBuf->pData + Length, (ulong_t)(pPicBufMetaData->Data.raw.pBuffer),
+                                    RawLineSize, pPicBufMetaData->Data.raw.PicWidthBytes, pPicBufMetaData->Data.raw.PicHeightPixel );
+        if (lres != RET_SUCCESS)
         {
-            // a single write will do
-            if ( 1 != fwrite( pRawBase, RawPlaneSize, 1, pFile ) )
-            {
-                UPDATE_RESULT( result, RET_FAILURE );
-            }
-        }
-        else
-        {
-            // remove trailing gaps from lines
-            uint32_t y;
-            for (y=0; y < pPicBufMetaData->Data.raw.PicHeightPixel; y++)
-            {
-                if ( 1 != fwrite( pRawTmp, (pPicBufMetaData->Data.raw.PicWidthPixel * (is16bit ? 2 : 1)), 1, pFile ) )
-                {
-                    UPDATE_RESULT( result, RET_FAILURE );
-                    break; // for loop
-                }
-                pRawTmp += pPicBufMetaData->Data.raw.PicWidthBytes;
-            }
+            somCtrlWriterPutBuffer( &pSomContext->Writer, pBuf );
+            return lres;
         }
+        Length += RawLineSize * pPicBufMetaData->Data.raw.PicHeightPixel;
+
+        // and off to the writer
+        lres = somCtrlWriterQueue( &pSomContext->Writer, pBuf, Length, pFile );
+        UPDATE_RESULT( result, lres );
     }
     else
     {
-        // update average data
+        // update average data, straight from on-board memory
+        uint8_t *pRawTmp = NULL;
 
-        if ( pSomContext->pAveragedData == NULL )
+        lres = HalMapMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.raw.pBuffer), RawPlaneSize, HAL_MAPMEM_READONLY, (void **)&pRawTmp );
+        if (lres != RET_SUCCESS)
         {
-            TRACE(SOM_CTRL_ERROR, "%s pSomContext->pAveragedData == NULL\n", __FUNCTION__);
-            UPDATE_RESULT( result, RET_NULL_POINTER );
+            return lres;
         }
-        else
+        uint8_t *pRawBase = pRawTmp;
+
+        // remove trailing gaps from lines
+        uint32_t x,y;
+        uint32_t *pRawAveragedTmp = (uint32_t*)(pSomContext->pAveragedData);
+        for (y=0; y < pPicBufMetaData->Data.raw.PicHeightPixel; y++)
         {
-            // remove trailing gaps from lines
-            uint32_t x,y;
-            uint32_t *pRawAveragedTmp = (uint32_t*)(pSomContext->pAveragedData);
-            for (y=0; y < pPicBufMetaData->Data.raw.PicHeightPixel; y++)
+            if ( is16bit )
             {
-                if ( is16bit )
+                uint16_t *pRawLine = (uint16_t*)pRawTmp;
+                for (x=0; x < pPicBufMetaData->Data.raw.PicWidthPixel; x++)
                 {
-                    uint16_t *pRawLine = (uint16_t*)pRawTmp;
-                    for (x=0; x < pPicBufMetaData->Data.raw.PicWidthPixel; x++)
-                    {
-                        *pRawAveragedTmp += somCtrlSwapUInt16( *pRawLine );
-                        pRawAveragedTmp++;
-                        pRawLine++;
-                    }
+                    *pRawAveragedTmp += somCtrlSwapUInt16( *pRawLine );
+                    pRawAveragedTmp++;
+                    pRawLine++;
                 }
-                else
+            }
+            else
+            {
+                uint8_t *pRawLine = pRawTmp;
+                for (x=0; x < pPicBufMetaData->Data.raw.PicWidthPixel; x++)
                 {
-                    uint8_t *pRawLine = pRawTmp;
-                    for (x=0; x < pPicBufMetaData->Data.raw.PicWidthPixel; x++)
-                    {
-                        *pRawAveragedTmp += *pRawLine;
-                        pRawAveragedTmp++;
-                        pRawLine++;
-                    }
+                    *pRawAveragedTmp += *pRawLine;
+                    pRawAveragedTmp++;
+                    pRawLine++;
                 }
-
-                pRawTmp += pPicBufMetaData->Data.raw.PicWidthBytes;
             }
+
+            pRawTmp += pPicBufMetaData->Data.raw.PicWidthBytes;
         }
 
+        lres = HalUnMapMemory( pSomContext->HalHandle, pRawBase );
+        UPDATE_RESULT( result, lres );
     }
 
-    // free local buffer
-    free( pLocBuf );
-
     TRACE(SOM_CTRL_INFO, "%s (exit)\n", __FUNCTION__);
 
     return result;
@@ -1527,47 +1541,57 @@ static RESULT somCtrlFlushAverageBufferRAW
         return RET_NULL_POINTER;
     }
 
+    uint32_t RawAveragedPlaneSize = pSomContext->CurrentPicWidth * pSomContext->CurrentPicHeight;
+    somCtrlWriteBuf_t *pBuf = NULL;
+    uint32_t Length;
+
+    lres = somCtrlWriterGetBuffer( &pSomContext->Writer, SOM_CTRL_HEADER_MAX + RawAveragedPlaneSize * (is16bit ? 2 : 1), &pBuf );
+    if (lres != RET_SUCCESS)
+    {
+        return lres;
+    }
+
+    // pgm header
+    Length = snprintf( (char *)pBuf->pData, SOM_CTRL_HEADER_MAX,
+            "%sP5\n%d %d\n#####<DCT Raw>\n#<Type>%u</Type>\n#<Layout>%u</Layout>\n#<TimeStampUs>%lli</TimeStampUs>\n#####</DCT Raw>\n%d\n",
+            putHeader ? "" : "\n", pSomContext->CurrentPicWidth, pSomContext->CurrentPicHeight,
+                    pSomContext->CurrentPicType, pSomContext->CurrentPicLayout, -1ll, is16bit ? 65535 : 255 );
+
     // finalize average calculation
-    // includes in place pixel data width reduction as well
+    // includes pixel data width reduction as well
     uint32_t i = 0;
-    uint32_t RawAveragedPlaneSize = pSomContext->CurrentPicWidth * pSomContext->CurrentPicHeight;
     uint32_t *pAveragedDataTmp = pSomContext->pAveragedData;
     if ( is16bit )
     {
-        uint16_t *pRawDataTmp = (uint16_t*)pAveragedDataTmp;
+        uint16_t RawData;
+        uint8_t *pRawDataTmp = pBuf->pData + Length;
         for(i=0; i < RawAveragedPlaneSize; i++)
         {
-            *pRawDataTmp++ = somCtrlSwapUInt16( *pAveragedDataTmp++ / pSomContext->FramesCaptured );
+            RawData = somCtrlSwapUInt16( *pAveragedDataTmp++ / pSomContext->FramesCaptured );
+            memcpy( pRawDataTmp, &RawData, sizeof(RawData) ); // header may leave it unaligned
+            pRawDataTmp += sizeof(RawData);
         }
     }
     else
     {
-        uint8_t *pRawDataTmp = (uint8_t*)pAveragedDataTmp;
+        uint8_t *pRawDataTmp = pBuf->pData + Length;
         for(i=0; i < RawAveragedPlaneSize; i++)
         {
             *pRawDataTmp++ = *pAveragedDataTmp++ / pSomContext->FramesCaptured;
         }
     }
+    Length += RawAveragedPlaneSize * (is16bit ? 2 : 1);
 
-    // write pgm header
-    fprintf( pFile,
-            "%sP5\n%d %d\n#####<DCT Raw>\n#<Type>%u</Type>\n#<Layout>%u</Layout>\n#<TimeStampUs>%lli</TimeStampUs>\n#####</DCT Raw>\n%d\n",
-            putHeader ? "" : "\n", pSomContext->CurrentPicWidth, pSomContext->CurrentPicHeight,
-                    pSomContext->CurrentPicType, pSomContext->CurrentPicLayout, -1ll, is16bit ? 65535 : 255 );
-
-
-    // write raw plane to file
-    // a single write will do
-    if ( 1 != fwrite( pSomContext->pAveragedData, RawAveragedPlaneSize * (is16bit ? 2 : 1), 1, pFile ) )
-    {
-        UPDATE_RESULT( result, RET_FAILURE );
-    }
+    // and off to the writer
+    lres = somCtrlWriterQueue( &pSomContext->Writer, pBuf, Length, pFile );
+    UPDATE_RESULT( result, lres );
 
     TRACE(SOM_CTRL_INFO, "%s (exit)\n", __FUNCTION__);
 
     return result;
 }
 
+
 /******************************************************************************
  * init_tag()
  * Get an existing tag, or create one if it doesn't exist
@@ -1819,48 +1843,48 @@ static RESULT somCtrlStoreBufferJpeg
         return RET_NULL_POINTER;
     }
 
-    // allocate local buffer
-    uint8_t *pLocBuf = malloc(MAX_ALIGNED_SIZE(pBuffer->baseSize, pPicBufMetaData->Align));
-    if (pLocBuf == NULL)
-    {
-        return RET_OUTOFMEM;
-    }
-
-    // get base address & size of local plane
     uint32_t DataSize = pPicBufMetaData->Data.jpeg.DataSize;
-    uint32_t RawPlaneSize = ALIGN_UP( DataSize, 8 );
-    uint8_t *pRawTmp, *pRawBase;
-    pRawTmp = pRawBase = (uint8_t *) ALIGN_UP( ((ulong_t)(pLocBuf)), pPicBufMetaData->Align);
-
-    // get raw plane from on-board memory
-    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)( pPicBufMetaData->Data.jpeg.pData), pRawBase, RawPlaneSize );
-    UPDATE_RESULT( result, lres );
+    uint32_t DataOffset = 0;
 
     if ( putHeader && pSomContext->ExifHeader )
     {
         /* start of JPEG image data section */
         static const unsigned int image_data_offset = 20;
 
+        // the exif header goes straight into the file, behind everything queued
+        lres = somCtrlWriterSync( &pSomContext->Writer, BOOL_FALSE );
+        UPDATE_RESULT( result, lres );
+
         lres = somGenExifHeader( pSomContext, pFile, pBuffer );
         UPDATE_RESULT( result, lres );
 
         // skip JFIF header here, replaced by exif header
-        if ( 1 != fwrite( pRawBase + image_data_offset, (DataSize - image_data_offset), 1, pFile ) )
-        {
-            UPDATE_RESULT( result, RET_FAILURE );
-        }
+        DataOffset = image_data_offset;
     }
-    else
+
+    if (result != RET_SUCCESS)
     {
-        // a single write will do
-        if ( 1 != fwrite( pRawBase, DataSize, 1, pFile ) )
-        {
-            UPDATE_RESULT( result, RET_FAILURE );
-        }
+        return result;
+    }
+
+    somCtrlWriteBuf_t *pBuf = NULL;
+    lres = somCtrlWriterGetBuffer( &pSomContext->Writer, DataSize - DataOffset, &pBuf );
+    if (lres != RET_SUCCESS)
+    {
+        return lres;
+    }
+
+    // get jpeg data from on-board memory
+    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.jpeg.pData) + DataOffset, pBuf->pData, DataSize - DataOffset );
+    if (lres != RET_SUCCESS)
+    {
+        somCtrlWriterPutBuffer( &pSomContext->Writer, pBuf );
+        return lres;
     }
 
-    // free local buffer
-    free( pLocBuf );
+    // and off to the writer
+    lres = somCtrlWriterQueue( &pSomContext->Writer, pBuf, DataSize - DataOffset, pFile );
+    UPDATE_RESULT( result, lres );
 
     TRACE(SOM_CTRL_INFO, "%s (exit)\n", __FUNCTION__);
 
@@ -1879,163 +1903,8 @@ static RESULT somCtrlStoreBufferYUV444Planar
     bool_t              putHeader
 )
 {
-    RESULT result = RET_SUCCESS;
-    RESULT lres;
-
-    TRACE(SOM_CTRL_INFO, "%s (enter)\n", __FUNCTION__);
-
-    if (!pSomContext)
-    {
-        return RET_NULL_POINTER;
-    }
-
-    if (!pFile)
-    {
-        return RET_NULL_POINTER;
-    }
-
-    // get & check buffer meta data
-    PicBufMetaData_t *pPicBufMetaData = (PicBufMetaData_t *)(pBuffer->pMetaData);
-    if (pPicBufMetaData == NULL)
-    {
-        return RET_NULL_POINTER;
-    }
-    // note: implementation assumes that on-board memory is used for buffers!
-
-    // allocate local buffer
-    uint8_t *pLocBuf = malloc(MAX_ALIGNED_SIZE(pBuffer->baseSize, pPicBufMetaData->Align));
-    if (pLocBuf == NULL)
-    {
-        return RET_OUTOFMEM;
-    }
-
-    // get base addresses & sizes of local planes
-    uint32_t YCPlaneSize = pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes * pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel;
-    uint8_t *pYTmp, *pYBase, *pCbCrTmp, *pCbCrBase;
-    pYTmp    = pYBase    = (uint8_t *) ALIGN_UP( ((ulong_t)(pLocBuf)),              pPicBufMetaData->Align); // pPicBufMetaData->Data.YCbCr.semiplanar.Y.pBuffer;
-    pCbCrTmp = pCbCrBase = (uint8_t *) ALIGN_UP( ((ulong_t)(pYTmp)) + YCPlaneSize , pPicBufMetaData->Align); // pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.pBuffer;
-
-    // get luma plane from on-board memory
-    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.YCbCr.semiplanar.Y.pBuffer),    pYBase,    YCPlaneSize );
-    UPDATE_RESULT( result, lres );
-
-    // get combined chroma plane from on-board memory
-    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.pBuffer), pCbCrBase, YCPlaneSize );
-    UPDATE_RESULT( result, lres );
-
-    // write out raw or RGB image?
-    if (!pSomContext->ForceRGBOut)
-    {
-        // write pgm header
-        fprintf( pFile, "%sP5\n%d %d\n255\n", putHeader ? "" : "\n", pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel, 2 * pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel );
-
-        // write luma plane to file
-        if ( pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel == pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes )
-        {
-            // a single write will do
-            if ( 1 != fwrite( pYBase, YCPlaneSize, 1, pFile ) )
-            {
-                UPDATE_RESULT( result, RET_FAILURE );
-            }
-        }
-        else
-        {
-            // remove trailing gaps from lines
-            uint32_t y;
-            for (y=0; y < pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel; y++)
-            {
-                if ( 1 != fwrite( pYTmp, pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel, 1, pFile ) )
-                {
-                    UPDATE_RESULT( result, RET_FAILURE );
-                    break; // for loop
-                }
-                pYTmp += pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes;
-            }
-        }
-
-        // write combined chroma plane to file
-        if ( pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthPixel == pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthBytes )
-        {
-            // a single write will do
-            if ( 1 != fwrite( pCbCrBase, YCPlaneSize, 1, pFile ) )
-            {
-                UPDATE_RESULT( result, RET_FAILURE );
-            }
-        }
-        else
-        {
-            // remove trailing gaps from lines
-            uint32_t y;
-            for (y=0; y < pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicHeightPixel; y++)
-            {
-                if ( 1 != fwrite( pCbCrTmp, pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthPixel, 1, pFile ) )
-                {
-                    UPDATE_RESULT( result, RET_FAILURE );
-                    break; // for loop
-                }
-                pCbCrTmp += pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthBytes;
-            }
-        }
-    }
-    else
-    {
-        // we need a temporary helper buffer capable of holding 3 times the YPlane size (upscaled to 4:4:4 by pixel replication)
-        uint8_t *pYCbCr444 = malloc(3*YCPlaneSize);
-        if (pYCbCr444 == NULL)
-        {
-            UPDATE_RESULT( result, RET_OUTOFMEM );
-        }
-        else
-        {
-            // upscale and combine each 4:2:2 pixel to 4:4:4 while removing any gaps at line ends as well
-            uint8_t *pYCbCr444Tmp = pYCbCr444;
-            uint32_t x,y;
-            for (y=0; y < pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel; y++)
-            {
-                // get line starts
-                uint8_t *pY = pYTmp;
-                uint8_t *pC = pCbCrTmp;
-
-                // walk through line
-                for (x=0; x < pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel; x+=2)
-                {
-                    uint8_t Cb, Cr;
-                    *pYCbCr444Tmp++ = *pY++;
-                    *pYCbCr444Tmp++ = Cb = *pC++;
-                    *pYCbCr444Tmp++ = Cr = *pC++;
-                    *pYCbCr444Tmp++ = *pY++;
-                    *pYCbCr444Tmp++ = Cb;
-                    *pYCbCr444Tmp++ = Cr;
-                }
-
-                // update line starts
-                pYTmp    += pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes;
-                pCbCrTmp += pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthBytes;
-            }
-
-            // inplace convert consecutive YCbCr444 to RGB; both are combined color component planes
-            ConvertYCbCr444combToRGBcomb( pYCbCr444, YCPlaneSize );
-
-            // write ppm header
-            fprintf( pFile, "%sP6\n%d %d\n255\n", putHeader ? "" : "", pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel, pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel );
-
-            // finally write result
-            if ( 1 != fwrite( pYCbCr444, 3 * YCPlaneSize, 1, pFile ) )
-            {
-                UPDATE_RESULT( result, RET_FAILURE );
-            }
-
-            // release helper buffer
-            free(pYCbCr444);
-        }
-    }
-
-    // free local buffer
-    free( pLocBuf );
-
-    TRACE(SOM_CTRL_INFO, "%s (exit)\n", __FUNCTION__);
-
-    return result;
+    // stored like semiplanar 4:2:2 data
+    return somCtrlStoreBufferYUV422Semi( pSomContext, pFile, pBuffer, putHeader );
 }
 
 
@@ -2074,200 +1943,119 @@ static RESULT somCtrlStoreBufferYUV422Semi
     }
     // note: implementation assumes that on-board memory is used for buffers!
 
-    // allocate local buffer
-    uint8_t *pLocBuf = malloc(MAX_ALIGNED_SIZE(pBuffer->baseSize, pPicBufMetaData->Align));
-    if (pLocBuf == NULL)
-    {
-        return RET_OUTOFMEM;
-    }
-
-    // get base addresses & sizes of local planes
-    uint32_t YCPlaneSize = pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes * pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel;
-    uint8_t *pYTmp, *pYBase, *pCbCrTmp, *pCbCrBase;
-    pYTmp    = pYBase    = (uint8_t *) ALIGN_UP( ((ulong_t)(pLocBuf)),              pPicBufMetaData->Align); // pPicBufMetaData->Data.YCbCr.semiplanar.Y.pBuffer;
-    pCbCrTmp = pCbCrBase = (uint8_t *) ALIGN_UP( ((ulong_t)(pYTmp)) + YCPlaneSize , pPicBufMetaData->Align); // pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.pBuffer;
-
-    // get luma plane from on-board memory
-    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.YCbCr.semiplanar.Y.pBuffer),    pYBase,    YCPlaneSize );
-    UPDATE_RESULT( result, lres );
-
-    // get combined chroma plane from on-board memory
-    lres = HalReadMemory( pSomContext->HalHandle, (ulong_t)(pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.pBuffer), pCbCrBase, YCPlaneSize );
-    UPDATE_RESULT( result, lres );
+    PicBufPlane_t *pY    = &pPicBufMetaData->Data.YCbCr.semiplanar.Y;
+    PicBufPlane_t *pCbCr = &pPicBufMetaData->Data.YCbCr.semiplanar.CbCr;
+    somCtrlWriteBuf_t *pBuf = NULL;
+    uint32_t Length;
 
     // write out raw or RGB image?
     if (!pSomContext->ForceRGBOut)
     {
-        // write pgm header
-        fprintf( pFile, "%sP5\n%d %d\n255\n", putHeader ? "" : "\n", pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel, 2 * pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel );
+        uint32_t YSize    = pY->PicWidthPixel * pY->PicHeightPixel;
+        uint32_t CbCrSize = pCbCr->PicWidthPixel * pCbCr->PicHeightPixel;
 
-        // write luma plane to file
-        if ( pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel == pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes )
+        lres = somCtrlWriterGetBuffer( &pSomContext->Writer, SOM_CTRL_HEADER_MAX + YSize + CbCrSize, &pBuf );
+        if (lres != RET_SUCCESS)
         {
-            // a single write will do
-            if ( 1 != fwrite( pYBase, YCPlaneSize, 1, pFile ) )
-            {
-                UPDATE_RESULT( result, RET_FAILURE );
-            }
-        }
-        else
-        {
-            // remove trailing gaps from lines
-            uint32_t y;
-            for (y=0; y < pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel; y++)
-            {
-                if ( 1 != fwrite( pYTmp, pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel, 1, pFile ) )
-                {
-                    UPDATE_RESULT( result, RET_FAILURE );
-                    break; // for loop
-                }
-                pYTmp += pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes;
-            }
+            return lres;
         }
 
-        // write combined chroma plane to file
-        if ( pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthPixel == pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthBytes )
-        {
-            // a single write will do
-            if ( 1 != fwrite( pCbCrBase, YCPlaneSize, 1, pFile ) )
-            {
-                UPDATE_RESULT( result, RET_FAILURE );
-            }
-        }
-        else
-        {
-            // remove trailing gaps from lines
-            uint32_t y;
-            for (y=0; y < pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicHeightPixel; y++)
-            {
-                if ( 1 != fwrite( pCbCrTmp, pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthPixel, 1, pFile ) )
-                {
-                    UPDATE_RESULT( result, RET_FAILURE );
-                    break; // for loop
-                }
-                pCbCrTmp += pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthBytes;
-            }
-        }
+        // pgm header
+        Length = snprintf( (char *)pBuf->pData, SOM_CTRL_HEADER_MAX, "%sP5\n%d %d\n255\n", putHeader ? "" : "\n", pY->PicWidthPixel, 2 * pY->PicHeightPixel );
+
+        // luma plane, then combined chroma plane, from on-board memory with trailing gaps removed from lines
+        lres = somCtrlPackPlane( pSomContext, pBuf->pData + Length, (ulong_t)(pY->pBuffer),
+                                    pY->PicWidthPixel, pY->PicWidthBytes, pY->PicHeightPixel );
+        UPDATE_RESULT( result, lres );
+        Length += YSize;
+
+        lres = somCtrlPackPlane( pSomContext, pBuf->pData + Length, (ulong_t)(pCbCr->pBuffer),
+                                    pCbCr->PicWidthPixel, pCbCr->PicWidthBytes, pCbCr->PicHeightPixel );
+        UPDATE_RESULT( result, lres );
+        Length += CbCrSize;
     }
     else
     {
-        // we need a temporary helper buffer capable of holding 3 times the YPlane size (upscaled to 4:4:4 by pixel replication)
-        uint8_t *pYCbCr444 = malloc(3*YCPlaneSize);
-        if (pYCbCr444 == NULL)
+        uint32_t RgbSize = 3 * pY->PicWidthPixel * pY->PicHeightPixel;
+        uint8_t *pYMapped = NULL;
+        uint8_t *pCbCrMapped = NULL;
+
+        lres = somCtrlWriterGetBuffer( &pSomContext->Writer, SOM_CTRL_HEADER_MAX + RgbSize, &pBuf );
+        if (lres != RET_SUCCESS)
         {
-            UPDATE_RESULT( result, RET_OUTOFMEM );
+            return lres;
         }
-        else
-        {
-            // upscale and combine each 4:2:2 pixel to 4:4:4 while removing any gaps at line ends as well
-            uint8_t *pYCbCr444Tmp = pYCbCr444;
-            uint32_t x,y;
-            for (y=0; y < pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel; y++)
-            {
-                // get line starts
-                uint8_t *pY = pYTmp;
-                uint8_t *pC = pCbCrTmp;
 
-                // walk through line
-                for (x=0; x < pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel; x+=2)
-                {
-                    uint8_t Cb, Cr;
-                    *pYCbCr444Tmp++ = *pY++;
-                    *pYCbCr444Tmp++ = Cb = *pC++;
-                    *pYCbCr444Tmp++ = Cr = *pC++;
-                    *pYCbCr444Tmp++ = *pY++;
-                    *pYCbCr444Tmp++ = Cb;
-                    *pYCbCr444Tmp++ = Cr;
-                }
-
-                // update line starts
-                pYTmp    += pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthBytes;
-                pCbCrTmp += pPicBufMetaData->Data.YCbCr.semiplanar.CbCr.PicWidthBytes;
-            }
+        // ppm header
+        Length = snprintf( (char *)pBuf->pData, SOM_CTRL_HEADER_MAX, "%sP6\n%d %d\n255\n", putHeader ? "" : "", pY->PicWidthPixel, pY->PicHeightPixel );
 
-            // inplace convert consecutive YCbCr444 to RGB; both are combined color component planes
-            ConvertYCbCr444combToRGBcomb( pYCbCr444, YCPlaneSize );
-
-            // write ppm header
-            fprintf( pFile, "%sP6\n%d %d\n255\n", putHeader ? "" : "", pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicWidthPixel, pPicBufMetaData->Data.YCbCr.semiplanar.Y.PicHeightPixel );
-
-            // finally write result
-            if ( 1 != fwrite( pYCbCr444, 3 * YCPlaneSize, 1, pFile ) )
+        // convert straight from on-board memory; 4:2:2 is upscaled to 4:4:4 by pixel replication
+        lres = HalMapMemory( pSomContext->HalHandle, (ulong_t)(pY->pBuffer), pY->PicWidthBytes * pY->PicHeightPixel, HAL_MAPMEM_READONLY, (void **)&pYMapped );
+        UPDATE_RESULT( result, lres );
+        if (lres == RET_SUCCESS)
+        {
+            lres = HalMapMemory( pSomContext->HalHandle, (ulong_t)(pCbCr->pBuffer), pCbCr->PicWidthBytes * pCbCr->PicHeightPixel, HAL_MAPMEM_READONLY, (void **)&pCbCrMapped );
+            UPDATE_RESULT( result, lres );
+            if (lres == RET_SUCCESS)
             {
-                UPDATE_RESULT( result, RET_FAILURE );
+                somCtrlConvYCbCr422SemiToRgb( pBuf->pData + Length, pYMapped, pY->PicWidthBytes, pCbCrMapped, pCbCr->PicWidthBytes,
+                                                pY->PicWidthPixel, pY->PicHeightPixel );
+
+                UPDATE_RESULT( result, HalUnMapMemory( pSomContext->HalHandle, pCbCrMapped ) );
             }
 
-            // release helper buffer
-            free(pYCbCr444);
+            UPDATE_RESULT( result, HalUnMapMemory( pSomContext->HalHandle, pYMapped ) );
         }
+        Length += RgbSize;
+    }
+
+    // and off to the writer
+    if (result != RET_SUCCESS)
+    {
+        somCtrlWriterPutBuffer( &pSomContext->Writer, pBuf );
+        return result;
     }
 
-    // free local buffer
-    free( pLocBuf );
+    lres = somCtrlWriterQueue( &pSomContext->Writer, pBuf, Length, pFile );
+    UPDATE_RESULT( result, lres );
 
     TRACE(SOM_CTRL_INFO, "%s (exit)\n", __FUNCTION__);
 
     return result;
 }
 
+
 /******************************************************************************
- * ConvertYCbCr444combToRGBcomb()
+ * somCtrlPackPlane()
+ *
+ * Gets a plane from on-board memory, without the stuffing at the line ends.
  *****************************************************************************/
-static void ConvertYCbCr444combToRGBcomb
+static RESULT somCtrlPackPlane
 (
-    uint8_t     *pYCbCr444,
-    uint32_t    PlaneSizePixel
+    somCtrlContext_t    *pSomContext,
+    uint8_t             *pDst,
+    ulong_t             Address,
+    uint32_t            LineSize,
+    uint32_t            Stride,
+    uint32_t            Lines
 )
 {
-    uint32_t pix;
-    for (pix = 0; pix < PlaneSizePixel; pix++)
-    {
-        // where to put the RGB data
-        uint8_t *pPix = pYCbCr444;
-
-        // get YCbCr pixel data
-        int32_t Y  = *pYCbCr444++;
-        int32_t Cb = *pYCbCr444++; // TODO: order in marvin output is CrCb and not CbCr as expected
-        int32_t Cr = *pYCbCr444++; //       s. above
-
-        // remove offset as in VideoDemystified 3; page 18f; YCbCr to RGB(0..255)
-        Y  -=  16;
-        Cr -= 128;
-        Cb -= 128;
-
-        // convert to RGB
-////#define USE_FLOAT
-#if (1)
-        // Standard Definition TV (BT.601) as in VideoDemystified 3; page 18f; YCbCr to RGB(0..255)
-    #ifdef USE_FLOAT
-        float R = 1.164*Y + 1.596*Cr;
-        float G = 1.164*Y - 0.813*Cr - 0.391*Cb;
-        float B = 1.164*Y + 2.018*Cb;
-    #else
-        int32_t R = ( ((int32_t)(1.164*1024))*Y + ((int32_t)(1.596*1024))*Cr                              ) >> 10;
-        int32_t G = ( ((int32_t)(1.164*1024))*Y - ((int32_t)(0.813*1024))*Cr - ((int32_t)(0.391*1024))*Cb ) >> 10;
-        int32_t B = ( ((int32_t)(1.164*1024))*Y + ((int32_t)(2.018*1024))*Cb                              ) >> 10;
-    #endif
-#else
-        // High Definition TV (BT.709) as in VideoDemystified 3; page 19; YCbCr to RGB(0..255)
-    #ifdef USE_FLOAT
-        float R = 1.164*Y + 1.793*Cr;
-        float G = 1.164*Y - 0.534*Cr - 0.213*Cb;
-        float B = 1.164*Y + 2.115*Cb;
-    #else
-        int32_t R = ( ((int32_t)(1.164*1024))*Y + ((int32_t)(1.793*1024))*Cr                              ) >> 10;
-        int32_t G = ( ((int32_t)(1.164*1024))*Y - ((int32_t)(0.534*1024))*Cr - ((int32_t)(0.213*1024))*Cb ) >> 10;
-        int32_t B = ( ((int32_t)(1.164*1024))*Y + ((int32_t)(2.115*1024))*Cb                              ) >> 10;
-    #endif
-#endif
-        // clip
-        if (R<0) R=0; else if (R>255) R=255;
-        if (G<0) G=0; else if (G>255) G=255;
-        if (B<0) B=0; else if (B>255) B=255;
+    RESULT result = RET_SUCCESS;
+    uint32_t y;
 
-        // write back RGB data
-        *pPix++ = (uint8_t) R;
-        *pPix++ = (uint8_t) G;
-        *pPix++ = (uint8_t) B;
+    if ( LineSize == Stride )
+    {
+        // a single read will do
+        return HalReadMemory( pSomContext->HalHandle, Address, pDst, LineSize * Lines );
     }
+
+    // line by line; these are copies, no system calls
+    for (y=0; (y < Lines) && (result == RET_SUCCESS); y++)
+    {
+        result = HalReadMemory( pSomContext->HalHandle, Address, pDst, LineSize );
+        Address += Stride;
+        pDst    += LineSize;
+    }
+
+    return result;
 }
@@ -0,0 +1,267 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file som_ctrl_conv.c
+ *
+ * @brief   Pixel conversion of the som ctrl, portable and NEON.
+ *
+ *****************************************************************************/
+#include <ebase/types.h>
+
+#include "som_ctrl_conv.h"
+
+#ifdef SOM_CTRL_CONV_NEON
+#include <arm_neon.h>
+#endif
+
+
+
+/******************************************************************************
+ * local macro definitions
+ *****************************************************************************/
+
+/* Standard Definition TV (BT.601) as in VideoDemystified 3; page 18f; YCbCr
+ * to RGB(0..255), 10 bit fixed point */
+#define CONV_Y      ( (int32_t)(1.164*1024) )
+#define CONV_R_CR   ( (int32_t)(1.596*1024) )
+#define CONV_G_CR   ( (int32_t)(0.813*1024) )
+#define CONV_G_CB   ( (int32_t)(0.391*1024) )
+#define CONV_B_CB   ( (int32_t)(2.018*1024) )
+
+
+
+/******************************************************************************
+ * local functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * ConvClip()
+ *****************************************************************************/
+static inline uint8_t ConvClip
+(
+    const int32_t   value
+)
+{
+    return ( ( value < 0 ) ? 0U : ( ( value > 255 ) ? 255U : (uint8_t)value ) );
+}
+
+
+
+/******************************************************************************
+ * ConvPixel()
+ *****************************************************************************/
+static inline void ConvPixel
+(
+    uint8_t         *pRgb,
+    int32_t         Y,
+    int32_t         Cb,
+    int32_t         Cr
+)
+{
+    // remove offset as in VideoDemystified 3; page 18f; YCbCr to RGB(0..255)
+    Y  -=  16;
+    Cr -= 128;
+    Cb -= 128;
+
+    pRgb[0] = ConvClip( ( CONV_Y*Y + CONV_R_CR*Cr                ) >> 10 );
+    pRgb[1] = ConvClip( ( CONV_Y*Y - CONV_G_CR*Cr - CONV_G_CB*Cb ) >> 10 );
+    pRgb[2] = ConvClip( ( CONV_Y*Y + CONV_B_CB*Cb                ) >> 10 );
+}
+
+
+
+/******************************************************************************
+ * ConvLine()
+ *
+ * One line straight from the planes, from pixel x on.
+ *****************************************************************************/
+static inline void ConvLine
+(
+    uint8_t         *pRgb,
+    const uint8_t   *pY,
+    const uint8_t   *pCbCr,
+    uint32_t        x,
+    const uint32_t  Width
+)
+{
+    for ( ; x < Width; x += 2U )
+    {
+        // TODO: order in marvin output is CrCb and not CbCr as expected
+        ConvPixel( &pRgb[3U * x],      pY[x],      pCbCr[x], pCbCr[x + 1U] );
+        ConvPixel( &pRgb[3U * x + 3U], pY[x + 1U], pCbCr[x], pCbCr[x + 1U] );
+    }
+}
+
+
+
+#ifdef SOM_CTRL_CONV_NEON
+
+/******************************************************************************
+ * ConvChannel()
+ *
+ * 8 results of 16 bit operands, narrowed with the same clipping as
+ * ConvClip(): saturate to 0..65535, then to 0..255.
+ *****************************************************************************/
+static inline uint8x8_t ConvChannel
+(
+    const int32x4_t lo,
+    const int32x4_t hi
+)
+{
+    return ( vqmovn_u16( vcombine_u16( vqmovun_s32( vshrq_n_s32( lo, 10 ) ),
+                                       vqmovun_s32( vshrq_n_s32( hi, 10 ) ) ) ) );
+}
+
+
+
+/******************************************************************************
+ * ConvPixels8()
+ *
+ * 8 pixels, offsets already removed.
+ *****************************************************************************/
+static inline void ConvPixels8
+(
+    const int16x8_t Y,
+    const int16x8_t Cb,
+    const int16x8_t Cr,
+    uint8x8_t       *pR,
+    uint8x8_t       *pG,
+    uint8x8_t       *pB
+)
+{
+    const int32x4_t ylo = vmull_n_s16( vget_low_s16( Y ),  (int16_t)CONV_Y );
+    const int32x4_t yhi = vmull_n_s16( vget_high_s16( Y ), (int16_t)CONV_Y );
+
+    *pR = ConvChannel( vmlal_n_s16( ylo, vget_low_s16( Cr ),  (int16_t)CONV_R_CR ),
+                       vmlal_n_s16( yhi, vget_high_s16( Cr ), (int16_t)CONV_R_CR ) );
+
+    *pG = ConvChannel( vmlsl_n_s16( vmlsl_n_s16( ylo, vget_low_s16( Cr ),  (int16_t)CONV_G_CR ), vget_low_s16( Cb ),  (int16_t)CONV_G_CB ),
+                       vmlsl_n_s16( vmlsl_n_s16( yhi, vget_high_s16( Cr ), (int16_t)CONV_G_CR ), vget_high_s16( Cb ), (int16_t)CONV_G_CB ) );
+
+    *pB = ConvChannel( vmlal_n_s16( ylo, vget_low_s16( Cb ),  (int16_t)CONV_B_CB ),
+                       vmlal_n_s16( yhi, vget_high_s16( Cb ), (int16_t)CONV_B_CB ) );
+}
+
+#endif /* SOM_CTRL_CONV_NEON */
+
+
+
+/******************************************************************************
+ * See header file for detailed comment.
+ *****************************************************************************/
+
+/******************************************************************************
+ * somCtrlConvYCbCr422SemiToRgbRef()
+ *****************************************************************************/
+void somCtrlConvYCbCr422SemiToRgbRef
+(
+    uint8_t         *pRgb,
+    const uint8_t   *pY,
+    const uint32_t  YStride,
+    const uint8_t   *pCbCr,
+    const uint32_t  CbCrStride,
+    const uint32_t  Width,
+    const uint32_t  Height
+)
+{
+    uint8_t *pYCbCr444 = pRgb;
+    uint32_t x, y, pix;
+
+    // upscale and combine each 4:2:2 pixel to 4:4:4 while removing any gaps at line ends as well
+    for ( y = 0U; y < Height; y++ )
+    {
+        // get line starts
+        const uint8_t *pYLine = pY;
+        const uint8_t *pC = pCbCr;
+
+        // walk through line
+        for ( x = 0U; x < Width; x += 2U )
+        {
+            uint8_t Cb, Cr;
+            *pYCbCr444++ = *pYLine++;
+            *pYCbCr444++ = Cb = *pC++;
+            *pYCbCr444++ = Cr = *pC++;
+            *pYCbCr444++ = *pYLine++;
+            *pYCbCr444++ = Cb;
+            *pYCbCr444++ = Cr;
+        }
+
+        // update line starts
+        pY    += YStride;
+        pCbCr += CbCrStride;
+    }
+
+    // inplace convert consecutive YCbCr444 to RGB; both are combined color component planes
+    for ( pix = 0U; pix < ( Width * Height ); pix++, pRgb += 3 )
+    {
+        ConvPixel( pRgb, pRgb[0], pRgb[1], pRgb[2] );
+    }
+}
+
+
+
+/******************************************************************************
+ * somCtrlConvYCbCr422SemiToRgb()
+ *****************************************************************************/
+void somCtrlConvYCbCr422SemiToRgb
+(
+    uint8_t         *pRgb,
+    const uint8_t   *pY,
+    const uint32_t  YStride,
+    const uint8_t   *pCbCr,
+    const uint32_t  CbCrStride,
+    const uint32_t  Width,
+    const uint32_t  Height
+)
+{
+    uint32_t y;
+
+    for ( y = 0U; y < Height; y++ )
+    {
+        uint32_t x = 0U;
+
+#ifdef SOM_CTRL_CONV_NEON
+        const int16x8_t YOffs = vdupq_n_s16( 16 );
+        const int16x8_t COffs = vdupq_n_s16( 128 );
+
+        // 16 pixels share 8 chroma pairs
+        for ( ; ( x + 16U ) <= Width; x += 16U )
+        {
+            const uint8x16_t  Y8 = vld1q_u8( &pY[x] );
+            const uint8x8x2_t C8 = vld2_u8( &pCbCr[x] );
+            const uint8x8x2_t Cb = vzip_u8( C8.val[0], C8.val[0] );
+            const uint8x8x2_t Cr = vzip_u8( C8.val[1], C8.val[1] );
+            uint8x8_t R[2], G[2], B[2];
+            uint8x16x3_t Rgb;
+
+            ConvPixels8( vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( vget_low_u8( Y8 ) ) ),  YOffs ),
+                         vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( Cb.val[0] ) ), COffs ),
+                         vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( Cr.val[0] ) ), COffs ),
+                         &R[0], &G[0], &B[0] );
+            ConvPixels8( vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( vget_high_u8( Y8 ) ) ), YOffs ),
+                         vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( Cb.val[1] ) ), COffs ),
+                         vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( Cr.val[1] ) ), COffs ),
+                         &R[1], &G[1], &B[1] );
+
+            Rgb.val[0] = vcombine_u8( R[0], R[1] );
+            Rgb.val[1] = vcombine_u8( G[0], G[1] );
+            Rgb.val[2] = vcombine_u8( B[0], B[1] );
+            vst3q_u8( &pRgb[3U * x], Rgb );
+        }
+#endif /* SOM_CTRL_CONV_NEON */
+
+        ConvLine( pRgb, pY, pCbCr, x, Width );
+
+        pRgb  += 3U * Width;
+        pY    += YStride;
+        pCbCr += CbCrStride;
+    }
+}
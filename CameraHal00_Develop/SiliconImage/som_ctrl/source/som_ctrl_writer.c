@@ -0,0 +1,548 @@
+/******************************************************************************
+ *
+ * Copyright 2010, Dream Chip Technologies GmbH. All rights reserved.
+ * No part of this work may be reproduced, modified, distributed, transmitted,
+ * transcribed, or translated into any language or computer format, in any form
+ * or by any means without written permission of:
+ * Dream Chip Technologies GmbH, Steinriede 10, 30827 Garbsen / Berenbostel,
+ * Germany
+ *
+ *****************************************************************************/
+/**
+ * @file som_ctrl_writer.c
+ *
+ * @brief   File writer stage of the som ctrl.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+
+#include <ebase/trace.h>
+#include <ebase/builtins.h>
+#include <ebase/dct_assert.h>
+
+#include <common/return_codes.h>
+#include <common/align.h>
+
+#include <oslayer/oslayer.h>
+
+#include "som_ctrl_writer.h"
+
+/******************************************************************************
+ * local macro definitions
+ *****************************************************************************/
+
+CREATE_TRACER(SOM_WRITER_INFO , "SOM-WRITER: ", INFO,  0);
+CREATE_TRACER(SOM_WRITER_ERROR, "SOM-WRITER: ", ERROR, 1);
+
+/******************************************************************************
+ * local type definitions
+ *****************************************************************************/
+
+typedef enum somCtrlWriteJobType_e
+{
+    SOM_CTRL_WRITE_JOB_DATA     = 0,    //!< write buffer, give it back
+    SOM_CTRL_WRITE_JOB_CLOSE    = 1,    //!< close file
+    SOM_CTRL_WRITE_JOB_SYNC     = 2,    //!< signal SyncEvent
+    SOM_CTRL_WRITE_JOB_EXIT     = 3     //!< end the writer thread
+} somCtrlWriteJobType_t;
+
+typedef struct somCtrlWriteJob_s
+{
+    somCtrlWriteJobType_t   Type;
+    somCtrlWriteBuf_t       *pBuf;
+    uint32_t                Length;
+    FILE                    *pFile;
+} somCtrlWriteJob_t;
+
+
+
+/******************************************************************************
+ * local functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * somCtrlWriterCount()
+ *****************************************************************************/
+static void somCtrlWriterCount
+(
+    somCtrlWriter_t     *pWriter,
+    const uint32_t      Length,
+    const bool_t        Failed,
+    const int64_t       Us
+)
+{
+    osMutexLock( &pWriter->StatsLock );
+
+    if ( Length )
+    {
+        pWriter->Stats.Pictures++;
+        pWriter->Stats.Bytes += Length;
+    }
+
+    if ( Failed )
+    {
+        pWriter->Stats.Errors++;
+        pWriter->NewErrors++;
+    }
+
+    pWriter->Stats.WriteUs += Us;
+
+    osMutexUnlock( &pWriter->StatsLock );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterTakeErrors()
+ *****************************************************************************/
+static uint32_t somCtrlWriterTakeErrors
+(
+    somCtrlWriter_t     *pWriter
+)
+{
+    uint32_t errors;
+
+    osMutexLock( &pWriter->StatsLock );
+    errors = pWriter->NewErrors;
+    pWriter->NewErrors = 0U;
+    osMutexUnlock( &pWriter->StatsLock );
+
+    return ( errors );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterThread()
+ *****************************************************************************/
+static int32_t somCtrlWriterThread
+(
+    void *p_arg
+)
+{
+    somCtrlWriter_t *pWriter = (somCtrlWriter_t *)p_arg;
+    bool_t bExit = BOOL_FALSE;
+
+    TRACE( SOM_WRITER_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    do
+    {
+        somCtrlWriteJob_t Job;
+        int64_t t0 = 0, t1 = 0;
+        bool_t failed = BOOL_FALSE;
+
+        if ( OSLAYER_OK != osQueueRead( &pWriter->JobQueue, &Job ) )
+        {
+            TRACE( SOM_WRITER_ERROR, "%s (receiving job failed)\n", __FUNCTION__ );
+            continue; // for now we simply try again
+        }
+
+        switch ( Job.Type )
+        {
+            case SOM_CTRL_WRITE_JOB_DATA:
+            {
+                // the whole picture in one go; stdio passes a write of this
+                // size straight to the kernel
+                osTimeStampUs( &t0 );
+                failed = ( 1 != fwrite( Job.pBuf->pData, Job.Length, 1, Job.pFile ) );
+                osTimeStampUs( &t1 );
+
+                if ( failed )
+                {
+                    TRACE( SOM_WRITER_ERROR, "%s (writing %u bytes failed)\n", __FUNCTION__, Job.Length );
+                }
+                somCtrlWriterCount( pWriter, Job.Length, failed, t1 - t0 );
+
+                osQueueWrite( &pWriter->FreeQueue, &Job.pBuf );
+                break;
+            }
+
+            case SOM_CTRL_WRITE_JOB_CLOSE:
+            {
+                osTimeStampUs( &t0 );
+                failed = ( 0 != fclose( Job.pFile ) );
+                osTimeStampUs( &t1 );
+
+                if ( failed )
+                {
+                    TRACE( SOM_WRITER_ERROR, "%s (closing file failed)\n", __FUNCTION__ );
+                }
+                somCtrlWriterCount( pWriter, 0U, failed, t1 - t0 );
+                break;
+            }
+
+            case SOM_CTRL_WRITE_JOB_SYNC:
+            {
+                osEventSignal( &pWriter->SyncEvent );
+                break;
+            }
+
+            case SOM_CTRL_WRITE_JOB_EXIT:
+            default:
+            {
+                bExit = BOOL_TRUE;
+                break;
+            }
+        }
+    }
+    while ( bExit == BOOL_FALSE );
+
+    TRACE( SOM_WRITER_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( 0 );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterSendJob()
+ *****************************************************************************/
+static RESULT somCtrlWriterSendJob
+(
+    somCtrlWriter_t         *pWriter,
+    somCtrlWriteJobType_t   Type,
+    somCtrlWriteBuf_t       *pBuf,
+    const uint32_t          Length,
+    FILE                    *pFile
+)
+{
+    somCtrlWriteJob_t Job;
+
+    Job.Type    = Type;
+    Job.pBuf    = pBuf;
+    Job.Length  = Length;
+    Job.pFile   = pFile;
+
+    if ( OSLAYER_OK != osQueueWrite( &pWriter->JobQueue, &Job ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (sending job %d failed)\n", __FUNCTION__, Type );
+        return ( RET_FAILURE );
+    }
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * See header file for detailed comment.
+ *****************************************************************************/
+
+/******************************************************************************
+ * somCtrlWriterCreate()
+ *****************************************************************************/
+RESULT somCtrlWriterCreate
+(
+    somCtrlWriter_t     *pWriter
+)
+{
+    uint32_t i;
+
+    TRACE( SOM_WRITER_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    DCT_ASSERT( pWriter != NULL );
+
+    MEMSET( pWriter, 0, sizeof(*pWriter) );
+
+    if ( OSLAYER_OK != osQueueInit( &pWriter->JobQueue, SOM_CTRL_WRITER_JOBS, sizeof(somCtrlWriteJob_t) ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (creating job queue failed)\n", __FUNCTION__ );
+        return ( RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osQueueInit( &pWriter->FreeQueue, SOM_CTRL_WRITER_BUFFERS, sizeof(somCtrlWriteBuf_t *) ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (creating free buffer queue failed)\n", __FUNCTION__ );
+        osQueueDestroy( &pWriter->JobQueue );
+        return ( RET_FAILURE );
+    }
+
+    for ( i = 0U; i < SOM_CTRL_WRITER_BUFFERS; i++ )
+    {
+        somCtrlWriteBuf_t *pBuf = &pWriter->Buf[i];
+        osQueueWrite( &pWriter->FreeQueue, &pBuf );
+    }
+
+    if ( OSLAYER_OK != osEventInit( &pWriter->SyncEvent, 1, 0 ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (creating sync event failed)\n", __FUNCTION__ );
+        osQueueDestroy( &pWriter->FreeQueue );
+        osQueueDestroy( &pWriter->JobQueue );
+        return ( RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osMutexInit( &pWriter->StatsLock ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (creating stats lock failed)\n", __FUNCTION__ );
+        osEventDestroy( &pWriter->SyncEvent );
+        osQueueDestroy( &pWriter->FreeQueue );
+        osQueueDestroy( &pWriter->JobQueue );
+        return ( RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osThreadCreate( &pWriter->Thread, somCtrlWriterThread, pWriter ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (creating writer thread failed)\n", __FUNCTION__ );
+        osMutexDestroy( &pWriter->StatsLock );
+        osEventDestroy( &pWriter->SyncEvent );
+        osQueueDestroy( &pWriter->FreeQueue );
+        osQueueDestroy( &pWriter->JobQueue );
+        return ( RET_FAILURE );
+    }
+
+    TRACE( SOM_WRITER_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterDestroy()
+ *****************************************************************************/
+RESULT somCtrlWriterDestroy
+(
+    somCtrlWriter_t     *pWriter
+)
+{
+    RESULT result = RET_SUCCESS;
+    uint32_t i;
+
+    TRACE( SOM_WRITER_INFO, "%s (enter)\n", __FUNCTION__ );
+
+    DCT_ASSERT( pWriter != NULL );
+
+    // jobs are done in order, so everything queued is through when the thread ends
+    UPDATE_RESULT( result, somCtrlWriterSendJob( pWriter, SOM_CTRL_WRITE_JOB_EXIT, NULL, 0U, NULL ) );
+
+    if ( ( result != RET_SUCCESS ) || ( OSLAYER_OK != osThreadWait( &pWriter->Thread ) ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (waiting for writer thread failed)\n", __FUNCTION__ );
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    if ( OSLAYER_OK != osThreadClose( &pWriter->Thread ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (closing writer thread failed)\n", __FUNCTION__ );
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    if ( somCtrlWriterTakeErrors( pWriter ) != 0U )
+    {
+        UPDATE_RESULT( result, RET_FAILURE );
+    }
+
+    for ( i = 0U; i < SOM_CTRL_WRITER_BUFFERS; i++ )
+    {
+        free( pWriter->Buf[i].pMem );
+        pWriter->Buf[i].pMem  = NULL;
+        pWriter->Buf[i].pData = NULL;
+        pWriter->Buf[i].Size  = 0U;
+    }
+
+    osMutexDestroy( &pWriter->StatsLock );
+    osEventDestroy( &pWriter->SyncEvent );
+    osQueueDestroy( &pWriter->FreeQueue );
+    osQueueDestroy( &pWriter->JobQueue );
+
+    TRACE( SOM_WRITER_INFO, "%s (exit)\n", __FUNCTION__ );
+
+    return ( result );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterGetBuffer()
+ *****************************************************************************/
+RESULT somCtrlWriterGetBuffer
+(
+    somCtrlWriter_t     *pWriter,
+    const uint32_t      Size,
+    somCtrlWriteBuf_t   **ppBuf
+)
+{
+    somCtrlWriteBuf_t *pBuf = NULL;
+    int64_t t0 = 0, t1 = 0;
+
+    DCT_ASSERT( pWriter != NULL );
+    DCT_ASSERT( ppBuf != NULL );
+
+    osTimeStampUs( &t0 );
+    if ( ( OSLAYER_OK != osQueueRead( &pWriter->FreeQueue, &pBuf ) ) || ( pBuf == NULL ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (receiving free buffer failed)\n", __FUNCTION__ );
+        return ( RET_FAILURE );
+    }
+    osTimeStampUs( &t1 );
+
+    osMutexLock( &pWriter->StatsLock );
+    pWriter->Stats.WaitUs += t1 - t0;
+    osMutexUnlock( &pWriter->StatsLock );
+
+    // grow; pictures of a capture are all the same size, so this happens
+    // once per buffer and capture
+    if ( pBuf->Size < Size )
+    {
+        free( pBuf->pMem );
+        pBuf->pMem = malloc( Size + SOM_CTRL_WRITER_ALIGN );
+        if ( pBuf->pMem == NULL )
+        {
+            pBuf->pData = NULL;
+            pBuf->Size  = 0U;
+            osQueueWrite( &pWriter->FreeQueue, &pBuf );
+            return ( RET_OUTOFMEM );
+        }
+
+        pBuf->pData = (uint8_t *)ALIGN_UP( (ulong_t)pBuf->pMem, (ulong_t)SOM_CTRL_WRITER_ALIGN );
+        pBuf->Size  = Size;
+    }
+
+    *ppBuf = pBuf;
+
+    return ( RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterPutBuffer()
+ *****************************************************************************/
+void somCtrlWriterPutBuffer
+(
+    somCtrlWriter_t     *pWriter,
+    somCtrlWriteBuf_t   *pBuf
+)
+{
+    DCT_ASSERT( pWriter != NULL );
+    DCT_ASSERT( pBuf != NULL );
+
+    osQueueWrite( &pWriter->FreeQueue, &pBuf );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterQueue()
+ *****************************************************************************/
+RESULT somCtrlWriterQueue
+(
+    somCtrlWriter_t     *pWriter,
+    somCtrlWriteBuf_t   *pBuf,
+    const uint32_t      Length,
+    FILE                *pFile
+)
+{
+    RESULT result;
+
+    DCT_ASSERT( pWriter != NULL );
+    DCT_ASSERT( pBuf != NULL );
+    DCT_ASSERT( Length <= pBuf->Size );
+
+    if ( pFile == NULL )
+    {
+        somCtrlWriterPutBuffer( pWriter, pBuf );
+        return ( RET_NULL_POINTER );
+    }
+
+    result = somCtrlWriterSendJob( pWriter, SOM_CTRL_WRITE_JOB_DATA, pBuf, Length, pFile );
+    if ( result != RET_SUCCESS )
+    {
+        somCtrlWriterPutBuffer( pWriter, pBuf );
+        return ( result );
+    }
+
+    // errors of earlier pictures
+    return ( ( somCtrlWriterTakeErrors( pWriter ) != 0U ) ? RET_FAILURE : RET_SUCCESS );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterClose()
+ *****************************************************************************/
+RESULT somCtrlWriterClose
+(
+    somCtrlWriter_t     *pWriter,
+    FILE                *pFile
+)
+{
+    DCT_ASSERT( pWriter != NULL );
+
+    if ( pFile == NULL )
+    {
+        return ( RET_NULL_POINTER );
+    }
+
+    return ( somCtrlWriterSendJob( pWriter, SOM_CTRL_WRITE_JOB_CLOSE, NULL, 0U, pFile ) );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterSync()
+ *****************************************************************************/
+RESULT somCtrlWriterSync
+(
+    somCtrlWriter_t     *pWriter,
+    const bool_t        Release
+)
+{
+    RESULT result;
+    uint32_t i;
+
+    DCT_ASSERT( pWriter != NULL );
+
+    result = somCtrlWriterSendJob( pWriter, SOM_CTRL_WRITE_JOB_SYNC, NULL, 0U, NULL );
+    if ( result != RET_SUCCESS )
+    {
+        return ( result );
+    }
+
+    if ( OSLAYER_OK != osEventWait( &pWriter->SyncEvent ) )
+    {
+        TRACE( SOM_WRITER_ERROR, "%s (waiting for sync failed)\n", __FUNCTION__ );
+        return ( RET_FAILURE );
+    }
+
+    if ( somCtrlWriterTakeErrors( pWriter ) != 0U )
+    {
+        result = RET_FAILURE;
+    }
+
+    // all buffers are back in the free queue now
+    if ( Release )
+    {
+        for ( i = 0U; i < SOM_CTRL_WRITER_BUFFERS; i++ )
+        {
+            free( pWriter->Buf[i].pMem );
+            pWriter->Buf[i].pMem  = NULL;
+            pWriter->Buf[i].pData = NULL;
+            pWriter->Buf[i].Size  = 0U;
+        }
+    }
+
+    TRACE( SOM_WRITER_INFO, "%s: %u pictures, %llu bytes, %lld us writing, %lld us waiting for buffers\n", __FUNCTION__,
+            pWriter->Stats.Pictures, (unsigned long long)pWriter->Stats.Bytes, pWriter->Stats.WriteUs, pWriter->Stats.WaitUs );
+
+    return ( result );
+}
+
+
+
+/******************************************************************************
+ * somCtrlWriterGetStats()
+ *****************************************************************************/
+void somCtrlWriterGetStats
+(
+    somCtrlWriter_t         *pWriter,
+    somCtrlWriterStats_t    *pStats
+)
+{
+    DCT_ASSERT( pWriter != NULL );
+    DCT_ASSERT( pStats != NULL );
+
+    osMutexLock( &pWriter->StatsLock );
+    *pStats = pWriter->Stats;
+    osMutexUnlock( &pWriter->StatsLock );
+}
@@ -12,6 +12,9 @@
 #include <asm/irq.h>
 #include <asm/io.h>
 #include <linux/err.h>
+#include <linux/poll.h>
+#include <linux/dma-buf.h>
+#include <linux/scatterlist.h>
 #include "ezy_buf.h"
 
 
@@ -53,6 +56,183 @@ static void ezybuf_free_contig(unsigned long addr,unsigned int buf_size)
 	free_pages(addr, get_order(buf_size));
 }
 
+/* the last reference is gone: the queue dropped the buffer and no dma-buf
+ * exported from it is left */
+static void ezybuf_buffer_free(struct kref *kref)
+{
+	struct ezybuf_buffer *eb = container_of(kref, struct ezybuf_buffer, ref);
+
+	if (eb->memory == EZY_MEMORY_MMAP)
+		ezybuf_free_contig(eb->vaddr, eb->size);
+	kfree(eb);
+}
+
+/* export of an EZY_MEMORY_MMAP buffer; every dma-buf holds a reference on
+ * the buffer, which outlives the queue until the last one is released.
+ * EZY_REQBUF is refused while a dma-buf of it is still around */
+static struct sg_table *ezybuf_dmabuf_map(struct dma_buf_attachment *dba, enum dma_data_direction dir)
+{
+	struct ezybuf_buffer *eb = dba->dmabuf->priv;
+	struct sg_table *sgt;
+
+	sgt = kzalloc(sizeof(*sgt), GFP_KERNEL);
+	if (!sgt)
+		return ERR_PTR(-ENOMEM);
+
+	if (sg_alloc_table(sgt, 1, GFP_KERNEL)) {
+		kfree(sgt);
+		return ERR_PTR(-ENOMEM);
+	}
+
+	sg_set_page(sgt->sgl, virt_to_page(eb->vaddr), dba->dmabuf->size, 0);
+	if (!dma_map_sg(dba->dev, sgt->sgl, sgt->orig_nents, dir)) {
+		sg_free_table(sgt);
+		kfree(sgt);
+		return ERR_PTR(-EIO);
+	}
+
+	return sgt;
+}
+
+static void ezybuf_dmabuf_unmap(struct dma_buf_attachment *dba, struct sg_table *sgt, enum dma_data_direction dir)
+{
+	dma_unmap_sg(dba->dev, sgt->sgl, sgt->orig_nents, dir);
+	sg_free_table(sgt);
+	kfree(sgt);
+}
+
+static void ezybuf_dmabuf_release(struct dma_buf *dbuf)
+{
+	struct ezybuf_buffer *eb = dbuf->priv;
+
+	atomic_dec(&eb->exports);
+	kref_put(&eb->ref, ezybuf_buffer_free);
+}
+
+static void *ezybuf_dmabuf_kmap(struct dma_buf *dbuf, unsigned long pgnum)
+{
+	struct ezybuf_buffer *eb = dbuf->priv;
+
+	return (void *)(eb->vaddr + pgnum * PAGE_SIZE);
+}
+
+static void ezybuf_dmabuf_kunmap(struct dma_buf *dbuf, unsigned long pgnum, void *vaddr)
+{
+}
+
+static void *ezybuf_dmabuf_vmap(struct dma_buf *dbuf)
+{
+	struct ezybuf_buffer *eb = dbuf->priv;
+
+	return (void *)eb->vaddr;
+}
+
+/* same mapping as ezybuf_mmap() gives */
+static int ezybuf_dmabuf_mmap(struct dma_buf *dbuf, struct vm_area_struct *vma)
+{
+	struct ezybuf_buffer *eb = dbuf->priv;
+	unsigned long size = vma->vm_end - vma->vm_start;
+
+	if ((vma->vm_pgoff << PAGE_SHIFT) + size > dbuf->size)
+		return -EINVAL;
+
+	if (!eb->cache)
+		vma->vm_page_prot = pgprot_writecombine(vma->vm_page_prot);
+	else
+		vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
+
+	return remap_pfn_range(vma, vma->vm_start, (eb->phyaddr >> PAGE_SHIFT) + vma->vm_pgoff, size, vma->vm_page_prot);
+}
+
+static struct dma_buf_ops ezybuf_dmabuf_ops = {
+	.map_dma_buf	= ezybuf_dmabuf_map,
+	.unmap_dma_buf	= ezybuf_dmabuf_unmap,
+	.release		= ezybuf_dmabuf_release,
+	.kmap_atomic	= ezybuf_dmabuf_kmap,
+	.kunmap_atomic	= ezybuf_dmabuf_kunmap,
+	.kmap			= ezybuf_dmabuf_kmap,
+	.kunmap			= ezybuf_dmabuf_kunmap,
+	.vmap			= ezybuf_dmabuf_vmap,
+	.mmap			= ezybuf_dmabuf_mmap,
+};
+
+/* import of an EZY_MEMORY_DMABUF buffer: attached to the reading device so
+ * the exporter keeps the pages in place. The device takes the pages from
+ * sgt, the CPU reads through vmap between dma_buf_begin/end_cpu_access */
+static void ezybuf_dmabuf_put(struct ezybuf_buffer *eb)
+{
+	if (!eb->dbuf)
+		return;
+
+	dma_buf_vunmap(eb->dbuf, (void *)eb->vaddr);
+	dma_buf_unmap_attachment(eb->dba, eb->sgt, DMA_TO_DEVICE);
+	dma_buf_detach(eb->dbuf, eb->dba);
+	dma_buf_put(eb->dbuf);
+
+	eb->dbuf = NULL;
+	eb->dba = NULL;
+	eb->sgt = NULL;
+	eb->vaddr = 0;
+	eb->size = 0;
+}
+
+/* eb keeps the dma-buf until another one is queued with it */
+static int ezybuf_dmabuf_get(struct ezybuf_queue *q, struct ezybuf_buffer *eb, int fd)
+{
+	struct dma_buf *dbuf;
+	struct dma_buf_attachment *dba;
+	struct sg_table *sgt;
+	void *vaddr;
+	int retval;
+
+	if (!q->dma_dev)
+		return -ENODEV;
+
+	dbuf = dma_buf_get(fd);
+	if (IS_ERR(dbuf))
+		return PTR_ERR(dbuf);
+
+	if (dbuf == eb->dbuf) {
+		dma_buf_put(dbuf);
+		return 0;
+	}
+
+	dba = dma_buf_attach(dbuf, q->dma_dev);
+	if (IS_ERR(dba)) {
+		retval = PTR_ERR(dba);
+		goto put;
+	}
+
+	sgt = dma_buf_map_attachment(dba, DMA_TO_DEVICE);
+	if (IS_ERR(sgt)) {
+		retval = PTR_ERR(sgt);
+		goto detach;
+	}
+
+	vaddr = dma_buf_vmap(dbuf);
+	if (!vaddr) {
+		retval = -ENOMEM;
+		goto unmap;
+	}
+
+	ezybuf_dmabuf_put(eb);
+	eb->dbuf = dbuf;
+	eb->dba = dba;
+	eb->sgt = sgt;
+	eb->vaddr = (unsigned long)vaddr;
+	eb->size = dbuf->size;
+
+	return 0;
+
+unmap:
+	dma_buf_unmap_attachment(dba, sgt, DMA_TO_DEVICE);
+detach:
+	dma_buf_detach(dbuf, dba);
+put:
+	dma_buf_put(dbuf);
+	return retval;
+}
+
 static void ezybuf_free_buffers(struct ezybuf_queue *q)
 {
 	int i;
@@ -62,9 +242,10 @@ static void ezybuf_free_buffers(struct ezybuf_queue *q)
 		for (i = 0; i < q->buf_cnt; i++) {
 			eb = q->buffers[i];
 			if (eb) {
-				if (eb->memory == EZY_MEMORY_MMAP)
-					ezybuf_free_contig(eb->vaddr, eb->size);
-				kfree(eb);
+				/* an exported buffer goes with its last dma-buf */
+				ezybuf_dmabuf_put(eb);
+				eb->queue = NULL;
+				kref_put(&eb->ref, ezybuf_buffer_free);
 				q->buffers[i] = NULL;
 			}
 		}
@@ -83,6 +264,7 @@ static void *ezybuf_alloc(unsigned int size)
 
 	if (NULL != eb) {
 		eb->state = STATE_EZBUF_PREPARED;
+		kref_init(&eb->ref);
 		INIT_LIST_HEAD(&eb->empty);
 		INIT_LIST_HEAD(&eb->full);
 		init_waitqueue_head(&eb->done);
@@ -105,6 +287,17 @@ static int ezybuf_reqbuf(struct ezybuf_queue *q, struct ezy_reqbufs *rbufs)
 	if (rbufs->size > EZY_MAX_SIZE)
 		return -EFAULT;
 
+	for (i = 0; q->buffers && i < q->buf_cnt; i++) {
+		eb = q->buffers[i];
+		if (!eb)
+			continue;
+		if (atomic_read(&eb->exports)) {
+			mutex_unlock(&q->lock);
+			return -EBUSY;
+		}
+		ezybuf_dmabuf_put(eb);
+	}
+
 	if (!q->buffers) {
 		q->buffers = kzalloc(sizeof(*q->buffers) * rbufs->count, GFP_KERNEL);
 	}
@@ -124,6 +317,8 @@ static int ezybuf_reqbuf(struct ezybuf_queue *q, struct ezy_reqbufs *rbufs)
 		eb->size 	 = rbufs->size;
 		eb->headlen = EZY_HEAD_LEN;
 		eb->buf_type = rbufs->buf_type;
+		eb->cache = q->cache;
+		eb->queue = q;
 
 		switch (eb->memory) {
 		case EZY_MEMORY_MMAP:
@@ -139,6 +334,14 @@ static int ezybuf_reqbuf(struct ezybuf_queue *q, struct ezy_reqbufs *rbufs)
 			eb->vaddr 	  = 0;
 			eb->bytesused = 0;
 			break;
+		case EZY_MEMORY_DMABUF:
+			/* size and vaddr come with the dma-buf at EZY_QBUF */
+			eb->headlen   = 0;
+			eb->size      = 0;
+			eb->phyaddr   = 0;
+			eb->vaddr     = 0;
+			eb->bytesused = 0;
+			break;
 		default:
 			printk("qbuf: wrong memory type\n");
 			goto free_mem;
@@ -211,6 +414,15 @@ static int ezybuf_qbuf(struct ezybuf_queue *q, struct ezy_buffer *buf)
 		goto done;
 	}
 
+	/* an empty buffer is only handed back, it needs no memory */
+	if (eb->memory == EZY_MEMORY_DMABUF && buf->bytesused) {
+		retval = ezybuf_dmabuf_get(q, eb, buf->fd);
+		if (retval < 0) {
+			printk("qbuf: dma-buf %d not usable: %d\n", buf->fd, retval);
+			goto done;
+		}
+	}
+
 	if (buf->bytesused > (eb->size - eb->headlen)) {
 		eb->bytesused = eb->size - eb->headlen;
 		printk("bytesused big than eb size\n");
@@ -225,7 +437,53 @@ static int ezybuf_qbuf(struct ezybuf_queue *q, struct ezy_buffer *buf)
 		spin_lock_irqsave(&q->irqlock, flags);
 		retval = ezybuf_qbuf_user(q, eb);
 		spin_unlock_irqrestore(&q->irqlock, flags);
+
+		if (q->hops && q->hops->qbuf)
+			q->hops->qbuf(q, q->priv, eb);
+	}
+done:
+	mutex_unlock(&q->lock);
+	return retval;
+}
+
+static int ezybuf_expbuf(struct ezybuf_queue *q, struct ezy_buffer *buf)
+{
+	DEFINE_DMA_BUF_EXPORT_INFO(exp_info);
+	struct ezybuf_buffer *eb;
+	struct dma_buf *dbuf;
+	int retval = -EINVAL;
+
+	mutex_lock(&q->lock);
+
+	if (buf->index < 0 || buf->index >= q->buf_cnt)
+		goto done;
+
+	eb = q->buffers[buf->index];
+	if (eb->memory != EZY_MEMORY_MMAP)
+		goto done;
+
+	exp_info.ops = &ezybuf_dmabuf_ops;
+	exp_info.size = PAGE_ALIGN(eb->size);
+	exp_info.flags = O_RDWR;
+	exp_info.priv = eb;
+
+	dbuf = dma_buf_export(&exp_info);
+	if (IS_ERR(dbuf)) {
+		retval = PTR_ERR(dbuf);
+		goto done;
+	}
+	atomic_inc(&eb->exports);
+	kref_get(&eb->ref);
+
+	retval = dma_buf_fd(dbuf, O_CLOEXEC);
+	if (retval < 0) {
+		dma_buf_put(dbuf);
+		goto done;
 	}
+
+	buf->fd = retval;
+	retval = 0;
+
 done:
 	mutex_unlock(&q->lock);
 	return retval;
@@ -355,6 +613,9 @@ static int ezybuf_streamon(struct ezybuf_queue *q)
 	spin_unlock_irqrestore(&q->irqlock, flags);
 	q->streaming = 1;
 
+	if (retval == 0 && q->hops && q->hops->qbuf)
+		q->hops->qbuf(q, q->priv, NULL);
+
 done:
 	mutex_unlock(&q->lock);
 	return retval;
@@ -480,7 +741,7 @@ static int ezybuf_mmap(struct file *filp, struct vm_area_struct *vma)
 	int flag = 0;
 
 	for (i = 0; i < q->buf_cnt; i++) {
-		if (q->buffers[i]->memory == EZY_MEMORY_USERPTR)
+		if (q->buffers[i]->memory != EZY_MEMORY_MMAP)
 			return -EAGAIN;
 
 		if (offset == q->buffers[i]->phyaddr) {
@@ -566,6 +827,10 @@ static long ezybuf_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 		retval = ezybuf_streamoff(q);
 		break;
 
+	case EZY_EXPBUF:
+		retval = ezybuf_expbuf(q, (struct ezy_buffer *)arg);
+		break;
+
 	default:
 		break;
 
@@ -602,6 +867,17 @@ static ssize_t ezybuf_write(struct file *filp, const char *bufer, size_t count,
 	return retval;
 }
 
+/* hooks get the real file here, poll_wait() may take a reference on it */
+static unsigned int ezybuf_poll(struct file *filp, poll_table *wait)
+{
+	struct ezybuf_queue *q = filp->private_data;
+
+	if (q->fops->poll)
+		return q->fops->poll(filp, wait);
+
+	return DEFAULT_POLLMASK;
+}
+
 static struct file_operations ezybuf_fops = {
 	.owner 	 		= THIS_MODULE,
 	.open 	 		= ezybuf_open,
@@ -610,6 +886,7 @@ static struct file_operations ezybuf_fops = {
 	.read	 		= ezybuf_read,
 	.write	 		= ezybuf_write,
 	.mmap 	 		= ezybuf_mmap,
+	.poll			= ezybuf_poll,
 };
 
 int ezybuf_queue_init(struct ezybuf_queue *q, struct file_operations *fops, unsigned int msize, unsigned int cache, char *name, void *priv)
@@ -666,6 +943,10 @@ int ezybuf_queue_init(struct ezybuf_queue *q, struct file_operations *fops, unsi
 
 void ezybuf_queue_cancel(struct ezybuf_queue *q)
 {
+	mutex_lock(&q->lock);
+	ezybuf_free_buffers(q);
+	mutex_unlock(&q->lock);
+
 	device_destroy(ezybuf_class, MKDEV(MAJOR(ezybuf_devt), q->id));
 	cdev_del(&q->c_dev);
 	ezybuf_delete(&q->kref);
@@ -738,6 +1019,27 @@ void drvbuf_wakeup(struct drvbuf_buffer *db)
 {
 	db->state = STATE_CMD_NONBLOCK;
 	wake_up_interruptible(&db->done);
+	if (db->queue)
+		wake_up_interruptible(&db->queue->wait);
+}
+
+/* readable when the next buffer drvbuf_dqfull() hands out is already woken */
+unsigned int drvbuf_poll(struct drvbuf_queue *q, struct file *filp, poll_table *wait)
+{
+	struct drvbuf_buffer *db;
+	unsigned int mask = 0;
+
+	poll_wait(filp, &q->wait, wait);
+
+	spin_lock(&q->fulllock);
+	if (!list_empty(&q->full)) {
+		db = list_entry(q->full.next, struct drvbuf_buffer, full);
+		if (db->state == STATE_CMD_NONBLOCK)
+			mask |= POLLIN | POLLRDNORM;
+	}
+	spin_unlock(&q->fulllock);
+
+	return mask;
 }
 
 void drvbuf_qempty(struct drvbuf_queue *q, struct drvbuf_buffer *db)
@@ -834,6 +1136,7 @@ int drvbuf_queue_init(struct drvbuf_queue *q, unsigned int buf_cnt, unsigned int
 	INIT_LIST_HEAD(&q->full);
 	spin_lock_init(&q->emptylock);
 	spin_lock_init(&q->fulllock);
+	init_waitqueue_head(&q->wait);
 
 	q->buf_cnt = 0;
 	for (i = 0; i < buf_cnt; i++) {
@@ -841,6 +1144,7 @@ int drvbuf_queue_init(struct drvbuf_queue *q, unsigned int buf_cnt, unsigned int
 		if (!db)
 			goto free_mem;
 
+		db->queue = q;
 		q->buf_cnt++;
 		drvbuf_qempty(q, db);
 		drvbuf_qfull(q, db);
@@ -900,6 +1204,7 @@ EXPORT_SYMBOL_GPL(drvbuf_qfull);
 EXPORT_SYMBOL_GPL(drvbuf_dqempty);
 EXPORT_SYMBOL_GPL(drvbuf_dqfull);
 EXPORT_SYMBOL_GPL(drvbuf_wakeup);
+EXPORT_SYMBOL_GPL(drvbuf_poll);
 
 module_init(ezybuf_init);
 module_exit(ezybuf_uninit);
@@ -32,6 +32,8 @@
 #include <linux/proc_fs.h>
 #include <linux/sysctl.h>
 #include <linux/list.h>
+#include <linux/poll.h>
+#include <linux/dma-buf.h>
 #endif
 
 #define EZY_HEAD_LEN		20
@@ -39,6 +41,7 @@
 enum ezy_memory {
 	EZY_MEMORY_MMAP             = 1,
 	EZY_MEMORY_USERPTR          = 2,
+	EZY_MEMORY_DMABUF           = 3,	/* frames are dma-bufs of another driver, queued by fd */
 };
 
 /* To allocate the memory*/
@@ -58,12 +61,13 @@ struct ezy_buffer {
 				  				 used in the mmap() system call */
 	int size;
 	int bytesused;	// actuall used size
+	int fd;			/* dma-buf: queued with EZY_QBUF, returned by EZY_EXPBUF */
 };
 
 /* ioctls definition */
 #pragma		pack(1)
 #define		EZY_IOC_BASE			       'E'
-#define		EZY_IOC_MAXNR					6
+#define		EZY_IOC_MAXNR					7
 
 /*Ioctl options which are to be passed while calling the ioctl*/
 #define	EZY_REQBUF		_IOWR(EZY_IOC_BASE,1, struct ezy_reqbufs *)
@@ -72,6 +76,7 @@ struct ezy_buffer {
 #define	EZY_DQBUF		_IOWR(EZY_IOC_BASE,4, struct ezy_buffer *)
 #define	EZY_STREAMON	_IOWR(EZY_IOC_BASE,5, struct ezy_buffer *)
 #define	EZY_STREAMOFF	_IOWR(EZY_IOC_BASE,6, struct ezy_buffer *)
+#define	EZY_EXPBUF		_IOWR(EZY_IOC_BASE,7, struct ezy_buffer *)
 
 #pragma	pack()
 /* End of ioctls */
@@ -123,6 +128,15 @@ struct ezybuf_buffer {
 	int size;
 	int bytesused;				// actuall used size
 
+	struct dma_buf *dbuf;		/* EZY_MEMORY_DMABUF: imported buffer, vaddr is its vmap */
+	struct dma_buf_attachment *dba;
+	struct sg_table *sgt;
+	atomic_t exports;			/* EZY_MEMORY_MMAP: dma-bufs exported and not released */
+	struct kref ref;			/* held by the queue and by every exported dma-buf */
+	unsigned int cache;			/* of the queue, for the mappings of an export */
+
+	struct ezybuf_queue *queue;
+
 	unsigned char *private;
 };
 
@@ -161,6 +175,8 @@ struct ezybuf_queue {
 	struct mutex lock;
 	struct kref kref;
 
+	struct ezybuf_hops *hops;	/* driver side, qbuf is called with priv once a buffer is full */
+	struct device *dma_dev;		/* driver side, reads the frames; imported dma-bufs are attached to it */
 };
 
 
@@ -182,11 +198,14 @@ enum drvbuf_state {
 	STATE_CMD_NONBLOCK,
 };
 
+struct drvbuf_queue;
+
 struct drvbuf_buffer {
 	struct list_head empty;
 	struct list_head full;
 	enum drvbuf_state state;
 	wait_queue_head_t done;
+	struct drvbuf_queue *queue;
 };
 
 struct drvbuf_queue {
@@ -198,6 +217,7 @@ struct drvbuf_queue {
 	unsigned int nonblock;
 	spinlock_t emptylock;
 	spinlock_t fulllock;
+	wait_queue_head_t wait;		/* woken on every drvbuf_wakeup, for poll */
 };
 
 int drvbuf_queue_init(struct drvbuf_queue *q,unsigned int buf_cnt,unsigned int msize,unsigned int nonblock);
@@ -207,5 +227,6 @@ void drvbuf_qfull(struct drvbuf_queue *q, struct drvbuf_buffer *db);
 struct drvbuf_buffer * drvbuf_dqempty(struct drvbuf_queue *q);
 struct drvbuf_buffer * drvbuf_dqfull(struct drvbuf_queue *q);
 void drvbuf_wakeup(struct drvbuf_buffer *db);
+unsigned int drvbuf_poll(struct drvbuf_queue *q, struct file *filp, poll_table *wait);
 #endif
 #endif
@@ -14,7 +14,6 @@
 #define MEDIA_DEV_NUM		1
 #define	MEDIA_CONFIG_NUM	1
 #define MJPEG_STATUS_BIT	0x02
-#define USB_BUF_CTRL_SIZE	1024
 
 static int major;
 struct media_device *gMedia = NULL;
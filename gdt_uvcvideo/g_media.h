@@ -46,6 +46,9 @@
 #define UVC_INTFACE_NUM			(MJPEG_INTFACE_STREAM + 1)
 #define MEDIA_INTFACE_NUM		(UVC_INTFACE_NUM)
 
+/* ep0 request buffer, the largest control payload is struct imu_batch */
+#define USB_BUF_CTRL_SIZE		2048
+
 #define STRING_MANUFACTURER		1
 #define STRING_PRODUCT			2
 #define STRING_SERIAL			3
@@ -193,6 +193,7 @@ struct uvc_stream_header {
 #define XU_DISK_MODE       							0x02
 #define XU_BURNING_MODE       						0x03
 #define XU_IMU_DATA      							0x0c
+#define XU_IMU_BATCH      							0x0d
 
 
 /* VideoStreaming interface controls */
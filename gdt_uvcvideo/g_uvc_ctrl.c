@@ -11,6 +11,11 @@
 
 extern struct media_device *gMedia;
 static struct imu_data g_imudata;
+static struct imu_data g_imuring[IMU_KRING_SIZE];
+static u32 g_imuhead;
+static u32 g_imutail;
+static u32 g_imuseq;
+static u32 g_imulost;
 static int  g_devicemode=SENSOR_MODE0;
 
 static struct uvc_ctrl_device *gUvcCtrldev = NULL;
@@ -106,6 +111,15 @@ struct unit_control_info uvc_ctrls[] = {
 		.len  	= 56,//imu data struct importim can't set to 32
 		.unit_uniq_ctl = uvc_vc_default_ctl,
 	},
+	{
+		.id 	= UVC_UNIT_EXT_ID,
+		.cs 	= XU_IMU_BATCH,
+		.flags 	= UVC_CONTROL_GET_RANGE,
+		.res  	= 0x01,
+		.info 	= UVC_SUPPORT_GET_VALUE,
+		.len  	= sizeof(struct imu_batch),
+		.unit_uniq_ctl = uvc_vc_default_ctl,
+	},
 	{
 		.id 	= UVC_UNIT_EXT_ID,
 		.cs 	= XU_VIDEO_MODE,
@@ -327,6 +341,24 @@ static void uvc_data_setup(void *dst, u32 size, cmd_callback callback, u32 flags
 	req->complete = uvc_data_complete;
 }
 
+/* drain up to IMU_BATCH_MAX queued samples into one control transfer */
+static void imu_batch_get(struct imu_batch *batch)
+{
+	unsigned long flags;
+	u32 num, i;
+
+	spin_lock_irqsave(&gUvcCtrldev->imulock, flags);
+	num = min_t(u32, g_imuhead - g_imutail, IMU_BATCH_MAX);
+	for (i = 0; i < num; i++)
+		batch->samples[i] = g_imuring[(g_imutail + i) & (IMU_KRING_SIZE - 1)];
+	g_imutail += num;
+	batch->seq = g_imuseq++;
+	batch->num = num;
+	batch->lost = min_t(u32, g_imulost, 0xffff);
+	g_imulost = 0;
+	spin_unlock_irqrestore(&gUvcCtrldev->imulock, flags);
+}
+
 static int uvc_vc_default_ctl(struct unit_control_info *info, u8 req, u8 *data)
 {
 	if (!(req & info->flags))
@@ -342,6 +374,8 @@ static int uvc_vc_default_ctl(struct unit_control_info *info, u8 req, u8 *data)
 			spin_lock(&gUvcCtrldev->imulock);
 			memcpy(data, &g_imudata, sizeof(struct imu_data));
 			spin_unlock(&gUvcCtrldev->imulock);
+		} else if (info->id == UVC_UNIT_EXT_ID && info->cs == XU_IMU_BATCH) {
+			imu_batch_get((struct imu_batch *)data);
 		} else {
 			memcpy(data, &info->cur, info->len);
 		}
@@ -457,12 +491,19 @@ static int uvc_vc_ctrl(struct unit_control *uctl, const struct usb_ctrlrequest *
 	if (value < 0)
 		goto done;
 
+	/* a short read would drop the IMU samples the batch drains */
+	if (info->id == UVC_UNIT_EXT_ID && info->cs == XU_IMU_BATCH &&
+	    ctrl->bRequest == GET_CUR && w_length < sizeof(struct imu_batch)) {
+		value = -EINVAL;
+		goto done;
+	}
+
 	if (info->unit_uniq_ctl)
 		value = info->unit_uniq_ctl(info, ctrl->bRequest, data);
 	else
 		goto done;
 
-	value = w_length;
+	value = min_t(u16, w_length, USB_BUF_CTRL_SIZE);
 
 done:
 
@@ -590,24 +631,77 @@ static int uvc_ctrl_release(struct inode *inode, struct file *filp)
 	return 0;
 }
 
-static int write_imudata(struct uvc_ctrl_device *ctrldev, struct imu_data* data)
+/* caller holds imulock, the oldest samples go when the host does not keep up */
+static void imu_ring_put(const struct imu_data *data, u32 num)
+{
+	u32 i;
+
+	for (i = 0; i < num; i++) {
+		if (g_imuhead - g_imutail == IMU_KRING_SIZE) {
+			g_imutail++;
+			g_imulost++;
+		}
+		g_imuring[g_imuhead++ & (IMU_KRING_SIZE - 1)] = data[i];
+	}
+}
+
+static int write_imudata(struct uvc_ctrl_device *ctrldev, struct imu_data __user *udata)
+{
+	struct imu_data data;
+	unsigned long flags;
+
+	if (copy_from_user(&data, udata, sizeof(data)))
+		return -EFAULT;
+
+	spin_lock_irqsave(&ctrldev->imulock, flags);
+	memcpy(&g_imudata, &data, sizeof(struct imu_data));
+	imu_ring_put(&data, 1);
+	spin_unlock_irqrestore(&ctrldev->imulock, flags);
+	return 0;
+}
+
+/* one syscall for a whole batch of samples from sunny_lib */
+static int write_imubatch(struct uvc_ctrl_device *ctrldev, struct imu_batch __user *ubatch)
 {
-	spin_lock(&ctrldev->imulock);
-	memcpy(&g_imudata, data, sizeof(struct imu_data));
-	spin_unlock(&ctrldev->imulock);
+	struct imu_data *samples;
+	unsigned long flags;
+	u16 num;
+
+	if (get_user(num, &ubatch->num))
+		return -EFAULT;
+	if (num == 0 || num > IMU_BATCH_MAX)
+		return -EINVAL;
+
+	/* too big for the stack, and any number of processes may be in here */
+	samples = kmalloc(num * sizeof(struct imu_data), GFP_KERNEL);
+	if (samples == NULL)
+		return -ENOMEM;
+	if (copy_from_user(samples, ubatch->samples, num * sizeof(struct imu_data))) {
+		kfree(samples);
+		return -EFAULT;
+	}
+
+	spin_lock_irqsave(&ctrldev->imulock, flags);
+	memcpy(&g_imudata, &samples[num - 1], sizeof(struct imu_data));
+	imu_ring_put(samples, num);
+	spin_unlock_irqrestore(&ctrldev->imulock, flags);
+
+	kfree(samples);
 	return 0;
 }
 
 static long uvc_ctrl_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 {
 	struct uvc_ctrl_device *ctrldev = filp->private_data;
-	struct imu_data* imudata = NULL;
 	int retval = 0;
 
 	switch (cmd) {
 	case CTRL_SET_CMD:
-		imudata = (struct imu_data*)arg;
-		write_imudata(ctrldev, imudata);
+		retval = write_imudata(ctrldev, (struct imu_data __user *)arg);
+		break;
+
+	case CTRL_SET_IMU_BATCH:
+		retval = write_imubatch(ctrldev, (struct imu_batch __user *)arg);
 		break;
 
 	case CTRL_GET_CMD:
@@ -626,11 +720,18 @@ static long uvc_ctrl_ioctl(struct file *filp, unsigned int cmd, unsigned long ar
 	return retval;
 }
 
+/* ezybuf passes the real file, so use the device directly */
+static unsigned int uvc_ctrl_poll(struct file *filp, poll_table *wait)
+{
+	return drvbuf_poll(&gUvcCtrldev->vd_queue, filp, wait);
+}
+
 static struct file_operations uvc_ctrl_fops = {
 	.owner 	 		= THIS_MODULE,
 	.open  	 		= uvc_ctrl_open,
 	.release 		= uvc_ctrl_release,
 	.unlocked_ioctl = uvc_ctrl_ioctl,
+	.poll			= uvc_ctrl_poll,
 };
 
 int uvc_ctrl_init(struct usb_gadget *gadget)
@@ -639,6 +740,8 @@ int uvc_ctrl_init(struct usb_gadget *gadget)
 
 	struct uvc_ctrl_device *ctrldev = NULL;
 
+	BUILD_BUG_ON(sizeof(struct imu_batch) > USB_BUF_CTRL_SIZE);
+
 	ctrldev = kzalloc(sizeof(*ctrldev), GFP_KERNEL);
 	if (!ctrldev) {
 		printk("uvc kzalloc uvc control dev memory failed \n");
@@ -18,6 +18,7 @@
 #include <linux/moduleparam.h>
 #include <linux/vmalloc.h>
 #include <linux/pagemap.h>
+#include <linux/uaccess.h>
 #include <asm/page.h>
 #include <asm/pgtable.h>
 #include <asm/byteorder.h>
@@ -31,9 +32,10 @@
 
 #define	CTRL_DRIVER_NAME			"g_uvc_ctrl"
 #define	CTRL_IOC_BASE				'C'
-#define	CTRL_IOC_MAXNR				2
+#define	CTRL_IOC_MAXNR				3
 #define	CTRL_SET_CMD				_IOW(CTRL_IOC_BASE,  1, struct imu_data *)
 #define	CTRL_GET_CMD				_IOR(CTRL_IOC_BASE,  2, struct uvc_cmd *)
+#define	CTRL_SET_IMU_BATCH			_IOW(CTRL_IOC_BASE,  3, struct imu_batch *)
 
 #define DEVICE_CMD_UNKNOWN			0x00
 #define DEVICE_PW_SV				0x01
@@ -118,6 +120,21 @@ struct imu_data {
 
 #define IMU_SIZE   sizeof(struct imu_data)
 
+/*
+ * XU_IMU_BATCH payload, also the CTRL_SET_IMU_BATCH argument. on GET_CUR
+ * the host gets every sample queued since its last read, oldest first,
+ * lost counts samples overwritten because the host fell behind.
+ */
+#define IMU_BATCH_MAX				32
+#define IMU_KRING_SIZE				256		/* power of two */
+
+struct imu_batch {
+	u32 seq;
+	u16 num;
+	u16 lost;
+	struct imu_data samples[IMU_BATCH_MAX];
+};
+
 void uvc_ctrl_uninit(void);
 int uvc_ctrl_init(struct usb_gadget *gadget);
 int uvc_media_cmd_put(u32 cmd, u32 data);
@@ -199,15 +199,7 @@ void mjpeg_config_reset(void)
 	struct video_device *mjpegdev = gMJPEGdev;
 
 	if (mjpegdev->ep_datain) {
-		if (mjpegdev->req)
-			usb_ep_dequeue(mjpegdev->ep_datain, mjpegdev->req);
-
-		if (mjpegdev->req)
-			usb_ep_free_request(mjpegdev->ep_datain, mjpegdev->req);
-
-		mjpegdev->req = NULL;
-
-		mjpegdev->sstatus = STREAME_STOP;
+		video_stream_xfer_stop(mjpegdev);
 		usb_ep_disable(mjpegdev->ep_datain);
 		mjpegdev->ep_datain = NULL;
 	}
@@ -290,6 +282,17 @@ static struct file_operations mjpeg_fops = {
 	.release = mjpeg_release,
 };
 
+/* filled buffer queued, restart the stream if it ran dry */
+static int mjpeg_qbuf(struct ezybuf_queue *q, void *priv, struct ezybuf_buffer *eb)
+{
+	video_stream_kick((struct video_device *)priv);
+	return 0;
+}
+
+static struct ezybuf_hops mjpeg_hops = {
+	.qbuf	 = mjpeg_qbuf,
+};
+
 int mjpeg_init(struct usb_gadget *gadget, unsigned long addr_offset)
 {
 	struct video_device *mjpegdev = NULL;
@@ -321,7 +324,7 @@ int mjpeg_init(struct usb_gadget *gadget, unsigned long addr_offset)
 	media_fun_put(mjpeg_function);
 
 	mjpegdev->gadget = gadget;
-	mjpegdev->packetlen = __constant_cpu_to_le16(MAX_PAYLOAD_LEN);
+	mjpegdev->packetlen = MAX_PAYLOAD_LEN;
 	mjpegdev->addr_offset = addr_offset;
 	retval = ezybuf_queue_init(&mjpegdev->buf_queue, &mjpeg_fops, sizeof(struct ezybuf_buffer), 0, MJPEG_DRIVER_NAME, mjpegdev);
 	if (retval < 0) {
@@ -329,6 +332,18 @@ int mjpeg_init(struct usb_gadget *gadget, unsigned long addr_offset)
 		goto done;
 	}
 
+	mjpegdev->buf_queue.hops = &mjpeg_hops;
+	mjpegdev->buf_queue.dma_dev = gadget->dev.parent;
+
+	retval = video_reqs_alloc(mjpegdev, ep);
+	if (retval < 0) {
+		printk("video_reqs_alloc fail %d\n", retval);
+		ezybuf_queue_cancel(&mjpegdev->buf_queue);
+		goto done;
+	}
+
+	video_debugfs_init(mjpegdev, MJPEG_DRIVER_NAME);
+
 	printk("DATAIN-%s\n", EP_DATAIN_NAME_MJPEG);
 
 	return 0;
@@ -343,6 +358,8 @@ void mjpeg_uninit(void)
 {
 	struct video_device *mjpegdev = gMJPEGdev;
 
+	video_debugfs_cleanup(mjpegdev);
+	video_reqs_free(mjpegdev);
 	ezybuf_queue_cancel(&mjpegdev->buf_queue);
 
 	if (gMJPEGdev)
@@ -15,6 +15,12 @@
 #include <linux/moduleparam.h>
 #include <linux/vmalloc.h>
 #include <linux/pagemap.h>
+#include <linux/dma-mapping.h>
+#include <linux/ktime.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/scatterlist.h>
+#include <linux/workqueue.h>
 
 #include <asm/page.h>
 #include <asm/pgtable.h>
@@ -33,13 +39,13 @@
 #include "g_uvc_mjpeg.h"
 
 
-struct wait_param {
-	struct work_struct my_work;
-	struct usb_ep *ep;
-	struct usb_request *req;
-};
+static unsigned int video_reqs = 4;
+module_param(video_reqs, uint, S_IRUGO);
+MODULE_PARM_DESC(video_reqs, "Video stream requests in flight (1-32)");
 
-struct wait_param  epwork;
+static bool video_sg = 1;
+module_param(video_sg, bool, S_IRUGO);
+MODULE_PARM_DESC(video_sg, "Send frame data in place where the UDC supports scatter-gather");
 
 static struct usb_interface_assoc_descriptor uvc_iad_desc = {
 	.bLength 			= sizeof(uvc_iad_desc),
@@ -105,7 +111,7 @@ static struct uvc_vc_extension_unit_desciptor uvc_vc_extunit_desc = {
 	.baSourceID[0]		= UVC_UNIT_PUNIT_ID,
 	.bControlSize 		= VC_EXT_UNIT_CONTROL_SIZE,
 	.bmControls[0]		= 0x07,
-	.bmControls[1]		= 0x08,
+	.bmControls[1]		= 0x18,
 	.iExtension 		= VC_EXT_UNIT_EXTENSION,
 };
 
@@ -144,104 +150,194 @@ static const struct usb_descriptor_header *video_function[] = {
 	NULL,
 };
 
-void wait_agent_fn(struct work_struct *data)
+void video_reqs_free(struct video_device *videodev)
 {
-	struct wait_param * pwait;
-	struct video_device *streamdev = NULL;
+	struct video_req *vreq;
+	unsigned int i;
 
-	if (data == NULL) {
-		printk("error no valid param \n");
-		return;
+	/* waits for a payload still being copied */
+	if (videodev->pump_wq) {
+		destroy_workqueue(videodev->pump_wq);
+		videodev->pump_wq = NULL;
 	}
 
-	pwait = (struct wait_param *)data;
-	if (pwait->ep && pwait->req) {
-		streamdev = (struct video_device *)pwait->ep->driver_data;
-		if (streamdev->sstatus == STREAME_XFER) {
-			video_stream_xfer_complete(pwait->ep, pwait->req);
-		}
+	if (videodev->vreqs == NULL)
+		return;
+
+	for (i = 0; i < videodev->nreqs; i++) {
+		vreq = &videodev->vreqs[i];
+		if (vreq->req)
+			usb_ep_free_request(vreq->ep, vreq->req);
+		kfree(vreq->buf);
 	}
+
+	kfree(videodev->vreqs);
+	videodev->vreqs = NULL;
+	videodev->nreqs = 0;
+	INIT_LIST_HEAD(&videodev->req_free);
 }
 
-void video_stream_xfer_complete(struct usb_ep *ep, struct usb_request *req)
+/* requests and their buffers for the whole lifetime of the function, the
+ * stream is started from the setup handler where nothing can be allocated.
+ * With scatter-gather a request only owns the stream header, the payload
+ * is taken from the frame; otherwise header and a copy of the payload are
+ * built in a buffer of packetlen */
+int video_reqs_alloc(struct video_device *videodev, struct usb_ep *ep)
 {
-	int ebstatus = 0;
-	int  retval = req->status;
-	struct video_buffer *videobuf = req->context;
-	struct video_device *videodev = ep->driver_data;
-	struct ezybuf_buffer *ebuf = NULL;
-	struct uvc_stream_header *uvchd = NULL;
-	u16 packetlen = videodev->packetlen;
-	int bytesused = 0;
-	u32 cur_frame;
-	u32 byteslen = 0;
-	u8 uvc_fid = 0;
-	struct timeval scr_time;
-	unsigned long flags;
-	switch (retval) {
-	case 0:
-		break;
-	case -EOVERFLOW:
+	struct video_req *vreq;
+	unsigned int nreqs = clamp_t(unsigned int, video_reqs, 1, UVC_VIDEO_REQS_MAX);
+	unsigned int bufsize;
+	unsigned int i;
+
+	INIT_LIST_HEAD(&videodev->req_free);
+
+	/* a payload from an imported frame takes up to one entry per page */
+	videodev->use_sg = video_sg && videodev->gadget->sg_supported &&
+		1 + DIV_ROUND_UP(videodev->packetlen - UVC_HLE + PAGE_SIZE - 1, PAGE_SIZE) <= UVC_VIDEO_SG_MAX;
+	bufsize = videodev->use_sg ? UVC_HLE : videodev->packetlen;
+
+	/* copied payloads are built here, not in the completion */
+	INIT_WORK(&videodev->pump_work, video_stream_pump_work);
+	videodev->pump_wq = alloc_ordered_workqueue("uvc_video", WQ_HIGHPRI);
+	if (videodev->pump_wq == NULL)
+		return -ENOMEM;
+
+	videodev->vreqs = kcalloc(nreqs, sizeof(*vreq), GFP_KERNEL);
+	if (videodev->vreqs == NULL) {
+		video_reqs_free(videodev);
+		return -ENOMEM;
+	}
 
-	case -EREMOTEIO:
-		break;
-	case -ECONNABORTED:
-	case -ECONNRESET:
-	case -ESHUTDOWN:
-		if (videobuf->ebuf) {
-			ezybuf_wakeup(videobuf->ebuf, EBUF_DONE);
+	videodev->nreqs = nreqs;
+	for (i = 0; i < nreqs; i++) {
+		vreq = &videodev->vreqs[i];
+		vreq->ep = ep;
+		vreq->videodev = videodev;
+		vreq->buf = kmalloc(bufsize, GFP_KERNEL);
+		vreq->req = usb_ep_alloc_request(ep, GFP_KERNEL);
+		if (vreq->buf == NULL || vreq->req == NULL) {
+			video_reqs_free(videodev);
+			return -ENOMEM;
 		}
 
-		videodev->sstatus=STREAME_STOP;
+		vreq->req->buf = vreq->buf;
+		vreq->req->complete = video_stream_xfer_complete;
+		vreq->req->context = vreq;
+		if (videodev->use_sg)
+			vreq->req->sg = vreq->sg;
+		list_add_tail(&vreq->list, &videodev->req_free);
+	}
 
+	printk("video stream: %u requests of %u bytes, %s\n", nreqs, videodev->packetlen,
+		videodev->use_sg ? "scatter-gather" : "copied");
+
+	return 0;
+}
+
+/* hands the frame being split back to user space, streamlock held */
+static void video_frame_release(struct video_buffer *videobuf)
+{
+	if (videobuf->ebuf) {
+		ezybuf_wakeup(videobuf->ebuf, EBUF_DONE);
 		videobuf->ebuf = NULL;
-		printk("%s gone (%d), %d/%d\n", ep->name, retval, req->actual, req->length);
-		return;
-	default:
-		break;
 	}
+}
 
-	if(videodev->sstatus == STREAME_STOP)
-		return ;
+/* header and payload slice into vreq->sg; a frame in the linear mapping is
+ * one entry, an imported one is taken from the pages of its attachment */
+static void video_payload_sg(struct video_req *vreq, struct ezybuf_buffer *ebuf, unsigned long vaddr, int len)
+{
+	struct scatterlist *sg;
+	unsigned long offset;
+	unsigned int n = 0;
+	unsigned int i;
+	int chunk;
 
-	if (videobuf->done) {
-		if (videobuf->ebuf) {
-			ezybuf_wakeup(videobuf->ebuf, EBUF_DONE);
-		}
-		ebuf = ezybuf_dqbuf_user(&videodev->buf_queue);
-		if (ebuf == NULL) {
-			ebstatus = -1;
-		} else if (!ebuf->bytesused) {
-			if (ebuf) {
-				ezybuf_wakeup(ebuf, EBUF_DONE);
+	sg_init_table(vreq->sg, ARRAY_SIZE(vreq->sg));
+	sg_set_buf(&vreq->sg[n++], vreq->buf, UVC_HLE);
+
+	if (ebuf->sgt == NULL) {
+		sg_set_buf(&vreq->sg[n++], (void *)vaddr, len);
+	} else {
+		offset = vaddr - ebuf->vaddr;
+		for_each_sg(ebuf->sgt->sgl, sg, ebuf->sgt->orig_nents, i) {
+			if (len <= 0 || n >= ARRAY_SIZE(vreq->sg))
+				break;
+			if (offset >= sg->length) {
+				offset -= sg->length;
+				continue;
 			}
 
-			ebstatus = -2;
+			chunk = min_t(int, len, sg->length - offset);
+			offset += sg->offset;
+			sg_set_page(&vreq->sg[n++], nth_page(sg_page(sg), offset >> PAGE_SHIFT), chunk, offset_in_page(offset));
+			offset = 0;
+			len -= chunk;
 		}
+	}
 
-		if (ebstatus) {
-			epwork.ep =  ep;
-			epwork.req = req;
-			//printk("schedule_work ebstatus=%d \n",ebstatus);
-			schedule_work(&(epwork.my_work));
-			return;
+	sg_mark_end(&vreq->sg[n - 1]);
+	vreq->req->num_sgs = n;
+}
+
+/* copies the payload slice of vreq into its buffer; an imported frame is
+ * read between begin and end_cpu_access, the exporter makes it coherent
+ * for the CPU there. May sleep, streamlock not held */
+static void video_payload_copy(struct video_req *vreq)
+{
+	struct ezybuf_buffer *ebuf = vreq->ebuf;
+	size_t len = vreq->req->length - UVC_HLE;
+	size_t start;
+
+	if (ebuf->dbuf == NULL) {
+		memcpy(vreq->buf + UVC_HLE, vreq->copy_from, len);
+		return;
+	}
+
+	start = (unsigned long)vreq->copy_from - ebuf->vaddr;
+	if (dma_buf_begin_cpu_access(ebuf->dbuf, start, len, DMA_TO_DEVICE) < 0)
+		printk("video stream: no cpu access to dma-buf, payload may be stale\n");
+	memcpy(vreq->buf + UVC_HLE, vreq->copy_from, len);
+	dma_buf_end_cpu_access(ebuf->dbuf, start, len, DMA_TO_DEVICE);
+}
+
+/* builds the next payload in vreq: stream header and the next slice of the
+ * current frame; streamlock held */
+static int video_encode_payload(struct video_device *videodev, struct video_req *vreq)
+{
+	struct video_buffer *videobuf = &videodev->videobuf;
+	struct ezybuf_buffer *ebuf = videobuf->ebuf;
+	struct uvc_stream_header *uvchd = (struct uvc_stream_header *)vreq->buf;
+	struct device *dev = videodev->gadget->dev.parent;
+	struct timeval scr_time;
+	dma_addr_t dma;
+	u32 cur_frame;
+	int bytesused;
+
+	if (ebuf == NULL) {
+		while ((ebuf = ezybuf_dqbuf_user(&videodev->buf_queue)) != NULL) {
+			if (ebuf->bytesused)
+				break;
+
+			ezybuf_wakeup(ebuf, EBUF_DONE);
 		}
 
+		if (ebuf == NULL)
+			return -EAGAIN;
+
 		videobuf->ebuf = ebuf;
-		if (ebuf->bytesused <= (packetlen - UVC_HLE)) {
-			videobuf->done = 1;
-			byteslen  = ebuf->bytesused + UVC_HLE;
-			bytesused = ebuf->bytesused;
-		} else {
-			videobuf->done = 0;
-			byteslen  = packetlen;
-			bytesused = packetlen - UVC_HLE;
+		videobuf->vaddr = ebuf->vaddr + ebuf->headlen;
+		videobuf->bytesremain = ebuf->bytesused;
+
+		/* user space fills the frame through an uncached mapping, drop
+		 * what the kernel mapping may still hold of the last copy;
+		 * imported frames are synced by their exporter on every copy */
+		if (!videodev->use_sg && ebuf->dbuf == NULL) {
+			dma = dma_map_single(dev, (void *)videobuf->vaddr, ebuf->bytesused, DMA_FROM_DEVICE);
+			if (!dma_mapping_error(dev, dma))
+				dma_unmap_single(dev, dma, ebuf->bytesused, DMA_FROM_DEVICE);
 		}
 
-		videobuf->vaddr = ebuf->vaddr + ebuf->headlen - UVC_HLE;
-		videobuf->offset = ebuf->phyaddr + ebuf->headlen - UVC_HLE;
-
-		uvchd = (struct uvc_stream_header *)videobuf->vaddr;
 		videobuf->uvc_fid ^= UVC_FID;
 		uvchd->bmHeaderInfo = videobuf->uvc_fid | UVC_SCR | UVC_PTS | UVC_EOH;
 
@@ -250,88 +346,307 @@ void video_stream_xfer_complete(struct usb_ep *ep, struct usb_request *req)
 
 		uvchd->dwPresentationTime = scr_time.tv_usec;
 		uvchd->scrSourceClock = (((u64)cur_frame & 0x7ff) << 32)  | ((scr_time.tv_sec * 1000000) + scr_time.tv_usec);
+	} else {
+		uvchd->bmHeaderInfo = videobuf->uvc_fid | UVC_EOH;
+	}
 
-		uvchd->bHeaderLength = UVC_HLE;
-		videobuf->bytesremain = ebuf->bytesused - bytesused;
+	uvchd->bHeaderLength = UVC_HLE;
 
-	} else {
-		bytesused =  packetlen - UVC_HLE;
-		if ((videobuf->bytesremain - bytesused) > 0) {
-			byteslen  = packetlen;
-			videobuf->bytesremain -= bytesused;
-		} else {
-			byteslen  = videobuf->bytesremain + UVC_HLE;
-			bytesused = videobuf->bytesremain;
-
-			videobuf->done = 1;
-			uvc_fid = UVC_EOF;
-		}
+	bytesused = min_t(int, videobuf->bytesremain, videodev->packetlen - UVC_HLE);
+	if (videodev->use_sg)
+		video_payload_sg(vreq, ebuf, videobuf->vaddr, bytesused);
+	else
+		vreq->copy_from = (void *)videobuf->vaddr;
+	videobuf->vaddr += bytesused;
+	videobuf->bytesremain -= bytesused;
 
-		uvchd = (struct uvc_stream_header *)videobuf->vaddr;
-		uvchd->bmHeaderInfo = videobuf->uvc_fid | uvc_fid | UVC_EOH;
-		uvchd->bHeaderLength = UVC_HLE;
+	vreq->ebuf = ebuf;
+	vreq->eof = (videobuf->bytesremain == 0);
+	if (vreq->eof) {
+		uvchd->bmHeaderInfo |= UVC_EOF;
+		videobuf->ebuf = NULL;
 	}
 
+	vreq->req->length = UVC_HLE + bytesused;
 
-	if (req != NULL) {
-		req->buf = (void *)videobuf->vaddr;
-		req->dma = videobuf->offset;
-		req->length = byteslen;
+	return 0;
+}
+
+/* first payload queued after the link ran dry; streamlock held */
+static void video_stream_restarted(struct video_device *videodev)
+{
+	ktime_t now = ktime_get();
+	u32 us;
+
+	us = ktime_us_delta(now, videodev->starved_since);
+	videodev->stats.starvations++;
+	videodev->stats.idle_us += us;
+	if (us > videodev->stats.idle_us_max)
+		videodev->stats.idle_us_max = us;
+
+	if (videodev->kicked) {
+		us = ktime_us_delta(now, videodev->kick_time);
+		videodev->stats.restarts++;
+		videodev->stats.restart_us += us;
+		if (us > videodev->stats.restart_us_max)
+			videodev->stats.restart_us_max = us;
 	}
 
-	if (videobuf == NULL) {
-		printk("videobuf==NULL xxxxxxxxxxxxxx\n");
-		return;
+	videodev->starved = 0;
+	videodev->kicked = 0;
+}
+
+/* fills and queues every idle request; payloads are queued in frame order
+ * under streamlock, completions come back in the same order. A copied
+ * payload is built with streamlock dropped, which is only safe because the
+ * copy path pumps from the one ordered work item alone */
+static void video_stream_pump(struct video_device *videodev)
+{
+	struct video_req *vreq;
+	unsigned long flags;
+	int retval;
+
+	spin_lock_irqsave(&videodev->streamlock, flags);
+
+	while (videodev->sstatus == STREAME_XFER && !list_empty(&videodev->req_free)) {
+		vreq = list_first_entry(&videodev->req_free, struct video_req, list);
+
+		if (video_encode_payload(videodev, vreq) < 0) {
+			/* the link runs dry when the last request is back, the
+			 * next qbuf restarts it through video_stream_kick() */
+			if (videodev->nqueued == 0 && videodev->stats.frames && !videodev->starved) {
+				videodev->starved = 1;
+				videodev->kicked = 0;
+				videodev->starved_since = ktime_get();
+			}
+			break;
+		}
+
+		if (videodev->starved)
+			video_stream_restarted(videodev);
+
+		/* counted from here, the frame is held while the payload is copied */
+		list_del_init(&vreq->list);
+		videodev->nqueued++;
+
+		if (!videodev->use_sg) {
+			spin_unlock_irqrestore(&videodev->streamlock, flags);
+			video_payload_copy(vreq);
+			spin_lock_irqsave(&videodev->streamlock, flags);
+		}
+
+		retval = -ESHUTDOWN;
+		if (videodev->sstatus == STREAME_XFER)
+			retval = usb_ep_queue(videodev->ep_datain, vreq->req, GFP_ATOMIC);
+		if (retval != 0) {
+			if (videodev->sstatus == STREAME_XFER)
+				printk("usb_ep_queue tranfer video data error= %d!!!!\n", retval);
+			videodev->nqueued--;
+			list_add(&vreq->list, &videodev->req_free);
+			if (vreq->eof)
+				ezybuf_wakeup(vreq->ebuf, EBUF_DONE);
+			vreq->ebuf = NULL;
+			videodev->sstatus = STREAME_STOP;
+			if (videodev->nqueued == 0)
+				video_frame_release(&videodev->videobuf);
+			break;
+		}
 	}
 
-	if (videobuf != NULL) {
-		videobuf->vaddr  += bytesused;
-		videobuf->offset += bytesused;
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
+}
+
+void video_stream_pump_work(struct work_struct *work)
+{
+	video_stream_pump(container_of(work, struct video_device, pump_work));
+}
+
+/* scatter-gather payloads are only a few table entries and are queued
+ * right away, a copy of up to packetlen is left to the work item */
+static void video_stream_schedule(struct video_device *videodev)
+{
+	if (videodev->use_sg)
+		video_stream_pump(videodev);
+	else
+		queue_work(videodev->pump_wq, &videodev->pump_work);
+}
+
+/* a filled frame was queued by user space */
+void video_stream_kick(struct video_device *videodev)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&videodev->streamlock, flags);
+	if (videodev->starved && !videodev->kicked) {
+		videodev->kicked = 1;
+		videodev->kick_time = ktime_get();
 	}
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
 
-	if (videodev->ep_datain == NULL) {
-		printk("ep_datain==NULL xxxxxxxxxxxxx\n");
-		return;
+	video_stream_schedule(videodev);
+}
+
+void video_stream_xfer_complete(struct usb_ep *ep, struct usb_request *req)
+{
+	int retval = req->status;
+	struct video_req *vreq = req->context;
+	struct video_device *videodev = vreq->videodev;
+	unsigned long flags;
+	int gone = 0;
+
+	switch (retval) {
+	case 0:
+		break;
+	case -EOVERFLOW:
+
+	case -EREMOTEIO:
+		break;
+	case -ECONNABORTED:
+	case -ECONNRESET:
+	case -ESHUTDOWN:
+		printk("%s gone (%d), %d/%d\n", ep->name, retval, req->actual, req->length);
+		gone = 1;
+		break;
+	default:
+		break;
 	}
 
-	retval = usb_ep_queue(videodev->ep_datain, req, GFP_ATOMIC);
-	if (retval != 0) {
-		printk("usb_ep_queue tranfer video data error= %d!!!!\n", retval);
+	spin_lock_irqsave(&videodev->streamlock, flags);
+
+	videodev->nqueued--;
+	videodev->stats.bytes += req->actual;
+	if (vreq->eof) {
+		ezybuf_wakeup(vreq->ebuf, EBUF_DONE);
+		if (!gone)
+			videodev->stats.frames++;
 	}
+	vreq->ebuf = NULL;
+	vreq->eof = 0;
+	list_add_tail(&vreq->list, &videodev->req_free);
+
+	if (gone)
+		videodev->sstatus = STREAME_STOP;
+
+	/* requests in flight may still send from the frame being split */
+	if (videodev->sstatus == STREAME_STOP && videodev->nqueued == 0)
+		video_frame_release(&videodev->videobuf);
+
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
 
+	if (!gone)
+		video_stream_schedule(videodev);
 }
 
 int video_stream_xfer_start(struct video_device *videodev)
 {
-	int	retval = 0;
-	struct usb_request	*req;
-	struct video_buffer *videobuf = NULL;
-	struct uvc_stream_header *vshead;
-
-	videobuf = &videodev->videobuf;
-	videobuf->done = 1;
-	vshead = &videobuf->vshead;
-	vshead->bmHeaderInfo =  UVC_EOH;
-	vshead->bHeaderLength = 2;
-
-	if (videodev->req == NULL) {
-		videodev->req = usb_ep_alloc_request(videodev->ep_datain, GFP_ATOMIC);
-		if (videodev->req == NULL)
-			return -ENOMEM;
+	unsigned long flags;
+
+	if (videodev->vreqs == NULL)
+		return -ENOMEM;
+
+	spin_lock_irqsave(&videodev->streamlock, flags);
+	/* left over from a stream stopped in the middle of a frame */
+	if (videodev->nqueued == 0)
+		video_frame_release(&videodev->videobuf);
+	videodev->starved = 0;
+	videodev->kicked = 0;
+	memset(&videodev->stats, 0, sizeof(videodev->stats));
+	videodev->stats.start = ktime_get();
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
+
+	video_stream_schedule(videodev);
+
+	return 0;
+}
+
+void video_stream_xfer_stop(struct video_device *videodev)
+{
+	unsigned long flags;
+	u32 queued = 0;
+	s64 ms;
+	unsigned int i;
+
+	spin_lock_irqsave(&videodev->streamlock, flags);
+	videodev->sstatus = STREAME_STOP;
+	for (i = 0; i < videodev->nreqs; i++) {
+		if (list_empty(&videodev->vreqs[i].list))
+			queued |= 1U << i;
+	}
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
+
+	/* completions of dequeued requests take streamlock */
+	for (i = 0; i < videodev->nreqs; i++) {
+		if (queued & (1U << i))
+			usb_ep_dequeue(videodev->ep_datain, videodev->vreqs[i].req);
 	}
 
-	req = videodev->req;
-	req->buf = (void *)vshead;
-	req->length = 2;
-	req->complete = video_stream_xfer_complete;
-	req->context = videobuf;
-	retval = usb_ep_queue(videodev->ep_datain, req, GFP_ATOMIC);
-	if (retval != 0) {
-		printk("usb_ep_queue error\n");
+	/* dequeued requests complete asynchronously and may still send from
+	 * the frame being split, the last completion releases it then */
+	spin_lock_irqsave(&videodev->streamlock, flags);
+	if (videodev->nqueued == 0)
+		video_frame_release(&videodev->videobuf);
+	videodev->stats.stop = ktime_get();
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
+
+	ms = ktime_ms_delta(videodev->stats.stop, videodev->stats.start);
+	printk("video stream: %u frames, %llu bytes in %lld ms, %u starvations\n",
+		videodev->stats.frames, videodev->stats.bytes, ms, videodev->stats.starvations);
+}
+
+static int video_stats_show(struct seq_file *s, void *unused)
+{
+	struct video_device *videodev = s->private;
+	struct video_stats stats;
+	unsigned long flags;
+	ktime_t end;
+
+	spin_lock_irqsave(&videodev->streamlock, flags);
+	stats = videodev->stats;
+	end = (videodev->sstatus == STREAME_XFER) ? ktime_get() : stats.stop;
+	spin_unlock_irqrestore(&videodev->streamlock, flags);
+
+	seq_printf(s, "frames: %u\n", stats.frames);
+	seq_printf(s, "bytes: %llu\n", stats.bytes);
+	seq_printf(s, "time_ms: %lld\n", ktime_ms_delta(end, stats.start));
+	seq_printf(s, "starvations: %u\n", stats.starvations);
+	seq_printf(s, "idle_us: %llu\n", stats.idle_us);
+	seq_printf(s, "idle_us_max: %u\n", stats.idle_us_max);
+	seq_printf(s, "restarts: %u\n", stats.restarts);
+	seq_printf(s, "restart_us: %llu\n", stats.restart_us);
+	seq_printf(s, "restart_us_max: %u\n", stats.restart_us_max);
+
+	return 0;
+}
+
+static int video_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, video_stats_show, inode->i_private);
+}
+
+static const struct file_operations video_stats_fops = {
+	.owner		= THIS_MODULE,
+	.open		= video_stats_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+/* <debugfs>/<name>/stats: counters of the current or last stream */
+void video_debugfs_init(struct video_device *videodev, const char *name)
+{
+	videodev->debugfs = debugfs_create_dir(name, NULL);
+	if (IS_ERR_OR_NULL(videodev->debugfs)) {
+		videodev->debugfs = NULL;
+		return;
 	}
 
-	return retval;
+	debugfs_create_file("stats", S_IRUGO, videodev->debugfs, videodev, &video_stats_fops);
+}
 
+void video_debugfs_cleanup(struct video_device *videodev)
+{
+	debugfs_remove_recursive(videodev->debugfs);
+	videodev->debugfs = NULL;
 }
 
 
@@ -357,8 +672,6 @@ int video_init(struct usb_gadget *gadget)
 		goto ctrl_done;
 	}
 
-	INIT_WORK(&(epwork.my_work), wait_agent_fn);
-
 	return 0;
 
 ctrl_done:
@@ -11,37 +11,89 @@ enum stream_status {
 	STREAME_XFER,
 };
 
+#define UVC_VIDEO_REQS_MAX	32
+#define UVC_VIDEO_SG_MAX	16	/* header and the pages of a vmapped payload */
+
+struct video_device;
+
+/* one request of the pool; the stream header is built in buf, the payload
+ * follows it in buf or in the next entries of sg */
+struct video_req {
+	struct list_head list;		/* on req_free while not queued */
+	struct usb_ep *ep;
+	struct usb_request *req;
+	struct video_device *videodev;
+	struct ezybuf_buffer *ebuf;	/* frame the payload is taken from */
+	u32 eof;					/* last payload of ebuf */
+	void *copy_from;			/* payload to copy into buf, without sg */
+	u8 *buf;
+	struct scatterlist sg[UVC_VIDEO_SG_MAX];
+};
+
+/* counters of the current or last stream */
+struct video_stats {
+	u32 frames;
+	u64 bytes;
+	ktime_t start;
+	ktime_t stop;
+	u32 starvations;			/* link ran dry for want of a filled frame */
+	u64 idle_us;
+	u32 idle_us_max;
+	u32 restarts;				/* restarts by a qbuf while dry */
+	u64 restart_us;				/* qbuf to first payload queued */
+	u32 restart_us_max;
+};
+
 struct video_buffer {
 	u8 uvc_fid;
-	struct ezybuf_buffer *ebuf;
-	u32 done;
+	struct ezybuf_buffer *ebuf;	/* frame being split, NULL between frames */
 	int bytesremain;
 	unsigned long vaddr;
-	unsigned long offset;
 
 	unsigned long vaddrremain;
 	unsigned int siezremain;
-	struct uvc_stream_header vshead;
 };
 
 struct video_device {
 	struct usb_gadget *gadget;
 	struct usb_ep *ep_datain;
-	struct usb_request *req;
-	u16 packetlen;
+	struct video_req *vreqs;
+	unsigned int nreqs;
+	unsigned int nqueued;
+	struct list_head req_free;
+	u32 use_sg;
+	u32 packetlen;
 	struct ezybuf_queue buf_queue;
 	struct video_buffer videobuf;
 	unsigned long addr_offset;
 	enum stream_status sstatus;
 	spinlock_t  streamlock;
+	struct workqueue_struct *pump_wq;
+	struct work_struct pump_work;
+
+	u32 starved;
+	ktime_t starved_since;
+	u32 kicked;					/* filled frame queued while starved */
+	ktime_t kick_time;
+	struct video_stats stats;
+	struct dentry *debugfs;
 };
 
 
 int video_init(struct usb_gadget *gadget);
 void video_uninit(void);
 
+int video_reqs_alloc(struct video_device *videodev, struct usb_ep *ep);
+void video_reqs_free(struct video_device *videodev);
+
 int video_stream_xfer_start(struct video_device *videodev);
+void video_stream_xfer_stop(struct video_device *videodev);
+void video_stream_kick(struct video_device *videodev);
 void video_stream_xfer_complete(struct usb_ep *ep, struct usb_request *req);
+void video_stream_pump_work(struct work_struct *work);
+
+void video_debugfs_init(struct video_device *videodev, const char *name);
+void video_debugfs_cleanup(struct video_device *videodev);
 
 
 
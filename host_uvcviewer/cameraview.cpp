@@ -18,12 +18,23 @@ CameraView::CameraView(QWidget *parent):QGraphicsView(parent)
 CameraView::~CameraView()
 {
 
+}
+//images come from the capture thread, one in flight at a time
+bool CameraView::claim(void)
+{
+    return pending.testAndSetAcquire(0, 1);
 }
 void CameraView::display(QImage* img)
 {
     pix->setPixmap(QPixmap::fromImage(*img));
+    delete img;
+    pending.fetchAndStoreRelease(0);
     cvWaitKey(0);
 }
+bool CameraView::save(const QString &filename)
+{
+    return pix->pixmap().save(filename, "PNG");
+}
 void CameraView::wheelEvent(QWheelEvent* event)
 {
     //Scale the view ie. do the zoom
@@ -5,6 +5,7 @@
 #include <QWheelEvent>
 #include <QMouseEvent>
 #include <QGraphicsLineItem>
+#include <QAtomicInt>
 
 
 class CameraView: public QGraphicsView
@@ -13,6 +14,8 @@ class CameraView: public QGraphicsView
 public:
     explicit CameraView(QWidget *parent = 0);
         ~CameraView();
+    bool claim(void);
+    bool save(const QString &filename);
 signals:
     void  sendpostion(int ,int );
 private slots:
@@ -25,5 +28,6 @@ private:
     QGraphicsScene *QScene;
     QGraphicsLineItem *hline;
     QGraphicsLineItem *sline;
+    QAtomicInt pending;
 };
 #endif
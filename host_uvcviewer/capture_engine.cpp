@@ -0,0 +1,535 @@
+#include "capture_engine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <linux/videodev2.h>
+
+#define CLEAR(x) memset(&(x), 0, sizeof(x))
+
+#define CAPTURE_POLL_MS			1000
+
+struct capture_buf_s {
+	void *start;
+	size_t length;
+};
+
+struct capture_entry_s {
+	int buf;
+	unsigned int bytesused;
+	unsigned int sequence;
+	unsigned int index;
+	long long timestamp_us;
+	long long dequeue_us;
+};
+
+struct capture_worker_s {
+	struct capture_engine_s *eng;
+	pthread_t tid;
+	int id;
+	void *data;
+	size_t size;
+};
+
+struct capture_engine_s {
+	int fd;
+	int stop_fd;
+	struct capture_config_s cfg;
+
+	struct capture_res_s res[CAPTURE_MAX_RES];
+	int num_res;
+	unsigned int frame_size;
+
+	struct capture_buf_s bufs[CAPTURE_MAX_BUFS];
+	int nbufs;
+
+	/* bounded queue of dequeued buffers, dequeue thread -> workers */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	struct capture_entry_s queue[CAPTURE_MAX_BUFS];
+	int head;
+	int count;
+	int stopping;
+
+	pthread_t dq_tid;
+	struct capture_worker_s workers[CAPTURE_MAX_WORKERS];
+	int running;
+	unsigned int next_index;
+
+	struct capture_stats_s stats;
+};
+
+static int xioctl(int fh, int request, void *arg)
+{
+	int r;
+
+	do {
+		r = ioctl(fh, request, arg);
+	} while (-1 == r && EINTR == errno);
+
+	return r;
+}
+
+long long capture_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+static int capture_qbuf(struct capture_engine_s *eng, int index)
+{
+	struct v4l2_buffer buf;
+
+	CLEAR(buf);
+	buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buf.memory = V4L2_MEMORY_MMAP;
+	buf.index = index;
+	if (-1 == xioctl(eng->fd, VIDIOC_QBUF, &buf)) {
+		fprintf(stderr, "capture: VIDIOC_QBUF %d failed: %s\n", index, strerror(errno));
+		__atomic_fetch_add(&eng->stats.errors, 1, __ATOMIC_RELAXED);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* frames carry a line sized header on top of at most 2 bytes per pixel */
+static unsigned int capture_res_size(const struct capture_res_s *res)
+{
+	return res->width * (res->height + 1) * 2;
+}
+
+int capture_enum_resolution(struct capture_engine_s *eng, int fmt_index)
+{
+	struct v4l2_fmtdesc fmt;
+	struct v4l2_frmsizeenum size;
+
+	eng->num_res = 0;
+
+	CLEAR(fmt);
+	fmt.index = fmt_index;
+	fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == xioctl(eng->fd, VIDIOC_ENUM_FMT, &fmt)) {
+		fprintf(stderr, "capture: VIDIOC_ENUM_FMT %d failed\n", fmt_index);
+		return -1;
+	}
+
+	CLEAR(size);
+	size.index = 0;
+	size.pixel_format = fmt.pixelformat;
+	while (size.index < CAPTURE_MAX_RES && xioctl(eng->fd, VIDIOC_ENUM_FRAMESIZES, &size) >= 0) {
+		if (size.type != V4L2_FRMSIZE_TYPE_DISCRETE) {
+			printf("capture: unknown frame size type %d\n", size.type);
+			break;
+		}
+		eng->res[eng->num_res].width = size.discrete.width;
+		eng->res[eng->num_res].height = size.discrete.height;
+		eng->res[eng->num_res].format = size.pixel_format;
+		printf("got discrete frame size %dx%d, format: 0x%x\n",
+		       size.discrete.width, size.discrete.height, size.pixel_format);
+		eng->num_res++;
+		size.index++;
+	}
+
+	if (eng->num_res == 0) {
+		printf("have no right resoltion!\n");
+		return -1;
+	}
+
+	return eng->num_res;
+}
+
+int capture_get_resolution(struct capture_engine_s *eng, struct capture_res_s *res, int max)
+{
+	int num = eng->num_res < max ? eng->num_res : max;
+
+	memcpy(res, eng->res, num * sizeof(struct capture_res_s));
+	return num;
+}
+
+/* size the worker buffers for the resolution that is about to stream */
+static unsigned int capture_frame_size(struct capture_engine_s *eng)
+{
+	struct v4l2_format fmt;
+	unsigned int size = 0;
+	int i;
+
+	CLEAR(fmt);
+	fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (0 == xioctl(eng->fd, VIDIOC_G_FMT, &fmt)) {
+		for (i = 0; i < eng->num_res; i++) {
+			if (eng->res[i].width == (int)fmt.fmt.pix.width &&
+			    eng->res[i].height == (int)fmt.fmt.pix.height)
+				size = capture_res_size(&eng->res[i]);
+		}
+		if (fmt.fmt.pix.sizeimage > size)
+			size = fmt.fmt.pix.sizeimage;
+	}
+
+	/* unknown format, fall back to the largest resolution we know of */
+	if (size == 0) {
+		for (i = 0; i < eng->num_res; i++) {
+			if (capture_res_size(&eng->res[i]) > size)
+				size = capture_res_size(&eng->res[i]);
+		}
+	}
+
+	return size;
+}
+
+static int capture_reserve(struct capture_worker_s *worker, size_t size)
+{
+	void *data;
+
+	if (worker->size >= size)
+		return 0;
+
+	data = realloc(worker->data, size);
+	if (data == NULL)
+		return -1;
+
+	worker->data = data;
+	worker->size = size;
+	return 0;
+}
+
+static void *capture_dequeue_thread(void *arg)
+{
+	struct capture_engine_s *eng = (struct capture_engine_s *)arg;
+	struct capture_entry_s entry, old;
+	struct v4l2_buffer buf;
+	struct pollfd pfd[2];
+	int dropped, r;
+
+	pfd[0].fd = eng->fd;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = eng->stop_fd;
+	pfd[1].events = POLLIN;
+
+	for (;;) {
+		r = poll(pfd, 2, CAPTURE_POLL_MS);
+		if (r < 0) {
+			if (EINTR == errno)
+				continue;
+			fprintf(stderr, "capture: poll failed: %s\n", strerror(errno));
+			break;
+		}
+		if (pfd[1].revents)
+			break;
+		if (r == 0) {
+			fprintf(stderr, "capture: no frame for %dms\n", CAPTURE_POLL_MS);
+			continue;
+		}
+		if (pfd[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+			fprintf(stderr, "capture: device error\n");
+			__atomic_fetch_add(&eng->stats.errors, 1, __ATOMIC_RELAXED);
+			break;
+		}
+
+		CLEAR(buf);
+		buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buf.memory = V4L2_MEMORY_MMAP;
+		if (-1 == xioctl(eng->fd, VIDIOC_DQBUF, &buf)) {
+			if (EAGAIN == errno)
+				continue;
+			fprintf(stderr, "capture: VIDIOC_DQBUF failed: %s\n", strerror(errno));
+			__atomic_fetch_add(&eng->stats.errors, 1, __ATOMIC_RELAXED);
+			break;
+		}
+
+		entry.buf = buf.index;
+		entry.bytesused = buf.bytesused;
+		entry.sequence = buf.sequence;
+		entry.index = eng->next_index++;
+		entry.timestamp_us = (long long)buf.timestamp.tv_sec * 1000000 + buf.timestamp.tv_usec;
+		entry.dequeue_us = capture_now();
+
+		/* queue full: the oldest frame goes back to the driver unprocessed */
+		dropped = 0;
+		pthread_mutex_lock(&eng->lock);
+		if (eng->count == eng->cfg.queue_depth) {
+			old = eng->queue[eng->head];
+			eng->head = (eng->head + 1) % eng->cfg.queue_depth;
+			eng->count--;
+			dropped = 1;
+		}
+		eng->queue[(eng->head + eng->count) % eng->cfg.queue_depth] = entry;
+		eng->count++;
+		if ((unsigned int)eng->count > eng->stats.queue_max)
+			eng->stats.queue_max = eng->count;
+		pthread_cond_signal(&eng->cond);
+		pthread_mutex_unlock(&eng->lock);
+
+		if (dropped) {
+			__atomic_fetch_add(&eng->stats.drops, 1, __ATOMIC_RELAXED);
+			capture_qbuf(eng, old.buf);
+		}
+	}
+
+	return NULL;
+}
+
+static void *capture_worker_thread(void *arg)
+{
+	struct capture_worker_s *worker = (struct capture_worker_s *)arg;
+	struct capture_engine_s *eng = worker->eng;
+	struct capture_frame_s frame;
+	struct capture_entry_s entry;
+	long long claim, max;
+
+	for (;;) {
+		pthread_mutex_lock(&eng->lock);
+		while (eng->count == 0 && !eng->stopping)
+			pthread_cond_wait(&eng->cond, &eng->lock);
+		if (eng->count == 0) {
+			pthread_mutex_unlock(&eng->lock);
+			break;
+		}
+		entry = eng->queue[eng->head];
+		eng->head = (eng->head + 1) % eng->cfg.queue_depth;
+		eng->count--;
+		pthread_mutex_unlock(&eng->lock);
+
+		/* claim the payload, the v4l2 buffer goes straight back */
+		if (capture_reserve(worker, entry.bytesused > eng->frame_size ? entry.bytesused : eng->frame_size) < 0) {
+			fprintf(stderr, "capture: worker %d out of memory\n", worker->id);
+			__atomic_fetch_add(&eng->stats.errors, 1, __ATOMIC_RELAXED);
+			capture_qbuf(eng, entry.buf);
+			continue;
+		}
+		memcpy(worker->data, eng->bufs[entry.buf].start, entry.bytesused);
+		capture_qbuf(eng, entry.buf);
+
+		claim = capture_now() - entry.dequeue_us;
+		max = __atomic_load_n(&eng->stats.claim_max_us, __ATOMIC_RELAXED);
+		while (claim > max &&
+		       !__atomic_compare_exchange_n(&eng->stats.claim_max_us, &max, claim, 1,
+		                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			;
+
+		frame.data = worker->data;
+		frame.bytesused = entry.bytesused;
+		frame.sequence = entry.sequence;
+		frame.index = entry.index;
+		frame.timestamp_us = entry.timestamp_us;
+		frame.dequeue_us = entry.dequeue_us;
+		frame.worker = worker->id;
+		if (eng->cfg.frame_cb != NULL)
+			eng->cfg.frame_cb(eng->cfg.arg, &frame);
+
+		__atomic_fetch_add(&eng->stats.frames, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&eng->stats.bytes, entry.bytesused, __ATOMIC_RELAXED);
+	}
+
+	return NULL;
+}
+
+struct capture_engine_s *capture_create(int fd, const struct capture_config_s *cfg)
+{
+	struct capture_engine_s *eng;
+
+	eng = (struct capture_engine_s *)calloc(1, sizeof(struct capture_engine_s));
+	if (eng == NULL)
+		return NULL;
+
+	eng->fd = fd;
+	eng->cfg = *cfg;
+	if (eng->cfg.nbufs <= 0)
+		eng->cfg.nbufs = CAPTURE_DEF_BUFS;
+	if (eng->cfg.nbufs > CAPTURE_MAX_BUFS)
+		eng->cfg.nbufs = CAPTURE_MAX_BUFS;
+	if (eng->cfg.workers <= 0)
+		eng->cfg.workers = CAPTURE_DEF_WORKERS;
+	if (eng->cfg.workers > CAPTURE_MAX_WORKERS)
+		eng->cfg.workers = CAPTURE_MAX_WORKERS;
+
+	eng->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (eng->stop_fd < 0) {
+		free(eng);
+		return NULL;
+	}
+
+	pthread_mutex_init(&eng->lock, NULL);
+	pthread_cond_init(&eng->cond, NULL);
+	return eng;
+}
+
+void capture_destroy(struct capture_engine_s *eng)
+{
+	int i;
+
+	if (eng == NULL)
+		return;
+
+	capture_stop(eng);
+	for (i = 0; i < CAPTURE_MAX_WORKERS; i++)
+		free(eng->workers[i].data);
+	close(eng->stop_fd);
+	pthread_mutex_destroy(&eng->lock);
+	pthread_cond_destroy(&eng->cond);
+	free(eng);
+}
+
+static void capture_uninit_buffers(struct capture_engine_s *eng)
+{
+	struct v4l2_requestbuffers req;
+	int i;
+
+	for (i = 0; i < eng->nbufs; i++)
+		munmap(eng->bufs[i].start, eng->bufs[i].length);
+	eng->nbufs = 0;
+
+	CLEAR(req);
+	req.count = 0;
+	req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	req.memory = V4L2_MEMORY_MMAP;
+	xioctl(eng->fd, VIDIOC_REQBUFS, &req);
+}
+
+static int capture_init_buffers(struct capture_engine_s *eng)
+{
+	struct v4l2_requestbuffers req;
+	struct v4l2_buffer buf;
+	int i;
+
+	CLEAR(req);
+	req.count = eng->cfg.nbufs;
+	req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	req.memory = V4L2_MEMORY_MMAP;
+	if (-1 == xioctl(eng->fd, VIDIOC_REQBUFS, &req)) {
+		fprintf(stderr, "capture: VIDIOC_REQBUFS failed: %s\n", strerror(errno));
+		return -1;
+	}
+	if (req.count < 2) {
+		fprintf(stderr, "capture: insufficient buffer memory\n");
+		return -1;
+	}
+	if (req.count > CAPTURE_MAX_BUFS)
+		req.count = CAPTURE_MAX_BUFS;
+
+	for (eng->nbufs = 0; eng->nbufs < (int)req.count; eng->nbufs++) {
+		CLEAR(buf);
+		buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buf.memory = V4L2_MEMORY_MMAP;
+		buf.index = eng->nbufs;
+		if (-1 == xioctl(eng->fd, VIDIOC_QUERYBUF, &buf))
+			goto fail;
+
+		eng->bufs[eng->nbufs].length = buf.length;
+		eng->bufs[eng->nbufs].start = mmap(NULL, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED,
+		                                   eng->fd, buf.m.offset);
+		if (MAP_FAILED == eng->bufs[eng->nbufs].start)
+			goto fail;
+	}
+
+	for (i = 0; i < eng->nbufs; i++) {
+		if (capture_qbuf(eng, i) < 0) {
+			capture_uninit_buffers(eng);
+			return -1;
+		}
+	}
+
+	return 0;
+
+fail:
+	fprintf(stderr, "capture: mapping buffer %d failed: %s\n", eng->nbufs, strerror(errno));
+	capture_uninit_buffers(eng);
+	return -1;
+}
+
+int capture_start(struct capture_engine_s *eng)
+{
+	enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	unsigned long long val;
+	int i;
+
+	if (eng->running)
+		return 0;
+
+	if (capture_init_buffers(eng) < 0)
+		return -1;
+
+	if (eng->cfg.queue_depth <= 0 || eng->cfg.queue_depth >= eng->nbufs)
+		eng->cfg.queue_depth = eng->nbufs - 1;
+	eng->frame_size = capture_frame_size(eng);
+	eng->head = 0;
+	eng->count = 0;
+	eng->stopping = 0;
+	eng->next_index = 0;
+	memset(&eng->stats, 0, sizeof(eng->stats));
+	eng->stats.start_us = capture_now();
+	while (read(eng->stop_fd, &val, sizeof(val)) > 0)
+		;
+
+	if (-1 == xioctl(eng->fd, VIDIOC_STREAMON, &type)) {
+		fprintf(stderr, "capture: VIDIOC_STREAMON failed: %s\n", strerror(errno));
+		capture_uninit_buffers(eng);
+		return -1;
+	}
+
+	for (i = 0; i < eng->cfg.workers; i++) {
+		eng->workers[i].eng = eng;
+		eng->workers[i].id = i;
+		pthread_create(&eng->workers[i].tid, NULL, capture_worker_thread, &eng->workers[i]);
+	}
+	pthread_create(&eng->dq_tid, NULL, capture_dequeue_thread, eng);
+	eng->running = 1;
+
+	printf("capture: %d buffers, %d workers, queue depth %d, frame size %u\n",
+	       eng->nbufs, eng->cfg.workers, eng->cfg.queue_depth, eng->frame_size);
+	return 0;
+}
+
+void capture_stop(struct capture_engine_s *eng)
+{
+	enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	unsigned long long val = 1;
+	int i;
+
+	if (!eng->running)
+		return;
+
+	if (write(eng->stop_fd, &val, sizeof(val)) < 0)
+		fprintf(stderr, "capture: failed to wake the dequeue thread\n");
+	pthread_join(eng->dq_tid, NULL);
+
+	/* workers drain what is still queued, then leave */
+	pthread_mutex_lock(&eng->lock);
+	eng->stopping = 1;
+	pthread_cond_broadcast(&eng->cond);
+	pthread_mutex_unlock(&eng->lock);
+	for (i = 0; i < eng->cfg.workers; i++)
+		pthread_join(eng->workers[i].tid, NULL);
+
+	if (-1 == xioctl(eng->fd, VIDIOC_STREAMOFF, &type))
+		fprintf(stderr, "capture: VIDIOC_STREAMOFF failed: %s\n", strerror(errno));
+	capture_uninit_buffers(eng);
+	eng->running = 0;
+}
+
+int capture_running(struct capture_engine_s *eng)
+{
+	return eng->running;
+}
+
+void capture_get_stats(struct capture_engine_s *eng, struct capture_stats_s *stats)
+{
+	stats->frames = __atomic_load_n(&eng->stats.frames, __ATOMIC_RELAXED);
+	stats->bytes = __atomic_load_n(&eng->stats.bytes, __ATOMIC_RELAXED);
+	stats->drops = __atomic_load_n(&eng->stats.drops, __ATOMIC_RELAXED);
+	stats->errors = __atomic_load_n(&eng->stats.errors, __ATOMIC_RELAXED);
+	stats->claim_max_us = __atomic_load_n(&eng->stats.claim_max_us, __ATOMIC_RELAXED);
+	pthread_mutex_lock(&eng->lock);
+	stats->queue_max = eng->stats.queue_max;
+	pthread_mutex_unlock(&eng->lock);
+	stats->start_us = eng->stats.start_us;
+}
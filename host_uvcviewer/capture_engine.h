@@ -0,0 +1,71 @@
+#ifndef CAPTURE_ENGINE_H
+#define CAPTURE_ENGINE_H
+
+/*
+ * v4l2 capture engine, no Qt in here. one thread dequeues buffers and
+ * hands their index to a worker pool through a bounded queue. a worker
+ * claims the payload by copying it into its own buffer and re-queues the
+ * v4l2 buffer at once, so frame processing never holds up the usb side.
+ */
+
+#define CAPTURE_MAX_RES			64
+#define CAPTURE_MAX_BUFS		16
+#define CAPTURE_MAX_WORKERS		8
+
+#define CAPTURE_DEF_BUFS		4
+#define CAPTURE_DEF_WORKERS		2
+
+struct capture_res_s {
+	int width;
+	int height;
+	unsigned int format;
+};
+
+struct capture_frame_s {
+	void *data;
+	unsigned int bytesused;
+	unsigned int sequence;			/* v4l2 sequence */
+	unsigned int index;				/* engine frame number, in dequeue order */
+	long long timestamp_us;			/* v4l2 timestamp */
+	long long dequeue_us;			/* CLOCK_MONOTONIC at DQBUF */
+	int worker;
+};
+
+/* runs on a worker thread, frame->data is only valid until it returns */
+typedef void (*capture_frame_fn)(void *arg, struct capture_frame_s *frame);
+
+struct capture_config_s {
+	int nbufs;						/* v4l2 buffers, 0: CAPTURE_DEF_BUFS */
+	int workers;					/* 0: CAPTURE_DEF_WORKERS */
+	int queue_depth;				/* 0: nbufs - 1, one buffer always stays with the driver */
+	capture_frame_fn frame_cb;
+	void *arg;
+};
+
+struct capture_stats_s {
+	unsigned long long frames;		/* handed to frame_cb */
+	unsigned long long bytes;
+	unsigned long long drops;		/* re-queued unprocessed because the queue was full */
+	unsigned long long errors;
+	unsigned int queue_max;			/* deepest the queue got */
+	long long claim_max_us;			/* longest DQBUF -> QBUF */
+	long long start_us;
+};
+
+struct capture_engine_s;
+
+long long capture_now(void);
+
+struct capture_engine_s *capture_create(int fd, const struct capture_config_s *cfg);
+void capture_destroy(struct capture_engine_s *eng);
+
+int capture_enum_resolution(struct capture_engine_s *eng, int fmt_index);
+int capture_get_resolution(struct capture_engine_s *eng, struct capture_res_s *res, int max);
+
+int capture_start(struct capture_engine_s *eng);
+void capture_stop(struct capture_engine_s *eng);
+int capture_running(struct capture_engine_s *eng);
+
+void capture_get_stats(struct capture_engine_s *eng, struct capture_stats_s *stats);
+
+#endif
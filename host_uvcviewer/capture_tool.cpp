@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <linux/videodev2.h>
+#include <linux/usb/video.h>
+#include <linux/uvcvideo.h>
+
+#include "capture_engine.h"
+#include "mipi_tx_header.h"
+
+/*
+ * headless front end of the capture engine: no display, only stats and
+ * optionally every frame recorded to disk, to measure the sustained
+ * frame rate the host side can take.
+ */
+
+#define CAPTURE_RECORD_MAGIC	0x52504143		/* "CAPR" */
+#define CAPTURE_CHANNELS		4
+
+/* every recorded frame is prefixed with this, frames may be out of order */
+struct capture_record_s {
+	unsigned int magic;
+	unsigned int index;
+	unsigned int sequence;
+	unsigned int bytesused;
+	long long timestamp_us;
+};
+
+struct channel_stats_s {
+	unsigned long long frames;
+	long first;
+	long last;
+};
+
+static const char *dev_name = "/dev/v4l/by-id/usb-Ningbo_Sunny_opto_Co._Ltd_Sunny_HD_WebCam-V3.1.0_Sunny_HD_WebCam-V3.1.0-video-index0";
+
+static volatile sig_atomic_t quit_flag = 0;
+static int record_fd = -1;
+static int work_us = 0;
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct channel_stats_s channels[CAPTURE_CHANNELS];
+static unsigned long long record_errors = 0;
+
+static void sig_handler(int)
+{
+	quit_flag = 1;
+}
+
+static int write_all(int fd, const void *data, size_t len)
+{
+	const char *p = (const char *)data;
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = write(fd, p, len);
+		if (ret < 0) {
+			if (EINTR == errno)
+				continue;
+			return -1;
+		}
+		p += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static void frame_cb(void *, struct capture_frame_s *frame)
+{
+	client_tx_frame_header_t *header = (client_tx_frame_header_t *)frame->data;
+	struct capture_record_s record;
+	struct channel_stats_s *ch;
+	long long end;
+
+	if (frame->bytesused >= sizeof(*header) && header->channel >= 0 && header->channel < CAPTURE_CHANNELS) {
+		pthread_mutex_lock(&stats_lock);
+		ch = &channels[header->channel];
+		if (ch->frames == 0 || header->framecounter < ch->first)
+			ch->first = header->framecounter;
+		if (ch->frames == 0 || header->framecounter > ch->last)
+			ch->last = header->framecounter;
+		ch->frames++;
+		pthread_mutex_unlock(&stats_lock);
+	}
+
+	/* stand-in for display/processing cost, to size the worker pool */
+	if (work_us > 0) {
+		end = capture_now() + work_us;
+		while (capture_now() < end)
+			;
+	}
+
+	if (record_fd >= 0) {
+		record.magic = CAPTURE_RECORD_MAGIC;
+		record.index = frame->index;
+		record.sequence = frame->sequence;
+		record.bytesused = frame->bytesused;
+		record.timestamp_us = frame->timestamp_us;
+
+		pthread_mutex_lock(&stats_lock);
+		if (write_all(record_fd, &record, sizeof(record)) < 0 ||
+		    write_all(record_fd, frame->data, frame->bytesused) < 0)
+			record_errors++;
+		pthread_mutex_unlock(&stats_lock);
+	}
+}
+
+static int set_sensor_mode(int fd, int mode)
+{
+	struct uvc_xu_control_query xu;
+	unsigned char data[2] = { (unsigned char)mode, 0x00 };
+
+	memset(&xu, 0, sizeof(xu));
+	xu.unit = 0x03;
+	xu.selector = 0x01;
+	xu.size = 2;
+	xu.data = data;
+	xu.query = UVC_SET_CUR;
+	if (-1 == ioctl(fd, UVCIOC_CTRL_QUERY, &xu)) {
+		fprintf(stderr, "set sensor mode %d failed: %s\n", mode, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static int set_format(int fd, int fmt_index, int width, int height, int rate)
+{
+	struct v4l2_fmtdesc fmtdes;
+	struct v4l2_format fmt;
+	struct v4l2_streamparm parm;
+
+	memset(&fmtdes, 0, sizeof(fmtdes));
+	fmtdes.index = fmt_index;
+	fmtdes.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == ioctl(fd, VIDIOC_ENUM_FMT, &fmtdes))
+		return -1;
+
+	if (width > 0 && height > 0) {
+		memset(&fmt, 0, sizeof(fmt));
+		fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		fmt.fmt.pix.width = width;
+		fmt.fmt.pix.height = height;
+		fmt.fmt.pix.pixelformat = fmtdes.pixelformat;
+		fmt.fmt.pix.field = V4L2_FIELD_INTERLACED;
+		if (-1 == ioctl(fd, VIDIOC_S_FMT, &fmt)) {
+			fprintf(stderr, "failed set video resolution %dx%d\n", width, height);
+			return -1;
+		}
+	}
+
+	if (rate > 0) {
+		memset(&parm, 0, sizeof(parm));
+		parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		parm.parm.capture.timeperframe.numerator = 1;
+		parm.parm.capture.timeperframe.denominator = rate;
+		if (-1 == ioctl(fd, VIDIOC_S_PARM, &parm)) {
+			fprintf(stderr, "failed set video frame rate %d\n", rate);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void print_summary(struct capture_engine_s *eng)
+{
+	struct capture_stats_s stats;
+	double secs;
+	long expect;
+	int i;
+
+	capture_get_stats(eng, &stats);
+	secs = (double)(capture_now() - stats.start_us) / 1000000.0;
+	if (secs <= 0)
+		secs = 1;
+
+	printf("total: %llu frames in %.1fs, %.2f fps, %.2f MB/s, dropped %llu, errors %llu, queue max %u, claim max %lldus\n",
+	       stats.frames, secs, stats.frames / secs, stats.bytes / secs / (1024 * 1024),
+	       stats.drops, stats.errors, stats.queue_max, stats.claim_max_us);
+
+	for (i = 0; i < CAPTURE_CHANNELS; i++) {
+		if (channels[i].frames == 0)
+			continue;
+		expect = channels[i].last - channels[i].first + 1;
+		printf("channel %d: %llu frames, device counter %ld..%ld, missing %lld (lost on the link or dropped here)\n", i, channels[i].frames,
+		       channels[i].first, channels[i].last, (long long)expect - (long long)channels[i].frames);
+	}
+	if (record_errors)
+		printf("record: %llu frames failed to write\n", record_errors);
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [options]\n", prog);
+	printf("  -d dev      video device\n");
+	printf("  -m mode     sensor mode 1..3 (xu selector 1)\n");
+	printf("  -f index    format index (default 1)\n");
+	printf("  -s WxH      resolution, must be one the device lists\n");
+	printf("  -r fps      frame rate\n");
+	printf("  -b bufs     v4l2 buffers (default %d)\n", CAPTURE_DEF_BUFS);
+	printf("  -w workers  worker threads (default %d)\n", CAPTURE_DEF_WORKERS);
+	printf("  -q depth    queue depth (default bufs - 1)\n");
+	printf("  -p us       simulated processing time per frame\n");
+	printf("  -o file     record every frame to file\n");
+	printf("  -t secs     stop after secs (default: until ctrl-c)\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct capture_config_s cfg;
+	struct capture_stats_s stats, last;
+	struct capture_engine_s *eng;
+	const char *record = NULL;
+	int width = 0, height = 0, rate = 0;
+	int fmt_index = 1, mode = 0, secs = 0;
+	long long now, prev;
+	int fd, opt, elapsed = 0;
+
+	memset(&cfg, 0, sizeof(cfg));
+	while ((opt = getopt(argc, argv, "d:m:f:s:r:b:w:q:p:o:t:h")) != -1) {
+		switch (opt) {
+		case 'd':
+			dev_name = optarg;
+			break;
+		case 'm':
+			mode = atoi(optarg);
+			break;
+		case 'f':
+			fmt_index = atoi(optarg);
+			break;
+		case 's':
+			if (sscanf(optarg, "%dx%d", &width, &height) != 2) {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'r':
+			rate = atoi(optarg);
+			break;
+		case 'b':
+			cfg.nbufs = atoi(optarg);
+			break;
+		case 'w':
+			cfg.workers = atoi(optarg);
+			break;
+		case 'q':
+			cfg.queue_depth = atoi(optarg);
+			break;
+		case 'p':
+			work_us = atoi(optarg);
+			break;
+		case 'o':
+			record = optarg;
+			break;
+		case 't':
+			secs = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	fd = open(dev_name, O_RDWR | O_NONBLOCK, 0);
+	if (fd < 0) {
+		fprintf(stderr, "Cannot open '%s': %d, %s\n", dev_name, errno, strerror(errno));
+		return -1;
+	}
+
+	if (record != NULL) {
+		record_fd = open(record, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (record_fd < 0) {
+			fprintf(stderr, "Cannot open '%s': %s\n", record, strerror(errno));
+			close(fd);
+			return -1;
+		}
+	}
+
+	cfg.frame_cb = frame_cb;
+	eng = capture_create(fd, &cfg);
+	if (eng == NULL) {
+		close(fd);
+		return -1;
+	}
+
+	if ((mode > 0 && set_sensor_mode(fd, mode) < 0) ||
+	    capture_enum_resolution(eng, fmt_index) < 0 ||
+	    set_format(fd, fmt_index, width, height, rate) < 0 ||
+	    capture_start(eng) < 0) {
+		capture_destroy(eng);
+		close(fd);
+		return -1;
+	}
+
+	signal(SIGINT, sig_handler);
+	signal(SIGTERM, sig_handler);
+
+	memset(&last, 0, sizeof(last));
+	prev = capture_now();
+	while (!quit_flag && (secs == 0 || elapsed < secs)) {
+		sleep(1);
+		elapsed++;
+
+		now = capture_now();
+		capture_get_stats(eng, &stats);
+		printf("%4ds: %.2f fps, %.2f MB/s, dropped %llu, queue max %u, claim max %lldus\n", elapsed,
+		       (stats.frames - last.frames) * 1000000.0 / (now - prev),
+		       (stats.bytes - last.bytes) * 1000000.0 / (now - prev) / (1024 * 1024),
+		       stats.drops - last.drops, stats.queue_max, stats.claim_max_us);
+		last = stats;
+		prev = now;
+	}
+
+	capture_stop(eng);
+	print_summary(eng);
+	capture_destroy(eng);
+
+	if (record_fd >= 0)
+		close(record_fd);
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# headless capture engine, no Qt/OpenCV needed
+#
+#-------------------------------------------------
+
+QT  -= core gui
+
+TARGET = capture_tool
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle qt
+
+SOURCES += capture_tool.cpp \
+    capture_engine.cpp \
+
+HEADERS  += capture_engine.h \
+	mipi_tx_header.h \
+
+LIBS += -lpthread
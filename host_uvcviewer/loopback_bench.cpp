@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <linux/videodev2.h>
+
+#include "capture_engine.h"
+
+/*
+ * host side of the loopback benchmark (shell/uvc_loopback_bench.sh): reads
+ * the gadget through dummy_hcd on the same machine, so the CLOCK_MONOTONIC
+ * stamp sunny_lib/camera_synth.cpp puts into S_MetaData gives the end to
+ * end latency from camera callback to DQBUF here. frameCount gaps are frames
+ * lost on the way, the image is checked against the synthetic pattern.
+ */
+
+#define LOOPBACK_CAMERAS		4
+#define LOOPBACK_STEP			0x9e3779b1u
+
+/* keep in sync with sunny_lib/typedef.h */
+struct loopback_meta_s {
+	long verison[4];
+	long cameraNum;
+	long width;
+	long height;
+	long bpp;
+	long dataFormat;
+	long frameCount;
+	long tv_sec;
+	long tv_usec;
+	long headerLength;
+};
+
+/* S_MetaData.dataFormat, keep in sync with sunny_lib/stream_config.h */
+enum {
+	LOOPBACK_YUV422 = 4,
+	LOOPBACK_YUV420_I420 = 5,
+	LOOPBACK_MONO_8BIT = 6,
+	LOOPBACK_YV12 = 7,
+	LOOPBACK_NV12 = 8,
+};
+
+struct camera_stats_s {
+	unsigned long long frames;
+	unsigned long long dropped;		/* frameCount gaps */
+	unsigned long long reordered;
+	long last;
+};
+
+static const char *dev_name = "/dev/video0";
+
+static volatile sig_atomic_t quit_flag = 0;
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct camera_stats_s cameras[LOOPBACK_CAMERAS];
+static unsigned long long torn = 0;
+static unsigned long long unknown = 0;
+static long long *latency = NULL;
+static unsigned long long nlatency = 0;
+static unsigned long long latency_size = 0;
+
+static void sig_handler(int)
+{
+	quit_flag = 1;
+}
+
+/* same as stream_frame_size() on the device */
+static unsigned int frame_size(const struct loopback_meta_s *meta)
+{
+	unsigned int pixels = meta->width * meta->height;
+
+	switch (meta->dataFormat) {
+	case LOOPBACK_NV12:
+	case LOOPBACK_YV12:
+	case LOOPBACK_YUV420_I420:
+		return pixels * 3 / 2;
+	case LOOPBACK_YUV422:
+		return pixels * 2;
+	case LOOPBACK_MONO_8BIT:
+		return pixels;
+	default:
+		return pixels * meta->bpp / 8;
+	}
+}
+
+/* the image camera_synth.cpp sends for this camera and frame */
+static int pattern_ok(const unsigned char *src, unsigned int size, long cam, long frame)
+{
+	unsigned int seed = (unsigned int)frame * LOOPBACK_STEP + ((unsigned int)cam << 28);
+	const unsigned int *word = (const unsigned int *)src;
+	unsigned int i;
+
+	for (i = 0; i < size / 4; i++) {
+		if (word[i] != seed + i)
+			return 0;
+	}
+	for (i = size & ~3u; i < size; i++) {
+		if (src[i] != (unsigned char)(seed + i))
+			return 0;
+	}
+
+	return 1;
+}
+
+static void latency_add(long long us)
+{
+	long long *grown;
+
+	if (nlatency == latency_size) {
+		latency_size = latency_size ? latency_size * 2 : 4096;
+		grown = (long long *)realloc(latency, latency_size * sizeof(*latency));
+		if (grown == NULL)
+			return;
+		latency = grown;
+	}
+	latency[nlatency++] = us;
+}
+
+static void frame_cb(void *, struct capture_frame_s *frame)
+{
+	const struct loopback_meta_s *meta = (const struct loopback_meta_s *)frame->data;
+	struct camera_stats_s *cam;
+	unsigned int size;
+	int ok;
+
+	if (frame->bytesused < sizeof(*meta) || meta->cameraNum < 0 || meta->cameraNum >= LOOPBACK_CAMERAS ||
+	    meta->headerLength < (long)sizeof(*meta) || meta->headerLength > (long)frame->bytesused) {
+		pthread_mutex_lock(&stats_lock);
+		unknown++;
+		pthread_mutex_unlock(&stats_lock);
+		return;
+	}
+
+	size = frame_size(meta);
+	ok = frame->bytesused >= meta->headerLength + size &&
+	     pattern_ok((const unsigned char *)frame->data + meta->headerLength, size, meta->cameraNum, meta->frameCount);
+
+	pthread_mutex_lock(&stats_lock);
+	cam = &cameras[meta->cameraNum];
+	if (cam->frames > 0) {
+		if (meta->frameCount > cam->last + 1)
+			cam->dropped += meta->frameCount - cam->last - 1;
+		else if (meta->frameCount <= cam->last)
+			cam->reordered++;
+	}
+	if (cam->frames == 0 || meta->frameCount > cam->last)
+		cam->last = meta->frameCount;
+	cam->frames++;
+	if (!ok)
+		torn++;
+	latency_add(frame->dequeue_us - ((long long)meta->tv_sec * 1000000 + meta->tv_usec));
+	pthread_mutex_unlock(&stats_lock);
+}
+
+static int cmp_ll(const void *a, const void *b)
+{
+	long long x = *(const long long *)a, y = *(const long long *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static long long percentile(int pct)
+{
+	unsigned long long i;
+
+	if (nlatency == 0)
+		return 0;
+	i = (nlatency * pct + 99) / 100;
+	return latency[i > 0 ? i - 1 : 0];
+}
+
+static int set_format(int fd, int fmt_index, int width, int height)
+{
+	struct v4l2_fmtdesc fmtdes;
+	struct v4l2_format fmt;
+
+	memset(&fmtdes, 0, sizeof(fmtdes));
+	fmtdes.index = fmt_index;
+	fmtdes.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == ioctl(fd, VIDIOC_ENUM_FMT, &fmtdes))
+		return -1;
+
+	if (width > 0 && height > 0) {
+		memset(&fmt, 0, sizeof(fmt));
+		fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		fmt.fmt.pix.width = width;
+		fmt.fmt.pix.height = height;
+		fmt.fmt.pix.pixelformat = fmtdes.pixelformat;
+		fmt.fmt.pix.field = V4L2_FIELD_INTERLACED;
+		if (-1 == ioctl(fd, VIDIOC_S_FMT, &fmt)) {
+			fprintf(stderr, "failed set video resolution %dx%d\n", width, height);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void print_summary(struct capture_engine_s *eng)
+{
+	struct capture_stats_s stats;
+	unsigned long long frames = 0, dropped = 0;
+	double secs;
+	int i;
+
+	capture_get_stats(eng, &stats);
+	secs = (double)(capture_now() - stats.start_us) / 1000000.0;
+	if (secs <= 0)
+		secs = 1;
+
+	for (i = 0; i < LOOPBACK_CAMERAS; i++) {
+		frames += cameras[i].frames;
+		dropped += cameras[i].dropped;
+	}
+
+	printf("total: %llu frames in %.1fs, %.2f fps, %.2f MB/s, dropped %llu, torn %llu, unknown %llu\n",
+	       frames, secs, frames / secs, stats.bytes / secs / (1024 * 1024), dropped, torn, unknown);
+	for (i = 0; i < LOOPBACK_CAMERAS; i++) {
+		if (cameras[i].frames == 0)
+			continue;
+		printf("camera %d: %llu frames, %.2f fps, dropped %llu, reordered %llu\n", i, cameras[i].frames,
+		       cameras[i].frames / secs, cameras[i].dropped, cameras[i].reordered);
+	}
+
+	if (nlatency > 0) {
+		qsort(latency, nlatency, sizeof(*latency), cmp_ll);
+		printf("latency: p50 %lldus, p90 %lldus, p99 %lldus, max %lldus\n",
+		       percentile(50), percentile(90), percentile(99), latency[nlatency - 1]);
+	}
+	printf("host: dropped %llu, errors %llu, queue max %u, claim max %lldus\n",
+	       stats.drops, stats.errors, stats.queue_max, stats.claim_max_us);
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [options]\n", prog);
+	printf("  -d dev      video device of the gadget (default %s)\n", dev_name);
+	printf("  -f index    format index (default 0)\n");
+	printf("  -s WxH      resolution, must be one the device lists\n");
+	printf("  -b bufs     v4l2 buffers (default %d)\n", CAPTURE_DEF_BUFS);
+	printf("  -t secs     run time (default 10)\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct capture_config_s cfg;
+	struct capture_stats_s stats, last;
+	struct capture_engine_s *eng;
+	int width = 0, height = 0;
+	int fmt_index = 0, secs = 10;
+	long long now, prev;
+	int fd, opt, elapsed = 0;
+
+	memset(&cfg, 0, sizeof(cfg));
+	while ((opt = getopt(argc, argv, "d:f:s:b:t:h")) != -1) {
+		switch (opt) {
+		case 'd':
+			dev_name = optarg;
+			break;
+		case 'f':
+			fmt_index = atoi(optarg);
+			break;
+		case 's':
+			if (sscanf(optarg, "%dx%d", &width, &height) != 2) {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'b':
+			cfg.nbufs = atoi(optarg);
+			break;
+		case 't':
+			secs = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	fd = open(dev_name, O_RDWR | O_NONBLOCK, 0);
+	if (fd < 0) {
+		fprintf(stderr, "Cannot open '%s': %d, %s\n", dev_name, errno, strerror(errno));
+		return -1;
+	}
+
+	/* one worker, frames are checked in dequeue order */
+	cfg.workers = 1;
+	cfg.frame_cb = frame_cb;
+	eng = capture_create(fd, &cfg);
+	if (eng == NULL) {
+		close(fd);
+		return -1;
+	}
+
+	if (capture_enum_resolution(eng, fmt_index) < 0 ||
+	    set_format(fd, fmt_index, width, height) < 0 ||
+	    capture_start(eng) < 0) {
+		capture_destroy(eng);
+		close(fd);
+		return -1;
+	}
+
+	signal(SIGINT, sig_handler);
+	signal(SIGTERM, sig_handler);
+
+	memset(&last, 0, sizeof(last));
+	prev = capture_now();
+	while (!quit_flag && elapsed < secs) {
+		sleep(1);
+		elapsed++;
+
+		now = capture_now();
+		capture_get_stats(eng, &stats);
+		pthread_mutex_lock(&stats_lock);
+		printf("%4ds: %.2f fps, %.2f MB/s, torn %llu\n", elapsed,
+		       (stats.frames - last.frames) * 1000000.0 / (now - prev),
+		       (stats.bytes - last.bytes) * 1000000.0 / (now - prev) / (1024 * 1024), torn);
+		pthread_mutex_unlock(&stats_lock);
+		last = stats;
+		prev = now;
+	}
+
+	capture_stop(eng);
+	print_summary(eng);
+	capture_destroy(eng);
+
+	free(latency);
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# host side of the dummy_hcd loopback benchmark, no Qt/OpenCV needed
+#
+#-------------------------------------------------
+
+QT  -= core gui
+
+TARGET = loopback_bench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle qt
+
+SOURCES += loopback_bench.cpp \
+    capture_engine.cpp \
+
+HEADERS  += capture_engine.h \
+
+LIBS += -lpthread
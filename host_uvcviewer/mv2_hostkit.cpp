@@ -24,6 +24,8 @@
 #include<linux/videodev2.h>
 #include<QDateTime>
 #include"mipi_tx_header.h"
+#include"capture_engine.h"
+#include"pixel_kernels.h"
 #include<QFileDialog>
 #include<QMessageBox>
 #include<QString>
@@ -42,24 +44,12 @@
 
 typedef unsigned char BYTE;
 typedef unsigned long       DWORD;
-typedef struct tagPOINT
-{
-    int x;
-    int y;
-}POINT;
 
 #define min(x,y)  ( x>y?y:x )
 #define WIDTHBYTES(bits)					((DWORD)(((bits) + 31) & (~31)) / 8)
 #define CLIP(x)				static_cast<BYTE>((x) > 255 ? 255 : ((x) < 0 ? 0 : (x)))
 #define GRAY(r, g, b)	static_cast<BYTE>(0.299 * (r) + 0.587 * (g) + 0.114 * (b));
 
-typedef enum
-{
-    BayerB,
-    BayerG,
-    BayerR
-}BayerColor;
-
 typedef enum
 {
     BAYER_DEF = 0,
@@ -106,46 +96,16 @@ typedef enum
     ALL				= 4
 } eColorChannel;
 
-typedef struct
-{
-    eBayer eBayerPattern;
-    int nW, nH;
-
-} PLContext;
-
 enum io_method {
         IO_METHOD_READ,
         IO_METHOD_MMAP,
         IO_METHOD_USERPTR,
 };
 
-typedef struct tagVideoRes
-{
-    int  width;
-    int  height;
-    unsigned int format;
-}VideoRes;
-
-typedef struct tagVideoResList
-{
-	VideoRes *video_res;
-	int num_res;
-}VideoResList;
-
-
 static char       *dev_name="/dev/v4l/by-id/usb-Ningbo_Sunny_opto_Co._Ltd_Sunny_HD_WebCam-V3.1.0_Sunny_HD_WebCam-V3.1.0-video-index0";
 
-static enum io_method   io = IO_METHOD_MMAP;
 static int              fd = -1;
-struct buffer {
-        void   *start;
-        size_t  length;
-};
-struct buffer          *buffers;
-static unsigned int     n_buffers;
-static int              out_buf;
-static int              frame_count = 9999999;
-static unsigned int     frames_captured = 0;
+static struct capture_engine_s *engine = NULL;
 static int init_flag = 0;
 static int save_yuv_l = 0;
 static int save_yuv_r = 0;
@@ -157,7 +117,6 @@ static int video_enable_flag = 0;
 
 static char file_log[60];
 QString  illu= QString("D50") ;
-struct v4l2_buffer buf;
 int scross=0;
 client_tx_frame_header_t* frame_header;
 QPointF mouseclick=QPointF(0,0);
@@ -166,18 +125,18 @@ int rightcount=0;
 int filenameindex=1;
 BYTE camconbination=0;
 
-QPixmap *pixmapa,*pixmapc;
-
-void* buffercama=malloc(6666*5555*2);
-void* buffercamc=malloc(6666*5555*2);
-void* bufferimg=malloc(6666*5555*2);
+//sized on the first frame and whenever the resolution changes
+void* buffercama=NULL;
+void* buffercamc=NULL;
+size_t buffercama_size=0;
+size_t buffercamc_size=0;
 double bufferindex = 2;
 
-client_tx_frame_header_t* frameheadera,*frameheaderc;
+client_tx_frame_header_t frameheadera,frameheaderc;
 
-IplImage* incoming_img =cvCreateImage( cvSize(6666,5555),IPL_DEPTH_8U,2);
-IplImage* fullsize_outputa =cvCreateImage( cvSize(6666,5555),IPL_DEPTH_8U,4);
-IplImage* fullsize_outputc =cvCreateImage( cvSize(6666,5555),IPL_DEPTH_8U,4);
+IplImage* incoming_img =NULL;
+IplImage* fullsize_outputa =NULL;
+IplImage* fullsize_outputc =NULL;
 
 CvVideoWriter* videoa =NULL;
 CvVideoWriter* videoc=NULL;
@@ -189,32 +148,8 @@ static int frames_num = 0;
 static long start_time = 1;
 static __int64_t total_frame_size = 0;
 
-#define MAX_SUPPORT_RES 64
-static VideoRes 	s_video_res[MAX_SUPPORT_RES];
-static VideoResList svideo_res_list;
-static int emun_resolution(void);
 static int deivce_mode=SENSOR_MODE0;
 
-static const BayerColor g_BayerRGB[4][2][2] =
-{
-    BayerG, // 0 0 0
-    BayerB, // 0 0 1
-    BayerR, // 0 1 0
-    BayerG, // 0 1 1
-    BayerR, // 1 0 0
-    BayerG, // 1 0 1
-    BayerG, // 1 1 0
-    BayerB, // 1 1 1
-    BayerB, // 2 0 0
-    BayerG, // 2 0 1
-    BayerG, // 2 1 0
-    BayerR, // 2 1 1
-    BayerG, // 3 0 0
-    BayerB, // 3 1 0
-    BayerR, // 3 0 1
-    BayerG  // 3 1 1
-};
-
 unsigned long get_tick_count()
 {
     struct timespec ts;
@@ -253,235 +188,14 @@ QImage Yuvtoqimg(BYTE* frame, int w, int h,int channel)
 		    break;
     }
 }
-void BorderInterpolate(PLContext* pCtx, BYTE* pRaw, BYTE* pBmp24, const int nW, const int nH, const int nBorder)
+static void reserve_buffer(void** buffer, size_t* size, size_t need)
 {
-    if ((nBorder < 1) || (nBorder > min(nW, nH) / 2))
+    if (*size >= need)
         return;
 
-    BYTE* raw = NULL;
-    BYTE* dib = NULL;
-    for (long y = 0; y < nH; ++y)
-    {
-        raw = pRaw + y * nW;
-        dib = pBmp24 + y * WIDTHBYTES(nW * 24);
-        for (long x = 0; x < nW; ++x)
-        {
-            if ((x == nBorder) && (y >= nBorder) && (y < nH - nBorder))
-            {
-                x = nW - nBorder;
-                raw += (nW - 2 * nBorder);
-                dib += (nW - 2 * nBorder) * 3;
-            }
-            long sum[3];
-            memset(sum,0 ,sizeof(sum));
-            long cnt[3];
-            memset(cnt, 0,sizeof(cnt));
-            BayerColor color = g_BayerRGB[pCtx->eBayerPattern][x & 0x01][y & 0x01];
-            for (long yoffset = -1; yoffset <= 1; ++yoffset)
-            {
-                for (long xoffset = -1; xoffset <= 1; ++xoffset)
-                {
-                    if ((yoffset == 0) && (xoffset == 0))
-                    {
-                        continue;
-                    }
-                    long y1 = y + yoffset;
-                    long x1 = x + xoffset;
-                    if ((y1 >= 0) && (y1 < nH) && (x1 >= 0) && (x1 < nW))
-                    {
-                        BayerColor c = g_BayerRGB[pCtx->eBayerPattern][x1 & 0x01][y1 & 0x01];
-                        if (c == color)
-                        {
-                            continue;
-                        }
-                        sum[c] += raw[yoffset * nW + xoffset];
-                        ++cnt[c];
-                    }
-                }
-            }
-            for (int c = R; c >= B; --c)
-            {
-                if (c == color)
-                {
-                    dib[c] = *raw;
-                }
-                else
-                {
-                    dib[c] = CLIP(1.0 * sum[c] / cnt[c]);
-                }
-            }
-            ++raw;
-            dib += 3;
-        }
-    }
-}
-
-void DemosaicBilinear(PLContext* pCtx, BYTE* pRaw, BYTE* pBmp24)
-{
-    const int nW = pCtx->nW;
-    const int nH = pCtx->nH;
-    memset(pBmp24,0 ,WIDTHBYTES(nW * 24) * nH);
-    BorderInterpolate(pCtx, pRaw, pBmp24, nW, nH, 2);
-    POINT ptROrg;
-    POINT ptG1Org;
-    POINT ptG2Org;
-    POINT ptBOrg;
-    int nG1B = 0; // B @ G1
-    int nG1R = 0; // R @ G1
-    int nG2B = 0; // B @ G2
-    int nG2R = 0; // R @ G2
-    switch (pCtx->eBayerPattern)
-    {
-    case BAYER_GBRG:
-        {
-            ptROrg.x = 1;
-            ptROrg.y = 0;
-            ptG1Org.x = 0;
-            ptG1Org.y = 0;
-            ptG2Org.x = 1;
-            ptG2Org.y = 1;
-            ptBOrg.x = 0;
-            ptBOrg.y = 1;
-            nG1B = nW;
-            nG1R = 1;
-            nG2B = 1;
-            nG2R = nW;
-            break;
-        }
-    case BAYER_RGGB:
-        {
-            ptROrg.x = 0;
-            ptROrg.y = 0;
-            ptG1Org.x = 0;
-            ptG1Org.y = 1;
-            ptG2Org.x = 1;
-            ptG2Org.y = 0;
-            ptBOrg.x = 1;
-            ptBOrg.y = 1;
-            nG1B = 1;
-            nG1R = nW;
-            nG2B = nW;
-            nG2R = 1;
-            break;
-        }
-    case BAYER_BGGR:
-        {
-            ptROrg.x = 1;
-            ptROrg.y = 1;
-            ptG1Org.x = 0;
-            ptG1Org.y = 1;
-            ptG2Org.x = 1;
-            ptG2Org.y = 0;
-            ptBOrg.x = 0;
-            ptBOrg.y = 0;
-            nG1B = nW;
-            nG1R = 1;
-            nG2B = 1;
-            nG2R = nW;
-            break;
-        }
-    case BAYER_GRBG:
-        {
-            ptROrg.x = 0;
-            ptROrg.y = 1;
-            ptG1Org.x = 0;
-            ptG1Org.y = 0;
-            ptG2Org.x = 1;
-            ptG2Org.y = 1;
-            ptBOrg.x = 1;
-            ptBOrg.y = 0;
-            nG1B = 1;
-            nG1R = nW;
-            nG2B = nW;
-            nG2R = 1;
-            break;
-        }
-    default:
-        {
-            assert(false);
-            break;
-        }
-    }
-    const int nLine = WIDTHBYTES(nW * 24);
-    // G1
-    for (int y = 2 + ptG1Org.y; y < nH - 2; y += 2)
-    {
-        int nIdxBmp = nLine * y + 3 * (2 + ptG1Org.x);
-        int nIdxRaw = nW * y + 2 + ptG1Org.x;
-        for (int x = 2 + ptG1Org.x; x < nW - 2; x += 2)
-        {
-            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw] + pRaw[nIdxRaw - nW - 1]) >> 1;
-            pBmp24[nIdxBmp + BayerB] = (pRaw[nIdxRaw - nG1B] + pRaw[nIdxRaw + nG1B]) >> 1;
-            pBmp24[nIdxBmp + BayerR] = (pRaw[nIdxRaw - nG1R] + pRaw[nIdxRaw + nG1R]) >> 1;
-            nIdxBmp += 6;
-            nIdxRaw += 2;
-        }
-        nIdxBmp += 3 * (2 + ptG1Org.x);
-        nIdxRaw += 2 + ptG1Org.x;
-    }
-    // G2
-    for (int y = 2 + ptG2Org.y; y < nH - 2; y += 2)
-    {
-        int nIdxBmp = nLine * y + 3 * (2 + ptG2Org.x);
-        int nIdxRaw = nW * y + 2 + ptG2Org.x;
-        for (int x = 2 + ptG2Org.x; x < nW - 2; x += 2)
-        {
-            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw] + pRaw[nIdxRaw - nW - 1]) >> 1;
-            pBmp24[nIdxBmp + BayerB] = (pRaw[nIdxRaw - nG2B] + pRaw[nIdxRaw + nG2B]) >> 1;
-            pBmp24[nIdxBmp + BayerR] = (pRaw[nIdxRaw - nG2R] + pRaw[nIdxRaw + nG2R]) >> 1;
-            nIdxBmp += 6;
-            nIdxRaw  += 2;
-        }
-        nIdxBmp += 3 * (2 + ptG2Org.x);
-        nIdxRaw += 2 + ptG2Org.x;
-    }
-    // B
-    for (int y = 2 + ptBOrg.y; y < nH - 2; y += 2)
-    {
-        int nIdxBmp = nLine * y + 3 * (2 + ptBOrg.x);
-        int nIdxRaw = nW * y + 2 + ptBOrg.x;
-        for (int x = 2 + ptBOrg.x; x < nW - 2; x += 2)
-        {
-            pBmp24[nIdxBmp + BayerB] = pRaw[nIdxRaw];
-            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw - nW] + pRaw[nIdxRaw + 1] + pRaw[nIdxRaw + nW] + pRaw[nIdxRaw - 1]) >> 2;
-            pBmp24[nIdxBmp + BayerR] = (pRaw[nIdxRaw - nW - 1] + pRaw[nIdxRaw - nW + 1] + pRaw[nIdxRaw + nW - 1] + pRaw[nIdxRaw + nW + 1]) >> 2;
-            nIdxBmp += 6;
-            nIdxRaw += 2;
-        }
-        nIdxBmp += 3 * (2 + ptBOrg.x);
-        nIdxRaw += 2 + ptBOrg.x;
-    }
-    // R
-    for (int y = 2 + ptROrg.y; y < nH - 2; y += 2)
-    {
-        int nIdxBmp = nLine * y + 3 * (2 + ptROrg.x);
-        int nIdxRaw = nW * y + 2 + ptROrg.x;
-        for (int x = 2 + ptROrg.x; x < nW - 2; x += 2)
-        {
-            int nIdxBmp = nLine * y + 3 * x;
-            int nIdxRaw = nW * y + x;
-            pBmp24[nIdxBmp + BayerB] = (pRaw[nIdxRaw - nW - 1] + pRaw[nIdxRaw - nW + 1] + pRaw[nIdxRaw + nW - 1] + pRaw[nIdxRaw + nW + 1]) >> 2;
-            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw - nW] + pRaw[nIdxRaw + 1] + pRaw[nIdxRaw + nW] + pRaw[nIdxRaw - 1]) >> 2;
-            pBmp24[nIdxBmp + BayerR] = pRaw[nIdxRaw];
-            nIdxBmp += 6;
-            nIdxRaw += 2;
-        }
-        nIdxBmp += 3 * (2 + ptROrg.x);
-        nIdxRaw += 2 + ptROrg.x;
-    }
-}
-
-void rawtoraw8(BYTE* frame, BYTE* raw8, int bit, int w, int h)
-{
-    for(int i = 0; i < h; i++)
-    {
-        for(int j = 0; j < w; j++)
-        {
-            BYTE low=*(frame+2*(i*w+ j));
-            BYTE high=*(frame+2*(i*w+ j)+1);
-            *(raw8+i*w+ j)=((low>>(bit-8)) | (high<<(16-bit)) ) ;
-         }
-    }
+    free(*buffer);
+    *buffer = malloc(need);
+    *size = *buffer != NULL ? need : 0;
 }
 
 static void errno_exit(const char *s)
@@ -501,39 +215,6 @@ static int xioctl(int fh, int request, void *arg)
     return r;
 }
 
-int MV2_HostKit::read_frame(void)
-{
-    CLEAR(buf);
-    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
-	
-    if (-1 == xioctl(fd, VIDIOC_DQBUF, &buf))
-     	errno_exit("VIDIOC_DQBUF");
-	
-
-    cv_display(buffers[buf.index].start, buf.bytesused);
-
-
-    if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
-            errno_exit("VIDIOC_QBUF");
-    return 1;
-}
-static void stop_capturing(void)
-{
-    enum v4l2_buf_type type;
-    type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (-1 == xioctl(fd, VIDIOC_STREAMOFF, &type))
-            errno_exit("VIDIOC_STREAMOFF");
-}
-
-static void start_capturing(void)
-{
-	enum v4l2_buf_type type;
-
-	type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-	if (-1 == xioctl(fd, VIDIOC_STREAMON, &type))
-		errno_exit("VIDIOC_STREAMON");
-}
 static void open_device(void)
 {
 	struct stat st;
@@ -563,131 +244,6 @@ static void close_device(void)
             errno_exit("close");
     fd = -1;
 }
-static int emun_resolution(void)
-{
-	struct v4l2_fmtdesc fmt;
- 	struct v4l2_frmsizeenum size;
-	int ret;
-	
-	fmt.index=1; //NV12 format
-	fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-	if (-1 == xioctl(fd, VIDIOC_ENUM_FMT, &fmt))
-		errno_exit("VIDIOC_ENUM_FMT");
-
-	memset (&size, 0, sizeof(struct v4l2_frmsizeenum));
-	size.index = 0;
-	size.pixel_format = fmt.pixelformat;
-	if((xioctl (fd, VIDIOC_ENUM_FRAMESIZES, &size)<0)){
-		errno_exit("can not list the frame size!\n");	
-	}
-
-	if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE)
-    {
-        do
-        {
-            s_video_res[size.index].width = size.discrete.width;
-            s_video_res[size.index].height = size.discrete.height;
-	     	s_video_res[size.index].format = size.pixel_format;
-            printf("got discrete frame size %dx%d, format: 0x%x\n",
-                   size.discrete.width,
-                   size.discrete.height,
-                   size.pixel_format);
-            size.index++;
-            svideo_res_list.num_res++;
-            if(size.index>=MAX_SUPPORT_RES)
-            {
-                break;
-            }
-        } while (xioctl(fd, VIDIOC_ENUM_FRAMESIZES, &size) >= 0);
-    }
-    else
-    {
-        printf("unknown type!\n");
-    }
-exit:
-	if(svideo_res_list.num_res == 0)
-	{
-	 	printf("have no right resoltion!\n");
-		return -1;
-	}
-	return 0;
-}
-static void init_mmap(void)
-{
-    struct v4l2_requestbuffers req;
-
-    CLEAR(req);
-
-    req.count = 4;
-    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    req.memory = V4L2_MEMORY_MMAP;
-    if (-1 == xioctl(fd, VIDIOC_REQBUFS, &req)) 
-	{
-        if (EINVAL == errno)
-		{
-            fprintf(stderr, "%s does not support ""memory mapping\n", dev_name);
-            exit(EXIT_FAILURE);
-        } 
-		else 
-        {
-            errno_exit("VIDIOC_REQBUFS");
-        }
-    }
-
-    if (req.count < 2) 
-	{
-        fprintf(stderr, "Insufficient buffer memory on %s\n",dev_name);
-        exit(EXIT_FAILURE);
-    }
-
-    buffers = (buffer*)calloc(req.count, sizeof(*buffers));
-
-    if (!buffers) 
-	{
-        fprintf(stderr, "Out of memory\n");
-        exit(EXIT_FAILURE);
-    }
-
-    for (n_buffers = 0; n_buffers < req.count; ++n_buffers)
-	{
-        struct v4l2_buffer buf;
-
-        CLEAR(buf);
-
-        buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf.memory      = V4L2_MEMORY_MMAP;
-        buf.index       = n_buffers;
-
-        if (-1 == xioctl(fd, VIDIOC_QUERYBUF, &buf))
-        {
-            errno_exit("VIDIOC_QUERYBUF");
-        }
-
-        buffers[n_buffers].length = buf.length;
-        buffers[n_buffers].start =mmap(NULL,buf.length,PROT_READ | PROT_WRITE,MAP_SHARED,fd, buf.m.offset);
-        if (MAP_FAILED == buffers[n_buffers].start)
-        {
-            errno_exit("mmap");
-        }
-    }
-}
-
-static void prepare_buffers(void)
-{
-	int i ;
-
-	for (i = 0; i < n_buffers; ++i) 
-	{
-		struct v4l2_buffer buf;
-		CLEAR(buf);
-		buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-		buf.memory = V4L2_MEMORY_MMAP;
-		buf.index = i;
-
-		if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
-			errno_exit("VIDIOC_QBUF");
-	}
-}
 static int set_device_mode(int mode,struct uvc_xu_control_query xu)
 {
 	unsigned char cur_data[2]={0x00,0x00};
@@ -817,37 +373,6 @@ static void init_device(void)
 	if (fmt.fmt.pix.sizeimage < min)
 	        fmt.fmt.pix.sizeimage = min;
 #endif
-	switch (io) 
-	{
-		case IO_METHOD_MMAP:
-			init_mmap();
-			prepare_buffers();
-			break;
-	    default:
-		        break;
-	}
-
-}
-static void uninit_device(void)
-{
-    unsigned int i;
-
-    switch (io) 
-	{
-		case IO_METHOD_MMAP:
-		    for (i = 0; i < n_buffers; ++i)
-			{
-		        if (-1 == munmap(buffers[i].start, buffers[i].length))
-				{
-					errno_exit("munmap");
-		        }
-		    }
-		    break;
-        default:
-	        break;
-    }
-
-    free(buffers);
 }
 
 int MV2_HostKit::set_mode(int mode)
@@ -873,10 +398,10 @@ int MV2_HostKit::set_mode(int mode)
 
 void MV2_HostKit::teardown()
 {
-    stop_capturing();
 	imu_enable_flag   = 0;
 	video_enable_flag = 0;
-    uninit_device();;
+	capture_destroy(engine);
+	engine = NULL;
     close_device();
 
 	quit_flag=1;
@@ -890,16 +415,30 @@ void MV2_HostKit::streamoff()
 {
 	imu_enable_flag   = 0;
 	video_enable_flag = 0;
-    stop_capturing();
-	uninit_device();
+	if (engine != NULL)
+		capture_stop(engine);
 }
 void MV2_HostKit::streamon()
 {
+	struct capture_config_s cfg;
+
 	init_device();
-    start_capturing();
+	if (engine == NULL)
+	{
+		//cv_display keeps its state in globals, so one worker only
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.workers  = 1;
+		cfg.frame_cb = capture_frame;
+		cfg.arg      = this;
+		engine = capture_create(fd, &cfg);
+		if (engine == NULL)
+			errno_exit("capture_create");
+		capture_enum_resolution(engine, 1);
+	}
+	if (capture_start(engine) < 0)
+		errno_exit("capture_start");
 	imu_enable_flag   = 1;
 	video_enable_flag = 1;
-	mainloop();
 }
 
 void MV2_HostKit::getpositiona(int x,int y)
@@ -931,19 +470,19 @@ void MV2_HostKit::keypressevent(QKeyEvent *event)
     {
 	    if((camconbination&0x01)!=0)
 	    {
-	        QString  sbayor=sbayord[frameheadera->bayeroder];
-	        filename = QString( "stereo_img_l_%1.png" ).arg(frameheadera->timestamp1*1000+(frameheadera->timestamp2/1000));
+	        QString  sbayor=sbayord[frameheadera.bayeroder];
+	        filename = QString( "stereo_img_l_%1.png" ).arg(frameheadera.timestamp1*1000+(frameheadera.timestamp2/1000));
 	        filename.replace(QString("sbayord"),sbayor);
-	        pixmapa->save ( filename, "PNG") ;
+	        camviea->save(filename);
 	        cvWaitKey(0);
     	}
 	
 	    if((camconbination&0x04)!=0)
 	    {
-	        QString  sbayor=sbayord[frameheaderc->bayeroder];
-	        filename = QString( "stereo_img_r_%1.png" ).arg(frameheaderc->timestamp1*1000+(frameheaderc->timestamp2/1000));
+	        QString  sbayor=sbayord[frameheaderc.bayeroder];
+	        filename = QString( "stereo_img_r_%1.png" ).arg(frameheaderc.timestamp1*1000+(frameheaderc.timestamp2/1000));
 	        filename.replace(QString("sbayord"),sbayor);
-	        pixmapc->save ( filename, "PNG") ;
+	        camviec->save(filename);
 	        cvWaitKey(2);
 	    }
 		
@@ -1040,36 +579,29 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
      	 }
      }
 	 
-    if(incoming_img->width != frame_header->width)
+    double newindex = 2;
+    if ((5==frame_header->bayeroder)||(7==frame_header->bayeroder)||(8==frame_header->bayeroder)||(9==frame_header->bayeroder))
+        newindex = 1.5;
+
+    //the images follow the stream resolution instead of being sized for the largest one
+    if(incoming_img == NULL || incoming_img->width != frame_header->width ||
+       fullsize_outputa->height != frame_header->height || bufferindex != newindex)
     {
-		 if ((5==frame_header->bayeroder)||(7==frame_header->bayeroder)||(8==frame_header->bayeroder)||(9==frame_header->bayeroder))
-		 {
-		     incoming_img->height=frame_header->height*3/2;
-
-		     incoming_img->width=frame_header->width;
-		     incoming_img->widthStep=frame_header->width;
-		     incoming_img->imageSize=frame_header->height*frame_header->width*3/2;
-		     bufferindex = 1.5;
-		 }
-		 else
-		 {
-		     incoming_img->height=frame_header->height;
-		     incoming_img->width=frame_header->width;
-		     incoming_img->widthStep=frame_header->width*2;
-		     incoming_img->imageSize=frame_header->height*frame_header->width*2;
-		     bufferindex = 2;
-		 }
-
-		fullsize_outputa->height=frame_header->height;
-		fullsize_outputa->width=frame_header->width;
-		fullsize_outputa->widthStep=frame_header->width*4;
-		fullsize_outputa->imageSize=frame_header->height*frame_header->width*4;
-
-		fullsize_outputc->height=frame_header->height;
-		fullsize_outputc->width=frame_header->width;
-		fullsize_outputc->widthStep=frame_header->width*4;
-		fullsize_outputc->imageSize=frame_header->height*frame_header->width*4;
-        return;
+		bufferindex = newindex;
+		if (incoming_img != NULL)
+		{
+			cvReleaseImageHeader(&incoming_img);
+			cvReleaseImage(&fullsize_outputa);
+			cvReleaseImage(&fullsize_outputc);
+		}
+
+		if (bufferindex == 1.5)
+			incoming_img = cvCreateImageHeader(cvSize(frame_header->width, frame_header->height*3/2), IPL_DEPTH_8U, 1);
+		else
+			incoming_img = cvCreateImageHeader(cvSize(frame_header->width, frame_header->height), IPL_DEPTH_8U, 2);
+
+		fullsize_outputa = cvCreateImage(cvSize(frame_header->width, frame_header->height), IPL_DEPTH_8U, 4);
+		fullsize_outputc = cvCreateImage(cvSize(frame_header->width, frame_header->height), IPL_DEPTH_8U, 4);
     }
 
 
@@ -1090,60 +622,42 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
     QImage imgc(frame_header->width,frame_header->height,QImage::Format_RGB32);
 
 
+    QImage* target = NULL;
+    if (0 == frame_header->channel)
+        target = &imga;
+    else if (2 == frame_header->channel)
+        target = &imgc;
+
     if((3==frame_header->bayeroder)|(2==frame_header->bayeroder)|(1==frame_header->bayeroder)|(0==frame_header->bayeroder))
     {
-	    PLContext pCtx={eBayer(frame_header->bayeroder),frame_header->width,frame_header->height };
-	    BYTE* pBmp24=(BYTE*)malloc(WIDTHBYTES(frame_header->width * 24) * frame_header->height);
+	    BYTE* pBmp24=(BYTE*)malloc(PK_BMP24_STRIDE(frame_header->width) * frame_header->height);
 	    BYTE* raw8=(BYTE*)malloc(WIDTHBYTES(frame_header->width * 8) * frame_header->height);
-	    rawtoraw8((BYTE*)frame,raw8,10,frame_header->width,frame_header->height);
+	    pk_raw16_to_raw8((BYTE*)frame,raw8,10,frame_header->width,frame_header->height);
 
-	    DemosaicBilinear(&pCtx, raw8, pBmp24);
+	    pk_demosaic_bilinear(frame_header->bayeroder, raw8, pBmp24, frame_header->width, frame_header->height);
 
-        switch (frame_header->channel) 
-		{
-		    case 0:
-		        {
-		            for(int i = 0; i < frame_header->height; i++)
-		            {
-		                for(int j = 0; j < frame_header->width; j++)
-		                {
-		                   BYTE  bmp24b =* (pBmp24+3*(i*frame_header->width+ j));
-		                   BYTE  bmp24g =* (pBmp24+3*(i*frame_header->width+ j)+1);
-		                   BYTE  bmp24r =* (pBmp24+3*(i*frame_header->width+ j)+2);
-		                   QRgb qRgb = (0xff << 24) | ((bmp24r & 0xff) << 16) | ((bmp24g & 0xff) << 8) | (bmp24b & 0xff);
-		                   imga.setPixel(j,i,qRgb);
-		                 }
-		            }
-		            break;
-		        }
-		    case 2:
-		        {
-		            for(int i = 0; i < frame_header->height; i++)
-		            {
-		                for(int j = 0; j < frame_header->width; j++)
-		                {
-		                   BYTE  bmp24b =* (pBmp24+3*(i*frame_header->width+ j));
-		                   BYTE  bmp24g =* (pBmp24+3*(i*frame_header->width+ j)+1);
-		                   BYTE  bmp24r =* (pBmp24+3*(i*frame_header->width+ j)+2);
-		                   QRgb qRgb = (0xff << 24) | ((bmp24r & 0xff) << 16) | ((bmp24g & 0xff) << 8) | (bmp24b & 0xff);
-		                   imgc.setPixel(j,i,qRgb);
-		                 }
-		            }
-		            break;
-		        }
-		    default:
-		        break;
-        }
+	    if (target != NULL)
+	        pk_bgr24_to_bgra(pBmp24, PK_BMP24_STRIDE(frame_header->width), target->bits(), frame_header->width, frame_header->height);
 
 		free(pBmp24);
 		free(raw8);
     }
-	else if((4==frame_header->bayeroder)||(5==frame_header->bayeroder)||(7==frame_header->bayeroder)||(8==frame_header->bayeroder)||(9==frame_header->bayeroder))
+	else if((4==frame_header->bayeroder)||(8==frame_header->bayeroder)||(9==frame_header->bayeroder))
     {
-            if(4==frame_header->bayeroder)
+            BYTE* y = (BYTE*)frame;
+            BYTE* uv = y + frame_header->width * frame_header->height;
+
+            //straight into the QImage, no opencv round trip
+            if (target != NULL)
             {
-                cvt_conversion_type=CV_YUV2RGBA_YVYU;
+                if(4==frame_header->bayeroder)
+                    pk_yuv422i_to_bgra(y, target->bits(), frame_header->width, frame_header->height, PK_YVYU);
+                else
+                    pk_nv12_to_bgra(y, uv, target->bits(), frame_header->width, frame_header->height, 8==frame_header->bayeroder);
             }
+    }
+	else if((5==frame_header->bayeroder)||(7==frame_header->bayeroder))
+    {
              if(5==frame_header->bayeroder)
              {
                  cvt_conversion_type= CV_YUV2BGRA_I420  ;
@@ -1152,14 +666,6 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
              {
                  cvt_conversion_type= CV_YUV2BGRA_YV12  ;
              }
-             if(8==frame_header->bayeroder)
-             {
-                 cvt_conversion_type= CV_YUV2BGRA_NV21  ;
-             }
-             if(9==frame_header->bayeroder)
-             {
-                 cvt_conversion_type= CV_YUV2BGRA_NV12  ;
-             }
 
 			 
             switch (frame_header->channel)
@@ -1182,47 +688,11 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
         else if(6==frame_header->bayeroder)
         {
             BYTE* raw8=(BYTE*)malloc(WIDTHBYTES(frame_header->width * 8) * frame_header->height);
-            rawtoraw8((BYTE*)frame,raw8,10,frame_header->width,frame_header->height);
-
-            BYTE* pBmp24=(BYTE*)malloc(WIDTHBYTES(frame_header->width * 24) * frame_header->height);
+            pk_raw16_to_raw8((BYTE*)frame,raw8,10,frame_header->width,frame_header->height);
 
-            switch (frame_header->channel)
-			{
-	            case 0:
-	            {
-	                for(int i = 0; i < frame_header->height; i++)
-	                {
-	                    for(int j = 0; j < frame_header->width; j++)
-	                    {
-
-	                        BYTE  bmp24b =* ((BYTE*)raw8+(i*frame_header->width+ j));
-	                        BYTE  bmp24g =* ((BYTE*)raw8+(i*frame_header->width+ j));
-	                        BYTE  bmp24r =* ((BYTE*)raw8+(i*frame_header->width+ j));
-	                       QRgb qRgb = (0xff << 24) | ((bmp24r & 0xff) << 16) | ((bmp24g & 0xff) << 8) | (bmp24b & 0xff);
-	                        imga.setPixel(j,i,qRgb);
-	                     }
-	                }
-	                break;
-	            }
-	            case 2:
-	            {
-	                for(int i = 0; i < frame_header->height; i++)
-	                {
-	                    for(int j = 0; j < frame_header->width; j++)
-	                    {
-	                        BYTE  bmp24b =* ((BYTE*)raw8+(i*frame_header->width+ j));
-	                        BYTE  bmp24g =* ((BYTE*)raw8+(i*frame_header->width+ j));
-	                        BYTE  bmp24r =* ((BYTE*)raw8+(i*frame_header->width+ j));
-	                       QRgb qRgb = (0xff << 24) | ((bmp24r & 0xff) << 16) | ((bmp24g & 0xff) << 8) | (bmp24b & 0xff);
-	                        imgc.setPixel(j,i,qRgb);
-	                     }
-	                }
-	                break;
-	            }
-	            default:
-	                break;
-            }
-            free(pBmp24);
+            if (target != NULL)
+                pk_gray_to_bgra(raw8, target->bits(), frame_header->width, frame_header->height);
+            free(raw8);
         }
         else
         {
@@ -1235,21 +705,22 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
 	        {
 	            camconbination=camconbination|0x01;
 
-				frameheadera=frame_header;
+				frameheadera=*frame_header;
 				
-	            memcpy(buffercama, frame, frameheadera->width*frameheadera->height*bufferindex);
+	            reserve_buffer(&buffercama, &buffercama_size, frameheadera.width*frameheadera.height*bufferindex);
+	            memcpy(buffercama, frame, frameheadera.width*frameheadera.height*bufferindex);
 				
-	            int rawa=*(unsigned short*)( buffercama+2*((int)positiona.y()*frameheadera->width+(int) positiona.x()));
+	            int rawa=*(unsigned short*)( buffercama+2*((int)positiona.y()*frameheadera.width+(int) positiona.x()));
 				
 	            QRgb qRgba=imga.pixel(positiona.x(),  positiona.y());
 				
 	            int brightnessa=((qRgba& 0x00ff0000)>>16)*0.299+((qRgba& 0x0000ff00)>>8)*0.587+(qRgba& 0x000000ff)*0.114;
 				
-				sendinfocama(frameheadera->width,frameheadera->height, frameheadera->bit, frameheadera->bayeroder, positiona.x(),   positiona.y(), brightnessa, rawa);
+				sendinfocama(frameheadera.width,frameheadera.height, frameheadera.bit, frameheadera.bayeroder, positiona.x(),   positiona.y(), brightnessa, rawa);
 				
-	            *pixmapa=QPixmap::fromImage(imga);
-				
-	            emit displaycama(&imga);
+	            //the view owns the copy, skip the frame while it is still busy
+	            if (camviea->claim())
+	                emit displaycama(new QImage(imga.copy()));
 	            break;
 	        }
 			
@@ -1258,21 +729,21 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
 				
 	            camconbination=camconbination|0x04;
 				
-	            frameheaderc=frame_header;
+	            frameheaderc=*frame_header;
 				
-	            memcpy(buffercamc, frame, frameheaderc->width*frameheaderc->height*bufferindex);
+	            reserve_buffer(&buffercamc, &buffercamc_size, frameheaderc.width*frameheaderc.height*bufferindex);
+	            memcpy(buffercamc, frame, frameheaderc.width*frameheaderc.height*bufferindex);
 				
-	            int rawc=*(unsigned short*)( buffercamc+2*((int)positionc.y()*frameheaderc->width+(int) positionc.x()));
+	            int rawc=*(unsigned short*)( buffercamc+2*((int)positionc.y()*frameheaderc.width+(int) positionc.x()));
 				
 	            QRgb qRgbc=imgc.pixel(positionc.x(),  positionc.y());
 				
 	            int brightnessc=((qRgbc& 0x00ff0000)>>16)*0.299+((qRgbc& 0x0000ff00)>>8)*0.587+(qRgbc& 0x000000ff)*0.114;
 				
-	            sendinfocamc(frameheaderc->width,frameheaderc->height, frameheaderc->bit, frameheaderc->bayeroder, positionc.x(),   positionc.y(), brightnessc, rawc);
+	            sendinfocamc(frameheaderc.width,frameheaderc.height, frameheaderc.bit, frameheaderc.bayeroder, positionc.x(),   positionc.y(), brightnessc, rawc);
 				
-	            *pixmapc=QPixmap::fromImage(imgc);
-				 
-	            emit displaycamc(&imgc);
+	            if (camviec->claim())
+	                emit displaycamc(new QImage(imgc.copy()));
 	            break;
 	        }
 			
@@ -1282,49 +753,12 @@ void MV2_HostKit::cv_display(void* frame, int frame_lenght)
 
 }
 
-void MV2_HostKit::mainloop(void)
+//runs on the capture worker, the gui thread is never blocked by it
+void MV2_HostKit::capture_frame(void *arg, struct capture_frame_s *frame)
 {
-    while (1) 
-	{
-        if(video_enable_flag)
-        {
-	        for (;;) 
-			{
-                fd_set fds;
-                struct timeval tv;
-                int r;
-
-			    FD_ZERO(&fds);
-			    FD_SET(fd, &fds);
-
-			    /* Timeout. */
-                tv.tv_sec = 100;
-			    tv.tv_usec = 0;
-
-			    r = select(fd + 1, &fds, NULL, NULL, &tv);
-			    if (-1 == r)
-				{
-
-			        if (EINTR == errno)
-			                continue;
-			        errno_exit("select");
-			    }
-
-                if (0 == r) 
-				{
-                    fprintf(stderr, "select timeout\n");
-                    exit(EXIT_FAILURE);
-                }
-
-                if (read_frame())
-                        break;
-            }
-        }
-		else
-        {
-           break;
-        }
-    }
+	MV2_HostKit *kit = (MV2_HostKit *)arg;
+
+	kit->cv_display(frame->data, frame->bytesused);
 }
 
 MV2_HostKit::MV2_HostKit(QWidget *parent):QMainWindow(parent)
@@ -1378,9 +812,6 @@ MV2_HostKit::MV2_HostKit(QWidget *parent):QMainWindow(parent)
 	connect(this,SIGNAL(sendinfocama(int,int,int,int,int,int,int,int)),mainguiwidget,SLOT(setinfoa(int,int,int,int,int,int,int,int)));
 	connect(this,SIGNAL(sendinfocamc(int,int,int,int,int,int,int,int)),mainguiwidget,SLOT(setinfoc(int,int,int,int,int,int,int,int)));
 
-    pixmapa = new QPixmap(5000,5000);
-    pixmapc = new QPixmap(5000,5000);
-
 	//init the imu cmd 
     xu_data.unit = 0x03;
     xu_data.selector = 0x0C;
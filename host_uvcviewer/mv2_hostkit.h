@@ -12,6 +12,7 @@
 #include<QThread>
 #include<QDateTime>
 #include"mipi_tx_header.h"
+#include"capture_engine.h"
 
 class MV2_HostKit : public QMainWindow
 {
@@ -51,8 +52,7 @@ private slots:
 
 public:
     void cv_display(void* frame, int frame_lenght);
-    void mainloop(void);
-	int  read_frame(void);
+	static void capture_frame(void *arg, struct capture_frame_s *frame);
     int  testtimer();
 	int start_videoprocess();
 	
@@ -0,0 +1,298 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "pixel_kernels.h"
+
+/*
+ * checks every simd kernel against the scalar reference, byte for byte,
+ * then times each one on a full size frame. exits non zero on a mismatch.
+ */
+
+#define BENCH_DEF_W			4208
+#define BENCH_DEF_H			3120
+#define BENCH_DEF_LOOPS		10
+
+struct frame_bufs_s {
+	int w, h;
+	unsigned char *raw16;		/* w * h * 2 */
+	unsigned char *raw10;		/* w / 4 * 5 * h */
+	unsigned char *raw8;		/* w * h */
+	unsigned char *yuv;			/* w * h * 2, big enough for nv12 and 422 */
+	unsigned char *out;			/* w * h * 4 */
+	unsigned short *out16;		/* w * h */
+};
+
+static const char *bayer_names[4] = { "gbrg", "rggb", "bggr", "grbg" };
+static const char *yuv422_names[3] = { "yuyv", "yvyu", "uyvy" };
+
+static long long now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void fill_random(unsigned char *p, size_t len, unsigned int *seed)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		p[i] = rand_r(seed) >> 7;
+}
+
+static int frame_alloc(struct frame_bufs_s *f, int w, int h)
+{
+	f->w = w;
+	f->h = h;
+	f->raw16 = (unsigned char *)malloc((size_t)w * h * 2);
+	f->raw10 = (unsigned char *)malloc((size_t)(w / 4 * 5 + 16) * h);
+	f->raw8 = (unsigned char *)malloc((size_t)w * h);
+	f->yuv = (unsigned char *)malloc((size_t)w * h * 2);
+	f->out = (unsigned char *)malloc((size_t)PK_BMP24_STRIDE(w) * h + (size_t)w * h * 4);
+	f->out16 = (unsigned short *)malloc((size_t)w * h * 2);
+	if (!f->raw16 || !f->raw10 || !f->raw8 || !f->yuv || !f->out || !f->out16)
+		return -1;
+
+	return 0;
+}
+
+static void frame_free(struct frame_bufs_s *f)
+{
+	free(f->raw16);
+	free(f->raw10);
+	free(f->raw8);
+	free(f->yuv);
+	free(f->out);
+	free(f->out16);
+}
+
+static void frame_fill(struct frame_bufs_s *f, unsigned int seed)
+{
+	unsigned short *s;
+	int i;
+
+	fill_random(f->raw16, (size_t)f->w * f->h * 2, &seed);
+	/* 10 bit samples like the sensor sends */
+	s = (unsigned short *)f->raw16;
+	for (i = 0; i < f->w * f->h; i++)
+		s[i] &= 0x3ff;
+	fill_random(f->raw10, (size_t)(f->w / 4 * 5 + 16) * f->h, &seed);
+	fill_random(f->raw8, (size_t)f->w * f->h, &seed);
+	fill_random(f->yuv, (size_t)f->w * f->h * 2, &seed);
+}
+
+/* runs one kernel with the given isa, the output lands in f->out/out16 */
+enum {
+	K_RAW16_TO_RAW8,
+	K_RAW10_TO_RAW16,
+	K_RAW10_TO_RAW8,
+	K_DEMOSAIC,
+	K_NV12,
+	K_NV21,
+	K_YUV422I,
+	K_NUM,
+};
+
+static const char *kernel_names[K_NUM] = {
+	"raw16->raw8", "raw10->raw16", "raw10->raw8", "demosaic", "nv12->bgra", "nv21->bgra", "422i->bgra",
+};
+
+static size_t kernel_run(struct frame_bufs_s *f, int kernel, int variant)
+{
+	const int w = f->w, h = f->h;
+
+	switch (kernel) {
+	case K_RAW16_TO_RAW8:
+		pk_raw16_to_raw8(f->raw16, f->out, 10, w, h);
+		return (size_t)w * h;
+	case K_RAW10_TO_RAW16:
+		pk_raw10_to_raw16(f->raw10, w / 4 * 5 + 16, f->out16, w, h);
+		return (size_t)w * h * 2;
+	case K_RAW10_TO_RAW8:
+		pk_raw10_to_raw8(f->raw10, w / 4 * 5 + 16, f->out, w, h);
+		return (size_t)w * h;
+	case K_DEMOSAIC:
+		pk_demosaic_bilinear(variant, f->raw8, f->out, w, h);
+		return (size_t)PK_BMP24_STRIDE(w) * h;
+	case K_NV12:
+	case K_NV21:
+		pk_nv12_to_bgra(f->yuv, f->yuv + w * h, f->out, w, h, kernel == K_NV21);
+		return (size_t)w * h * 4;
+	case K_YUV422I:
+		pk_yuv422i_to_bgra(f->yuv, f->out, w, h, variant);
+		return (size_t)w * h * 4;
+	default:
+		return 0;
+	}
+}
+
+static int kernel_variants(int kernel)
+{
+	if (kernel == K_DEMOSAIC)
+		return 4;
+	if (kernel == K_YUV422I)
+		return 3;
+	return 1;
+}
+
+static const char *variant_name(int kernel, int variant)
+{
+	if (kernel == K_DEMOSAIC)
+		return bayer_names[variant];
+	if (kernel == K_YUV422I)
+		return yuv422_names[variant];
+	return "";
+}
+
+static void *kernel_out(struct frame_bufs_s *f, int kernel)
+{
+	return kernel == K_RAW10_TO_RAW16 ? (void *)f->out16 : (void *)f->out;
+}
+
+static size_t kernel_out_size(struct frame_bufs_s *f, int kernel)
+{
+	if (kernel == K_RAW10_TO_RAW16)
+		return (size_t)f->w * f->h * 2;
+	return (size_t)PK_BMP24_STRIDE(f->w) * f->h + (size_t)f->w * f->h * 4;
+}
+
+/* scalar result vs isa result for every kernel, on a frame of w x h */
+static int verify(int isa, int w, int h)
+{
+	struct frame_bufs_s f;
+	unsigned char *ref;
+	size_t len, i;
+	int k, v, fails = 0;
+
+	if (frame_alloc(&f, w, h) < 0)
+		return -1;
+	frame_fill(&f, w * 131 + h);
+	ref = (unsigned char *)malloc((size_t)PK_BMP24_STRIDE(w) * h + (size_t)w * h * 4);
+
+	for (k = 0; k < K_NUM; k++) {
+		/* raw10 needs whole 4 pixel groups */
+		if ((k == K_RAW10_TO_RAW16 || k == K_RAW10_TO_RAW8) && (w & 3))
+			continue;
+		for (v = 0; v < kernel_variants(k); v++) {
+			pk_set_isa(PK_ISA_SCALAR);
+			memset(kernel_out(&f, k), 0xa5, kernel_out_size(&f, k));
+			len = kernel_run(&f, k, v);
+			memcpy(ref, kernel_out(&f, k), len);
+
+			pk_set_isa(isa);
+			memset(kernel_out(&f, k), 0x5a, kernel_out_size(&f, k));
+			kernel_run(&f, k, v);
+			if (memcmp(ref, kernel_out(&f, k), len) == 0)
+				continue;
+
+			for (i = 0; i < len && ref[i] == ((unsigned char *)kernel_out(&f, k))[i]; i++)
+				;
+			printf("MISMATCH %s %s %s at %dx%d, byte %zu: %u != %u\n", pk_isa_name(isa), kernel_names[k],
+			       variant_name(k, v), w, h, i, ((unsigned char *)kernel_out(&f, k))[i], ref[i]);
+			fails++;
+		}
+	}
+
+	free(ref);
+	frame_free(&f);
+	return fails;
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [options]\n", prog);
+	printf("  -s WxH      frame size (default %dx%d)\n", BENCH_DEF_W, BENCH_DEF_H);
+	printf("  -n loops    timed runs per kernel (default %d)\n", BENCH_DEF_LOOPS);
+	printf("  -v          verify only\n");
+}
+
+int main(int argc, char **argv)
+{
+	/* odd sizes catch the scalar tails and the tiny frame fallback */
+	static const int sizes[][2] = { { 64, 8 }, { 132, 7 }, { 100, 6 }, { 78, 9 }, { 6, 6 }, { 640, 480 } };
+	struct frame_bufs_s f;
+	int w = BENCH_DEF_W, h = BENCH_DEF_H, loops = BENCH_DEF_LOOPS;
+	int verify_only = 0, fails = 0;
+	double best[PK_ISA_NUM][K_NUM];
+	long long t0, t;
+	int opt, isa, k, i, n;
+
+	while ((opt = getopt(argc, argv, "s:n:vh")) != -1) {
+		switch (opt) {
+		case 's':
+			if (sscanf(optarg, "%dx%d", &w, &h) != 2 || w < 8 || h < 8 || (w & 3)) {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'n':
+			loops = atoi(optarg);
+			break;
+		case 'v':
+			verify_only = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	for (isa = PK_ISA_SCALAR + 1; isa < PK_ISA_NUM; isa++) {
+		if (!pk_isa_supported(isa))
+			continue;
+		for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+			fails += verify(isa, sizes[i][0], sizes[i][1]);
+		printf("verify %s: %s\n", pk_isa_name(isa), fails ? "FAILED" : "ok");
+	}
+	if (fails || verify_only)
+		return fails ? 1 : 0;
+
+	if (frame_alloc(&f, w, h) < 0) {
+		fprintf(stderr, "out of memory\n");
+		return -1;
+	}
+	frame_fill(&f, 1);
+
+	printf("%dx%d, best of %d runs, ms\n", w, h, loops);
+	printf("%-14s", "kernel");
+	for (isa = 0; isa < PK_ISA_NUM; isa++)
+		if (pk_isa_supported(isa))
+			printf("%10s", pk_isa_name(isa));
+	printf("\n");
+
+	for (k = 0; k < K_NUM; k++) {
+		for (isa = 0; isa < PK_ISA_NUM; isa++) {
+			best[isa][k] = 0;
+			if (!pk_isa_supported(isa))
+				continue;
+			pk_set_isa(isa);
+			kernel_run(&f, k, 0);
+			for (n = 0; n < loops; n++) {
+				t0 = now_us();
+				kernel_run(&f, k, 0);
+				t = now_us() - t0;
+				if (n == 0 || t < best[isa][k])
+					best[isa][k] = t;
+			}
+		}
+
+		printf("%-14s", kernel_names[k]);
+		for (isa = 0; isa < PK_ISA_NUM; isa++)
+			if (pk_isa_supported(isa))
+				printf("%10.2f", best[isa][k] / 1000.0);
+		for (isa = PK_ISA_NUM - 1; isa > PK_ISA_SCALAR; isa--) {
+			if (pk_isa_supported(isa) && best[isa][k] > 0) {
+				printf("   x%.1f", best[PK_ISA_SCALAR][k] / best[isa][k]);
+				break;
+			}
+		}
+		printf("\n");
+	}
+
+	frame_free(&f);
+	return 0;
+}
@@ -0,0 +1,17 @@
+#-------------------------------------------------
+#
+# pixel kernel check and benchmark, no Qt/OpenCV needed
+#
+#-------------------------------------------------
+
+QT  -= core gui
+
+TARGET = pixel_bench
+TEMPLATE = app
+CONFIG += console release
+CONFIG -= app_bundle qt
+
+SOURCES += pixel_bench.cpp \
+    pixel_kernels.cpp \
+
+HEADERS  += pixel_kernels.h \
@@ -0,0 +1,1101 @@
+#include "pixel_kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PK_X86					1
+#include <immintrin.h>
+#define PK_TARGET_SSE41			__attribute__((target("sse4.1")))
+#define PK_TARGET_AVX2			__attribute__((target("avx2")))
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PK_NEON					1
+#include <arm_neon.h>
+#endif
+
+typedef unsigned char BYTE;
+
+#define min(x,y)				( x>y?y:x )
+#define CLIP(x)					static_cast<BYTE>((x) > 255 ? 255 : ((x) < 0 ? 0 : (x)))
+
+static int pk_isa = -1;
+
+/* ------------------------------------------------------------------------
+ * scalar reference. BorderInterpolate, DemosaicBilinear and rawtoraw8 are
+ * the viewer's original loops, the simd versions must match them byte for
+ * byte.
+ * ---------------------------------------------------------------------- */
+
+typedef enum
+{
+    BayerB,
+    BayerG,
+    BayerR
+}BayerColor;
+
+typedef struct tagPOINT
+{
+    int x;
+    int y;
+}POINT;
+
+typedef struct
+{
+    int eBayerPattern;
+    int nW, nH;
+
+} PLContext;
+
+static const BayerColor g_BayerRGB[4][2][2] =
+{
+    BayerG, // 0 0 0
+    BayerB, // 0 0 1
+    BayerR, // 0 1 0
+    BayerG, // 0 1 1
+    BayerR, // 1 0 0
+    BayerG, // 1 0 1
+    BayerG, // 1 1 0
+    BayerB, // 1 1 1
+    BayerB, // 2 0 0
+    BayerG, // 2 0 1
+    BayerG, // 2 1 0
+    BayerR, // 2 1 1
+    BayerG, // 3 0 0
+    BayerB, // 3 1 0
+    BayerR, // 3 0 1
+    BayerG  // 3 1 1
+};
+
+static void BorderInterpolate(PLContext* pCtx, const BYTE* pRaw, BYTE* pBmp24, const int nW, const int nH, const int nBorder)
+{
+    if ((nBorder < 1) || (nBorder > min(nW, nH) / 2))
+        return;
+
+    const BYTE* raw = NULL;
+    BYTE* dib = NULL;
+    for (long y = 0; y < nH; ++y)
+    {
+        raw = pRaw + y * nW;
+        dib = pBmp24 + y * PK_BMP24_STRIDE(nW);
+        for (long x = 0; x < nW; ++x)
+        {
+            if ((x == nBorder) && (y >= nBorder) && (y < nH - nBorder))
+            {
+                x = nW - nBorder;
+                raw += (nW - 2 * nBorder);
+                dib += (nW - 2 * nBorder) * 3;
+            }
+            long sum[3];
+            memset(sum,0 ,sizeof(sum));
+            long cnt[3];
+            memset(cnt, 0,sizeof(cnt));
+            BayerColor color = g_BayerRGB[pCtx->eBayerPattern][x & 0x01][y & 0x01];
+            for (long yoffset = -1; yoffset <= 1; ++yoffset)
+            {
+                for (long xoffset = -1; xoffset <= 1; ++xoffset)
+                {
+                    if ((yoffset == 0) && (xoffset == 0))
+                    {
+                        continue;
+                    }
+                    long y1 = y + yoffset;
+                    long x1 = x + xoffset;
+                    if ((y1 >= 0) && (y1 < nH) && (x1 >= 0) && (x1 < nW))
+                    {
+                        BayerColor c = g_BayerRGB[pCtx->eBayerPattern][x1 & 0x01][y1 & 0x01];
+                        if (c == color)
+                        {
+                            continue;
+                        }
+                        sum[c] += raw[yoffset * nW + xoffset];
+                        ++cnt[c];
+                    }
+                }
+            }
+            for (int c = BayerR; c >= BayerB; --c)
+            {
+                if (c == color)
+                {
+                    dib[c] = *raw;
+                }
+                else
+                {
+                    dib[c] = CLIP(1.0 * sum[c] / cnt[c]);
+                }
+            }
+            ++raw;
+            dib += 3;
+        }
+    }
+}
+
+/* where each colour sits in the 2x2 cell and which neighbours feed it */
+struct bayer_layout_s {
+	POINT r, g1, g2, b;
+	int g1b_w, g1r_w, g2b_w, g2r_w;		/* 1: offset nW (vertical), 0: offset 1 */
+};
+
+static const struct bayer_layout_s bayer_layouts[4] = {
+	/* GBRG */ { {1, 0}, {0, 0}, {1, 1}, {0, 1}, 1, 0, 0, 1 },
+	/* RGGB */ { {0, 0}, {0, 1}, {1, 0}, {1, 1}, 0, 1, 1, 0 },
+	/* BGGR */ { {1, 1}, {0, 1}, {1, 0}, {0, 0}, 1, 0, 0, 1 },
+	/* GRBG */ { {0, 1}, {0, 0}, {1, 1}, {1, 0}, 0, 1, 1, 0 },
+};
+
+static void DemosaicBilinear(PLContext* pCtx, const BYTE* pRaw, BYTE* pBmp24)
+{
+    const int nW = pCtx->nW;
+    const int nH = pCtx->nH;
+    const struct bayer_layout_s *lay = &bayer_layouts[pCtx->eBayerPattern];
+    memset(pBmp24,0 ,PK_BMP24_STRIDE(nW) * nH);
+    BorderInterpolate(pCtx, pRaw, pBmp24, nW, nH, 2);
+    POINT ptROrg = lay->r;
+    POINT ptG1Org = lay->g1;
+    POINT ptG2Org = lay->g2;
+    POINT ptBOrg = lay->b;
+    int nG1B = lay->g1b_w ? nW : 1; // B @ G1
+    int nG1R = lay->g1r_w ? nW : 1; // R @ G1
+    int nG2B = lay->g2b_w ? nW : 1; // B @ G2
+    int nG2R = lay->g2r_w ? nW : 1; // R @ G2
+    const int nLine = PK_BMP24_STRIDE(nW);
+    // G1
+    for (int y = 2 + ptG1Org.y; y < nH - 2; y += 2)
+    {
+        int nIdxBmp = nLine * y + 3 * (2 + ptG1Org.x);
+        int nIdxRaw = nW * y + 2 + ptG1Org.x;
+        for (int x = 2 + ptG1Org.x; x < nW - 2; x += 2)
+        {
+            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw] + pRaw[nIdxRaw - nW - 1]) >> 1;
+            pBmp24[nIdxBmp + BayerB] = (pRaw[nIdxRaw - nG1B] + pRaw[nIdxRaw + nG1B]) >> 1;
+            pBmp24[nIdxBmp + BayerR] = (pRaw[nIdxRaw - nG1R] + pRaw[nIdxRaw + nG1R]) >> 1;
+            nIdxBmp += 6;
+            nIdxRaw += 2;
+        }
+    }
+    // G2
+    for (int y = 2 + ptG2Org.y; y < nH - 2; y += 2)
+    {
+        int nIdxBmp = nLine * y + 3 * (2 + ptG2Org.x);
+        int nIdxRaw = nW * y + 2 + ptG2Org.x;
+        for (int x = 2 + ptG2Org.x; x < nW - 2; x += 2)
+        {
+            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw] + pRaw[nIdxRaw - nW - 1]) >> 1;
+            pBmp24[nIdxBmp + BayerB] = (pRaw[nIdxRaw - nG2B] + pRaw[nIdxRaw + nG2B]) >> 1;
+            pBmp24[nIdxBmp + BayerR] = (pRaw[nIdxRaw - nG2R] + pRaw[nIdxRaw + nG2R]) >> 1;
+            nIdxBmp += 6;
+            nIdxRaw  += 2;
+        }
+    }
+    // B
+    for (int y = 2 + ptBOrg.y; y < nH - 2; y += 2)
+    {
+        int nIdxBmp = nLine * y + 3 * (2 + ptBOrg.x);
+        int nIdxRaw = nW * y + 2 + ptBOrg.x;
+        for (int x = 2 + ptBOrg.x; x < nW - 2; x += 2)
+        {
+            pBmp24[nIdxBmp + BayerB] = pRaw[nIdxRaw];
+            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw - nW] + pRaw[nIdxRaw + 1] + pRaw[nIdxRaw + nW] + pRaw[nIdxRaw - 1]) >> 2;
+            pBmp24[nIdxBmp + BayerR] = (pRaw[nIdxRaw - nW - 1] + pRaw[nIdxRaw - nW + 1] + pRaw[nIdxRaw + nW - 1] + pRaw[nIdxRaw + nW + 1]) >> 2;
+            nIdxBmp += 6;
+            nIdxRaw += 2;
+        }
+    }
+    // R
+    for (int y = 2 + ptROrg.y; y < nH - 2; y += 2)
+    {
+        for (int x = 2 + ptROrg.x; x < nW - 2; x += 2)
+        {
+            int nIdxBmp = nLine * y + 3 * x;
+            int nIdxRaw = nW * y + x;
+            pBmp24[nIdxBmp + BayerB] = (pRaw[nIdxRaw - nW - 1] + pRaw[nIdxRaw - nW + 1] + pRaw[nIdxRaw + nW - 1] + pRaw[nIdxRaw + nW + 1]) >> 2;
+            pBmp24[nIdxBmp + BayerG] = (pRaw[nIdxRaw - nW] + pRaw[nIdxRaw + 1] + pRaw[nIdxRaw + nW] + pRaw[nIdxRaw - 1]) >> 2;
+            pBmp24[nIdxBmp + BayerR] = pRaw[nIdxRaw];
+        }
+    }
+}
+
+static void rawtoraw8(const BYTE* frame, BYTE* raw8, int bit, int w, int h)
+{
+    for(int i = 0; i < h; i++)
+    {
+        for(int j = 0; j < w; j++)
+        {
+            BYTE low=*(frame+2*(i*w+ j));
+            BYTE high=*(frame+2*(i*w+ j)+1);
+            *(raw8+i*w+ j)=((low>>(bit-8)) | (high<<(16-bit)) ) ;
+         }
+    }
+}
+
+static void raw10_to_raw16_c(const BYTE *src, unsigned short *dst, int x, int w)
+{
+	const BYTE *p;
+	int i;
+
+	for (; x < w; x += 4) {
+		p = src + x / 4 * 5;
+		for (i = 0; i < 4; i++)
+			dst[x + i] = (p[i] << 2) | ((p[4] >> (2 * i)) & 3);
+	}
+}
+
+static void raw10_to_raw8_c(const BYTE *src, BYTE *dst, int x, int w)
+{
+	const BYTE *p;
+
+	for (; x < w; x += 4) {
+		p = src + x / 4 * 5;
+		dst[x] = p[0];
+		dst[x + 1] = p[1];
+		dst[x + 2] = p[2];
+		dst[x + 3] = p[3];
+	}
+}
+
+/*
+ * yuv -> rgb in 1/64 fixed point, bt.601 limited range:
+ * 1.164 -> 74, 1.596 -> 102, 0.391 -> 25, 0.813 -> 52, 2.018 -> 129
+ */
+#define YUV_Y(y)				(((int)(y) - 16) * 74)
+
+static inline BYTE clamp_shift6(int v)
+{
+	v >>= 6;
+	return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+static inline void yuv_to_bgra(int y, int u, int v, BYTE *dst)
+{
+	int yy = YUV_Y(y);
+
+	u -= 128;
+	v -= 128;
+	dst[0] = clamp_shift6(yy + 129 * u);
+	dst[1] = clamp_shift6(yy - 25 * u - 52 * v);
+	dst[2] = clamp_shift6(yy + 102 * v);
+	dst[3] = 0xff;
+}
+
+static void nv12_row_c(const BYTE *y, const BYTE *uv, BYTE *dst, int x, int w, int swap_uv)
+{
+	int u, v;
+
+	for (; x < w; x++) {
+		u = uv[(x & ~1) + swap_uv];
+		v = uv[(x & ~1) + 1 - swap_uv];
+		yuv_to_bgra(y[x], u, v, dst + 4 * x);
+	}
+}
+
+/* byte index of y0, u, y1, v in a 4 byte 422 group */
+static const int yuv422_order[3][4] = {
+	{ 0, 1, 2, 3 },		/* YUYV */
+	{ 0, 3, 2, 1 },		/* YVYU */
+	{ 1, 0, 3, 2 },		/* UYVY */
+};
+
+static void yuv422i_row_c(const BYTE *src, BYTE *dst, int x, int w, int order)
+{
+	const int *o = yuv422_order[order];
+	const BYTE *p;
+
+	for (; x < w; x += 2) {
+		p = src + 2 * x;
+		yuv_to_bgra(p[o[0]], p[o[1]], p[o[3]], dst + 4 * x);
+		yuv_to_bgra(p[o[2]], p[o[1]], p[o[3]], dst + 4 * x + 4);
+	}
+}
+
+/* ------------------------------------------------------------------------
+ * demosaic plan shared by the simd versions. each interior pixel takes
+ * every channel from one of six candidates, which one depends only on the
+ * parity of x and y.
+ * ---------------------------------------------------------------------- */
+
+enum {
+	CAND_C,			/* the pixel itself */
+	CAND_H2,		/* (left + right) >> 1 */
+	CAND_V2,		/* (up + down) >> 1 */
+	CAND_CROSS,		/* (up + down + left + right) >> 2 */
+	CAND_DIAG,		/* four diagonals >> 2 */
+	CAND_GD,		/* (pixel + up left) >> 1 */
+	CAND_NUM,
+};
+
+/* sel[y & 1][x & 1][BayerB..BayerR] */
+static void demosaic_plan(int pattern, unsigned char sel[2][2][3])
+{
+	const struct bayer_layout_s *lay = &bayer_layouts[pattern];
+
+	sel[lay->r.y][lay->r.x][BayerB] = CAND_DIAG;
+	sel[lay->r.y][lay->r.x][BayerG] = CAND_CROSS;
+	sel[lay->r.y][lay->r.x][BayerR] = CAND_C;
+
+	sel[lay->b.y][lay->b.x][BayerB] = CAND_C;
+	sel[lay->b.y][lay->b.x][BayerG] = CAND_CROSS;
+	sel[lay->b.y][lay->b.x][BayerR] = CAND_DIAG;
+
+	sel[lay->g1.y][lay->g1.x][BayerB] = lay->g1b_w ? CAND_V2 : CAND_H2;
+	sel[lay->g1.y][lay->g1.x][BayerG] = CAND_GD;
+	sel[lay->g1.y][lay->g1.x][BayerR] = lay->g1r_w ? CAND_V2 : CAND_H2;
+
+	sel[lay->g2.y][lay->g2.x][BayerB] = lay->g2b_w ? CAND_V2 : CAND_H2;
+	sel[lay->g2.y][lay->g2.x][BayerG] = CAND_GD;
+	sel[lay->g2.y][lay->g2.x][BayerR] = lay->g2r_w ? CAND_V2 : CAND_H2;
+}
+
+static inline int demosaic_cand(const BYTE *p, int w, int cand)
+{
+	switch (cand) {
+	case CAND_C:
+		return p[0];
+	case CAND_H2:
+		return (p[-1] + p[1]) >> 1;
+	case CAND_V2:
+		return (p[-w] + p[w]) >> 1;
+	case CAND_CROSS:
+		return (p[-w] + p[1] + p[w] + p[-1]) >> 2;
+	case CAND_DIAG:
+		return (p[-w - 1] + p[-w + 1] + p[w - 1] + p[w + 1]) >> 2;
+	default:
+		return (p[0] + p[-w - 1]) >> 1;
+	}
+}
+
+static void demosaic_row_c(const BYTE *row, BYTE *dst, int x, int x_end, int w, const unsigned char sel[2][3])
+{
+	for (; x < x_end; x++) {
+		dst[3 * x + BayerB] = demosaic_cand(row + x, w, sel[x & 1][BayerB]);
+		dst[3 * x + BayerG] = demosaic_cand(row + x, w, sel[x & 1][BayerG]);
+		dst[3 * x + BayerR] = demosaic_cand(row + x, w, sel[x & 1][BayerR]);
+	}
+}
+
+typedef int (*demosaic_row_fn)(const BYTE *row, BYTE *dst, int x, int x_end, int w, const unsigned char sel[2][3]);
+
+/* border from the reference, interior rows from row_fn, padding cleared */
+static void demosaic_simd(int pattern, const BYTE *raw, BYTE *bmp24, int w, int h, demosaic_row_fn row_fn)
+{
+	PLContext ctx = { pattern, w, h };
+	unsigned char sel[2][2][3];
+	const int stride = PK_BMP24_STRIDE(w);
+	int x, y;
+
+	demosaic_plan(pattern, sel);
+	for (y = 0; y < h; y++)
+		memset(bmp24 + y * stride + 3 * w, 0, stride - 3 * w);
+	BorderInterpolate(&ctx, raw, bmp24, w, h, 2);
+
+	for (y = 2; y < h - 2; y++) {
+		x = row_fn(raw + y * w, bmp24 + y * stride, 2, w - 2, w, sel[y & 1]);
+		demosaic_row_c(raw + y * w, bmp24 + y * stride, x, w - 2, w, sel[y & 1]);
+	}
+}
+
+/* ------------------------------------------------------------------------
+ * x86
+ * ---------------------------------------------------------------------- */
+#ifdef PK_X86
+
+/* pshufb masks interleaving 16 b, g and r bytes into 48 bytes */
+static unsigned char bgr_masks[3][3][16];
+
+static void bgr_masks_init(void)
+{
+	int t, i, ch, j;
+
+	for (t = 0; t < 3; t++) {
+		for (i = 0; i < 16; i++) {
+			j = 16 * t + i;
+			for (ch = 0; ch < 3; ch++)
+				bgr_masks[t][ch][i] = (j % 3 == ch) ? j / 3 : 0x80;
+		}
+	}
+}
+
+PK_TARGET_SSE41
+static inline __m128i sse_avg2(__m128i a, __m128i b)
+{
+	/* pavgb rounds up, take the carry back off */
+	return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+}
+
+PK_TARGET_SSE41
+static inline __m128i sse_avg4(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i lo, hi;
+
+	lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+	                   _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+	hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+	                   _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+	return _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2));
+}
+
+PK_TARGET_SSE41
+static inline void sse_store_bgr(BYTE *dst, __m128i b, __m128i g, __m128i r)
+{
+	const __m128i (*m)[3] = (const __m128i (*)[3])bgr_masks;
+	int t;
+
+	for (t = 0; t < 3; t++) {
+		_mm_storeu_si128((__m128i *)(dst + 16 * t),
+		                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, _mm_loadu_si128(&m[t][0])),
+		                                           _mm_shuffle_epi8(g, _mm_loadu_si128(&m[t][1]))),
+		                              _mm_shuffle_epi8(r, _mm_loadu_si128(&m[t][2]))));
+	}
+}
+
+#define LOAD128(p)				_mm_loadu_si128((const __m128i *)(p))
+
+PK_TARGET_SSE41
+static int demosaic_row_sse41(const BYTE *row, BYTE *dst, int x, int x_end, int w, const unsigned char sel[2][3])
+{
+	const __m128i odd = _mm_set1_epi16((short)0xff00);
+	__m128i cand[CAND_NUM], ch[3];
+	const BYTE *p;
+	int c;
+
+	for (; x + 16 <= x_end; x += 16) {
+		p = row + x;
+		cand[CAND_C] = LOAD128(p);
+		cand[CAND_H2] = sse_avg2(LOAD128(p - 1), LOAD128(p + 1));
+		cand[CAND_V2] = sse_avg2(LOAD128(p - w), LOAD128(p + w));
+		cand[CAND_CROSS] = sse_avg4(LOAD128(p - w), LOAD128(p + 1), LOAD128(p + w), LOAD128(p - 1));
+		cand[CAND_DIAG] = sse_avg4(LOAD128(p - w - 1), LOAD128(p - w + 1), LOAD128(p + w - 1), LOAD128(p + w + 1));
+		cand[CAND_GD] = sse_avg2(cand[CAND_C], LOAD128(p - w - 1));
+
+		for (c = 0; c < 3; c++)
+			ch[c] = _mm_blendv_epi8(cand[sel[0][c]], cand[sel[1][c]], odd);
+		sse_store_bgr(dst + 3 * x, ch[BayerB], ch[BayerG], ch[BayerR]);
+	}
+
+	return x;
+}
+
+PK_TARGET_AVX2
+static inline __m256i avx2_avg2(__m256i a, __m256i b)
+{
+	return _mm256_sub_epi8(_mm256_avg_epu8(a, b), _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi8(1)));
+}
+
+PK_TARGET_AVX2
+static inline __m256i avx2_avg4(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i lo, hi;
+
+	/* unpack and pack both stay in their 128 bit lane, so the order holds */
+	lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)),
+	                      _mm256_add_epi16(_mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(d, zero)));
+	hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)),
+	                      _mm256_add_epi16(_mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(d, zero)));
+	return _mm256_packus_epi16(_mm256_srli_epi16(lo, 2), _mm256_srli_epi16(hi, 2));
+}
+
+#define LOAD256(p)				_mm256_loadu_si256((const __m256i *)(p))
+
+PK_TARGET_AVX2
+static int demosaic_row_avx2(const BYTE *row, BYTE *dst, int x, int x_end, int w, const unsigned char sel[2][3])
+{
+	const __m256i odd = _mm256_set1_epi16((short)0xff00);
+	const __m128i (*m)[3] = (const __m128i (*)[3])bgr_masks;
+	__m256i cand[CAND_NUM], ch[3];
+	__m128i b, g, r;
+	const BYTE *p;
+	int c, half, t;
+
+	for (; x + 32 <= x_end; x += 32) {
+		p = row + x;
+		cand[CAND_C] = LOAD256(p);
+		cand[CAND_H2] = avx2_avg2(LOAD256(p - 1), LOAD256(p + 1));
+		cand[CAND_V2] = avx2_avg2(LOAD256(p - w), LOAD256(p + w));
+		cand[CAND_CROSS] = avx2_avg4(LOAD256(p - w), LOAD256(p + 1), LOAD256(p + w), LOAD256(p - 1));
+		cand[CAND_DIAG] = avx2_avg4(LOAD256(p - w - 1), LOAD256(p - w + 1), LOAD256(p + w - 1), LOAD256(p + w + 1));
+		cand[CAND_GD] = avx2_avg2(cand[CAND_C], LOAD256(p - w - 1));
+
+		for (c = 0; c < 3; c++)
+			ch[c] = _mm256_blendv_epi8(cand[sel[0][c]], cand[sel[1][c]], odd);
+
+		for (half = 0; half < 2; half++) {
+			b = half ? _mm256_extracti128_si256(ch[BayerB], 1) : _mm256_castsi256_si128(ch[BayerB]);
+			g = half ? _mm256_extracti128_si256(ch[BayerG], 1) : _mm256_castsi256_si128(ch[BayerG]);
+			r = half ? _mm256_extracti128_si256(ch[BayerR], 1) : _mm256_castsi256_si128(ch[BayerR]);
+			for (t = 0; t < 3; t++) {
+				_mm_storeu_si128((__m128i *)(dst + 3 * x + 48 * half + 16 * t),
+				                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, _mm_loadu_si128(&m[t][0])),
+				                                           _mm_shuffle_epi8(g, _mm_loadu_si128(&m[t][1]))),
+				                              _mm_shuffle_epi8(r, _mm_loadu_si128(&m[t][2]))));
+			}
+		}
+	}
+
+	return demosaic_row_sse41(row, dst, x, x_end, w, sel);
+}
+
+PK_TARGET_SSE41
+static int raw16_to_raw8_sse41(const BYTE *src, BYTE *dst, int bit, int n)
+{
+	const __m128i shift = _mm_cvtsi32_si128(bit - 8);
+	const __m128i mask = _mm_set1_epi16(0xff);
+	__m128i a, b;
+	int i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		a = _mm_and_si128(_mm_srl_epi16(LOAD128(src + 2 * i), shift), mask);
+		b = _mm_and_si128(_mm_srl_epi16(LOAD128(src + 2 * i + 16), shift), mask);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(a, b));
+	}
+
+	return i;
+}
+
+PK_TARGET_AVX2
+static int raw16_to_raw8_avx2(const BYTE *src, BYTE *dst, int bit, int n)
+{
+	const __m128i shift = _mm_cvtsi32_si128(bit - 8);
+	const __m256i mask = _mm256_set1_epi16(0xff);
+	__m256i a, b;
+	int i;
+
+	for (i = 0; i + 32 <= n; i += 32) {
+		a = _mm256_and_si256(_mm256_srl_epi16(LOAD256(src + 2 * i), shift), mask);
+		b = _mm256_and_si256(_mm256_srl_epi16(LOAD256(src + 2 * i + 32), shift), mask);
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8));
+	}
+
+	return i + raw16_to_raw8_sse41(src + 2 * i, dst + i, bit, n - i);
+}
+
+/* 16 bytes are loaded per 8 pixels (10 bytes) */
+PK_TARGET_SSE41
+static int raw10_to_raw16_sse41(const BYTE *src, unsigned short *dst, int w)
+{
+	const __m128i msb_idx = _mm_setr_epi8(0, -1, 1, -1, 2, -1, 3, -1, 5, -1, 6, -1, 7, -1, 8, -1);
+	const __m128i lsb_idx = _mm_setr_epi8(4, -1, 4, -1, 4, -1, 4, -1, 9, -1, 9, -1, 9, -1, 9, -1);
+	const __m128i lsb_mul = _mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1);
+	const __m128i three = _mm_set1_epi16(3);
+	const int bytes = w / 4 * 5;
+	__m128i in, msb, lsb;
+	int x;
+
+	for (x = 0; x + 8 <= w && x / 4 * 5 + 16 <= bytes; x += 8) {
+		in = LOAD128(src + x / 4 * 5);
+		msb = _mm_slli_epi16(_mm_shuffle_epi8(in, msb_idx), 2);
+		lsb = _mm_shuffle_epi8(in, lsb_idx);
+		lsb = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(lsb, lsb_mul), 6), three);
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(msb, lsb));
+	}
+
+	return x;
+}
+
+PK_TARGET_SSE41
+static int raw10_to_raw8_sse41(const BYTE *src, BYTE *dst, int w)
+{
+	const __m128i idx_a = _mm_setr_epi8(0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1);
+	const __m128i idx_b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, 14);
+	const BYTE *p;
+	int x;
+
+	for (x = 0; x + 16 <= w; x += 16) {
+		p = src + x / 4 * 5;
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_shuffle_epi8(LOAD128(p), idx_a),
+		                                                    _mm_shuffle_epi8(LOAD128(p + 4), idx_b)));
+	}
+
+	return x;
+}
+
+/* 8 pixels of y/u/v (16 bit, u and v already centred) to b,g,r 16 bit */
+PK_TARGET_SSE41
+static inline void sse_yuv_to_bgr16(__m128i y, __m128i u, __m128i v, __m128i *b, __m128i *g, __m128i *r)
+{
+	__m128i yy = _mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), _mm_set1_epi16(74));
+
+	*b = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(u, _mm_set1_epi16(129))), 6);
+	*g = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(yy, _mm_mullo_epi16(u, _mm_set1_epi16(25))),
+	                                  _mm_mullo_epi16(v, _mm_set1_epi16(52))), 6);
+	*r = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(v, _mm_set1_epi16(102))), 6);
+}
+
+PK_TARGET_SSE41
+static inline void sse_store_bgra(BYTE *dst, __m128i b, __m128i g, __m128i r)
+{
+	const __m128i a = _mm_set1_epi8((char)0xff);
+	__m128i bg, ra;
+
+	bg = _mm_unpacklo_epi8(b, g);
+	ra = _mm_unpacklo_epi8(r, a);
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(bg, ra));
+	_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(bg, ra));
+	bg = _mm_unpackhi_epi8(b, g);
+	ra = _mm_unpackhi_epi8(r, a);
+	_mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(bg, ra));
+	_mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(bg, ra));
+}
+
+PK_TARGET_SSE41
+static int nv12_row_sse41(const BYTE *y, const BYTE *uv, BYTE *dst, int w, int swap_uv)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i low = _mm_set1_epi16(0xff);
+	const __m128i bias = _mm_set1_epi16(128);
+	__m128i yv, uvv, u, v, b0, g0, r0, b1, g1, r1;
+	int x;
+
+	for (x = 0; x + 16 <= w; x += 16) {
+		yv = LOAD128(y + x);
+		uvv = LOAD128(uv + x);
+		u = _mm_sub_epi16(_mm_and_si128(uvv, low), bias);
+		v = _mm_sub_epi16(_mm_srli_epi16(uvv, 8), bias);
+		if (swap_uv) {
+			__m128i t = u;
+			u = v;
+			v = t;
+		}
+
+		sse_yuv_to_bgr16(_mm_unpacklo_epi8(yv, zero), _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v), &b0, &g0, &r0);
+		sse_yuv_to_bgr16(_mm_unpackhi_epi8(yv, zero), _mm_unpackhi_epi16(u, u), _mm_unpackhi_epi16(v, v), &b1, &g1, &r1);
+		sse_store_bgra(dst + 4 * x, _mm_packus_epi16(b0, b1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(r0, r1));
+	}
+
+	return x;
+}
+
+PK_TARGET_SSE41
+static int yuv422i_row_sse41(const BYTE *src, BYTE *dst, int w, int order)
+{
+	const int *o = yuv422_order[order];
+	const __m128i bias = _mm_set1_epi16(128);
+	__m128i y_idx, u_idx, v_idx, in, b[2], g[2], r[2];
+	int x, k;
+
+	y_idx = _mm_setr_epi8(o[0], -1, o[2], -1, o[0] + 4, -1, o[2] + 4, -1,
+	                      o[0] + 8, -1, o[2] + 8, -1, o[0] + 12, -1, o[2] + 12, -1);
+	u_idx = _mm_setr_epi8(o[1], -1, o[1], -1, o[1] + 4, -1, o[1] + 4, -1,
+	                      o[1] + 8, -1, o[1] + 8, -1, o[1] + 12, -1, o[1] + 12, -1);
+	v_idx = _mm_setr_epi8(o[3], -1, o[3], -1, o[3] + 4, -1, o[3] + 4, -1,
+	                      o[3] + 8, -1, o[3] + 8, -1, o[3] + 12, -1, o[3] + 12, -1);
+
+	for (x = 0; x + 16 <= w; x += 16) {
+		for (k = 0; k < 2; k++) {
+			in = LOAD128(src + 2 * x + 16 * k);
+			sse_yuv_to_bgr16(_mm_shuffle_epi8(in, y_idx),
+			                 _mm_sub_epi16(_mm_shuffle_epi8(in, u_idx), bias),
+			                 _mm_sub_epi16(_mm_shuffle_epi8(in, v_idx), bias), &b[k], &g[k], &r[k]);
+		}
+		sse_store_bgra(dst + 4 * x, _mm_packus_epi16(b[0], b[1]), _mm_packus_epi16(g[0], g[1]),
+		               _mm_packus_epi16(r[0], r[1]));
+	}
+
+	return x;
+}
+
+#endif /* PK_X86 */
+
+/* ------------------------------------------------------------------------
+ * neon
+ * ---------------------------------------------------------------------- */
+#ifdef PK_NEON
+
+static inline uint8x16_t neon_avg4(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d)
+{
+	uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(a), vget_low_u8(b)), vaddl_u8(vget_low_u8(c), vget_low_u8(d)));
+	uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(a), vget_high_u8(b)), vaddl_u8(vget_high_u8(c), vget_high_u8(d)));
+
+	return vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2));
+}
+
+static int demosaic_row_neon(const BYTE *row, BYTE *dst, int x, int x_end, int w, const unsigned char sel[2][3])
+{
+	const uint8x16_t odd = vreinterpretq_u8_u16(vdupq_n_u16(0xff00));
+	uint8x16_t cand[CAND_NUM];
+	uint8x16x3_t out;
+	const BYTE *p;
+	int c;
+
+	for (; x + 16 <= x_end; x += 16) {
+		p = row + x;
+		cand[CAND_C] = vld1q_u8(p);
+		cand[CAND_H2] = vhaddq_u8(vld1q_u8(p - 1), vld1q_u8(p + 1));
+		cand[CAND_V2] = vhaddq_u8(vld1q_u8(p - w), vld1q_u8(p + w));
+		cand[CAND_CROSS] = neon_avg4(vld1q_u8(p - w), vld1q_u8(p + 1), vld1q_u8(p + w), vld1q_u8(p - 1));
+		cand[CAND_DIAG] = neon_avg4(vld1q_u8(p - w - 1), vld1q_u8(p - w + 1), vld1q_u8(p + w - 1), vld1q_u8(p + w + 1));
+		cand[CAND_GD] = vhaddq_u8(cand[CAND_C], vld1q_u8(p - w - 1));
+
+		for (c = 0; c < 3; c++)
+			out.val[c] = vbslq_u8(odd, cand[sel[1][c]], cand[sel[0][c]]);
+		vst3q_u8(dst + 3 * x, out);
+	}
+
+	return x;
+}
+
+static int raw16_to_raw8_neon(const BYTE *src, BYTE *dst, int bit, int n)
+{
+	const int16x8_t shift = vdupq_n_s16(-(bit - 8));
+	uint16x8_t a, b;
+	int i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		a = vshlq_u16(vld1q_u16((const uint16_t *)(src + 2 * i)), shift);
+		b = vshlq_u16(vld1q_u16((const uint16_t *)(src + 2 * i + 16)), shift);
+		vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+	}
+
+	return i;
+}
+
+/* 16 bytes are loaded per 8 pixels (10 bytes) */
+static int raw10_to_raw16_neon(const BYTE *src, unsigned short *dst, int w)
+{
+	static const uint8_t msb_idx[8] = { 0, 1, 2, 3, 5, 6, 7, 8 };
+	static const uint8_t lsb_idx[8] = { 4, 4, 4, 4, 9, 9, 9, 9 };
+	static const int16_t lsb_shift[8] = { 0, -2, -4, -6, 0, -2, -4, -6 };
+	const uint8x8_t mi = vld1_u8(msb_idx), li = vld1_u8(lsb_idx);
+	const int16x8_t ls = vld1q_s16(lsb_shift);
+	const int bytes = w / 4 * 5;
+	uint8x8x2_t tbl;
+	uint16x8_t msb, lsb;
+	const BYTE *p;
+	int x;
+
+	for (x = 0; x + 8 <= w && x / 4 * 5 + 16 <= bytes; x += 8) {
+		p = src + x / 4 * 5;
+		tbl.val[0] = vld1_u8(p);
+		tbl.val[1] = vld1_u8(p + 8);
+		msb = vshlq_n_u16(vmovl_u8(vtbl2_u8(tbl, mi)), 2);
+		lsb = vandq_u16(vshlq_u16(vmovl_u8(vtbl2_u8(tbl, li)), ls), vdupq_n_u16(3));
+		vst1q_u16(dst + x, vorrq_u16(msb, lsb));
+	}
+
+	return x;
+}
+
+static int raw10_to_raw8_neon(const BYTE *src, BYTE *dst, int w)
+{
+	static const uint8_t msb_idx[8] = { 0, 1, 2, 3, 5, 6, 7, 8 };
+	const uint8x8_t mi = vld1_u8(msb_idx);
+	const int bytes = w / 4 * 5;
+	uint8x8x2_t tbl;
+	const BYTE *p;
+	int x;
+
+	for (x = 0; x + 8 <= w && x / 4 * 5 + 16 <= bytes; x += 8) {
+		p = src + x / 4 * 5;
+		tbl.val[0] = vld1_u8(p);
+		tbl.val[1] = vld1_u8(p + 8);
+		vst1_u8(dst + x, vtbl2_u8(tbl, mi));
+	}
+
+	return x;
+}
+
+/* 8 pixels, u and v already centred */
+static inline void neon_yuv_to_bgr(uint8x8_t y, int16x8_t u, int16x8_t v, uint8x8_t *b, uint8x8_t *g, uint8x8_t *r)
+{
+	int16x8_t yy = vmulq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y)), vdupq_n_s16(16)), 74);
+
+	*b = vqshrun_n_s16(vqaddq_s16(yy, vmulq_n_s16(u, 129)), 6);
+	*g = vqshrun_n_s16(vsubq_s16(vsubq_s16(yy, vmulq_n_s16(u, 25)), vmulq_n_s16(v, 52)), 6);
+	*r = vqshrun_n_s16(vqaddq_s16(yy, vmulq_n_s16(v, 102)), 6);
+}
+
+static inline int16x8_t neon_centre(uint8x8_t c)
+{
+	return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c)), vdupq_n_s16(128));
+}
+
+static int nv12_row_neon(const BYTE *y, const BYTE *uv, BYTE *dst, int w, int swap_uv)
+{
+	uint8x8x2_t c, dup_u, dup_v;
+	uint8x8x4_t out;
+	int x;
+
+	out.val[3] = vdup_n_u8(0xff);
+	for (x = 0; x + 16 <= w; x += 16) {
+		c = vld2_u8(uv + x);		/* 8 u, 8 v */
+		dup_u = vzip_u8(c.val[swap_uv], c.val[swap_uv]);
+		dup_v = vzip_u8(c.val[1 - swap_uv], c.val[1 - swap_uv]);
+
+		neon_yuv_to_bgr(vld1_u8(y + x), neon_centre(dup_u.val[0]), neon_centre(dup_v.val[0]),
+		                &out.val[0], &out.val[1], &out.val[2]);
+		vst4_u8(dst + 4 * x, out);
+		neon_yuv_to_bgr(vld1_u8(y + x + 8), neon_centre(dup_u.val[1]), neon_centre(dup_v.val[1]),
+		                &out.val[0], &out.val[1], &out.val[2]);
+		vst4_u8(dst + 4 * x + 32, out);
+	}
+
+	return x;
+}
+
+static int yuv422i_row_neon(const BYTE *src, BYTE *dst, int w, int order)
+{
+	const int *o = yuv422_order[order];
+	uint8x8x4_t in, even, odd;
+	uint8x8x2_t z;
+	uint8x16x4_t out;
+	int16x8_t u, v;
+	int x, c;
+
+	for (x = 0; x + 16 <= w; x += 16) {
+		in = vld4_u8(src + 2 * x);		/* 8 groups of 4 bytes */
+		u = neon_centre(in.val[o[1]]);
+		v = neon_centre(in.val[o[3]]);
+		neon_yuv_to_bgr(in.val[o[0]], u, v, &even.val[0], &even.val[1], &even.val[2]);
+		neon_yuv_to_bgr(in.val[o[2]], u, v, &odd.val[0], &odd.val[1], &odd.val[2]);
+		for (c = 0; c < 3; c++) {
+			z = vzip_u8(even.val[c], odd.val[c]);
+			out.val[c] = vcombine_u8(z.val[0], z.val[1]);
+		}
+		out.val[3] = vdupq_n_u8(0xff);
+		vst4q_u8(dst + 4 * x, out);
+	}
+
+	return x;
+}
+
+#endif /* PK_NEON */
+
+/* ------------------------------------------------------------------------
+ * dispatch
+ * ---------------------------------------------------------------------- */
+
+int pk_isa_supported(int isa)
+{
+	switch (isa) {
+	case PK_ISA_SCALAR:
+		return 1;
+#ifdef PK_X86
+	case PK_ISA_SSE41:
+		return __builtin_cpu_supports("sse4.1");
+	case PK_ISA_AVX2:
+		return __builtin_cpu_supports("avx2");
+#endif
+#ifdef PK_NEON
+	case PK_ISA_NEON:
+		return 1;
+#endif
+	default:
+		return 0;
+	}
+}
+
+int pk_set_isa(int isa)
+{
+#ifdef PK_X86
+	static int masks_ready = 0;
+
+	if (!masks_ready) {
+		bgr_masks_init();
+		masks_ready = 1;
+	}
+#endif
+	while (isa > PK_ISA_SCALAR && !pk_isa_supported(isa))
+		isa--;
+	if (isa < PK_ISA_SCALAR)
+		isa = PK_ISA_SCALAR;
+
+	pk_isa = isa;
+	return isa;
+}
+
+int pk_get_isa(void)
+{
+	if (pk_isa < 0)
+		pk_set_isa(PK_ISA_NUM - 1);
+
+	return pk_isa;
+}
+
+const char *pk_isa_name(int isa)
+{
+	static const char *names[PK_ISA_NUM] = { "scalar", "sse4.1", "avx2", "neon" };
+
+	if (isa < 0 || isa >= PK_ISA_NUM)
+		return "?";
+
+	return names[isa];
+}
+
+void pk_raw16_to_raw8(const unsigned char *src, unsigned char *dst, int bit, int w, int h)
+{
+	int n = w * h, i = 0;
+
+	switch (pk_get_isa()) {
+#ifdef PK_X86
+	case PK_ISA_AVX2:
+		i = raw16_to_raw8_avx2(src, dst, bit, n);
+		break;
+	case PK_ISA_SSE41:
+		i = raw16_to_raw8_sse41(src, dst, bit, n);
+		break;
+#endif
+#ifdef PK_NEON
+	case PK_ISA_NEON:
+		i = raw16_to_raw8_neon(src, dst, bit, n);
+		break;
+#endif
+	default:
+		rawtoraw8(src, dst, bit, w, h);
+		return;
+	}
+
+	/* the tail, as one row of n - i pixels */
+	if (i < n)
+		rawtoraw8(src + 2 * i, dst + i, bit, n - i, 1);
+}
+
+void pk_raw10_to_raw16(const unsigned char *src, int stride, unsigned short *dst, int w, int h)
+{
+	int isa = pk_get_isa();
+	int x, y;
+
+	for (y = 0; y < h; y++, src += stride, dst += w) {
+		x = 0;
+#ifdef PK_X86
+		if (isa >= PK_ISA_SSE41)
+			x = raw10_to_raw16_sse41(src, dst, w);
+#endif
+#ifdef PK_NEON
+		if (isa == PK_ISA_NEON)
+			x = raw10_to_raw16_neon(src, dst, w);
+#endif
+		raw10_to_raw16_c(src, dst, x, w);
+	}
+}
+
+void pk_raw10_to_raw8(const unsigned char *src, int stride, unsigned char *dst, int w, int h)
+{
+	int isa = pk_get_isa();
+	int x, y;
+
+	for (y = 0; y < h; y++, src += stride, dst += w) {
+		x = 0;
+#ifdef PK_X86
+		if (isa >= PK_ISA_SSE41)
+			x = raw10_to_raw8_sse41(src, dst, w);
+#endif
+#ifdef PK_NEON
+		if (isa == PK_ISA_NEON)
+			x = raw10_to_raw8_neon(src, dst, w);
+#endif
+		raw10_to_raw8_c(src, dst, x, w);
+	}
+}
+
+int pk_demosaic_bilinear(int pattern, const unsigned char *raw, unsigned char *bmp24, int w, int h)
+{
+	PLContext ctx = { pattern, w, h };
+	demosaic_row_fn row_fn = NULL;
+
+	if (pattern < PK_BAYER_GBRG || pattern > PK_BAYER_GRBG)
+		return -1;
+
+	switch (pk_get_isa()) {
+#ifdef PK_X86
+	case PK_ISA_AVX2:
+		row_fn = demosaic_row_avx2;
+		break;
+	case PK_ISA_SSE41:
+		row_fn = demosaic_row_sse41;
+		break;
+#endif
+#ifdef PK_NEON
+	case PK_ISA_NEON:
+		row_fn = demosaic_row_neon;
+		break;
+#endif
+	default:
+		break;
+	}
+
+	/* tiny frames have no interior worth vectorizing */
+	if (row_fn == NULL || w < 8 || h < 5)
+		DemosaicBilinear(&ctx, raw, bmp24);
+	else
+		demosaic_simd(pattern, raw, bmp24, w, h, row_fn);
+
+	return 0;
+}
+
+void pk_nv12_to_bgra(const unsigned char *y, const unsigned char *uv, unsigned char *dst, int w, int h, int swap_uv)
+{
+	int isa = pk_get_isa();
+	int x, row;
+
+	swap_uv = swap_uv ? 1 : 0;
+	for (row = 0; row < h; row++) {
+		x = 0;
+#ifdef PK_X86
+		if (isa >= PK_ISA_SSE41)
+			x = nv12_row_sse41(y, uv, dst, w, swap_uv);
+#endif
+#ifdef PK_NEON
+		if (isa == PK_ISA_NEON)
+			x = nv12_row_neon(y, uv, dst, w, swap_uv);
+#endif
+		nv12_row_c(y, uv, dst, x, w, swap_uv);
+
+		y += w;
+		dst += 4 * w;
+		if (row & 1)
+			uv += w;
+	}
+}
+
+void pk_yuv422i_to_bgra(const unsigned char *src, unsigned char *dst, int w, int h, int order)
+{
+	int isa = pk_get_isa();
+	int x, row;
+
+	if (order < PK_YUYV || order > PK_UYVY)
+		order = PK_YUYV;
+
+	for (row = 0; row < h; row++) {
+		x = 0;
+#ifdef PK_X86
+		if (isa >= PK_ISA_SSE41)
+			x = yuv422i_row_sse41(src, dst, w, order);
+#endif
+#ifdef PK_NEON
+		if (isa == PK_ISA_NEON)
+			x = yuv422i_row_neon(src, dst, w, order);
+#endif
+		yuv422i_row_c(src, dst, x, w, order);
+
+		src += 2 * w;
+		dst += 4 * w;
+	}
+}
+
+/* display helpers, memory bound, the compiler does fine with these */
+void pk_bgr24_to_bgra(const unsigned char *src, int stride, unsigned char *dst, int w, int h)
+{
+	const BYTE *s;
+	int x, y;
+
+	for (y = 0; y < h; y++, src += stride) {
+		for (x = 0, s = src; x < w; x++, s += 3, dst += 4) {
+			dst[0] = s[0];
+			dst[1] = s[1];
+			dst[2] = s[2];
+			dst[3] = 0xff;
+		}
+	}
+}
+
+void pk_gray_to_bgra(const unsigned char *src, unsigned char *dst, int w, int h)
+{
+	int i, n = w * h;
+
+	for (i = 0; i < n; i++, dst += 4) {
+		dst[0] = src[i];
+		dst[1] = src[i];
+		dst[2] = src[i];
+		dst[3] = 0xff;
+	}
+}
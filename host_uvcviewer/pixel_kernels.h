@@ -0,0 +1,59 @@
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+/*
+ * pixel conversion kernels for the host viewer. every kernel has a scalar
+ * version that is the reference (demosaic and raw16 unpack are the
+ * viewer's original code) and sse4.1/avx2 or neon versions that give the
+ * same bytes. the best isa the cpu has is picked at first use.
+ */
+
+enum {
+	PK_ISA_SCALAR,
+	PK_ISA_SSE41,
+	PK_ISA_AVX2,
+	PK_ISA_NEON,
+	PK_ISA_NUM,
+};
+
+/* same values as the frame header bayeroder */
+enum {
+	PK_BAYER_GBRG = 0,
+	PK_BAYER_RGGB = 1,
+	PK_BAYER_BGGR = 2,
+	PK_BAYER_GRBG = 3,
+};
+
+/* 422 interleaved byte orders */
+enum {
+	PK_YUYV,
+	PK_YVYU,
+	PK_UYVY,
+};
+
+/* demosaic output rows are padded to 4 bytes, like a 24 bit dib */
+#define PK_BMP24_STRIDE(w)		((((w) * 24 + 31) & ~31) / 8)
+
+int pk_get_isa(void);
+int pk_set_isa(int isa);			/* returns the isa actually used */
+int pk_isa_supported(int isa);
+const char *pk_isa_name(int isa);
+
+/* w * h little endian 16 bit samples of 'bit' bits -> top 8 bits */
+void pk_raw16_to_raw8(const unsigned char *src, unsigned char *dst, int bit, int w, int h);
+
+/* mipi raw10, 4 pixels in 5 bytes, w a multiple of 4 */
+void pk_raw10_to_raw16(const unsigned char *src, int stride, unsigned short *dst, int w, int h);
+void pk_raw10_to_raw8(const unsigned char *src, int stride, unsigned char *dst, int w, int h);
+
+/* bilinear demosaic of an 8 bit bayer frame to PK_BMP24_STRIDE rows of b,g,r */
+int pk_demosaic_bilinear(int pattern, const unsigned char *raw, unsigned char *bmp24, int w, int h);
+
+/* bt.601 limited range to b,g,r,0xff (QImage::Format_RGB32), w even */
+void pk_nv12_to_bgra(const unsigned char *y, const unsigned char *uv, unsigned char *dst, int w, int h, int swap_uv);
+void pk_yuv422i_to_bgra(const unsigned char *src, unsigned char *dst, int w, int h, int order);
+
+void pk_bgr24_to_bgra(const unsigned char *src, int stride, unsigned char *dst, int w, int h);
+void pk_gray_to_bgra(const unsigned char *src, unsigned char *dst, int w, int h);
+
+#endif
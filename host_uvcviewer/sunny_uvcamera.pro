@@ -18,20 +18,24 @@ SOURCES += main.cpp\
     mv2_hostkit.cpp \
     maingui.cpp \
     cameraview.cpp \
+    capture_engine.cpp \
+    pixel_kernels.cpp \
 	
 HEADERS  += mv2_hostkit.h \
     maingui.h \
     cameraview.h \
 	mipi_tx_header.h \
 	video.h \
+	capture_engine.h \
+	pixel_kernels.h \
 
 Debug
 {
-    LIBS += -L/usr/local/lib/ -lopencv_core -lopencv_highgui -lopencv_imgproc
+    LIBS += -L/usr/local/lib/ -lopencv_core -lopencv_highgui -lopencv_imgproc -lpthread
 #    LIBS += -lusb-1.0
 }
 
 Release
 {
-    LIBS += -L/usr/local/lib/ -lopencv_core -lopencv_highgui -lopencv_imgproc
+    LIBS += -L/usr/local/lib/ -lopencv_core -lopencv_highgui -lopencv_imgproc -lpthread
 }
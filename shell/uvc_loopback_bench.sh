@@ -0,0 +1,62 @@
+#!/bin/bash
+# UVC gadget loopback benchmark on dummy_hcd, gadget and host on this machine.
+#
+# ezy_buf.ko and uvc_gadget.ko have to be built for the running kernel,
+# uvc_loopback_source and ezybuf_dmabuf_test with make -C sunny_lib/host
+# (no android needed) and loopback_bench (host_uvcviewer) for this machine.
+# Extra arguments go to uvc_loopback_source, e.g. -z or
+# -c "1280x720:8@30,1280x720:8@30".
+#
+# dummy_hcd does not do scatter-gather, the gadget sends copied payloads
+# here; the video_sg path is not covered by this benchmark.
+
+SECS=${SECS:-10}
+EZY_BUF_KO=${EZY_BUF_KO:-ezy_buf/ezy_buf.ko}
+UVC_GADGET_KO=${UVC_GADGET_KO:-gdt_uvcvideo/uvc_gadget.ko}
+SOURCE=${SOURCE:-sunny_lib/host/uvc_loopback_source}
+SOURCE_LOG=${SOURCE_LOG:-/tmp/uvc_loopback_source.log}
+DMABUF_TEST=${DMABUF_TEST:-sunny_lib/host/ezybuf_dmabuf_test}
+BENCH=${BENCH:-host_uvcviewer/loopback_bench}
+
+if [[ $EUID != 0 ]] ; then
+  echo This must be run as root!
+  exit 1
+fi
+
+cleanup() {
+  [ -n "$source_pid" ] && kill $source_pid 2>/dev/null && wait $source_pid
+  rmmod uvc_gadget 2>/dev/null
+  rmmod ezy_buf 2>/dev/null
+  rmmod dummy_hcd 2>/dev/null
+}
+trap cleanup EXIT
+
+modprobe dummy_hcd || exit 1
+insmod $EZY_BUF_KO || exit 1
+insmod $UVC_GADGET_KO || exit 1
+
+# dma-buf export and import of the gadget queue, before the source takes it
+$DMABUF_TEST || exit 1
+
+$SOURCE "$@" > $SOURCE_LOG 2>&1 &
+source_pid=$!
+
+# the host side enumerates through dummy_hcd's root hub
+video=
+for i in 1 2 3 4 5 6 7 8 9 10 ; do
+  sleep 1
+  for v in /sys/class/video4linux/video* ; do
+    if readlink -f $v/device | grep -q dummy_hcd ; then
+      video=/dev/$(basename $v)
+      break 2
+    fi
+  done
+done
+
+if [ -z "$video" ] ; then
+  echo no video device on dummy_hcd
+  exit 1
+fi
+
+echo Streaming $video for ${SECS}s...
+$BENCH -d $video -t $SECS
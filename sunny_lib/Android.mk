@@ -7,7 +7,13 @@ LOCAL_SRC_FILES:= \
 	sensors_interface.cpp \
 	uvc_ctrl.cpp \
 	uvc_stream.cpp \
+	ezy_dmabuf.cpp \
 	uvc_interface.cpp \
+	stereo_sync.cpp \
+	imu_ring.cpp \
+	imu_batch.cpp \
+	stream_config.cpp \
+	telemetry.cpp \
 	libsfifo/sfifo.cpp \
 	libmsg/msg_util.cpp \
 
@@ -39,10 +45,103 @@ LOCAL_SHARED_LIBRARIES:= \
 	libgui \
 	libcamera_client \
 
-LOCAL_CFLAGS := -fno-short-enums -DCOPY_IMAGE_BUFFER
+LOCAL_CFLAGS := -fno-short-enums
 LOCAL_CFLAGS += -DLINUX  -DMIPI_USE_CAMERIC -DHAL_MOCKUP -DCAM_ENGINE_DRAW_DOM_ONLY -D_FILE_OFFSET_BITS=64 -DHAS_STDINT_H
 LOCAL_CFLAGS += -DANDROID_JELLYBEAN
 LOCAL_MODULE := libsunny_sensor
 
 LOCAL_MODULE_TAGS:= optional
 include $(BUILD_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+	libsfifo/sfifo.cpp \
+	libsfifo/sfifo_bench.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+	libutils \
+	libcutils \
+	liblog \
+
+LOCAL_MODULE := sfifo_bench
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+	imu_batch.cpp \
+	imu_batch_bench.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+	libutils \
+	libcutils \
+	liblog \
+
+LOCAL_MODULE := imu_batch_bench
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
+
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+	telemetry.cpp \
+	telemetry_reader.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+	libutils \
+	libcutils \
+	liblog \
+
+LOCAL_MODULE := sunny_telemetry
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+	ezy_dmabuf.cpp \
+	ezybuf_dmabuf_test.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+	libutils \
+	libcutils \
+	liblog \
+
+LOCAL_MODULE := ezybuf_dmabuf_test
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+	uvc_loopback_source.cpp \
+	camera_synth.cpp \
+	uvc_ctrl.cpp \
+	uvc_stream.cpp \
+	ezy_dmabuf.cpp \
+	uvc_interface.cpp \
+	stereo_sync.cpp \
+	imu_batch.cpp \
+	stream_config.cpp \
+	telemetry.cpp \
+	libsfifo/sfifo.cpp \
+	libmsg/msg_util.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+	libutils \
+	libcutils \
+	liblog \
+
+LOCAL_CFLAGS := -fno-short-enums
+
+LOCAL_MODULE := uvc_loopback_source
+
+LOCAL_MODULE_TAGS:= optional
+include $(BUILD_EXECUTABLE)
@@ -33,105 +33,38 @@
 #include "imu_mpu6500.h"
 #include "uvc_stream.h"
 #include "libsfifo/sfifo.h"
+#include "stream_config.h"
+#include "telemetry.h"
 #include "log_tag.h"
 
 using namespace android;
 
-sp<Camera> camera;
-sp<Camera> camera0;
-sp<Camera> camera1;
-
-CameraParameters params0;
-CameraParameters params1;
-static int ret0 = -1, ret1 = -1;
+static sp<Camera> cameras[STREAM_CAMERA_MAX];
+static CameraParameters cam_params[STREAM_CAMERA_MAX];
+static BOOL cam_opened[STREAM_CAMERA_MAX];
 static const String16 processName("sunny_test");
 extern int VS_GetVideomode(void);
 
-enum {
-	CAMERA_A,
-	CAMERA_B,
-	CAMERA_C,
-	CAMERA_D,
-};
-
-enum {
-	YUV_8 = 8,
-	RAW_10 = 10,
-	RAW_12 = 12,
-	RAW_16 = 16,
-};
-
-enum {
-	BAYER_DEF = 0,
-	BAYER_GBRG = 0,
-	BAYER_RGGB = 1,
-	BAYER_BGGR = 2,
-	BAYER_GRBG = 3,
-	YUV422 = 4,
-	YUV420_I420 = 5,
-	MONO_8BIT = 6,
-	YV12 = 7,
-	NV12 = 8,
-};
-
-static void stopPreview0();
-static void stopPreview1();
-
-struct sfifo_des_s *rvideo_sfifo_handle;
-struct sfifo_des_s *lvideo_sfifo_handle;
+/* one camera callback thread feeds each sfifo, video_stream_thread drains them all */
+struct sfifo_des_s *video_sfifo_handle[STREAM_CAMERA_MAX];
 
-void CameraHandler::notify(int32_t msgType, int32_t ext1, int32_t ext2)
+/*
+ * the preview is one line taller than the image, the HAL keeps the frame
+ * timestamp in the tail. for NV12 that line sits between the Y and UV plane.
+ */
+static void frame_copy(const struct stream_camera_s *cam, unsigned char *dst, const unsigned char *src)
 {
-	int32_t tmpext1, tmpext2, tmpmsgType;
-	tmpext1 = ext1;
-	tmpext2 = ext2;
-	tmpmsgType = msgType;
-}
+	unsigned int y_size = cam->width * cam->height;
 
-void CameraHandler::postData(int32_t msgType, const sp<IMemory>& dataPtr, camera_frame_metadata_t *metadata)
-{
-	camera_frame_metadata_t* tmp = metadata;
-	int32_t tmpmsgType = msgType;
-	static int framecount = 0;
-	struct timeval *tm0 = NULL;
-
-	struct sfifo_s *sfifo;
-
-	S_MetaData   MetaData_CamA = {
-		0, 0, 0, 0,
-		CAMERA_A,
-		IMAGE_WIDTH,
-		IMAGE_HEIGHT,
-		YUV_8,
-		NV12,
-		0,
-		0,
-		0,
-		HEAD_LEN,
-	};
-
-	tm0 = (struct timeval*)((unsigned char *)dataPtr->pointer() + dataPtr->size() - 16);
-	MetaData_CamA.tv_sec = tm0->tv_sec;
-	MetaData_CamA.tv_usec = tm0->tv_usec;
-	MetaData_CamA.frameCount = framecount;
-	sfifo = sfifo_get_free_buf(lvideo_sfifo_handle);
-	if (sfifo != NULL) {
-		memcpy(sfifo->buffer, &MetaData_CamA, HEAD_LEN);
-		memcpy(sfifo->buffer + HEAD_LEN, (unsigned char *)dataPtr->pointer(), 640 * 480);
-		memcpy(sfifo->buffer + HEAD_LEN + 640 * 480, (unsigned char *)dataPtr->pointer() + 640 * 481, 640 * 480 / 2);
-		sfifo_put_active_buf(sfifo, lvideo_sfifo_handle);
-		framecount++;
+	if (cam->format == NV12) {
+		memcpy(dst, src, y_size);
+		memcpy(dst + y_size, src + cam->width * (cam->height + 1), y_size / 2);
+	} else {
+		memcpy(dst, src, stream_frame_size(cam));
 	}
 }
 
-void CameraHandler::postDataTimestamp(nsecs_t timestamp, int32_t msgType, const sp<IMemory>& dataPtr)
-{
-	uint8_t *ptr = (uint8_t*) dataPtr->pointer();
-	nsecs_t tmptimestamp = timestamp;
-	int32_t tmpmsgType = msgType;
-}
-
-void CameraHandler1::notify(int32_t msgType, int32_t ext1, int32_t ext2)
+void CameraHandler::notify(int32_t msgType, int32_t ext1, int32_t ext2)
 {
 	int32_t tmpext1, tmpext2, tmpmsgType;
 	tmpext1 = ext1;
@@ -139,193 +72,149 @@ void CameraHandler1::notify(int32_t msgType, int32_t ext1, int32_t ext2)
 	tmpmsgType = msgType;
 }
 
-void CameraHandler1::postData(int32_t msgType, const sp<IMemory>& dataPtr, camera_frame_metadata_t *metadata)
+void CameraHandler::postData(int32_t msgType, const sp<IMemory>& dataPtr, camera_frame_metadata_t *metadata)
 {
 	camera_frame_metadata_t* tmp = metadata;
 	int32_t tmpmsgType = msgType;
+	const struct stream_camera_s *cam = &stream_config_get()->cam[mIndex];
+	struct sfifo_des_s *sfifo_des_p = video_sfifo_handle[mIndex];
+	struct timeval *tm = NULL;
 	struct sfifo_s *sfifo;
-	static int framecount = 0;
-	struct timeval *tm1 = NULL;
-	S_MetaData   MetaData_CamB = {
-		0, 0, 0, 0,
-		CAMERA_C,
-		IMAGE_WIDTH,
-		IMAGE_HEIGHT,
-		YUV_8,
-		NV12,
-		0,
-		0,
-		0,
-		HEAD_LEN,
-	};
-
-	tm1 = (struct timeval*)((unsigned char *)dataPtr->pointer() + dataPtr->size() - 16);
-	sfifo = sfifo_get_free_buf(rvideo_sfifo_handle);
+	S_MetaData MetaData;
+	long long t_cb;
+
+	t_cb = telemetry_frame_begin(mIndex);
+	stream_meta_init(cam, &MetaData);
+	tm = (struct timeval*)((unsigned char *)dataPtr->pointer() + dataPtr->size() - 16);
+	MetaData.tv_sec = tm->tv_sec;
+	MetaData.tv_usec = tm->tv_usec;
+	MetaData.frameCount = mFrameCount;
+
+	sfifo = uvcstream_get_free_sfifo();
+	if (sfifo == NULL)
+		sfifo = sfifo_get_free_buf(sfifo_des_p);
 	if (sfifo != NULL) {
-		MetaData_CamB.tv_sec = tm1->tv_sec;
-		MetaData_CamB.tv_usec = tm1->tv_usec;
-		MetaData_CamB.frameCount = framecount;
-		memcpy(sfifo->buffer, &MetaData_CamB, HEAD_LEN);
-		memcpy(sfifo->buffer + HEAD_LEN, (unsigned char *)dataPtr->pointer(), 640 * 480);
-		memcpy(sfifo->buffer + HEAD_LEN + 640 * 480, (unsigned char *)dataPtr->pointer() + 640 * 481, 640 * 480 / 2);
-		sfifo_put_active_buf(sfifo, rvideo_sfifo_handle);
-		framecount++;
+		telemetry_frame_start(sfifo, t_cb);
+		memcpy(sfifo->buffer, &MetaData, HEAD_LEN);
+		frame_copy(cam, sfifo->buffer + HEAD_LEN, (unsigned char *)dataPtr->pointer());
+		telemetry_stamp(sfifo, TELEM_SFIFO_ENQ);
+		if (sfifo_put_active_buf(sfifo, sfifo_des_p) < 0) {
+			uvcstream_release_sfifo(sfifo, mIndex);
+			telemetry_drop(TELEM_CAM_CB);
+			return;
+		}
+		mFrameCount++;
+	} else {
+		telemetry_drop(TELEM_CAM_CB);
 	}
 }
 
-void CameraHandler1::postDataTimestamp(nsecs_t timestamp, int32_t msgType, const sp<IMemory>& dataPtr)
+void CameraHandler::postDataTimestamp(nsecs_t timestamp, int32_t msgType, const sp<IMemory>& dataPtr)
 {
 	uint8_t *ptr = (uint8_t*) dataPtr->pointer();
 	nsecs_t tmptimestamp = timestamp;
 	int32_t tmpmsgType = msgType;
 }
 
-static int openCamera0()
+static int openCamera(int index)
 {
-	ALOGD("%s ,%d \n", __func__, __LINE__);
-	camera0 = Camera::connect(0, processName, Camera::USE_CALLING_UID);
+	int id = stream_config_get()->cam[index].id;
 
-	if (NULL == camera0.get()) {
-		ALOGD("Unable to connect to Camera0Service\n");
-		ALOGD("Retrying... \n");
-		sleep(1);
-		camera0 = Camera::connect(0, processName, Camera::USE_CALLING_UID);
+	ALOGD("%s ,%d camera%d\n", __func__, __LINE__, id);
+	cameras[index] = Camera::connect(id, processName, Camera::USE_CALLING_UID);
 
-		if (NULL == camera0.get()) {
-			ALOGD("connect to Camera0 Giving up!! \n");
-			return -1;
-		}
-	}
-
-	params0 = camera0->getParameters();
-	camera0->setParameters(params0.flatten());
-	camera0->setListener(new CameraHandler());
-	camera0->setPreviewCallbackFlags(CAMERA_FRAME_CALLBACK_FLAG_ENABLE_MASK);
-
-	return 0;
-}
-
-static int openCamera1()
-{
-	ALOGD("%s ,%d \n", __func__, __LINE__);
-	camera1 = Camera::connect(1, processName, Camera::USE_CALLING_UID);
-	if (NULL == camera1.get()) {
-		ALOGD("Unable to connect to Camera1Service\n");
+	if (NULL == cameras[index].get()) {
+		ALOGD("Unable to connect to Camera%dService\n", id);
 		ALOGD("Retrying... \n");
-
 		sleep(1);
-		camera1 = Camera::connect(1, processName, Camera::USE_CALLING_UID);
+		cameras[index] = Camera::connect(id, processName, Camera::USE_CALLING_UID);
 
-		if (NULL == camera1.get()) {
-			ALOGD("connect to Camera1 Giving up!! \n");
+		if (NULL == cameras[index].get()) {
+			ALOGD("connect to Camera%d Giving up!! \n", id);
 			return -1;
 		}
 	}
 
-	params1 = camera1->getParameters();
-	camera1->setParameters(params1.flatten());
-	camera1->setListener(new CameraHandler1());
-	camera1->setPreviewCallbackFlags(CAMERA_FRAME_CALLBACK_FLAG_ENABLE_MASK);
+	cam_params[index] = cameras[index]->getParameters();
+	cameras[index]->setParameters(cam_params[index].flatten());
+	cameras[index]->setListener(new CameraHandler(index));
+	cameras[index]->setPreviewCallbackFlags(CAMERA_FRAME_CALLBACK_FLAG_ENABLE_MASK);
 
 	return 0;
 }
 
-static int closeCamera0()
+static int closeCamera(int index)
 {
-	if (NULL == camera0.get()) {
-		ALOGD("invalid camera0 reference\n");
+	if (NULL == cameras[index].get()) {
+		ALOGD("invalid camera%d reference\n", index);
 		return -1;
 	}
 
-	camera0->disconnect();
-	camera0.clear();
+	cameras[index]->disconnect();
+	cameras[index].clear();
 	return 0;
 }
 
-static int closeCamera1()
+static int startPreview(int index)
 {
-	if (NULL == camera1.get()) {
-		ALOGD("invalid camera1 reference\n");
-		return -1;
-	}
+	const struct stream_camera_s *cam = &stream_config_get()->cam[index];
 
-	camera1->disconnect();
-	camera1.clear();
-	return 0;
-}
+	cam_params[index].setPreviewSize(cam->width, cam->height + 1);
+	cam_params[index].setPreviewFrameRate(cam->fps);
+	cameras[index]->setParameters(cam_params[index].flatten());
 
-static int startPreview0()
-{
-	params0.setPreviewSize(640, 481);
-	camera0->setParameters(params0.flatten());
-
-	camera0->startPreview();
+	cameras[index]->startPreview();
 	return 0;
 }
 
-static int startPreview1()
+static void stopPreview(int index)
 {
-	params1.setPreviewSize(640, 481);
-	camera1->setParameters(params1.flatten());
-	camera1->startPreview();
-	return 0;
+	cameras[index]->stopPreview();
+	closeCamera(index);
 }
 
-static void stopPreview0()
+static void camera_close_all(void)
 {
-	camera0->stopPreview();
-	closeCamera0();
-}
+	int i;
 
-static void stopPreview1()
-{
-	camera1->stopPreview();
-	closeCamera1();
+	for (i = 0; i < STREAM_CAMERA_MAX; i++) {
+		if (cam_opened[i]) {
+			closeCamera(i);
+			cam_opened[i] = FALSE;
+		}
+	}
 }
 
 int camera_init(void)
 {
+	const struct stream_config_s *cfg = stream_config_get();
+	int i;
+
 	sp<ProcessState> proc(ProcessState::self());
 	ProcessState::self()->startThreadPool();
 
-	rvideo_sfifo_handle = sfifo_init(3, (640 * 480 * 3 / 2 + HEAD_LEN), 5);
-	lvideo_sfifo_handle = sfifo_init(3, (640 * 480 * 3 / 2 + HEAD_LEN), 5);
-	ret0 = openCamera0();
-	if (ret0 < 0) {
-		ALOGD("Camera0 initialization failed\n");
-		return -1;
-	}
-	
-	ret1 = openCamera1();
-	if (ret1 < 0) {
-		ALOGD("Camera1 initialization failed\n");
-		if (ret0 == 0) {
-			closeCamera0();
+	for (i = 0; i < cfg->num; i++) {
+		video_sfifo_handle[i] = sfifo_ring_init(cfg->sfifo_bufs, stream_slot_size(&cfg->cam[i]),
+							 cfg->sfifo_bufs + cfg->gadget_bufs);
+		if (video_sfifo_handle[i] == NULL) {
+			ALOGD("Camera%d sfifo init failed\n", i);
+			return -1;
 		}
-		return -1;
 	}
 
-
-	if (ret0 == 0) {
-		if (startPreview0() < 0) {
-			ALOGD("Error while starting preview\n");
-			if (ret1 == 0) {
-				closeCamera1();
-			}
+	for (i = 0; i < cfg->num; i++) {
+		if (openCamera(i) < 0) {
+			ALOGD("Camera%d initialization failed\n", i);
+			camera_close_all();
 			return -1;
 		}
+		cam_opened[i] = TRUE;
 	}
 
-	if (ret1 == 0) {
-		if (startPreview1() < 0) {
-			ALOGD("Error while starting2 preview\n");
-			if (ret0 == 0) {
-				closeCamera0();
-			}
-
-			if (ret1 == 0) {
-				closeCamera1();
-			}
+	for (i = 0; i < cfg->num; i++) {
+		if (startPreview(i) < 0) {
+			ALOGD("Error while starting preview%d\n", i);
+			camera_close_all();
 			return -1;
 		}
 	}
@@ -334,12 +223,14 @@ int camera_init(void)
 
 void camera_uninit(void)
 {
+	int i;
+
 	ALOGD("%s,%d \n",__func__,__LINE__);
 
-	if (ret0 == 0) {
-		stopPreview0();
-	}
-	if (ret1 == 0) {
-		stopPreview1();
+	for (i = 0; i < STREAM_CAMERA_MAX; i++) {
+		if (cam_opened[i]) {
+			stopPreview(i);
+			cam_opened[i] = FALSE;
+		}
 	}
 }
@@ -55,9 +55,6 @@
 #define COMPENSATION_OFFSET 20
 #define DELIMITER           "|"
 
-#define IMAGE_WIDTH  				640
-#define IMAGE_HEIGHT 				480
-
 #define MODEL "sunny_test"
 #define MAKE "sunny_test"
 
@@ -67,29 +64,22 @@ extern "C" {
 }
 namespace android
 {
+/* one listener per camera, index is the position in the stream config */
 class CameraHandler: public CameraListener
 {
 public:
-	virtual void notify(int32_t msgType, int32_t ext1, int32_t ext2);
-	virtual void postData(int32_t msgType,
-	                      const sp<IMemory>& dataPtr,
-	                      camera_frame_metadata_t *metadata);
-
-	virtual void postDataTimestamp(nsecs_t timestamp, int32_t msgType, const sp<IMemory>& dataPtr);
-};
-};
+	CameraHandler(int index) : mIndex(index), mFrameCount(0) {}
 
-namespace android
-{
-class CameraHandler1: public CameraListener
-{
-public:
 	virtual void notify(int32_t msgType, int32_t ext1, int32_t ext2);
 	virtual void postData(int32_t msgType,
 	                      const sp<IMemory>& dataPtr,
 	                      camera_frame_metadata_t *metadata);
 
 	virtual void postDataTimestamp(nsecs_t timestamp, int32_t msgType, const sp<IMemory>& dataPtr);
+
+private:
+	int mIndex;
+	int mFrameCount;
 };
 };
 
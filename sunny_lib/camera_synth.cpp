@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "uvc_stream.h"
+#include "libsfifo/sfifo.h"
+#include "stream_config.h"
+#include "telemetry.h"
+#include "log_tag.h"
+
+/*
+ * stand-in for camera_ctrl.cpp without android cameras, for the loopback
+ * benchmark. one thread per configured camera produces frames at the
+ * camera rate and hands them on exactly like CameraHandler::postData().
+ *
+ * S_MetaData carries CLOCK_MONOTONIC so a reader on the same machine gets
+ * the end to end latency from it. frameCount advances for every frame
+ * produced, frames lost on the way show up as gaps. the image is
+ * synth_fill() of camera and frame, a reader that does the same can tell
+ * a torn frame (host_uvcviewer/loopback_bench.cpp).
+ */
+
+#define SYNTH_STEP		0x9e3779b1u
+
+/* one camera callback thread feeds each sfifo, video_stream_thread drains them all */
+struct sfifo_des_s *video_sfifo_handle[STREAM_CAMERA_MAX];
+
+static pthread_t synth_tid[STREAM_CAMERA_MAX];
+static BOOL synth_started[STREAM_CAMERA_MAX];
+static volatile int synth_quit = 0;
+
+static void synth_fill(unsigned char *dst, unsigned int size, long cam, long frame)
+{
+	unsigned int seed = (unsigned int)frame * SYNTH_STEP + ((unsigned int)cam << 28);
+	unsigned int *word = (unsigned int *)dst;
+	unsigned int i;
+
+	for (i = 0; i < size / 4; i++)
+		word[i] = seed + i;
+	for (i = size & ~3u; i < size; i++)
+		dst[i] = (unsigned char)(seed + i);
+}
+
+static void *synth_thread(void *arg)
+{
+	int index = (int)(long)arg;
+	const struct stream_camera_s *cam = &stream_config_get()->cam[index];
+	struct sfifo_des_s *sfifo_des_p = video_sfifo_handle[index];
+	unsigned int frame_size = stream_frame_size(cam);
+	long period_ns = 1000000000L / cam->fps;
+	struct timespec next, now;
+	struct sfifo_s *sfifo;
+	S_MetaData MetaData;
+	long frame_count = 0;
+	long long t_cb;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while (!synth_quit) {
+		next.tv_nsec += period_ns;
+		while (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+		t_cb = telemetry_frame_begin(index);
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		stream_meta_init(cam, &MetaData);
+		MetaData.tv_sec = now.tv_sec;
+		MetaData.tv_usec = now.tv_nsec / 1000;
+		MetaData.frameCount = frame_count;
+
+		sfifo = uvcstream_get_free_sfifo();
+		if (sfifo == NULL)
+			sfifo = sfifo_get_free_buf(sfifo_des_p);
+		if (sfifo != NULL) {
+			telemetry_frame_start(sfifo, t_cb);
+			memcpy(sfifo->buffer, &MetaData, HEAD_LEN);
+			synth_fill(sfifo->buffer + HEAD_LEN, frame_size, MetaData.cameraNum, frame_count);
+			telemetry_stamp(sfifo, TELEM_SFIFO_ENQ);
+			if (sfifo_put_active_buf(sfifo, sfifo_des_p) < 0) {
+				uvcstream_release_sfifo(sfifo, index);
+				telemetry_drop(TELEM_CAM_CB);
+			}
+		} else {
+			telemetry_drop(TELEM_CAM_CB);
+		}
+		frame_count++;
+	}
+
+	return NULL;
+}
+
+int camera_init(void)
+{
+	const struct stream_config_s *cfg = stream_config_get();
+	int i;
+
+	for (i = 0; i < cfg->num; i++) {
+		video_sfifo_handle[i] = sfifo_ring_init(cfg->sfifo_bufs, stream_slot_size(&cfg->cam[i]),
+							 cfg->sfifo_bufs + cfg->gadget_bufs);
+		if (video_sfifo_handle[i] == NULL) {
+			ALOGD("Camera%d sfifo init failed\n", i);
+			return -1;
+		}
+	}
+
+	synth_quit = 0;
+	for (i = 0; i < cfg->num; i++) {
+		if (pthread_create(&synth_tid[i], NULL, synth_thread, (void *)(long)i) != 0) {
+			ALOGD("Camera%d synth thread failed\n", i);
+			return -1;
+		}
+		synth_started[i] = TRUE;
+		ALOGD("Camera%d synthetic %dx%d @%d\n", i, cfg->cam[i].width, cfg->cam[i].height, cfg->cam[i].fps);
+	}
+
+	return 0;
+}
+
+void camera_uninit(void)
+{
+	int i;
+
+	synth_quit = 1;
+	for (i = 0; i < STREAM_CAMERA_MAX; i++) {
+		if (synth_started[i]) {
+			pthread_join(synth_tid[i], NULL);
+			synth_started[i] = FALSE;
+		}
+	}
+}
@@ -43,7 +43,7 @@
 enum ezy_memory {
 	EZY_MEMORY_MMAP             = 1,
 	EZY_MEMORY_USERPTR          = 2,
-//	ezy_MEMORY_OVERLAY          = 3,
+	EZY_MEMORY_DMABUF           = 3,
 };
 
 
@@ -65,6 +65,7 @@ struct ezy_buffer {
 				  				 used in the mmap() system call */
 	int size;
 	int bytesused;	// actuall used size
+	int fd;			/* dma-buf: queued with EZY_QBUF, returned by EZY_EXPBUF */
 };
 
 /* ioctls definition */
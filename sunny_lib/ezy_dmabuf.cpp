@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "uvc_stream.h"
+#include "ezy_dmabuf.h"
+#include "log_tag.h"
+
+/* dma-buf fd of buffer index, -1 on error; the caller owns the fd */
+int ezy_export_buffer(int ezy_fd, int index)
+{
+	struct ezy_buffer bufd;
+
+	memset(&bufd, 0, sizeof(bufd));
+	bufd.index = index;
+	if (ioctl(ezy_fd, EZY_EXPBUF, &bufd) < 0) {
+		ALOGD("export ezy buffer %d failed\n", index);
+		return -1;
+	}
+
+	return bufd.fd;
+}
+
+/* queue bytesused bytes of dmabuf_fd in slot index; 0 bytes hands the slot
+ * back without a frame */
+int ezy_import_buffer(int ezy_fd, int index, int dmabuf_fd, unsigned int bytesused)
+{
+	struct ezy_buffer bufd;
+
+	memset(&bufd, 0, sizeof(bufd));
+	bufd.index = index;
+	bufd.fd = dmabuf_fd;
+	bufd.bytesused = bytesused;
+	if (ioctl(ezy_fd, EZY_QBUF, &bufd) < 0) {
+		ALOGD("import dma-buf %d into ezy buffer %d failed\n", dmabuf_fd, index);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef __EZY_DMABUF_H__
+#define __EZY_DMABUF_H__
+
+/*
+ * dma-bufs and ezy_buf queues (ezy_buf/ezy_buf.c). ezy_fd is an opened
+ * queue device, e.g. /dev/g_uvc_mjpeg.
+ *
+ * export: a MEMORY_MMAP buffer as a dma-buf fd, for another driver to fill.
+ * the buffer lives until the fd and every mapping of it are gone, EZY_REQBUF
+ * is refused until then.
+ *
+ * import: a MEMORY_DMABUF queue takes frames in dma-bufs of another driver
+ * (udmabuf, ion, v4l2 EXPBUF), the frame starts at offset 0 of the dma-buf.
+ * the queue holds the dma-buf until another one is queued in the same slot
+ * or the next EZY_REQBUF, the caller may close its fd right away.
+ */
+
+int ezy_export_buffer(int ezy_fd, int index);
+int ezy_import_buffer(int ezy_fd, int index, int dmabuf_fd, unsigned int bytesused);
+
+#endif
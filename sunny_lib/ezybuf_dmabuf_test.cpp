@@ -0,0 +1,347 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/types.h>
+
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "uvc_stream.h"
+#include "ezy_dmabuf.h"
+
+/*
+ * dma-buf round trip through an ezy_buf queue. run as root with ezy_buf.ko
+ * and uvc_gadget.ko loaded and nobody else on the queue device, e.g. before
+ * uvc_loopback_source in shell/uvc_loopback_bench.sh.
+ *
+ * export: a MEMORY_MMAP buffer is exported, written through the dma-buf and
+ * read back through the queue mapping and the other way round. EZY_REQBUF
+ * has to be refused while the dma-buf is open, and the dma-buf has to stay
+ * readable after the queue device is closed.
+ * import: a udmabuf (memfd backed, stock kernels since 4.20) is queued into
+ * a MEMORY_DMABUF queue, which attaches and vmaps it. with -s the queue is
+ * streamed and the frame has to come back done and unchanged, which needs
+ * the host to read the gadget.
+ */
+
+#define EZY_DEVICE				"/dev/g_uvc_mjpeg"
+#define UDMABUF_DEVICE			"/dev/udmabuf"
+#define TEST_BUFS				2
+#define TEST_SIZE				(64 * 1024)
+#define TEST_WAIT_MS			2000
+
+/* <linux/udmabuf.h>, not in every set of kernel headers */
+struct test_udmabuf_create {
+	__u32 memfd;
+	__u32 flags;
+	__u64 offset;
+	__u64 size;
+};
+#define TEST_UDMABUF_CREATE		_IOW('u', 0x42, struct test_udmabuf_create)
+
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING		0x0002U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS				(1024 + 9)
+#define F_SEAL_SHRINK			0x0002
+#endif
+
+static const char *dev_name = EZY_DEVICE;
+
+static void fill(unsigned char *p, unsigned int size, unsigned int seed)
+{
+	unsigned int *word = (unsigned int *)p;
+	unsigned int i;
+
+	for (i = 0; i < size / 4; i++)
+		word[i] = seed * 0x9e3779b1u + i;
+}
+
+/* offset of the first wrong word, -1 when all match */
+static long check(const unsigned char *p, unsigned int size, unsigned int seed)
+{
+	const unsigned int *word = (const unsigned int *)p;
+	unsigned int i;
+
+	for (i = 0; i < size / 4; i++) {
+		if (word[i] != seed * 0x9e3779b1u + i)
+			return (long)i * 4;
+	}
+
+	return -1;
+}
+
+static int reqbufs(int fd, enum ezy_memory memory, int count, int size)
+{
+	struct ezy_reqbufs req;
+
+	memset(&req, 0, sizeof(req));
+	req.memory = memory;
+	req.count = count;
+	req.size = size;
+	return ioctl(fd, EZY_REQBUF, &req);
+}
+
+static int fail(const char *test, const char *what)
+{
+	printf("%s: FAILED, %s (%s)\n", test, what, strerror(errno));
+	return -1;
+}
+
+static int test_export(void)
+{
+	struct ezy_buffer bufd;
+	unsigned char *qmap, *dmap;
+	int fd, dfd;
+	long bad;
+
+	fd = open(dev_name, O_RDWR | O_NONBLOCK);
+	if (fd < 0)
+		return fail("export", "queue device not there");
+
+	if (reqbufs(fd, EZY_MEMORY_MMAP, TEST_BUFS, TEST_SIZE) < 0) {
+		close(fd);
+		return fail("export", "EZY_REQBUF");
+	}
+
+	memset(&bufd, 0, sizeof(bufd));
+	bufd.index = 0;
+	if (ioctl(fd, EZY_QUERYBUF, &bufd) < 0) {
+		close(fd);
+		return fail("export", "EZY_QUERYBUF");
+	}
+
+	qmap = (unsigned char *)mmap(0, bufd.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, bufd.phyaddr);
+	if (qmap == MAP_FAILED) {
+		close(fd);
+		return fail("export", "mmap of the queue");
+	}
+
+	dfd = ezy_export_buffer(fd, 0);
+	if (dfd < 0) {
+		munmap(qmap, bufd.size);
+		close(fd);
+		return fail("export", "EZY_EXPBUF");
+	}
+
+	dmap = (unsigned char *)mmap(0, bufd.size, PROT_READ | PROT_WRITE, MAP_SHARED, dfd, 0);
+	if (dmap == MAP_FAILED) {
+		close(dfd);
+		munmap(qmap, bufd.size);
+		close(fd);
+		return fail("export", "mmap of the dma-buf");
+	}
+
+	fill(dmap, bufd.size, 1);
+	bad = check(qmap, bufd.size, 1);
+	if (bad < 0) {
+		fill(qmap, bufd.size, 2);
+		bad = check(dmap, bufd.size, 2);
+	}
+	if (bad >= 0) {
+		printf("export: FAILED, dma-buf and queue mapping differ at %ld\n", bad);
+		goto done;
+	}
+
+	if (reqbufs(fd, EZY_MEMORY_MMAP, TEST_BUFS, TEST_SIZE) == 0) {
+		bad = 0;
+		printf("export: FAILED, EZY_REQBUF taken while the dma-buf is open\n");
+		goto done;
+	}
+
+	munmap(qmap, bufd.size);
+	qmap = NULL;
+	close(fd);
+	fd = -1;
+
+	bad = check(dmap, bufd.size, 2);
+	if (bad >= 0) {
+		printf("export: FAILED, dma-buf changed at %ld with the queue device closed\n", bad);
+		goto done;
+	}
+
+done:
+	munmap(dmap, bufd.size);
+	close(dfd);
+	if (qmap != NULL)
+		munmap(qmap, bufd.size);
+	if (fd >= 0)
+		close(fd);
+	if (bad >= 0)
+		return -1;
+
+	/* the last reference is gone, the queue may reallocate */
+	fd = open(dev_name, O_RDWR | O_NONBLOCK);
+	if (fd < 0 || reqbufs(fd, EZY_MEMORY_MMAP, TEST_BUFS, TEST_SIZE) < 0) {
+		if (fd >= 0)
+			close(fd);
+		return fail("export", "EZY_REQBUF after the dma-buf was closed");
+	}
+	close(fd);
+
+	printf("export: ok, %d bytes both ways\n", bufd.size);
+	return 0;
+}
+
+static int udmabuf_create(unsigned int size, unsigned char **map)
+{
+	struct test_udmabuf_create create;
+	int ud, mfd, dfd = -1;
+
+#ifdef __NR_memfd_create
+	mfd = syscall(__NR_memfd_create, "ezybuf_dmabuf_test", MFD_ALLOW_SEALING);
+#else
+	mfd = -1;
+	errno = ENOSYS;
+#endif
+	if (mfd < 0)
+		return -1;
+
+	ud = open(UDMABUF_DEVICE, O_RDWR);
+	if (ud < 0)
+		goto done;
+
+	if (ftruncate(mfd, size) < 0 || fcntl(mfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0)
+		goto done;
+
+	*map = (unsigned char *)mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, mfd, 0);
+	if (*map == MAP_FAILED)
+		goto done;
+
+	memset(&create, 0, sizeof(create));
+	create.memfd = mfd;
+	create.size = size;
+	dfd = ioctl(ud, TEST_UDMABUF_CREATE, &create);
+	if (dfd < 0)
+		munmap(*map, size);
+
+done:
+	if (ud >= 0)
+		close(ud);
+	close(mfd);
+	return dfd;
+}
+
+/* 1 when udmabuf is not there */
+static int test_import(int stream)
+{
+	struct ezy_buffer bufd;
+	unsigned char *map;
+	int fd, dfd, ms, ret = -1;
+	long bad;
+
+	dfd = udmabuf_create(TEST_SIZE, &map);
+	if (dfd < 0) {
+		if (access(UDMABUF_DEVICE, F_OK) == 0)
+			return fail("import", "udmabuf");
+		printf("import: skipped, no %s\n", UDMABUF_DEVICE);
+		return 1;
+	}
+	fill(map, TEST_SIZE, 3);
+
+	fd = open(dev_name, O_RDWR | O_NONBLOCK);
+	if (fd < 0) {
+		fail("import", "queue device not there");
+		goto unmap;
+	}
+
+	if (reqbufs(fd, EZY_MEMORY_DMABUF, TEST_BUFS, 0) < 0) {
+		fail("import", "EZY_REQBUF");
+		goto done;
+	}
+
+	if (ezy_import_buffer(fd, 0, dfd, TEST_SIZE) < 0) {
+		fail("import", "EZY_QBUF of the udmabuf");
+		goto done;
+	}
+
+	/* the queue holds its own reference */
+	close(dfd);
+	dfd = -1;
+
+	if (stream) {
+		memset(&bufd, 0, sizeof(bufd));
+		if (ioctl(fd, EZY_STREAMON, &bufd) < 0) {
+			fail("import", "EZY_STREAMON");
+			goto done;
+		}
+
+		for (ms = 0; ms < TEST_WAIT_MS; ms += 10) {
+			memset(&bufd, 0, sizeof(bufd));
+			if (ioctl(fd, EZY_DQBUF, &bufd) == 0)
+				break;
+			usleep(10000);
+		}
+
+		memset(&bufd, 0, sizeof(bufd));
+		ioctl(fd, EZY_STREAMOFF, &bufd);
+
+		if (ms >= TEST_WAIT_MS) {
+			printf("import: FAILED, frame not sent in %d ms, is the host streaming?\n", TEST_WAIT_MS);
+			goto done;
+		}
+
+		bad = check(map, TEST_SIZE, 3);
+		if (bad >= 0) {
+			printf("import: FAILED, udmabuf changed at %ld on the way\n", bad);
+			goto done;
+		}
+	}
+
+	printf("import: ok, %d bytes %s\n", TEST_SIZE, stream ? "sent" : "queued");
+	ret = 0;
+
+done:
+	if (fd >= 0) {
+		/* drops the import */
+		reqbufs(fd, EZY_MEMORY_DMABUF, 0, 0);
+		close(fd);
+	}
+unmap:
+	if (dfd >= 0)
+		close(dfd);
+	munmap(map, TEST_SIZE);
+	return ret;
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [-d device] [-s]\n", prog);
+	printf("  -d  ezy_buf queue device (default %s)\n", EZY_DEVICE);
+	printf("  -s  stream the imported frame, the host has to read the gadget\n");
+}
+
+int main(int argc, char **argv)
+{
+	int stream = 0;
+	int opt, ret;
+
+	while ((opt = getopt(argc, argv, "d:sh")) != -1) {
+		switch (opt) {
+		case 'd':
+			dev_name = optarg;
+			break;
+		case 's':
+			stream = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	ret = test_export();
+	if (test_import(stream) < 0)
+		ret = -1;
+
+	return ret < 0 ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+#ifndef __HOST_CUTILS_PROPERTIES_H__
+#define __HOST_CUTILS_PROPERTIES_H__
+
+/* host build (sunny_lib/host/Makefile): a property is the environment
+ * variable of the same name, e.g. env sunny.stream.cameras=... */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PROPERTY_VALUE_MAX	92
+
+static inline int property_get(const char *key, char *value, const char *default_value)
+{
+	const char *env = getenv(key);
+
+	if (env == NULL)
+		env = default_value;
+	if (env == NULL) {
+		value[0] = '\0';
+		return 0;
+	}
+
+	strncpy(value, env, PROPERTY_VALUE_MAX - 1);
+	value[PROPERTY_VALUE_MAX - 1] = '\0';
+	return strlen(value);
+}
+
+#endif
@@ -0,0 +1,35 @@
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "../libmsg/msg_util.h"
+
+/*
+ * host build (sunny_lib/host/Makefile): there is no /data/UNIX.domain
+ * server to tell about disk mode. uvcctrl_cmd_process() still polls
+ * msg_get_fd(), an eventfd nobody writes keeps it quiet.
+ */
+
+static int connect_fd = -1;
+
+int msg_init(void)
+{
+	connect_fd = eventfd(0, EFD_CLOEXEC);
+	return connect_fd < 0 ? -1 : 0;
+}
+
+int msg_send(void)
+{
+	return 0;
+}
+
+int msg_uninit(void)
+{
+	close(connect_fd);
+	connect_fd = -1;
+	return 0;
+}
+
+int msg_get_fd(void)
+{
+	return connect_fd;
+}
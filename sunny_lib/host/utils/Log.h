@@ -0,0 +1,10 @@
+#ifndef __HOST_UTILS_LOG_H__
+#define __HOST_UTILS_LOG_H__
+
+/* host build (sunny_lib/host/Makefile): android log to stderr */
+
+#include <stdio.h>
+
+#define ALOGD(...)			fprintf(stderr, __VA_ARGS__)
+
+#endif
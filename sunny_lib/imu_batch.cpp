@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "imu_batch.h"
+#include "log_tag.h"
+
+void imu_batcher_init(struct imu_batcher_s *b, int max_num, long long max_us, imu_batch_flush_cb flush)
+{
+	memset(b, 0, sizeof(*b));
+
+	if (max_num <= 0 || max_num > IMU_BATCH_MAX)
+		max_num = IMU_BATCH_MAX;
+
+	b->max_num = max_num;
+	b->max_us = max_us;
+	b->flush = flush;
+}
+
+int imu_batcher_flush(struct imu_batcher_s *b)
+{
+	int ret = 0;
+
+	if (b->batch.num == 0)
+		return 0;
+
+	if (b->flush != NULL)
+		ret = b->flush(&b->batch);
+	if (ret < 0)
+		b->stats.errors++;
+
+	b->stats.flushes++;
+	b->batch.seq++;
+	b->batch.num = 0;
+	return ret;
+}
+
+int imu_batcher_push(struct imu_batcher_s *b, const struct imu_data *data, long long now_us)
+{
+	if (b->batch.num == 0)
+		b->first_us = now_us;
+
+	b->batch.samples[b->batch.num++] = *data;
+	b->stats.samples++;
+
+	if (b->batch.num >= b->max_num || now_us - b->first_us >= b->max_us)
+		return imu_batcher_flush(b);
+
+	return 0;
+}
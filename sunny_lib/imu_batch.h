@@ -0,0 +1,43 @@
+#ifndef __IMU_BATCH_H__
+#define __IMU_BATCH_H__
+
+#include "uvc_ctrl.h"
+
+#define IMU_BATCH_MAX			32		/* same as the gadget, XU_IMU_BATCH payload */
+#define IMU_BATCH_NUM_DEF		8
+#define IMU_BATCH_US_DEF		8000
+
+/* CTRL_SET_IMU_BATCH argument, layout shared with g_uvc_ctrl.h */
+struct imu_batch {
+	Uint32 seq;
+	Uint16 num;
+	Uint16 lost;
+	struct imu_data samples[IMU_BATCH_MAX];
+};
+
+typedef int (*imu_batch_flush_cb)(struct imu_batch *batch);
+
+struct imu_batch_stats {
+	unsigned long samples;
+	unsigned long flushes;
+	unsigned long errors;
+};
+
+/*
+ * collects samples from the imu thread and hands them on once max_num are
+ * queued or the oldest one is max_us old. single producer, no locking.
+ */
+struct imu_batcher_s {
+	int max_num;
+	long long max_us;
+	long long first_us;		/* arrival of samples[0] */
+	imu_batch_flush_cb flush;
+	struct imu_batch batch;
+	struct imu_batch_stats stats;
+};
+
+void imu_batcher_init(struct imu_batcher_s *b, int max_num, long long max_us, imu_batch_flush_cb flush);
+int imu_batcher_push(struct imu_batcher_s *b, const struct imu_data *data, long long now_us);
+int imu_batcher_flush(struct imu_batcher_s *b);
+
+#endif
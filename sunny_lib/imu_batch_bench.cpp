@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "imu_batch.h"
+
+/*
+ * imu hand-off benchmark: feeds synthetic samples at the imu rate into the
+ * gadget, once with one CTRL_SET_CMD per sample and once batched with
+ * CTRL_SET_IMU_BATCH. reports syscalls/sec, cpu time and the time from a
+ * sample being produced to it sitting in the gadget ring. the host side
+ * read interval comes on top of that and is not measured here.
+ */
+
+#define VIDEO_CMD_DEVICE		"/dev/g_uvc_ctrl"
+#define	CTRL_IOC_BASE			'C'
+#define	CTRL_SET_CMD			_IOW(CTRL_IOC_BASE,  1, struct imu_data *)
+#define	CTRL_SET_IMU_BATCH		_IOW(CTRL_IOC_BASE,  3, struct imu_batch *)
+
+static int bench_fd = -1;
+static int bench_null = 0;		/* no gadget, write() the payload to /dev/null */
+static long long *gen_time;
+static long long *latency;
+static int flushed;
+static unsigned long syscalls;
+
+static long long get_time_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+static long long get_cpu_us(void)
+{
+	struct rusage ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+	return (long long)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+	       ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+static int cmp_ll(const void *a, const void *b)
+{
+	long long x = *(const long long *)a;
+	long long y = *(const long long *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int put_sample(struct imu_data *data)
+{
+	int ret;
+
+	syscalls++;
+	if (bench_null)
+		ret = write(bench_fd, data, sizeof(*data));
+	else
+		ret = ioctl(bench_fd, CTRL_SET_CMD, data);
+
+	latency[flushed] = get_time_us() - gen_time[flushed];
+	flushed++;
+	return ret;
+}
+
+static int put_batch(struct imu_batch *batch)
+{
+	long long now;
+	int ret, i;
+
+	syscalls++;
+	if (bench_null)
+		ret = write(bench_fd, batch, sizeof(*batch) - (IMU_BATCH_MAX - batch->num) * sizeof(struct imu_data));
+	else
+		ret = ioctl(bench_fd, CTRL_SET_IMU_BATCH, batch);
+
+	now = get_time_us();
+	for (i = 0; i < batch->num; i++, flushed++)
+		latency[flushed] = now - gen_time[flushed];
+	return ret;
+}
+
+static void run_bench(const char *name, int samples, int rate, int batch_num, long long batch_us)
+{
+	struct imu_batcher_s batcher;
+	struct imu_data data;
+	struct timespec next;
+	long long start, elapsed, cpu;
+	long long period_ns = rate > 0 ? 1000000000LL / rate : 0;
+	int i;
+
+	memset(&data, 0, sizeof(data));
+	imu_batcher_init(&batcher, batch_num, batch_us, put_batch);
+	flushed = 0;
+	syscalls = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	start = get_time_us();
+	cpu = get_cpu_us();
+
+	for (i = 0; i < samples; i++) {
+		if (period_ns > 0) {
+			next.tv_nsec += period_ns;
+			while (next.tv_nsec >= 1000000000L) {
+				next.tv_nsec -= 1000000000L;
+				next.tv_sec++;
+			}
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		}
+
+		gen_time[i] = get_time_us();
+		data.gyro_x = (float)i;
+		data.timestamp = (long)gen_time[i];
+		if (batch_num <= 1)
+			put_sample(&data);
+		else
+			imu_batcher_push(&batcher, &data, gen_time[i]);
+	}
+	if (batch_num > 1)
+		imu_batcher_flush(&batcher);
+
+	elapsed = get_time_us() - start;
+	cpu = get_cpu_us() - cpu;
+
+	qsort(latency, flushed, sizeof(long long), cmp_ll);
+	printf("%-8s samples=%d samples/sec=%.0f syscalls/sec=%.0f cpu=%.2f%% p50=%lldus p99=%lldus max=%lldus\n",
+	       name, flushed, (double)flushed * 1000000.0 / elapsed, (double)syscalls * 1000000.0 / elapsed,
+	       (double)cpu * 100.0 / elapsed, latency[flushed / 2],
+	       latency[(long long)flushed * 99 / 100], latency[flushed - 1]);
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [-n samples] [-r rate] [-b batch] [-t us] [-d device|null]\n", prog);
+	printf("  -n  number of samples per run (default 5000)\n");
+	printf("  -r  imu rate in Hz, 0 pushes as fast as possible (default 1000)\n");
+	printf("  -b  samples per batch (default %d)\n", IMU_BATCH_NUM_DEF);
+	printf("  -t  max batch age in us (default %d)\n", IMU_BATCH_US_DEF);
+	printf("  -d  gadget control device (default %s), null writes to /dev/null\n", VIDEO_CMD_DEVICE);
+}
+
+int main(int argc, char **argv)
+{
+	const char *device = VIDEO_CMD_DEVICE;
+	int samples = 5000;
+	int rate = 1000;
+	int batch_num = IMU_BATCH_NUM_DEF;
+	long long batch_us = IMU_BATCH_US_DEF;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:r:b:t:d:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			samples = atoi(optarg);
+			break;
+		case 'r':
+			rate = atoi(optarg);
+			break;
+		case 'b':
+			batch_num = atoi(optarg);
+			break;
+		case 't':
+			batch_us = atoll(optarg);
+			break;
+		case 'd':
+			device = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	if (samples <= 0 || rate < 0 || batch_num <= 1 || batch_num > IMU_BATCH_MAX) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	if (strcmp(device, "null") == 0) {
+		bench_null = 1;
+		device = "/dev/null";
+	}
+	bench_fd = open(device, O_RDWR);
+	if (bench_fd < 0) {
+		printf("failed to open %s\n", device);
+		return -1;
+	}
+
+	gen_time = (long long *)calloc(samples, sizeof(long long));
+	latency = (long long *)calloc(samples, sizeof(long long));
+	if (gen_time == NULL || latency == NULL) {
+		close(bench_fd);
+		return -1;
+	}
+
+	run_bench("single", samples, rate, 1, 0);
+	run_bench("batched", samples, rate, batch_num, batch_us);
+
+	free(gen_time);
+	free(latency);
+	close(bench_fd);
+	return 0;
+}
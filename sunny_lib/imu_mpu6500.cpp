@@ -45,6 +45,7 @@
 #include "typedef.h"
 #include "uvc_ctrl.h"
 #include "uvc_stream.h"
+#include "imu_ring.h"
 
 
 #ifdef ENABLE_DMP_SCREEN_AUTO_ROTATION
@@ -271,6 +272,7 @@ static int debug_time = 0;
 static pthread_t Sensor_thread_id;
 static sensors_poll_context_t *g_ctx = NULL;
 static int g_sensor_exit = 1;
+static struct imu_ring_s *g_imu_ring = NULL;
 
 int sensors_poll_context_t::pollEvents(sensors_event_t *data, int count)
 {
@@ -417,6 +419,7 @@ void* Sensor_poll_thread(void* parg)
 	int acl_ready = 0;
 	int64_t tm_cur = 0;
 	int64_t tm_lasttimes = 0;
+	int64_t imu_timestamp = 0;
 	int videomode;
 	int (*imu_proc)(struct imu_data * data);
 
@@ -428,6 +431,7 @@ void* Sensor_poll_thread(void* parg)
 				imudata.gyro_y    = data[i].gyro.v[1];
 				imudata.gyro_z 	 = data[i].gyro.v[2];
 				imudata.timestamp = (long)(data[i].timestamp);
+				imu_timestamp = data[i].timestamp;
 				gyro_ready = 1;
 			}
 
@@ -436,6 +440,7 @@ void* Sensor_poll_thread(void* parg)
 				imudata.acl_y     = data[i].acceleration.v[1];
 				imudata.acl_z 	  = data[i].acceleration.v[2];
 				imudata.timestamp = (long)(data[i].timestamp);
+				imu_timestamp = data[i].timestamp;
 				acl_ready = 1;
 			}
 		}
@@ -443,6 +448,9 @@ void* Sensor_poll_thread(void* parg)
 			gyro_ready = 0;
 			acl_ready = 0;
 
+			/* history for frame aligned bundles, kept even when nobody streams */
+			imu_ring_push(g_imu_ring, &imudata, imu_timestamp);
+
 			if (is_uvcstreamon() == TRUE){
 				imu_function_lock();
 				if	(g_fpimu_cb != NULL){
@@ -458,6 +466,10 @@ void* Sensor_poll_thread(void* parg)
 
 int imu_init(void)
 {
+	g_imu_ring = imu_ring_init();
+	if (g_imu_ring == NULL)
+		return -1;
+
 	g_ctx = new sensors_poll_context_t();
 	g_ctx->activate(SENSORS_GYROSCOPE_HANDLE, 1);
 	g_ctx->setDelay(SENSORS_GYROSCOPE_HANDLE, 5000000);//200HZ
@@ -473,4 +485,14 @@ void imu_uninit(void)
 	g_ctx->activate(SENSORS_GYROSCOPE_HANDLE, 0);
 	g_ctx->activate(SENSORS_ACCELERATION_HANDLE, 0);
 	delete g_ctx;
+	imu_ring_uninit(g_imu_ring);
+	g_imu_ring = NULL;
+}
+
+int imu_get_bundle(long long from_us, long long to_us, long long exposure_us, struct imu_bundle_s *bundle)
+{
+	if (g_imu_ring == NULL)
+		return -1;
+
+	return imu_ring_get_bundle(g_imu_ring, from_us, to_us, exposure_us, bundle);
 }
@@ -1,7 +1,10 @@
 #ifndef __SENSORS_MPL_H__
 #define __SENSORS_MPL_H__
 
+struct imu_bundle_s;
+
 int imu_init(void);
 void imu_uninit(void);
+int imu_get_bundle(long long from_us, long long to_us, long long exposure_us, struct imu_bundle_s *bundle);
 
 #endif
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "uvc_ctrl.h"
+#include "imu_ring.h"
+#include "log_tag.h"
+
+/*
+ * lock free IMU history. the writer marks a slot invalid, fills it and then
+ * stamps it with its ring index; readers copy a slot and re-check the stamp,
+ * so a sample overwritten during the copy is simply treated as gone.
+ */
+
+#define IMU_RING_MASK		(IMU_RING_SIZE - 1)
+
+static int imu_ring_read(struct imu_ring_s *ring, unsigned int idx, struct imu_sample_s *sample)
+{
+	struct imu_sample_s *slot = &ring->slots[idx & IMU_RING_MASK];
+	unsigned int seq;
+
+	seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+	if (seq != idx + 1)
+		return -1;
+
+	sample->timestamp = slot->timestamp;
+	memcpy(sample->acl, slot->acl, sizeof(sample->acl));
+	memcpy(sample->gyro, slot->gyro, sizeof(sample->gyro));
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+		return -1;
+
+	return 0;
+}
+
+static void sample_to_imu(const struct imu_sample_s *sample, struct imu_data *data)
+{
+	data->acl_x = sample->acl[0];
+	data->acl_y = sample->acl[1];
+	data->acl_z = sample->acl[2];
+	data->gyro_x = sample->gyro[0];
+	data->gyro_y = sample->gyro[1];
+	data->gyro_z = sample->gyro[2];
+	/* wraps where long is 32 bit, the bundle carries the full ns alongside */
+	data->timestamp = (long)sample->timestamp;
+}
+
+/* oldest ring index whose sample is newer than t_ns, head when there is none */
+static unsigned int imu_ring_find(struct imu_ring_s *ring, unsigned int head, long long t_ns)
+{
+	struct imu_sample_s sample;
+	unsigned int tail = (head > IMU_RING_SIZE) ? head - IMU_RING_SIZE : 0;
+	unsigned int idx = head;
+
+	while (idx > tail) {
+		if (imu_ring_read(ring, idx - 1, &sample) < 0 || sample.timestamp <= t_ns)
+			break;
+		idx--;
+	}
+
+	return idx;
+}
+
+struct imu_ring_s *imu_ring_init(void)
+{
+	struct imu_ring_s *ring;
+
+	ring = (struct imu_ring_s *)calloc(1, sizeof(struct imu_ring_s));
+	if (ring == NULL) {
+		ALOGD("imu ring alloc failed\n");
+		return NULL;
+	}
+
+	return ring;
+}
+
+void imu_ring_uninit(struct imu_ring_s *ring)
+{
+	free(ring);
+}
+
+void imu_ring_push(struct imu_ring_s *ring, const struct imu_data *data, long long timestamp_ns)
+{
+	unsigned int idx = ring->head;
+	struct imu_sample_s *slot = &ring->slots[idx & IMU_RING_MASK];
+
+	__atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	slot->timestamp = timestamp_ns;
+	slot->acl[0] = data->acl_x;
+	slot->acl[1] = data->acl_y;
+	slot->acl[2] = data->acl_z;
+	slot->gyro[0] = data->gyro_x;
+	slot->gyro[1] = data->gyro_y;
+	slot->gyro[2] = data->gyro_z;
+
+	__atomic_store_n(&slot->seq, idx + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&ring->head, idx + 1, __ATOMIC_RELEASE);
+}
+
+/* samples in (from_us, to_us], oldest first, timestamps_ns may be NULL */
+int imu_ring_get_range(struct imu_ring_s *ring, long long from_us, long long to_us,
+                       struct imu_data *samples, long long *timestamps_ns, int max_num)
+{
+	struct imu_sample_s sample;
+	unsigned int head, idx;
+	int num = 0;
+
+	if (ring == NULL || samples == NULL || max_num <= 0 || to_us < from_us)
+		return -1;
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	idx = imu_ring_find(ring, head, from_us * 1000);
+
+	for (; idx != head && num < max_num; idx++) {
+		if (imu_ring_read(ring, idx, &sample) < 0)
+			continue;
+		if (sample.timestamp > to_us * 1000)
+			break;
+		if (timestamps_ns != NULL)
+			timestamps_ns[num] = sample.timestamp;
+		sample_to_imu(&sample, &samples[num++]);
+	}
+
+	return num;
+}
+
+/*
+ * linear interpolation between the two samples around t_us. a t_us newer
+ * than the newest sample, as usual at frame time, is extrapolated from the
+ * last two samples up to IMU_EXTRAPOLATE_US.
+ */
+int imu_ring_interpolate(struct imu_ring_s *ring, long long t_us, struct imu_data *out)
+{
+	struct imu_sample_s a, b, mid;
+	long long t_ns = t_us * 1000;
+	unsigned int head, idx;
+	float k;
+	int i;
+
+	if (ring == NULL || out == NULL)
+		return -1;
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	if (head < 2)
+		return -1;
+
+	idx = imu_ring_find(ring, head, t_ns);
+	if (idx == head)
+		idx--;
+	if (idx == 0)
+		return -1;
+
+	if (imu_ring_read(ring, idx - 1, &a) < 0 || imu_ring_read(ring, idx, &b) < 0)
+		return -1;
+	if (t_ns - b.timestamp > IMU_EXTRAPOLATE_US * 1000LL)
+		return -1;
+
+	k = (b.timestamp > a.timestamp) ? (float)(t_ns - a.timestamp) / (float)(b.timestamp - a.timestamp) : 0.0f;
+	for (i = 0; i < 3; i++) {
+		mid.acl[i] = a.acl[i] + (b.acl[i] - a.acl[i]) * k;
+		mid.gyro[i] = a.gyro[i] + (b.gyro[i] - a.gyro[i]) * k;
+	}
+	mid.timestamp = t_ns;
+	sample_to_imu(&mid, out);
+
+	return 0;
+}
+
+int imu_ring_get_bundle(struct imu_ring_s *ring, long long from_us, long long to_us,
+                        long long exposure_us, struct imu_bundle_s *bundle)
+{
+	int num;
+
+	if (bundle == NULL)
+		return -1;
+
+	memset(bundle, 0, sizeof(*bundle));
+
+	num = imu_ring_get_range(ring, from_us, to_us, bundle->samples, bundle->timestamp_ns, IMU_BUNDLE_MAX);
+	if (num < 0)
+		return -1;
+	bundle->num = num;
+
+	/* the samples are still good without a midpoint */
+	bundle->mid_valid = (imu_ring_interpolate(ring, to_us - exposure_us / 2, &bundle->mid) == 0);
+	if (bundle->mid_valid)
+		bundle->mid_timestamp_ns = (to_us - exposure_us / 2) * 1000;
+
+	return 0;
+}
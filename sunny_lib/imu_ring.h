@@ -0,0 +1,49 @@
+#ifndef __IMU_RING_H__
+#define __IMU_RING_H__
+
+#include "typedef.h"
+#include "uvc_ctrl.h"
+
+#define IMU_RING_SIZE		8192	/* power of two, ~8s at 1kHz */
+#define IMU_BUNDLE_MAX		128
+#define IMU_EXTRAPOLATE_US	20000	/* how far past the newest sample the midpoint may be */
+
+struct imu_sample_s {
+	volatile unsigned int seq;		/* ring index + 1 once written, 0 while writing */
+	long long timestamp;			/* ns, full width copy of imu_data.timestamp */
+	float acl[3];
+	float gyro[3];
+};
+
+/* single writer (the sensor poll thread), any number of readers */
+struct imu_ring_s {
+	volatile unsigned int head;
+	struct imu_sample_s slots[IMU_RING_SIZE];
+};
+
+/*
+ * every sample in (from_us, to_us] plus one interpolated at the exposure
+ * midpoint, mid_valid is 0 when the ring has nothing around the midpoint.
+ * imu_data.timestamp is a long and wraps every ~2s on 32 bit, the full ns
+ * timestamps are in timestamp_ns[] and mid_timestamp_ns.
+ */
+struct imu_bundle_s {
+	int num;
+	struct imu_data samples[IMU_BUNDLE_MAX];
+	long long timestamp_ns[IMU_BUNDLE_MAX];
+	int mid_valid;
+	struct imu_data mid;
+	long long mid_timestamp_ns;
+};
+
+struct imu_ring_s *imu_ring_init(void);
+void imu_ring_uninit(struct imu_ring_s *ring);
+void imu_ring_push(struct imu_ring_s *ring, const struct imu_data *data, long long timestamp_ns);
+
+int imu_ring_get_range(struct imu_ring_s *ring, long long from_us, long long to_us,
+                       struct imu_data *samples, long long *timestamps_ns, int max_num);
+int imu_ring_interpolate(struct imu_ring_s *ring, long long t_us, struct imu_data *out);
+int imu_ring_get_bundle(struct imu_ring_s *ring, long long from_us, long long to_us,
+                        long long exposure_us, struct imu_bundle_s *bundle);
+
+#endif
@@ -9,7 +9,7 @@
 #include "msg_util.h"
 #define UNIX_DOMAIN "/data/UNIX.domain"
 
-static int connect_fd;
+static int connect_fd = -1;
 int msg_init(void)
 {
 	struct sockaddr_un srv_addr;
@@ -44,5 +44,10 @@ int msg_send(void)
 int msg_uninit(void)
 {
 	close(connect_fd);
+	connect_fd = -1;
 	return 0;
+}
+int msg_get_fd(void)
+{
+	return connect_fd;
 }
\ No newline at end of file
@@ -7,4 +7,5 @@ struct tagmsg_buff{
 int msg_init(void);
 int msg_send(void);
 int msg_uninit(void);
+int msg_get_fd(void);
 #endif
\ No newline at end of file
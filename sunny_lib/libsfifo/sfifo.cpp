@@ -11,6 +11,10 @@
 #include <pthread.h>
 #include <signal.h>
 #include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include <utils/Log.h>
 
@@ -23,11 +27,205 @@
 
 struct sfifo_des_s sfifo_des[MAX_SFIFO_NUM];
 
+static long get_time_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static int sfifo_futex_wait(volatile int *addr, int val, int timeout_ms)
+{
+	struct timespec ts;
+
+	if (timeout_ms < 0)
+		return syscall(__NR_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+
+	ts.tv_sec = timeout_ms / 1000;
+	ts.tv_nsec = (timeout_ms % 1000) * 1000 * 1000;
+	return syscall(__NR_futex, addr, FUTEX_WAIT_PRIVATE, val, &ts, NULL, 0);
+}
+
+static void sfifo_futex_wake(volatile int *addr)
+{
+	syscall(__NR_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static int sfifo_ring_setup(struct sfifo_ring_des_s *ring, int sfifo_num)
+{
+	unsigned int slots_num = 1;
+
+	while (slots_num < (unsigned int)sfifo_num)
+		slots_num <<= 1;
+
+	ring->slots = (struct sfifo_s **)calloc(slots_num, sizeof(struct sfifo_s *));
+	if (ring->slots == NULL)
+		return -1;
+
+	ring->mask = slots_num - 1;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->seq = 0;
+	ring->waiters = 0;
+	ring->kick = 0;
+
+	return 0;
+}
+
+static int sfifo_ring_put(struct sfifo_ring_des_s *ring, struct sfifo_s *sfifo)
+{
+	unsigned int tail = (unsigned int)ring->tail;
+	unsigned int head = (unsigned int)__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	if (sfifo == NULL)
+		return -1;
+
+	if (tail - head > ring->mask) {
+		ALOGD("sfifo ring full\n");
+		return -1;
+	}
+
+	ring->slots[tail & ring->mask] = sfifo;
+	__atomic_store_n(&ring->tail, (int)(tail + 1), __ATOMIC_RELEASE);
+	__atomic_add_fetch(&ring->seq, 1, __ATOMIC_SEQ_CST);
+
+	/* pairs with the waiters increment in sfifo_ring_wait() */
+	if (__atomic_load_n(&ring->waiters, __ATOMIC_SEQ_CST) > 0)
+		sfifo_futex_wake(&ring->seq);
+
+	return 0;
+}
+
+static struct sfifo_s* sfifo_ring_get(struct sfifo_ring_des_s *ring)
+{
+	unsigned int head = (unsigned int)ring->head;
+	unsigned int tail = (unsigned int)__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	struct sfifo_s *sfifo;
+
+	if (head == tail)
+		return NULL;
+
+	sfifo = ring->slots[head & ring->mask];
+	__atomic_store_n(&ring->head, (int)(head + 1), __ATOMIC_RELEASE);
+
+	return sfifo;
+}
+
+static struct sfifo_s* sfifo_ring_wait(struct sfifo_ring_des_s *ring, int timeout_ms)
+{
+	struct sfifo_s *sfifo;
+	long deadline = 0;
+	int left = timeout_ms;
+	int seq;
+
+	if (timeout_ms > 0)
+		deadline = get_time_ms() + timeout_ms;
+
+	while ((sfifo = sfifo_ring_get(ring)) == NULL) {
+		if (timeout_ms == 0)
+			break;
+
+		if (__atomic_exchange_n(&ring->kick, 0, __ATOMIC_SEQ_CST))
+			break;
+
+		if (timeout_ms > 0) {
+			left = (int)(deadline - get_time_ms());
+			if (left <= 0)
+				break;
+		}
+
+		seq = __atomic_load_n(&ring->seq, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) == ring->head &&
+		    !__atomic_load_n(&ring->kick, __ATOMIC_SEQ_CST))
+			sfifo_futex_wait(&ring->seq, seq, left);
+		__atomic_sub_fetch(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+	}
+
+	return sfifo;
+}
+
+static int sfifo_list_timedwait(struct sfifo_list_des_s *list, int timeout_ms)
+{
+	struct timespec outtime;
+	struct timeval now;
+
+	if (timeout_ms < 0)
+		return pthread_cond_wait(&(list->cond), &(list->lock_mutex));
+
+	gettimeofday(&now, NULL);
+	outtime.tv_sec = now.tv_sec + timeout_ms / 1000;
+	outtime.tv_nsec = (now.tv_usec + (timeout_ms % 1000) * 1000) * 1000;
+	if (outtime.tv_nsec >= 1000 * 1000 * 1000) {
+		outtime.tv_sec++;
+		outtime.tv_nsec -= 1000 * 1000 * 1000;
+	}
+	return pthread_cond_timedwait(&(list->cond), &(list->lock_mutex), &outtime);
+}
+
+static struct sfifo_s* sfifo_list_wait(struct sfifo_list_des_s *list, int timeout_ms)
+{
+	struct sfifo_s *sfifo = NULL;
+
+	pthread_mutex_lock(&(list->lock_mutex));
+	while (list->head == NULL) {
+		if (list->kick) {
+			list->kick = 0;
+			break;
+		}
+		if (timeout_ms == 0 || sfifo_list_timedwait(list, timeout_ms) == ETIMEDOUT)
+			break;
+	}
+
+	sfifo = list->head;
+	if (sfifo != NULL)
+		list->head = sfifo->next;
+	pthread_mutex_unlock(&(list->lock_mutex));
+
+	return sfifo;
+}
+
+static void sfifo_ring_wakeup(struct sfifo_ring_des_s *ring)
+{
+	__atomic_store_n(&ring->kick, 1, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&ring->seq, 1, __ATOMIC_SEQ_CST);
+	sfifo_futex_wake(&ring->seq);
+}
+
+static void sfifo_list_wakeup(struct sfifo_list_des_s *list)
+{
+	pthread_mutex_lock(&(list->lock_mutex));
+	list->kick = 1;
+	pthread_cond_broadcast(&(list->cond));
+	pthread_mutex_unlock(&(list->lock_mutex));
+}
+
+/* only the active side is waited on by a thread that needs kicking */
+void sfifo_wakeup(struct sfifo_des_s *sfifo_des_p)
+{
+	if (sfifo_des_p->mode == SFIFO_MODE_RING)
+		sfifo_ring_wakeup(&sfifo_des_p->active_ring);
+	else
+		sfifo_list_wakeup(&sfifo_des_p->active_list);
+}
+
 struct sfifo_s* sfifo_get_free_buf(struct sfifo_des_s *sfifo_des_p)
 {
 	static long empty_count = 0;
 	struct sfifo_s *sfifo = NULL;
 
+	if (sfifo_des_p->mode == SFIFO_MODE_RING) {
+#ifdef CONFIG_COND_FREE
+		sfifo = sfifo_ring_wait(&sfifo_des_p->free_ring, SFIFO_WAIT_FOREVER);
+#else
+		sfifo = sfifo_ring_get(&sfifo_des_p->free_ring);
+		if (sfifo == NULL && empty_count++ % 120 == 0) {
+			ALOGD("free ring empty\n");
+		}
+#endif
+		return sfifo;
+	}
+
 	pthread_mutex_lock(&(sfifo_des_p->free_list.lock_mutex));
 #ifdef CONFIG_COND_FREE
 	while (sfifo_des_p->free_list.head == NULL) {
@@ -50,27 +248,33 @@ EXIT:
 	return sfifo;
 }
 
+struct sfifo_s* sfifo_wait_free_buf(struct sfifo_des_s *sfifo_des_p, int timeout_ms)
+{
+	if (sfifo_des_p->mode == SFIFO_MODE_RING)
+		return sfifo_ring_wait(&sfifo_des_p->free_ring, timeout_ms);
+
+	return sfifo_list_wait(&sfifo_des_p->free_list, timeout_ms);
+}
+
 int sfifo_put_free_buf(struct sfifo_s *sfifo, struct sfifo_des_s *sfifo_des_p)
 {
-	int send_cond = 0;
+	if (sfifo_des_p->mode == SFIFO_MODE_RING)
+		return sfifo_ring_put(&sfifo_des_p->free_ring, sfifo);
 
 	pthread_mutex_lock(&(sfifo_des_p->free_list.lock_mutex));
 	if (sfifo_des_p->free_list.head == NULL) {
 		sfifo_des_p->free_list.head = sfifo;
 		sfifo_des_p->free_list.tail = sfifo;
 		sfifo_des_p->free_list.tail->next = NULL;
-		send_cond = 1;
 	} else {
 		sfifo_des_p->free_list.tail->next = sfifo;
 		sfifo_des_p->free_list.tail = sfifo;
 		sfifo_des_p->free_list.tail->next = NULL;
 	}
 	pthread_mutex_unlock(&(sfifo_des_p->free_list.lock_mutex));
-#ifdef CONFIG_COND_FREE
-	if (send_cond) {
-		pthread_cond_signal(&(sfifo_des_p->free_list.cond));
-	}
-#endif
+	/* one buffer, one waiter: signal on every put, not only on the first
+	 * one into an empty list, or a second sfifo_wait_free_buf() sleeps on */
+	pthread_cond_signal(&(sfifo_des_p->free_list.cond));
 	return 0;
 }
 
@@ -78,6 +282,15 @@ struct sfifo_s* sfifo_get_active_buf(struct sfifo_des_s *sfifo_des_p)
 {
 	struct sfifo_s *sfifo = NULL;
 
+	if (sfifo_des_p->mode == SFIFO_MODE_RING) {
+#ifdef CONFIG_COND_ACTIVE
+		sfifo = sfifo_ring_wait(&sfifo_des_p->active_ring, SFIFO_WAIT_FOREVER);
+#else
+		sfifo = sfifo_ring_get(&sfifo_des_p->active_ring);
+#endif
+		return sfifo;
+	}
+
 	pthread_mutex_lock(&(sfifo_des_p->active_list.lock_mutex));
 #ifdef CONFIG_COND_ACTIVE
 	while (sfifo_des_p->active_list.head == NULL) {
@@ -100,10 +313,21 @@ EXIT:
 	return sfifo;
 }
 
+struct sfifo_s* sfifo_wait_active_buf(struct sfifo_des_s *sfifo_des_p, int timeout_ms)
+{
+	if (sfifo_des_p->mode == SFIFO_MODE_RING)
+		return sfifo_ring_wait(&sfifo_des_p->active_ring, timeout_ms);
+
+	return sfifo_list_wait(&sfifo_des_p->active_list, timeout_ms);
+}
+
 int sfifo_put_active_buf(struct sfifo_s *sfifo, struct sfifo_des_s *sfifo_des_p)
 {
 	int send_cond = 0;
 
+	if (sfifo_des_p->mode == SFIFO_MODE_RING)
+		return sfifo_ring_put(&sfifo_des_p->active_ring, sfifo);
+
 	pthread_mutex_lock(&(sfifo_des_p->active_list.lock_mutex));
 	if (sfifo_des_p->active_list.head == NULL) {
 		sfifo_des_p->active_list.head = sfifo;
@@ -141,6 +365,14 @@ int sfifo_reset(struct sfifo_des_s *sfifo_des_p)
 	int ret = 0;
 	struct sfifo_s *sfifo = NULL;
 
+	if (sfifo_des_p->mode == SFIFO_MODE_RING) {
+		while ((sfifo = sfifo_ring_get(&sfifo_des_p->active_ring)) != NULL) {
+			sfifo_ring_put(&sfifo_des_p->free_ring, sfifo);
+		}
+		ALOGD("sfifo ring reset sucess\n");
+		return 0;
+	}
+
 	ret = pthread_mutex_lock(&(sfifo_des_p->active_list.lock_mutex));
 	if (ret != 0) {
 		ALOGD("lock active_list.lock_mutex error\n");
@@ -191,16 +423,19 @@ struct sfifo_des_s *sfifo_init(int sfifo_num, int sfifo_buffer_size, int sfifo_a
 	struct sfifo_des_s *sfifo_des_p;
 	sfifo_des_p = (struct sfifo_des_s *)malloc(sizeof(struct sfifo_des_s));
 
+	sfifo_des_p->mode = SFIFO_MODE_LIST;
 	sfifo_des_p->sfifos_num = sfifo_num;
 	sfifo_des_p->sfifos_active_max_num = sfifo_active_max_num;
 
 	sfifo_des_p->free_list.sfifo_num = 0;
+	sfifo_des_p->free_list.kick = 0;
 	sfifo_des_p->free_list.head = NULL;
 	sfifo_des_p->free_list.tail = NULL;
 	pthread_mutex_init(&sfifo_des_p->free_list.lock_mutex, NULL);
 	pthread_cond_init(&sfifo_des_p->free_list.cond, NULL);
 
 	sfifo_des_p->active_list.sfifo_num = 0;
+	sfifo_des_p->active_list.kick = 0;
 	sfifo_des_p->active_list.head = NULL;
 	sfifo_des_p->active_list.tail = NULL;
 	pthread_mutex_init(&sfifo_des_p->active_list.lock_mutex, NULL);
@@ -212,6 +447,9 @@ struct sfifo_des_s *sfifo_init(int sfifo_num, int sfifo_buffer_size, int sfifo_a
 		ALOGD("sfifo_init: %x\n", sfifo->buffer);
 		memset(sfifo->buffer, i, sfifo_buffer_size);
 		sfifo->size = sfifo_buffer_size;
+		sfifo->index = -1;
+		sfifo->born = 0;
+		sfifo->stamp = 0;
 		sfifo->next = NULL;
 		sfifo_put_free_buf(sfifo, sfifo_des_p);
 	}
@@ -219,3 +457,42 @@ struct sfifo_des_s *sfifo_init(int sfifo_num, int sfifo_buffer_size, int sfifo_a
 	return sfifo_des_p;
 }
 
+struct sfifo_des_s *sfifo_ring_init(int sfifo_num, int sfifo_buffer_size, int sfifo_active_max_num)
+{
+	int i = 0;
+	struct sfifo_s *sfifo;
+
+	struct sfifo_des_s *sfifo_des_p;
+	sfifo_des_p = (struct sfifo_des_s *)calloc(1, sizeof(struct sfifo_des_s));
+	if (sfifo_des_p == NULL)
+		return NULL;
+
+	sfifo_des_p->mode = SFIFO_MODE_RING;
+	sfifo_des_p->sfifos_num = sfifo_num;
+	sfifo_des_p->sfifos_active_max_num = sfifo_active_max_num > sfifo_num ? sfifo_active_max_num : sfifo_num;
+
+	/* buffers not allocated here (index >= 0) may be queued as active too */
+	if (sfifo_ring_setup(&sfifo_des_p->free_ring, sfifo_num) < 0 ||
+	    sfifo_ring_setup(&sfifo_des_p->active_ring, sfifo_des_p->sfifos_active_max_num) < 0) {
+		ALOGD("sfifo_ring_init: slots alloc failed\n");
+		free(sfifo_des_p->free_ring.slots);
+		free(sfifo_des_p->active_ring.slots);
+		free(sfifo_des_p);
+		return NULL;
+	}
+
+	for (i = 0; i < sfifo_num; i++) {
+		sfifo = (struct sfifo_s *)malloc(sizeof(struct sfifo_s));
+		sfifo->buffer = (unsigned char *)malloc(sfifo_buffer_size);
+		ALOGD("sfifo_ring_init: %p\n", sfifo->buffer);
+		memset(sfifo->buffer, i, sfifo_buffer_size);
+		sfifo->size = sfifo_buffer_size;
+		sfifo->index = -1;
+		sfifo->born = 0;
+		sfifo->stamp = 0;
+		sfifo->next = NULL;
+		sfifo_ring_put(&sfifo_des_p->free_ring, sfifo);
+	}
+
+	return sfifo_des_p;
+}
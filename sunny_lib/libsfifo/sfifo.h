@@ -1,6 +1,11 @@
 #ifndef SFIFO_H_
 #define SFIFO_H_
 
+#define SFIFO_MODE_LIST		0	/* mutex + condvar linked lists */
+#define SFIFO_MODE_RING		1	/* lock-free single producer / single consumer rings */
+
+#define SFIFO_WAIT_FOREVER	(-1)
+
 struct sfifo_list_des_s {
 	int sfifo_num;
 
@@ -9,34 +14,64 @@ struct sfifo_list_des_s {
 
 	pthread_mutex_t lock_mutex;
 	pthread_cond_t cond;
+	int kick;
+};
+
+/*
+ * one direction of a ring mode sfifo. only one thread may put and only one
+ * thread may get. "seq" is bumped on every put and wakeup and is the futex
+ * word a blocked getter sleeps on, "waiters" tells whether a wake is needed.
+ */
+struct sfifo_ring_des_s {
+	volatile int head __attribute__((aligned(64)));	/* next slot to get, owned by the getter */
+	volatile int tail __attribute__((aligned(64)));	/* next slot to put, owned by the putter */
+	volatile int seq;
+	volatile int waiters;
+	volatile int kick;
+	unsigned int mask;
+	struct sfifo_s **slots;
 };
 
 struct sfifo_des_s {
 	int sfifo_init;
+	int mode;
 
 	unsigned int sfifos_num;
 	unsigned int sfifos_active_max_num;
 
 	struct sfifo_list_des_s free_list;
 	struct sfifo_list_des_s active_list;
+
+	struct sfifo_ring_des_s free_ring;
+	struct sfifo_ring_des_s active_ring;
 };
 
 struct sfifo_s {
 	unsigned char *buffer;
 	unsigned int size;
+	int index;		/* backing buffer index when not allocated by sfifo, -1 otherwise */
+	long long born;		/* telemetry: camera callback time, us */
+	long long stamp;	/* telemetry: time the frame passed its last stage, us */
 	struct sfifo_s *next;
 };
 
 extern struct sfifo_des_s *sfifo_init(int sfifo_num, int sfifo_buffer_size, int sfifo_active_max_num);
+extern struct sfifo_des_s *sfifo_ring_init(int sfifo_num, int sfifo_buffer_size, int sfifo_active_max_num);
 
 /* productor */
 extern struct sfifo_s* sfifo_get_free_buf(struct sfifo_des_s *sfifo_des_p);
+extern struct sfifo_s* sfifo_wait_free_buf(struct sfifo_des_s *sfifo_des_p, int timeout_ms);
 extern int sfifo_put_free_buf(struct sfifo_s *sfifo, struct sfifo_des_s *sfifo_des_p);
 
 /* consumer */
 extern struct sfifo_s* sfifo_get_active_buf(struct sfifo_des_s *sfifo_des_p);
+extern struct sfifo_s* sfifo_wait_active_buf(struct sfifo_des_s *sfifo_des_p, int timeout_ms);
 extern int sfifo_put_active_buf(struct sfifo_s *sfifo, struct sfifo_des_s *sfifo_des_p);
 
+/* make a blocked sfifo_wait_*_buf() return NULL right away */
+extern void sfifo_wakeup(struct sfifo_des_s *sfifo_des_p);
+
+/* ring mode: must be called while the consumer is not taking buffers */
 extern int sfifo_reset(struct sfifo_des_s *sfifo_des_p);
 
 #endif
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <utils/Log.h>
+
+#include "sfifo.h"
+
+/*
+ * sfifo hand-off micro-benchmark: one producer thread stamps and queues
+ * 640x480 NV12 sized buffers, one consumer thread takes them and records
+ * the put_active -> get_active latency. run once per sfifo mode.
+ */
+
+#define BENCH_FRAME_SIZE	(640 * 480 * 3 / 2)
+
+struct bench_arg {
+	struct sfifo_des_s *sfifo_des_p;
+	int frames;
+	int copy;
+	long long *latency;
+	unsigned char *frame;
+};
+
+static long long get_time_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+static int cmp_ll(const void *a, const void *b)
+{
+	long long x = *(const long long *)a;
+	long long y = *(const long long *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void* producer_thread(void *param)
+{
+	struct bench_arg *arg = (struct bench_arg *)param;
+	struct sfifo_s *sfifo;
+	long long stamp;
+	int i;
+
+	for (i = 0; i < arg->frames; i++) {
+		sfifo = sfifo_wait_free_buf(arg->sfifo_des_p, SFIFO_WAIT_FOREVER);
+		if (sfifo == NULL) {
+			printf("producer: no free buffer\n");
+			break;
+		}
+		if (arg->copy)
+			memcpy(sfifo->buffer + sizeof(stamp), arg->frame, BENCH_FRAME_SIZE);
+		stamp = get_time_ns();
+		memcpy(sfifo->buffer, &stamp, sizeof(stamp));
+		sfifo_put_active_buf(sfifo, arg->sfifo_des_p);
+	}
+
+	return NULL;
+}
+
+static void* consumer_thread(void *param)
+{
+	struct bench_arg *arg = (struct bench_arg *)param;
+	struct sfifo_s *sfifo;
+	long long stamp;
+	int i;
+
+	for (i = 0; i < arg->frames; i++) {
+		sfifo = sfifo_wait_active_buf(arg->sfifo_des_p, SFIFO_WAIT_FOREVER);
+		if (sfifo == NULL) {
+			printf("consumer: no active buffer\n");
+			break;
+		}
+		memcpy(&stamp, sfifo->buffer, sizeof(stamp));
+		arg->latency[i] = get_time_ns() - stamp;
+		sfifo_put_free_buf(sfifo, arg->sfifo_des_p);
+	}
+
+	return NULL;
+}
+
+static int run_bench(const char *name, struct sfifo_des_s *sfifo_des_p, int frames, int copy)
+{
+	struct bench_arg arg;
+	pthread_t ptid, ctid;
+	long long start, elapsed;
+
+	if (sfifo_des_p == NULL) {
+		printf("%s: sfifo init failed\n", name);
+		return -1;
+	}
+
+	memset(&arg, 0, sizeof(arg));
+	arg.sfifo_des_p = sfifo_des_p;
+	arg.frames = frames;
+	arg.copy = copy;
+	arg.latency = (long long *)calloc(frames, sizeof(long long));
+	arg.frame = (unsigned char *)malloc(BENCH_FRAME_SIZE);
+	if (arg.latency == NULL || arg.frame == NULL) {
+		free(arg.latency);
+		free(arg.frame);
+		return -1;
+	}
+	memset(arg.frame, 0x80, BENCH_FRAME_SIZE);
+
+	start = get_time_ns();
+	pthread_create(&ctid, NULL, consumer_thread, &arg);
+	pthread_create(&ptid, NULL, producer_thread, &arg);
+	pthread_join(ptid, NULL);
+	pthread_join(ctid, NULL);
+	elapsed = get_time_ns() - start;
+
+	qsort(arg.latency, frames, sizeof(long long), cmp_ll);
+	printf("%-6s frames=%d ops/sec=%.0f p50=%lldns p99=%lldns max=%lldns\n",
+	       name, frames, (double)frames * 1000000000.0 / elapsed,
+	       arg.latency[frames / 2], arg.latency[(long long)frames * 99 / 100],
+	       arg.latency[frames - 1]);
+
+	free(arg.latency);
+	free(arg.frame);
+	return 0;
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [-n frames] [-b buffers] [-c]\n", prog);
+	printf("  -n  number of frames to hand off (default 100000)\n");
+	printf("  -b  number of sfifo buffers (default 3)\n");
+	printf("  -c  copy a full frame into each buffer like postData does\n");
+}
+
+int main(int argc, char **argv)
+{
+	int frames = 100000;
+	int buffers = 3;
+	int copy = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:b:ch")) != -1) {
+		switch (opt) {
+		case 'n':
+			frames = atoi(optarg);
+			break;
+		case 'b':
+			buffers = atoi(optarg);
+			break;
+		case 'c':
+			copy = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	if (frames <= 0 || buffers <= 0) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	run_bench("list", sfifo_init(buffers, BENCH_FRAME_SIZE + sizeof(long long), buffers), frames, copy);
+	run_bench("ring", sfifo_ring_init(buffers, BENCH_FRAME_SIZE + sizeof(long long), buffers), frames, copy);
+
+	return 0;
+}
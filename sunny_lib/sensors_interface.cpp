@@ -7,6 +7,8 @@
 #include "imu_mpu6500.h"
 #include "uvc_stream.h"
 #include "uvc_interface.h"
+#include "stream_config.h"
+#include "telemetry.h"
 #include "log_tag.h"
 
 extern int camera_init(void);
@@ -15,6 +17,10 @@ extern void camera_uninit(void);
 int Sensors_Init(video_hdl* videohdl, imu_hdl* imuhdl)
 {
 	int ret = -1;
+
+	if (telemetry_init(TELEMETRY_SHM_PATH) < 0)
+		ALOGD("telemetry init failed!\n");
+
 	ret = camera_init();
 	if (ret < 0) {
 		ALOGD("camera init failed!\n");
@@ -35,6 +41,16 @@ int Sensors_Init(video_hdl* videohdl, imu_hdl* imuhdl)
 
 	return ret;
 }
+int Sensors_SetStreamConfig(const struct stream_config_s *cfg)
+{
+	return stream_config_init(cfg);
+}
+
+int Sensors_GetImuBundle(long long from_us, long long to_us, long long exposure_us, struct imu_bundle_s *bundle)
+{
+	return imu_get_bundle(from_us, to_us, exposure_us, bundle);
+}
+
 int get_sensors_mode(void)
 {
 	return get_device_mode() ;
@@ -44,6 +60,7 @@ void Sensors_Uninit(void)
 	camera_uninit();
 	imu_uninit();
 	uvc_uninit();
+	telemetry_uninit();
 	ALOGD("Now begin to rmmod the drives \n");
 }
 
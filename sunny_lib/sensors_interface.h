@@ -1,7 +1,23 @@
 #ifndef __SENSORS_INTERFACE_H__
 #define __SENSORS_INTERFACE_H__
 
+#include "imu_ring.h"
+
 int Sensors_Init(video_hdl*, imu_hdl*);
 int get_sensors_mode(void);
 int Sensors_Uninit(void);
+
+/*
+ * optional, before Sensors_Init(). without it the stream layout comes from
+ * the sunny.stream.* properties, or two 640x480 NV12 cameras.
+ */
+struct stream_config_s;
+int Sensors_SetStreamConfig(const struct stream_config_s *cfg);
+
+/*
+ * IMU samples between two frame timestamps (S_MetaData tv_sec/tv_usec in us)
+ * plus one interpolated at the exposure midpoint of the later frame, see
+ * struct imu_bundle_s.
+ */
+int Sensors_GetImuBundle(long long from_us, long long to_us, long long exposure_us, struct imu_bundle_s *bundle);
 #endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "libsfifo/sfifo.h"
+#include "stereo_sync.h"
+#include "log_tag.h"
+
+/*
+ * continuous frame grouping across cameras (left/right for the stereo pair).
+ * each camera keeps a small timestamp ordered window, the oldest frame of
+ * every camera is grouped when all of them are within max_skew, otherwise
+ * the oldest one can never find a partner any more and is dropped.
+ */
+
+static long long frame_timestamp(struct sfifo_s *sfifo)
+{
+	S_MetaData *meta = (S_MetaData *)sfifo->buffer;
+
+	return (long long)meta->tv_sec * 1000 * 1000 + meta->tv_usec;
+}
+
+static void window_drop_head(struct stereo_sync_s *sync, int side)
+{
+	struct stereo_window_s *win = &sync->side[side];
+	struct sfifo_s *sfifo = win->frames[0].sfifo;
+
+	win->num--;
+	memmove(&win->frames[0], &win->frames[1], win->num * sizeof(struct stereo_frame_s));
+
+	sync->stats.orphans[side]++;
+	if (sync->release != NULL)
+		sync->release(sfifo, side);
+}
+
+struct stereo_sync_s *stereo_sync_init(int nside, int window, long long max_skew_us, stereo_release_cb release)
+{
+	struct stereo_sync_s *sync;
+
+	if (nside <= 0 || nside > STEREO_SYNC_SIDE_MAX)
+		return NULL;
+
+	if (window <= 0 || window > STEREO_SYNC_WINDOW_MAX)
+		window = STEREO_SYNC_WINDOW_MAX;
+
+	sync = (struct stereo_sync_s *)calloc(1, sizeof(struct stereo_sync_s));
+	if (sync == NULL)
+		return NULL;
+
+	sync->nside = nside;
+	sync->window = window;
+	sync->max_skew = max_skew_us;
+	sync->release = release;
+
+	return sync;
+}
+
+void stereo_sync_uninit(struct stereo_sync_s *sync)
+{
+	if (sync == NULL)
+		return;
+
+	stereo_sync_flush(sync);
+	free(sync);
+}
+
+void stereo_sync_set_skew(struct stereo_sync_s *sync, long long max_skew_us)
+{
+	sync->max_skew = max_skew_us;
+}
+
+int stereo_sync_push(struct stereo_sync_s *sync, int side, struct sfifo_s *sfifo)
+{
+	struct stereo_window_s *win;
+	long long timestamp;
+	int i;
+
+	if (sync == NULL || sfifo == NULL || side < 0 || side >= sync->nside)
+		return -1;
+
+	win = &sync->side[side];
+	if (win->num >= sync->window)
+		window_drop_head(sync, side);
+
+	timestamp = frame_timestamp(sfifo);
+	for (i = win->num; i > 0 && win->frames[i - 1].timestamp > timestamp; i--)
+		win->frames[i] = win->frames[i - 1];
+
+	win->frames[i].sfifo = sfifo;
+	win->frames[i].timestamp = timestamp;
+	win->num++;
+
+	return 0;
+}
+
+int stereo_sync_pop(struct stereo_sync_s *sync, struct sfifo_s **frames)
+{
+	struct stereo_window_s *win;
+	long long skew;
+	int oldest, newest;
+	int side, bucket;
+
+	while (1) {
+		oldest = newest = 0;
+		for (side = 0; side < sync->nside; side++) {
+			if (sync->side[side].num == 0)
+				return -1;
+			if (sync->side[side].frames[0].timestamp < sync->side[oldest].frames[0].timestamp)
+				oldest = side;
+			if (sync->side[side].frames[0].timestamp > sync->side[newest].frames[0].timestamp)
+				newest = side;
+		}
+
+		skew = sync->side[newest].frames[0].timestamp - sync->side[oldest].frames[0].timestamp;
+		if (skew > sync->max_skew) {
+			window_drop_head(sync, oldest);
+			continue;
+		}
+
+		for (side = 0; side < sync->nside; side++) {
+			win = &sync->side[side];
+			frames[side] = win->frames[0].sfifo;
+			win->num--;
+			memmove(&win->frames[0], &win->frames[1], win->num * sizeof(struct stereo_frame_s));
+		}
+
+		bucket = (int)(skew / STEREO_SYNC_HIST_STEP_US);
+		if (bucket >= STEREO_SYNC_HIST_NUM)
+			bucket = STEREO_SYNC_HIST_NUM - 1;
+		sync->stats.skew_hist[bucket]++;
+		sync->stats.pairs++;
+
+		return 0;
+	}
+}
+
+int stereo_sync_count(struct stereo_sync_s *sync, int side)
+{
+	return sync->side[side].num;
+}
+
+/* give every held frame back, used on stream off */
+void stereo_sync_flush(struct stereo_sync_s *sync)
+{
+	int side, i;
+
+	for (side = 0; side < sync->nside; side++) {
+		for (i = 0; i < sync->side[side].num; i++) {
+			if (sync->release != NULL)
+				sync->release(sync->side[side].frames[i].sfifo, side);
+		}
+		sync->side[side].num = 0;
+	}
+}
+
+void stereo_sync_get_stats(struct stereo_sync_s *sync, struct stereo_sync_stats *stats)
+{
+	memcpy(stats, &sync->stats, sizeof(struct stereo_sync_stats));
+}
@@ -0,0 +1,55 @@
+#ifndef __STEREO_SYNC_H__
+#define __STEREO_SYNC_H__
+
+#define STEREO_LEFT					0
+#define STEREO_RIGHT				1
+
+#define STEREO_SYNC_SIDE_MAX		4
+#define STEREO_SYNC_WINDOW_MAX		8
+#define STEREO_SYNC_SKEW_US			500		/* default max left/right skew */
+#define STEREO_SYNC_HIST_STEP_US	100
+#define STEREO_SYNC_HIST_NUM		11		/* last bucket counts everything above */
+
+struct sfifo_s;
+
+/* frames dropped by the synchronizer are handed back through this, side is the camera index */
+typedef void (*stereo_release_cb)(struct sfifo_s *sfifo, int side);
+
+struct stereo_sync_stats {
+	unsigned long pairs;
+	unsigned long orphans[STEREO_SYNC_SIDE_MAX];
+	unsigned long skew_hist[STEREO_SYNC_HIST_NUM];
+};
+
+struct stereo_frame_s {
+	struct sfifo_s *sfifo;
+	long long timestamp;	/* us, from S_MetaData tv_sec/tv_usec */
+};
+
+struct stereo_window_s {
+	int num;
+	struct stereo_frame_s frames[STEREO_SYNC_WINDOW_MAX];	/* oldest first */
+};
+
+struct stereo_sync_s {
+	int nside;
+	int window;
+	long long max_skew;
+	stereo_release_cb release;
+	struct stereo_window_s side[STEREO_SYNC_SIDE_MAX];
+	struct stereo_sync_stats stats;
+};
+
+struct stereo_sync_s *stereo_sync_init(int nside, int window, long long max_skew_us, stereo_release_cb release);
+void stereo_sync_uninit(struct stereo_sync_s *sync);
+void stereo_sync_set_skew(struct stereo_sync_s *sync, long long max_skew_us);
+
+int stereo_sync_push(struct stereo_sync_s *sync, int side, struct sfifo_s *sfifo);
+/* frames[] gets one frame per side, -1 until every side has one within max_skew */
+int stereo_sync_pop(struct stereo_sync_s *sync, struct sfifo_s **frames);
+int stereo_sync_count(struct stereo_sync_s *sync, int side);
+void stereo_sync_flush(struct stereo_sync_s *sync);
+
+void stereo_sync_get_stats(struct stereo_sync_s *sync, struct stereo_sync_stats *stats);
+
+#endif
@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cutils/properties.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "stream_config.h"
+#include "log_tag.h"
+
+/*
+ * runtime description of the camera streams. everything that used to be
+ * sized for two 640x480 NV12 cameras (sfifo slots, gadget buffers,
+ * S_MetaData) is derived from here.
+ */
+
+#define STREAM_SFIFO_BUFS_MIN		3		/* sync window of two plus one for the producer */
+#define STREAM_PAGE_SIZE			4096
+
+struct stream_format_s {
+	const char *name;
+	int format;
+	int bpp;
+};
+
+static const struct stream_format_s stream_formats[] = {
+	{ "nv12",	NV12,			YUV_8 },
+	{ "yv12",	YV12,			YUV_8 },
+	{ "i420",	YUV420_I420,	YUV_8 },
+	{ "yuv422",	YUV422,			YUV_8 },
+	{ "mono",	MONO_8BIT,		YUV_8 },
+	{ "raw8",	BAYER_DEF,		YUV_8 },
+	{ "raw10",	BAYER_DEF,		RAW_10 },
+	{ "raw12",	BAYER_DEF,		RAW_12 },
+	{ "raw16",	BAYER_DEF,		RAW_16 },
+};
+
+#define STREAM_FORMAT_NUM			(sizeof(stream_formats) / sizeof(stream_formats[0]))
+
+/* the first two keep the ids the stereo module always had */
+static const int stream_meta_ids[STREAM_CAMERA_MAX] = { CAMERA_A, CAMERA_C, CAMERA_B, CAMERA_D };
+
+static struct stream_config_s stream_cfg;
+static BOOL b_stream_cfg_valid = FALSE;
+
+static void stream_config_default(struct stream_config_s *cfg)
+{
+	int i;
+
+	memset(cfg, 0, sizeof(*cfg));
+	cfg->num = 2;
+	cfg->sfifo_bufs = STREAM_SFIFO_BUFS_MIN;
+	cfg->gadget_bufs = 3 * cfg->num;
+	for (i = 0; i < cfg->num; i++) {
+		cfg->cam[i].id = i;
+		cfg->cam[i].meta_id = stream_meta_ids[i];
+		cfg->cam[i].width = 640;
+		cfg->cam[i].height = 480;
+		cfg->cam[i].format = NV12;
+		cfg->cam[i].bpp = YUV_8;
+		cfg->cam[i].fps = 30;
+	}
+}
+
+static int stream_camera_parse(struct stream_camera_s *cam, const char *str)
+{
+	const char *p;
+	unsigned int i;
+	int len;
+
+	if (sscanf(str, "%dx%d", &cam->width, &cam->height) != 2)
+		return -1;
+	if (cam->width <= 0 || cam->height <= 0)
+		return -1;
+
+	cam->format = NV12;
+	cam->bpp = YUV_8;
+	cam->fps = 30;
+
+	p = strchr(str, ':');
+	if (p != NULL) {
+		p++;
+		len = strcspn(p, "@");
+		for (i = 0; i < STREAM_FORMAT_NUM; i++) {
+			if ((int)strlen(stream_formats[i].name) == len &&
+			    strncmp(p, stream_formats[i].name, len) == 0)
+				break;
+		}
+		if (i == STREAM_FORMAT_NUM)
+			return -1;
+		cam->format = stream_formats[i].format;
+		cam->bpp = stream_formats[i].bpp;
+	}
+
+	p = strchr(str, '@');
+	if (p != NULL) {
+		cam->fps = atoi(p + 1);
+		if (cam->fps <= 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+/* "WxH[:fmt][@fps],..." one entry per camera, camera id is the position */
+int stream_config_parse(struct stream_config_s *cfg, const char *str)
+{
+	struct stream_camera_s cam[STREAM_CAMERA_MAX];
+	char buf[PROPERTY_VALUE_MAX];
+	char *tok, *save;
+	int num = 0;
+
+	strncpy(buf, str, sizeof(buf) - 1);
+	buf[sizeof(buf) - 1] = '\0';
+
+	for (tok = strtok_r(buf, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+		if (num >= STREAM_CAMERA_MAX) {
+			ALOGD("stream cfg: more than %d cameras\n", STREAM_CAMERA_MAX);
+			return -1;
+		}
+		if (stream_camera_parse(&cam[num], tok) < 0) {
+			ALOGD("stream cfg: bad camera \"%s\"\n", tok);
+			return -1;
+		}
+		cam[num].id = num;
+		cam[num].meta_id = stream_meta_ids[num];
+		num++;
+	}
+
+	if (num == 0)
+		return -1;
+
+	memcpy(cfg->cam, cam, num * sizeof(struct stream_camera_s));
+	cfg->num = num;
+	return 0;
+}
+
+/* cfg NULL: defaults, overridden by the sunny.stream.* properties */
+int stream_config_init(const struct stream_config_s *cfg)
+{
+	char value[PROPERTY_VALUE_MAX];
+	struct stream_config_s tmp;
+
+	if (cfg != NULL) {
+		tmp = *cfg;
+	} else {
+		stream_config_default(&tmp);
+
+		if (property_get(STREAM_PROP_CAMERAS, value, NULL) > 0) {
+			if (stream_config_parse(&tmp, value) < 0)
+				return -1;
+			tmp.gadget_bufs = 3 * tmp.num;
+		}
+		if (property_get(STREAM_PROP_SFIFO_BUFS, value, NULL) > 0)
+			tmp.sfifo_bufs = atoi(value);
+		if (property_get(STREAM_PROP_GADGET_BUFS, value, NULL) > 0)
+			tmp.gadget_bufs = atoi(value);
+	}
+
+	if (tmp.num <= 0 || tmp.num > STREAM_CAMERA_MAX || tmp.gadget_bufs <= 0) {
+		ALOGD("stream cfg: invalid camera/buffer count\n");
+		return -1;
+	}
+	if (tmp.sfifo_bufs < STREAM_SFIFO_BUFS_MIN)
+		tmp.sfifo_bufs = STREAM_SFIFO_BUFS_MIN;
+
+	stream_cfg = tmp;
+	b_stream_cfg_valid = TRUE;
+	return 0;
+}
+
+const struct stream_config_s *stream_config_get(void)
+{
+	if (!b_stream_cfg_valid && stream_config_init(NULL) < 0) {
+		ALOGD("stream cfg: falling back to the default configuration\n");
+		stream_config_default(&stream_cfg);
+		b_stream_cfg_valid = TRUE;
+	}
+
+	return &stream_cfg;
+}
+
+unsigned int stream_frame_size(const struct stream_camera_s *cam)
+{
+	unsigned int pixels = cam->width * cam->height;
+
+	switch (cam->format) {
+	case NV12:
+	case YV12:
+	case YUV420_I420:
+		return pixels * 3 / 2;
+	case YUV422:
+		return pixels * 2;
+	case MONO_8BIT:
+		return pixels;
+	default:
+		/* bayer, raw10/raw12 are packed */
+		return pixels * cam->bpp / 8;
+	}
+}
+
+unsigned int stream_slot_size(const struct stream_camera_s *cam)
+{
+	return HEAD_LEN + stream_frame_size(cam);
+}
+
+unsigned int stream_max_slot_size(const struct stream_config_s *cfg)
+{
+	unsigned int size, max = 0;
+	int i;
+
+	for (i = 0; i < cfg->num; i++) {
+		size = stream_slot_size(&cfg->cam[i]);
+		if (size > max)
+			max = size;
+	}
+
+	return max;
+}
+
+/* every camera frame goes out in its own gadget buffer */
+unsigned int stream_gadget_buf_size(const struct stream_config_s *cfg)
+{
+	return stream_max_slot_size(cfg) + STREAM_GADGET_HEAD_LEN;
+}
+
+void stream_meta_init(const struct stream_camera_s *cam, S_MetaData *meta)
+{
+	memset(meta, 0, sizeof(*meta));
+	meta->cameraNum = cam->meta_id;
+	meta->width = cam->width;
+	meta->height = cam->height;
+	meta->bpp = cam->bpp;
+	meta->dataFormat = cam->format;
+	meta->headerLength = HEAD_LEN;
+}
+
+/* ezy_buf allocates power of two page blocks */
+static unsigned int contig_alloc_size(unsigned int size)
+{
+	unsigned int alloc = STREAM_PAGE_SIZE;
+
+	while (alloc < size)
+		alloc <<= 1;
+
+	return alloc;
+}
+
+/* startup self check, logs what this configuration keeps resident */
+int stream_config_check(const struct stream_config_s *cfg, unsigned int gadget_size, unsigned int gadget_headlen)
+{
+	unsigned long long sfifo_total = 0, rate = 0;
+	unsigned long long gadget_total;
+	unsigned int slot;
+	int i, ret = 0;
+
+	ALOGD("stream cfg: %d camera(s)\n", cfg->num);
+	for (i = 0; i < cfg->num; i++) {
+		slot = stream_slot_size(&cfg->cam[i]);
+		sfifo_total += (unsigned long long)slot * cfg->sfifo_bufs;
+		rate += (unsigned long long)slot * cfg->cam[i].fps;
+		ALOGD("  cam%d: id=%d %dx%d fmt=%d bpp=%d %dfps slot=%u\n", i, cfg->cam[i].id,
+		      cfg->cam[i].width, cfg->cam[i].height, cfg->cam[i].format, cfg->cam[i].bpp,
+		      cfg->cam[i].fps, slot);
+
+		if (slot > gadget_size - gadget_headlen) {
+			ALOGD("  cam%d: slot does not fit the %u byte gadget buffer\n", i, gadget_size - gadget_headlen);
+			ret = -1;
+		}
+	}
+
+	gadget_total = (unsigned long long)contig_alloc_size(gadget_size) * cfg->gadget_bufs;
+	ALOGD("  sfifo:  %d x %d bufs, %llu KB\n", cfg->num, cfg->sfifo_bufs, sfifo_total / 1024);
+	ALOGD("  gadget: %d x %u bytes (%u pinned), %llu KB\n", cfg->gadget_bufs, gadget_size,
+	      contig_alloc_size(gadget_size), gadget_total / 1024);
+	ALOGD("  total pinned %llu KB, uvc payload %llu KB/s\n", (sfifo_total + gadget_total) / 1024, rate / 1024);
+
+	return ret;
+}
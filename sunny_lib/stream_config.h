@@ -0,0 +1,73 @@
+#ifndef __STREAM_CONFIG_H__
+#define __STREAM_CONFIG_H__
+
+#include "typedef.h"
+
+#define STREAM_CAMERA_MAX			4
+#define STREAM_GADGET_HEAD_LEN		20		/* EZY_HEAD_LEN of the gadget ezy_buf queue */
+
+/* property overrides, read once by stream_config_init() */
+#define STREAM_PROP_CAMERAS			"sunny.stream.cameras"		/* e.g. "640x480:nv12@30,640x480:nv12@30" */
+#define STREAM_PROP_SFIFO_BUFS		"sunny.stream.sfifo_bufs"
+#define STREAM_PROP_GADGET_BUFS		"sunny.stream.gadget_bufs"
+
+/* S_MetaData.cameraNum */
+enum {
+	CAMERA_A,
+	CAMERA_B,
+	CAMERA_C,
+	CAMERA_D,
+};
+
+/* S_MetaData.bpp */
+enum {
+	YUV_8 = 8,
+	RAW_10 = 10,
+	RAW_12 = 12,
+	RAW_16 = 16,
+};
+
+/* S_MetaData.dataFormat */
+enum {
+	BAYER_DEF = 0,
+	BAYER_GBRG = 0,
+	BAYER_RGGB = 1,
+	BAYER_BGGR = 2,
+	BAYER_GRBG = 3,
+	YUV422 = 4,
+	YUV420_I420 = 5,
+	MONO_8BIT = 6,
+	YV12 = 7,
+	NV12 = 8,
+};
+
+struct stream_camera_s {
+	int id;				/* android camera id */
+	int meta_id;		/* S_MetaData.cameraNum */
+	int width;
+	int height;
+	int format;			/* S_MetaData.dataFormat */
+	int bpp;			/* S_MetaData.bpp */
+	int fps;
+};
+
+struct stream_config_s {
+	int num;
+	int sfifo_bufs;		/* per camera */
+	int gadget_bufs;
+	struct stream_camera_s cam[STREAM_CAMERA_MAX];
+};
+
+int stream_config_init(const struct stream_config_s *cfg);
+const struct stream_config_s *stream_config_get(void);
+int stream_config_parse(struct stream_config_s *cfg, const char *str);
+
+unsigned int stream_frame_size(const struct stream_camera_s *cam);
+unsigned int stream_slot_size(const struct stream_camera_s *cam);
+unsigned int stream_max_slot_size(const struct stream_config_s *cfg);
+unsigned int stream_gadget_buf_size(const struct stream_config_s *cfg);
+void stream_meta_init(const struct stream_camera_s *cam, S_MetaData *meta);
+
+int stream_config_check(const struct stream_config_s *cfg, unsigned int gadget_size, unsigned int gadget_headlen);
+
+#endif
@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "libsfifo/sfifo.h"
+#include "telemetry.h"
+#include "log_tag.h"
+
+/*
+ * pipeline telemetry. all updates are relaxed atomic adds on a page that
+ * can be file backed, so telemetry_dump or any other process can read it
+ * while sunny_lib runs. when telemetry_init was not called every hook
+ * returns at once.
+ */
+
+static const char *stage_names[TELEM_STAGE_NUM] = {
+	"cam_cb",
+	"sfifo_enq",
+	"pair",
+	"cb_enter",
+	"cb_exit",
+	"qbuf",
+	"e2e",
+};
+
+static struct telem_shm_s *telem = NULL;
+static BOOL b_telem_mapped = FALSE;
+static long long cam_last[TELEM_CAMERA_MAX];
+
+static int telem_bucket(unsigned long long us)
+{
+	int bits;
+
+	if (us < (1ULL << TELEM_SUB_BITS))
+		return (int)us;
+
+	bits = 63 - __builtin_clzll(us);
+	if (bits > TELEM_MAX_BITS)
+		return TELEM_BUCKETS - 1;
+
+	return ((bits - TELEM_SUB_BITS + 1) << TELEM_SUB_BITS) +
+	       (int)((us >> (bits - TELEM_SUB_BITS)) & ((1 << TELEM_SUB_BITS) - 1));
+}
+
+/* lowest value that lands in bucket idx */
+static unsigned long long telem_bucket_value(int idx)
+{
+	int bits;
+
+	if (idx < (1 << TELEM_SUB_BITS))
+		return idx;
+
+	bits = (idx >> TELEM_SUB_BITS) + TELEM_SUB_BITS - 1;
+	return (1ULL << bits) + ((unsigned long long)(idx & ((1 << TELEM_SUB_BITS) - 1)) << (bits - TELEM_SUB_BITS));
+}
+
+int telemetry_init(const char *path)
+{
+	int fd;
+
+	if (telem != NULL)
+		return 0;
+
+	if (path != NULL) {
+		fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (fd >= 0 && ftruncate(fd, sizeof(struct telem_shm_s)) == 0) {
+			telem = (struct telem_shm_s *)mmap(NULL, sizeof(struct telem_shm_s),
+			                                   PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (telem == MAP_FAILED)
+				telem = NULL;
+			else
+				b_telem_mapped = TRUE;
+		}
+		if (fd >= 0)
+			close(fd);
+		if (telem == NULL)
+			ALOGD("telemetry: cannot map %s, keeping it private\n", path);
+	}
+
+	if (telem == NULL) {
+		telem = (struct telem_shm_s *)calloc(1, sizeof(struct telem_shm_s));
+		if (telem == NULL)
+			return -1;
+	}
+
+	memset(telem, 0, sizeof(struct telem_shm_s));
+	memset(cam_last, 0, sizeof(cam_last));
+	telem->version = TELEMETRY_VERSION;
+	telem->stage_num = TELEM_STAGE_NUM;
+	telem->bucket_num = TELEM_BUCKETS;
+	telem->start_us = telemetry_now();
+	__atomic_store_n(&telem->magic, TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+void telemetry_uninit(void)
+{
+	struct telem_shm_s *t = telem;
+
+	if (t == NULL)
+		return;
+
+	telem = NULL;
+	if (b_telem_mapped)
+		munmap(t, sizeof(struct telem_shm_s));
+	else
+		free(t);
+	b_telem_mapped = FALSE;
+}
+
+long long telemetry_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+void telemetry_record(int stage, long long us)
+{
+	struct telem_hist_s *hist;
+	unsigned long long max;
+
+	if (telem == NULL || stage < 0 || stage >= TELEM_STAGE_NUM)
+		return;
+
+	if (us < 0)
+		us = 0;
+
+	hist = &telem->stages[stage];
+	__atomic_fetch_add(&hist->buckets[telem_bucket(us)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&hist->sum, (unsigned long long)us, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+
+	max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+	while ((unsigned long long)us > max &&
+	       !__atomic_compare_exchange_n(&hist->max, &max, (unsigned long long)us, 1,
+	                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+void telemetry_drop(int stage)
+{
+	if (telem == NULL || stage < 0 || stage >= TELEM_STAGE_NUM)
+		return;
+
+	__atomic_fetch_add(&telem->stages[stage].drops, 1, __ATOMIC_RELAXED);
+}
+
+/* camera callback entry, returns the time to hand to telemetry_frame_start */
+long long telemetry_frame_begin(int cam)
+{
+	long long now;
+
+	if (telem == NULL)
+		return 0;
+
+	now = telemetry_now();
+	if (cam >= 0 && cam < TELEM_CAMERA_MAX) {
+		if (cam_last[cam] != 0)
+			telemetry_record(TELEM_CAM_CB, now - cam_last[cam]);
+		cam_last[cam] = now;
+	}
+
+	return now;
+}
+
+void telemetry_frame_start(struct sfifo_s *sfifo, long long t_us)
+{
+	sfifo->born = t_us;
+	sfifo->stamp = t_us;
+}
+
+void telemetry_stamp(struct sfifo_s *sfifo, int stage)
+{
+	long long now;
+
+	if (telem == NULL || sfifo == NULL)
+		return;
+
+	now = telemetry_now();
+	telemetry_record(stage, now - sfifo->stamp);
+	sfifo->stamp = now;
+}
+
+void telemetry_frame_done(struct sfifo_s *sfifo)
+{
+	if (telem == NULL || sfifo == NULL || sfifo->born == 0)
+		return;
+
+	telemetry_record(TELEM_E2E, telemetry_now() - sfifo->born);
+}
+
+const char *telemetry_stage_name(int stage)
+{
+	if (stage < 0 || stage >= TELEM_STAGE_NUM)
+		return "?";
+
+	return stage_names[stage];
+}
+
+long long telemetry_percentile(const struct telem_hist_s *hist, double p)
+{
+	unsigned long long target, seen = 0;
+	int i;
+
+	if (hist->count == 0)
+		return 0;
+
+	target = (unsigned long long)(hist->count * p / 100.0);
+	if (target >= hist->count)
+		target = hist->count - 1;
+
+	for (i = 0; i < TELEM_BUCKETS; i++) {
+		seen += hist->buckets[i];
+		if (seen > target)
+			return (long long)telem_bucket_value(i);
+	}
+
+	return (long long)hist->max;
+}
+
+const struct telem_shm_s *telemetry_get(void)
+{
+	return telem;
+}
+
+void telemetry_dump(const struct telem_shm_s *shm)
+{
+	const struct telem_hist_s *hist;
+	int i;
+
+	if (shm == NULL)
+		return;
+
+	for (i = 0; i < TELEM_STAGE_NUM; i++) {
+		hist = &shm->stages[i];
+		ALOGD("telem %-9s n=%llu mean=%lldus p50=%lldus p99=%lldus max=%lluus drops=%llu\n",
+		      telemetry_stage_name(i), hist->count,
+		      hist->count ? (long long)(hist->sum / hist->count) : 0LL,
+		      telemetry_percentile(hist, 50), telemetry_percentile(hist, 99),
+		      hist->max, hist->drops);
+	}
+}
@@ -0,0 +1,69 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#define TELEMETRY_SHM_PATH		"/data/sunny_telemetry"
+#define TELEMETRY_MAGIC			0x54454c4d		/* "TELM" */
+#define TELEMETRY_VERSION		1
+
+/*
+ * log-linear (HDR style) buckets: values below 2^TELEM_SUB_BITS us get a
+ * bucket each, every power of two above is split in 2^TELEM_SUB_BITS
+ * buckets, so the error stays below 12.5% up to ~67s.
+ */
+#define TELEM_SUB_BITS			3
+#define TELEM_MAX_BITS			26
+#define TELEM_BUCKETS			((TELEM_MAX_BITS - TELEM_SUB_BITS + 2) << TELEM_SUB_BITS)
+
+#define TELEM_CAMERA_MAX		4
+
+/* each stage histograms the time since the frame passed the previous one */
+enum telem_stage {
+	TELEM_CAM_CB,		/* camera callback, interval to the previous frame of that camera */
+	TELEM_SFIFO_ENQ,	/* callback entry -> sfifo_put_active_buf */
+	TELEM_PAIR,			/* enqueue -> grouped with the other cameras */
+	TELEM_CB_ENTER,		/* grouped -> g_fpvideo_cb entry */
+	TELEM_CB_EXIT,		/* g_fpvideo_cb duration */
+	TELEM_QBUF,			/* previous stage -> EZY_QBUF done */
+	TELEM_E2E,			/* camera callback -> handed to the gadget or the user */
+	TELEM_STAGE_NUM,
+};
+
+struct sfifo_s;
+
+struct telem_hist_s {
+	unsigned long long count;
+	unsigned long long sum;		/* us */
+	unsigned long long max;
+	unsigned long long drops;
+	unsigned int buckets[TELEM_BUCKETS];
+};
+
+/* layout of TELEMETRY_SHM_PATH, counters only ever grow */
+struct telem_shm_s {
+	unsigned int magic;
+	unsigned int version;
+	unsigned int stage_num;
+	unsigned int bucket_num;
+	long long start_us;
+	struct telem_hist_s stages[TELEM_STAGE_NUM];
+};
+
+int telemetry_init(const char *path);
+void telemetry_uninit(void);
+
+long long telemetry_now(void);
+void telemetry_record(int stage, long long us);
+void telemetry_drop(int stage);
+
+/* frame bookkeeping, the timestamps live in the sfifo */
+long long telemetry_frame_begin(int cam);
+void telemetry_frame_start(struct sfifo_s *sfifo, long long t_us);
+void telemetry_stamp(struct sfifo_s *sfifo, int stage);
+void telemetry_frame_done(struct sfifo_s *sfifo);
+
+const char *telemetry_stage_name(int stage);
+long long telemetry_percentile(const struct telem_hist_s *hist, double p);
+void telemetry_dump(const struct telem_shm_s *shm);
+const struct telem_shm_s *telemetry_get(void);
+
+#endif
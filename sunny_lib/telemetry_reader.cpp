@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <utils/Log.h>
+
+#include "telemetry.h"
+
+/*
+ * prints the pipeline telemetry sunny_lib keeps in TELEMETRY_SHM_PATH,
+ * once or every -i seconds, while the stream keeps running.
+ */
+
+static void print_stages(const struct telem_shm_s *shm)
+{
+	const struct telem_hist_s *hist;
+	long long uptime;
+	int i;
+
+	uptime = telemetry_now() - shm->start_us;
+	printf("uptime %lld.%03llds\n", uptime / 1000000, (uptime / 1000) % 1000);
+	printf("%-10s %10s %8s %8s %8s %8s %8s %8s\n",
+	       "stage", "count", "mean", "p50", "p90", "p99", "max", "drops");
+
+	for (i = 0; i < TELEM_STAGE_NUM; i++) {
+		hist = &shm->stages[i];
+		printf("%-10s %10llu %8lld %8lld %8lld %8lld %8llu %8llu\n",
+		       telemetry_stage_name(i), hist->count,
+		       hist->count ? (long long)(hist->sum / hist->count) : 0LL,
+		       telemetry_percentile(hist, 50), telemetry_percentile(hist, 90),
+		       telemetry_percentile(hist, 99), hist->max, hist->drops);
+	}
+	printf("(us)\n");
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [-f file] [-i seconds]\n", prog);
+	printf("  -f  telemetry file (default %s)\n", TELEMETRY_SHM_PATH);
+	printf("  -i  repeat every n seconds\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = TELEMETRY_SHM_PATH;
+	const struct telem_shm_s *shm;
+	int interval = 0;
+	int fd, opt;
+
+	while ((opt = getopt(argc, argv, "f:i:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			path = optarg;
+			break;
+		case 'i':
+			interval = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("failed to open %s\n", path);
+		return -1;
+	}
+
+	shm = (const struct telem_shm_s *)mmap(NULL, sizeof(struct telem_shm_s), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (shm == MAP_FAILED) {
+		printf("failed to map %s\n", path);
+		return -1;
+	}
+
+	if (shm->magic != TELEMETRY_MAGIC || shm->version != TELEMETRY_VERSION ||
+	    shm->stage_num != TELEM_STAGE_NUM || shm->bucket_num != TELEM_BUCKETS) {
+		printf("%s: unknown telemetry layout\n", path);
+		munmap((void *)shm, sizeof(struct telem_shm_s));
+		return -1;
+	}
+
+	do {
+		print_stages(shm);
+		if (interval > 0)
+			sleep(interval);
+	} while (interval > 0);
+
+	munmap((void *)shm, sizeof(struct telem_shm_s));
+	return 0;
+}
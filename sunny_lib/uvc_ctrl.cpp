@@ -1,4 +1,5 @@
 #include <sys/ioctl.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <pthread.h>
@@ -6,10 +7,13 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <time.h>
+#include <sys/epoll.h>
 #include <utils/Log.h>
 #include "typedef.h"
 #include "uvc_ctrl.h"
 #include "uvc_stream.h"
+#include "imu_batch.h"
 #include "libmsg/msg_util.h"
 #include "log_tag.h"
 #include "device_mode.h"
@@ -18,6 +22,7 @@
 #define	CTRL_IOC_BASE			'C'
 #define	CTRL_SET_CMD			_IOW(CTRL_IOC_BASE,  1, struct imu_data *)
 #define	CTRL_GET_CMD			_IOR(CTRL_IOC_BASE,  2, struct uvc_cmd *)
+#define	CTRL_SET_IMU_BATCH		_IOW(CTRL_IOC_BASE,  3, struct imu_batch *)
 
 
 #define DEVICE_CMD_UNKNOWN		0x00
@@ -28,6 +33,8 @@
 #define DEVICE_BURN_MODE		0x05
 #define DEVICE_FRAME_INFO		0x06
 
+#define UVC_CTRL_EPOLL_EVENTS	4
+
 static	int videoFd = -1;
 static  pthread_t uvcgetctrl_tid;
 
@@ -38,7 +45,8 @@ video_cb g_fpvideo_cb;
 imu_cb   g_fpimu_cb;
 static video_hdl g_videohdl;
 static imu_hdl   g_imuhdl;
-extern bool b_diskmode_flag;
+static struct imu_batcher_s imu_batcher;
+static BOOL b_imu_batch = TRUE;
 
 int  imu_uvc_process(struct imu_data *data);
 
@@ -80,6 +88,40 @@ int uvcctrl_put_data(struct imu_data *data)
 	return ioctl(videoFd, CTRL_SET_CMD, data);
 }
 
+static int uvcctrl_put_batch(struct imu_batch *batch)
+{
+	return ioctl(videoFd, CTRL_SET_IMU_BATCH, batch);
+}
+
+static long long get_time_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+/* num <= 1 goes back to one CTRL_SET_CMD per sample */
+void uvcctrl_set_imu_batch(int num, long long max_us)
+{
+	imu_function_lock();
+	if (b_imu_batch)
+		imu_batcher_flush(&imu_batcher);
+	b_imu_batch = (num > 1) ? TRUE : FALSE;
+	imu_batcher_init(&imu_batcher, num, max_us, uvcctrl_put_batch);
+	imu_function_unlock();
+}
+
+int uvcctrl_get_imu_batch_stats(struct imu_batch_stats *stats)
+{
+	if (stats == NULL)
+		return -1;
+
+	imu_function_lock();
+	*stats = imu_batcher.stats;
+	imu_function_unlock();
+	return 0;
+}
+
 void imu_function_lock(void)
 {
 	pthread_mutex_lock(&imufp_lock_mutex);
@@ -105,91 +147,145 @@ unsigned int sensor_mode0_handle(unsigned char *l_buf, unsigned int l_len, unsig
 	return 0;
 }
 
-static void* uvcctrl_cmd_process(void* arg)
+static int uvcctrl_cmd_handle(struct uvc_cmd *cmd)
 {
-	struct uvc_cmd cmd;
-	int ret = -1;
-	void *tmp;
-	tmp = arg;
-	int quit_flag = 0;
-
-	while (1) {
-
-		ret = uvcctrl_cmd_get(&cmd);
-		if (ret < 0) {
-			ALOGD("uvcctrl_cmdget() error\n");
+	switch (cmd->cmd) {
+	case DEVICE_PW_SV:
+		ALOGD("DEVICE_PW_SV \n");
+		uvcstream_off();
+		break;
+
+	case DEVICE_PW_ON:
+		printf("DEVICE_PW_ON \n");
+		uvcstream_on();
+		break;
+
+	case DEVICE_DISK_MODE:
+		printf("DEVICE_DISK_MODE\n");
+		/* finished in uvcctrl_cmd_process() on UVC_EVENT_DISK_MODE */
+		set_device_mode(DISK_MODE);
+		uvcstream_wakeup();
+		break;
+
+	case DEVICE_BURN_MODE:
+		printf("DEVICE_BURN_MODE \n");
+		printf("Now we are going to reboot........... \n");
+		system("reboot loader\n");
+		break;
+
+	case DEVICE_VIDEO_MODE:
+		if (cmd->data == SENSOR_MODE0) {
+			set_device_mode(cmd->data);
+			printf("Video OffLine Mode \n");
+			video_function_lock();
+			g_fpvideo_cb = sensor_mode0_handle;
+			video_function_unlock();
+			imu_function_lock();
+			g_fpimu_cb = imu_uvc_process;
+			imu_function_unlock();
+		} else if (cmd->data == SENSOR_MODE1) {
+			set_device_mode(cmd->data);
+			printf("Video OnLine Mode \n");
+			if (g_videohdl.callback != NULL) {
+				video_function_lock();
+				g_fpvideo_cb = g_videohdl.callback;
+				video_function_unlock();
+			}
+			if (g_imuhdl.callback != NULL) {
+				imu_function_lock();
+				g_fpimu_cb = g_imuhdl.callback;
+				imu_function_unlock();
+			}
 		}
+		break;
 
-		switch (cmd.cmd) {
-		case DEVICE_PW_SV:
-			ALOGD("DEVICE_PW_SV \n");
-			uvcstream_off();
-			break;
+	default :
+		break;
+	}
 
-		case DEVICE_PW_ON:
-			printf("DEVICE_PW_ON \n");
-			uvcstream_on();
-			break;
+	return 0;
+}
 
-		case DEVICE_DISK_MODE:
-			printf("DEVICE_DISK_MODE\n");
-			set_device_mode(DISK_MODE);
-			do{
-				usleep(100);
-			}while(!b_diskmode_flag);
-
-			msg_send();
-			msg_uninit();
-			ALOGD("uvcstream_getmode quit_flag=1\n");
-			quit_flag=1;
-			break;
+static int uvcctrl_epoll_add(int epfd, int fd)
+{
+	struct epoll_event ev;
 
-		case DEVICE_BURN_MODE:
-			printf("DEVICE_BURN_MODE \n");
-			printf("Now we are going to reboot........... \n");
-			system("reboot loader\n");
-			break;
+	if (fd < 0)
+		return -1;
 
-		case DEVICE_VIDEO_MODE:
-			if (cmd.data == SENSOR_MODE0) {
-				set_device_mode(cmd.data);
-				printf("Video OffLine Mode \n");
-				video_function_lock();
-				g_fpvideo_cb = sensor_mode0_handle;
-				video_function_unlock();
-				imu_function_lock();
-				g_fpimu_cb = imu_uvc_process;
-				imu_function_unlock();
-			} else if (cmd.data == SENSOR_MODE1) {
-				set_device_mode(cmd.data);
-				printf("Video OnLine Mode \n");
-				if (g_videohdl.callback != NULL){
-					video_function_lock();
-				if (g_videohdl.callback != NULL)
-					g_fpvideo_cb = g_videohdl.callback;
-					video_function_unlock();
-				}
-				if (g_imuhdl.callback != NULL){
-					imu_function_lock();
-					g_fpimu_cb = g_imuhdl.callback;
-					imu_function_unlock();
-					}
-			}
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
 
-			break;
+/*
+ * one loop for the gadget command queue, stream state events from
+ * video_stream_thread and the msg socket, nothing here sleeps or polls
+ */
+static void* uvcctrl_cmd_process(void* arg)
+{
+	struct epoll_event events[UVC_CTRL_EPOLL_EVENTS];
+	struct uvc_cmd cmd;
+	int epfd, msgfd;
+	int ret, num, i;
+	int quit_flag = 0;
+	void *tmp;
+	tmp = arg;
 
-		default :
-			break;
-		}
+	epfd = epoll_create(UVC_CTRL_EPOLL_EVENTS);
+	if (epfd < 0) {
+		ALOGD("uvcctrl epoll create failed!\n");
+		return NULL;
+	}
 
-		if (quit_flag == 1) {
-			ALOGD("uvc ctrl break\n");
+	msgfd = msg_get_fd();
+	if (uvcctrl_epoll_add(epfd, videoFd) < 0)
+		ALOGD("epoll add %s failed!\n", VIDEO_CMD_DEVICE);
+	if (uvcctrl_epoll_add(epfd, uvcstream_event_fd()) < 0)
+		ALOGD("epoll add uvcstream event failed!\n");
+	if (uvcctrl_epoll_add(epfd, msgfd) < 0)
+		ALOGD("epoll add msg socket failed!\n");
+
+	while (!quit_flag) {
+		num = epoll_wait(epfd, events, UVC_CTRL_EPOLL_EVENTS, -1);
+		if (num < 0) {
+			if (errno == EINTR)
+				continue;
+			ALOGD("uvcctrl epoll_wait error %d\n", errno);
 			break;
 		}
 
-		usleep(10 * 1000);
+		for (i = 0; i < num && !quit_flag; i++) {
+			if (events[i].data.fd == videoFd) {
+				ret = uvcctrl_cmd_get(&cmd);
+				if (ret < 0) {
+					ALOGD("uvcctrl_cmdget() error\n");
+					continue;
+				}
+				uvcctrl_cmd_handle(&cmd);
+			} else if (events[i].data.fd == uvcstream_event_fd()) {
+				if (uvcstream_event_process() != UVC_EVENT_DISK_MODE)
+					continue;
+
+				msg_send();
+				epoll_ctl(epfd, EPOLL_CTL_DEL, msgfd, NULL);
+				msg_uninit();
+				ALOGD("uvcstream_getmode quit_flag=1\n");
+				quit_flag = 1;
+			} else if (events[i].data.fd == msgfd) {
+				/* the server never talks back, drop whatever arrives */
+				struct tagmsg_buff msg;
+				if ((events[i].events & (EPOLLHUP | EPOLLERR)) ||
+				    read(msgfd, &msg, sizeof(msg)) <= 0) {
+					ALOGD("msg socket closed by server\n");
+					epoll_ctl(epfd, EPOLL_CTL_DEL, msgfd, NULL);
+				}
+			}
+		}
 	}
 
+	ALOGD("uvc ctrl break\n");
+	close(epfd);
 	return NULL;
 }
 
@@ -198,7 +294,11 @@ int  imu_uvc_process(struct imu_data *data)
 	int retval = -1;
 
 	if (is_uvcstreamon() == TRUE || data != NULL) {
-		retval = uvcctrl_put_data(data);
+		/* called from the imu thread under imu_function_lock */
+		if (b_imu_batch)
+			retval = imu_batcher_push(&imu_batcher, data, get_time_us());
+		else
+			retval = uvcctrl_put_data(data);
 		if (retval < 0) {
 			ALOGD("put imu to uvc_drv failed!\n");
 		}
@@ -218,6 +318,7 @@ int uvcctrl_init(video_hdl* videohdl, imu_hdl* imuhdl)
 	//device default work mode sensor mode0
 	g_fpvideo_cb = sensor_mode0_handle;
 	g_fpimu_cb  =imu_uvc_process;
+	imu_batcher_init(&imu_batcher, IMU_BATCH_NUM_DEF, IMU_BATCH_US_DEF, uvcctrl_put_batch);
 
 	pthread_mutex_init(&imufp_lock_mutex, NULL);
 	pthread_mutex_init(&videofp_lock_mutex, NULL);
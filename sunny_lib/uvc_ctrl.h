@@ -56,5 +56,10 @@ void imu_function_unlock(void);
 void video_function_lock(void);
 void video_function_unlock(void);
 
+/* imu samples to the gadget: num per CTRL_SET_IMU_BATCH, or every max_us */
+struct imu_batch_stats;
+void uvcctrl_set_imu_batch(int num, long long max_us);
+int uvcctrl_get_imu_batch_stats(struct imu_batch_stats *stats);
+
 #endif
 
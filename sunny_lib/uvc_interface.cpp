@@ -13,6 +13,12 @@ int uvc_init(video_hdl* videohdl, imu_hdl* imuhdl)
 {
 	int ret = 0;
 
+	ret = uvcstream_event_init();
+	if (ret < 0) {
+		ALOGD("uvc stream event init failed! \n");
+		return -1;
+	}
+
 	ret = uvcctrl_init(videohdl, imuhdl);
 	if (ret < 0) {
 		ALOGD("uvcctrl init failed! \n");
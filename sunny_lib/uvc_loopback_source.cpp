@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <signal.h>
+
+#include <utils/Log.h>
+
+#include "typedef.h"
+#include "uvc_stream.h"
+#include "uvc_interface.h"
+#include "stream_config.h"
+#include "telemetry.h"
+
+/*
+ * gadget side of the loopback benchmark (shell/uvc_loopback_bench.sh):
+ * camera_synth.cpp instead of the android cameras, the rest of the way
+ * from the sfifos to the gadget is the product's. frames are handed over
+ * with write_video_buffer() unless -z keeps the zero copy path. the host
+ * side is host_uvcviewer/loopback_bench.
+ */
+
+extern int camera_init(void);
+extern void camera_uninit(void);
+
+static volatile sig_atomic_t quit_flag = 0;
+
+static void sig_handler(int sig)
+{
+	quit_flag = 1;
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [options]\n", prog);
+	printf("  -c cameras  \"WxH[:fmt][@fps],...\" (default: stream config)\n");
+	printf("  -g bufs     gadget buffers (default 3 per camera)\n");
+	printf("  -z          camera frames straight into gadget buffers\n");
+	printf("  -f file     telemetry file (default %s)\n", TELEMETRY_SHM_PATH);
+	printf("  -t secs     stop after secs (default: until killed)\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct stream_config_s cfg;
+	const char *telem = TELEMETRY_SHM_PATH;
+	int zerocopy = 0, gadget_bufs = 0, secs = 0;
+	int opt, elapsed = 0;
+
+	cfg = *stream_config_get();
+	while ((opt = getopt(argc, argv, "c:g:zf:t:h")) != -1) {
+		switch (opt) {
+		case 'c':
+			if (stream_config_parse(&cfg, optarg) < 0) {
+				printf("bad camera list \"%s\"\n", optarg);
+				return -1;
+			}
+			cfg.gadget_bufs = 3 * cfg.num;
+			break;
+		case 'g':
+			gadget_bufs = atoi(optarg);
+			break;
+		case 'z':
+			zerocopy = 1;
+			break;
+		case 'f':
+			telem = optarg;
+			break;
+		case 't':
+			secs = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 0;
+		}
+	}
+
+	if (gadget_bufs > 0)
+		cfg.gadget_bufs = gadget_bufs;
+	if (stream_config_init(&cfg) < 0)
+		return -1;
+
+	if (telemetry_init(telem) < 0)
+		printf("telemetry init failed, running without\n");
+
+	uvcstream_set_zerocopy(zerocopy != 0);
+
+	if (camera_init() < 0 || uvc_init(NULL, NULL) < 0) {
+		printf("loopback source init failed\n");
+		camera_uninit();
+		return -1;
+	}
+
+	printf("loopback source: %d camera(s), %d gadget buffers, %s\n", cfg.num, cfg.gadget_bufs,
+	       zerocopy ? "zero copy" : "write_video_buffer");
+
+	signal(SIGINT, sig_handler);
+	signal(SIGTERM, sig_handler);
+	while (!quit_flag && (secs == 0 || elapsed < secs)) {
+		sleep(1);
+		elapsed++;
+	}
+
+	camera_uninit();
+	telemetry_dump(telemetry_get());
+
+	/* video_stream_thread only ever leaves for disk mode, exit takes it down */
+	return 0;
+}
@@ -12,34 +12,55 @@
 #include <asm/types.h>
 #include <pthread.h>
 #include <time.h>
+#include <sys/eventfd.h>
 #include <utils/Log.h>
 
 #include "typedef.h"
 #include "uvc_ctrl.h"
 #include "uvc_stream.h"
 #include "libsfifo/sfifo.h"
+#include "stereo_sync.h"
+#include "stream_config.h"
+#include "telemetry.h"
+#include "ezy_dmabuf.h"
 #include "log_tag.h"
 #define UVC_AVC_DEVICE_NAME			"/dev/g_uvc_mjpeg"
-#define UVC_AVC_NUMBUFS				6
-//#define UVC_AVC_BUFSIZE				(2*640*480)
-#define UVC_AVC_BUFSIZE				(2*1280*720)
+
+#define VIDEO_SYNC_WINDOW			2
+#define VIDEO_SYNC_WAIT_MS			20
 
 #define CLEAR(x)					memset (&(x), 0, sizeof (x))
 #define MAX_BUFFERS 				128
 
 
 BOOL bStreamOn = FALSE;
-BOOL b_streamoff_flag = FALSE;
-BOOL b_diskmode_flag  = FALSE;
+static int stream_state = UVC_STREAM_OFF;
+static pthread_mutex_t stream_state_mutex = PTHREAD_MUTEX_INITIALIZER;
+static BOOL b_pending_on = FALSE;
+static int video_evfd = -1;		/* control -> video_stream_thread */
+static int ctrl_evfd = -1;		/* video_stream_thread -> control loop */
+static long long t_stream_on = 0;
+static long long t_stream_off = 0;
+static long long on_latency = -1;
+static long long off_latency = -1;
+static BOOL b_first_frame = FALSE;
 static EZY_BufHndl *videobufferhndl = NULL;
 static pthread_t videoth_tid;
 static int g_devicemode = SENSOR_MODE0;
 static pthread_rwlock_t  hvideomodemutex;
 static BOOL ums_mode = FALSE;
+#ifdef COPY_IMAGE_BUFFER
+static BOOL b_zerocopy = FALSE;
+#else
+static BOOL b_zerocopy = TRUE;
+#endif
+/* one sfifo per gadget buffer, used by the zero copy path */
+static struct sfifo_s *gadget_sfifos = NULL;
+static struct stereo_sync_s *video_sync = NULL;
+static const struct stream_config_s *stream_cfg = NULL;
 
 
-extern struct sfifo_des_s *rvideo_sfifo_handle;
-extern struct sfifo_des_s *lvideo_sfifo_handle;
+extern struct sfifo_des_s *video_sfifo_handle[];
 extern video_cb g_fpvideo_cb;
 
 static void buffer_uninit(EZY_BufHndl *hndl);
@@ -51,50 +72,12 @@ static int buffer_init(EZY_BufHndl *hndl, const char *name, int numBufs, int buf
 
 
 
-static long get_tick_count(void)
+static long long get_time_us(void)
 {
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	return (tv.tv_sec * 1000 + tv.tv_usec / 1000);
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
 }
-static void test_video0_fps(void)
-{
-	static int frames_num = 0;
-	static long start_time = 1;
-
-	if (start_time == 1) {
-		start_time = get_tick_count();
-	}
-	frames_num++;
-
-	if (frames_num % 60 == 0) {
-		double cur_framerate = 0;
-		cur_framerate = (double)frames_num * 1000 / (get_tick_count() - start_time);
-		start_time = get_tick_count();
-		frames_num = 0;
-		ALOGD("Right VIDEO Frame Rate = %f\n", cur_framerate);
-	}
-}
-
-static void test_video1_fps(void)
-{
-	static int frames_num = 0;
-	static long start_time = 1;
-
-	if (start_time == 1) {
-		start_time = get_tick_count();
-	}
-	frames_num++;
-
-	if (frames_num % 60 == 0) {
-		double cur_framerate = 0;
-		cur_framerate = (double)frames_num * 1000 / (get_tick_count() - start_time);
-		start_time = get_tick_count();
-		frames_num = 0;
-		ALOGD("Left VIDEO Frame Rate = %f\n", cur_framerate);
-	}
-}
-
 
 static int buffer_init(EZY_BufHndl *hndl, const char *name, int numBufs, int bufSize, enum EzyMemory memory, int qflag, int nonBlock)
 {
@@ -243,6 +226,7 @@ int buffer_put_full(EZY_BufHndl *hndl, struct EzyBuf *eb)
 	bufd.bytesused = eb->bytesused;
 	bufd.phyaddr = eb->phyaddr;
 	bufd.index = eb->index;
+	bufd.fd = eb->fd;
 	if (ioctl(hndl->fd, EZY_QBUF, &bufd) < 0) {
 		ALOGD(" Q buffer failed \n");
 		return -1;
@@ -253,17 +237,39 @@ int buffer_put_full(EZY_BufHndl *hndl, struct EzyBuf *eb)
 
 static int uvcstream_buffer_init(void)
 {
+	unsigned int bufsize;
 	int ret;
+	int i;
+
+	stream_cfg = stream_config_get();
+	bufsize = stream_gadget_buf_size(stream_cfg);
 
 	videobufferhndl = (EZY_BufHndl *)malloc(sizeof(EZY_BufHndl));
 	if (videobufferhndl == NULL)
 		return -1;
 	//change block to nblock for change device mode
-	if (buffer_init(videobufferhndl, UVC_AVC_DEVICE_NAME, UVC_AVC_NUMBUFS, UVC_AVC_BUFSIZE, MEMORY_MMAP, EZY_BUF_Q, EZY_BUF_NBLOCK) < 0) {
+	if (buffer_init(videobufferhndl, UVC_AVC_DEVICE_NAME, stream_cfg->gadget_bufs, bufsize, MEMORY_MMAP, EZY_BUF_Q, EZY_BUF_NBLOCK) < 0) {
 		ALOGD("InitGedgetDevice err\n");
 		return -1;
 	}
 
+	if (stream_config_check(stream_cfg, videobufferhndl->ezyBufs[0]->size, videobufferhndl->ezyBufs[0]->headlen) < 0) {
+		ALOGD("stream config does not fit the gadget buffers\n");
+		return -1;
+	}
+
+	gadget_sfifos = (struct sfifo_s *)calloc(videobufferhndl->numBufs, sizeof(struct sfifo_s));
+	if (gadget_sfifos == NULL) {
+		ALOGD("gadget sfifo alloc failed\n");
+		return -1;
+	}
+	for (i = 0; i < videobufferhndl->numBufs; i++) {
+		gadget_sfifos[i].buffer = (unsigned char *)videobufferhndl->ezyBufs[i]->start + videobufferhndl->ezyBufs[i]->headlen;
+		gadget_sfifos[i].size = videobufferhndl->ezyBufs[i]->size - videobufferhndl->ezyBufs[i]->headlen;
+		gadget_sfifos[i].index = i;
+		gadget_sfifos[i].next = NULL;
+	}
+
 	ret = pthread_rwlock_init(&hvideomodemutex, NULL);
 	if (ret) {
 		ALOGD("Cannot init the thread mutex\n");
@@ -274,6 +280,8 @@ static int uvcstream_buffer_init(void)
 
 static void uvcstream_buffer_uninit(void)
 {
+	free(gadget_sfifos);
+	gadget_sfifos = NULL;
 	buffer_uninit(videobufferhndl);
 	pthread_rwlock_destroy(&hvideomodemutex);
 }
@@ -301,30 +309,234 @@ unsigned int write_video_buffer(unsigned char* pBuffer, unsigned int nBufferLen)
 	return 0;
 }
 
+void uvcstream_set_zerocopy(bool enable)
+{
+	b_zerocopy = enable ? TRUE : FALSE;
+}
+
+/* hand a gadget buffer to a camera callback, NULL when zero copy is not usable now */
+struct sfifo_s *uvcstream_get_free_sfifo(void)
+{
+	struct EzyBuf eBuf;
+
+	if (!b_zerocopy || !bStreamOn || gadget_sfifos == NULL)
+		return NULL;
+
+	if (get_device_mode() != SENSOR_MODE0)
+		return NULL;
+
+	if (buffer_get_free(videobufferhndl, &eBuf) < 0)
+		return NULL;
+
+	return &gadget_sfifos[eBuf.index];
+}
+
+int uvcstream_put_full_sfifo(struct sfifo_s *sfifo, unsigned int nBufferLen)
+{
+	struct EzyBuf eBuf;
+
+	if (videobufferhndl == NULL || sfifo == NULL || sfifo->index < 0)
+		return -1;
+
+	eBuf = *videobufferhndl->ezyBufs[sfifo->index];
+	eBuf.bytesused = nBufferLen;
+
+	if (buffer_put_full(videobufferhndl, &eBuf) < 0) {
+		ALOGD("Put GadgetBuf fail\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/* dma-buf of a gadget buffer for a camera driver to capture into, -1 on error;
+ * the caller owns the fd, a filled buffer is queued with uvcstream_put_full_sfifo() */
+int uvcstream_export_buffer(int index)
+{
+	if (videobufferhndl == NULL || index < 0 || index >= videobufferhndl->numBufs)
+		return -1;
+
+	return ezy_export_buffer(videobufferhndl->fd, index);
+}
+
+/* gadget buffers go back to the gadget unsent (bytesused 0), the rest to the camera sfifo */
+static void frame_release(struct sfifo_s *sfifo, int cam)
+{
+	if (sfifo == NULL)
+		return;
+
+	if (sfifo->index >= 0) {
+		/* after stream off EZY_STREAMON queues it again by itself */
+		if (bStreamOn)
+			uvcstream_put_full_sfifo(sfifo, 0);
+	} else {
+		sfifo_put_free_buf(sfifo, video_sfifo_handle[cam]);
+	}
+}
+
+/* a frame a camera callback took but could not queue */
+void uvcstream_release_sfifo(struct sfifo_s *sfifo, int cam)
+{
+	frame_release(sfifo, cam);
+}
+
+static void frame_queue(struct sfifo_s *sfifo, int cam)
+{
+	unsigned int len = stream_slot_size(&stream_cfg->cam[cam]);
+	long long born, stamp, now;
+	int ret;
+
+	/* once queued a gadget buffer may be refilled at once, keep the stamps */
+	born = sfifo->born;
+	stamp = sfifo->stamp;
+
+	if (sfifo->index >= 0) {
+		ret = uvcstream_put_full_sfifo(sfifo, len);
+	} else {
+		ret = write_video_buffer(sfifo->buffer, len);
+		sfifo_put_free_buf(sfifo, video_sfifo_handle[cam]);
+	}
+
+	if (ret != 0) {
+		telemetry_drop(TELEM_QBUF);
+	} else if (born != 0) {
+		now = telemetry_now();
+		telemetry_record(TELEM_QBUF, now - stamp);
+		telemetry_record(TELEM_E2E, now - born);
+	}
+}
+
+/* EZY_STREAMON re-queues every gadget buffer, so stale ones are just dropped */
+static void frame_drain(struct sfifo_des_s *sfifo_des_p)
+{
+	struct sfifo_s *sfifo;
+
+	while ((sfifo = sfifo_wait_active_buf(sfifo_des_p, 0)) != NULL) {
+		if (sfifo->index < 0)
+			sfifo_put_free_buf(sfifo, sfifo_des_p);
+	}
+}
+
+static void video_thread_wakeup(void)
+{
+	int i;
+
+	for (i = 0; i < stream_cfg->num; i++)
+		sfifo_wakeup(video_sfifo_handle[i]);
+	eventfd_write(video_evfd, 1);
+}
+
 int uvcstream_on(void)
 {
-	if(bStreamOn == TRUE)
+	int i;
+
+	if (videobufferhndl == NULL || stream_cfg == NULL)
+		return -1;
+
+	pthread_mutex_lock(&stream_state_mutex);
+	if (stream_state == UVC_STREAM_ON || stream_state == UVC_STREAM_DISK) {
+		pthread_mutex_unlock(&stream_state_mutex);
 		return 0;
+	}
+
+	t_stream_on = get_time_us();
+	if (stream_state == UVC_STREAM_STOPPING) {
+		/* finished by uvcstream_event_process() once the stop is acked */
+		b_pending_on = TRUE;
+		pthread_mutex_unlock(&stream_state_mutex);
+		return 0;
+	}
 
 	buffer_streamon(videobufferhndl);
-	sfifo_reset(lvideo_sfifo_handle);
-	sfifo_reset(rvideo_sfifo_handle);
+	for (i = 0; i < stream_cfg->num; i++)
+		frame_drain(video_sfifo_handle[i]);
+	b_first_frame = TRUE;
+	stream_state = UVC_STREAM_ON;
 	bStreamOn = TRUE;
-	
+	pthread_mutex_unlock(&stream_state_mutex);
+
+	eventfd_write(video_evfd, 1);
 	return 0;
 }
 
+/* returns at once, the gadget is stopped when video_stream_thread has let go */
 int uvcstream_off(void)
 {
-	if(bStreamOn == FALSE)
+	pthread_mutex_lock(&stream_state_mutex);
+	if (stream_state != UVC_STREAM_ON) {
+		b_pending_on = FALSE;
+		pthread_mutex_unlock(&stream_state_mutex);
 		return 0;
+	}
 
+	t_stream_off = get_time_us();
+	stream_state = UVC_STREAM_STOPPING;
 	bStreamOn = FALSE;
-	do{
-		usleep(100);
+	pthread_mutex_unlock(&stream_state_mutex);
+
+	video_thread_wakeup();
+	return 0;
+}
+
+/* before uvcctrl_init(), the ctrl thread adds uvcstream_event_fd() to its epoll set */
+int uvcstream_event_init(void)
+{
+	video_evfd = eventfd(0, 0);
+	ctrl_evfd = eventfd(0, EFD_NONBLOCK);
+	if (video_evfd < 0 || ctrl_evfd < 0) {
+		ALOGD("uvcstream eventfd create failed!\n");
+		return -1;
 	}
-	while(!b_streamoff_flag);
-	buffer_streamoff(videobufferhndl);
+
+	return 0;
+}
+
+int uvcstream_event_fd(void)
+{
+	return ctrl_evfd;
+}
+
+/* kick video_stream_thread after a device mode change */
+void uvcstream_wakeup(void)
+{
+	video_thread_wakeup();
+}
+
+/* called by the control loop when uvcstream_event_fd() is readable */
+int uvcstream_event_process(void)
+{
+	eventfd_t value;
+	int event = UVC_EVENT_NONE;
+	BOOL pending_on;
+
+	eventfd_read(ctrl_evfd, &value);
+
+	pthread_mutex_lock(&stream_state_mutex);
+	if (stream_state == UVC_STREAM_STOPPING) {
+		buffer_streamoff(videobufferhndl);
+		stream_state = UVC_STREAM_OFF;
+		off_latency = get_time_us() - t_stream_off;
+		ALOGD("stream off done in %lld us\n", off_latency);
+		event = UVC_EVENT_STREAM_OFF;
+	} else if (stream_state == UVC_STREAM_DISK) {
+		event = UVC_EVENT_DISK_MODE;
+	}
+	pending_on = b_pending_on;
+	b_pending_on = FALSE;
+	pthread_mutex_unlock(&stream_state_mutex);
+
+	if (pending_on && event == UVC_EVENT_STREAM_OFF)
+		uvcstream_on();
+
+	return event;
+}
+
+int uvcstream_get_latency(long long *on_us, long long *off_us)
+{
+	if (on_us != NULL)
+		*on_us = on_latency;
+	if (off_us != NULL)
+		*off_us = off_latency;
 	return 0;
 }
 
@@ -366,93 +578,164 @@ int get_device_mode(void)
 	return mode;
 }
 
-static void frame_sync()
+/* block on the first camera with nothing waiting, then pick up the others */
+static void video_sync_fill(void)
 {
 	struct sfifo_s *sfifo;
+	int wait_cam, i;
 
-	long int l_frame_t;
-	long int r_frame_t;
+	for (wait_cam = 0; wait_cam < stream_cfg->num - 1; wait_cam++) {
+		if (stereo_sync_count(video_sync, wait_cam) == 0)
+			break;
+	}
 
-	sfifo = sfifo_get_active_buf(lvideo_sfifo_handle);
-	l_frame_t = ((S_MetaData*)(sfifo->buffer))->tv_sec * 1000 * 1000 + ((S_MetaData*)(sfifo->buffer))->tv_usec;
-	sfifo_put_free_buf(sfifo, lvideo_sfifo_handle);
+	sfifo = sfifo_wait_active_buf(video_sfifo_handle[wait_cam], VIDEO_SYNC_WAIT_MS);
+	stereo_sync_push(video_sync, wait_cam, sfifo);
 
-	sfifo = sfifo_get_active_buf(rvideo_sfifo_handle);
-	r_frame_t = ((S_MetaData*)(sfifo->buffer))->tv_sec * 1000 * 1000 + ((S_MetaData*)(sfifo->buffer))->tv_usec;
-	sfifo_put_free_buf(sfifo, rvideo_sfifo_handle);
+	for (i = 0; i < stream_cfg->num; i++) {
+		if (i == wait_cam)
+			continue;
+		sfifo = sfifo_wait_active_buf(video_sfifo_handle[i], 0);
+		stereo_sync_push(video_sync, i, sfifo);
+	}
+}
 
-	printf("l_time = %ld\n", l_frame_t);
-	printf("r_time = %ld\n", r_frame_t);
+/* frames the synchronizer gives up on while streaming are pairing drops */
+static void sync_release(struct sfifo_s *sfifo, int cam)
+{
+	if (bStreamOn)
+		telemetry_drop(TELEM_PAIR);
+	frame_release(sfifo, cam);
+}
 
-	while (r_frame_t - l_frame_t > 500) {
-		sfifo = sfifo_get_active_buf(lvideo_sfifo_handle);
-		l_frame_t = ((S_MetaData*)(sfifo->buffer))->tv_sec * 1000 * 1000 + ((S_MetaData*)(sfifo->buffer))->tv_usec;
-		sfifo_put_free_buf(sfifo, lvideo_sfifo_handle);
-	}
+static void video_sync_dump(void)
+{
+	struct stereo_sync_stats stats;
 
-	while (l_frame_t - r_frame_t > 500) {
-		sfifo = sfifo_get_active_buf(rvideo_sfifo_handle);
-		r_frame_t = ((S_MetaData*)(sfifo->buffer))->tv_sec * 1000 * 1000 + ((S_MetaData*)(sfifo->buffer))->tv_usec;
-		sfifo_put_free_buf(sfifo, rvideo_sfifo_handle);
-	}
+	stereo_sync_get_stats(video_sync, &stats);
+	ALOGD("stereo sync: pairs=%lu orphans %lu/%lu/%lu/%lu skew<100us=%lu <200us=%lu <500us=%lu\n",
+	      stats.pairs, stats.orphans[0], stats.orphans[1], stats.orphans[2], stats.orphans[3],
+	      stats.skew_hist[0], stats.skew_hist[1],
+	      stats.skew_hist[2] + stats.skew_hist[3] + stats.skew_hist[4]);
+}
 
-	return;
+/* video_cb takes two frames, cameras are handed over pairwise */
+static void video_frames_callback(struct sfifo_s **frames)
+{
+	unsigned int l_len, r_len;
+	unsigned char *r_buf;
+	int i;
+
+	if (g_fpvideo_cb == NULL)
+		return;
+
+	for (i = 0; i < stream_cfg->num; i += 2) {
+		l_len = stream_slot_size(&stream_cfg->cam[i]);
+		r_buf = NULL;
+		r_len = 0;
+		if (i + 1 < stream_cfg->num) {
+			r_buf = frames[i + 1]->buffer;
+			r_len = stream_slot_size(&stream_cfg->cam[i + 1]);
+		}
+		g_fpvideo_cb(frames[i]->buffer, l_len, r_buf, r_len);
+	}
 }
 
 static void* video_stream_thread(void* param)
 {
-	static long long loop = 0;
-	struct sfifo_s *l_sfifo, *r_sfifo;
+	struct sfifo_s *frames[STREAM_CAMERA_MAX];
+	BOOL zerocopy;
 	void* arg = param;
-	int retval = -1;
-	int need_sync = 1;
-	long int time_s;
+	eventfd_t wake;
+	int i;
 
 	while (1) {
 
 		if (get_device_mode() == DISK_MODE) {
 			ALOGD("device switch to disk mode \n");
-			b_diskmode_flag= TRUE;
+			stereo_sync_flush(video_sync);
+			pthread_mutex_lock(&stream_state_mutex);
+			stream_state = UVC_STREAM_DISK;
+			pthread_mutex_unlock(&stream_state_mutex);
+			eventfd_write(ctrl_evfd, 1);
 			break;
 		}
 
 		if (!bStreamOn) {
-			b_streamoff_flag=TRUE;
-			usleep(10000);
-			need_sync = 1;
+			stereo_sync_flush(video_sync);
+			pthread_mutex_lock(&stream_state_mutex);
+			if (stream_state == UVC_STREAM_STOPPING)
+				eventfd_write(ctrl_evfd, 1);
+			pthread_mutex_unlock(&stream_state_mutex);
+			/* sleep until uvcstream_on() or a mode change */
+			eventfd_read(video_evfd, &wake);
 			continue;
-		} else if (bStreamOn && need_sync == 1) {
-			frame_sync();
-			need_sync = 0;
 		}
 
-		l_sfifo = sfifo_get_active_buf(lvideo_sfifo_handle);
-		r_sfifo = sfifo_get_active_buf(rvideo_sfifo_handle);
+		if (stereo_sync_pop(video_sync, frames) < 0) {
+			video_sync_fill();
+			continue;
+		}
 
-		if (l_sfifo != NULL  && r_sfifo != NULL) {
-#if 0
-			time_s = ((S_MetaData*)(l_sfifo->buffer))->tv_sec * 1000 * 1000 + ((S_MetaData*)(l_sfifo->buffer))->tv_usec;
-			printf("l = %ld\n", time_s);
-			time_s = ((S_MetaData*)(r_sfifo->buffer))->tv_sec * 1000 * 1000 + ((S_MetaData*)(r_sfifo->buffer))->tv_usec;
-			printf("r = %ld\n\n\n", time_s);
-#endif
+		zerocopy = FALSE;
+		for (i = 0; i < stream_cfg->num; i++) {
+			telemetry_stamp(frames[i], TELEM_PAIR);
+			if (frames[i]->index >= 0)
+				zerocopy = TRUE;
+		}
+
+		if (zerocopy && get_device_mode() == SENSOR_MODE0) {
+			/* frames already sit in gadget buffers, just queue them */
 			video_function_lock();
-			if (g_fpvideo_cb != NULL){
-				g_fpvideo_cb(l_sfifo->buffer, IMAGE_SIZE, r_sfifo->buffer, IMAGE_SIZE);
-			}
+			for (i = 0; i < stream_cfg->num; i++)
+				frame_queue(frames[i], i);
 			video_function_unlock();
-			sfifo_put_free_buf(l_sfifo, lvideo_sfifo_handle);
-			sfifo_put_free_buf(r_sfifo, rvideo_sfifo_handle);
 		} else {
-			sfifo_put_free_buf(l_sfifo, lvideo_sfifo_handle);
-			sfifo_put_free_buf(r_sfifo, rvideo_sfifo_handle);
+			video_function_lock();
+			for (i = 0; i < stream_cfg->num; i++)
+				telemetry_stamp(frames[i], TELEM_CB_ENTER);
+			video_frames_callback(frames);
+			for (i = 0; i < stream_cfg->num; i++) {
+				telemetry_stamp(frames[i], TELEM_CB_EXIT);
+				telemetry_frame_done(frames[i]);
+			}
+			video_function_unlock();
+			for (i = 0; i < stream_cfg->num; i++)
+				frame_release(frames[i], i);
+		}
+
+		if (b_first_frame) {
+			b_first_frame = FALSE;
+			on_latency = get_time_us() - t_stream_on;
+			ALOGD("stream on -> first frame queued in %lld us\n", on_latency);
 		}
 
+		if (video_sync->stats.pairs % 600 == 0) {
+			video_sync_dump();
+			telemetry_dump(telemetry_get());
+		}
 	}
 
 	return NULL;
 }
 
+void uvcstream_set_sync_skew(long skew_us)
+{
+	if (video_sync == NULL)
+		return;
+
+	stereo_sync_set_skew(video_sync, skew_us);
+}
+
+int uvcstream_get_sync_stats(struct stereo_sync_stats *stats)
+{
+	if (video_sync == NULL || stats == NULL)
+		return -1;
+
+	stereo_sync_get_stats(video_sync, stats);
+	return 0;
+}
+
 int uvcstream_init(void)
 {
 	int ret = -1;
@@ -462,6 +745,13 @@ int uvcstream_init(void)
 		ALOGD("uvcstream buffer init failed!\n");
 		return -1;
 	}
+
+	/* keep one buffer per camera free for the producer */
+	video_sync = stereo_sync_init(stream_cfg->num, VIDEO_SYNC_WINDOW, STEREO_SYNC_SKEW_US, sync_release);
+	if (video_sync == NULL) {
+		ALOGD("stereo sync init failed!\n");
+		return -1;
+	}
 	ret = pthread_create(&videoth_tid, NULL, video_stream_thread, NULL);
 	if (ret != 0) {
 		ALOGD("Create video stream thread failed!\n");
@@ -473,5 +763,11 @@ int uvcstream_init(void)
 void uvcstream_uninit(void)
 {
 	pthread_join(videoth_tid, NULL);
+	stereo_sync_uninit(video_sync);
+	video_sync = NULL;
+	close(video_evfd);
+	close(ctrl_evfd);
+	video_evfd = -1;
+	ctrl_evfd = -1;
 	uvcstream_buffer_uninit();
 }
@@ -5,12 +5,12 @@
 
 
 #define		EZY_IOC_BASE			       'E'
-#define		EZY_IOC_MAXNR					6
+#define		EZY_IOC_MAXNR					7
 
 enum ezy_memory {
 	EZY_MEMORY_MMAP             = 1,
 	EZY_MEMORY_USERPTR          = 2,
-//	ezy_MEMORY_OVERLAY          = 3,
+	EZY_MEMORY_DMABUF           = 3,
 };
 
 
@@ -32,6 +32,7 @@ struct ezy_buffer {
 				  				 used in the mmap() system call */
 	int size;
 	int bytesused;	// actuall used size
+	int fd;			/* dma-buf: queued with EZY_QBUF, returned by EZY_EXPBUF */
 };
 
 #define	EZY_REQBUF		_IOWR(EZY_IOC_BASE,1, struct ezy_reqbufs *)
@@ -40,10 +41,9 @@ struct ezy_buffer {
 #define	EZY_DQBUF		_IOWR(EZY_IOC_BASE,4, struct ezy_buffer *)
 #define	EZY_STREAMON	_IOWR(EZY_IOC_BASE,5, struct ezy_buffer *)
 #define	EZY_STREAMOFF	_IOWR(EZY_IOC_BASE,6, struct ezy_buffer *)
+#define	EZY_EXPBUF		_IOWR(EZY_IOC_BASE,7, struct ezy_buffer *)
 
 
-#define IMAGE_SIZE			(640*480*3/2+HEAD_LEN)
-
 #define EZY_BUF_Q			0
 #define EZY_BUF_NQ			1
 
@@ -53,6 +53,7 @@ struct ezy_buffer {
 enum EzyMemory {
 	MEMORY_MMAP             = 1,
 	MEMORY_USERPTR          = 2,
+	MEMORY_DMABUF           = 3,
 };
 
 struct EzyBuf {
@@ -62,6 +63,7 @@ struct EzyBuf {
 	int index;
 	int size;
 	int bytesused;
+	int fd;				/* MEMORY_DMABUF: dma-buf holding the frame */
 };
 
 typedef struct {
@@ -71,14 +73,45 @@ typedef struct {
 	int numBufs;
 } EZY_BufHndl;
 
+struct sfifo_s;
+struct stereo_sync_stats;
+
+enum uvc_stream_state {
+	UVC_STREAM_OFF,
+	UVC_STREAM_ON,
+	UVC_STREAM_STOPPING,	/* waiting for video_stream_thread to let go of the gadget */
+	UVC_STREAM_DISK,		/* video_stream_thread left for disk mode */
+};
+
+/* uvcstream_event_process() results */
+#define UVC_EVENT_NONE			0
+#define UVC_EVENT_STREAM_OFF	1
+#define UVC_EVENT_DISK_MODE		2
+
 int uvcstream_init(void);
 int uvcstream_on(void);
 int uvcstream_off();
 bool is_uvcstreamon(void);
+int uvcstream_event_init(void);
+int uvcstream_event_fd(void);
+int uvcstream_event_process(void);
+void uvcstream_wakeup(void);
+int uvcstream_get_latency(long long *on_us, long long *off_us);
 int set_device_mode(int mode);
 int get_device_mode(void);
 void uvcstream_uninit(void);
 unsigned int write_video_buffer(unsigned char* pBuffer, unsigned int nBufferLen);
 
+/* zero copy: camera callbacks fill gadget buffers directly */
+void uvcstream_set_zerocopy(bool enable);
+struct sfifo_s *uvcstream_get_free_sfifo(void);
+int uvcstream_put_full_sfifo(struct sfifo_s *sfifo, unsigned int nBufferLen);
+void uvcstream_release_sfifo(struct sfifo_s *sfifo, int cam);
+int uvcstream_export_buffer(int index);
+
+/* frame grouping across cameras */
+void uvcstream_set_sync_skew(long skew_us);
+int uvcstream_get_sync_stats(struct stereo_sync_stats *stats);
+
 
 #endif